@@ -86,6 +86,7 @@
 - (void)_updateLastErrorMessage:(NSString *)theErrorMessage;
 - (void)_updateLastErrorID:(NSUInteger)theErrorID;
 - (void)_updateLastSqlstate:(NSString *)theSqlstate;
+- (void)_refuseLocalDataRequestsOnConnection:(MYSQL *)theConnection;
 
 @end
 
@@ -29,6 +29,13 @@
 //  More info at <https://github.com/sequelpro/sequelpro>
 
 
+/**
+ * Supplies the data for a LOAD DATA LOCAL INFILE query, by filling the buffer with up to
+ * bufferLength bytes and returning the number of bytes supplied; 0 once all data has been
+ * supplied, or -1 to abort the query.
+ */
+typedef NSInteger (^SPMySQLLocalDataReadBlock)(char *buffer, NSUInteger bufferLength);
+
 @interface SPMySQLConnection (Querying_and_Preparation)
 
 // Data preparation
@@ -43,6 +50,7 @@
 - (id)streamingQueryString:(NSString *)theQueryString useLowMemoryBlockingStreaming:(BOOL)fullStreaming;
 - (SPMySQLStreamingResultStore *)resultStoreFromQueryString:(NSString *)theQueryString;
 - (id)queryString:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding withResultType:(SPMySQLResultType)theReturnType;
+- (BOOL)loadLocalDataWithQueryString:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding readingDataUsingBlock:(SPMySQLLocalDataReadBlock)readBlock;
 
 // Query convenience functions
 - (NSArray *)getAllRowsFromQuery:(NSString *)theQueryString;
@@ -32,6 +32,21 @@
 #import "SPMySQLConnection.h"
 #import "SPMySQL Private APIs.h"
 
+// The MySQL client error reported when local data can't be supplied (CR_UNKNOWN_ERROR)
+static const int SPMySQLLocalDataErrorID = 2000;
+
+/**
+ * The state of a LOAD DATA LOCAL INFILE query supplying its data from a block.
+ */
+typedef struct {
+	SPMySQLLocalDataReadBlock readBlock;
+} SPMySQLLocalDataLoad;
+
+static int _SPMySQLLocalDataInit(void **localData, const char *filename, void *userData);
+static int _SPMySQLLocalDataRead(void *localData, char *buffer, unsigned int bufferLength);
+static void _SPMySQLLocalDataEnd(void *localData);
+static int _SPMySQLLocalDataError(void *localData, char *errorMessage, unsigned int errorMessageLength);
+
 @implementation SPMySQLConnection (Querying_and_Preparation)
 
 #pragma mark -
@@ -432,6 +447,35 @@
 	return [theResult autorelease];
 }
 
+/**
+ * Run a LOAD DATA LOCAL INFILE query, supplying the file data from the supplied block
+ * rather than from a file; the file name in the query is ignored.  The connection must
+ * have been connected with SPMySQLClientFlagLocalFiles, and the server must allow
+ * loading local data.  Any other requests for local files are always refused.
+ *
+ * Returns whether the query succeeded; the error is available as for other queries.
+ */
+- (BOOL)loadLocalDataWithQueryString:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding readingDataUsingBlock:(SPMySQLLocalDataReadBlock)readBlock
+{
+	if (!(clientFlags & SPMySQLClientFlagLocalFiles) || !mySQLConnection) {
+		[self _updateLastErrorMessage:@"Loading local data is not enabled for this connection"];
+		[self _updateLastErrorID:SPMySQLLocalDataErrorID];
+		[self _updateLastSqlstate:@"HY000"];
+		return NO;
+	}
+
+	SPMySQLLocalDataLoad localDataLoad = { readBlock };
+
+	// If the query reconnects, the new connection will refuse the request
+	mysql_set_local_infile_handler(mySQLConnection, _SPMySQLLocalDataInit, _SPMySQLLocalDataRead, _SPMySQLLocalDataEnd, _SPMySQLLocalDataError, &localDataLoad);
+
+	[self queryString:theQueryString usingEncoding:theEncoding withResultType:SPMySQLResultAsResult];
+
+	if (mySQLConnection) [self _refuseLocalDataRequestsOnConnection:mySQLConnection];
+
+	return ![self queryErrored];
+}
+
 #pragma mark -
 #pragma mark Query convenience functions
 
@@ -745,4 +789,53 @@
 	}
 }
 
+/**
+ * Install a handler refusing any request from the server to read a local file, so the
+ * client library never reads files from disk on the server's behalf.
+ */
+- (void)_refuseLocalDataRequestsOnConnection:(MYSQL *)theConnection
+{
+	mysql_set_local_infile_handler(theConnection, _SPMySQLLocalDataInit, _SPMySQLLocalDataRead, _SPMySQLLocalDataEnd, _SPMySQLLocalDataError, NULL);
+}
+
 @end
+
+#pragma mark -
+#pragma mark Local data handler functions
+
+/**
+ * Start supplying local data; fails if no local data load is in progress.
+ */
+static int _SPMySQLLocalDataInit(void **localData, const char *filename, void *userData)
+{
+	*localData = userData;
+
+	return userData ? 0 : 1;
+}
+
+/**
+ * Fill the client library's buffer from the local data load's block.
+ */
+static int _SPMySQLLocalDataRead(void *localData, char *buffer, unsigned int bufferLength)
+{
+	NSInteger readLength = ((SPMySQLLocalDataLoad *)localData)->readBlock(buffer, bufferLength);
+
+	return (readLength < 0) ? -1 : (int)readLength;
+}
+
+/**
+ * Finish supplying local data; the load's state is owned by the querying method.
+ */
+static void _SPMySQLLocalDataEnd(void *localData)
+{
+}
+
+/**
+ * Describe why local data couldn't be supplied.
+ */
+static int _SPMySQLLocalDataError(void *localData, char *errorMessage, unsigned int errorMessageLength)
+{
+	strlcpy(errorMessage, localData ? "The local data could not be read" : "Local files can't be loaded on this connection", errorMessageLength);
+
+	return SPMySQLLocalDataErrorID;
+}
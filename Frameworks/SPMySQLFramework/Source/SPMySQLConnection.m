@@ -608,6 +608,14 @@ asm(".desc ___crashreporter_info__, 0x10");
 	// Set the connection timeout
 	mysql_options(theConnection, MYSQL_OPT_CONNECT_TIMEOUT, (const void *)&timeout);
 
+	// Only let the server request local files if asked to; the data is then supplied through
+	// -loadLocalDataWithQueryString:usingEncoding:readingDataUsingBlock:, never read from disk
+	[self _refuseLocalDataRequestsOnConnection:theConnection];
+	if (clientFlags & SPMySQLClientFlagLocalFiles) {
+		unsigned int trueUInt = 1;
+		mysql_options(theConnection, MYSQL_OPT_LOCAL_INFILE, (const void *)&trueUInt);
+	}
+
 	// Set the connection encoding
 	NSStringEncoding connectEncodingNS = [SPMySQLConnection stringEncodingForMySQLCharset:[encodingName UTF8String]];
 	mysql_options(theConnection, MYSQL_SET_CHARSET_NAME, [encodingName UTF8String]);
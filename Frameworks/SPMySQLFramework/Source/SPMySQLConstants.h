@@ -78,6 +78,7 @@ typedef enum {
 // Redeclared from mysql_com.h (private header)
 typedef NS_OPTIONS(unsigned long, SPMySQLClientFlags) {
 	SPMySQLClientFlagCompression  = 32,          // CLIENT_COMPRESS
+	SPMySQLClientFlagLocalFiles   = 128,         // CLIENT_LOCAL_FILES
 	SPMySQLClientFlagInteractive  = 1024,        // CLIENT_INTERACTIVE
 	SPMySQLClientFlagMultiResults = (1UL << 17)  // CLIENT_MULTI_RESULTS = 131072
 };
@@ -35,6 +35,9 @@
 	struct st_spmysqlstreamingrowdata *currentDataStoreEntry;
 	struct st_spmysqlstreamingrowdata *lastDataStoreEntry;
 
+	// The last row returned as raw data, freed when the next row is retrieved
+	struct st_spmysqlstreamingrowdata *rawRowDataStoreEntry;
+
 	// Additional counts and memory length tracking
 	NSUInteger processedRowCount;
 
@@ -54,6 +54,7 @@ typedef struct st_spmysqlstreamingrowdata {
 @interface SPMySQLFastStreamingResult () // Private API
 
 - (void) _downloadAllData;
+- (void) _freeRawRowData;
 
 @end
 
@@ -91,6 +92,7 @@ typedef struct st_spmysqlstreamingrowdata {
 		// Initialise the linked list pointers
 		currentDataStoreEntry = NULL;
 		lastDataStoreEntry = NULL;
+		rawRowDataStoreEntry = NULL;
 
 		// Set up the linked list lock
 		pthread_mutex_init(&dataLock, NULL);
@@ -154,6 +156,9 @@ typedef struct st_spmysqlstreamingrowdata {
 	// If the target type was unspecified, use the instance default
 	if (theType == SPMySQLResultRowAsDefault) theType = defaultRowReturnType;
 
+	// Free any row previously returned as raw data
+	[self _freeRawRowData];
+
 	// Set up the return data as appropriate
 	if (theType == SPMySQLResultRowAsArray) {
 		theReturnData = [NSMutableArray arrayWithCapacity:numberOfFields];
@@ -165,10 +170,16 @@ typedef struct st_spmysqlstreamingrowdata {
 	pthread_mutex_lock(&dataLock);
 
 	// Determine whether any data is available; if not, wait 1ms before trying again
-	while (!dataDownloaded && processedRowCount == downloadedRowCount) {
-		pthread_mutex_unlock(&dataLock);
-		usleep(1000);
-		pthread_mutex_lock(&dataLock);
+	if (!dataDownloaded && processedRowCount == downloadedRowCount) {
+		uint64_t waitStartTime = mach_absolute_time();
+
+		while (!dataDownloaded && processedRowCount == downloadedRowCount) {
+			pthread_mutex_unlock(&dataLock);
+			usleep(1000);
+			pthread_mutex_lock(&dataLock);
+		}
+
+		dataWaitTime += _elapsedSecondsSinceAbsoluteTime(waitStartTime);
 	}
 
 	// If all rows have been processed, the end of the result set has been reached; return nil.
@@ -242,12 +253,87 @@ typedef struct st_spmysqlstreamingrowdata {
 	return theReturnData;
 }
 
+/**
+ * Retrieve the next row in the result set as raw data, without converting the cells
+ * to objects.  The row's storage is kept until the next row is retrieved, so the
+ * cell pointers can refer directly to the downloaded data.
+ */
+- (BOOL)getRawRowCells:(const char **)theCells lengths:(unsigned long *)theLengths
+{
+	NSUInteger copiedDataLength = 0;
+
+	// Free any row previously returned as raw data
+	[self _freeRawRowData];
+
+	// Lock the data mutex, and wait for data to be available as for object rows
+	pthread_mutex_lock(&dataLock);
+
+	if (!dataDownloaded && processedRowCount == downloadedRowCount) {
+		uint64_t waitStartTime = mach_absolute_time();
+
+		while (!dataDownloaded && processedRowCount == downloadedRowCount) {
+			pthread_mutex_unlock(&dataLock);
+			usleep(1000);
+			pthread_mutex_lock(&dataLock);
+		}
+
+		dataWaitTime += _elapsedSecondsSinceAbsoluteTime(waitStartTime);
+	}
+
+	// If all rows have been processed, the end of the result set has been reached
+	if (processedRowCount == downloadedRowCount) {
+		pthread_mutex_unlock(&dataLock);
+		return NO;
+	}
+
+	// Take the current row from the linked list, keeping its storage for the caller
+	rawRowDataStoreEntry = currentDataStoreEntry;
+	currentDataStoreEntry = currentDataStoreEntry->nextRow;
+	if (!currentDataStoreEntry) lastDataStoreEntry = NULL;
+
+	processedRowCount++;
+	currentRowIndex++;
+	if (dataDownloaded && processedRowCount == downloadedRowCount) currentRowIndex = NSNotFound;
+
+	pthread_mutex_unlock(&dataLock);
+
+	// Point each cell at its data within the row store; NULL cells are stored with a length of NSNotFound
+	for (NSUInteger i = 0; i < numberOfFields; i++) {
+		unsigned long fieldLength = rawRowDataStoreEntry->dataLengths[i];
+
+		if (fieldLength == NSNotFound) {
+			theCells[i] = NULL;
+			theLengths[i] = 0;
+		} else {
+			theCells[i] = rawRowDataStoreEntry->data + copiedDataLength;
+			theLengths[i] = fieldLength;
+			copiedDataLength += fieldLength;
+		}
+	}
+
+	return YES;
+}
+
+#pragma mark -
+#pragma mark Retrieval statistics
+
+/**
+ * Returns the number of downloaded rows which have been retrieved from the result so far.
+ */
+- (NSUInteger)processedRowCount
+{
+	return processedRowCount;
+}
+
 /*
  * Ensure the result set is fully processed and freed without any processing
  * This method ensures that the connection is unlocked.
  */
 - (void)cancelResultLoad
 {
+	// Free any row previously returned as raw data
+	[self _freeRawRowData];
+
 	// If data has already been downloaded successfully, no further action is required
 	if (dataDownloaded && processedRowCount == downloadedRowCount) return;
 
@@ -317,6 +403,20 @@ typedef struct st_spmysqlstreamingrowdata {
 #pragma mark -
 #pragma mark Result set internals
 
+/**
+ * Free the storage of the last row returned as raw data, if any.
+ */
+- (void)_freeRawRowData
+{
+	if (!rawRowDataStoreEntry) return;
+
+	free(rawRowDataStoreEntry->dataLengths);
+	if (rawRowDataStoreEntry->data != NULL) free(rawRowDataStoreEntry->data);
+	free(rawRowDataStoreEntry);
+
+	rawRowDataStoreEntry = NULL;
+}
+
 /**
  * Used internally to download results in a background thread
  */
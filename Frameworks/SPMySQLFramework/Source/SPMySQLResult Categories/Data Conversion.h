@@ -32,5 +32,7 @@
 
 + (void)_initializeDataConversion;
 - (id)_getObjectFromBytes:(char *)bytes ofLength:(NSUInteger)length fieldDefinitionIndex:(NSUInteger)fieldIndex previewLength:(NSUInteger)previewLength;
+- (BOOL)_fieldIsReturnedAsString:(NSUInteger)fieldIndex;
+- (SPMySQLResultFieldProcessor)_processorForFieldAtIndex:(NSUInteger)fieldIndex;
 
 @end
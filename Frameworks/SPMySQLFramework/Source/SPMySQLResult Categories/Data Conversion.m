@@ -172,6 +172,32 @@ static NSStringEncoding NSFromCFStringEncodingGBK_95;
 	return nil;
 }
 
+/**
+ * Returns whether cells in the specified field are returned as strings decoded from the
+ * raw bytes using the result's string encoding, without any further processing.
+ */
+- (BOOL)_fieldIsReturnedAsString:(NSUInteger)fieldIndex
+{
+	SPMySQLResultFieldProcessor dataProcessor = [self _processorForFieldAtIndex:fieldIndex];
+
+	return (dataProcessor == SPMySQLResultFieldAsString || dataProcessor == SPMySQLResultFieldAsStringOrBlob);
+}
+
+/**
+ * Returns the processor used to convert cells in the specified field, taking into
+ * account whether the instance is set to return all data as strings.
+ */
+- (SPMySQLResultFieldProcessor)_processorForFieldAtIndex:(NSUInteger)fieldIndex
+{
+	SPMySQLResultFieldProcessor dataProcessor = _processorForField(fieldDefinitions[fieldIndex]);
+
+	if (returnDataAsStrings && dataProcessor == SPMySQLResultFieldAsBlob) {
+		dataProcessor = SPMySQLResultFieldAsString;
+	}
+
+	return dataProcessor;
+}
+
 @end
 
 /**
@@ -74,6 +74,8 @@ typedef enum {
 
 // Column information
 - (NSArray *)fieldNames;
+- (SPMySQLResultFieldProcessor)fieldProcessorForFieldAtIndex:(NSUInteger)fieldIndex;
+- (NSUInteger)bitLengthForFieldAtIndex:(NSUInteger)fieldIndex;
 
 // Data retrieval (note that fast enumeration is also supported, using instance-default format)
 - (void)seekToRow:(unsigned long long)targetRow;
@@ -159,6 +159,32 @@ static id NSNullPointer;
 	return [NSArray arrayWithObjects:fieldNames count:numberOfFields];
 }
 
+/**
+ * Retrieve how cells in the specified field are converted when rows are returned;
+ * allows raw row data to be interpreted the same way as the converted objects.
+ */
+- (SPMySQLResultFieldProcessor)fieldProcessorForFieldAtIndex:(NSUInteger)fieldIndex
+{
+	if (fieldIndex >= numberOfFields) {
+		[NSException raise:NSRangeException format:@"Requested field index %llu beyond bounds (%llu)", (unsigned long long)fieldIndex, (unsigned long long)numberOfFields];
+	}
+
+	return [self _processorForFieldAtIndex:fieldIndex];
+}
+
+/**
+ * Retrieve the defined length of the specified field, which for BIT fields is
+ * the number of bits cells are padded to when converted.
+ */
+- (NSUInteger)bitLengthForFieldAtIndex:(NSUInteger)fieldIndex
+{
+	if (fieldIndex >= numberOfFields) {
+		[NSException raise:NSRangeException format:@"Requested field index %llu beyond bounds (%llu)", (unsigned long long)fieldIndex, (unsigned long long)numberOfFields];
+	}
+
+	return (NSUInteger)fieldDefinitions[fieldIndex].length;
+}
+
 /**
  * For field definitions, see Result Categories/Field Definitions.h/m
  */
@@ -40,6 +40,9 @@
 	// Counts and memory length tracking
 	NSUInteger downloadedRowCount;
 
+	// Time spent waiting for rows to be received
+	double dataWaitTime;
+
 	IMP isConnectedPtr;
 	SEL isConnectedSelector;
 }
@@ -49,7 +52,14 @@
 - (instancetype)initWithMySQLResult:(void *)theResult stringEncoding:(NSStringEncoding)theStringEncoding connection:(SPMySQLConnection *)theConnection;
 - (instancetype)initWithMySQLResult:(void *)theResult stringEncoding:(NSStringEncoding)theStringEncoding NS_UNAVAILABLE;
 
+// Raw data retrieval, bypassing object conversion
+- (BOOL)getRawRowCells:(const char **)theCells lengths:(unsigned long *)theLengths;
+
 // Allow result fetching to be cancelled
 - (void)cancelResultLoad;
 
+// Retrieval statistics
+- (NSUInteger)processedRowCount;
+- (double)dataWaitTime;
+
 @end
@@ -31,6 +31,11 @@
 #import "SPMySQLStreamingResult.h"
 #import "SPMySQL Private APIs.h"
 
+@interface SPMySQLStreamingResult () // Private API
+
+- (void)_markResultLoadComplete;
+
+@end
 
 /**
  * This type of streaming result allows each row to be accessed on-demand; this can
@@ -74,6 +79,7 @@
 
 		// Start with no rows downloaded
 		downloadedRowCount = 0;
+		dataWaitTime = 0;
 		dataDownloaded = NO;
 		connectionUnlocked = NO;
 
@@ -168,14 +174,7 @@
 	// If no row was returned, the end of the result set has been reached.  Clear markers,
 	// unlock the parent connection, and return nil.
 	if (!theRow) {
-		dataDownloaded = YES;
-		[parentConnection _unlockConnection];
-		connectionUnlocked = YES;
-
-		// If the connection query may have been cancelled with a query kill, double-check connection
-		if ([parentConnection lastQueryWasCancelled] && [parentConnection serverMajorVersion] < 5) {
-			[parentConnection checkConnection];
-		}
+		[self _markResultLoadComplete];
 
 		return nil;
 	}
@@ -186,6 +185,67 @@
 	return theRow;
 }
 
+/**
+ * Retrieve the next row in the result set as raw MySQL data, without converting the
+ * cells to objects.  The supplied arrays must each have space for -numberOfFields items;
+ * cell pointers are set to NULL for NULL values.  The data is not NUL-terminated, is in
+ * the result's string encoding, and remains valid only until the next row is retrieved.
+ * Use -fieldProcessorForFieldAtIndex: to determine how each cell should be interpreted.
+ *
+ * @return NO if there are no rows remaining
+ */
+- (BOOL)getRawRowCells:(const char **)theCells lengths:(unsigned long *)theLengths
+{
+	MYSQL_ROW theRow = NULL;
+
+	// Ensure that the connection is still up before performing a row fetch; rows are received
+	// from the server as they are fetched, so the fetch is timed as waiting for data
+	if ((*isConnectedPtr)(parentConnection, isConnectedSelector)) {
+		uint64_t fetchStartTime = mach_absolute_time();
+
+		theRow = mysql_fetch_row(resultSet);
+
+		dataWaitTime += _elapsedSecondsSinceAbsoluteTime(fetchStartTime);
+	}
+
+	if (!theRow) {
+		[self _markResultLoadComplete];
+
+		return NO;
+	}
+
+	unsigned long *theRowDataLengths = mysql_fetch_lengths(resultSet);
+
+	memcpy(theCells, theRow, sizeof(char *) * numberOfFields);
+	memcpy(theLengths, theRowDataLengths, sizeof(unsigned long) * numberOfFields);
+
+	currentRowIndex++;
+	downloadedRowCount++;
+
+	return YES;
+}
+
+#pragma mark -
+#pragma mark Retrieval statistics
+
+/**
+ * Returns the number of rows which have been retrieved from the result so far.
+ */
+- (NSUInteger)processedRowCount
+{
+	return downloadedRowCount;
+}
+
+/**
+ * Returns the total time, in seconds, spent waiting for raw rows to be received from the
+ * server - a high value indicates the export or import reading the result is limited by the
+ * server or network rather than its own processing.
+ */
+- (double)dataWaitTime
+{
+	return dataWaitTime;
+}
+
 /*
  * Ensure the result set is fully processed and freed without any processing
  * This method ensures that the connection is unlocked.
@@ -248,4 +308,23 @@
 	return 1;
 }
 
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Clear markers and unlock the parent connection once the end of the result set
+ * has been reached.
+ */
+- (void)_markResultLoadComplete
+{
+	dataDownloaded = YES;
+	[parentConnection _unlockConnection];
+	connectionUnlocked = YES;
+
+	// If the connection query may have been cancelled with a query kill, double-check connection
+	if ([parentConnection lastQueryWasCancelled] && [parentConnection serverMajorVersion] < 5) {
+		[parentConnection checkConnection];
+	}
+}
+
 @end
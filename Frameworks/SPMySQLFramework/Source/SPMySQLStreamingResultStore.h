@@ -61,6 +61,8 @@ typedef char SPMySQLStreamingResultStoreRowData;
 - (id)cellDataAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
 - (id)cellPreviewAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex previewLength:(NSUInteger)previewLength;
 - (BOOL)cellIsNullAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (NSUInteger)cellDataLengthAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (const char *)stringBytesAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex length:(NSUInteger *)length;
 
 /* Deleting rows and addition of placeholder rows */
 - (void) addDummyRow;
@@ -54,6 +54,7 @@ typedef enum {
 - (void) _ensureCapacityForAdditionalRowCount:(NSUInteger)numExtraRows;
 - (void) _increaseCapacity;
 - (NSUInteger) _rowCapacity;
+- (char *) _rawCellDataAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex length:(NSUInteger *)length;
 - (SPMySQLStreamingResultStoreRowData **) _transferResultStoreData;
 
 @end
@@ -444,6 +445,41 @@ static inline void SPMySQLStreamingResultStoreFreeRowData(SPMySQLStreamingResult
 	return (((BOOL *)(rowData + (sizeOfMetadata * numberOfFields)))[columnIndex]);
 }
 
+/**
+ * Returns the length in bytes of the raw data stored at a specified row and
+ * column index, without creating an object for the cell; NSNotFound is returned
+ * for NULL cells and dummy rows.
+ */
+- (NSUInteger)cellDataLengthAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	NSUInteger dataLength;
+
+	if (![self _rawCellDataAtRow:rowIndex column:columnIndex length:&dataLength]) {
+		return NSNotFound;
+	}
+
+	return dataLength;
+}
+
+/**
+ * Returns a pointer to the raw bytes stored at a specified row and column index, for
+ * cells which would be returned as strings decoded using the result's string encoding.
+ * NULL is returned for NULL cells, dummy rows, and columns returned as other types.
+ * The bytes are not NUL-terminated, and the pointer is only valid until the store is
+ * next modified.
+ */
+- (const char *)stringBytesAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex length:(NSUInteger *)length
+{
+	// Throw an exception if the column index is out of bounds
+	if (columnIndex >= numberOfFields) {
+		[NSException raise:NSRangeException format:@"Requested storage index (row %llu, col %llu) beyond bounds (%llu, %llu)", (unsigned long long)rowIndex, (unsigned long long)columnIndex, (unsigned long long)numberOfRows, (unsigned long long)numberOfFields];
+	}
+
+	if (![self _fieldIsReturnedAsString:columnIndex]) return NULL;
+
+	return [self _rawCellDataAtRow:rowIndex column:columnIndex length:length];
+}
+
 #pragma mark - Data retrieval overrides
 
 /**
@@ -844,6 +880,59 @@ static inline void SPMySQLStreamingResultStoreFreeRowData(SPMySQLStreamingResult
 	return rowCapacity;
 }
 
+/**
+ * Private method to locate the raw data for a cell, returning a pointer to the start
+ * of the data and setting the supplied length, or returning NULL for NULL cells and
+ * dummy rows.
+ */
+- (char *) _rawCellDataAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex length:(NSUInteger *)length
+{
+	// Throw an exception if the row or column index is out of bounds
+	if (rowIndex >= numberOfRows || columnIndex >= numberOfFields) {
+		[NSException raise:NSRangeException format:@"Requested storage index (row %llu, col %llu) beyond bounds (%llu, %llu)", (unsigned long long)rowIndex, (unsigned long long)columnIndex, (unsigned long long)numberOfRows, (unsigned long long)numberOfFields];
+	}
+
+	SPMySQLStreamingResultStoreRowData *rowData = dataStorage[rowIndex];
+
+	// A null pointer for the row indicates a dummy entry
+	if (rowData == NULL) {
+		return NULL;
+	}
+
+	unsigned long dataStart, dataEnd;
+	size_t sizeOfMetadata;
+
+	// Get the metadata size for this row and adjust the data pointer past the indicator
+	sizeOfMetadata = rowData[0];
+	rowData = rowData + 1;
+
+	// NULL cells have no data
+	if (((BOOL *)(rowData + (sizeOfMetadata * numberOfFields)))[columnIndex]) {
+		return NULL;
+	}
+
+	// Retrieve the data positions, as in the cell preview method
+	switch (sizeOfMetadata) {
+		case SPMySQLStoreMetadataAsChar:
+			dataStart = columnIndex ? ((unsigned char *)rowData)[columnIndex - 1] : 0;
+			dataEnd = ((unsigned char *)rowData)[columnIndex];
+			break;
+		case SPMySQLStoreMetadataAsShort:
+			dataStart = columnIndex ? ((unsigned short *)rowData)[columnIndex - 1] : 0;
+			dataEnd = ((unsigned short *)rowData)[columnIndex];
+			break;
+		case SPMySQLStoreMetadataAsLong:
+		default:
+			dataStart = columnIndex ? ((unsigned long *)rowData)[columnIndex - 1] : 0;
+			dataEnd = ((unsigned long *)rowData)[columnIndex];
+			break;
+	}
+
+	if (length) *length = (NSUInteger)(dataEnd - dataStart);
+
+	return rowData + ((sizeOfMetadata + sizeof(BOOL)) * numberOfFields) + dataStart;
+}
+
 /**
  * Private method to return the internal result store, relinquishing
  * ownership to allow transfer of data.  Note that the returned result
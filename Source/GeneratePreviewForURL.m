@@ -336,6 +336,7 @@ NSString *PreviewForExportSettingsSPF(NSDictionary *spf, NSURL *myURL, NSInteger
 		@"SPCSVExport": @"CSV",
 		@"SPXMLExport": @"XML",
 		@"SPDotExport": @"Dot",
+		@"SPArrowExport": @"Arrow",
 	};
 	MapIf(spf, @"exportType", types, vars);
 	
@@ -0,0 +1,68 @@
+//
+//  SPArrowExporter.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExporter.h"
+#import "SPArrowExporterProtocol.h"
+
+/**
+ * @class SPArrowExporter SPArrowExporter.h
+ *
+ * Arrow exporter class.  Writes a table, or a filtered or custom query result, to an Apache Arrow
+ * IPC file, reading tables as a stream of raw rows and writing them in record batches so that
+ * large tables aren't held in memory.
+ */
+@interface SPArrowExporter : SPExporter
+{
+	NSObject <SPArrowExporterProtocol> *delegate;
+
+	NSString *arrowTableName;
+	NSString *arrowExportErrors;
+}
+
+/**
+ * @property delegate Exporter delegate
+ */
+@property (readwrite, assign) NSObject <SPArrowExporterProtocol> *delegate;
+
+/**
+ * @property arrowTableName Table name
+ */
+@property (readwrite, retain) NSString *arrowTableName;
+
+/**
+ * @property arrowExportErrors Export errors
+ */
+@property (readwrite, retain) NSString *arrowExportErrors;
+
+- (id)initWithDelegate:(NSObject<SPArrowExporterProtocol> *)exportDelegate;
+
+- (BOOL)didExportErrorsOccur;
+
+@end
@@ -0,0 +1,232 @@
+//
+//  SPArrowExporter.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPArrowExporter.h"
+#import "SPArrowIPCWriter.h"
+#import "SPExportFile.h"
+#import "SPFileHandle.h"
+#import "SPExportUtilities.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// Rows are written in record batches of up to this many rows, or this many bytes of buffered data
+static const NSUInteger SPArrowExporterRecordBatchRowCount = 65536;
+static const NSUInteger SPArrowExporterRecordBatchMaximumLength = 67108864;
+
+@implementation SPArrowExporter
+
+@synthesize delegate;
+@synthesize arrowTableName;
+@synthesize arrowExportErrors;
+
+/**
+ * Initialise an instance of SPArrowExporter using the supplied delegate.
+ *
+ * @param exportDelegate The exporter delegate
+ *
+ * @return The initialised instance
+ */
+- (id)initWithDelegate:(NSObject<SPArrowExporterProtocol> *)exportDelegate
+{
+	if ((self = [super init])) {
+		SPExportDelegateConformsToProtocol(exportDelegate, @protocol(SPArrowExporterProtocol));
+
+		[self setDelegate:exportDelegate];
+	}
+
+	return self;
+}
+
+- (void)exportOperation
+{
+	BOOL changeEncoding = NO;
+	BOOL cancelled = NO;
+
+	SPArrowIPCWriter *arrowWriter = nil;
+	SPMySQLStreamingResult *streamingResult = nil;
+
+	const char **rawRowCells = NULL;
+	unsigned long *rawRowCellLengths = NULL;
+
+	id <SPExportRowSource> rowSource = [self exportRowSource];
+
+	double lastProgressValue = 0;
+	NSUInteger totalRows, currentRowIndex = 0;
+
+	// Check to see if we have at least a table name or row source
+	if ((![self arrowTableName] || ![[self arrowTableName] length]) && ![[rowSource exportFieldNames] count]) return;
+
+	// Inform the delegate that the export process is about to begin
+	[delegate performSelectorOnMainThread:@selector(arrowExportProcessWillBegin:) withObject:self waitUntilDone:NO];
+
+	// Mark the process as running
+	[self setExportProcessIsRunning:YES];
+
+	// Rows of a row source are written as text; record batches are built column by column, so
+	// the rows are read in order rather than in concurrent chunks
+	if (rowSource) {
+		totalRows = [rowSource numberOfExportRows];
+
+		arrowWriter = [[SPArrowIPCWriter alloc] initWithColumnNames:[rowSource exportFieldNames]];
+	}
+	// Tables are streamed as raw rows, typed from the result's field definitions
+	else {
+
+		// Arrow text is always UTF-8
+		changeEncoding = ![[connection encoding] hasPrefix:@"utf8"];
+
+		if (changeEncoding) {
+			[connection storeEncodingForRestoration];
+
+			if (![connection setEncoding:@"utf8mb4"]) [connection setEncoding:@"utf8"];
+		}
+
+		totalRows       = [[connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [[self arrowTableName] backtickQuotedString]]] integerValue];
+		streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self arrowTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming]];
+
+		[self beginRecordingTable:[self arrowTableName] readingResult:streamingResult];
+
+		arrowWriter = [[SPArrowIPCWriter alloc] initWithFieldDefinitions:[streamingResult fieldDefinitions]];
+
+		rawRowCells = malloc(sizeof(char *) * ([streamingResult numberOfFields] + 1));
+		rawRowCellLengths = malloc(sizeof(unsigned long) * ([streamingResult numberOfFields] + 1));
+	}
+
+	// Inform the delegate that we are about to start writing the data to disk
+	[delegate performSelectorOnMainThread:@selector(arrowExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+
+	NSAutoreleasePool *arrowExportPool = [[NSAutoreleasePool alloc] init];
+
+	while (1)
+	{
+		// Check for cancellation flag
+		if ([self isCancelled]) {
+			if (streamingResult) {
+				[connection cancelCurrentQuery];
+				[streamingResult cancelResultLoad];
+			}
+
+			cancelled = YES;
+
+			break;
+		}
+
+		// Retrieve the next row from the supplied data, either from the row source...
+		if (rowSource) {
+			if (currentRowIndex == totalRows) break;
+
+			[arrowWriter appendRow:[rowSource exportRowAtIndex:currentRowIndex]];
+
+			[self recordRowsWrittenFromSource:1];
+		}
+		// Or by reading the raw row from the streaming result
+		else {
+			if (![streamingResult getRawRowCells:rawRowCells lengths:rawRowCellLengths]) break;
+
+			[arrowWriter appendRawRowCells:rawRowCells lengths:rawRowCellLengths];
+		}
+
+		currentRowIndex++;
+
+		// Write a record batch once enough rows have been collected
+		if ([arrowWriter bufferedRowCount] >= SPArrowExporterRecordBatchRowCount || [arrowWriter bufferedByteCount] >= SPArrowExporterRecordBatchMaximumLength) {
+			[arrowWriter writeRecordBatchToOutput:[self exportOutputFile]];
+
+			// Drain the autorelease pool to keep memory usage low
+			[arrowExportPool release];
+			arrowExportPool = [[NSAutoreleasePool alloc] init];
+		}
+
+		// Update the progress
+		if (totalRows && (currentRowIndex * ([self exportMaxProgress] / totalRows)) > lastProgressValue + 1) {
+
+			double progress = (currentRowIndex * ([self exportMaxProgress] / totalRows));
+
+			[self setExportProgressValue:progress];
+
+			lastProgressValue = progress;
+
+			// Inform the delegate that the export's progress has been updated
+			[delegate performSelectorOnMainThread:@selector(arrowExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+		}
+	}
+
+	// If the table couldn't be read in full, the footer is left out rather than writing a file which
+	// reads as complete but is missing rows
+	if (!cancelled && streamingResult && ([connection queryErrored] || ![connection isConnected])) {
+		[self setArrowExportErrors:[NSString stringWithFormat:NSLocalizedString(@"An error occurred while reading the table '%@', so the export file %@ is incomplete and can't be read. MySQL said: %@", @"arrow export : table read failed message"), [self arrowTableName], [[self exportOutputFile] exportFilePath], ([connection lastErrorMessage]) ? [connection lastErrorMessage] : @""]];
+	}
+
+	// Write the remaining rows and the footer, without which the file can't be read
+	if (!cancelled && ![self didExportErrorsOccur]) [arrowWriter finishWritingToOutput:[self exportOutputFile]];
+
+	[self endRecordingTable:[self arrowTableName]];
+
+	[arrowExportPool release];
+	[arrowWriter release];
+
+	if (rawRowCells) free(rawRowCells);
+	if (rawRowCellLengths) free(rawRowCellLengths);
+
+	if (changeEncoding) [connection restoreStoredEncoding];
+
+	if (cancelled) return;
+
+	// Write data to disk
+	[[[self exportOutputFile] exportFileHandle] synchronizeFile];
+
+	// Mark the process as not running
+	[self setExportProcessIsRunning:NO];
+
+	// Inform the delegate that the export process is complete
+	[delegate performSelectorOnMainThread:@selector(arrowExportProcessComplete:) withObject:self waitUntilDone:NO];
+}
+
+/**
+ * Returns whether or not any export errors occurred, such as the table not being read in full.
+ *
+ * @return A BOOL indicating the occurrence of errors
+ */
+- (BOOL)didExportErrorsOccur
+{
+	return ([[self arrowExportErrors] length] != 0);
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	if (arrowTableName) SPClear(arrowTableName);
+	if (arrowExportErrors) SPClear(arrowExportErrors);
+
+	[super dealloc];
+}
+
+@end
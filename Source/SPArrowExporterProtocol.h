@@ -0,0 +1,68 @@
+//
+//  SPArrowExporterProtocol.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPArrowExporter;
+
+/**
+ * @protocol SPArrowExporterProtocol SPArrowExporterProtocol.h
+ *
+ * Arrow exporter delegate protocol.
+ */
+@protocol SPArrowExporterProtocol
+
+/**
+ * Called when the Arrow export process is about to begin.
+ *
+ * @param SPArrowExporter The expoter calling the method.
+ */
+- (void)arrowExportProcessWillBegin:(SPArrowExporter *)exporter;
+
+/**
+ * Called when the Arrow export process is complete.
+ *
+ * @param SPArrowExporter The expoter calling the method.
+ */
+- (void)arrowExportProcessComplete:(SPArrowExporter *)exporter;
+
+/**
+ * Called when the progress of the Arrow export process is updated.
+ *
+ * @param SPArrowExporter The expoter calling the method.
+ */
+- (void)arrowExportProcessProgressUpdated:(SPArrowExporter *)exporter;
+
+/**
+ * Called when the Arrow export process is about to begin writing data to disk.
+ *
+ * @param SPArrowExporter The expoter calling the method.
+ */
+- (void)arrowExportProcessWillBeginWritingData:(SPArrowExporter *)exporter;
+
+@end
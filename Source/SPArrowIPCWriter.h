@@ -0,0 +1,80 @@
+//
+//  SPArrowIPCWriter.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+struct SPArrowColumn;
+struct SPArrowBuffer;
+struct SPFlatBufferBuilder;
+
+/**
+ * @class SPArrowIPCWriter SPArrowIPCWriter.h
+ *
+ * Writes rows to the Apache Arrow IPC file format (also read as Feather V2) in record batches.
+ *
+ * Columns are typed from the field definitions of the result being exported: integers, floating
+ * point numbers, decimals, dates and timestamps are stored natively, BIT values as unsigned
+ * 64-bit integers, binary strings, BLOBs and geometry as binary, and everything else as UTF-8
+ * text.  Values which can't be represented, such as zero dates, are written as nulls.
+ *
+ * Text columns whose first record batch contains few distinct values are dictionary encoded,
+ * with any values first seen in later batches written as dictionary deltas.  Buffers are written
+ * uncompressed, as Arrow's zstd and lz4 body compression needs libraries this project doesn't link.
+ */
+@interface SPArrowIPCWriter : NSObject
+{
+	NSUInteger columnCount;
+	NSArray *columnNames;
+	struct SPArrowColumn *columns;
+
+	NSUInteger rowCount;
+
+	struct SPFlatBufferBuilder *builder;
+	struct SPArrowBuffer *messageBody;
+	struct SPArrowBuffer *fieldNodes;
+	struct SPArrowBuffer *bufferRegions;
+	struct SPArrowBuffer *dictionaryBlocks;
+	struct SPArrowBuffer *recordBatchBlocks;
+
+	unsigned long long fileOffset;
+	BOOL schemaWritten;
+}
+
+- (id)initWithFieldDefinitions:(NSArray *)fieldDefinitions;
+- (id)initWithColumnNames:(NSArray *)names;
+
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths;
+- (void)appendRow:(NSArray *)row;
+
+- (NSUInteger)bufferedRowCount;
+- (NSUInteger)bufferedByteCount;
+
+- (void)writeRecordBatchToOutput:(id)output;
+- (void)finishWritingToOutput:(id)output;
+
+@end
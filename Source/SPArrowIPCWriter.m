@@ -0,0 +1,1262 @@
+//
+//  SPArrowIPCWriter.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPArrowIPCWriter.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The initial size of each growable buffer
+static const size_t SPArrowBufferInitialCapacity = 4096;
+
+// A text column is dictionary encoded when its first batch holds at most one distinct value for
+// every this many rows
+static const NSUInteger SPArrowDictionaryRowsPerValue = 4;
+
+// The largest DECIMAL precision a 128-bit Arrow decimal can hold; wider columns are written as text
+static const int32_t SPArrowMaximumDecimalPrecision = 38;
+
+// Metadata version V5, and the Message header and Type union members used
+static const int16_t SPArrowMetadataVersion = 4;
+
+enum {
+	SPArrowMessageSchema = 1,
+	SPArrowMessageDictionaryBatch = 2,
+	SPArrowMessageRecordBatch = 3
+};
+
+enum {
+	SPArrowTypeInt = 2,
+	SPArrowTypeFloatingPoint = 3,
+	SPArrowTypeBinary = 4,
+	SPArrowTypeUtf8 = 5,
+	SPArrowTypeDecimal = 7,
+	SPArrowTypeDate = 8,
+	SPArrowTypeTimestamp = 10
+};
+
+#pragma mark Buffers
+
+typedef struct SPArrowBuffer {
+	uint8_t *bytes;
+	size_t length;
+	size_t capacity;
+} SPArrowBuffer;
+
+static inline void SPArrowBufferReserve(SPArrowBuffer *buffer, size_t additional)
+{
+	if (buffer->length + additional <= buffer->capacity) return;
+
+	size_t capacity = buffer->capacity ? buffer->capacity : SPArrowBufferInitialCapacity;
+
+	while (capacity < buffer->length + additional) capacity *= 2;
+
+	buffer->bytes = realloc(buffer->bytes, capacity);
+	buffer->capacity = capacity;
+}
+
+static inline void SPArrowBufferAppend(SPArrowBuffer *buffer, const void *bytes, size_t length)
+{
+	SPArrowBufferReserve(buffer, length);
+	if (length) memcpy(buffer->bytes + buffer->length, bytes, length);
+	buffer->length += length;
+}
+
+static inline void SPArrowBufferAppendZeros(SPArrowBuffer *buffer, size_t length)
+{
+	SPArrowBufferReserve(buffer, length);
+	if (length) memset(buffer->bytes + buffer->length, 0, length);
+	buffer->length += length;
+}
+
+static void SPArrowBufferFree(SPArrowBuffer *buffer)
+{
+	free(buffer->bytes);
+	buffer->bytes = NULL;
+	buffer->length = buffer->capacity = 0;
+}
+
+#pragma mark Flatbuffers
+
+// Arrow's metadata is stored as flatbuffers, which are built back to front so that every
+// offset points forward to an object which has already been written.  None of the tables
+// used have more fields than this.
+#define SPFlatBufferMaximumFields 8
+
+typedef struct SPFlatBufferBuilder {
+	uint8_t *bytes;
+	size_t capacity;
+	size_t size;
+	size_t minimumAlignment;
+	size_t tableStart;
+	uint32_t fieldOffsets[SPFlatBufferMaximumFields];
+	int fieldCount;
+} SPFlatBufferBuilder;
+
+static void SPFlatBufferGrow(SPFlatBufferBuilder *fb, size_t additional)
+{
+	if (fb->size + additional <= fb->capacity) return;
+
+	size_t capacity = fb->capacity ? fb->capacity : 1024;
+
+	while (capacity < fb->size + additional) capacity *= 2;
+
+	uint8_t *bytes = malloc(capacity);
+
+	if (fb->size) memcpy(bytes + capacity - fb->size, fb->bytes + fb->capacity - fb->size, fb->size);
+
+	free(fb->bytes);
+
+	fb->bytes = bytes;
+	fb->capacity = capacity;
+}
+
+/* Pad so that the next length bytes prepended end up aligned. */
+static void SPFlatBufferAlign(SPFlatBufferBuilder *fb, size_t length, size_t alignment)
+{
+	if (alignment > fb->minimumAlignment) fb->minimumAlignment = alignment;
+
+	size_t padding = (~(fb->size + length) + 1) & (alignment - 1);
+
+	SPFlatBufferGrow(fb, padding + length);
+	fb->size += padding;
+	memset(fb->bytes + fb->capacity - fb->size, 0, padding);
+}
+
+static void SPFlatBufferPrepend(SPFlatBufferBuilder *fb, const void *bytes, size_t length)
+{
+	SPFlatBufferGrow(fb, length);
+	fb->size += length;
+	memcpy(fb->bytes + fb->capacity - fb->size, bytes, length);
+}
+
+static uint32_t SPFlatBufferAddScalar(SPFlatBufferBuilder *fb, const void *value, size_t length)
+{
+	SPFlatBufferAlign(fb, length, length);
+	SPFlatBufferPrepend(fb, value, length);
+
+	return (uint32_t)fb->size;
+}
+
+static uint32_t SPFlatBufferAddOffset(SPFlatBufferBuilder *fb, uint32_t offset)
+{
+	SPFlatBufferAlign(fb, 4, 4);
+
+	uint32_t relative = (uint32_t)(fb->size + 4 - offset);
+
+	SPFlatBufferPrepend(fb, &relative, 4);
+
+	return (uint32_t)fb->size;
+}
+
+static uint32_t SPFlatBufferCreateString(SPFlatBufferBuilder *fb, const char *string, size_t length)
+{
+	uint8_t terminator = 0;
+	uint32_t count = (uint32_t)length;
+
+	SPFlatBufferAlign(fb, length + 1, 4);
+	SPFlatBufferPrepend(fb, &terminator, 1);
+	SPFlatBufferPrepend(fb, string, length);
+	SPFlatBufferPrepend(fb, &count, 4);
+
+	return (uint32_t)fb->size;
+}
+
+static uint32_t SPFlatBufferCreateStructVector(SPFlatBufferBuilder *fb, const void *structs, size_t structSize, uint32_t count)
+{
+	SPFlatBufferAlign(fb, structSize * count, 4);
+	SPFlatBufferAlign(fb, structSize * count, 8);
+	SPFlatBufferPrepend(fb, structs, structSize * count);
+	SPFlatBufferPrepend(fb, &count, 4);
+
+	return (uint32_t)fb->size;
+}
+
+static uint32_t SPFlatBufferCreateOffsetVector(SPFlatBufferBuilder *fb, const uint32_t *offsets, uint32_t count)
+{
+	SPFlatBufferAlign(fb, count * 4, 4);
+
+	for (uint32_t i = count; i > 0; i--) SPFlatBufferAddOffset(fb, offsets[i - 1]);
+
+	SPFlatBufferPrepend(fb, &count, 4);
+
+	return (uint32_t)fb->size;
+}
+
+static void SPFlatBufferStartTable(SPFlatBufferBuilder *fb)
+{
+	memset(fb->fieldOffsets, 0, sizeof(fb->fieldOffsets));
+	fb->fieldCount = 0;
+	fb->tableStart = fb->size;
+}
+
+static void SPFlatBufferTableAddScalar(SPFlatBufferBuilder *fb, int field, const void *value, size_t length)
+{
+	fb->fieldOffsets[field] = SPFlatBufferAddScalar(fb, value, length);
+
+	if (field >= fb->fieldCount) fb->fieldCount = field + 1;
+}
+
+static void SPFlatBufferTableAddOffset(SPFlatBufferBuilder *fb, int field, uint32_t offset)
+{
+	fb->fieldOffsets[field] = SPFlatBufferAddOffset(fb, offset);
+
+	if (field >= fb->fieldCount) fb->fieldCount = field + 1;
+}
+
+/* Finish the table started last, writing its vtable directly before it. */
+static uint32_t SPFlatBufferEndTable(SPFlatBufferBuilder *fb)
+{
+	int32_t placeholder = 0;
+	uint32_t tableOffset = SPFlatBufferAddScalar(fb, &placeholder, 4);
+	uint16_t entry;
+
+	for (int i = fb->fieldCount; i > 0; i--) {
+		entry = fb->fieldOffsets[i - 1] ? (uint16_t)(tableOffset - fb->fieldOffsets[i - 1]) : 0;
+		SPFlatBufferPrepend(fb, &entry, 2);
+	}
+
+	entry = (uint16_t)(tableOffset - fb->tableStart);
+	SPFlatBufferPrepend(fb, &entry, 2);
+	entry = (uint16_t)((fb->fieldCount + 2) * 2);
+	SPFlatBufferPrepend(fb, &entry, 2);
+
+	int32_t vtableDistance = (int32_t)(fb->size - tableOffset);
+
+	memcpy(fb->bytes + fb->capacity - tableOffset, &vtableDistance, 4);
+
+	return tableOffset;
+}
+
+static void SPFlatBufferFinish(SPFlatBufferBuilder *fb, uint32_t root)
+{
+	SPFlatBufferAlign(fb, 4, fb->minimumAlignment > 8 ? fb->minimumAlignment : 8);
+	SPFlatBufferAddOffset(fb, root);
+}
+
+static inline const uint8_t *SPFlatBufferBytes(SPFlatBufferBuilder *fb)
+{
+	return fb->bytes + fb->capacity - fb->size;
+}
+
+static void SPFlatBufferReset(SPFlatBufferBuilder *fb)
+{
+	fb->size = 0;
+	fb->minimumAlignment = 1;
+}
+
+#pragma mark Columns
+
+typedef enum {
+	SPArrowInt8 = 0,
+	SPArrowInt16,
+	SPArrowInt32,
+	SPArrowInt64,
+	SPArrowUInt8,
+	SPArrowUInt16,
+	SPArrowUInt32,
+	SPArrowUInt64,
+	SPArrowFloat32,
+	SPArrowFloat64,
+	SPArrowDecimal128,
+	SPArrowDate32,
+	SPArrowTimestampMicroseconds,
+	SPArrowBitField,
+	SPArrowUtf8,
+	SPArrowBinary
+} SPArrowColumnType;
+
+// The width of each value of the fixed width types, indexed by SPArrowColumnType
+static const size_t SPArrowValueWidths[] = { 1, 2, 4, 8, 1, 2, 4, 8, 4, 8, 16, 4, 8, 8, 0, 0 };
+
+typedef struct SPArrowColumn {
+	SPArrowColumnType type;
+	int32_t precision;
+	int32_t scale;
+
+	// The current batch
+	SPArrowBuffer validity;
+	SPArrowBuffer values;
+	SPArrowBuffer offsets;
+	int64_t nullCount;
+
+	// The dictionary of encoded columns, kept across batches, and a hash table of its entries
+	BOOL dictionaryEncoded;
+	SPArrowBuffer dictionaryOffsets;
+	SPArrowBuffer dictionaryValues;
+	uint32_t dictionaryCount;
+	uint32_t dictionaryWrittenCount;
+	uint32_t *dictionarySlots;
+	uint32_t dictionarySlotCount;
+} SPArrowColumn;
+
+typedef struct { int64_t length; int64_t nullCount; } SPArrowFieldNode;
+typedef struct { int64_t offset; int64_t length; } SPArrowBufferRegion;
+typedef struct { int64_t offset; int32_t metadataLength; int32_t padding; int64_t bodyLength; } SPArrowBlock;
+
+static inline BOOL SPArrowColumnIsVariableWidth(SPArrowColumn *column)
+{
+	return column->type == SPArrowUtf8 || column->type == SPArrowBinary;
+}
+
+/* Empty the column ready for a new batch, keeping its dictionary. */
+static void SPArrowColumnReset(SPArrowColumn *column)
+{
+	int32_t zero = 0;
+
+	column->validity.length = 0;
+	column->values.length = 0;
+	column->offsets.length = 0;
+	column->nullCount = 0;
+
+	if (SPArrowColumnIsVariableWidth(column) && !column->dictionaryEncoded) SPArrowBufferAppend(&column->offsets, &zero, 4);
+}
+
+static void SPArrowColumnFreeDictionary(SPArrowColumn *column)
+{
+	SPArrowBufferFree(&column->dictionaryOffsets);
+	SPArrowBufferFree(&column->dictionaryValues);
+
+	free(column->dictionarySlots);
+
+	column->dictionarySlots = NULL;
+	column->dictionarySlotCount = 0;
+	column->dictionaryCount = 0;
+}
+
+static void SPArrowColumnFree(SPArrowColumn *column)
+{
+	SPArrowBufferFree(&column->validity);
+	SPArrowBufferFree(&column->values);
+	SPArrowBufferFree(&column->offsets);
+	SPArrowColumnFreeDictionary(column);
+}
+
+/* Configure a column's type from a MySQL field definition. */
+static void SPArrowColumnConfigure(SPArrowColumn *column, NSDictionary *field)
+{
+	NSString *type = [field objectForKey:@"type"];
+	BOOL isUnsigned = [[field objectForKey:@"UNSIGNED_FLAG"] boolValue];
+
+	column->type = SPArrowUtf8;
+
+	if ([type isEqualToString:@"TINYINT"]) {
+		column->type = isUnsigned ? SPArrowUInt8 : SPArrowInt8;
+	}
+	else if ([type isEqualToString:@"SMALLINT"]) {
+		column->type = isUnsigned ? SPArrowUInt16 : SPArrowInt16;
+	}
+	else if ([type isEqualToString:@"MEDIUMINT"] || [type isEqualToString:@"INT"]) {
+		column->type = isUnsigned ? SPArrowUInt32 : SPArrowInt32;
+	}
+	else if ([type isEqualToString:@"BIGINT"]) {
+		column->type = isUnsigned ? SPArrowUInt64 : SPArrowInt64;
+	}
+	else if ([type isEqualToString:@"YEAR"]) {
+		column->type = SPArrowInt16;
+	}
+	else if ([type isEqualToString:@"FLOAT"]) {
+		column->type = SPArrowFloat32;
+	}
+	else if ([type isEqualToString:@"DOUBLE"]) {
+		column->type = SPArrowFloat64;
+	}
+	else if ([type isEqualToString:@"DECIMAL"]) {
+		// The field length of a DECIMAL(M,D) counts the point and sign as well as the digits
+		int32_t scale = [[field objectForKey:@"decimals"] intValue];
+		int32_t precision = [[field objectForKey:@"byte_length"] intValue] - (scale > 0 ? 1 : 0) - (isUnsigned ? 0 : 1);
+
+		if (precision >= 1 && precision <= SPArrowMaximumDecimalPrecision && scale <= precision) {
+			column->type = SPArrowDecimal128;
+			column->precision = precision;
+			column->scale = scale;
+		}
+	}
+	else if ([type isEqualToString:@"DATE"]) {
+		column->type = SPArrowDate32;
+	}
+	else if ([type isEqualToString:@"DATETIME"] || [type isEqualToString:@"TIMESTAMP"]) {
+		column->type = SPArrowTimestampMicroseconds;
+	}
+	else if ([type isEqualToString:@"BIT"]) {
+		column->type = SPArrowBitField;
+	}
+	else if ([type hasSuffix:@"BLOB"] || [type isEqualToString:@"BINARY"] || [type isEqualToString:@"VARBINARY"] || [type isEqualToString:@"GEOMETRY"]) {
+		column->type = SPArrowBinary;
+	}
+}
+
+static inline void SPArrowColumnSetValid(SPArrowColumn *column, int64_t row, BOOL valid)
+{
+	if ((size_t)(row >> 3) >= column->validity.length) SPArrowBufferAppendZeros(&column->validity, 1);
+
+	if (valid) {
+		column->validity.bytes[row >> 3] |= (uint8_t)(1 << (row & 7));
+	}
+	else {
+		column->nullCount++;
+	}
+}
+
+static inline uint64_t SPArrowHash(const uint8_t *bytes, size_t length)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < length; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+
+	return hash;
+}
+
+/* Look up a value in the column's dictionary, adding it if it's new; returns its index. */
+static uint32_t SPArrowColumnDictionaryIndex(SPArrowColumn *column, const uint8_t *bytes, size_t length)
+{
+	const int32_t *entryOffsets;
+	uint32_t slot;
+
+	if (!column->dictionaryOffsets.length) {
+		int32_t zero = 0;
+
+		SPArrowBufferAppend(&column->dictionaryOffsets, &zero, 4);
+	}
+
+	// Keep the hash table at most half full
+	if ((column->dictionaryCount + 1) * 2 > column->dictionarySlotCount) {
+		uint32_t slotCount = column->dictionarySlotCount ? column->dictionarySlotCount * 2 : 1024;
+		uint32_t *slots = calloc(slotCount, sizeof(uint32_t));
+
+		entryOffsets = (const int32_t *)column->dictionaryOffsets.bytes;
+
+		for (uint32_t i = 0; i < column->dictionaryCount; i++)
+		{
+			slot = (uint32_t)SPArrowHash(column->dictionaryValues.bytes + entryOffsets[i], entryOffsets[i + 1] - entryOffsets[i]) & (slotCount - 1);
+
+			while (slots[slot]) slot = (slot + 1) & (slotCount - 1);
+
+			slots[slot] = i + 1;
+		}
+
+		free(column->dictionarySlots);
+
+		column->dictionarySlots = slots;
+		column->dictionarySlotCount = slotCount;
+	}
+
+	entryOffsets = (const int32_t *)column->dictionaryOffsets.bytes;
+	slot = (uint32_t)SPArrowHash(bytes, length) & (column->dictionarySlotCount - 1);
+
+	while (column->dictionarySlots[slot])
+	{
+		uint32_t index = column->dictionarySlots[slot] - 1;
+
+		if ((size_t)(entryOffsets[index + 1] - entryOffsets[index]) == length && !memcmp(column->dictionaryValues.bytes + entryOffsets[index], bytes, length)) return index;
+
+		slot = (slot + 1) & (column->dictionarySlotCount - 1);
+	}
+
+	int32_t end;
+
+	SPArrowBufferAppend(&column->dictionaryValues, bytes, length);
+
+	end = (int32_t)column->dictionaryValues.length;
+
+	SPArrowBufferAppend(&column->dictionaryOffsets, &end, 4);
+
+	column->dictionarySlots[slot] = column->dictionaryCount + 1;
+
+	return column->dictionaryCount++;
+}
+
+/* Switch a text column to dictionary encoding if its current batch has few enough distinct values. */
+static BOOL SPArrowColumnEncodeAsDictionaryIfRepetitive(SPArrowColumn *column, int64_t batchRowCount, int64_t maximumDistinctValues)
+{
+	if (column->type != SPArrowUtf8 || !batchRowCount) return NO;
+
+	SPArrowBuffer indices = { NULL, 0, 0 };
+	const int32_t *valueOffsets = (const int32_t *)column->offsets.bytes;
+
+	for (int64_t row = 0; row < batchRowCount; row++)
+	{
+		int32_t index = (int32_t)SPArrowColumnDictionaryIndex(column, column->values.bytes + valueOffsets[row], valueOffsets[row + 1] - valueOffsets[row]);
+
+		if (column->dictionaryCount > maximumDistinctValues) {
+			SPArrowBufferFree(&indices);
+			SPArrowColumnFreeDictionary(column);
+
+			return NO;
+		}
+
+		SPArrowBufferAppend(&indices, &index, 4);
+	}
+
+	SPArrowBufferFree(&column->values);
+	SPArrowBufferFree(&column->offsets);
+
+	column->values = indices;
+	column->dictionaryEncoded = YES;
+
+	return YES;
+}
+
+#pragma mark Value parsing
+
+static inline BOOL SPArrowParseInteger(const char *bytes, size_t length, int64_t *signedValue, uint64_t *unsignedValue)
+{
+	size_t i = 0;
+	BOOL negative = NO;
+	uint64_t value = 0;
+
+	if (length && (bytes[0] == '-' || bytes[0] == '+')) {
+		negative = (bytes[0] == '-');
+		i++;
+	}
+
+	if (i == length) return NO;
+
+	for (; i < length; i++)
+	{
+		if (bytes[i] < '0' || bytes[i] > '9') return NO;
+
+		value = value * 10 + (uint64_t)(bytes[i] - '0');
+	}
+
+	if (signedValue) *signedValue = negative ? (int64_t)(0 - value) : (int64_t)value;
+	if (unsignedValue) *unsignedValue = value;
+
+	return YES;
+}
+
+static inline int64_t SPArrowParseDigits(const char *bytes, size_t length, size_t start, size_t count)
+{
+	int64_t value = 0;
+
+	if (start + count > length) return -1;
+
+	for (size_t i = start; i < start + count; i++)
+	{
+		if (bytes[i] < '0' || bytes[i] > '9') return -1;
+
+		value = value * 10 + (bytes[i] - '0');
+	}
+
+	return value;
+}
+
+/* Days since 1970-01-01 in the proleptic Gregorian calendar. */
+static inline int64_t SPArrowDaysFromCivil(int64_t year, int64_t month, int64_t day)
+{
+	year -= (month <= 2);
+
+	int64_t era = (year >= 0 ? year : year - 399) / 400;
+	int64_t yearOfEra = year - era * 400;
+	int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+	return era * 146097 + dayOfEra - 719468;
+}
+
+/*
+ * Parse a DATE, DATETIME or TIMESTAMP value into days or microseconds since the epoch.  Zero
+ * and partial dates have no equivalent, and are rejected.
+ */
+static BOOL SPArrowParseDateTime(const char *bytes, size_t length, BOOL withTime, int64_t *result)
+{
+	int64_t year = SPArrowParseDigits(bytes, length, 0, 4);
+	int64_t month = SPArrowParseDigits(bytes, length, 5, 2);
+	int64_t day = SPArrowParseDigits(bytes, length, 8, 2);
+
+	if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31) return NO;
+
+	int64_t days = SPArrowDaysFromCivil(year, month, day);
+
+	if (!withTime) {
+		*result = days;
+		return YES;
+	}
+
+	int64_t hours = SPArrowParseDigits(bytes, length, 11, 2);
+	int64_t minutes = SPArrowParseDigits(bytes, length, 14, 2);
+	int64_t seconds = SPArrowParseDigits(bytes, length, 17, 2);
+	int64_t microseconds = 0;
+
+	if (hours < 0 || minutes < 0 || seconds < 0) return NO;
+
+	if (length > 20 && bytes[19] == '.') {
+		for (size_t i = 20; i < 26; i++)
+		{
+			microseconds *= 10;
+
+			if (i < length) {
+				if (bytes[i] < '0' || bytes[i] > '9') return NO;
+
+				microseconds += bytes[i] - '0';
+			}
+		}
+	}
+
+	*result = ((days * 24 + hours) * 60 + minutes) * 60000000LL + seconds * 1000000LL + microseconds;
+
+	return YES;
+}
+
+/* Parse a DECIMAL value into a little-endian 128-bit integer scaled by the column's scale. */
+static BOOL SPArrowParseDecimal(const char *bytes, size_t length, int32_t scale, uint8_t *result)
+{
+	unsigned __int128 value = 0;
+	BOOL negative = NO, inFraction = NO;
+	int32_t fractionDigits = 0;
+	size_t i = 0;
+
+	if (length && (bytes[0] == '-' || bytes[0] == '+')) {
+		negative = (bytes[0] == '-');
+		i++;
+	}
+
+	if (i == length) return NO;
+
+	for (; i < length; i++)
+	{
+		if (bytes[i] == '.' && !inFraction) {
+			inFraction = YES;
+			continue;
+		}
+
+		if (bytes[i] < '0' || bytes[i] > '9') return NO;
+
+		if (inFraction) {
+			if (fractionDigits == scale) continue;
+
+			fractionDigits++;
+		}
+
+		value = value * 10 + (unsigned)(bytes[i] - '0');
+	}
+
+	for (; fractionDigits < scale; fractionDigits++) value *= 10;
+
+	if (negative) value = ~value + 1;
+
+	for (i = 0; i < 16; i++)
+	{
+		result[i] = (uint8_t)(value & 0xFF);
+		value >>= 8;
+	}
+
+	return YES;
+}
+
+/* Append a cell to the column's current batch; NULL cells are passed as a NULL pointer. */
+static void SPArrowColumnAppendCell(SPArrowColumn *column, int64_t row, const char *bytes, size_t length)
+{
+	BOOL valid = (bytes != NULL);
+
+	if (SPArrowColumnIsVariableWidth(column)) {
+		if (column->dictionaryEncoded) {
+			int32_t index = valid ? (int32_t)SPArrowColumnDictionaryIndex(column, (const uint8_t *)bytes, length) : 0;
+
+			SPArrowBufferAppend(&column->values, &index, 4);
+		}
+		else {
+			if (valid) SPArrowBufferAppend(&column->values, bytes, length);
+
+			int32_t end = (int32_t)column->values.length;
+
+			SPArrowBufferAppend(&column->offsets, &end, 4);
+		}
+
+		SPArrowColumnSetValid(column, row, valid);
+
+		return;
+	}
+
+	size_t width = SPArrowValueWidths[column->type];
+
+	SPArrowBufferAppendZeros(&column->values, width);
+
+	uint8_t *value = column->values.bytes + column->values.length - width;
+
+	if (valid) {
+		int64_t signedValue = 0;
+		uint64_t unsignedValue = 0;
+		char number[64];
+
+		switch (column->type)
+		{
+			case SPArrowInt8:
+			case SPArrowInt16:
+			case SPArrowInt32:
+			case SPArrowInt64:
+				if ((valid = SPArrowParseInteger(bytes, length, &signedValue, NULL))) memcpy(value, &signedValue, width);
+				break;
+			case SPArrowUInt8:
+			case SPArrowUInt16:
+			case SPArrowUInt32:
+			case SPArrowUInt64:
+				if ((valid = SPArrowParseInteger(bytes, length, NULL, &unsignedValue))) memcpy(value, &unsignedValue, width);
+				break;
+			case SPArrowFloat32:
+			case SPArrowFloat64:
+				if ((valid = (length < sizeof(number)))) {
+					memcpy(number, bytes, length);
+					number[length] = '\0';
+
+					if (column->type == SPArrowFloat32) {
+						float floatValue = strtof(number, NULL);
+						memcpy(value, &floatValue, 4);
+					}
+					else {
+						double doubleValue = strtod(number, NULL);
+						memcpy(value, &doubleValue, 8);
+					}
+				}
+				break;
+			case SPArrowDecimal128:
+				valid = SPArrowParseDecimal(bytes, length, column->scale, value);
+				break;
+			case SPArrowDate32:
+				if ((valid = SPArrowParseDateTime(bytes, length, NO, &signedValue))) {
+					int32_t days = (int32_t)signedValue;
+					memcpy(value, &days, 4);
+				}
+				break;
+			case SPArrowTimestampMicroseconds:
+				if ((valid = SPArrowParseDateTime(bytes, length, YES, &signedValue))) memcpy(value, &signedValue, 8);
+				break;
+			case SPArrowBitField:
+				// BIT values are sent as big-endian binary
+				for (size_t i = 0; i < length && i < 8; i++) unsignedValue = (unsignedValue << 8) | (uint8_t)bytes[i];
+				memcpy(value, &unsignedValue, 8);
+				break;
+			default:
+				break;
+		}
+	}
+
+	SPArrowColumnSetValid(column, row, valid);
+}
+
+#pragma mark Metadata
+
+/* Build the table describing a column's value type, returning its Type union member. */
+static uint32_t SPArrowCreateTypeTable(SPFlatBufferBuilder *fb, SPArrowColumn *column, uint8_t *typeType)
+{
+	static const int32_t intWidths[] = { 8, 16, 32, 64, 8, 16, 32, 64 };
+
+	int16_t shortValue;
+	int32_t intValue;
+	uint8_t boolValue;
+
+	SPFlatBufferStartTable(fb);
+
+	switch (column->type)
+	{
+		case SPArrowInt8:
+		case SPArrowInt16:
+		case SPArrowInt32:
+		case SPArrowInt64:
+		case SPArrowUInt8:
+		case SPArrowUInt16:
+		case SPArrowUInt32:
+		case SPArrowUInt64:
+		case SPArrowBitField:
+			*typeType = SPArrowTypeInt;
+			intValue = (column->type == SPArrowBitField) ? 64 : intWidths[column->type];
+			boolValue = (column->type <= SPArrowInt64);
+			SPFlatBufferTableAddScalar(fb, 0, &intValue, 4);
+			SPFlatBufferTableAddScalar(fb, 1, &boolValue, 1);
+			break;
+		case SPArrowFloat32:
+		case SPArrowFloat64:
+			*typeType = SPArrowTypeFloatingPoint;
+			shortValue = (column->type == SPArrowFloat32) ? 1 : 2; // SINGLE or DOUBLE
+			SPFlatBufferTableAddScalar(fb, 0, &shortValue, 2);
+			break;
+		case SPArrowDecimal128:
+			*typeType = SPArrowTypeDecimal;
+			intValue = 128;
+			SPFlatBufferTableAddScalar(fb, 2, &intValue, 4);
+			SPFlatBufferTableAddScalar(fb, 0, &column->precision, 4);
+			SPFlatBufferTableAddScalar(fb, 1, &column->scale, 4);
+			break;
+		case SPArrowDate32:
+			*typeType = SPArrowTypeDate;
+			shortValue = 0; // DAY
+			SPFlatBufferTableAddScalar(fb, 0, &shortValue, 2);
+			break;
+		case SPArrowTimestampMicroseconds:
+			*typeType = SPArrowTypeTimestamp;
+			shortValue = 2; // MICROSECOND
+			SPFlatBufferTableAddScalar(fb, 0, &shortValue, 2);
+			break;
+		case SPArrowUtf8:
+			*typeType = SPArrowTypeUtf8;
+			break;
+		case SPArrowBinary:
+			*typeType = SPArrowTypeBinary;
+			break;
+	}
+
+	return SPFlatBufferEndTable(fb);
+}
+
+static uint32_t SPArrowCreateRecordBatch(SPFlatBufferBuilder *fb, int64_t length, SPArrowBuffer *nodes, SPArrowBuffer *regions)
+{
+	uint32_t nodeVector = SPFlatBufferCreateStructVector(fb, nodes->bytes, sizeof(SPArrowFieldNode), (uint32_t)(nodes->length / sizeof(SPArrowFieldNode)));
+	uint32_t regionVector = SPFlatBufferCreateStructVector(fb, regions->bytes, sizeof(SPArrowBufferRegion), (uint32_t)(regions->length / sizeof(SPArrowBufferRegion)));
+
+	SPFlatBufferStartTable(fb);
+	SPFlatBufferTableAddScalar(fb, 0, &length, 8);
+	SPFlatBufferTableAddOffset(fb, 1, nodeVector);
+	SPFlatBufferTableAddOffset(fb, 2, regionVector);
+
+	return SPFlatBufferEndTable(fb);
+}
+
+/* Wrap a message header in a Message table and finish the flatbuffer. */
+static void SPArrowFinishMessage(SPFlatBufferBuilder *fb, uint8_t headerType, uint32_t header, int64_t bodyLength)
+{
+	int16_t version = SPArrowMetadataVersion;
+
+	SPFlatBufferStartTable(fb);
+	SPFlatBufferTableAddScalar(fb, 3, &bodyLength, 8);
+	SPFlatBufferTableAddOffset(fb, 2, header);
+	SPFlatBufferTableAddScalar(fb, 0, &version, 2);
+	SPFlatBufferTableAddScalar(fb, 1, &headerType, 1);
+	SPFlatBufferFinish(fb, SPFlatBufferEndTable(fb));
+}
+
+/*
+ * Append a buffer to a message body and record its region.  Every buffer starts on an 8-byte
+ * boundary.
+ */
+static void SPArrowAppendBodyBuffer(SPArrowBuffer *body, SPArrowBuffer *regions, const void *bytes, size_t length)
+{
+	SPArrowBufferRegion region = { (int64_t)body->length, (int64_t)length };
+
+	SPArrowBufferAppend(body, bytes, length);
+
+	SPArrowBufferAppend(regions, &region, sizeof(region));
+	SPArrowBufferAppendZeros(body, (8 - (body->length & 7)) & 7);
+}
+
+@interface SPArrowIPCWriter ()
+
+- (id)_initWithColumnNames:(NSArray *)names;
+- (uint32_t)_createSchema;
+- (void)_writeMessageToOutput:(id)output block:(SPArrowBuffer *)blocks;
+- (void)_writeBytes:(const void *)bytes length:(NSUInteger)length toOutput:(id)output;
+
+@end
+
+@implementation SPArrowIPCWriter
+
+/**
+ * Initialise a writer for the columns of a result, typing each column from its field
+ * definition.
+ */
+- (id)initWithFieldDefinitions:(NSArray *)fieldDefinitions
+{
+	NSMutableArray *names = [NSMutableArray arrayWithCapacity:[fieldDefinitions count]];
+
+	for (NSDictionary *field in fieldDefinitions)
+	{
+		[names addObject:[field objectForKey:@"name"] ? [field objectForKey:@"name"] : @""];
+	}
+
+	if ((self = [self _initWithColumnNames:names])) {
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			SPArrowColumnConfigure(&columns[i], [fieldDefinitions objectAtIndex:i]);
+			SPArrowColumnReset(&columns[i]);
+		}
+	}
+
+	return self;
+}
+
+/**
+ * Initialise a writer for rows without field definitions, such as rows supplied as arrays of
+ * objects; every column is written as text.
+ */
+- (id)initWithColumnNames:(NSArray *)names
+{
+	if ((self = [self _initWithColumnNames:names])) {
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			columns[i].type = SPArrowUtf8;
+			SPArrowColumnReset(&columns[i]);
+		}
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Rows
+
+/**
+ * Append a raw row retrieved from a streaming result to the current record batch; NULL cells
+ * are passed as NULL pointers.  Text is expected to be UTF-8.
+ */
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths
+{
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		SPArrowColumnAppendCell(&columns[i], rowCount, cells[i], cells[i] ? lengths[i] : 0);
+	}
+
+	rowCount++;
+}
+
+/**
+ * Append a row of objects to the current record batch, converting each cell to UTF-8 text.
+ */
+- (void)appendRow:(NSArray *)row
+{
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		id cell = i < [row count] ? NSArrayObjectAtIndex(row, i) : [NSNull null];
+
+		if (cell == [NSNull null]) {
+			SPArrowColumnAppendCell(&columns[i], rowCount, NULL, 0);
+		}
+		else if ([cell isKindOfClass:[NSData class]]) {
+			SPArrowColumnAppendCell(&columns[i], rowCount, [cell bytes], [cell length]);
+		}
+		else {
+			NSString *string = [cell isKindOfClass:[SPMySQLGeometryData class]] ? [cell wktString] : [cell description];
+			const char *bytes = [string UTF8String];
+
+			SPArrowColumnAppendCell(&columns[i], rowCount, bytes, strlen(bytes));
+		}
+	}
+
+	rowCount++;
+}
+
+/**
+ * The number of rows appended since the last record batch was written.
+ */
+- (NSUInteger)bufferedRowCount
+{
+	return rowCount;
+}
+
+/**
+ * The approximate size of the rows appended since the last record batch was written.
+ */
+- (NSUInteger)bufferedByteCount
+{
+	NSUInteger length = 0;
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		length += columns[i].validity.length + columns[i].values.length + columns[i].offsets.length;
+	}
+
+	return length;
+}
+
+#pragma mark -
+#pragma mark Output
+
+/**
+ * Write the rows appended so far to the supplied output as a record batch, preceded by the file
+ * header and schema if this is the first batch and by any new dictionary entries.  The output
+ * must respond to -writeData:.
+ */
+- (void)writeRecordBatchToOutput:(id)output
+{
+	NSUInteger i;
+	SPArrowFieldNode node;
+
+	// The first batch decides which text columns are dictionary encoded, as the schema can't change
+	if (!schemaWritten) {
+		for (i = 0; i < columnCount; i++)
+		{
+			SPArrowColumnEncodeAsDictionaryIfRepetitive(&columns[i], rowCount, rowCount / SPArrowDictionaryRowsPerValue);
+		}
+
+		[self _writeBytes:"ARROW1\0\0" length:8 toOutput:output];
+
+		SPFlatBufferReset(builder);
+		messageBody->length = 0;
+		SPArrowFinishMessage(builder, SPArrowMessageSchema, [self _createSchema], 0);
+		[self _writeMessageToOutput:output block:NULL];
+
+		schemaWritten = YES;
+	}
+
+	// Write any dictionary entries added since the last batch, as a delta after the first
+	for (i = 0; i < columnCount; i++)
+	{
+		SPArrowColumn *column = &columns[i];
+
+		if (!column->dictionaryEncoded || column->dictionaryWrittenCount == column->dictionaryCount) continue;
+
+		uint32_t first = column->dictionaryWrittenCount;
+		uint32_t count = column->dictionaryCount - first;
+		const int32_t *entryOffsets = (const int32_t *)column->dictionaryOffsets.bytes;
+		SPArrowBuffer deltaOffsets = { NULL, 0, 0 };
+		int64_t dictionaryId = (int64_t)i;
+		uint8_t isDelta = (first > 0);
+
+		for (uint32_t j = 0; j <= count; j++)
+		{
+			int32_t offset = entryOffsets[first + j] - entryOffsets[first];
+
+			SPArrowBufferAppend(&deltaOffsets, &offset, 4);
+		}
+
+		messageBody->length = fieldNodes->length = bufferRegions->length = 0;
+
+		node.length = count;
+		node.nullCount = 0;
+
+		SPArrowBufferAppend(fieldNodes, &node, sizeof(node));
+		SPArrowAppendBodyBuffer(messageBody, bufferRegions, NULL, 0);
+		SPArrowAppendBodyBuffer(messageBody, bufferRegions, deltaOffsets.bytes, deltaOffsets.length);
+		SPArrowAppendBodyBuffer(messageBody, bufferRegions, column->dictionaryValues.bytes + entryOffsets[first], entryOffsets[first + count] - entryOffsets[first]);
+		SPArrowBufferFree(&deltaOffsets);
+
+		SPFlatBufferReset(builder);
+
+		uint32_t data = SPArrowCreateRecordBatch(builder, count, fieldNodes, bufferRegions);
+
+		SPFlatBufferStartTable(builder);
+		SPFlatBufferTableAddScalar(builder, 0, &dictionaryId, 8);
+		SPFlatBufferTableAddOffset(builder, 1, data);
+		SPFlatBufferTableAddScalar(builder, 2, &isDelta, 1);
+
+		SPArrowFinishMessage(builder, SPArrowMessageDictionaryBatch, SPFlatBufferEndTable(builder), (int64_t)messageBody->length);
+		[self _writeMessageToOutput:output block:dictionaryBlocks];
+
+		column->dictionaryWrittenCount = column->dictionaryCount;
+	}
+
+	if (!rowCount) return;
+
+	messageBody->length = fieldNodes->length = bufferRegions->length = 0;
+
+	for (i = 0; i < columnCount; i++)
+	{
+		SPArrowColumn *column = &columns[i];
+
+		node.length = (int64_t)rowCount;
+		node.nullCount = column->nullCount;
+
+		SPArrowBufferAppend(fieldNodes, &node, sizeof(node));
+
+		// The validity bitmap can be left out when there are no nulls
+		SPArrowAppendBodyBuffer(messageBody, bufferRegions, column->validity.bytes, column->nullCount ? column->validity.length : 0);
+
+		if (SPArrowColumnIsVariableWidth(column) && !column->dictionaryEncoded) {
+			SPArrowAppendBodyBuffer(messageBody, bufferRegions, column->offsets.bytes, column->offsets.length);
+		}
+
+		SPArrowAppendBodyBuffer(messageBody, bufferRegions, column->values.bytes, column->values.length);
+	}
+
+	SPFlatBufferReset(builder);
+	SPArrowFinishMessage(builder, SPArrowMessageRecordBatch, SPArrowCreateRecordBatch(builder, (int64_t)rowCount, fieldNodes, bufferRegions), (int64_t)messageBody->length);
+	[self _writeMessageToOutput:output block:recordBatchBlocks];
+
+	rowCount = 0;
+
+	for (i = 0; i < columnCount; i++) SPArrowColumnReset(&columns[i]);
+}
+
+/**
+ * Write any remaining rows followed by the end of stream marker and the file footer, which
+ * indexes every batch written.
+ */
+- (void)finishWritingToOutput:(id)output
+{
+	uint32_t endOfStream[2] = { 0xFFFFFFFF, 0 };
+	int16_t version = SPArrowMetadataVersion;
+	int32_t footerLength;
+
+	[self writeRecordBatchToOutput:output];
+	[self _writeBytes:endOfStream length:sizeof(endOfStream) toOutput:output];
+
+	SPFlatBufferReset(builder);
+
+	uint32_t recordBatches = SPFlatBufferCreateStructVector(builder, recordBatchBlocks->bytes, sizeof(SPArrowBlock), (uint32_t)(recordBatchBlocks->length / sizeof(SPArrowBlock)));
+	uint32_t dictionaries = SPFlatBufferCreateStructVector(builder, dictionaryBlocks->bytes, sizeof(SPArrowBlock), (uint32_t)(dictionaryBlocks->length / sizeof(SPArrowBlock)));
+	uint32_t schema = [self _createSchema];
+
+	SPFlatBufferStartTable(builder);
+	SPFlatBufferTableAddOffset(builder, 1, schema);
+	SPFlatBufferTableAddOffset(builder, 2, dictionaries);
+	SPFlatBufferTableAddOffset(builder, 3, recordBatches);
+	SPFlatBufferTableAddScalar(builder, 0, &version, 2);
+	SPFlatBufferFinish(builder, SPFlatBufferEndTable(builder));
+
+	footerLength = (int32_t)builder->size;
+
+	[self _writeBytes:SPFlatBufferBytes(builder) length:builder->size toOutput:output];
+	[self _writeBytes:&footerLength length:4 toOutput:output];
+	[self _writeBytes:"ARROW1" length:6 toOutput:output];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (id)_initWithColumnNames:(NSArray *)names
+{
+	if ((self = [super init])) {
+		columnNames = [names copy];
+		columnCount = [columnNames count];
+		columns = calloc(columnCount ? columnCount : 1, sizeof(SPArrowColumn));
+
+		builder = calloc(1, sizeof(SPFlatBufferBuilder));
+		messageBody = calloc(1, sizeof(SPArrowBuffer));
+		fieldNodes = calloc(1, sizeof(SPArrowBuffer));
+		bufferRegions = calloc(1, sizeof(SPArrowBuffer));
+		dictionaryBlocks = calloc(1, sizeof(SPArrowBuffer));
+		recordBatchBlocks = calloc(1, sizeof(SPArrowBuffer));
+	}
+
+	return self;
+}
+
+/**
+ * Build the Schema table, listing every column as a nullable field.
+ */
+- (uint32_t)_createSchema
+{
+	uint32_t *fields = malloc(sizeof(uint32_t) * (columnCount ? columnCount : 1));
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		const char *name = [[NSArrayObjectAtIndex(columnNames, i) description] UTF8String];
+		uint8_t typeType = 0, nullable = 1;
+		uint32_t dictionary = 0;
+
+		uint32_t nameOffset = SPFlatBufferCreateString(builder, name, strlen(name));
+		uint32_t type = SPArrowCreateTypeTable(builder, &columns[i], &typeType);
+		uint32_t children = SPFlatBufferCreateOffsetVector(builder, NULL, 0);
+
+		// Dictionary indices are signed 32-bit integers, with the dictionary identified by column
+		if (columns[i].dictionaryEncoded) {
+			int32_t indexWidth = 32;
+			uint8_t indexSigned = 1;
+			int64_t dictionaryId = (int64_t)i;
+
+			SPFlatBufferStartTable(builder);
+			SPFlatBufferTableAddScalar(builder, 0, &indexWidth, 4);
+			SPFlatBufferTableAddScalar(builder, 1, &indexSigned, 1);
+
+			uint32_t indexType = SPFlatBufferEndTable(builder);
+
+			SPFlatBufferStartTable(builder);
+			SPFlatBufferTableAddScalar(builder, 0, &dictionaryId, 8);
+			SPFlatBufferTableAddOffset(builder, 1, indexType);
+			dictionary = SPFlatBufferEndTable(builder);
+		}
+
+		SPFlatBufferStartTable(builder);
+		SPFlatBufferTableAddOffset(builder, 0, nameOffset);
+		SPFlatBufferTableAddOffset(builder, 3, type);
+		SPFlatBufferTableAddOffset(builder, 5, children);
+
+		if (dictionary) SPFlatBufferTableAddOffset(builder, 4, dictionary);
+
+		SPFlatBufferTableAddScalar(builder, 1, &nullable, 1);
+		SPFlatBufferTableAddScalar(builder, 2, &typeType, 1);
+
+		fields[i] = SPFlatBufferEndTable(builder);
+	}
+
+	uint32_t fieldVector = SPFlatBufferCreateOffsetVector(builder, fields, (uint32_t)columnCount);
+
+	free(fields);
+
+	SPFlatBufferStartTable(builder);
+	SPFlatBufferTableAddOffset(builder, 1, fieldVector);
+
+	return SPFlatBufferEndTable(builder);
+}
+
+/**
+ * Write the finished message in the builder, followed by the message body, recording its
+ * position in the supplied list of blocks for the footer if one is given.
+ */
+- (void)_writeMessageToOutput:(id)output block:(SPArrowBuffer *)blocks
+{
+	uint32_t continuation = 0xFFFFFFFF;
+	int32_t metadataLength = (int32_t)((builder->size + 7) & ~(size_t)7);
+	uint8_t padding[8] = { 0 };
+	SPArrowBlock block = { (int64_t)fileOffset, metadataLength + 8, 0, (int64_t)messageBody->length };
+
+	[self _writeBytes:&continuation length:4 toOutput:output];
+	[self _writeBytes:&metadataLength length:4 toOutput:output];
+	[self _writeBytes:SPFlatBufferBytes(builder) length:builder->size toOutput:output];
+	[self _writeBytes:padding length:(metadataLength - builder->size) toOutput:output];
+	[self _writeBytes:messageBody->bytes length:messageBody->length toOutput:output];
+
+	if (blocks) SPArrowBufferAppend(blocks, &block, sizeof(block));
+}
+
+- (void)_writeBytes:(const void *)bytes length:(NSUInteger)length toOutput:(id)output
+{
+	if (!length) return;
+
+	[output writeData:[NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO]];
+
+	fileOffset += length;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	for (NSUInteger i = 0; i < columnCount; i++) SPArrowColumnFree(&columns[i]);
+
+	free(columns);
+
+	SPArrowBufferFree(messageBody);
+	SPArrowBufferFree(fieldNodes);
+	SPArrowBufferFree(bufferRegions);
+	SPArrowBufferFree(dictionaryBlocks);
+	SPArrowBufferFree(recordBatchBlocks);
+
+	free(builder->bytes);
+	free(builder);
+	free(messageBody);
+	free(fieldNodes);
+	free(bufferRegions);
+	free(dictionaryBlocks);
+	free(recordBatchBlocks);
+
+	SPClear(columnNames);
+
+	[super dealloc];
+}
+
+@end
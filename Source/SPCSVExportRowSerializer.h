@@ -0,0 +1,96 @@
+//
+//  SPCSVExportRowSerializer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * How the cells of a column are written by an SPCSVExportRowSerializer.
+ */
+typedef enum {
+	SPCSVExportCellAsString   = 0, // Enclosed text
+	SPCSVExportCellAsNumber   = 1, // Numbers, written without enclosing characters
+	SPCSVExportCellAsBit      = 2, // BIT values, written as unenclosed zero-padded strings of bits
+	SPCSVExportCellAsGeometry = 3, // Geometry data, written as enclosed WKT text
+	SPCSVExportCellDetectingNumber = 4  // Text which is written unenclosed if it looks like a number, for columns of unknown type
+} SPCSVExportCellFormat;
+
+/**
+ * @class SPCSVExportRowSerializer SPCSVExportRowSerializer.h
+ *
+ * Serializes CSV rows into a byte buffer in the output encoding, matching the quoting and escaping
+ * of SPCSVExporter's string-based writer.  Each cell is first scanned, 16 bytes at a time where the
+ * CPU allows, for the leading bytes of the escape, enclosing, field separator and line ending
+ * strings; cells containing none of them are copied directly, and only the remainder go through
+ * escaping.  Raw rows retrieved from a streaming result are written without creating any objects.
+ *
+ * The separators are matched bytewise, so the serializer can only be used for UTF-8 and
+ * single-byte output encodings (see +supportsEncoding:).
+ */
+@interface SPCSVExportRowSerializer : NSObject
+{
+	NSUInteger columnCount;
+	SPCSVExportCellFormat *cellFormats;
+	NSUInteger *bitLengths;
+
+	NSStringEncoding stringEncoding;
+
+	NSData *fieldSeparator;
+	NSData *enclosingCharacter;
+	NSData *escapeString;
+	NSData *lineEnding;
+	NSData *nullString;
+
+	unsigned char stringSpecialBytes[4];
+	NSUInteger stringSpecialByteCount;
+	unsigned char numberSpecialBytes[4];
+	NSUInteger numberSpecialByteCount;
+
+	char *buffer;
+	NSUInteger bufferLength;
+	NSUInteger bufferCapacity;
+
+	char *escapeBuffers[2];
+	NSUInteger escapeBufferCapacities[2];
+}
+
++ (BOOL)supportsEncoding:(NSStringEncoding)encoding;
+
+- (id)initWithColumnCount:(NSUInteger)count stringEncoding:(NSStringEncoding)encoding fieldSeparator:(NSString *)separator enclosingCharacter:(NSString *)enclosing escapeString:(NSString *)escape lineEnding:(NSString *)lineEnd nullString:(NSString *)null;
+
+- (void)setFormat:(SPCSVExportCellFormat)format bitLength:(NSUInteger)bitLength forColumn:(NSUInteger)column;
+- (SPCSVExportCellFormat)formatForColumn:(NSUInteger)column;
+
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths;
+- (void)appendRow:(NSArray *)row;
+- (void)appendFieldNames:(NSArray *)fieldNames;
+
+- (NSUInteger)length;
+- (void)writeToOutput:(id)output;
+- (void)reset;
+
+@end
@@ -0,0 +1,496 @@
+//
+//  SPCSVExportRowSerializer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVExportRowSerializer.h"
+#import "SPExportByteScanning.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The initial size of the output buffer, which grows as required
+static const NSUInteger SPCSVExportRowSerializerInitialCapacity = 65536;
+
+// The widest BIT field supported by MySQL
+static const NSUInteger SPCSVExportMaximumBitLength = 64;
+
+@interface SPCSVExportRowSerializer ()
+
+- (void)_ensureCapacity:(NSUInteger)additionalLength;
+- (void)_appendData:(NSData *)data;
+- (void)_appendCellBytes:(const char *)bytes length:(NSUInteger)length enclosed:(BOOL)enclosed;
+- (void)_appendCellString:(NSString *)string enclosed:(BOOL)enclosed;
+- (void)_appendBitBytes:(const char *)bytes length:(NSUInteger)length padLength:(NSUInteger)padLength;
+- (const char *)_bytes:(const char *)bytes length:(NSUInteger *)length escapingOccurrencesOf:(NSData *)needle;
+
+@end
+
+/**
+ * Copies bytes to the output, inserting the escape string before each occurrence of the needle
+ * starting at the supplied first match.  Occurrences are found left to right without overlapping,
+ * as -[NSMutableString replaceOccurrencesOfString:withString:options:range:] does.  Returns the
+ * length written.
+ */
+static NSUInteger SPCSVExportEscapeOccurrences(const char *bytes, NSUInteger length, const char *firstMatch, const char *needle, NSUInteger needleLength, const char *escape, NSUInteger escapeLength, char *output)
+{
+	const char *end = bytes + length;
+	const char *runStart = bytes;
+	const char *match = firstMatch;
+	char *outputPosition = output;
+
+	while (match)
+	{
+		memcpy(outputPosition, runStart, match - runStart);
+		outputPosition += match - runStart;
+
+		memcpy(outputPosition, escape, escapeLength);
+		outputPosition += escapeLength;
+
+		memcpy(outputPosition, match, needleLength);
+		outputPosition += needleLength;
+
+		runStart = match + needleLength;
+		match = ((NSUInteger)(end - runStart) >= needleLength) ? memmem(runStart, end - runStart, needle, needleLength) : NULL;
+	}
+
+	memcpy(outputPosition, runStart, end - runStart);
+	outputPosition += end - runStart;
+
+	return outputPosition - output;
+}
+
+/**
+ * Returns whether a cell of a column of unknown type should be written as a number, using the same
+ * test as SPCSVExporter's string-based writer: the whole string must scan as a float, and numbers
+ * with a leading zero are only accepted if it's followed by a decimal point.
+ */
+static BOOL SPCSVExportStringLooksNumeric(NSString *string)
+{
+	NSUInteger length = [string length];
+
+	if (!length) return NO;
+
+	NSScanner *scanner = [[NSScanner alloc] initWithString:string];
+
+	BOOL numeric = [scanner scanFloat:NULL] && [scanner isAtEnd] &&
+		([string characterAtIndex:0] != '0' || length == 1 || [string characterAtIndex:1] == '.');
+
+	[scanner release];
+
+	return numeric;
+}
+
+/**
+ * Adds the leading byte of the supplied string to a set of special bytes, if not already present.
+ */
+static void SPCSVExportAddSpecialByte(NSData *string, unsigned char *specialBytes, NSUInteger *specialByteCount)
+{
+	if (![string length]) return;
+
+	unsigned char byte = ((const unsigned char *)[string bytes])[0];
+
+	for (NSUInteger i = 0; i < *specialByteCount; i++)
+	{
+		if (specialBytes[i] == byte) return;
+	}
+
+	specialBytes[(*specialByteCount)++] = byte;
+}
+
+@implementation SPCSVExportRowSerializer
+
+/**
+ * Returns whether rows can be serialized in the supplied encoding.
+ */
++ (BOOL)supportsEncoding:(NSStringEncoding)encoding
+{
+	return SPExportEncodingIsASCIICompatible(encoding);
+}
+
+/**
+ * Initialise a serializer for rows of the supplied number of columns, with all columns written as strings.
+ *
+ * @param count     The number of columns in each row
+ * @param encoding  The encoding of string data in raw rows, and of the output
+ * @param separator The field separator string, with any escaped tabs and line endings already restored
+ * @param enclosing The string fields are enclosed in, which may be empty
+ * @param escape    The string used to escape special strings within fields
+ * @param lineEnd   The line ending string, with any escaped tabs and line endings already restored
+ * @param null      The string written for NULL values
+ */
+- (id)initWithColumnCount:(NSUInteger)count stringEncoding:(NSStringEncoding)encoding fieldSeparator:(NSString *)separator enclosingCharacter:(NSString *)enclosing escapeString:(NSString *)escape lineEnding:(NSString *)lineEnd nullString:(NSString *)null
+{
+	if ((self = [super init])) {
+		columnCount = count;
+		cellFormats = calloc(MAX(count, 1), sizeof(SPCSVExportCellFormat));
+		bitLengths = calloc(MAX(count, 1), sizeof(NSUInteger));
+
+		stringEncoding = encoding;
+
+		fieldSeparator     = [[separator dataUsingEncoding:encoding allowLossyConversion:YES] retain];
+		enclosingCharacter = [[(enclosing ? enclosing : @"") dataUsingEncoding:encoding allowLossyConversion:YES] retain];
+		escapeString       = [[escape dataUsingEncoding:encoding allowLossyConversion:YES] retain];
+		lineEnding         = [[lineEnd dataUsingEncoding:encoding allowLossyConversion:YES] retain];
+		nullString         = [[(null ? null : @"") dataUsingEncoding:encoding allowLossyConversion:YES] retain];
+
+		// Enclosed cells only need the escape and enclosing strings escaped, unless there is no
+		// enclosing string; unenclosed cells also need the field separators and line endings escaped.
+		SPCSVExportAddSpecialByte(escapeString, stringSpecialBytes, &stringSpecialByteCount);
+		SPCSVExportAddSpecialByte(enclosingCharacter, stringSpecialBytes, &stringSpecialByteCount);
+
+		if (![enclosingCharacter length]) {
+			SPCSVExportAddSpecialByte(fieldSeparator, stringSpecialBytes, &stringSpecialByteCount);
+			SPCSVExportAddSpecialByte(lineEnding, stringSpecialBytes, &stringSpecialByteCount);
+		}
+
+		SPCSVExportAddSpecialByte(escapeString, numberSpecialBytes, &numberSpecialByteCount);
+		SPCSVExportAddSpecialByte(enclosingCharacter, numberSpecialBytes, &numberSpecialByteCount);
+		SPCSVExportAddSpecialByte(fieldSeparator, numberSpecialBytes, &numberSpecialByteCount);
+		SPCSVExportAddSpecialByte(lineEnding, numberSpecialBytes, &numberSpecialByteCount);
+
+		bufferCapacity = SPCSVExportRowSerializerInitialCapacity;
+		bufferLength = 0;
+		buffer = malloc(bufferCapacity);
+	}
+
+	return self;
+}
+
+/**
+ * Set how the cells of the specified column are written.  The bit length is the width BIT
+ * values in raw rows are padded to, and is otherwise ignored.
+ */
+- (void)setFormat:(SPCSVExportCellFormat)format bitLength:(NSUInteger)bitLength forColumn:(NSUInteger)column
+{
+	if (column >= columnCount) return;
+
+	cellFormats[column] = format;
+	bitLengths[column] = MIN(bitLength, SPCSVExportMaximumBitLength);
+}
+
+- (SPCSVExportCellFormat)formatForColumn:(NSUInteger)column
+{
+	return (column < columnCount) ? cellFormats[column] : SPCSVExportCellAsString;
+}
+
+#pragma mark -
+#pragma mark Row serialization
+
+/**
+ * Append the cells of a raw row, as returned by -[SPMySQLStreamingResult getRawRowCells:lengths:],
+ * followed by the line ending.
+ */
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths
+{
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		if (i) [self _appendData:fieldSeparator];
+
+		const char *cell = cells[i];
+		NSUInteger length = lengths[i];
+
+		if (cell == NULL) {
+			[self _appendData:nullString];
+			continue;
+		}
+
+		switch (cellFormats[i])
+		{
+			case SPCSVExportCellAsString:
+			case SPCSVExportCellDetectingNumber:
+				[self _appendCellBytes:cell length:length enclosed:YES];
+				break;
+
+			case SPCSVExportCellAsNumber:
+				[self _appendCellBytes:cell length:length enclosed:NO];
+				break;
+
+			case SPCSVExportCellAsBit:
+				[self _appendBitBytes:cell length:length padLength:bitLengths[i]];
+				break;
+
+			case SPCSVExportCellAsGeometry:
+				if (!length) {
+					[self _appendCellBytes:cell length:0 enclosed:YES];
+				}
+				else {
+					SPMySQLGeometryData *geometry = [[SPMySQLGeometryData alloc] initWithBytes:cell length:length];
+
+					[self _appendCellString:[geometry wktString] enclosed:YES];
+
+					[geometry release];
+				}
+				break;
+		}
+	}
+
+	[self _appendData:lineEnding];
+}
+
+/**
+ * Append the cells of a row supplied as an array of objects, followed by the line ending.  Geometry
+ * data is detected from the objects' classes rather than the column formats, and cells of columns
+ * detecting numbers are tested individually.
+ */
+- (void)appendRow:(NSArray *)row
+{
+	NSNull *null = [NSNull null];
+	NSUInteger count = MIN([row count], columnCount);
+
+	for (NSUInteger i = 0; i < count; i++)
+	{
+		if (i) [self _appendData:fieldSeparator];
+
+		id object = [row objectAtIndex:i];
+
+		if (object == null) {
+			[self _appendData:nullString];
+			continue;
+		}
+
+		// Bit values are already converted to strings of bits, so are written like numbers
+		BOOL enclosed = (cellFormats[i] == SPCSVExportCellAsString || cellFormats[i] == SPCSVExportCellAsGeometry);
+
+		if ([object isKindOfClass:[SPMySQLGeometryData class]]) {
+			[self _appendCellString:[object wktString] enclosed:YES];
+		}
+		else if ([object isKindOfClass:[NSData class]]) {
+			[self _appendCellBytes:[object bytes] length:[object length] enclosed:(enclosed || cellFormats[i] == SPCSVExportCellDetectingNumber)];
+		}
+		else if (cellFormats[i] == SPCSVExportCellDetectingNumber) {
+			NSString *string = [object description];
+
+			[self _appendCellString:string enclosed:!SPCSVExportStringLooksNumeric(string)];
+		}
+		else {
+			[self _appendCellString:[object description] enclosed:enclosed];
+		}
+	}
+
+	[self _appendData:lineEnding];
+}
+
+/**
+ * Append a row of field names, all written as enclosed strings, followed by the line ending.
+ */
+- (void)appendFieldNames:(NSArray *)fieldNames
+{
+	NSUInteger count = [fieldNames count];
+
+	for (NSUInteger i = 0; i < count; i++)
+	{
+		if (i) [self _appendData:fieldSeparator];
+
+		[self _appendCellString:[fieldNames objectAtIndex:i] enclosed:YES];
+	}
+
+	[self _appendData:lineEnding];
+}
+
+#pragma mark -
+#pragma mark Buffer handling
+
+- (NSUInteger)length
+{
+	return bufferLength;
+}
+
+/**
+ * Write the buffered output to the supplied export file or file handle, and empty the buffer.
+ */
+- (void)writeToOutput:(id)output
+{
+	if (!bufferLength) return;
+
+	[output writeData:[NSData dataWithBytesNoCopy:buffer length:bufferLength freeWhenDone:NO]];
+
+	bufferLength = 0;
+}
+
+/**
+ * Discard any buffered output.
+ */
+- (void)reset
+{
+	bufferLength = 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (void)_ensureCapacity:(NSUInteger)additionalLength
+{
+	if (bufferLength + additionalLength <= bufferCapacity) return;
+
+	while (bufferLength + additionalLength > bufferCapacity) bufferCapacity *= 2;
+
+	buffer = realloc(buffer, bufferCapacity);
+}
+
+- (void)_appendData:(NSData *)data
+{
+	NSUInteger length = [data length];
+
+	[self _ensureCapacity:length];
+
+	memcpy(buffer + bufferLength, [data bytes], length);
+	bufferLength += length;
+}
+
+/**
+ * Append a cell, enclosed in the enclosing string if required.  Empty cells are always written as
+ * a pair of enclosing strings.  Occurrences of the escape string, and of the enclosing string when
+ * it differs, are escaped; for unenclosed cells, or when there is no enclosing string, so are the
+ * field separator and line ending.
+ */
+- (void)_appendCellBytes:(const char *)bytes length:(NSUInteger)length enclosed:(BOOL)enclosed
+{
+	NSUInteger enclosingLength = [enclosingCharacter length];
+
+	if (!length) {
+		[self _appendData:enclosingCharacter];
+		[self _appendData:enclosingCharacter];
+		return;
+	}
+
+	BOOL escapesSeparators = (!enclosed || !enclosingLength);
+
+	// Cells which contain none of the special strings' leading bytes are copied directly
+	NSUInteger specialByteIndex = (escapesSeparators) ?
+		SPExportFindByteInSet(bytes, length, numberSpecialBytes, numberSpecialByteCount) :
+		SPExportFindByteInSet(bytes, length, stringSpecialBytes, stringSpecialByteCount);
+
+	if (specialByteIndex < length) {
+		bytes = [self _bytes:bytes length:&length escapingOccurrencesOf:escapeString];
+
+		if (![enclosingCharacter isEqualToData:escapeString]) {
+			bytes = [self _bytes:bytes length:&length escapingOccurrencesOf:enclosingCharacter];
+		}
+
+		if (escapesSeparators) {
+			bytes = [self _bytes:bytes length:&length escapingOccurrencesOf:fieldSeparator];
+			bytes = [self _bytes:bytes length:&length escapingOccurrencesOf:lineEnding];
+		}
+	}
+
+	[self _ensureCapacity:length + (enclosed ? enclosingLength * 2 : 0)];
+
+	char *output = buffer + bufferLength;
+
+	if (enclosed) {
+		memcpy(output, [enclosingCharacter bytes], enclosingLength);
+		output += enclosingLength;
+	}
+
+	memcpy(output, bytes, length);
+	output += length;
+
+	if (enclosed) {
+		memcpy(output, [enclosingCharacter bytes], enclosingLength);
+		output += enclosingLength;
+	}
+
+	bufferLength = output - buffer;
+}
+
+- (void)_appendCellString:(NSString *)string enclosed:(BOOL)enclosed
+{
+	NSData *stringData = [string dataUsingEncoding:stringEncoding allowLossyConversion:YES];
+
+	[self _appendCellBytes:[stringData bytes] length:[stringData length] enclosed:enclosed];
+}
+
+/**
+ * Append BIT data as an unenclosed string of bits, zero-padded to the field's bit length in the
+ * same way SPMySQL converts BIT values to strings.
+ */
+- (void)_appendBitBytes:(const char *)bytes length:(NSUInteger)length padLength:(NSUInteger)padLength
+{
+	char bitString[SPCSVExportMaximumBitLength];
+	NSUInteger bitLength = MIN(length << 3, padLength);
+
+	memset(bitString, '0', padLength);
+
+	// Fill in from the least significant bit, the rightmost bit of the last byte
+	for (NSUInteger i = 0; i < bitLength; i++)
+	{
+		if (bytes[(length - 1) - (i >> 3)] & (1 << (i % 8))) bitString[padLength - 1 - i] = '1';
+	}
+
+	[self _appendCellBytes:bitString length:padLength enclosed:NO];
+}
+
+/**
+ * Returns the supplied bytes with the escape string inserted before each occurrence of the needle,
+ * updating the length.  When there are no occurrences the bytes are returned unchanged; otherwise
+ * the result is written to whichever escape buffer doesn't hold the input.
+ */
+- (const char *)_bytes:(const char *)bytes length:(NSUInteger *)length escapingOccurrencesOf:(NSData *)needle
+{
+	NSUInteger needleLength = [needle length];
+
+	if (!needleLength || *length < needleLength) return bytes;
+
+	const char *match = memmem(bytes, *length, [needle bytes], needleLength);
+
+	if (!match) return bytes;
+
+	NSUInteger escapeLength = [escapeString length];
+	NSUInteger outputIndex = (bytes == escapeBuffers[0]) ? 1 : 0;
+	NSUInteger requiredCapacity = *length + ((*length / needleLength) + 1) * escapeLength;
+
+	if (escapeBufferCapacities[outputIndex] < requiredCapacity) {
+		escapeBuffers[outputIndex] = realloc(escapeBuffers[outputIndex], requiredCapacity);
+		escapeBufferCapacities[outputIndex] = requiredCapacity;
+	}
+
+	*length = SPCSVExportEscapeOccurrences(bytes, *length, match, [needle bytes], needleLength, [escapeString bytes], escapeLength, escapeBuffers[outputIndex]);
+
+	return escapeBuffers[outputIndex];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(fieldSeparator);
+	SPClear(enclosingCharacter);
+	SPClear(escapeString);
+	SPClear(lineEnding);
+	SPClear(nullString);
+
+	free(cellFormats);
+	free(bitLengths);
+	free(buffer);
+	free(escapeBuffers[0]);
+	free(escapeBuffers[1]);
+
+	[super dealloc];
+}
+
+@end
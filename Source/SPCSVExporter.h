@@ -44,8 +44,6 @@
 {		
 	NSObject <SPCSVExporterProtocol> *delegate;
 	
-	NSArray *csvDataArray;
-	
 	NSString *csvTableName;
 	NSString *csvFieldSeparatorString;
 	NSString *csvEnclosingCharacterString;
@@ -63,11 +61,6 @@
  */
 @property(readwrite, assign) NSObject <SPCSVExporterProtocol> *delegate;
 
-/** 
- * @property csvDataArray Data array
- */
-@property(readwrite, retain) NSArray *csvDataArray;
-
 /**
  * @property csvTableName Table name
  */
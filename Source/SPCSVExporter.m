@@ -33,13 +33,24 @@
 #import "SPTableData.h"
 #import "SPExportUtilities.h"
 #import "SPExportFile.h"
+#import "SPExportConnectionPool.h"
+#import "SPExportChunkedTableReader.h"
+#import "SPCSVExportRowSerializer.h"
 
 #import <SPMySQL/SPMySQL.h>
 
+// The length of serialized rows collected before they are written to the file
+static const NSUInteger SPCSVExportSerializedWriteLength = 262144;
+
+@interface SPCSVExporter ()
+
+- (BOOL)_writeRowsFromSource:(id <SPExportRowSource>)rowSource;
+
+@end
+
 @implementation SPCSVExporter
 
 @synthesize delegate;
-@synthesize csvDataArray;
 @synthesize csvTableName;
 @synthesize csvOutputFieldNames;
 @synthesize csvFieldSeparatorString;
@@ -76,10 +87,15 @@
 	NSMutableString *csvCellString = [NSMutableString string];
 	
 	NSMutableArray *tableColumnNumericStatus = [NSMutableArray array];
+	NSMutableArray *tableColumnBitStatus = [NSMutableArray array];
 
 	NSArray *csvRow = nil;
 	NSScanner *csvNumericTester = nil;
-	SPMySQLFastStreamingResult *streamingResult = nil;
+	id streamingResult = nil;
+	id <SPExportRowSource> rowSource = [self exportRowSource];
+	NSDictionary *tableDetails = nil;
+	SPExportConnectionPool *connectionPool = nil;
+	SPMySQLConnection *readerConnection = nil;
 	NSString *escapedEscapeString, *escapedFieldSeparatorString, *escapedEnclosingString, *escapedLineEndString, *dataConversionString;
 
 	id csvCell;
@@ -89,9 +105,9 @@
 	double lastProgressValue;
 	NSUInteger i, totalRows, csvCellCount = 0;
 	
-	// Check to see if we have at least a table name or data array
-	if ((![self csvTableName] && ![self csvDataArray]) ||
-		([[self csvTableName] isEqualToString:@""] && [[self csvDataArray] count] == 0))
+	// Check to see if we have at least a table name or row source
+	if ((![self csvTableName] && !rowSource) ||
+		([[self csvTableName] isEqualToString:@""] && ![[rowSource exportFieldNames] count]))
 	{
 		return;
 	}
@@ -122,9 +138,7 @@
 
 	// Before the streaming query is started, build an array of numeric columns if a table
 	// is being exported
-	if ([self csvTableName] && (![self csvDataArray])) {
-		NSDictionary *tableDetails = nil;
-		
+	if ([self csvTableName] && !rowSource) {
 		// Determine whether the supplied table is actually a table or a view via the CREATE TABLE command, and get the table details
 		SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"SHOW CREATE TABLE %@", [[self csvTableName] backtickQuotedString]]];
 		[queryResult setReturnDataAsStrings:YES];
@@ -145,16 +159,44 @@
 					|| [tableColumnTypeGrouping isEqualToString:@"integer"]
 					|| [tableColumnTypeGrouping isEqualToString:@"float"])
 			]]; 
+			[tableColumnBitStatus addObject:[NSNumber numberWithBool:[tableColumnTypeGrouping isEqualToString:@"bit"]]];
 		}
-		
-		[tableDetails release];
 	}
 
-	// Make a streaming request for the data if the data array isn't set
-	if ((![self csvDataArray]) && [self csvTableName]) {
+	// Make a streaming request for the data if there's no row source
+	if (!rowSource && [self csvTableName]) {
 		totalRows		= [[connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [[self csvTableName] backtickQuotedString]]] integerValue];
-		streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self csvTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming]];
+
+		// For large tables, read key ranges concurrently across a pool of connections sharing a snapshot
+		NSString *chunkingKey = ([self exportParallelConnections] > 1) ? [SPExportChunkedTableReader chunkingKeyForTableDetails:tableDetails rowCount:totalRows] : nil;
+
+		if (chunkingKey) {
+			connectionPool = [[SPExportConnectionPool alloc] initWithConnection:connection];
+
+			// Chunks read on separate connections are only consistent if their snapshots were started
+			// under a global read lock; otherwise the table is read as a single stream
+			if ([connectionPool openConnections:[self exportParallelConnections]] && [connectionPool usesSharedSnapshot]) {
+				readerConnection = [connectionPool checkoutConnection];
+
+				streamingResult = [[[SPExportChunkedTableReader alloc] initWithTableName:[self csvTableName] keyColumn:chunkingKey selectColumns:@"*" connection:readerConnection connectionPool:connectionPool] autorelease];
+				[streamingResult startReading];
+			}
+			else {
+				[connectionPool close];
+				SPClear(connectionPool);
+			}
+		}
+
+		if (!streamingResult) {
+			streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self csvTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming]];
+		}
+
+		[self beginRecordingTable:[self csvTableName] readingResult:streamingResult];
+
+		[[self exportOutputFile] addTableToCurrentPart:[self csvTableName]];
 	}
+
+	if (tableDetails) SPClear(tableDetails);
 	
 	// Detect and restore special characters being used as terminating or line end strings
 	NSMutableString *tempSeparatorString = [NSMutableString stringWithString:[self csvFieldSeparatorString]];
@@ -200,14 +242,60 @@
 	escapedEnclosingString      = [[self csvEscapeString] stringByAppendingString:[self csvEnclosingCharacterString]];
 	escapedLineEndString        = [[self csvEscapeString] stringByAppendingString:[self csvLineEndingString]];
 	
-	// Set up the starting row; for supplied arrays, which include the column
-	// headers as the first row, decide whether to skip the first row.
+	// Table rows are serialized bytewise when the output encoding allows it; rows of a streaming result
+	// are serialized directly from the raw MySQL row data if it's already in the output encoding.
+	SPCSVExportRowSerializer *rowSerializer = nil;
+	const char **rawRowCells = NULL;
+	unsigned long *rawRowCellLengths = NULL;
+	NSUInteger tableColumnCount = [tableColumnNumericStatus count];
+
+	if (streamingResult && tableColumnCount && [SPCSVExportRowSerializer supportsEncoding:[self exportOutputEncoding]]) {
+		BOOL useRawRows = [streamingResult isKindOfClass:[SPMySQLStreamingResult class]] && ([connection stringEncoding] == [self exportOutputEncoding]);
+
+		rowSerializer = [[SPCSVExportRowSerializer alloc] initWithColumnCount:tableColumnCount
+		                                                       stringEncoding:[self exportOutputEncoding]
+		                                                       fieldSeparator:[self csvFieldSeparatorString]
+		                                                   enclosingCharacter:[self csvEnclosingCharacterString]
+		                                                         escapeString:[self csvEscapeString]
+		                                                           lineEnding:[self csvLineEndingString]
+		                                                           nullString:[self csvNULLString]];
+
+		for (i = 0; i < tableColumnCount; i++)
+		{
+			SPCSVExportCellFormat cellFormat = [NSArrayObjectAtIndex(tableColumnNumericStatus, i) boolValue] ? SPCSVExportCellAsNumber : SPCSVExportCellAsString;
+			NSUInteger bitLength = 0;
+
+			// Raw rows carry no object types, so BIT and geometry data are identified from the result fields
+			if (useRawRows) {
+				if ([NSArrayObjectAtIndex(tableColumnBitStatus, i) boolValue]) {
+					cellFormat = SPCSVExportCellAsBit;
+					bitLength = [streamingResult bitLengthForFieldAtIndex:i];
+				}
+				else if ([streamingResult fieldProcessorForFieldAtIndex:i] == SPMySQLResultFieldAsGeometry) {
+					cellFormat = SPCSVExportCellAsGeometry;
+				}
+			}
+
+			[rowSerializer setFormat:cellFormat bitLength:bitLength forColumn:i];
+		}
+
+		if (useRawRows) {
+			rawRowCells = malloc(sizeof(char *) * tableColumnCount);
+			rawRowCellLengths = malloc(sizeof(unsigned long) * tableColumnCount);
+		}
+	}
+
+	// Set up the starting row; rows of a row source are counted from the column headers
+	// as the first row, so decide whether to skip the first row.
 	NSUInteger currentRowIndex = 0;
 	
 	[csvString setString:@""];
 	
-	if ([self csvDataArray]) totalRows = [[self csvDataArray] count];
-	if (([self csvDataArray]) && (![self csvOutputFieldNames])) currentRowIndex++;
+	if (rowSource) totalRows = [rowSource numberOfExportRows] + 1;
+	if (rowSource && (![self csvOutputFieldNames])) currentRowIndex++;
+
+	// Each part of a split export file repeats the field names if they're included
+	BOOL partsIncludeFieldNames = [self csvOutputFieldNames];
 		
 	// Drop into the processing loop
 	NSAutoreleasePool *csvExportPool = [[NSAutoreleasePool alloc] init];
@@ -216,160 +304,228 @@
 	
 	// Inform the delegate that we are about to start writing the data to disk
 	[delegate performSelectorOnMainThread:@selector(csvExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+
+	// Rows of a row source are serialized bytewise in concurrent chunks if the output encoding allows it
+	BOOL rowSourceWritten = NO;
+
+	if (rowSource && [SPCSVExportRowSerializer supportsEncoding:[self exportOutputEncoding]]) {
+		if (![self _writeRowsFromSource:rowSource]) {
+			[csvExportPool release];
+
+			return;
+		}
+
+		rowSourceWritten = YES;
+	}
 	
-	while (1) 
+	while (!rowSourceWritten) 
 	{
 		// Check for cancellation flag
 		if ([self isCancelled]) {
 			if (streamingResult) {
-				[connection cancelCurrentQuery];
+				[(readerConnection ? readerConnection : connection) cancelCurrentQuery];
 				[streamingResult cancelResultLoad];
 			}
+
+			if (connectionPool) {
+				[connectionPool close];
+				SPClear(connectionPool);
+			}
+
+			if (rowSerializer) SPClear(rowSerializer);
+			if (rawRowCells) free(rawRowCells);
+			if (rawRowCellLengths) free(rawRowCellLengths);
 			
 			[csvExportPool release];
 
 			return;
 		}
-		
-		// Retrieve the next row from the supplied data, either directly from the array...
-		BOOL forceNonNumericRow = NO;
-		if ([self csvDataArray]) {
-			csvRow = NSArrayObjectAtIndex([self csvDataArray], currentRowIndex);
-		} 
-		// Or by reading an appropriate row from the streaming result
-		else {
-			// If still requested to read the field names, get the field names
+
+		// Serialize table rows bytewise if possible, writing them out in large blocks
+		if (rowSerializer) {
 			if ([self csvOutputFieldNames]) {
-				csvRow = [streamingResult fieldNames];
+				[rowSerializer appendFieldNames:[streamingResult fieldNames]];
 				[self setCsvOutputFieldNames:NO];
-				forceNonNumericRow = YES;
-			} 
+			}
+			else if (rawRowCells) {
+				if (![streamingResult getRawRowCells:rawRowCells lengths:rawRowCellLengths]) break;
+
+				[rowSerializer appendRawRowCells:rawRowCells lengths:rawRowCellLengths];
+			}
 			else {
 				csvRow = [streamingResult getRowAsArray];
-				
+
 				if (!csvRow) break;
+
+				[rowSerializer appendRow:csvRow];
+			}
+
+			if ([rowSerializer length] >= SPCSVExportSerializedWriteLength) {
+				[rowSerializer writeToOutput:[self exportOutputFile]];
+
+				// Only whole rows have been written, so a split export file can roll over to a new part
+				if ([[self exportOutputFile] needsNewPart] && [[self exportOutputFile] beginNewPart]) {
+					[[self exportOutputFile] addTableToCurrentPart:[self csvTableName]];
+
+					if (partsIncludeFieldNames) [rowSerializer appendFieldNames:[streamingResult fieldNames]];
+				}
+
+				// Drain the autorelease pool with each write to keep memory usage low
+				[csvExportPool release];
+				csvExportPool = [[NSAutoreleasePool alloc] init];
 			}
 		}
+		else {
+			// Retrieve the next row from the supplied data, either from the row source...
+			BOOL forceNonNumericRow = NO;
+			if (rowSource) {
+				if (currentRowIndex == totalRows) break;
+
+				if (currentRowIndex == 0) {
+					csvRow = [rowSource exportFieldNames];
+					forceNonNumericRow = YES;
+				}
+				else {
+					csvRow = [rowSource exportRowAtIndex:currentRowIndex - 1];
+
+					[self recordRowsWrittenFromSource:1];
+				}
+			} 
+			// Or by reading an appropriate row from the streaming result
+			else {
+				// If still requested to read the field names, get the field names
+				if ([self csvOutputFieldNames]) {
+					csvRow = [streamingResult fieldNames];
+					[self setCsvOutputFieldNames:NO];
+					forceNonNumericRow = YES;
+				} 
+				else {
+					csvRow = [streamingResult getRowAsArray];
+				
+					if (!csvRow) break;
+				}
+			}
 		
-		// Get the cell count if we don't already have it stored
-		if (!csvCellCount) csvCellCount = [csvRow count];
+			// Get the cell count if we don't already have it stored
+			if (!csvCellCount) csvCellCount = [csvRow count];
 					
-		[csvString setString:@""];
+			[csvString setString:@""];
 		
-		for (i = 0 ; i < csvCellCount; i++) 
-		{
-			// Check for cancellation flag
-			if ([self isCancelled]) {
-				[csvExportPool release];
+			for (i = 0 ; i < csvCellCount; i++) 
+			{
+				// Check for cancellation flag
+				if ([self isCancelled]) {
+					[csvExportPool release];
 
-				return;
-			}
+					return;
+				}
 			
-			csvCell = NSArrayObjectAtIndex(csvRow, i);
+				csvCell = NSArrayObjectAtIndex(csvRow, i);
 							
-			// For NULL objects supplied from a queryResult, add an unenclosed null string as per prefs
-			if ([csvCell isNSNull]) {
-				[csvString appendString:[self csvNULLString]];
+				// For NULL objects supplied from a queryResult, add an unenclosed null string as per prefs
+				if ([csvCell isNSNull]) {
+					[csvString appendString:[self csvNULLString]];
 				
-				if (i < (csvCellCount - 1)) [csvString appendString:[self csvFieldSeparatorString]];
+					if (i < (csvCellCount - 1)) [csvString appendString:[self csvFieldSeparatorString]];
 				
-				continue;
-			}
+					continue;
+				}
 			
-			// Retrieve the contents of this cell
-			if ([csvCell isKindOfClass:[NSData class]]) {
-				dataConversionString = [[NSString alloc] initWithData:csvCell encoding:[self exportOutputEncoding]];
+				// Retrieve the contents of this cell
+				if ([csvCell isKindOfClass:[NSData class]]) {
+					dataConversionString = [[NSString alloc] initWithData:csvCell encoding:[self exportOutputEncoding]];
 				
-				if (dataConversionString == nil) {
-					dataConversionString = [[NSString alloc] initWithData:csvCell encoding:NSASCIIStringEncoding];
-				}
+					if (dataConversionString == nil) {
+						dataConversionString = [[NSString alloc] initWithData:csvCell encoding:NSASCIIStringEncoding];
+					}
 				
-				[csvCellString setString:[NSString stringWithString:dataConversionString]];
-				[dataConversionString release];
-			}
-			else if ([csvCell isKindOfClass:[SPMySQLGeometryData class]]) {
-				[csvCellString setString:[csvCell wktString]];
-			}
-			else {
-				[csvCellString setString:[csvCell description]];
-			}
+					[csvCellString setString:[NSString stringWithString:dataConversionString]];
+					[dataConversionString release];
+				}
+				else if ([csvCell isKindOfClass:[SPMySQLGeometryData class]]) {
+					[csvCellString setString:[csvCell wktString]];
+				}
+				else {
+					[csvCellString setString:[csvCell description]];
+				}
 			
-			// Add empty strings as a pair of enclosing characters.
-			if ([csvCellString length] == 0) {
-				[csvString appendString:[self csvEnclosingCharacterString]];
-				[csvString appendString:[self csvEnclosingCharacterString]];
-			}
-			else {
-				// is this the header row?
-				if (forceNonNumericRow) {
-					csvCellIsNumeric = NO;
+				// Add empty strings as a pair of enclosing characters.
+				if ([csvCellString length] == 0) {
+					[csvString appendString:[self csvEnclosingCharacterString]];
+					[csvString appendString:[self csvEnclosingCharacterString]];
 				}
-				// If an array of bools supplying information as to whether the column is numeric has been supplied, use it.
-				else if ([tableColumnNumericStatus count] > 0) {
-					csvCellIsNumeric = [NSArrayObjectAtIndex(tableColumnNumericStatus, i) boolValue];
-				} 
-				// Otherwise, first test whether this cell contains data
-				else if ([NSArrayObjectAtIndex(csvRow, i) isKindOfClass:[NSData class]]) {
-					csvCellIsNumeric = NO;
-				} 
-				// Or fall back to testing numeric content via an NSScanner.
 				else {
-					csvNumericTester = [NSScanner scannerWithString:csvCellString];
+					// is this the header row?
+					if (forceNonNumericRow) {
+						csvCellIsNumeric = NO;
+					}
+					// If an array of bools supplying information as to whether the column is numeric has been supplied, use it.
+					else if ([tableColumnNumericStatus count] > 0) {
+						csvCellIsNumeric = [NSArrayObjectAtIndex(tableColumnNumericStatus, i) boolValue];
+					} 
+					// Otherwise, first test whether this cell contains data
+					else if ([NSArrayObjectAtIndex(csvRow, i) isKindOfClass:[NSData class]]) {
+						csvCellIsNumeric = NO;
+					} 
+					// Or fall back to testing numeric content via an NSScanner.
+					else {
+						csvNumericTester = [NSScanner scannerWithString:csvCellString];
 					
-					csvCellIsNumeric = [csvNumericTester scanFloat:nil] && 
-					[csvNumericTester isAtEnd] && 
-					([csvCellString characterAtIndex:0] != '0' || 
-					 [csvCellString length] == 1 || 
-					 ([csvCellString length] > 1 && 
-					  [csvCellString characterAtIndex:1] == '.'));
-				}
+						csvCellIsNumeric = [csvNumericTester scanFloat:nil] && 
+						[csvNumericTester isAtEnd] && 
+						([csvCellString characterAtIndex:0] != '0' || 
+						 [csvCellString length] == 1 || 
+						 ([csvCellString length] > 1 && 
+						  [csvCellString characterAtIndex:1] == '.'));
+					}
 									
-				// Escape any occurrences of the escaping character
-				[csvCellString replaceOccurrencesOfString:[self csvEscapeString]
-											   withString:escapedEscapeString
-												  options:NSLiteralSearch
-													range:NSMakeRange(0, [csvCellString length])];
-				
-				// Escape any occurrences of the enclosure string
-				if (![[self csvEscapeString] isEqualToString:[self csvEnclosingCharacterString]]) {
-					[csvCellString replaceOccurrencesOfString:[self csvEnclosingCharacterString]
-												   withString:escapedEnclosingString
+					// Escape any occurrences of the escaping character
+					[csvCellString replaceOccurrencesOfString:[self csvEscapeString]
+												   withString:escapedEscapeString
 													  options:NSLiteralSearch
 														range:NSMakeRange(0, [csvCellString length])];
-				}
 				
-				// If the string isn't quoted or otherwise enclosed, escape occurrences of the field separators and line end character
-				if (quoteFieldSeparators || csvCellIsNumeric) {
-					[csvCellString replaceOccurrencesOfString:[self csvFieldSeparatorString]
-												   withString:escapedFieldSeparatorString
-													  options:NSLiteralSearch
-														range:NSMakeRange(0, [csvCellString length])];
-					[csvCellString replaceOccurrencesOfString:[self csvLineEndingString]
-												   withString:escapedLineEndString
-													  options:NSLiteralSearch
-														range:NSMakeRange(0, [csvCellString length])];
-				}
+					// Escape any occurrences of the enclosure string
+					if (![[self csvEscapeString] isEqualToString:[self csvEnclosingCharacterString]]) {
+						[csvCellString replaceOccurrencesOfString:[self csvEnclosingCharacterString]
+													   withString:escapedEnclosingString
+														  options:NSLiteralSearch
+															range:NSMakeRange(0, [csvCellString length])];
+					}
 				
-				// Write out the cell data by appending strings - this is significantly faster than stringWithFormat.
-				if (csvCellIsNumeric) {
-					[csvString appendString:csvCellString];
-				} 
-				else {
-					[csvString appendString:[self csvEnclosingCharacterString]];
-					[csvString appendString:csvCellString];
-					[csvString appendString:[self csvEnclosingCharacterString]];
+					// If the string isn't quoted or otherwise enclosed, escape occurrences of the field separators and line end character
+					if (quoteFieldSeparators || csvCellIsNumeric) {
+						[csvCellString replaceOccurrencesOfString:[self csvFieldSeparatorString]
+													   withString:escapedFieldSeparatorString
+														  options:NSLiteralSearch
+															range:NSMakeRange(0, [csvCellString length])];
+						[csvCellString replaceOccurrencesOfString:[self csvLineEndingString]
+													   withString:escapedLineEndString
+														  options:NSLiteralSearch
+															range:NSMakeRange(0, [csvCellString length])];
+					}
+				
+					// Write out the cell data by appending strings - this is significantly faster than stringWithFormat.
+					if (csvCellIsNumeric) {
+						[csvString appendString:csvCellString];
+					} 
+					else {
+						[csvString appendString:[self csvEnclosingCharacterString]];
+						[csvString appendString:csvCellString];
+						[csvString appendString:[self csvEnclosingCharacterString]];
+					}
 				}
-			}
 			
-			if (i < ([csvRow count] - 1)) [csvString appendString:[self csvFieldSeparatorString]];
-		}
+				if (i < ([csvRow count] - 1)) [csvString appendString:[self csvFieldSeparatorString]];
+			}
 		
-		// Append the line ending to the string for this row, and record the length processed for pool flushing
-		[csvString appendString:[self csvLineEndingString]];
-		currentPoolDataLength += [csvString length];
+			// Append the line ending to the string for this row, and record the length processed for pool flushing
+			[csvString appendString:[self csvLineEndingString]];
+			currentPoolDataLength += [csvString length];
 		
-		// Write it to the fileHandle
-		[self writeString:csvString];
+			// Write it to the fileHandle
+			[self writeString:csvString];
+		}
 		
 		currentRowIndex++;
 		
@@ -387,15 +543,30 @@
 		[delegate performSelectorOnMainThread:@selector(csvExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
 		
 		// Drain the autorelease pool as required to keep memory usage low
-		if (currentPoolDataLength > 250000) {
+		if (!rowSerializer && currentPoolDataLength > 250000) {
 			[csvExportPool release];
 			csvExportPool = [[NSAutoreleasePool alloc] init];
 		}
 		
-		// If an array was supplied and we've processed all rows, break
-		if ([self csvDataArray] && (totalRows == currentRowIndex)) break;
+		// If a row source was supplied and we've processed all rows, break
+		if (rowSource && (totalRows == currentRowIndex)) break;
 	}
+
+	[self endRecordingTable:[self csvTableName]];
 	
+	if (connectionPool) {
+		[connectionPool close];
+		SPClear(connectionPool);
+	}
+
+	if (rowSerializer) {
+		[rowSerializer writeToOutput:[self exportOutputFile]];
+		SPClear(rowSerializer);
+	}
+
+	if (rawRowCells) free(rawRowCells);
+	if (rawRowCellLengths) free(rawRowCellLengths);
+
 	// Write data to disk
 	[[[self exportOutputFile] exportFileHandle] synchronizeFile];
 	
@@ -408,11 +579,88 @@
 	[csvExportPool release];
 }
 
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Write the field names if required and all the rows of the supplied row source, serializing chunks
+ * of rows concurrently.  Cells of the rows are written unenclosed if they look like numbers.
+ *
+ * @return NO if the export was cancelled
+ */
+- (BOOL)_writeRowsFromSource:(id <SPExportRowSource>)rowSource
+{
+	NSArray *fieldNames = [rowSource exportFieldNames];
+	NSUInteger columnCount = [fieldNames count];
+	NSUInteger totalRows = [rowSource numberOfExportRows];
+	BOOL partsIncludeFieldNames = [self csvOutputFieldNames];
+
+	__block double lastProgressValue = 0;
+
+	SPCSVExportRowSerializer *fieldNamesSerializer = [[SPCSVExportRowSerializer alloc] initWithColumnCount:columnCount
+	                                                                                         stringEncoding:[self exportOutputEncoding]
+	                                                                                         fieldSeparator:[self csvFieldSeparatorString]
+	                                                                                     enclosingCharacter:[self csvEnclosingCharacterString]
+	                                                                                           escapeString:[self csvEscapeString]
+	                                                                                             lineEnding:[self csvLineEndingString]
+	                                                                                             nullString:[self csvNULLString]];
+
+	if ([self csvOutputFieldNames]) {
+		[fieldNamesSerializer appendFieldNames:fieldNames];
+		[fieldNamesSerializer writeToOutput:[self exportOutputFile]];
+
+		[self setCsvOutputFieldNames:NO];
+	}
+
+	BOOL completed = [self writeRowsFromSource:rowSource serializingChunksUsingBlock:^id(NSRange rowRange) {
+		SPCSVExportRowSerializer *chunkSerializer = [[SPCSVExportRowSerializer alloc] initWithColumnCount:columnCount
+		                                                                                    stringEncoding:[self exportOutputEncoding]
+		                                                                                    fieldSeparator:[self csvFieldSeparatorString]
+		                                                                                enclosingCharacter:[self csvEnclosingCharacterString]
+		                                                                                      escapeString:[self csvEscapeString]
+		                                                                                        lineEnding:[self csvLineEndingString]
+		                                                                                        nullString:[self csvNULLString]];
+
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			[chunkSerializer setFormat:SPCSVExportCellDetectingNumber bitLength:0 forColumn:i];
+		}
+
+		for (NSUInteger rowIndex = rowRange.location; rowIndex < NSMaxRange(rowRange); rowIndex++)
+		{
+			[chunkSerializer appendRow:[rowSource exportRowAtIndex:rowIndex]];
+		}
+
+		return [chunkSerializer autorelease];
+	} progressHandler:^(NSUInteger rowsWritten) {
+
+		// Only whole chunks have been written, so a split export file can roll over to a new part
+		if ([[self exportOutputFile] needsNewPart] && [[self exportOutputFile] beginNewPart] && partsIncludeFieldNames) {
+			[fieldNamesSerializer appendFieldNames:fieldNames];
+			[fieldNamesSerializer writeToOutput:[self exportOutputFile]];
+		}
+
+		double progress = (rowsWritten * ([self exportMaxProgress] / totalRows));
+
+		if (progress > lastProgressValue) {
+			[self setExportProgressValue:progress];
+
+			lastProgressValue = progress;
+
+			// Inform the delegate that the export's progress has been updated
+			[delegate performSelectorOnMainThread:@selector(csvExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+		}
+	}];
+
+	[fieldNamesSerializer release];
+
+	return completed;
+}
+
 #pragma mark -
 
 - (void)dealloc
 {
-	if (csvDataArray) SPClear(csvDataArray);
 	if (csvTableName) SPClear(csvTableName);
 	
 	SPClear(csvFieldSeparatorString);
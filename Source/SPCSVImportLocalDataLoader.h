@@ -0,0 +1,93 @@
+//
+//  SPCSVImportLocalDataLoader.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMySQLConnection;
+
+/**
+ * @class SPCSVImportLocalDataLoader SPCSVImportLocalDataLoader.h
+ *
+ * Imports CSV rows with LOAD DATA LOCAL INFILE rather than with INSERT statements, for field
+ * mappings which only copy columns of the file into columns of the table.  Parsed rows are buffered
+ * in the loader's own tab separated format, with the field mapping applied as for INSERTs - missing
+ * cells become column defaults, and empty cells of nullable numeric columns become NULL - and each
+ * batch is then sent as the data of a single LOAD DATA statement.
+ *
+ * The statements run on a copy of the parent connection which is allowed to supply local data,
+ * set up with the parent session's database, encoding, SQL_MODE, time zone and key checks.  If the
+ * client or the server doesn't allow loading local data, -localDataRefused is set and the rows should
+ * be inserted instead.
+ *
+ * Loading local data reports rows which can't be loaded as warnings rather than errors, as if IGNORE
+ * had been used, so the loader is only used for imports which ignore or replace duplicate rows.
+ */
+@interface SPCSVImportLocalDataLoader : NSObject
+{
+	SPMySQLConnection *parentConnection;
+	SPMySQLConnection *connection;
+
+	NSString *tableName;
+	NSArray *columnNames;
+	NSUInteger columnCount;
+	NSUInteger *sourceColumns;
+	NSArray *defaultValues;
+	NSIndexSet *emptyStringNullColumns;
+	NSString *duplicateHandling;
+	BOOL lowPriority;
+	NSString *loadQuery;
+
+	NSMutableData *rowData;
+	NSMutableData *cellBuffer;
+	NSUInteger rowCount;
+
+	NSString *lastErrorMessage;
+	NSArray *lastWarnings;
+	BOOL localDataRefused;
+}
+
+- (id)initWithConnection:(SPMySQLConnection *)connection table:(NSString *)table columnNames:(NSArray *)names sourceColumns:(NSArray *)columnIndexes defaultValues:(NSArray *)defaults;
+
+- (void)setEmptyStringNullColumns:(NSIndexSet *)columnIndexes;
+- (void)setDuplicateHandling:(NSString *)handling;
+- (void)setLowPriority:(BOOL)isLowPriority;
+
+- (BOOL)open;
+- (void)close;
+
+- (void)appendRow:(NSArray *)csvRowArray;
+- (NSUInteger)rowCount;
+- (NSUInteger)bufferedLength;
+
+- (BOOL)loadBufferedRows;
+
+- (BOOL)localDataRefused;
+- (NSString *)lastErrorMessage;
+- (NSArray *)lastWarnings;
+
+@end
@@ -0,0 +1,460 @@
+//
+//  SPCSVImportLocalDataLoader.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVImportLocalDataLoader.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// Errors reported when the client or the server doesn't allow loading local data: the server's
+// ER_NOT_ALLOWED_COMMAND and ER_CLIENT_LOCAL_FILES_DISABLED, and the client's own refusals
+static const NSUInteger SPCSVImportLocalDataNotAllowedErrorID = 1148;
+static const NSUInteger SPCSVImportLocalDataDisabledErrorID = 3948;
+static const NSUInteger SPCSVImportLocalDataRejectedErrorID = 2068;
+static const NSUInteger SPCSVImportLocalDataClientErrorID = 2000;
+
+// The maximum number of warnings retrieved after each load
+static const NSUInteger SPCSVImportLocalDataMaximumWarnings = 100;
+
+@interface SPCSVImportLocalDataLoader ()
+
+- (void)_appendEscapedString:(NSString *)aString;
+- (NSString *)_loadQueryWithCharacterSet:(NSString *)characterSet;
+
+@end
+
+@implementation SPCSVImportLocalDataLoader
+
+/**
+ * Set up a loader for the supplied table.  For each table column to load, columnIndexes holds the
+ * index of the CSV column supplying its data, and defaults the value used where a row has no cell
+ * for that column.
+ */
+- (id)initWithConnection:(SPMySQLConnection *)aConnection table:(NSString *)table columnNames:(NSArray *)names sourceColumns:(NSArray *)columnIndexes defaultValues:(NSArray *)defaults
+{
+	if ((self = [super init])) {
+		parentConnection = [aConnection retain];
+		connection = nil;
+
+		tableName = [table copy];
+		columnNames = [names copy];
+		columnCount = [columnNames count];
+		defaultValues = [defaults copy];
+		emptyStringNullColumns = [[NSIndexSet alloc] init];
+		duplicateHandling = nil;
+		lowPriority = NO;
+		loadQuery = nil;
+
+		sourceColumns = malloc(sizeof(NSUInteger) * (columnCount ? columnCount : 1));
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			sourceColumns[i] = [[columnIndexes objectAtIndex:i] unsignedIntegerValue];
+		}
+
+		rowData = [[NSMutableData alloc] init];
+		cellBuffer = [[NSMutableData alloc] init];
+		rowCount = 0;
+
+		lastErrorMessage = nil;
+		lastWarnings = nil;
+		localDataRefused = NO;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Load options
+
+/**
+ * Set the columns for which empty cells are loaded as NULL, as for nullable numeric columns.
+ */
+- (void)setEmptyStringNullColumns:(NSIndexSet *)columnIndexes
+{
+	if (emptyStringNullColumns != columnIndexes) {
+		[emptyStringNullColumns release];
+		emptyStringNullColumns = [columnIndexes copy];
+	}
+}
+
+/**
+ * Set how rows duplicating a unique key are handled - @"REPLACE" or @"IGNORE".  Without either,
+ * rows which can't be loaded would only be reported as warnings, so -open won't load the rows.
+ */
+- (void)setDuplicateHandling:(NSString *)handling
+{
+	if (duplicateHandling != handling) {
+		[duplicateHandling release];
+		duplicateHandling = [handling copy];
+	}
+}
+
+/**
+ * Set whether the loads wait until no other clients are reading the table.
+ */
+- (void)setLowPriority:(BOOL)isLowPriority
+{
+	lowPriority = isLowPriority;
+}
+
+#pragma mark -
+#pragma mark Connection
+
+/**
+ * Open the connection used to load the data.  Must be called after setting the duplicate handling,
+ * as loading is only used where rows duplicating a key are ignored or replaced.
+ *
+ * @return NO if the connection couldn't be set up or duplicates aren't handled, with -localDataRefused
+ *         set if the server doesn't allow loading local data
+ */
+- (BOOL)open
+{
+	if (connection) return YES;
+
+	// Loading local data reports rows which can't be loaded, such as duplicate keys or invalid values,
+	// as warnings rather than errors, as IGNORE does; so only load when duplicates are already handled
+	if (!duplicateHandling) return NO;
+
+	SPMySQLResult *result = [parentConnection queryString:@"SELECT DATABASE(), @@GLOBAL.local_infile, @@SESSION.sql_mode, @@SESSION.time_zone, @@SESSION.foreign_key_checks, @@SESSION.unique_checks"];
+
+	[result setReturnDataAsStrings:YES];
+
+	NSArray *sessionDetails = [result getRowAsArray];
+
+	if ([parentConnection queryErrored] || [sessionDetails count] != 6) return NO;
+
+	NSString *database = [NSArrayObjectAtIndex(sessionDetails, 0) unboxNull];
+	NSString *sqlMode = [NSArrayObjectAtIndex(sessionDetails, 2) unboxNull];
+	NSString *timeZone = [NSArrayObjectAtIndex(sessionDetails, 3) unboxNull];
+	NSString *encoding = [parentConnection encoding];
+
+	if (![[NSArrayObjectAtIndex(sessionDetails, 1) unboxNull] integerValue]) {
+		localDataRefused = YES;
+
+		return NO;
+	}
+
+	SPMySQLConnection *loadConnection = [[parentConnection copy] autorelease];
+
+	[loadConnection addClientFlags:SPMySQLClientFlagLocalFiles];
+
+	// Copy the local port from the parent connection, in case a proxy has changed
+	[loadConnection setPort:[parentConnection port]];
+
+	if (![loadConnection connect]) return NO;
+
+	if (encoding) [loadConnection setEncoding:encoding];
+
+	if ([database length] && ![loadConnection selectDatabase:database]) {
+		[loadConnection disconnect];
+
+		return NO;
+	}
+
+	// Mirror the parent's session variables affecting how the rows are stored
+	NSMutableArray *sessionAssignments = [NSMutableArray array];
+
+	if (sqlMode) [sessionAssignments addObject:[NSString stringWithFormat:@"SQL_MODE=%@", [loadConnection escapeAndQuoteString:sqlMode]]];
+	if (timeZone) [sessionAssignments addObject:[NSString stringWithFormat:@"TIME_ZONE=%@", [loadConnection escapeAndQuoteString:timeZone]]];
+
+	[sessionAssignments addObject:[NSString stringWithFormat:@"FOREIGN_KEY_CHECKS=%ld", (long)[[NSArrayObjectAtIndex(sessionDetails, 4) unboxNull] integerValue]]];
+	[sessionAssignments addObject:[NSString stringWithFormat:@"UNIQUE_CHECKS=%ld", (long)[[NSArrayObjectAtIndex(sessionDetails, 5) unboxNull] integerValue]]];
+
+	[loadConnection queryString:[NSString stringWithFormat:@"SET %@", [sessionAssignments componentsJoinedByString:@", "]]];
+
+	if ([loadConnection queryErrored]) {
+		[loadConnection disconnect];
+
+		return NO;
+	}
+
+	// Rows are always buffered as UTF-8, which servers before 5.5.3 can only load as utf8
+	BOOL supportsUTF8MB4 = [loadConnection serverVersionIsGreaterThanOrEqualTo:5 minorVersion:5 releaseVersion:3];
+
+	loadQuery = [[self _loadQueryWithCharacterSet:(supportsUTF8MB4 ? @"utf8mb4" : @"utf8")] retain];
+	connection = [loadConnection retain];
+
+	return YES;
+}
+
+/**
+ * Discard any buffered rows and disconnect the loading connection.
+ */
+- (void)close
+{
+	[rowData setLength:0];
+	rowCount = 0;
+
+	if (connection) {
+		if ([connection isConnected]) [connection disconnect];
+		SPClear(connection);
+	}
+}
+
+#pragma mark -
+#pragma mark Rows
+
+/**
+ * Buffer a parsed CSV row, applying the field mapping.
+ */
+- (void)appendRow:(NSArray *)csvRowArray
+{
+	NSUInteger cellCount = [csvRowArray count];
+	static const char fieldSeparator = '\t';
+	static const char lineTerminator = '\n';
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		id cellData = (sourceColumns[i] < cellCount) ? NSArrayObjectAtIndex(csvRowArray, sourceColumns[i]) : [SPNotLoaded notLoaded];
+
+		// If the row has no data for the column, load the column default value
+		if ([cellData isSPNotLoaded]) cellData = NSArrayObjectAtIndex(defaultValues, i);
+
+		if (i) [rowData appendBytes:&fieldSeparator length:1];
+
+		if ([cellData isNSNull] || ([emptyStringNullColumns containsIndex:i] && ![[cellData description] length])) {
+			[rowData appendBytes:"\\N" length:2];
+		}
+		else {
+			[self _appendEscapedString:[cellData description]];
+		}
+	}
+
+	[rowData appendBytes:&lineTerminator length:1];
+	rowCount++;
+}
+
+/**
+ * Returns the number of rows buffered since the last load.
+ */
+- (NSUInteger)rowCount
+{
+	return rowCount;
+}
+
+/**
+ * Returns the length of the data buffered since the last load, in bytes.
+ */
+- (NSUInteger)bufferedLength
+{
+	return [rowData length];
+}
+
+/**
+ * Load the buffered rows with a single LOAD DATA statement, and empty the buffer.  Rows the server
+ * couldn't load as supplied - for example duplicate keys, or values out of range - are reported by
+ * the server as warnings rather than errors, and are available from -lastWarnings.
+ *
+ * @return NO if the statement failed, with the error available from -lastErrorMessage; if loading
+ *         local data was refused, -localDataRefused is also set, and no rows were loaded
+ */
+- (BOOL)loadBufferedRows
+{
+	if (lastErrorMessage) SPClear(lastErrorMessage);
+	if (lastWarnings) SPClear(lastWarnings);
+
+	if (!connection || !rowCount) return (connection != nil);
+
+	const char *bytes = [rowData bytes];
+	NSUInteger length = [rowData length];
+	__block NSUInteger position = 0;
+
+	BOOL loaded = [connection loadLocalDataWithQueryString:loadQuery usingEncoding:[connection stringEncoding] readingDataUsingBlock:^NSInteger(char *buffer, NSUInteger bufferLength) {
+		NSUInteger readLength = MIN(bufferLength, length - position);
+
+		memcpy(buffer, bytes + position, readLength);
+		position += readLength;
+
+		return (NSInteger)readLength;
+	}];
+
+	if (loaded) {
+		SPMySQLResult *result = [connection queryString:[NSString stringWithFormat:@"SHOW WARNINGS LIMIT %lu", (unsigned long)SPCSVImportLocalDataMaximumWarnings]];
+		NSMutableArray *warnings = [NSMutableArray array];
+		NSArray *warning;
+
+		[result setReturnDataAsStrings:YES];
+
+		while ((warning = [result getRowAsArray]))
+		{
+			if ([warning count] > 2) [warnings addObject:NSArrayObjectAtIndex(warning, 2)];
+		}
+
+		if ([warnings count]) lastWarnings = [warnings copy];
+	}
+	else {
+		NSUInteger errorID = [connection lastErrorID];
+
+		lastErrorMessage = [[connection lastErrorMessage] copy];
+		localDataRefused = (errorID == SPCSVImportLocalDataNotAllowedErrorID
+			|| errorID == SPCSVImportLocalDataDisabledErrorID
+			|| errorID == SPCSVImportLocalDataRejectedErrorID
+			|| errorID == SPCSVImportLocalDataClientErrorID);
+	}
+
+	[rowData setLength:0];
+	rowCount = 0;
+
+	return loaded;
+}
+
+#pragma mark -
+#pragma mark Results
+
+/**
+ * Returns whether the client or the server doesn't allow loading local data, in which case the
+ * rows should be imported with INSERT statements instead.
+ */
+- (BOOL)localDataRefused
+{
+	return localDataRefused;
+}
+
+/**
+ * Returns the error of the last load, or nil if it succeeded.
+ */
+- (NSString *)lastErrorMessage
+{
+	return lastErrorMessage;
+}
+
+/**
+ * Returns the warning messages of the last load, or nil if there were none.
+ */
+- (NSArray *)lastWarnings
+{
+	return lastWarnings;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Append a cell's data as UTF-8, escaping the characters which would otherwise end the field or
+ * the row.  Runs of bytes which don't need escaping are copied in one go.
+ */
+- (void)_appendEscapedString:(NSString *)aString
+{
+	NSUInteger stringLength = [aString length];
+
+	if (!stringLength) return;
+
+	NSUInteger maximumLength = [aString maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+	NSUInteger usedLength = 0;
+
+	if ([cellBuffer length] < maximumLength) [cellBuffer setLength:maximumLength];
+
+	[aString getBytes:[cellBuffer mutableBytes] maxLength:maximumLength usedLength:&usedLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, stringLength) remainingRange:NULL];
+
+	const char *bytes = [cellBuffer bytes];
+	NSUInteger runStart = 0;
+	char escape[2] = { '\\', 0 };
+
+	for (NSUInteger i = 0; i < usedLength; i++)
+	{
+		switch (bytes[i]) {
+			case '\\': escape[1] = '\\'; break;
+			case '\t': escape[1] = 't'; break;
+			case '\n': escape[1] = 'n'; break;
+			case '\0': escape[1] = '0'; break;
+			default: continue;
+		}
+
+		if (i > runStart) [rowData appendBytes:(bytes + runStart) length:(i - runStart)];
+		[rowData appendBytes:escape length:2];
+		runStart = i + 1;
+	}
+
+	if (usedLength > runStart) [rowData appendBytes:(bytes + runStart) length:(usedLength - runStart)];
+}
+
+/**
+ * Build the LOAD DATA statement loading the buffered rows into the mapped columns.  Columns for
+ * which empty cells are NULL are read into user variables and converted by the SET clause.
+ */
+- (NSString *)_loadQueryWithCharacterSet:(NSString *)characterSet
+{
+	NSMutableString *query = [NSMutableString stringWithString:@"LOAD DATA "];
+	NSMutableArray *columnTargets = [NSMutableArray arrayWithCapacity:columnCount];
+	NSMutableArray *columnAssignments = [NSMutableArray array];
+
+	if (lowPriority) [query appendString:@"LOW_PRIORITY "];
+
+	[query appendString:@"LOCAL INFILE 'sequel-pro-csv-import' "];
+
+	if (duplicateHandling) [query appendFormat:@"%@ ", duplicateHandling];
+
+	[query appendFormat:@"INTO TABLE %@ CHARACTER SET %@ FIELDS TERMINATED BY X'09' ESCAPED BY X'5C' LINES TERMINATED BY X'0A' ", [tableName backtickQuotedString], characterSet];
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		NSString *columnName = [NSArrayObjectAtIndex(columnNames, i) backtickQuotedString];
+
+		if ([emptyStringNullColumns containsIndex:i]) {
+			NSString *variable = [NSString stringWithFormat:@"@sp_import_%lu", (unsigned long)i];
+
+			[columnTargets addObject:variable];
+			[columnAssignments addObject:[NSString stringWithFormat:@"%@ = NULLIF(%@, '')", columnName, variable]];
+		}
+		else {
+			[columnTargets addObject:columnName];
+		}
+	}
+
+	[query appendFormat:@"(%@)", [columnTargets componentsJoinedByString:@", "]];
+
+	if ([columnAssignments count]) [query appendFormat:@" SET %@", [columnAssignments componentsJoinedByString:@", "]];
+
+	return query;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	[self close];
+
+	SPClear(parentConnection);
+	SPClear(tableName);
+	SPClear(columnNames);
+	SPClear(defaultValues);
+	SPClear(emptyStringNullColumns);
+	if (duplicateHandling) SPClear(duplicateHandling);
+	if (loadQuery) SPClear(loadQuery);
+	SPClear(rowData);
+	SPClear(cellBuffer);
+	if (lastErrorMessage) SPClear(lastErrorMessage);
+	if (lastWarnings) SPClear(lastWarnings);
+
+	free(sourceColumns);
+
+	[super dealloc];
+}
+
+@end
@@ -0,0 +1,77 @@
+//
+//  SPCSVParallelTokenizer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVTokenizer.h"
+
+@class SPCSVParallelTokenizerChunk;
+@class SPCSVSpeculativeRows;
+
+/**
+ * @class SPCSVParallelTokenizer SPCSVParallelTokenizer.h
+ *
+ * Tokenizes CSV data on all available cores, returning exactly the rows SPCSVTokenizer would, in
+ * the same order.
+ *
+ * Appended data is split into large chunks, which are tokenized on a worker pool.  As a chunk may
+ * start within a quoted field, each chunk is tokenized speculatively in both starting states: once
+ * assuming it starts outside quotes and once assuming it starts inside them, each from the first
+ * line terminator that assumption gives.  Rows are then returned in order by chaining the chunks -
+ * the row spanning each chunk boundary is tokenized from the exact end of the previous rows, and
+ * the speculative rows starting where that row ends are used.  If neither starts there, as can
+ * happen for a chunk starting just after an escape or within an unquoted field containing a quote,
+ * the chunk is tokenized again sequentially, so the rows are always the same as SPCSVTokenizer's.
+ *
+ * Rows are only available as arrays; the field span methods of SPCSVTokenizer aren't supported.
+ */
+@interface SPCSVParallelTokenizer : SPCSVTokenizer
+{
+	NSString *fieldTerminatorString;
+	NSString *lineTerminatorString;
+	NSString *fieldQuoteString;
+	NSString *escapeString;
+	NSString *nullReplacementString;
+
+	NSMutableData *currentChunkData;
+	NSUInteger currentChunkLocation;
+	NSMutableArray *pendingChunks;
+	NSUInteger maximumPendingChunks;
+	BOOL allDataAppended;
+
+	SPCSVTokenizer *boundaryTokenizer;
+	NSUInteger boundaryTokenizerLocation;
+	SPCSVParallelTokenizerChunk *boundaryChunk;
+	BOOL boundaryChunkIsSequential;
+
+	SPCSVSpeculativeRows *acceptedRows;
+	SPCSVParallelTokenizerChunk *acceptedChunk;
+	NSUInteger acceptedRowIndex;
+}
+
+@end
@@ -0,0 +1,670 @@
+//
+//  SPCSVParallelTokenizer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVParallelTokenizer.h"
+
+// The amount of data tokenized by each worker; large enough that the rows spanning chunk
+// boundaries, which are tokenized sequentially, are a small part of the data
+static const NSUInteger SPCSVParallelTokenizerChunkLength = 1024 * 1024;
+
+/**
+ * The bytes which decide where rows end, used to find a likely row start part way through data.
+ */
+typedef struct {
+	uint8_t fieldQuoteByte;
+	uint8_t escapeByte;
+	uint8_t lineEndBytes[2];
+	NSUInteger lineEndLength;
+	BOOL hasFieldQuote;
+	BOOL hasEscape;
+} SPCSVRowStartSearch;
+
+static NSUInteger SPCSVFindRowStart(const uint8_t *bytes, NSUInteger length, BOOL insideQuotes, const SPCSVRowStartSearch *search);
+
+/**
+ * The rows tokenized from one starting point within a chunk.
+ */
+@interface SPCSVSpeculativeRows : NSObject
+{
+	NSUInteger startLocation;
+	NSUInteger endLocation;
+	NSMutableArray *rows;
+	NSMutableData *rowEndLocations;
+	NSUInteger encodingErrorRowIndex;
+}
+
+@property (readonly) NSUInteger startLocation;
+@property (readonly) NSUInteger endLocation;
+@property (readonly) NSUInteger encodingErrorRowIndex;
+
+- (id)initByTokenizingBytes:(const void *)bytes length:(NSUInteger)length location:(NSUInteger)location usingTokenizer:(SPCSVTokenizer *)tokenizer dataIsComplete:(BOOL)dataComplete;
+
+- (NSUInteger)rowCount;
+- (NSMutableArray *)rowAtIndex:(NSUInteger)rowIndex;
+- (NSUInteger)endLocationOfRowAtIndex:(NSUInteger)rowIndex;
+
+@end
+
+@implementation SPCSVSpeculativeRows
+
+@synthesize startLocation;
+@synthesize endLocation;
+@synthesize encodingErrorRowIndex;
+
+/**
+ * Tokenize all the complete rows of the supplied bytes, which start at the supplied location in
+ * the data.  Tokenizing stops after a row containing a field which can't be decoded.
+ */
+- (id)initByTokenizingBytes:(const void *)bytes length:(NSUInteger)length location:(NSUInteger)location usingTokenizer:(SPCSVTokenizer *)tokenizer dataIsComplete:(BOOL)dataComplete
+{
+	if ((self = [super init])) {
+		startLocation = location;
+		rows = [[NSMutableArray alloc] init];
+		rowEndLocations = [[NSMutableData alloc] init];
+		encodingErrorRowIndex = NSNotFound;
+
+		[tokenizer appendBytes:bytes length:length];
+
+		while ([tokenizer tokenizeRowAndTrimData:NO dataIsComplete:dataComplete])
+		{
+			NSUInteger rowEndLocation = location + [tokenizer totalLengthParsed];
+
+			[rows addObject:[tokenizer tokenizedRowAsArray]];
+			[rowEndLocations appendBytes:&rowEndLocation length:sizeof(NSUInteger)];
+
+			if ([tokenizer encodingErrorOccurred]) {
+				encodingErrorRowIndex = [rows count] - 1;
+				break;
+			}
+		}
+
+		endLocation = location + [tokenizer totalLengthParsed];
+	}
+
+	return self;
+}
+
+- (NSUInteger)rowCount
+{
+	return [rows count];
+}
+
+- (NSMutableArray *)rowAtIndex:(NSUInteger)rowIndex
+{
+	return [rows objectAtIndex:rowIndex];
+}
+
+- (NSUInteger)endLocationOfRowAtIndex:(NSUInteger)rowIndex
+{
+	return ((const NSUInteger *)[rowEndLocations bytes])[rowIndex];
+}
+
+- (void)dealloc
+{
+	SPClear(rows);
+	SPClear(rowEndLocations);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+/**
+ * A chunk of data tokenized by a worker.
+ */
+@interface SPCSVParallelTokenizerChunk : NSObject
+{
+	NSData *data;
+	NSUInteger location;
+	BOOL isFinal;
+	BOOL startsAtRow;
+	SPCSVRowStartSearch rowStartSearch;
+	SPCSVTokenizer *outsideQuotesTokenizer;
+	SPCSVTokenizer *insideQuotesTokenizer;
+	NSMutableArray *speculativeRows;
+	dispatch_semaphore_t completionSemaphore;
+}
+
+@property (readonly) NSData *data;
+@property (readonly) NSUInteger location;
+@property (readonly) BOOL isFinal;
+
+- (id)initWithData:(NSData *)chunkData location:(NSUInteger)chunkLocation isFinal:(BOOL)chunkIsFinal startsAtRow:(BOOL)chunkStartsAtRow rowStartSearch:(SPCSVRowStartSearch)search outsideQuotesTokenizer:(SPCSVTokenizer *)outsideTokenizer insideQuotesTokenizer:(SPCSVTokenizer *)insideTokenizer;
+- (void)tokenize;
+- (BOOL)waitUntilTokenized:(BOOL)block;
+- (SPCSVSpeculativeRows *)rowsStartingAtLocation:(NSUInteger)rowLocation;
+
+@end
+
+@implementation SPCSVParallelTokenizerChunk
+
+@synthesize data;
+@synthesize location;
+@synthesize isFinal;
+
+/**
+ * Initialise a chunk of the data starting at the supplied location.  Each tokenizer is used for one
+ * of the starting states, and a chunk which is known to start at a row only uses the first.
+ */
+- (id)initWithData:(NSData *)chunkData location:(NSUInteger)chunkLocation isFinal:(BOOL)chunkIsFinal startsAtRow:(BOOL)chunkStartsAtRow rowStartSearch:(SPCSVRowStartSearch)search outsideQuotesTokenizer:(SPCSVTokenizer *)outsideTokenizer insideQuotesTokenizer:(SPCSVTokenizer *)insideTokenizer
+{
+	if ((self = [super init])) {
+		data = [chunkData retain];
+		location = chunkLocation;
+		isFinal = chunkIsFinal;
+		startsAtRow = chunkStartsAtRow;
+		rowStartSearch = search;
+		outsideQuotesTokenizer = [outsideTokenizer retain];
+		insideQuotesTokenizer = [insideTokenizer retain];
+		speculativeRows = [[NSMutableArray alloc] initWithCapacity:2];
+		completionSemaphore = dispatch_semaphore_create(0);
+	}
+
+	return self;
+}
+
+/**
+ * Tokenize the chunk's rows from each possible starting point.  Run on a worker thread.
+ */
+- (void)tokenize
+{
+	NSAutoreleasePool *tokenizePool = [[NSAutoreleasePool alloc] init];
+	const uint8_t *bytes = [data bytes];
+	NSUInteger length = [data length];
+	NSUInteger outsideQuotesOffset = startsAtRow ? 0 : SPCSVFindRowStart(bytes, length, NO, &rowStartSearch);
+	NSUInteger insideQuotesOffset = (startsAtRow || !insideQuotesTokenizer) ? NSNotFound : SPCSVFindRowStart(bytes, length, YES, &rowStartSearch);
+	SPCSVSpeculativeRows *rows;
+
+	if (outsideQuotesOffset != NSNotFound) {
+		rows = [[SPCSVSpeculativeRows alloc] initByTokenizingBytes:(bytes + outsideQuotesOffset) length:(length - outsideQuotesOffset) location:(location + outsideQuotesOffset) usingTokenizer:outsideQuotesTokenizer dataIsComplete:isFinal];
+		[speculativeRows addObject:rows];
+		[rows release];
+	}
+
+	// Both starting states often reach the same row start, once the quotes they disagree about close
+	if (insideQuotesOffset != NSNotFound && insideQuotesOffset != outsideQuotesOffset) {
+		rows = [[SPCSVSpeculativeRows alloc] initByTokenizingBytes:(bytes + insideQuotesOffset) length:(length - insideQuotesOffset) location:(location + insideQuotesOffset) usingTokenizer:insideQuotesTokenizer dataIsComplete:isFinal];
+		[speculativeRows addObject:rows];
+		[rows release];
+	}
+
+	SPClear(outsideQuotesTokenizer);
+	if (insideQuotesTokenizer) SPClear(insideQuotesTokenizer);
+
+	[tokenizePool drain];
+
+	dispatch_semaphore_signal(completionSemaphore);
+}
+
+/**
+ * Returns whether the chunk has been tokenized, optionally waiting until it has.
+ */
+- (BOOL)waitUntilTokenized:(BOOL)block
+{
+	if (dispatch_semaphore_wait(completionSemaphore, block ? DISPATCH_TIME_FOREVER : DISPATCH_TIME_NOW)) return NO;
+
+	// Leave the chunk marked as tokenized for later checks
+	dispatch_semaphore_signal(completionSemaphore);
+
+	return YES;
+}
+
+/**
+ * Returns the rows tokenized from the supplied location in the data, if the chunk was tokenized
+ * from there.
+ */
+- (SPCSVSpeculativeRows *)rowsStartingAtLocation:(NSUInteger)rowLocation
+{
+	for (SPCSVSpeculativeRows *rows in speculativeRows)
+	{
+		if ([rows startLocation] == rowLocation) return rows;
+	}
+
+	return nil;
+}
+
+- (void)dealloc
+{
+	SPClear(data);
+	if (outsideQuotesTokenizer) SPClear(outsideQuotesTokenizer);
+	if (insideQuotesTokenizer) SPClear(insideQuotesTokenizer);
+	SPClear(speculativeRows);
+
+	dispatch_release(completionSemaphore);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPCSVParallelTokenizer ()
+
+- (SPCSVTokenizer *)_newChunkTokenizerSkippingByteOrderMark:(BOOL)skipByteOrderMark;
+- (void)_submitCurrentChunk;
+- (void)_startChunk:(SPCSVParallelTokenizerChunk *)chunk;
+- (void)_acceptRows:(SPCSVSpeculativeRows *)rows ofChunk:(SPCSVParallelTokenizerChunk *)chunk;
+- (NSArray *)_rowByTokenizingBoundaryChunk;
+- (NSArray *)_rowByReturningRow:(NSMutableArray *)row endingAtLocation:(NSUInteger)rowEndLocation;
+
+@end
+
+@implementation SPCSVParallelTokenizer
+
+/**
+ * Set up a parallel tokenizer, with the same arguments and requirements as SPCSVTokenizer.
+ */
+- (id)initWithStringEncoding:(NSStringEncoding)encoding fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape
+{
+	if ((self = [super initWithStringEncoding:encoding fieldTerminator:fieldEnd lineTerminator:lineEnd fieldQuote:fieldQuote escape:escape])) {
+		fieldTerminatorString = [fieldEnd copy];
+		lineTerminatorString = [lineEnd copy];
+		fieldQuoteString = [fieldQuote copy];
+		escapeString = [escape copy];
+		nullReplacementString = nil;
+
+		currentChunkData = [[NSMutableData alloc] initWithCapacity:SPCSVParallelTokenizerChunkLength];
+		currentChunkLocation = 0;
+		pendingChunks = [[NSMutableArray alloc] init];
+
+		// Tokenized chunks wait to be returned, so only allow enough in flight to keep every core busy
+		maximumPendingChunks = MAX(2, [[NSProcessInfo processInfo] activeProcessorCount]);
+		allDataAppended = NO;
+
+		boundaryTokenizer = nil;
+		boundaryTokenizerLocation = 0;
+		boundaryChunk = nil;
+		boundaryChunkIsSequential = NO;
+
+		acceptedRows = nil;
+		acceptedRowIndex = 0;
+		acceptedChunk = nil;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Settings
+
+- (void)setNullReplacementString:(NSString *)nullString
+{
+	[super setNullReplacementString:nullString];
+
+	if (nullReplacementString) SPClear(nullReplacementString);
+	nullReplacementString = [nullString copy];
+
+	[boundaryTokenizer setNullReplacementString:nullString];
+}
+
+- (void)setEscapeStringsAreMatchedStrictly:(BOOL)strictMatching
+{
+	[super setEscapeStringsAreMatchedStrictly:strictMatching];
+
+	[boundaryTokenizer setEscapeStringsAreMatchedStrictly:strictMatching];
+}
+
+/**
+ * Set the indexes of the fields which are decoded.  Chunks which have already been handed to the
+ * worker pool may still decode all the fields.
+ */
+- (void)setMaterialisedFieldIndexes:(NSIndexSet *)fieldIndexes
+{
+	[super setMaterialisedFieldIndexes:fieldIndexes];
+
+	[boundaryTokenizer setMaterialisedFieldIndexes:fieldIndexes];
+}
+
+#pragma mark -
+#pragma mark Adding data
+
+/**
+ * Append additional bytes to tokenize, handing full chunks to the worker pool.
+ */
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+	if (allDataAppended) [NSException raise:NSInternalInconsistencyException format:@"Cannot append CSV data after all the data has been tokenized"];
+
+	[currentChunkData appendBytes:bytes length:length];
+
+	if ([currentChunkData length] >= SPCSVParallelTokenizerChunkLength) [self _submitCurrentChunk];
+}
+
+- (void)appendData:(NSData *)someData
+{
+	[self appendBytes:[someData bytes] length:[someData length]];
+}
+
+#pragma mark -
+#pragma mark Tokenizing rows
+
+/**
+ * Rows can only be retrieved as arrays, as the fields of each row are held by the chunk tokenizers.
+ */
+- (BOOL)tokenizeRowAndTrimData:(BOOL)trimData dataIsComplete:(BOOL)dataComplete
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Rows of a parallel CSV tokenizer can only be retrieved as arrays"];
+
+	return NO;
+}
+
+/**
+ * Retrieve the next row as an array of strings, as for SPCSVTokenizer.  Returns nil if the next
+ * rows are still being tokenized, unless all the data has been supplied or too many chunks are
+ * being tokenized, in which case this waits for them.
+ */
+- (NSArray *)getRowAsArrayAndTrimData:(BOOL)trimData dataIsComplete:(BOOL)dataComplete
+{
+	NSArray *row;
+
+	// Once all the data has been supplied, tokenize the remainder as the final chunk
+	if (dataComplete && !allDataAppended) {
+		allDataAppended = YES;
+		[self _submitCurrentChunk];
+	}
+
+	while (1)
+	{
+		// Return any rows tokenized from the start of a row
+		if (acceptedRows) {
+			if (acceptedRowIndex < [acceptedRows rowCount]) {
+				NSUInteger rowIndex = acceptedRowIndex++;
+
+				if (rowIndex == [acceptedRows encodingErrorRowIndex]) encodingErrorOccurred = YES;
+
+				return [self _rowByReturningRow:[acceptedRows rowAtIndex:rowIndex] endingAtLocation:[acceptedRows endLocationOfRowAtIndex:rowIndex]];
+			}
+
+			SPClear(acceptedRows);
+			SPClear(acceptedChunk);
+		}
+
+		// Tokenize the row spanning into the next chunk, or the chunk itself if its rows couldn't be used
+		if (boundaryChunk) {
+			if ((row = [self _rowByTokenizingBoundaryChunk])) return row;
+
+			continue;
+		}
+
+		if (![pendingChunks count]) return nil;
+
+		SPCSVParallelTokenizerChunk *chunk = [pendingChunks objectAtIndex:0];
+
+		if (![chunk waitUntilTokenized:(allDataAppended || [pendingChunks count] >= maximumPendingChunks)]) return nil;
+
+		[self _startChunk:chunk];
+		[pendingChunks removeObjectAtIndex:0];
+	}
+}
+
+#pragma mark -
+#pragma mark Basic information
+
+/**
+ * Returns the length of the data which hasn't yet been returned as rows.
+ */
+- (NSUInteger)length
+{
+	return currentChunkLocation + [currentChunkData length] - totalLengthParsed;
+}
+
+/**
+ * Returns the data which hasn't yet been returned as rows.
+ */
+- (NSData *)remainingData
+{
+	NSMutableData *remainingData = [NSMutableData data];
+
+	if (acceptedRows) {
+		[remainingData appendData:[[acceptedChunk data] subdataWithRange:NSMakeRange(totalLengthParsed - [acceptedChunk location], [acceptedRows endLocation] - totalLengthParsed)]];
+	}
+
+	if (boundaryTokenizer) [remainingData appendData:[boundaryTokenizer remainingData]];
+
+	for (SPCSVParallelTokenizerChunk *chunk in pendingChunks)
+	{
+		[remainingData appendData:[chunk data]];
+	}
+
+	[remainingData appendData:currentChunkData];
+
+	return remainingData;
+}
+
+/**
+ * Returns the position of the tokenizer within the remaining data, which always starts at the
+ * next row.
+ */
+- (NSUInteger)tokenizerPosition
+{
+	return 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Create a tokenizer with the same settings, for tokenizing part of the data.
+ */
+- (SPCSVTokenizer *)_newChunkTokenizerSkippingByteOrderMark:(BOOL)skipByteOrderMark
+{
+	SPCSVTokenizer *tokenizer = [[SPCSVTokenizer alloc] initWithStringEncoding:stringEncoding fieldTerminator:fieldTerminatorString lineTerminator:lineTerminatorString fieldQuote:fieldQuoteString escape:escapeString];
+
+	[tokenizer setNullReplacementString:nullReplacementString];
+	[tokenizer setEscapeStringsAreMatchedStrictly:useStrictEscapeMatching];
+	[tokenizer setMaterialisedFieldIndexes:materialisedFieldIndexes];
+	[tokenizer setSkipsByteOrderMark:skipByteOrderMark];
+
+	return tokenizer;
+}
+
+/**
+ * Hand the current chunk to the worker pool.  Only the first chunk is known to start at a row; the
+ * others are tokenized in both starting states.
+ */
+- (void)_submitCurrentChunk
+{
+	BOOL isFirstChunk = !currentChunkLocation;
+	SPCSVRowStartSearch search = { fieldQuoteByte, (hasEscape && !escapeIsFieldQuote) ? escapeByte : 0, { lineEndBytes[0], lineEndBytes[1] }, lineEndLength, hasFieldQuote, (hasEscape && !escapeIsFieldQuote) };
+	SPCSVTokenizer *outsideQuotesTokenizer = [self _newChunkTokenizerSkippingByteOrderMark:isFirstChunk];
+	SPCSVTokenizer *insideQuotesTokenizer = (isFirstChunk || !hasFieldQuote) ? nil : [self _newChunkTokenizerSkippingByteOrderMark:NO];
+
+	SPCSVParallelTokenizerChunk *chunk = [[SPCSVParallelTokenizerChunk alloc] initWithData:currentChunkData location:currentChunkLocation isFinal:allDataAppended startsAtRow:isFirstChunk rowStartSearch:search outsideQuotesTokenizer:outsideQuotesTokenizer insideQuotesTokenizer:insideQuotesTokenizer];
+
+	[pendingChunks addObject:chunk];
+
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		[chunk tokenize];
+	});
+
+	[chunk release];
+	[outsideQuotesTokenizer release];
+	[insideQuotesTokenizer release];
+
+	currentChunkLocation += [currentChunkData length];
+	SPClear(currentChunkData);
+	currentChunkData = [[NSMutableData alloc] initWithCapacity:SPCSVParallelTokenizerChunkLength];
+}
+
+/**
+ * Start returning the rows of a tokenized chunk.  The first chunk's rows can be used directly;
+ * for later chunks, the row spanning the boundary is tokenized first, to find where its rows start.
+ */
+- (void)_startChunk:(SPCSVParallelTokenizerChunk *)chunk
+{
+	if (!boundaryTokenizer) {
+		[self _acceptRows:[chunk rowsStartingAtLocation:[chunk location]] ofChunk:chunk];
+		return;
+	}
+
+	[boundaryTokenizer appendData:[chunk data]];
+
+	boundaryChunk = [chunk retain];
+	boundaryChunkIsSequential = NO;
+}
+
+/**
+ * Return a chunk's rows tokenized from the start of a row, and keep the incomplete row at the end
+ * of the chunk to be completed with the next chunk.
+ */
+- (void)_acceptRows:(SPCSVSpeculativeRows *)rows ofChunk:(SPCSVParallelTokenizerChunk *)chunk
+{
+	NSUInteger tailOffset = [rows endLocation] - [chunk location];
+
+	acceptedRows = [rows retain];
+	acceptedRowIndex = 0;
+	acceptedChunk = [chunk retain];
+
+	if (boundaryTokenizer) SPClear(boundaryTokenizer);
+
+	boundaryTokenizer = [self _newChunkTokenizerSkippingByteOrderMark:NO];
+	boundaryTokenizerLocation = [rows endLocation];
+
+	[boundaryTokenizer appendBytes:((const uint8_t *)[[chunk data] bytes] + tailOffset) length:([[chunk data] length] - tailOffset)];
+}
+
+/**
+ * Tokenize the next row of the boundary chunk from the exact end of the rows returned so far.
+ * Once the row spanning the start of the chunk is complete, the chunk's rows tokenized from where
+ * it ends are used; if there are none, the rest of the chunk is tokenized here.
+ *
+ * @return nil once no more rows end within the chunk
+ */
+- (NSArray *)_rowByTokenizingBoundaryChunk
+{
+	if (![boundaryTokenizer tokenizeRowAndTrimData:YES dataIsComplete:[boundaryChunk isFinal]]) {
+		SPClear(boundaryChunk);
+		return nil;
+	}
+
+	NSUInteger rowEndLocation = boundaryTokenizerLocation + [boundaryTokenizer totalLengthParsed];
+	NSMutableArray *row = [boundaryTokenizer tokenizedRowAsArray];
+
+	if ([boundaryTokenizer encodingErrorOccurred]) encodingErrorOccurred = YES;
+
+	if (!boundaryChunkIsSequential) {
+		SPCSVSpeculativeRows *rows = [boundaryChunk rowsStartingAtLocation:rowEndLocation];
+
+		if (rows) {
+			[self _acceptRows:rows ofChunk:boundaryChunk];
+			SPClear(boundaryChunk);
+		}
+		else {
+			boundaryChunkIsSequential = YES;
+		}
+	}
+
+	return [self _rowByReturningRow:row endingAtLocation:rowEndLocation];
+}
+
+/**
+ * Pad a row to the number of fields of the first row, as SPCSVTokenizer does, and record the
+ * data up to its end as parsed.
+ */
+- (NSArray *)_rowByReturningRow:(NSMutableArray *)row endingAtLocation:(NSUInteger)rowEndLocation
+{
+	NSUInteger i;
+
+	if (rowFieldCount == NSNotFound) {
+		rowFieldCount = [row count];
+	}
+	else {
+		for (i = [row count]; i < (NSUInteger)rowFieldCount; i++) [row addObject:[SPNotLoaded notLoaded]];
+	}
+
+	totalLengthParsed = rowEndLocation;
+
+	return [[row retain] autorelease];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	// Ensure no workers are still using the pending chunks
+	for (SPCSVParallelTokenizerChunk *chunk in pendingChunks)
+	{
+		[chunk waitUntilTokenized:YES];
+	}
+
+	SPClear(fieldTerminatorString);
+	SPClear(lineTerminatorString);
+	SPClear(fieldQuoteString);
+	SPClear(escapeString);
+	if (nullReplacementString) SPClear(nullReplacementString);
+	SPClear(currentChunkData);
+	SPClear(pendingChunks);
+	if (boundaryTokenizer) SPClear(boundaryTokenizer);
+	if (boundaryChunk) SPClear(boundaryChunk);
+	if (acceptedRows) SPClear(acceptedRows);
+	if (acceptedChunk) SPClear(acceptedChunk);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+/**
+ * Find the start of the first row in the supplied bytes, assuming they start inside or outside
+ * quotes: the position after the first line terminator found outside quotes, where any field quote
+ * toggles between the two and an escape which isn't the field quote escapes the following byte.
+ * This ignores that quotes only start fields at their start, so may be wrong for some data; the
+ * result is always checked against the end of the previous row.
+ *
+ * @return NSNotFound if no line terminator is found outside quotes
+ */
+static NSUInteger SPCSVFindRowStart(const uint8_t *bytes, NSUInteger length, BOOL insideQuotes, const SPCSVRowStartSearch *search)
+{
+	NSUInteger i;
+
+	for (i = 0; i < length; i++)
+	{
+		if (search->hasEscape && bytes[i] == search->escapeByte) {
+			i++;
+			continue;
+		}
+
+		if (search->hasFieldQuote && bytes[i] == search->fieldQuoteByte) {
+			insideQuotes = !insideQuotes;
+			continue;
+		}
+
+		if (!insideQuotes && bytes[i] == search->lineEndBytes[0] && (search->lineEndLength == 1 || (i + 1 < length && bytes[i + 1] == search->lineEndBytes[1]))) {
+			return i + search->lineEndLength;
+		}
+	}
+
+	return NSNotFound;
+}
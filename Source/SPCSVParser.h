@@ -44,13 +44,17 @@
  *    to minimise multibyte issues)
  *  - Correct treatment of line terminators within quoted strings and proper escape support
  *    including escape characters matching the quote characters in Excel style
+ *  - Parsing raw data rather than strings for single-character terminators, quotes and escapes
+ *    in ASCII-compatible encodings, using SPCSVTokenizer, optionally on all available cores
  *
- * The internal usage of string range finding, similar to the NSScanner approach, means this
- * could be significantly sped up for single-character terminators.
+ * The internal usage of string range finding, similar to the NSScanner approach, means string
+ * parsing is significantly slower than raw data parsing; where possible, raw data should be used.
  */
 
 #define SPCSVPARSER_TRIM_ENACT_LENGTH 250000
 
+@class SPCSVTokenizer;
+
 @interface SPCSVParser : NSObject
 {
 	NSMutableString *csvString;
@@ -79,6 +83,9 @@
 
 	BOOL escapeStringIsFieldQuoteString;
 	BOOL useStrictEscapeMatching;
+
+	SPCSVTokenizer *dataTokenizer;
+	NSStringEncoding dataEncoding;
 }
 
 /* Retrieving data from the CSV string */
@@ -90,6 +97,13 @@
 - (void) appendString:(NSString *)aString;
 - (void) setString:(NSString *)aString;
 
+/* Parsing raw data */
+- (BOOL) parseDataWithEncoding:(NSStringEncoding)encoding;
+- (BOOL) parseDataWithEncoding:(NSStringEncoding)encoding inParallel:(BOOL)parallel;
+- (void) appendData:(NSData *)someData;
+- (void) setMaterialisedFieldIndexes:(NSIndexSet *)fieldIndexes;
+- (BOOL) encodingErrorOccurred;
+
 /* Basic information */
 - (NSUInteger) length;
 - (NSString *) string;
@@ -29,6 +29,8 @@
 //  More info at <https://github.com/sequelpro/sequelpro>
 
 #import "SPCSVParser.h"
+#import "SPCSVTokenizer.h"
+#import "SPCSVParallelTokenizer.h"
 
 /**
  * Please see the header files for a general description of the purpose of this class.
@@ -48,9 +50,10 @@
 	NSMutableArray *csvArray = [[NSMutableArray alloc] init];
 	NSArray *csvRowArray;
 
-	// Ensure that the full string is being parsed by resetting the parser position
+	// Ensure that the full string is being parsed by resetting the parser position; raw data is
+	// parsed from the current position
 	parserPosition = trimPosition;
-	totalLengthParsed = 0;
+	if (!dataTokenizer) totalLengthParsed = 0;
 
 	// Loop through the results fetching process
 	while ((csvRowArray = [self getRowAsArrayAndTrimString:NO stringIsComplete:YES]))
@@ -93,6 +96,8 @@
 	BOOL nonStrictEscapeMatchingFallback = NO;
 	BOOL lineEndingEncountered = NO;
 
+	if (dataTokenizer) return [dataTokenizer getRowAsArrayAndTrimData:trimString dataIsComplete:stringComplete];
+
 	if (fieldCount == NSNotFound)
 		csvRowArray = [NSMutableArray array];
 	else
@@ -327,21 +332,103 @@
  */
 - (void) appendString:(NSString *)aString
 {
+	if (dataTokenizer) {
+		[dataTokenizer appendData:[aString dataUsingEncoding:dataEncoding]];
+		return;
+	}
+
 	[csvString appendString:aString];
 	csvStringLength += [aString length];
 }
 
 /**
- * Completely replace the underlying CSV string.
+ * Completely replace the underlying CSV string.  This also returns the parser to parsing strings
+ * if it was parsing raw data.
  */
 - (void) setString:(NSString *)aString
 {
+	if (dataTokenizer) SPClear(dataTokenizer);
+
 	trimPosition = 0;
 	totalLengthParsed = 0;
 	[csvString setString:aString];
 	csvStringLength = [csvString length];
 }
 
+#pragma mark -
+#pragma mark Parsing raw data
+
+/**
+ * Switch the parser to parsing raw data in the supplied encoding, supplied using -appendData:,
+ * rather than strings.  The raw data is split bytewise without first being decoded, and only
+ * the fields which are used are decoded.  This is only supported for single-character field
+ * terminators, field quotes and escapes, one or two character line terminators, and encodings
+ * in which ASCII characters can't occur within other characters; these must be set before
+ * calling this method.
+ * Returns NO if raw data can't be parsed, in which case strings must still be supplied.
+ */
+- (BOOL) parseDataWithEncoding:(NSStringEncoding)encoding
+{
+	return [self parseDataWithEncoding:encoding inParallel:NO];
+}
+
+/**
+ * Switch the parser to parsing raw data as above, optionally splitting the data into chunks
+ * which are tokenized on all available cores using SPCSVParallelTokenizer.  The rows returned
+ * are the same either way; parsing in parallel is worthwhile for large amounts of data.
+ */
+- (BOOL) parseDataWithEncoding:(NSStringEncoding)encoding inParallel:(BOOL)parallel
+{
+	Class tokenizerClass = parallel ? [SPCSVParallelTokenizer class] : [SPCSVTokenizer class];
+
+	if (dataTokenizer) SPClear(dataTokenizer);
+
+	dataTokenizer = [[tokenizerClass alloc] initWithStringEncoding:encoding fieldTerminator:fieldEndString lineTerminator:lineEndString fieldQuote:fieldQuoteString escape:escapeString];
+
+	if (!dataTokenizer) return NO;
+
+	dataEncoding = encoding;
+	[dataTokenizer setEscapeStringsAreMatchedStrictly:useStrictEscapeMatching];
+	[dataTokenizer setNullReplacementString:nullReplacementString];
+
+	// Pass on any string which hasn't been parsed yet
+	if (csvStringLength > parserPosition) {
+		[dataTokenizer appendData:[[csvString substringFromIndex:parserPosition] dataUsingEncoding:encoding]];
+	}
+	[csvString setString:@""];
+	trimPosition = 0;
+	parserPosition = 0;
+	csvStringLength = 0;
+
+	return YES;
+}
+
+/**
+ * Append additional raw data when parsing raw data; the data may be split anywhere,
+ * including within characters.
+ */
+- (void) appendData:(NSData *)someData
+{
+	[dataTokenizer appendData:someData];
+}
+
+/**
+ * When parsing raw data, set the indexes of the fields which are decoded into strings; other
+ * fields are returned as NSNull.  Set to nil, the default, to decode all fields.
+ */
+- (void) setMaterialisedFieldIndexes:(NSIndexSet *)fieldIndexes
+{
+	[dataTokenizer setMaterialisedFieldIndexes:fieldIndexes];
+}
+
+/**
+ * Returns whether raw data was encountered which isn't valid in the parsed encoding.
+ */
+- (BOOL) encodingErrorOccurred
+{
+	return [dataTokenizer encodingErrorOccurred];
+}
+
 #pragma mark -
 #pragma mark Basic information
 
@@ -350,6 +437,8 @@
  */
 - (NSUInteger) length
 {
+	if (dataTokenizer) return [dataTokenizer length];
+
 	return csvStringLength - trimPosition;
 }
 
@@ -358,6 +447,8 @@
  */
 - (NSString *) string
 {
+	if (dataTokenizer) return [[[NSString alloc] initWithData:[dataTokenizer remainingData] encoding:dataEncoding] autorelease];
+
 	return [csvString substringWithRange:NSMakeRange(trimPosition, csvStringLength - trimPosition)];
 }
 
@@ -366,6 +457,8 @@
  */
 - (NSUInteger) parserPosition
 {
+	if (dataTokenizer) return [dataTokenizer tokenizerPosition];
+
 	return parserPosition;
 }
 
@@ -375,6 +468,8 @@
  */
 - (NSUInteger) totalLengthParsed
 {
+	if (dataTokenizer) return [dataTokenizer totalLengthParsed];
+
 	return totalLengthParsed;
 }
 
@@ -472,6 +567,8 @@
 	if (nullReplacementString) SPClear(nullReplacementString);
 
 	if (nullString) nullReplacementString = [[NSString alloc] initWithString:nullString];
+
+	[dataTokenizer setNullReplacementString:nullReplacementString];
 }
 
 /**
@@ -483,6 +580,8 @@
 - (void) setEscapeStringsAreMatchedStrictly:(BOOL)strictMatching
 {
 	useStrictEscapeMatching = strictMatching;
+
+	[dataTokenizer setEscapeStringsAreMatchedStrictly:strictMatching];
 }
 
 #pragma mark -
@@ -519,6 +618,10 @@
 	// Set up the default null replacement character string as nil
 	nullReplacementString = nil;
 
+	// Strings are parsed until raw data parsing is requested
+	dataTokenizer = nil;
+	dataEncoding = NSUTF8StringEncoding;
+
 	// With the default field and line separators, it's possible to skip
 	// a few characters - reset the character set that can be skipped
 	skipCharacterSet = nil;
@@ -661,6 +764,7 @@
 	SPClear(escapedEscapeString);
 	if (nullReplacementString) SPClear(nullReplacementString);
 	if (skipCharacterSet)      SPClear(skipCharacterSet);
+	if (dataTokenizer)         SPClear(dataTokenizer);
 	[super dealloc];
 }
 
@@ -0,0 +1,129 @@
+//
+//  SPCSVTokenizer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * The location of a field of the current row, together with how it was written.  Fields which
+ * needed unescaping, or were assembled from several parts of the data, are held in the
+ * tokenizer's unescaped field buffer rather than in the CSV data itself.
+ */
+typedef struct {
+	NSUInteger location;
+	NSUInteger length;
+	uint8_t flags;
+} SPCSVFieldSpan;
+
+typedef enum {
+	SPCSVFieldIsQuoted    = 1 << 0, // The field started with the field quote string
+	SPCSVFieldIsUnescaped = 1 << 1, // The field is held in the unescaped field buffer
+	SPCSVFieldIsNull      = 1 << 2  // The field is \N, or the null replacement string unquoted
+} SPCSVFieldFlags;
+
+/**
+ * @class SPCSVTokenizer SPCSVTokenizer.h
+ *
+ * Splits CSV data into rows and fields working directly on the bytes of the data, for encodings
+ * in which the ASCII characters are single bytes never occurring within other characters, and
+ * single character field terminators, quotes and escapes.  The tokenizer follows the same rules
+ * as SPCSVParser - including its escaping, Excel-style doubled quotes, whitespace skipping, null
+ * strings and empty row handling - and is used by SPCSVParser when parsing raw data.
+ *
+ * Structural characters are located 64 bytes at a time, by building a bitmask of the quote, field
+ * terminator and line terminator bytes of each block with SSE2 or NEON comparisons where available,
+ * and then walking the set bits.  Each row is tokenized into field spans without copying, and
+ * strings are only created for the fields which are requested, so columns of the file which
+ * aren't imported are never decoded.
+ */
+@interface SPCSVTokenizer : NSObject
+{
+	NSMutableData *csvData;
+	NSUInteger trimPosition;
+	NSUInteger tokenizerPosition;
+	NSUInteger totalLengthParsed;
+	NSStringEncoding stringEncoding;
+	BOOL byteOrderMarkChecked;
+
+	uint8_t fieldEndByte;
+	uint8_t fieldQuoteByte;
+	uint8_t escapeByte;
+	uint8_t lineEndBytes[2];
+	NSUInteger lineEndLength;
+	BOOL hasFieldQuote;
+	BOOL hasEscape;
+	BOOL escapeIsFieldQuote;
+	BOOL useStrictEscapeMatching;
+	BOOL skipSpaces;
+	BOOL skipTabs;
+	NSData *nullReplacementData;
+
+	uint8_t structuralBytes[3];
+	NSUInteger structuralByteCount;
+	NSUInteger maskBlockLocation;
+	uint64_t maskBlockBits;
+
+	SPCSVFieldSpan *fieldSpans;
+	NSUInteger fieldSpanCount;
+	NSUInteger fieldSpanCapacity;
+	NSMutableData *unescapedData;
+
+	NSInteger rowFieldCount;
+	NSIndexSet *materialisedFieldIndexes;
+	BOOL encodingErrorOccurred;
+}
+
++ (BOOL)canTokenizeStringEncoding:(NSStringEncoding)encoding fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape;
+
+- (id)initWithStringEncoding:(NSStringEncoding)encoding fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape;
+
+/* Settings */
+- (void)setNullReplacementString:(NSString *)nullString;
+- (void)setEscapeStringsAreMatchedStrictly:(BOOL)strictMatching;
+- (void)setMaterialisedFieldIndexes:(NSIndexSet *)fieldIndexes;
+- (void)setSkipsByteOrderMark:(BOOL)skipByteOrderMark;
+
+/* Adding data */
+- (void)appendData:(NSData *)someData;
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+/* Tokenizing rows */
+- (BOOL)tokenizeRowAndTrimData:(BOOL)trimData dataIsComplete:(BOOL)dataComplete;
+- (NSUInteger)fieldCount;
+- (SPCSVFieldSpan)fieldSpanAtIndex:(NSUInteger)fieldIndex;
+- (id)fieldAtIndex:(NSUInteger)fieldIndex;
+- (NSMutableArray *)tokenizedRowAsArray;
+- (NSArray *)getRowAsArrayAndTrimData:(BOOL)trimData dataIsComplete:(BOOL)dataComplete;
+
+/* Basic information */
+- (NSUInteger)length;
+- (NSData *)remainingData;
+- (NSUInteger)tokenizerPosition;
+- (NSUInteger)totalLengthParsed;
+- (BOOL)encodingErrorOccurred;
+
+@end
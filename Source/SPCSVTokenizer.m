@@ -0,0 +1,798 @@
+//
+//  SPCSVTokenizer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVTokenizer.h"
+#import "SPExportByteScanning.h"
+
+// How far the tokenizer moves through the data before discarding the tokenized part
+static const NSUInteger SPCSVTokenizerTrimLength = 1024 * 1024;
+
+static const uint8_t SPCSVUTF8ByteOrderMark[3] = { 0xEF, 0xBB, 0xBF };
+
+/**
+ * The state of a structural character search: the data, the bytes searched for, and the bitmask
+ * of the last 64-byte block examined.  Blocks are aligned to the start of the data, and only
+ * complete blocks are cached, so appending data never invalidates the cached bitmask.
+ */
+typedef struct {
+	const uint8_t *bytes;
+	NSUInteger length;
+	const uint8_t *structuralBytes;
+	NSUInteger structuralByteCount;
+	NSUInteger *blockLocation;
+	uint64_t *blockBits;
+} SPCSVStructuralScan;
+
+static inline uint64_t SPCSVStructuralBitmask(const uint8_t *block, const uint8_t *structuralBytes, NSUInteger structuralByteCount);
+static inline NSUInteger SPCSVFindStructuralByte(SPCSVStructuralScan *scan, NSUInteger position);
+static inline NSUInteger SPCSVSkipWhitespace(const uint8_t *bytes, NSUInteger length, NSUInteger position, BOOL skipSpaces, BOOL skipTabs);
+static inline void SPCSVFieldAppendData(SPCSVFieldSpan *field, const uint8_t *bytes, NSUInteger location, NSUInteger length, NSMutableData *unescapedData);
+static inline void SPCSVFieldAppendLiteral(SPCSVFieldSpan *field, const uint8_t *bytes, const uint8_t *literal, NSUInteger length, NSMutableData *unescapedData);
+static void SPCSVFieldMoveToUnescapedData(SPCSVFieldSpan *field, const uint8_t *bytes, NSMutableData *unescapedData);
+static NSUInteger SPCSVRemoveEscapes(uint8_t *bytes, NSUInteger length, uint8_t escapeByte, const uint8_t *sequence, NSUInteger sequenceLength);
+
+@interface SPCSVTokenizer ()
+
+- (BOOL)_tokenizeNextRowWithDataIsComplete:(BOOL)dataComplete;
+- (void)_finishField:(SPCSVFieldSpan *)field dataBytes:(const uint8_t *)bytes;
+- (void)_discardTokenizedData;
+
+@end
+
+@implementation SPCSVTokenizer
+
+/**
+ * Returns whether data in the supplied encoding, using the supplied terminators, quote and escape
+ * strings, can be tokenized bytewise.
+ */
++ (BOOL)canTokenizeStringEncoding:(NSStringEncoding)encoding fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape
+{
+	if (!SPExportEncodingIsASCIICompatible(encoding)) return NO;
+
+	if ([fieldEnd length] != 1 || [lineEnd length] < 1 || [lineEnd length] > 2 || [fieldQuote length] > 1 || [escape length] > 1) return NO;
+
+	for (NSString *string in @[fieldEnd, lineEnd, fieldQuote, escape])
+	{
+		for (NSUInteger i = 0; i < [string length]; i++)
+		{
+			if ([string characterAtIndex:i] > 0x7F) return NO;
+		}
+	}
+
+	return YES;
+}
+
+/**
+ * Set up a tokenizer for data in the supplied encoding.  Returns nil if the data can't be tokenized
+ * bytewise, in which case it should be decoded and parsed by SPCSVParser as strings.
+ */
+- (id)initWithStringEncoding:(NSStringEncoding)encoding fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape
+{
+	if (![SPCSVTokenizer canTokenizeStringEncoding:encoding fieldTerminator:fieldEnd lineTerminator:lineEnd fieldQuote:fieldQuote escape:escape]) {
+		[self release];
+		return nil;
+	}
+
+	if ((self = [super init])) {
+		csvData = [[NSMutableData alloc] init];
+		trimPosition = 0;
+		tokenizerPosition = 0;
+		totalLengthParsed = 0;
+		stringEncoding = encoding;
+		byteOrderMarkChecked = (encoding != NSUTF8StringEncoding);
+
+		fieldEndByte = (uint8_t)[fieldEnd characterAtIndex:0];
+		lineEndLength = [lineEnd length];
+		lineEndBytes[0] = (uint8_t)[lineEnd characterAtIndex:0];
+		lineEndBytes[1] = (lineEndLength > 1) ? (uint8_t)[lineEnd characterAtIndex:1] : 0;
+		hasFieldQuote = ([fieldQuote length] > 0);
+		fieldQuoteByte = hasFieldQuote ? (uint8_t)[fieldQuote characterAtIndex:0] : 0;
+		hasEscape = ([escape length] > 0);
+		escapeByte = hasEscape ? (uint8_t)[escape characterAtIndex:0] : 0;
+		escapeIsFieldQuote = [fieldQuote isEqualToString:escape];
+		useStrictEscapeMatching = NO;
+		nullReplacementData = nil;
+
+		// Leading whitespace is skipped unless it is one of the structural strings, as for SPCSVParser
+		skipSpaces = ![fieldEnd isEqualToString:@" "] && ![fieldQuote isEqualToString:@" "] && ![escape isEqualToString:@" "] && ![lineEnd isEqualToString:@" "];
+		skipTabs = ![fieldEnd isEqualToString:@"\t"] && ![fieldQuote isEqualToString:@"\t"] && ![escape isEqualToString:@"\t"] && ![lineEnd isEqualToString:@"\t"];
+
+		// Fields and rows are split at the field terminator, the first byte of the line terminator
+		// and the field quote; escapes are only ever looked for just before those
+		structuralByteCount = 0;
+		structuralBytes[structuralByteCount++] = fieldEndByte;
+		if (lineEndBytes[0] != fieldEndByte) structuralBytes[structuralByteCount++] = lineEndBytes[0];
+		if (hasFieldQuote && fieldQuoteByte != fieldEndByte && fieldQuoteByte != lineEndBytes[0]) structuralBytes[structuralByteCount++] = fieldQuoteByte;
+		maskBlockLocation = NSNotFound;
+		maskBlockBits = 0;
+
+		fieldSpanCapacity = 32;
+		fieldSpans = malloc(sizeof(SPCSVFieldSpan) * fieldSpanCapacity);
+		fieldSpanCount = 0;
+		unescapedData = [[NSMutableData alloc] init];
+
+		rowFieldCount = NSNotFound;
+		materialisedFieldIndexes = nil;
+		encodingErrorOccurred = NO;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Settings
+
+/**
+ * Set a string to be returned as NSNull if it is encountered unquoted, as for SPCSVParser.
+ */
+- (void)setNullReplacementString:(NSString *)nullString
+{
+	if (nullReplacementData) SPClear(nullReplacementData);
+
+	if (nullString) nullReplacementData = [[nullString dataUsingEncoding:stringEncoding] retain];
+}
+
+/**
+ * Set whether doubled field quotes are only treated as escaped quotes if the escape string is the
+ * field quote string, as for SPCSVParser.
+ */
+- (void)setEscapeStringsAreMatchedStrictly:(BOOL)strictMatching
+{
+	useStrictEscapeMatching = strictMatching;
+}
+
+/**
+ * Set the indexes of the fields which are returned by -getRowAsArrayAndTrimData:dataIsComplete:;
+ * other fields are returned as NSNull without being decoded.  Set to nil to return all fields.
+ */
+- (void)setMaterialisedFieldIndexes:(NSIndexSet *)fieldIndexes
+{
+	if (materialisedFieldIndexes != fieldIndexes) {
+		[materialisedFieldIndexes release];
+		materialisedFieldIndexes = [fieldIndexes copy];
+	}
+}
+
+/**
+ * Set whether a UTF-8 byte order mark at the start of the data is skipped, which it is by default.
+ * Data which continues part way through a file shouldn't have one skipped.
+ */
+- (void)setSkipsByteOrderMark:(BOOL)skipByteOrderMark
+{
+	byteOrderMarkChecked = (!skipByteOrderMark || stringEncoding != NSUTF8StringEncoding);
+}
+
+#pragma mark -
+#pragma mark Adding data
+
+/**
+ * Append additional data to tokenize, for example to allow streaming parsing.  The data may be
+ * split anywhere, including within characters.
+ */
+- (void)appendData:(NSData *)someData
+{
+	[csvData appendData:someData];
+}
+
+/**
+ * Append additional bytes to tokenize.
+ */
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+	[csvData appendBytes:bytes length:length];
+}
+
+#pragma mark -
+#pragma mark Tokenizing rows
+
+/**
+ * Tokenize the next row into field spans, which remain valid until the next row is tokenized.
+ * Empty rows are skipped.  As for SPCSVParser, if the data isn't yet complete, a final row which
+ * has no line terminator is left untokenized so it can be completed by more data.
+ *
+ * @return NO if no more rows can be tokenized
+ */
+- (BOOL)tokenizeRowAndTrimData:(BOOL)trimData dataIsComplete:(BOOL)dataComplete
+{
+	[self _discardTokenizedData];
+
+	// Skip a UTF-8 byte order mark at the start of the data
+	if (!byteOrderMarkChecked && ([csvData length] >= 3 || dataComplete)) {
+		byteOrderMarkChecked = YES;
+
+		if (!tokenizerPosition && [csvData length] >= 3 && !memcmp([csvData bytes], SPCSVUTF8ByteOrderMark, 3)) {
+			tokenizerPosition = trimPosition = 3;
+			totalLengthParsed += 3;
+		}
+	}
+
+	while ([self _tokenizeNextRowWithDataIsComplete:dataComplete])
+	{
+		// Skip empty rows, and rows only consisting of a null
+		if (!fieldSpanCount || (fieldSpanCount == 1 && ((fieldSpans[0].flags & SPCSVFieldIsNull) || !fieldSpans[0].length))) {
+			if (tokenizerPosition == [csvData length]) break;
+
+			continue;
+		}
+
+		// Mark the row's data as discardable, once the spans are no longer needed
+		if (trimData) trimPosition = tokenizerPosition;
+
+		return YES;
+	}
+
+	fieldSpanCount = 0;
+
+	return NO;
+}
+
+/**
+ * Returns the number of fields in the tokenized row.
+ */
+- (NSUInteger)fieldCount
+{
+	return fieldSpanCount;
+}
+
+/**
+ * Returns the location of a field of the tokenized row.
+ */
+- (SPCSVFieldSpan)fieldSpanAtIndex:(NSUInteger)fieldIndex
+{
+	return fieldSpans[fieldIndex];
+}
+
+/**
+ * Returns a field of the tokenized row as a string, or NSNull for null fields.  If the field isn't
+ * valid in the tokenizer's encoding, an empty string is returned and -encodingErrorOccurred is set.
+ */
+- (id)fieldAtIndex:(NSUInteger)fieldIndex
+{
+	SPCSVFieldSpan field = fieldSpans[fieldIndex];
+
+	if (field.flags & SPCSVFieldIsNull) return [NSNull null];
+	if (!field.length) return @"";
+
+	const uint8_t *bytes = (field.flags & SPCSVFieldIsUnescaped) ? [unescapedData bytes] : [csvData bytes];
+	NSString *fieldString = [[NSString alloc] initWithBytes:(bytes + field.location) length:field.length encoding:stringEncoding];
+
+	if (!fieldString) {
+		encodingErrorOccurred = YES;
+
+		return @"";
+	}
+
+	return [fieldString autorelease];
+}
+
+/**
+ * Returns the fields of the tokenized row as an array, without padding it to the number of
+ * fields of the first row.  Fields which aren't in the materialised field indexes are NSNull.
+ */
+- (NSMutableArray *)tokenizedRowAsArray
+{
+	NSUInteger i;
+	NSUInteger capacity = (rowFieldCount == NSNotFound || (NSUInteger)rowFieldCount < fieldSpanCount) ? fieldSpanCount : (NSUInteger)rowFieldCount;
+	NSMutableArray *csvRowArray = [NSMutableArray arrayWithCapacity:capacity];
+
+	for (i = 0; i < fieldSpanCount; i++)
+	{
+		if (materialisedFieldIndexes && ![materialisedFieldIndexes containsIndex:i]) {
+			[csvRowArray addObject:[NSNull null]];
+		}
+		else {
+			[csvRowArray addObject:[self fieldAtIndex:i]];
+		}
+	}
+
+	return csvRowArray;
+}
+
+/**
+ * Retrieve the next row as an array of strings, in the same way as SPCSVParser: rows are padded
+ * with SPNotLoaded to the number of fields of the first row returned.  Fields which aren't in the
+ * materialised field indexes are returned as NSNull.
+ *
+ * @return nil if no more rows can be returned
+ */
+- (NSArray *)getRowAsArrayAndTrimData:(BOOL)trimData dataIsComplete:(BOOL)dataComplete
+{
+	if (![self tokenizeRowAndTrimData:trimData dataIsComplete:dataComplete]) return nil;
+
+	NSUInteger i;
+	NSMutableArray *csvRowArray = [self tokenizedRowAsArray];
+
+	if (rowFieldCount == NSNotFound) {
+		rowFieldCount = fieldSpanCount;
+	}
+	else {
+		for (i = fieldSpanCount; i < (NSUInteger)rowFieldCount; i++) [csvRowArray addObject:[SPNotLoaded notLoaded]];
+	}
+
+	return csvRowArray;
+}
+
+#pragma mark -
+#pragma mark Basic information
+
+/**
+ * Returns the length of the data which hasn't been trimmed.
+ */
+- (NSUInteger)length
+{
+	return [csvData length] - trimPosition;
+}
+
+/**
+ * Returns the data which hasn't been trimmed.
+ */
+- (NSData *)remainingData
+{
+	return [csvData subdataWithRange:NSMakeRange(trimPosition, [csvData length] - trimPosition)];
+}
+
+/**
+ * Returns the position of the tokenizer within the data which hasn't been discarded.
+ */
+- (NSUInteger)tokenizerPosition
+{
+	return tokenizerPosition;
+}
+
+/**
+ * Returns the total length of data tokenized, in bytes.
+ */
+- (NSUInteger)totalLengthParsed
+{
+	return totalLengthParsed;
+}
+
+/**
+ * Returns whether a field couldn't be decoded in the tokenizer's encoding.
+ */
+- (BOOL)encodingErrorOccurred
+{
+	return encodingErrorOccurred;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Tokenize the fields up to the next line terminator, following the rules of
+ * -[SPCSVParser getRowAsArrayAndTrimString:stringIsComplete:].
+ *
+ * @return NO, leaving the position unchanged, if the data isn't complete and no line terminator
+ *         was found; otherwise YES, including when no fields remain
+ */
+- (BOOL)_tokenizeNextRowWithDataIsComplete:(BOOL)dataComplete
+{
+	const uint8_t *bytes = [csvData bytes];
+	NSUInteger length = [csvData length];
+	NSUInteger position = tokenizerPosition;
+	NSUInteger nextQuote, nextTerminator, skipLength, j;
+	BOOL isEscaped, terminatorIsLineEnd;
+	BOOL nonStrictEscapeMatchingFallback = NO;
+	BOOL lineEndingEncountered = NO;
+	SPCSVStructuralScan scan = { bytes, length, structuralBytes, structuralByteCount, &maskBlockLocation, &maskBlockBits };
+	SPCSVFieldSpan field;
+
+	fieldSpanCount = 0;
+	[unescapedData setLength:0];
+
+	while (position < length && !lineEndingEncountered)
+	{
+		field.location = position;
+		field.length = 0;
+		field.flags = 0;
+
+		position = SPCSVSkipWhitespace(bytes, length, position, skipSpaces, skipTabs);
+
+		// Capture the entire quoted string if the field starts with the quote character
+		if (hasFieldQuote && position < length && bytes[position] == fieldQuoteByte) {
+			position++;
+			field.flags |= SPCSVFieldIsQuoted;
+
+			while (position < length)
+			{
+				nextQuote = position;
+				while ((nextQuote = SPCSVFindStructuralByte(&scan, nextQuote)) != NSNotFound && bytes[nextQuote] != fieldQuoteByte) nextQuote++;
+
+				// Check whether the quote was escaped, or doubled Excel-style
+				if (hasEscape && nextQuote != NSNotFound) {
+					isEscaped = NO;
+					nonStrictEscapeMatchingFallback = NO;
+					skipLength = 1;
+
+					if (!escapeIsFieldQuote) {
+						for (j = nextQuote; j > position && bytes[j - 1] == escapeByte; j--) isEscaped = !isEscaped;
+						if (!useStrictEscapeMatching && !isEscaped) nonStrictEscapeMatchingFallback = YES;
+					}
+
+					if ((escapeIsFieldQuote || nonStrictEscapeMatchingFallback) && nextQuote + 2 <= length && bytes[nextQuote + 1] == fieldQuoteByte) {
+						isEscaped = YES;
+						skipLength = 2;
+					}
+
+					if (isEscaped) {
+						if (escapeIsFieldQuote || nonStrictEscapeMatchingFallback) {
+							SPCSVFieldAppendData(&field, bytes, position, nextQuote + 1 - position, unescapedData);
+						}
+						else {
+							SPCSVFieldAppendData(&field, bytes, position, nextQuote - 1 - position, unescapedData);
+							SPCSVFieldAppendLiteral(&field, bytes, &fieldQuoteByte, 1, unescapedData);
+						}
+
+						position = nextQuote + skipLength;
+						continue;
+					}
+				}
+
+				if (nextQuote != NSNotFound) {
+					SPCSVFieldAppendData(&field, bytes, position, nextQuote - position, unescapedData);
+					position = nextQuote + 1;
+				}
+				else {
+					SPCSVFieldAppendData(&field, bytes, position, length - position, unescapedData);
+					position = length;
+				}
+
+				if (position < length) position = SPCSVSkipWhitespace(bytes, length, position, skipSpaces, skipTabs);
+
+				break;
+			}
+		}
+
+		// Process the rest of the field up to the next field or line terminator
+		while (position < length)
+		{
+			nextTerminator = position;
+			terminatorIsLineEnd = NO;
+
+			while ((nextTerminator = SPCSVFindStructuralByte(&scan, nextTerminator)) != NSNotFound)
+			{
+				if (bytes[nextTerminator] == fieldEndByte) break;
+
+				if (bytes[nextTerminator] == lineEndBytes[0] && (lineEndLength == 1 || (nextTerminator + 1 < length && bytes[nextTerminator + 1] == lineEndBytes[1]))) {
+					terminatorIsLineEnd = YES;
+					break;
+				}
+
+				nextTerminator++;
+			}
+
+			if (nextTerminator == NSNotFound) {
+				SPCSVFieldAppendData(&field, bytes, position, length - position, unescapedData);
+				position = length;
+				break;
+			}
+
+			skipLength = terminatorIsLineEnd ? lineEndLength : 1;
+
+			// If the terminator was escaped, keep it in the field
+			if (hasEscape) {
+				isEscaped = NO;
+				for (j = nextTerminator; j > position && bytes[j - 1] == escapeByte; j--) isEscaped = !isEscaped;
+
+				if (isEscaped) {
+					SPCSVFieldAppendData(&field, bytes, position, nextTerminator - 1 - position, unescapedData);
+
+					if (terminatorIsLineEnd) {
+						SPCSVFieldAppendLiteral(&field, bytes, lineEndBytes, lineEndLength, unescapedData);
+					}
+					else {
+						SPCSVFieldAppendLiteral(&field, bytes, &fieldEndByte, 1, unescapedData);
+					}
+
+					position = nextTerminator + skipLength;
+					continue;
+				}
+			}
+
+			SPCSVFieldAppendData(&field, bytes, position, nextTerminator - position, unescapedData);
+			position = nextTerminator + skipLength;
+			lineEndingEncountered = terminatorIsLineEnd;
+
+			break;
+		}
+
+		[self _finishField:&field dataBytes:bytes];
+
+		if (fieldSpanCount == fieldSpanCapacity) {
+			fieldSpanCapacity *= 2;
+			fieldSpans = realloc(fieldSpans, sizeof(SPCSVFieldSpan) * fieldSpanCapacity);
+		}
+
+		fieldSpans[fieldSpanCount++] = field;
+	}
+
+	// Leave a final row without a line terminator until all the data has been supplied
+	if (!lineEndingEncountered && !dataComplete) {
+		fieldSpanCount = 0;
+
+		return NO;
+	}
+
+	totalLengthParsed += position - tokenizerPosition;
+	tokenizerPosition = position;
+
+	return YES;
+}
+
+/**
+ * Mark a field as null, or remove its escapes, as SPCSVParser does once a field is complete.
+ */
+- (void)_finishField:(SPCSVFieldSpan *)field dataBytes:(const uint8_t *)bytes
+{
+	BOOL fieldIsQuoted = (field->flags & SPCSVFieldIsQuoted);
+	const uint8_t *fieldBytes = ((field->flags & SPCSVFieldIsUnescaped) ? (const uint8_t *)[unescapedData bytes] : bytes) + field->location;
+
+	if ((field->length == 2 && fieldBytes[0] == '\\' && fieldBytes[1] == 'N')
+		|| (!fieldIsQuoted && nullReplacementData && field->length == [nullReplacementData length] && !memcmp(fieldBytes, [nullReplacementData bytes], field->length)))
+	{
+		field->flags |= SPCSVFieldIsNull;
+
+		return;
+	}
+
+	if (!hasEscape || !field->length || !memchr(fieldBytes, escapeByte, field->length)) return;
+
+	if (!(field->flags & SPCSVFieldIsUnescaped)) SPCSVFieldMoveToUnescapedData(field, bytes, unescapedData);
+
+	// Apply the same replacements, in the same order, as SPCSVParser
+	uint8_t *unescapedBytes = (uint8_t *)[unescapedData mutableBytes] + field->location;
+	NSUInteger unescapedLength = field->length;
+
+	if (fieldIsQuoted) unescapedLength = SPCSVRemoveEscapes(unescapedBytes, unescapedLength, escapeByte, &fieldEndByte, 1);
+	if (!fieldIsQuoted && hasFieldQuote) unescapedLength = SPCSVRemoveEscapes(unescapedBytes, unescapedLength, escapeByte, &fieldQuoteByte, 1);
+	if (fieldIsQuoted) unescapedLength = SPCSVRemoveEscapes(unescapedBytes, unescapedLength, escapeByte, lineEndBytes, lineEndLength);
+	if (!escapeIsFieldQuote) unescapedLength = SPCSVRemoveEscapes(unescapedBytes, unescapedLength, escapeByte, &escapeByte, 1);
+
+	field->length = unescapedLength;
+	[unescapedData setLength:field->location + unescapedLength];
+}
+
+/**
+ * Discard the data before the trim position once enough has built up, to trade off memory
+ * usage against the cost of moving the remaining data.
+ */
+- (void)_discardTokenizedData
+{
+	if (trimPosition < SPCSVTokenizerTrimLength) return;
+
+	[csvData replaceBytesInRange:NSMakeRange(0, trimPosition) withBytes:NULL length:0];
+
+	tokenizerPosition -= trimPosition;
+	trimPosition = 0;
+
+	// The data has moved relative to the cached block
+	maskBlockLocation = NSNotFound;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(csvData);
+	SPClear(unescapedData);
+	if (nullReplacementData) SPClear(nullReplacementData);
+	if (materialisedFieldIndexes) SPClear(materialisedFieldIndexes);
+
+	free(fieldSpans);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+#pragma mark Tokenizing functions
+
+/**
+ * Returns a bitmask of the bytes of a 64-byte block which match any of the structural bytes, with
+ * bit n set for byte n.
+ */
+static inline uint64_t SPCSVStructuralBitmask(const uint8_t *block, const uint8_t *structuralBytes, NSUInteger structuralByteCount)
+{
+	uint64_t bitmask = 0;
+	NSUInteger i, j;
+
+#if defined(__SSE2__)
+	__m128i needles[3];
+
+	for (j = 0; j < 3; j++) needles[j] = _mm_set1_epi8((char)structuralBytes[j < structuralByteCount ? j : 0]);
+
+	for (i = 0; i < 4; i++)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(block + (i * 16)));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, needles[0]), _mm_cmpeq_epi8(chunk, needles[1])), _mm_cmpeq_epi8(chunk, needles[2]));
+
+		bitmask |= (uint64_t)(uint16_t)_mm_movemask_epi8(matches) << (i * 16);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	static const uint8_t bitWeights[16] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+	uint8x16_t weights = vld1q_u8(bitWeights);
+	uint8x16_t needles[3];
+	uint8x16_t weightedMatches[4];
+
+	for (j = 0; j < 3; j++) needles[j] = vdupq_n_u8(structuralBytes[j < structuralByteCount ? j : 0]);
+
+	for (i = 0; i < 4; i++)
+	{
+		uint8x16_t chunk = vld1q_u8(block + (i * 16));
+		uint8x16_t matches = vorrq_u8(vorrq_u8(vceqq_u8(chunk, needles[0]), vceqq_u8(chunk, needles[1])), vceqq_u8(chunk, needles[2]));
+
+		weightedMatches[i] = vandq_u8(matches, weights);
+	}
+
+	// Pairwise additions combine each byte's weighted bit into the 64-bit mask
+	uint8x16_t sum = vpaddq_u8(vpaddq_u8(weightedMatches[0], weightedMatches[1]), vpaddq_u8(weightedMatches[2], weightedMatches[3]));
+	sum = vpaddq_u8(sum, sum);
+	bitmask = vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+#else
+	for (i = 0; i < 64; i++)
+	{
+		for (j = 0; j < structuralByteCount; j++)
+		{
+			if (block[i] == structuralBytes[j]) {
+				bitmask |= (uint64_t)1 << i;
+				break;
+			}
+		}
+	}
+#endif
+
+	return bitmask;
+}
+
+/**
+ * Returns the location of the next structural byte at or after the supplied position, or
+ * NSNotFound.  Complete blocks are searched using their bitmasks, and the final partial block
+ * bytewise.
+ */
+static inline NSUInteger SPCSVFindStructuralByte(SPCSVStructuralScan *scan, NSUInteger position)
+{
+	NSUInteger blockStart, j;
+	uint64_t bits;
+
+	while (position < scan->length)
+	{
+		blockStart = position & ~(NSUInteger)63;
+
+		if (blockStart + 64 > scan->length) {
+			for (; position < scan->length; position++)
+			{
+				for (j = 0; j < scan->structuralByteCount; j++)
+				{
+					if (scan->bytes[position] == scan->structuralBytes[j]) return position;
+				}
+			}
+
+			return NSNotFound;
+		}
+
+		if (*scan->blockLocation != blockStart) {
+			*scan->blockBits = SPCSVStructuralBitmask(scan->bytes + blockStart, scan->structuralBytes, scan->structuralByteCount);
+			*scan->blockLocation = blockStart;
+		}
+
+		bits = *scan->blockBits & (~(uint64_t)0 << (position - blockStart));
+
+		if (bits) return blockStart + (NSUInteger)__builtin_ctzll(bits);
+
+		position = blockStart + 64;
+	}
+
+	return NSNotFound;
+}
+
+/**
+ * Returns the position after any skippable whitespace.
+ */
+static inline NSUInteger SPCSVSkipWhitespace(const uint8_t *bytes, NSUInteger length, NSUInteger position, BOOL skipSpaces, BOOL skipTabs)
+{
+	while (position < length && ((skipSpaces && bytes[position] == ' ') || (skipTabs && bytes[position] == '\t'))) position++;
+
+	return position;
+}
+
+/**
+ * Add a range of the data to a field.  A field made up of a single range refers to the data
+ * directly; once a second part is added it is copied into the unescaped field buffer.
+ */
+static inline void SPCSVFieldAppendData(SPCSVFieldSpan *field, const uint8_t *bytes, NSUInteger location, NSUInteger length, NSMutableData *unescapedData)
+{
+	if (!length) return;
+
+	if (field->flags & SPCSVFieldIsUnescaped) {
+		[unescapedData appendBytes:(bytes + location) length:length];
+		field->length += length;
+	}
+	else if (!field->length) {
+		field->location = location;
+		field->length = length;
+	}
+	else if (field->location + field->length == location) {
+		field->length += length;
+	}
+	else {
+		SPCSVFieldMoveToUnescapedData(field, bytes, unescapedData);
+		[unescapedData appendBytes:(bytes + location) length:length];
+		field->length += length;
+	}
+}
+
+/**
+ * Add bytes which don't appear in the data at this point, such as an unescaped terminator, to a field.
+ */
+static inline void SPCSVFieldAppendLiteral(SPCSVFieldSpan *field, const uint8_t *bytes, const uint8_t *literal, NSUInteger length, NSMutableData *unescapedData)
+{
+	if (!(field->flags & SPCSVFieldIsUnescaped)) SPCSVFieldMoveToUnescapedData(field, bytes, unescapedData);
+
+	[unescapedData appendBytes:literal length:length];
+	field->length += length;
+}
+
+/**
+ * Copy a field's data to the end of the unescaped field buffer.
+ */
+static void SPCSVFieldMoveToUnescapedData(SPCSVFieldSpan *field, const uint8_t *bytes, NSMutableData *unescapedData)
+{
+	NSUInteger unescapedLocation = [unescapedData length];
+
+	if (field->length) [unescapedData appendBytes:(bytes + field->location) length:field->length];
+
+	field->location = unescapedLocation;
+	field->flags |= SPCSVFieldIsUnescaped;
+}
+
+/**
+ * Replace each occurrence of the escape byte followed by the sequence with the sequence, in place,
+ * matching occurrences from the start as -[NSMutableString replaceOccurrencesOfString:...] does.
+ * Returns the new length.
+ */
+static NSUInteger SPCSVRemoveEscapes(uint8_t *bytes, NSUInteger length, uint8_t escapeByte, const uint8_t *sequence, NSUInteger sequenceLength)
+{
+	NSUInteger readPosition = 0, writePosition = 0;
+
+	while (readPosition < length)
+	{
+		if (bytes[readPosition] == escapeByte && readPosition + 1 + sequenceLength <= length && !memcmp(bytes + readPosition + 1, sequence, sequenceLength)) {
+			memmove(bytes + writePosition, bytes + readPosition + 1, sequenceLength);
+			writePosition += sequenceLength;
+			readPosition += 1 + sequenceLength;
+		}
+		else {
+			bytes[writePosition++] = bytes[readPosition++];
+		}
+	}
+
+	return writePosition;
+}
@@ -68,6 +68,7 @@ typedef NS_ENUM(NSUInteger, SPExportType) {
 	SPPDFExport   = 4,
 	SPHTMLExport  = 5,
 	SPExcelExport = 6,
+	SPArrowExport = 7,
 	SPAnyExportType = NSUIntegerMax, // this is a transient type to indicate "no specific choice"
 };
 
@@ -248,6 +249,13 @@ typedef enum
 // Narrow down completion max rows
 extern const NSUInteger SPNarrowDownCompletionMaxRows;
 
+// Deferred blob and text column previews
+extern const NSUInteger SPDeferredColumnPreviewLength;
+extern const NSUInteger SPDeferredColumnFetchBatchSize;
+
+// Incremental table content refreshes
+extern const NSUInteger SPIncrementalRefreshOverlapSeconds;
+
 // Default monospaced font name
 extern NSString *SPDefaultMonospacedFontName;
 
@@ -312,6 +320,7 @@ extern NSString *SPCustomQueryMaxHistoryItems;
 extern NSString *SPReloadAfterAddingRow;
 extern NSString *SPReloadAfterEditingRow;
 extern NSString *SPReloadAfterRemovingRow;
+extern NSString *SPDeferRowEditCommits;
 extern NSString *SPLoadBlobsAsNeeded;
 extern NSString *SPTableRowCountQueryLevel;
 extern NSString *SPTableRowCountCheapSizeBoundary;
@@ -406,9 +415,17 @@ extern NSString *SPCSVImportLineTerminator;
 extern NSString *SPCSVImportFieldEnclosedBy;
 extern NSString *SPCSVImportFieldEscapeCharacter;
 extern NSString *SPCSVImportFirstLineIsHeader;
+extern NSString *SPCSVImportLoadLocalData;
 extern NSString *SPCSVFieldImportMappingAlignment;
 extern NSString *SPImportClipboardTempFileNamePrefix;
+extern NSString *SPImportParallelConnections;
 extern NSString *SPLastExportSettings;
+extern NSString *SPExportParallelConnections;
+extern NSString *SPExportCheckpoints;
+extern NSString *SPExportStatisticsReports;
+extern NSString *SPExportSplitFileSize;
+extern NSString *SPExportSplitFilesPerTable;
+extern NSString *SPExportGzipCompressionLevel;
 
 // Export filename tokens
 extern NSString *SPFileNameDatabaseTokenName;
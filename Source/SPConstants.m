@@ -33,6 +33,13 @@
 // Narrow down completion max rows
 const NSUInteger SPNarrowDownCompletionMaxRows   = 15;
 
+// Deferred blob and text column previews
+const NSUInteger SPDeferredColumnPreviewLength   = 256;
+const NSUInteger SPDeferredColumnFetchBatchSize  = 100;
+
+// Incremental table content refreshes
+const NSUInteger SPIncrementalRefreshOverlapSeconds = 60;
+
 // Default monospaced font name
 NSString *SPDefaultMonospacedFontName            = @"Monaco";
 
@@ -97,6 +104,7 @@ NSString *SPCustomQueryMaxHistoryItems           = @"CustomQueryMaxHistoryItems"
 NSString *SPReloadAfterAddingRow                 = @"ReloadAfterAddingRow";
 NSString *SPReloadAfterEditingRow                = @"ReloadAfterEditingRow";
 NSString *SPReloadAfterRemovingRow               = @"ReloadAfterRemovingRow";
+NSString *SPDeferRowEditCommits                  = @"DeferRowEditCommits";
 NSString *SPLoadBlobsAsNeeded                    = @"LoadBlobsAsNeeded";
 NSString *SPTableRowCountQueryLevel              = @"TableRowCountQueryLevel";
 NSString *SPTableRowCountCheapSizeBoundary       = @"TableRowCountCheapLookupSizeBoundary";
@@ -190,10 +198,18 @@ NSString *SPCSVImportFieldEnclosedBy             = @"CSVImportFieldEnclosedBy";
 NSString *SPCSVImportFieldEscapeCharacter        = @"CSVImportFieldEscapeCharacter";
 NSString *SPCSVImportFieldTerminator             = @"CSVImportFieldTerminator";
 NSString *SPCSVImportFirstLineIsHeader           = @"CSVImportFirstLineIsHeader";
+NSString *SPCSVImportLoadLocalData               = @"CSVImportLoadLocalData";
 NSString *SPCSVImportLineTerminator              = @"CSVImportLineTerminator";
 NSString *SPCSVFieldImportMappingAlignment       = @"CSVFieldImportMappingAlignment";
 NSString *SPImportClipboardTempFileNamePrefix    = @"/tmp/_SP_ClipBoard_Import_File_";
+NSString *SPImportParallelConnections            = @"ImportParallelConnections";
 NSString *SPLastExportSettings                   = @"LastExportSettings";
+NSString *SPExportParallelConnections            = @"ExportParallelConnections";
+NSString *SPExportCheckpoints                    = @"ExportCheckpoints";
+NSString *SPExportStatisticsReports              = @"ExportStatisticsReports";
+NSString *SPExportSplitFileSize                  = @"ExportSplitFileSize";
+NSString *SPExportSplitFilesPerTable             = @"ExportSplitFilesPerTable";
+NSString *SPExportGzipCompressionLevel           = @"ExportGzipCompressionLevel";
 
 // Export filename tokens
 NSString *SPFileNameDatabaseTokenName            = @"database";
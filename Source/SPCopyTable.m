@@ -50,6 +50,9 @@
 #import "SPTablesList.h"
 #import "SPBundleCommandRunner.h"
 #import "SPDatabaseContentViewDelegate.h"
+#import "SPTextWidthMeasurer.h"
+#import "SPDataStorageSerializer.h"
+#import "SPDatabaseDocument.h"
 
 #import <SPMySQL/SPMySQL.h>
 #import "pthread.h"
@@ -59,10 +62,24 @@ NSInteger SPEditMenuCopy            = 2001;
 NSInteger SPEditMenuCopyWithColumns = 2002;
 NSInteger SPEditMenuCopyAsSQL       = 2003;
 
-static const NSInteger kBlobExclude     = 1;
-static const NSInteger kBlobInclude     = 2;
-static const NSInteger kBlobAsFile      = 3;
-static const NSInteger kBlobAsImageFile = 4;
+static const NSInteger kBlobExclude     = SPDataStorageBlobsExcluded;
+static const NSInteger kBlobInclude     = SPDataStorageBlobsIncluded;
+static const NSInteger kBlobAsFile      = SPDataStorageBlobsAsFiles;
+static const NSInteger kBlobAsImageFile = SPDataStorageBlobsAsImageFile;
+
+// Copies of at least this many rows are prepared in the background, with progress display
+static const NSUInteger SPCopyTableBackgroundCopyMinimumRows = 50000;
+static const NSInteger SPCopyTableDeferredEditsMenuItemTag = 10000001;
+
+@interface SPCopyTable ()
+
+- (SPTextWidthMeasurer *)_columnWidthMeasurer;
+- (NSUInteger)_autodetectWidthForColumnDefinition:(NSDictionary *)columnDefinition maxRows:(NSUInteger)rowsToCheck usingMeasurer:(SPTextWidthMeasurer *)measurer;
+- (SPDataStorageSerializer *)_serializerWithFormat:(SPDataStorageSerializationFormat)format;
+- (void)_copyRowsTask:(NSDictionary *)copyDetails;
+- (void)_writeCopiedString:(NSString *)copiedString asSQL:(BOOL)isSQL;
+
+@end
 
 @implementation SPCopyTable
 
@@ -101,30 +118,60 @@ static const NSInteger kBlobAsImageFile = 4;
 - (void)copy:(id)sender
 {
 #ifndef SP_CODA /* copy table rows */
-	NSString *tmp = nil;
-
-	if ([sender tag] == SPEditMenuCopyAsSQL) {
-		tmp = [self rowsAsSqlInsertsOnlySelectedRows:YES];
-		
-		if (tmp != nil){
-			NSPasteboard *pb = [NSPasteboard generalPasteboard];
+	if ([self numberOfSelectedRows] == 0) return;
 
-			[pb declareTypes:@[NSStringPboardType] owner:nil];
+	BOOL copyAsSQL = ([sender tag] == SPEditMenuCopyAsSQL);
+	NSIndexSet *selectedRows = [self selectedRowIndexes];
+	SPDataStorageSerializer *serializer;
 
-			[pb setString:tmp forType:NSStringPboardType];
-		}
-	} 
+	if (copyAsSQL) {
+		serializer = [self _serializerWithFormat:SPDataStorageSerializeAsSQLInserts];
+	}
 	else {
-		tmp = [self rowsAsTabStringWithHeaders:([sender tag] == SPEditMenuCopyWithColumns) onlySelectedRows:YES blobHandling:kBlobInclude];
-		
-		if (tmp != nil) {
-			NSPasteboard *pb = [NSPasteboard generalPasteboard];
+		serializer = [self _serializerWithFormat:SPDataStorageSerializeAsTabText];
+		[serializer setIncludesHeaders:([sender tag] == SPEditMenuCopyWithColumns)];
+		[serializer setBlobHandling:SPDataStorageBlobsIncluded];
+	}
 
-			[pb declareTypes:@[NSTabularTextPboardType, NSStringPboardType] owner:nil];
+	SPDatabaseDocument *tableDocument = nil;
+	if ([[self delegate] respondsToSelector:@selector(tableDocumentInstance)]) {
+		tableDocument = [(id)[self delegate] tableDocumentInstance];
+	}
+
+	// Prepare large copies in the background, allowing progress display and cancellation
+	if ([selectedRows count] >= SPCopyTableBackgroundCopyMinimumRows && tableDocument && ![tableDocument isWorking]) {
 
-			[pb setString:tmp forType:NSStringPboardType];
-			[pb setString:tmp forType:NSTabularTextPboardType];
+		// Ensure any row identification details are set up before they're used off the main thread
+		if (copyAsSQL && [[self delegate] isKindOfClass:[SPTableContent class]] && selectedTable) {
+			[tableInstance argumentForRow:[selectedRows firstIndex]];
 		}
+
+		[tableDocument startTaskWithDescription:NSLocalizedString(@"Copying rows...", @"copying table rows task description")];
+		[tableDocument enableTaskCancellationWithTitle:NSLocalizedString(@"Cancel", @"cancel button") callbackObject:serializer callbackFunction:@selector(cancel)];
+
+		[serializer setProgressHandler:^(CGFloat progress) {
+			[tableDocument setTaskPercentage:(progress * 100)];
+		}];
+
+		NSDictionary *copyDetails = @{
+			@"serializer" : serializer,
+			@"rows" : [[selectedRows copy] autorelease],
+			@"document" : tableDocument,
+			@"asSQL" : @(copyAsSQL)
+		};
+
+		[NSThread detachNewThreadWithName:SPCtxt(@"SPCopyTable copy task", tableDocument) target:self selector:@selector(_copyRowsTask:) object:copyDetails];
+
+		return;
+	}
+
+	NSString *tmp = [serializer serializeRows:selectedRows];
+
+	if (tmp != nil) {
+		[self _writeCopiedString:tmp asSQL:copyAsSQL];
+	}
+	else if (copyAsSQL) {
+		NSBeep();
 	}
 #endif
 }
@@ -153,125 +200,12 @@ static const NSInteger kBlobAsImageFile = 4;
 	else
 		selectedRows = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, [tableStorage count])];
 
-	NSArray *columns = [self tableColumns];
-	NSUInteger numColumns = [columns count];
-	NSMutableString *result = [NSMutableString stringWithCapacity:2000];
-
-	// Add the table headers if requested to do so
-	if (withHeaders) {
-		NSUInteger i;
-		for( i = 0; i < numColumns; i++ ){
-			if([result length])
-				[result appendString:@"\t"];
-			[result appendString:[[NSArrayObjectAtIndex(columns, i) headerCell] stringValue]];
-		}
-		[result appendString:@"\n"];
-	}
-
-	// Create an array of table column mappings for fast iteration
-	NSUInteger *columnMappings = calloc(numColumns, sizeof(NSUInteger));
-	for (NSUInteger ci = 0; ci < numColumns; ci++ )
-		columnMappings[ci] = (NSUInteger)[[NSArrayObjectAtIndex(columns, ci) identifier] integerValue];
-
-	// Loop through the rows, adding their descriptive contents
-	NSString *nullString = [prefs objectForKey:SPNullValue];
-	Class spmysqlGeometryData = [SPMySQLGeometryData class];
-	__block NSUInteger rowCounter = 0;
-
-	if((withBlobHandling == kBlobAsFile || withBlobHandling == kBlobAsImageFile) && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-		NSFileManager *fm = [NSFileManager defaultManager];
-		[fm removeItemAtPath:tmpBlobFileDirectory error:nil];
-		[fm createDirectoryAtPath:tmpBlobFileDirectory withIntermediateDirectories:YES attributes:nil error:nil];
-	}
+	SPDataStorageSerializer *serializer = [self _serializerWithFormat:SPDataStorageSerializeAsTabText];
+	[serializer setIncludesHeaders:withHeaders];
+	[serializer setBlobHandling:(SPDataStorageBlobHandling)withBlobHandling];
+	[serializer setBlobFileDirectory:tmpBlobFileDirectory];
 
-	BOOL hexBlobs = [prefs boolForKey:SPDisplayBinaryDataAsHex];
-	[selectedRows enumerateIndexesUsingBlock:^(NSUInteger rowIndex, BOOL * _Nonnull stop) {
-		for (NSUInteger c = 0; c < numColumns; c++ ) {
-			id cellData = SPDataStorageObjectAtRowAndColumn(tableStorage, rowIndex, columnMappings[c]);
-
-			// Copy the shown representation of the cell - custom NULL display strings, (not loaded),
-			// definable representation of any blobs or binary texts.
-			if (cellData) {
-				if ([cellData isNSNull])
-					[result appendFormat:@"%@\t", nullString];
-				else if ([cellData isSPNotLoaded])
-					[result appendFormat:@"%@\t", NSLocalizedString(@"(not loaded)", @"value shown for hidden blob and text fields")];
-				else if ([cellData isKindOfClass:[NSData class]]) {
-					if(withBlobHandling == kBlobInclude) {
-						NSString *displayString;
-						if (hexBlobs)
-							displayString = [[NSString alloc] initWithFormat:@"0x%@", [cellData dataToHexString]];
-						else
-							displayString = [[NSString alloc] initWithData:cellData encoding:[mySQLConnection stringEncoding]];
-						if (!displayString) displayString = [[NSString alloc] initWithData:cellData encoding:NSISOLatin1StringEncoding];
-						if (displayString) {
-							[result appendFormat:@"%@\t", displayString];
-							[displayString release];
-						}
-					}
-					else if(withBlobHandling == kBlobAsFile && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-						NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.dat", tmpBlobFileDirectory, (long)rowCounter, (long)c];
-						[cellData writeToFile:fp atomically:NO];
-						[result appendFormat:@"%@\t", fp];
-					}
-					else if(withBlobHandling == kBlobAsImageFile && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-						NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.tif", tmpBlobFileDirectory, (long)rowCounter, (long)c];
-						NSImage *image = [[NSImage alloc] initWithData:cellData];
-						if (image) {
-							NSData *d = [[NSData alloc] initWithData:[image TIFFRepresentationUsingCompression:NSTIFFCompressionLZW factor:1]];
-							[d writeToFile:fp atomically:NO];
-							if(d) SPClear(d);
-							[image release];
-						} else {
-							NSString *noData = @"";
-							[noData writeToFile:fp atomically:NO encoding:NSUTF8StringEncoding error:NULL];
-						}
-						[result appendFormat:@"%@\t", fp];
-					}
-					else {
-						[result appendString:@"BLOB\t"];
-					}
-				}
-				else if ([cellData isKindOfClass:spmysqlGeometryData]) {
-					if((withBlobHandling == kBlobAsFile || withBlobHandling == kBlobAsImageFile) && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-						NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.pdf", tmpBlobFileDirectory, (long)rowCounter, (long)c];
-						SPGeometryDataView *v = [[SPGeometryDataView alloc] initWithCoordinates:[cellData coordinates]];
-						NSData *thePDF = [v pdfData];
-						if(thePDF) {
-							[thePDF writeToFile:fp atomically:NO];
-							[result appendFormat:@"%@\t", fp];
-						} else {
-							[result appendFormat:@"%@\t", [cellData wktString]];
-						}
-						if(v) SPClear(v);
-					} else {
-						[result appendFormat:@"%@\t", [cellData wktString]];
-					}
-				}
-				else
-					[result appendFormat:@"%@\t", [[[cellData description] stringByReplacingOccurrencesOfString:@"\n" withString:@"↵"] stringByReplacingOccurrencesOfString:@"\t" withString:@"⇥"]];
-			} else {
-				[result appendString:@"\t"];
-			}
-		}
-
-		rowCounter++;
-
-		// Remove the trailing tab and add the linebreak
-		if ([result length]){
-			[result deleteCharactersInRange:NSMakeRange([result length]-1, 1)];
-		}
-		[result appendString:@"\n"];
-	}];
-
-	// Remove the trailing line end
-	if ([result length]) {
-		[result deleteCharactersInRange:NSMakeRange([result length]-1, 1)];
-	}
-
-	free(columnMappings);
-
-	return result;
+	return [serializer serializeRows:selectedRows];
 }
 
 /**
@@ -288,126 +222,12 @@ static const NSInteger kBlobAsImageFile = 4;
 	else
 		selectedRows = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, [tableStorage count])];
 
-	NSArray *columns = [self tableColumns];
-	NSUInteger numColumns = [columns count];
-	NSMutableString *result = [NSMutableString stringWithCapacity:2000];
-
-	// Add the table headers if requested to do so
-	if (withHeaders) {
-		NSUInteger i;
-		for( i = 0; i < numColumns; i++ ){
-			if([result length])
-				[result appendString:@","];
-			[result appendFormat:@"\"%@\"", [[[NSArrayObjectAtIndex(columns, i) headerCell] stringValue] stringByReplacingOccurrencesOfString:@"\"" withString:@"\"\""]];
-		}
-		[result appendString:@"\n"];
-	}
-
-	// Create an array of table column mappings for fast iteration
-	NSUInteger *columnMappings = calloc(numColumns, sizeof(NSUInteger));
-	for (NSUInteger ci = 0; ci < numColumns; ci++ )
-		columnMappings[ci] = (NSUInteger)[[NSArrayObjectAtIndex(columns, ci) identifier] integerValue];
-
-	// Loop through the rows, adding their descriptive contents
-	NSString *nullString = [prefs objectForKey:SPNullValue];
-	Class spmysqlGeometryData = [SPMySQLGeometryData class];
+	SPDataStorageSerializer *serializer = [self _serializerWithFormat:SPDataStorageSerializeAsCSV];
+	[serializer setIncludesHeaders:withHeaders];
+	[serializer setBlobHandling:(SPDataStorageBlobHandling)withBlobHandling];
+	[serializer setBlobFileDirectory:tmpBlobFileDirectory];
 
-	__block NSUInteger rowCounter = 0;
-
-	if((withBlobHandling == kBlobAsFile || withBlobHandling == kBlobAsImageFile) && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-		NSFileManager *fm = [NSFileManager defaultManager];
-		[fm removeItemAtPath:tmpBlobFileDirectory error:nil];
-		[fm createDirectoryAtPath:tmpBlobFileDirectory withIntermediateDirectories:YES attributes:nil error:nil];
-	}
-
-	BOOL hexBlobs = [prefs boolForKey:SPDisplayBinaryDataAsHex];
-	[selectedRows enumerateIndexesUsingBlock:^(NSUInteger rowIndex, BOOL * _Nonnull stop) {
-		for (NSUInteger c = 0; c < numColumns; c++ ) {
-			id cellData = SPDataStorageObjectAtRowAndColumn(tableStorage, rowIndex, columnMappings[c]);
-
-			// Copy the shown representation of the cell - custom NULL display strings, (not loaded),
-			// definable representation of any blobs or binary texts.
-			if (cellData) {
-				if ([cellData isNSNull])
-					[result appendFormat:@"\"%@\",", nullString];
-				else if ([cellData isSPNotLoaded])
-					[result appendFormat:@"\"%@\",", NSLocalizedString(@"(not loaded)", @"value shown for hidden blob and text fields")];
-				else if ([cellData isKindOfClass:[NSData class]]) {
-					if(withBlobHandling == kBlobInclude) {
-						NSString *displayString;
-						if (hexBlobs)
-							displayString = [[NSString alloc] initWithFormat:@"0x%@", [cellData dataToHexString]];
-						else
-							displayString = [[NSString alloc] initWithData:cellData encoding:[mySQLConnection stringEncoding]];
-						if (!displayString) displayString = [[NSString alloc] initWithData:cellData encoding:NSISOLatin1StringEncoding];
-						if (displayString) {
-							[result appendFormat:@"\"%@\",", displayString];
-							[displayString release];
-						}
-					}
-					else if(withBlobHandling == kBlobAsFile && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-						NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.dat", tmpBlobFileDirectory, (long)rowCounter, (long)c];
-						[cellData writeToFile:fp atomically:NO];
-						[result appendFormat:@"\"%@\",", fp];
-					}
-					else if(withBlobHandling == kBlobAsImageFile && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-						NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.tif", tmpBlobFileDirectory, (long)rowCounter, (long)c];
-						NSImage *image = [[NSImage alloc] initWithData:cellData];
-						if (image) {
-							NSData *d = [[NSData alloc] initWithData:[image TIFFRepresentationUsingCompression:NSTIFFCompressionLZW factor:1]];
-							[d writeToFile:fp atomically:NO];
-							if(d) SPClear(d);
-							[image release];
-						} else {
-							NSString *noData = @"";
-							[noData writeToFile:fp atomically:NO encoding:NSUTF8StringEncoding error:NULL];
-						}
-						[result appendFormat:@"\"%@\",", fp];
-					}
-					else {
-						[result appendString:@"\"BLOB\","];
-					}
-				}
-				else if ([cellData isKindOfClass:spmysqlGeometryData]) {
-					if((withBlobHandling == kBlobAsFile || withBlobHandling == kBlobAsImageFile) && tmpBlobFileDirectory && [tmpBlobFileDirectory length]) {
-						NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.pdf", tmpBlobFileDirectory, (long)rowCounter, (long)c];
-						SPGeometryDataView *v = [[SPGeometryDataView alloc] initWithCoordinates:[cellData coordinates]];
-						NSData *thePDF = [v pdfData];
-						if(thePDF) {
-							[thePDF writeToFile:fp atomically:NO];
-							[result appendFormat:@"\"%@\",", fp];
-						} else {
-							[result appendFormat:@"\"%@\",", [cellData wktString]];
-						}
-						if(v) SPClear(v);
-					} else {
-						[result appendFormat:@"\"%@\",", [cellData wktString]];
-					}
-				}
-				else
-					[result appendFormat:@"\"%@\",", [cellData description]];
-			} else {
-				[result appendString:@","];
-			}
-		}
-
-		rowCounter++;
-
-		// Remove the trailing tab and add the linebreak
-		if ([result length]){
-			[result deleteCharactersInRange:NSMakeRange([result length]-1, 1)];
-		}
-		[result appendString:@"\n"];
-	}];
-
-	// Remove the trailing line end
-	if ([result length]) {
-		[result deleteCharactersInRange:NSMakeRange([result length]-1, 1)];
-	}
-
-	free(columnMappings);
-
-	return result;
+	return [serializer serializeRows:selectedRows];
 }
 #endif
 
@@ -421,181 +241,10 @@ static const NSInteger kBlobAsImageFile = 4;
 
 	NSIndexSet *selectedRows = (onlySelected) ? [self selectedRowIndexes] : [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, [tableStorage count])];
 
-	NSArray *columns      = [self tableColumns];
-	NSUInteger numColumns = [columns count];
-	NSMutableString *value = [NSMutableString stringWithCapacity:10];
-
-	id cellData = nil;
-
-	NSUInteger rowCounter = 0;
-	NSUInteger penultimateRowIndex = [selectedRows count];
-	NSUInteger c;
+	NSString *result = [[self _serializerWithFormat:SPDataStorageSerializeAsSQLInserts] serializeRows:selectedRows];
 
-	NSMutableString *result = [NSMutableString stringWithCapacity:2000];
-
-	// Create an array of table column names
-	NSMutableArray *tbHeader = [NSMutableArray arrayWithCapacity:numColumns];
-	
-	for (id enumObj in columns) 
-	{
-		[tbHeader addObject:[[enumObj headerCell] stringValue]];
-	}
-
-	// Create arrays of table column mappings and types for fast iteration
-	NSUInteger *columnMappings = calloc(numColumns, sizeof(NSUInteger));
-	NSUInteger *columnTypes = calloc(numColumns, sizeof(NSUInteger));
-	
-	for (c = 0; c < numColumns; c++) 
-	{
-		columnMappings[c] = (NSUInteger)[[NSArrayObjectAtIndex(columns, c) identifier] integerValue];
-
-		NSString *t = [NSArrayObjectAtIndex(columnDefinitions, columnMappings[c]) objectForKey:@"typegrouping"];
-
-		// Numeric data
-		if ([t isEqualToString:@"bit"] || [t isEqualToString:@"integer"] || [t isEqualToString:@"float"])
-			columnTypes[c] = 0;
-
-		// Blob data or long text data
-		else if ([t isEqualToString:@"blobdata"] || [t isEqualToString:@"textdata"])
-			columnTypes[c] = 2;
-
-		// GEOMETRY data
-		else if ([t isEqualToString:@"geometry"])
-			columnTypes[c] = 3;
-
-		// Default to strings
-		else
-			columnTypes[c] = 1;
-	}
-
-	// Begin the SQL string
-	[result appendFormat:@"INSERT INTO %@ (%@)\nVALUES\n",
-		[(selectedTable == nil) ? @"<table>" : selectedTable backtickQuotedString], [tbHeader componentsJoinedAndBacktickQuoted]];
-
-	NSUInteger rowIndex = [selectedRows firstIndex];
-	Class spTableContentClass = [SPTableContent class];
-	Class nsDataClass = [NSData class];
-	
-	while (rowIndex != NSNotFound)
-	{
-		[value appendString:@"\t("];
-		cellData = nil;
-		rowCounter++;
-		NSMutableArray *rowValues = [[NSMutableArray alloc] initWithCapacity:numColumns];
-		
-		for (c = 0; c < numColumns; c++)
-		{
-			cellData = SPDataStorageObjectAtRowAndColumn(tableStorage, rowIndex, columnMappings[c]);
-
-			// If the data is not loaded, attempt to fetch the value
-			if ([cellData isSPNotLoaded] && [[self delegate] isKindOfClass:spTableContentClass]) {
-
-				NSString *whereArgument = [tableInstance argumentForRow:rowIndex];
-				// Abort if no table name given, not table content, or if there are no indices on this table
-				if (!selectedTable || ![[self delegate] isKindOfClass:spTableContentClass] || ![whereArgument length]) {
-					NSBeep();
-					free(columnMappings);
-					free(columnTypes);
-					return nil;
-				}
-
-				// Use the argumentForRow to retrieve the missing information
-				// TODO - this could be preloaded for all selected rows rather than cell-by-cell
-				cellData = [mySQLConnection getFirstFieldFromQuery:
-							[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@",
-								[NSArrayObjectAtIndex(tbHeader, columnMappings[c]) backtickQuotedString],
-								[selectedTable backtickQuotedString],
-								whereArgument]];
-			}
-
-			// Check for NULL value
-			if ([cellData isNSNull]) {
-				[rowValues addObject:@"NULL"];
-				continue;
-
-			} 
-			else if (cellData) {
-
-				// Check column type and insert the data accordingly
-				switch (columnTypes[c]) {
-
-					// Convert numeric types to unquoted strings
-					case 0:
-						[rowValues addObject:[cellData description]];
-						break;
-
-					// Quote string, text and blob types appropriately
-					case 1:
-					case 2:
-						if ([cellData isKindOfClass:nsDataClass]) {
-							[rowValues addObject:[mySQLConnection escapeAndQuoteData:cellData]];
-						} else {
-							[rowValues addObject:[mySQLConnection escapeAndQuoteString:[cellData description]]];
-						}
-						break;
-
-					// GEOMETRY
-					case 3:
-						[rowValues addObject:[mySQLConnection escapeAndQuoteData:[cellData data]]];
-						break;
-					// Unhandled cases - abort
-					default:
-						NSBeep();
-						free(columnMappings);
-						free(columnTypes);
-						[rowValues release];
-						return nil;
-				}
-
-			// If nil is encountered, abort
-			} 
-			else {
-				NSBeep();
-				free(columnMappings);
-				free(columnTypes);
-				[rowValues release];
-				return nil;
-			}
-		}
-
-		// Add to the string in comma-separated form, and increment the string length
-		[value appendString:[rowValues componentsJoinedByString:@", "]];
-		[rowValues release];
-
-		// Close this VALUES group and set up the next one if appropriate
-		if (rowCounter != penultimateRowIndex) {
-
-			// Add a new INSERT starter command every ~250k of data.
-			if ([value length] > 250000) {
-				[result appendFormat:@"%@);\n\nINSERT INTO %@ (%@)\nVALUES\n",
-						value,
-						[(selectedTable == nil) ? @"<table>" : selectedTable backtickQuotedString],
-						[tbHeader componentsJoinedAndBacktickQuoted]];
-				[value setString:@""];
-			} 
-			else {
-				[value appendString:@"),\n"];
-			}
-
-		} 
-		else {
-			[value appendString:@"),\n"];
-			[result appendString:value];
-		}
-
-		// Get the next selected row index
-		rowIndex = [selectedRows indexGreaterThanIndex:rowIndex];
-	}
-
-	// Remove the trailing ",\n" from the query string
-	if ([result length] > 3) {
-		[result deleteCharactersInRange:NSMakeRange([result length]-2, 2)];
-	}
-
-	[result appendString:@";\n"];
-
-	free(columnMappings);
-	free(columnTypes);
+	// Abort if any unloaded values couldn't be retrieved
+	if (!result) NSBeep();
 
 	return result;
 }
@@ -614,71 +263,7 @@ static const NSInteger kBlobAsImageFile = 4;
  */
 - (NSString *) draggedRowsAsTabString
 {
-	NSArray *columns = [self tableColumns];
-	NSUInteger numColumns = [columns count];
-	NSIndexSet *selectedRows = [self selectedRowIndexes];
-
-	NSMutableString *result = [NSMutableString stringWithCapacity:2000];
-
-	// Create an array of table column mappings for fast iteration
-	NSUInteger *columnMappings = calloc(numColumns, sizeof(NSUInteger));
-	for (NSUInteger ci = 0; ci < numColumns; ci++ )
-		columnMappings[ci] = (NSUInteger)[[NSArrayObjectAtIndex(columns, ci) identifier] integerValue];
-
-	// Loop through the rows, adding their descriptive contents
-	NSString *nullString = [prefs objectForKey:SPNullValue];
-	Class nsDataClass = [NSData class];
-	Class spmysqlGeometryData = [SPMySQLGeometryData class];
-	NSStringEncoding connectionEncoding = [mySQLConnection stringEncoding];
-	BOOL hexBlobs = [prefs boolForKey:SPDisplayBinaryDataAsHex];
-	[selectedRows enumerateIndexesUsingBlock:^(NSUInteger rowIndex, BOOL * _Nonnull stop) {
-		for (NSUInteger c = 0; c < numColumns; c++ ) {
-			id cellData = SPDataStorageObjectAtRowAndColumn(tableStorage, rowIndex, columnMappings[c]);
-
-			// Copy the shown representation of the cell - custom NULL display strings, (not loaded),
-			// and the string representation of any blobs or binary texts.
-			if (cellData) {
-				if ([cellData isNSNull])
-					[result appendFormat:@"%@\t", nullString];
-				else if ([cellData isSPNotLoaded])
-					[result appendFormat:@"%@\t", NSLocalizedString(@"(not loaded)", @"value shown for hidden blob and text fields")];
-				else if ([cellData isKindOfClass:nsDataClass]) {
-					NSString *displayString;
-					if (hexBlobs)
-						displayString = [[NSString alloc] initWithFormat:@"0x%@", [cellData dataToHexString]];
-					else
-						displayString = [[NSString alloc] initWithData:cellData encoding:connectionEncoding];
-					if (!displayString) displayString = [[NSString alloc] initWithData:cellData encoding:NSISOLatin1StringEncoding];
-					if (displayString) {
-						[result appendString:displayString];
-						[result appendString:@"\t"];
-						[displayString release];
-					}
-				}
-				else if ([cellData isKindOfClass:spmysqlGeometryData]) {
-					[result appendFormat:@"%@\t", [cellData wktString]];
-				} else
-					[result appendFormat:@"%@\t", [cellData description]];
-			} else {
-				[result appendString:@"\t"];
-			}
-		}
-
-		if ([result length]) {
-			[result deleteCharactersInRange:NSMakeRange([result length]-1, 1)];
-		}
-
-		[result appendString:@"\n"];
-	}];
-
-	// Trim the trailing line ending
-	if ([result length]) {
-		[result deleteCharactersInRange:NSMakeRange([result length]-1, 1)];
-	}
-
-	free(columnMappings);
-
-	return result;
+	return [[self _serializerWithFormat:SPDataStorageSerializeAsDraggedTabText] serializeRows:[self selectedRowIndexes]];
 }
 
 #pragma mark -
@@ -712,22 +297,46 @@ static const NSInteger kBlobAsImageFile = 4;
  */
 - (NSDictionary *) autodetectColumnWidths
 {
-	NSMutableDictionary *columnWidths = [NSMutableDictionary dictionaryWithCapacity:[columnDefinitions count]];
+	NSUInteger columnCount = [columnDefinitions count];
+	NSMutableDictionary *columnWidths = [NSMutableDictionary dictionaryWithCapacity:columnCount];
 	NSUInteger columnWidth;
 	NSUInteger allColumnWidths = 0;
 
 	// Determine the available size
 	NSScrollView *parentScrollView = (NSScrollView*)[[self superview] superview];
- 	CGFloat visibleTableWidth = [parentScrollView bounds].size.width - [NSScroller scrollerWidth] - [columnDefinitions count] * 3.5f;
+ 	CGFloat visibleTableWidth = [parentScrollView bounds].size.width - [NSScroller scrollerWidth] - columnCount * 3.5f;
+
+	// Measure the columns in parallel, sharing the font lookup tables.  Cancellation
+	// is checked against the calling thread, as the work runs on dispatch threads.
+	SPTextWidthMeasurer *measurer = [self _columnWidthMeasurer];
+	NSThread *callingThread = [NSThread currentThread];
+	NSUInteger *detectedWidths = calloc(columnCount, sizeof(NSUInteger));
+	__block volatile BOOL cancelled = NO;
+
+	dispatch_apply(columnCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+		if (cancelled || [callingThread isCancelled]) {
+			cancelled = YES;
+			return;
+		}
 
-	for (NSDictionary *columnDefinition in columnDefinitions) {
-		if ([[NSThread currentThread] isCancelled]) return nil;
+		@autoreleasepool {
+			detectedWidths[i] = [self _autodetectWidthForColumnDefinition:[columnDefinitions objectAtIndex:i] maxRows:100 usingMeasurer:measurer];
+		}
+	});
 
-		columnWidth = [self autodetectWidthForColumnDefinition:columnDefinition maxRows:100];
-		[columnWidths setObject:[NSString stringWithFormat:@"%llu", (unsigned long long)columnWidth] forKey:[columnDefinition objectForKey:@"datacolumnindex"]];
+	if (cancelled) {
+		free(detectedWidths);
+		return nil;
+	}
+
+	for (NSUInteger i = 0; i < columnCount; i++) {
+		columnWidth = detectedWidths[i];
+		[columnWidths setObject:[NSString stringWithFormat:@"%llu", (unsigned long long)columnWidth] forKey:[[columnDefinitions objectAtIndex:i] objectForKey:@"datacolumnindex"]];
 		allColumnWidths += columnWidth;
 	}
 
+	free(detectedWidths);
+
 	// Compare the column widths to the table width.  If wider, narrow down wide columns as necessary
 	if (allColumnWidths > visibleTableWidth) {
 		NSUInteger availableWidthToReduce = 0;
@@ -764,20 +373,49 @@ static const NSInteger kBlobAsImageFile = 4;
  */
 - (NSUInteger)autodetectWidthForColumnDefinition:(NSDictionary *)columnDefinition maxRows:(NSUInteger)rowsToCheck
 {
-	CGFloat columnBaseWidth;
-	NSUInteger cellWidth, maxCellWidth, i;
-	NSRange linebreakRange;
-	double rowStep;
-	unichar breakChar;
+	return [self _autodetectWidthForColumnDefinition:columnDefinition maxRows:rowsToCheck usingMeasurer:[self _columnWidthMeasurer]];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns the shared width measurer for the current table font.
+ */
+- (SPTextWidthMeasurer *)_columnWidthMeasurer
+{
 #ifndef SP_CODA /* patch */
 	NSFont *tableFont = [NSUnarchiver unarchiveObjectWithData:[prefs dataForKey:SPGlobalResultTableFont]];
 #else
 	NSFont *tableFont = [NSFont systemFontOfSize:[NSFont smallSystemFontSize]];
 #endif
+
+	return [SPTextWidthMeasurer measurerForFont:tableFont];
+}
+
+/**
+ * Autodetect the column width for a specified column using the supplied measurer.
+ * Numeric and date values are measured from the raw data lengths alone, and text
+ * cells are only converted to strings if their raw length shows they could be
+ * wider than the widest cell found so far.
+ */
+- (NSUInteger)_autodetectWidthForColumnDefinition:(NSDictionary *)columnDefinition maxRows:(NSUInteger)rowsToCheck usingMeasurer:(SPTextWidthMeasurer *)measurer
+{
+	CGFloat columnBaseWidth;
+	NSUInteger cellWidth, maxCellWidth, rawLength, i;
+	double rowStep;
 	NSUInteger columnIndex = (NSUInteger)[[columnDefinition objectForKey:@"datacolumnindex"] integerValue];
-	NSDictionary *stringAttributes = @{NSFontAttributeName : tableFont};
+	NSString *typeGrouping = [columnDefinition objectForKey:@"typegrouping"];
 	Class spmysqlGeometryData = [SPMySQLGeometryData class];
 	BOOL hexBlobs = [prefs boolForKey:SPDisplayBinaryDataAsHex];
+	NSString *nullValue = [prefs objectForKey:SPNullValue];
+	NSStringEncoding connectionEncoding = [mySQLConnection stringEncoding];
+
+	// Numeric and date values are always plain ASCII text of a restricted set of characters,
+	// while the raw length of other text values provides an upper bound for their width in
+	// Latin-1 compatible and multibyte encodings
+	BOOL measureFromRawLength = [typeGrouping isEqualToString:@"integer"] || [typeGrouping isEqualToString:@"float"] || [typeGrouping isEqualToString:@"date"];
+	BOOL boundFromRawLength = ([typeGrouping isEqualToString:@"string"] || [typeGrouping isEqualToString:@"textdata"] || [typeGrouping isEqualToString:@"enum"]) && [SPTextWidthMeasurer byteLengthBoundsWidthForEncoding:connectionEncoding];
 
 	// Check the number of rows available to check, sampling every n rows
 	if ([tableStorage count] < rowsToCheck)
@@ -794,6 +432,25 @@ static const NSInteger kBlobAsImageFile = 4;
 	maxCellWidth = 0;
 	for (i = 0; i < rowsToCheck; i += rowStep) {
 
+		if (measureFromRawLength || boundFromRawLength) {
+			rawLength = [tableStorage rawDataLengthAtRow:i column:columnIndex];
+
+			if (rawLength != NSNotFound) {
+				if (measureFromRawLength) {
+					cellWidth = [measurer widthOfNumericStringWithLength:rawLength];
+					if (cellWidth > maxCellWidth) maxCellWidth = cellWidth;
+					if (maxCellWidth > SP_MAX_CELL_WIDTH) {
+						maxCellWidth = SP_MAX_CELL_WIDTH;
+						break;
+					}
+					continue;
+				}
+
+				// Skip text which can't be wider than the current widest value
+				if ([measurer maximumWidthOfStringWithByteLength:rawLength] <= maxCellWidth) continue;
+			}
+		}
+
 		// Retrieve part of the cell's content to get widths, topping out at a maximum length
 		id contentString = SPDataStoragePreviewAtRowAndColumn(tableStorage, i, columnIndex, 500);
 
@@ -807,7 +464,7 @@ static const NSInteger kBlobAsImageFile = 4;
 
 		// Replace NULLs with their placeholder string
 		else if ([contentString isNSNull]) {
-			contentString = [prefs objectForKey:SPNullValue];
+			contentString = nullValue;
 
 		// Same for cells for which loading has been deferred - likely blobs
 		} else if ([contentString isSPNotLoaded]) {
@@ -818,38 +475,17 @@ static const NSInteger kBlobAsImageFile = 4;
 			// Otherwise, ensure the cell is represented as a short string
 			if ([contentString isKindOfClass:[NSData class]]) {
 				if (hexBlobs)
-					contentString = [[NSString alloc] initWithFormat:@"0x%@", [(NSData *)contentString dataToHexString]];
+					contentString = [NSString stringWithFormat:@"0x%@", [(NSData *)contentString dataToHexString]];
 				else
-					contentString = [contentString shortStringRepresentationUsingEncoding:[mySQLConnection stringEncoding]];
+					contentString = [contentString shortStringRepresentationUsingEncoding:connectionEncoding];
 			} else if ([(NSString *)contentString length] > 500) {
 				contentString = [contentString substringToIndex:500];
 			}
-
-			// If any linebreaks are present, they are displayed as single characters; replace them with pilcrow/
-			// reverse pilcrow to match display output width.
-			linebreakRange = [contentString rangeOfCharacterFromSet:[NSCharacterSet newlineCharacterSet] options:NSLiteralSearch];
-			if (linebreakRange.location != NSNotFound) {
-				NSMutableString *singleLineString = [[[NSMutableString alloc] initWithString:contentString] autorelease];
-				while (linebreakRange.location != NSNotFound) {
-					breakChar = [singleLineString characterAtIndex:linebreakRange.location];
-					switch (breakChar) {
-						case '\n':
-							[singleLineString replaceCharactersInRange:linebreakRange withString:@"¶"];
-							break;
-						default:
-							[singleLineString replaceCharactersInRange:linebreakRange withString:@"⁋"];
-							if (breakChar == '\r' && NSMaxRange(linebreakRange) < [singleLineString length] && [singleLineString characterAtIndex:linebreakRange.location+1] == '\n') {
-								[singleLineString deleteCharactersInRange:NSMakeRange(linebreakRange.location+1, 1)];
-							}
-					}
-					linebreakRange = [singleLineString rangeOfCharacterFromSet:[NSCharacterSet newlineCharacterSet] options:NSLiteralSearch];
-				}
-				contentString = singleLineString;
-			}
 		}
 
-		// Calculate the width, using it if it's higher than the current stored width
-		cellWidth = [contentString sizeWithAttributes:stringAttributes].width;
+		// Calculate the width, using it if it's higher than the current stored width.  Linebreaks
+		// are measured as the pilcrow/reverse pilcrow characters they are displayed as.
+		cellWidth = [measurer widthOfString:contentString];
 		if (cellWidth > maxCellWidth) maxCellWidth = cellWidth;
 		if (maxCellWidth > SP_MAX_CELL_WIDTH) {
 			maxCellWidth = SP_MAX_CELL_WIDTH;
@@ -860,7 +496,7 @@ static const NSInteger kBlobAsImageFile = 4;
 	// If the column has a foreign key link, expand the width; and also for enums
 	if ([columnDefinition objectForKey:@"foreignkeyreference"]) {
 		maxCellWidth += 18;
-	} else if ([[columnDefinition objectForKey:@"typegrouping"] isEqualToString:@"enum"]) {
+	} else if ([typeGrouping isEqualToString:@"enum"]) {
 		maxCellWidth += 8;
 	}
 
@@ -868,11 +504,117 @@ static const NSInteger kBlobAsImageFile = 4;
 	maxCellWidth += columnBaseWidth;
 
 	// If the header width is wider than this expanded width, use it instead
-	cellWidth = [[columnDefinition objectForKey:@"name"] sizeWithAttributes:@{NSFontAttributeName : [NSFont labelFontOfSize:[NSFont smallSystemFontSize]]}].width;
+	cellWidth = [[SPTextWidthMeasurer measurerForFont:[NSFont labelFontOfSize:[NSFont smallSystemFontSize]]] widthOfString:[columnDefinition objectForKey:@"name"]];
 	if (cellWidth + 10 > maxCellWidth) maxCellWidth = cellWidth + 10;
 
 	return maxCellWidth;
 }
+/**
+ * Set up a serializer for the current table columns, in their displayed order.
+ */
+- (SPDataStorageSerializer *)_serializerWithFormat:(SPDataStorageSerializationFormat)format
+{
+	NSArray *columns = [self tableColumns];
+	NSMutableArray *storageColumns = [NSMutableArray arrayWithCapacity:[columns count]];
+	NSMutableArray *columnNames = [NSMutableArray arrayWithCapacity:[columns count]];
+	NSMutableArray *typeGroupings = [NSMutableArray arrayWithCapacity:[columns count]];
+
+	for (NSTableColumn *column in columns) {
+		NSUInteger storageColumn = (NSUInteger)[[column identifier] integerValue];
+		NSString *typeGrouping = nil;
+
+		if (storageColumn < [columnDefinitions count]) {
+			typeGrouping = [NSArrayObjectAtIndex(columnDefinitions, storageColumn) objectForKey:@"typegrouping"];
+		}
+
+		[storageColumns addObject:@(storageColumn)];
+		[columnNames addObject:[[column headerCell] stringValue]];
+		[typeGroupings addObject:(typeGrouping ? typeGrouping : @"")];
+	}
+
+	SPDataStorageSerializer *serializer = [[[SPDataStorageSerializer alloc] initWithDataStorage:tableStorage format:format] autorelease];
+
+	[serializer setColumns:storageColumns names:columnNames typeGroupings:typeGroupings];
+	[serializer setConnection:mySQLConnection];
+	[serializer setTableName:selectedTable];
+	[serializer setNullString:[prefs objectForKey:SPNullValue]];
+	[serializer setDisplaysBinaryDataAsHex:[prefs boolForKey:SPDisplayBinaryDataAsHex]];
+
+	// Unloaded values are fetched for SQL output, and values which are only partially loaded
+	// for all output, using the table content view to identify the rows.
+	if ([[self delegate] isKindOfClass:[SPTableContent class]]) {
+		SPTableContent *contentInstance = tableInstance;
+		SPDataStorage *dataStorage = tableStorage;
+		SPMySQLConnection *connection = mySQLConnection;
+		NSArray *definitions = columnDefinitions;
+		NSString *table = selectedTable;
+
+		[serializer setUnloadedValueLoader:^id(NSUInteger rowIndex, NSUInteger columnIndex) {
+			if (format != SPDataStorageSerializeAsSQLInserts && ![dataStorage cellIsTruncatedPreviewAtRow:rowIndex column:columnIndex]) return nil;
+
+			NSString *whereArgument = [contentInstance argumentForRow:rowIndex];
+
+			// Abort if no table name given, or if there are no indices on this table
+			if (!table || ![whereArgument length]) return nil;
+
+			return [connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@",
+				[[NSArrayObjectAtIndex(definitions, columnIndex) objectForKey:@"name"] backtickQuotedString],
+				[table backtickQuotedString],
+				whereArgument]];
+		}];
+	}
+
+	return serializer;
+}
+
+/**
+ * Serialize a large copy on a background thread, placing the result on the pasteboard
+ * once complete unless cancelled.
+ */
+- (void)_copyRowsTask:(NSDictionary *)copyDetails
+{
+	@autoreleasepool {
+		SPDataStorageSerializer *serializer = [copyDetails objectForKey:@"serializer"];
+		SPDatabaseDocument *tableDocument = [copyDetails objectForKey:@"document"];
+		BOOL copyAsSQL = [[copyDetails objectForKey:@"asSQL"] boolValue];
+
+		NSString *copiedString = [serializer serializeRows:[copyDetails objectForKey:@"rows"]];
+
+		SPMainQSync(^{
+			[tableDocument disableTaskCancellation];
+
+			if (copiedString) {
+				[self _writeCopiedString:copiedString asSQL:copyAsSQL];
+			}
+			else if (![serializer isCancelled]) {
+				NSBeep();
+			}
+
+			[tableDocument endTask];
+		});
+	}
+}
+
+/**
+ * Place copied rows on the general pasteboard.
+ */
+- (void)_writeCopiedString:(NSString *)copiedString asSQL:(BOOL)isSQL
+{
+	NSPasteboard *pb = [NSPasteboard generalPasteboard];
+
+	if (isSQL) {
+		[pb declareTypes:@[NSStringPboardType] owner:nil];
+
+		[pb setString:copiedString forType:NSStringPboardType];
+	}
+	else {
+		[pb declareTypes:@[NSTabularTextPboardType, NSStringPboardType] owner:nil];
+
+		[pb setString:copiedString forType:NSStringPboardType];
+		[pb setString:copiedString forType:NSTabularTextPboardType];
+	}
+}
+
 
 #pragma mark -
 
@@ -885,6 +627,12 @@ static const NSInteger kBlobAsImageFile = 4;
 
 	[SPAppDelegate reloadBundles:self];
 
+	// Remove deferred row edit items and their separator
+	NSMenuItem *editsItem;
+	while ((editsItem = [menu itemWithTag:SPCopyTableDeferredEditsMenuItemTag])) {
+		[menu removeItem:editsItem];
+	}
+
 	// Remove 'Bundles' sub menu and separator
 	NSMenuItem *bItem = [menu itemWithTag:10000000];
 	if(bItem) {
@@ -946,6 +694,25 @@ static const NSInteger kBlobAsImageFile = 4;
 
 		[bundleSubMenuItem release];
 	}
+
+	// Add the deferred row edit items for table content
+	if ([[self delegate] isKindOfClass:[SPTableContent class]]) {
+		NSMenuItem *separatorItem = [NSMenuItem separatorItem];
+		[separatorItem setTag:SPCopyTableDeferredEditsMenuItemTag];
+		[menu addItem:separatorItem];
+
+		NSArray *editsItems = @[
+			[[[NSMenuItem alloc] initWithTitle:NSLocalizedString(@"Defer Saving Edited Rows", @"defer saving edited rows menu item") action:@selector(toggleDeferredRowEdits:) keyEquivalent:@""] autorelease],
+			[[[NSMenuItem alloc] initWithTitle:NSLocalizedString(@"Save Edited Rows", @"save queued row edits menu item") action:@selector(commitPendingRowEdits:) keyEquivalent:@""] autorelease],
+			[[[NSMenuItem alloc] initWithTitle:NSLocalizedString(@"Discard Edited Rows", @"discard queued row edits menu item") action:@selector(discardPendingRowEdits:) keyEquivalent:@""] autorelease]
+		];
+
+		for (NSMenuItem *item in editsItems) {
+			[item setTarget:tableInstance];
+			[item setTag:SPCopyTableDeferredEditsMenuItemTag];
+			[menu addItem:item];
+		}
+	}
 #endif
 	return menu;
 
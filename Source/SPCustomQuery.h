@@ -41,6 +41,7 @@
 @class SPCopyTable;
 @class SPQueryFavoriteManager;
 @class SPDataStorage;
+@class SPExportDataStorageRowSource;
 @class SPSplitView;
 @class SPFieldEditorController;
 @class SPMySQLConnection;
@@ -217,6 +218,7 @@
 - (NSArray *)currentResult;
 - (NSArray *)currentDataResultWithNULLs:(BOOL)includeNULLs truncateDataFields:(BOOL)truncate;
 - (NSUInteger)currentResultRowCount;
+- (SPExportDataStorageRowSource *)currentResultRowSource;
 - (void)updateResultStore:(SPMySQLStreamingResultStore *)theResultStore;
 
 // Retrieving and setting table state
@@ -48,6 +48,7 @@
 #import "SPQueryController.h"
 #import "SPEncodingPopupAccessory.h"
 #import "SPDataStorage.h"
+#import "SPExportRowSource.h"
 #import "SPAlertSheets.h"
 #import "SPCopyTable.h"
 #import "SPGeometryDataView.h"
@@ -960,6 +961,9 @@ typedef void (^QueryProgressHandler)(QueryProgress *);
 		if ( ![resultData count] ) {
 			[customQueryView performSelectorOnMainThread:@selector(reloadData) withObject:nil waitUntilDone:YES];
 
+			// Rows were modified, so the content view and any cached row counts are out of date
+			if (totalAffectedRows) [tableDocumentInstance setContentRequiresReload:YES];
+
 			// Notify any listeners that the query has completed
 			[[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:@"SMySQLQueryHasBeenPerformed" object:tableDocumentInstance];
 
@@ -1594,6 +1598,24 @@ typedef void (^QueryProgressHandler)(QueryProgress *);
 	return [resultData count];
 }
 
+/**
+ * Returns a row source supplying the current result (as shown in custom result view) directly from
+ * the loaded result data, so it can be exported without copying it into an array first.
+ */
+- (SPExportDataStorageRowSource *)currentResultRowSource
+{
+	NSMutableArray *columnIndexes = [NSMutableArray array];
+	NSMutableArray *columnNames = [NSMutableArray array];
+
+	for (NSTableColumn *tableColumn in [customQueryView tableColumns])
+	{
+		[columnIndexes addObject:[NSNumber numberWithInteger:[[tableColumn identifier] integerValue]]];
+		[columnNames addObject:[[tableColumn headerCell] stringValue]];
+	}
+
+	return [[[SPExportDataStorageRowSource alloc] initWithDataStorage:resultData columns:columnIndexes names:columnNames stringEncoding:[mySQLConnection stringEncoding]] autorelease];
+}
+
 /**
  * Returns the current result (as shown in custom result view) as an array, the first object containing 
  * the field names as an array and the following objects containing the rows as arrays.
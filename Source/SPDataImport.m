@@ -37,7 +37,10 @@
 #import "SPCustomQuery.h"
 #import "SPGrowlController.h"
 #import "SPSQLParser.h"
+#import "SPSQLImportPipeline.h"
+#import "SPSQLImportTableDispatcher.h"
 #import "SPCSVParser.h"
+#import "SPCSVImportLocalDataLoader.h"
 #import "SPTableData.h"
 #import "RegexKitLite.h"
 #import "SPAlertSheets.h"
@@ -51,12 +54,21 @@
 
 #define SP_FILE_READ_ERROR_STRING NSLocalizedString(@"File read error", @"File read error title (Import Dialog)")
 
+// How often the utilisation of the SQL import stages is updated, in seconds
+static const NSTimeInterval SPSQLImportUtilisationUpdateInterval = 1.0;
+
+// The length of CSV data buffered for each LOAD DATA LOCAL INFILE statement, in bytes
+static const NSUInteger SPCSVImportLocalDataBatchLength = 4 * 1024 * 1024;
+
 @interface SPDataImport ()
 
 - (void)_startBackgroundImportTaskForFilename:(NSString *)filename;
 - (void)_importBackgroundProcess:(NSDictionary *)userInfo;
 - (void)_resetFieldMappingGlobals;
 - (void)_closeAndStopProgressSheet;
+- (void)_reportSQLImportError:(NSString *)errorMessage inQuery:(NSInteger)queryNumber errors:(NSMutableString *)errors ignoringFurtherErrors:(BOOL *)ignoreSQLErrors;
+- (SPCSVImportLocalDataLoader *)_localDataLoaderForCSVImport;
+- (void)_showCSVEncodingErrorForEncoding:(NSStringEncoding)csvEncoding rowsImported:(NSInteger)rowsImported;
 - (NSString *)_getLineEndingForFile:(NSString *)filePath;
 
 @end
@@ -333,38 +345,28 @@
 /**
  * Streaming data processing method to import a supplied SQL file.
  *
- * The file is read in chunk by chunk; each chunk is then checked
- * for line endings, which are used to split the data into parts
- * which can be parsed to NSStrings in the appropriate encoding.
- *
- * The NSStrings are then fed to a SQL parser, which splits them
- * into statements ready to be executed.
+ * The file is read, decompressed and split into statements by a
+ * SPSQLImportPipeline in the background, while the statements
+ * already split are executed on this thread.
  */
 - (void)importSQLFile:(NSString *)filename
 {
 	NSAutoreleasePool *importPool;
 	SPFileHandle *sqlFileHandle;
-	NSMutableData *sqlDataBuffer;
-	const unsigned char *sqlDataBufferBytes;
-	NSData *fileChunk;
-	NSString *sqlString;
-	SPSQLParser *sqlParser;
+	SPSQLImportPipeline *importPipeline;
+	SPSQLImportTableDispatcher *tableDispatcher = nil;
 	NSString *query;
 	NSMutableString *errors = [NSMutableString string];
-	NSInteger fileChunkMaxLength = 1024 * 1024;
 	NSUInteger fileTotalLength = 0;
 	NSUInteger fileProcessedLength = 0;
+	NSUInteger queryByteLength = 0;
 	NSInteger queriesPerformed = 0;
-	NSInteger dataBufferLength = 0;
-	NSInteger dataBufferPosition = 0;
-	NSInteger dataBufferLastQueryEndPosition = 0;
+	NSTimeInterval lastUtilisationUpdateTime = 0;
 	BOOL fileIsCompressed;
-	BOOL allDataRead = NO;
 	BOOL ignoreSQLErrors = ([importSQLErrorHandlingPopup selectedTag] == SPSQLImportIgnoreErrors);
 	BOOL ignoreCharsetError = NO;
 	NSStringEncoding sqlEncoding = NSUTF8StringEncoding;
 	NSString *connectionEncodingToRestore = nil;
-	NSCharacterSet *whitespaceAndNewlineCharset = [NSCharacterSet whitespaceAndNewlineCharacterSet];
 
 	// Start the notification timer to allow notifications to be shown, even if frontmost, for long queries
 	[[SPGrowlController sharedGrowlController] setVisibilityForNotificationName:@"Import Finished"];
@@ -436,160 +438,59 @@
 	// initialize
 	serverStatus.noBackslashEscapes = 0; // for the moment we only care about that flag
 
-	// Read in the file in a loop
-	sqlParser = [[SPSQLParser alloc] init];
-	[sqlParser setDelimiterSupport:YES];
 	[mySQLConnection updateServerStatusBits:&serverStatus];
-	[sqlParser setNoBackslashEscapes:serverStatus.noBackslashEscapes];
-	sqlDataBuffer = [[NSMutableData alloc] init];
-	importPool = [[NSAutoreleasePool alloc] init];
-	while (1) {
-		if (progressCancelled) break;
-
-		@try {
-			fileChunk = [sqlFileHandle readDataOfLength:fileChunkMaxLength];
-		}
-		// Report file read errors, and bail
-		@catch (NSException *exception) {
-			if (connectionEncodingToRestore) {
-				[mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
-			}
-			if (sqlModeToRestore) {
-				[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
-			}
-
-			[self _closeAndStopProgressSheet];
-
-			SPOnewayAlertSheet(
-				SP_FILE_READ_ERROR_STRING,
-				[tableDocumentInstance parentWindow],
-				[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file.\n\nOnly %ld queries were executed.\n\n(%@)", @"SQL read error, including detail from system"), (long)queriesPerformed, [exception reason]]
-			);
-			[sqlParser release];
-			[sqlDataBuffer release];
-			[importPool drain];
-			[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
-			if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
-			return;
-		}
-
-		// If no data returned, end of file - set a marker to ensure full processing
-		if (!fileChunk || ![fileChunk length]) {
-			allDataRead = YES;
-
-		// Otherwise add the data to the read/parse buffer
-		} else {
-			[sqlDataBuffer appendData:fileChunk];
-		}
-
-		// Step through the data buffer, identifying line endings to parse the data with
-		sqlDataBufferBytes = [sqlDataBuffer bytes];
-		dataBufferLength = [sqlDataBuffer length];
-		for ( ; dataBufferPosition < dataBufferLength || allDataRead; dataBufferPosition++) {
-			if (sqlDataBufferBytes[dataBufferPosition] == 0x0A || sqlDataBufferBytes[dataBufferPosition] == 0x0D || allDataRead) {
-
-				// Keep reading through any other line endings
-				while (dataBufferPosition + 1 < dataBufferLength
-						&& (sqlDataBufferBytes[dataBufferPosition+1] == 0x0A
-							|| sqlDataBufferBytes[dataBufferPosition+1] == 0x0D))
-				{
-					dataBufferPosition++;
-				}
-
-				// Try to generate a NSString with the resulting data
-				sqlString = [[NSString alloc] initWithData:[sqlDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferPosition - dataBufferLastQueryEndPosition)]
-				                                  encoding:sqlEncoding];
-				if (!sqlString) {
-					if (connectionEncodingToRestore) {
-						[mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
-					}
-					if (sqlModeToRestore) {
-						[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
-					}
-
-					[self _closeAndStopProgressSheet];
-
-					NSString *displayEncoding;
-
-					if (![importEncodingPopup indexOfSelectedItem]) {
-						displayEncoding = [NSString stringWithFormat:@"%@ - %@", [importEncodingPopup titleOfSelectedItem], [NSString localizedNameOfStringEncoding:sqlEncoding]];
-					} else {
-						displayEncoding = [NSString localizedNameOfStringEncoding:sqlEncoding];
-					}
-					SPOnewayAlertSheet(
-						SP_FILE_READ_ERROR_STRING,
-						[tableDocumentInstance parentWindow],
-						[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read in the encoding you selected (%@).\n\nOnly %ld queries were executed.", @"SQL encoding read error"), displayEncoding, (long)queriesPerformed]
-					);
-					[sqlParser release];
-					[sqlDataBuffer release];
-					[importPool drain];
-					[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
-					if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
-					return;
-				}
 
-				// Add the NSString segment to the SQL parser and release it
-				[sqlParser appendString:sqlString];
-				[sqlString release];
+	// Read and split the file into statements in the background, executing them as they become available
+	importPipeline = [[SPSQLImportPipeline alloc] initWithFileHandle:sqlFileHandle stringEncoding:sqlEncoding noBackslashEscapes:serverStatus.noBackslashEscapes];
+	[importPipeline start];
 
-				if (allDataRead) break;
+	// Optionally execute the statements of independent tables on additional connections
+	if ([prefs integerForKey:SPImportParallelConnections] > 1) {
+		tableDispatcher = [[SPSQLImportTableDispatcher alloc] initWithConnection:mySQLConnection stringEncoding:sqlEncoding];
 
-				// Increment the query end position marker
-				dataBufferLastQueryEndPosition = dataBufferPosition;
-			}
-		}
+		if (![tableDispatcher openConnections:[prefs integerForKey:SPImportParallelConnections]]) SPClear(tableDispatcher);
+	}
 
-		// Trim the data buffer if part of it was used
-		if (dataBufferLastQueryEndPosition) {
-			[sqlDataBuffer setData:[sqlDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferLength - dataBufferLastQueryEndPosition)]];
-			dataBufferPosition -= dataBufferLastQueryEndPosition;
-			dataBufferLastQueryEndPosition = 0;
-		}
+	importPool = [[NSAutoreleasePool alloc] init];
+	while ((query = [importPipeline nextStatementReturningByteLength:&queryByteLength])) {
+		if (progressCancelled) break;
+		fileProcessedLength += queryByteLength;
 
-		// Before entering the following loop, check that we actually have a connection.
-		// If not, check the connection if appropriate and then clean up and exit if appropriate.
-		if (![mySQLConnection isConnected] && ([mySQLConnection userTriggeredDisconnect] || ![mySQLConnection checkConnection])) {
-			if ([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
+		// Skip blank or whitespace-only queries to avoid errors
+		if (![query length]) continue;
 
-			[self _closeAndStopProgressSheet];
-			[errors appendString:NSLocalizedString(@"The connection to the server was lost during the import.  The import is only partially complete.", @"Connection lost during import error message")];
-			[self showErrorSheetWithMessage:errors];
-			[sqlParser release];
-			[sqlDataBuffer release];
-			[importPool drain];
-
-			return;
-		}
+		// Statements only touching a single table may be executed on the dispatcher's connections instead
+		if (![tableDispatcher dispatchStatement:query statementNumber:(queriesPerformed+1)]) {
+			// Before running the query, check that we actually have a connection.
+			// If not, check the connection if appropriate and then clean up and exit if appropriate.
+			if (![mySQLConnection isConnected] && ([mySQLConnection userTriggeredDisconnect] || ![mySQLConnection checkConnection])) {
+				if ([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
 
-		// Extract and process any complete SQL queries that can be found in the strings parsed so far
-		while ((query = [sqlParser trimAndReturnStringToCharacter:';' trimmingInclusively:YES returningInclusively:NO])) {
-			if (progressCancelled) break;
-			fileProcessedLength += [query lengthOfBytesUsingEncoding:sqlEncoding] + 1;
+				[tableDispatcher close];
+				[tableDispatcher release];
+				[importPipeline close];
+				[self _closeAndStopProgressSheet];
+				[errors appendString:NSLocalizedString(@"The connection to the server was lost during the import.  The import is only partially complete.", @"Connection lost during import error message")];
+				[self showErrorSheetWithMessage:errors];
+				[importPipeline release];
+				[importPool drain];
 
-			// Ensure whitespace is removed from both ends, and normalise if necessary.
-			if ([sqlParser containsCarriageReturns]) {
-				query = [SPSQLParser normaliseQueryForExecution:query];
-			} else {
-				query = [query stringByTrimmingCharactersInSet:whitespaceAndNewlineCharset];
+				return;
 			}
 
-			// Skip blank or whitespace-only queries to avoid errors
-			if (![query length]) continue;
-
 			// Run the query
 			[mySQLConnection queryString:query usingEncoding:sqlEncoding withResultType:SPMySQLResultAsResult];
 
 			// in case the query was a "SET @@sql_mode = ...", the server_status may have changed
-			if([mySQLConnection updateServerStatusBits:&serverStatus]) [sqlParser setNoBackslashEscapes:serverStatus.noBackslashEscapes];
+			if([mySQLConnection updateServerStatusBits:&serverStatus]) [importPipeline setNoBackslashEscapes:serverStatus.noBackslashEscapes];
 
 			// Check for any errors
 			if ([mySQLConnection queryErrored] && ![[mySQLConnection lastErrorMessage] isEqualToString:@"Query was empty"]) {
-				[errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [mySQLConnection lastErrorMessage]];
-
 				// if the error is about utf8mb4 not being supported by the server display a more helpful message.
 				// Note: the same error will occur when doing CREATE TABLE... with utf8mb4.
 				if([mySQLConnection lastErrorID] == 1115 /* ER_UNKNOWN_CHARACTER_SET */ && [[mySQLConnection lastErrorMessage] rangeOfString:@"utf8mb4" options:NSCaseInsensitiveSearch].location != NSNotFound && [query rangeOfString:@"SET NAMES" options:NSCaseInsensitiveSearch].location != NSNotFound) {
+					[errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [mySQLConnection lastErrorMessage]];
+
 					if(!ignoreCharsetError) {
 						__block NSInteger charsetErrorSheetReturnCode;
 
@@ -615,75 +516,104 @@
 						}
 					}
 				}
-				// If not set to ignore errors, ask what to do.  Use NSAlert rather than
-				// SPBeginWaitingAlertSheet as there is already a modal sheet in progress.
-				else if (!ignoreSQLErrors) {
-					__block NSInteger sqlImportErrorSheetReturnCode;
-
-					SPMainQSync(^{
-						NSAlert *sqlErrorAlert = [NSAlert alertWithMessageText:NSLocalizedString(@"An error occurred while importing SQL", @"sql import error message")
-						                                         defaultButton:NSLocalizedString(@"Continue", @"continue button")
-						                                       alternateButton:NSLocalizedString(@"Ignore All Errors", @"ignore errors button")
-						                                           otherButton:NSLocalizedString(@"Stop", @"stop button")
-						                             informativeTextWithFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [mySQLConnection lastErrorMessage]];
-						[sqlErrorAlert setAlertStyle:NSWarningAlertStyle];
-						sqlImportErrorSheetReturnCode = [sqlErrorAlert runModal];
-					});
-
-					switch (sqlImportErrorSheetReturnCode) {
-						// On "continue", no additional action is required
-						case NSAlertDefaultReturn:
-							break;
-						// Ignore all future errors if asked to
-						case NSAlertAlternateReturn:
-							ignoreSQLErrors = YES;
-							break;
-						// Otherwise, stop
-						default:
-							[errors appendString:NSLocalizedString(@"Import cancelled!\n", @"import cancelled message")];
-							progressCancelled = YES;
-					}
+				else {
+					[self _reportSQLImportError:[mySQLConnection lastErrorMessage] inQuery:(queriesPerformed+1) errors:errors ignoringFurtherErrors:&ignoreSQLErrors];
 				}
 			}
+		}
 
-			// Increment the processed queries count
-			queriesPerformed++;
+		// Report any errors of statements executed on the dispatcher's connections
+		for (NSDictionary *dispatchedError in [tableDispatcher takeErrors]) {
+			[self _reportSQLImportError:[dispatchedError objectForKey:@"message"] inQuery:[[dispatchedError objectForKey:@"statementNumber"] integerValue] errors:errors ignoringFurtherErrors:&ignoreSQLErrors];
+		}
 
-			// Update the progress bar
-			if (fileIsCompressed) {
-				[singleProgressBar setDoubleValue:[sqlFileHandle realDataReadLength]];
-				[singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of SQL", @"SQL import progress text where total size is unknown"),
-					[NSString stringForByteSize:fileProcessedLength]]];
-			} else {
-				[singleProgressBar setDoubleValue:fileProcessedLength];
-				[singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of %@", @"SQL import progress text"),
-					[NSString stringForByteSize:fileProcessedLength], [NSString stringForByteSize:fileTotalLength]]];
+		// Increment the processed queries count
+		queriesPerformed++;
+
+		// Update the progress bar
+		if (fileIsCompressed) {
+			[singleProgressBar setDoubleValue:[sqlFileHandle realDataReadLength]];
+			[singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of SQL", @"SQL import progress text where total size is unknown"),
+				[NSString stringForByteSize:fileProcessedLength]]];
+		} else {
+			[singleProgressBar setDoubleValue:fileProcessedLength];
+			[singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of %@", @"SQL import progress text"),
+				[NSString stringForByteSize:fileProcessedLength], [NSString stringForByteSize:fileTotalLength]]];
+		}
+
+		// Periodically show how busy each stage of the import is, and reset the autorelease pool
+		if ([NSDate timeIntervalSinceReferenceDate] - lastUtilisationUpdateTime >= SPSQLImportUtilisationUpdateInterval) {
+			NSString *utilisationDescription = [NSString stringWithFormat:NSLocalizedString(@"Reading: %.0f%% busy\nSplitting: %.0f%% busy\nExecuting: %.0f%% busy", @"SQL import stage utilisation tooltip"),
+				[importPipeline readerUtilisation] * 100, [importPipeline splitterUtilisation] * 100, [importPipeline executorUtilisation] * 100];
+
+			if ([tableDispatcher connectionCount]) {
+				utilisationDescription = [utilisationDescription stringByAppendingFormat:NSLocalizedString(@"\nTable data: %lu connections", @"SQL import tooltip : number of connections importing table data"), (unsigned long)[tableDispatcher connectionCount]];
+			}
+			else if ([tableDispatcher serialFallbackReason]) {
+				utilisationDescription = [utilisationDescription stringByAppendingFormat:NSLocalizedString(@"\nTable data: imported in order, as %@", @"SQL import tooltip : table data imported on a single connection, with reason"), [tableDispatcher serialFallbackReason]];
 			}
+
+			[singleProgressText setToolTip:utilisationDescription];
+
+			lastUtilisationUpdateTime = [NSDate timeIntervalSinceReferenceDate];
+
+			[importPool drain];
+			importPool = [[NSAutoreleasePool alloc] init];
 		}
+	}
 
-		// If all the data has been read, break out of the processing loop
-		if (allDataRead) break;
+	// Finish executing the statements queued on the dispatcher's connections, and report their errors
+	if (tableDispatcher) {
+		if (!progressCancelled) [tableDispatcher waitUntilAllStatementsExecuted];
 
-		// Reset the autorelease pool
-		[importPool drain];
-		importPool = [[NSAutoreleasePool alloc] init];
+		[tableDispatcher close];
+
+		for (NSDictionary *dispatchedError in [tableDispatcher takeErrors]) {
+			[self _reportSQLImportError:[dispatchedError objectForKey:@"message"] inQuery:[[dispatchedError objectForKey:@"statementNumber"] integerValue] errors:errors ignoringFurtherErrors:&ignoreSQLErrors];
+		}
+
+		SPClear(tableDispatcher);
 	}
 
-	// If any text remains in the SQL parser, it's an unterminated query - execute it.
-	query = [sqlParser stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-	if ([query length] && !progressCancelled) {
+	[importPipeline close];
 
-		// Run the query
-		[mySQLConnection queryString:query usingEncoding:sqlEncoding withResultType:SPMySQLResultAsResult];
-		// we don't care for the server_status that is set AFTER the last query has been executed
+	// Report file read or decoding errors which stopped the import, and bail
+	if (!progressCancelled && ([importPipeline readErrorReason] || [importPipeline decodingFailed])) {
+		if (connectionEncodingToRestore) {
+			[mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
+		}
+		if (sqlModeToRestore) {
+			[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
+		}
+
+		[self _closeAndStopProgressSheet];
 
-		// Check for any errors
-		if ([mySQLConnection queryErrored] && ![[mySQLConnection lastErrorMessage] isEqualToString:@"Query was empty"]) {
-			[errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [mySQLConnection lastErrorMessage]];
+		if ([importPipeline readErrorReason]) {
+			SPOnewayAlertSheet(
+				SP_FILE_READ_ERROR_STRING,
+				[tableDocumentInstance parentWindow],
+				[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file.\n\nOnly %ld queries were executed.\n\n(%@)", @"SQL read error, including detail from system"), (long)queriesPerformed, [importPipeline readErrorReason]]
+			);
 		}
+		else {
+			NSString *displayEncoding;
 
-		// Increment the processed queries count
-		queriesPerformed++;
+			if (![importEncodingPopup indexOfSelectedItem]) {
+				displayEncoding = [NSString stringWithFormat:@"%@ - %@", [importEncodingPopup titleOfSelectedItem], [NSString localizedNameOfStringEncoding:sqlEncoding]];
+			} else {
+				displayEncoding = [NSString localizedNameOfStringEncoding:sqlEncoding];
+			}
+			SPOnewayAlertSheet(
+				SP_FILE_READ_ERROR_STRING,
+				[tableDocumentInstance parentWindow],
+				[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read in the encoding you selected (%@).\n\nOnly %ld queries were executed.", @"SQL encoding read error"), displayEncoding, (long)queriesPerformed]
+			);
+		}
+		[importPipeline release];
+		[importPool drain];
+		[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+		if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
+		return;
 	}
 
 	// Clean up
@@ -693,8 +623,7 @@
 	if (sqlModeToRestore) {
 		[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
 	}
-	[sqlParser release];
-	[sqlDataBuffer release];
+	[importPipeline release];
 	[importPool drain];
 	[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
 	if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
@@ -751,6 +680,7 @@
 	NSData *fileChunk;
 	NSString *csvString;
 	SPCSVParser *csvParser;
+	SPCSVImportLocalDataLoader *localDataLoader = nil;
 	NSMutableString *query;
 	NSMutableString *errors = [NSMutableString string];
 	NSMutableString *insertBaseString = [NSMutableString string];
@@ -770,6 +700,7 @@
 	NSUInteger i;
 	BOOL allDataRead = NO;
 	BOOL insertBaseStringHasEntries;
+	BOOL csvParserParsesData;
 	__block NSStringEncoding csvEncoding;
 
 	fieldMappingArray = nil;
@@ -867,6 +798,10 @@
 		[csvParser setNullReplacementString:[prefs objectForKey:SPNullValue]];
 	});
 
+	// Where the encoding and settings allow it, let the parser split the file's data bytewise
+	// rather than decoding it into strings first, tokenizing chunks of it on all available cores
+	csvParserParsesData = [csvParser parseDataWithEncoding:csvEncoding inParallel:([[NSProcessInfo processInfo] activeProcessorCount] > 1)];
+
 	csvDataBuffer = [[NSMutableData alloc] init];
 	importPool = [[NSAutoreleasePool alloc] init];
 	while (1) {
@@ -900,7 +835,9 @@
 		if (!fileChunk || ![fileChunk length]) {
 			allDataRead = YES;
 
-		// Otherwise add the data to the read/parse buffer
+		// Otherwise add the data to the parser directly, or to the read/parse buffer
+		} else if (csvParserParsesData) {
+			[csvParser appendData:fileChunk];
 		} else {
 			[csvDataBuffer appendData:fileChunk];
 		}
@@ -908,7 +845,7 @@
 		// Step through the data buffer, identifying line endings to parse the data with
 		csvDataBufferBytes = [csvDataBuffer bytes];
 		dataBufferLength = [csvDataBuffer length];
-		for ( ; dataBufferPosition < dataBufferLength || allDataRead; dataBufferPosition++) {
+		for ( ; !csvParserParsesData && (dataBufferPosition < dataBufferLength || allDataRead); dataBufferPosition++) {
 			if (csvDataBufferBytes[dataBufferPosition] == 0x0A || csvDataBufferBytes[dataBufferPosition] == 0x0D || allDataRead) {
 #warning This EOL detection logic will break for multibyte encodings (like UTF16)!
 				// Keep reading through any other line endings
@@ -923,19 +860,7 @@
 				csvString = [[NSString alloc] initWithData:[csvDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferPosition - dataBufferLastQueryEndPosition)] encoding:csvEncoding];
 				if (!csvString) {
 					[self _closeAndStopProgressSheet];
-					SPMainQSync(^{
-						NSString *displayEncoding;
-						if (![importEncodingPopup indexOfSelectedItem]) {
-							displayEncoding = [NSString stringWithFormat:@"%@ - %@", [importEncodingPopup titleOfSelectedItem], [NSString localizedNameOfStringEncoding:csvEncoding]];
-						} else {
-							displayEncoding = [NSString localizedNameOfStringEncoding:csvEncoding];
-						}
-						SPOnewayAlertSheet(
-							SP_FILE_READ_ERROR_STRING,
-							[tableDocumentInstance parentWindow],
-							[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read using the encoding you selected (%@).\n\nOnly %ld rows were imported.", @"CSV encoding read error"), displayEncoding, (long)rowsImported]
-						);
-					});
+					[self _showCSVEncodingErrorForEncoding:csvEncoding rowsImported:rowsImported];
 					[csvParser release];
 					[csvDataBuffer release];
 					[parsedRows release];
@@ -970,6 +895,23 @@
 		// rows have been read, in order to ensure short files are still processed.
 		while ((csvRowArray = [csvParser getRowAsArrayAndTrimString:YES stringIsComplete:allDataRead]) || (allDataRead && [parsedRows count])) {
 
+			// If raw data is being parsed, stop if a field couldn't be decoded
+			if ([csvParser encodingErrorOccurred]) {
+				[self _closeAndStopProgressSheet];
+				[self _showCSVEncodingErrorForEncoding:csvEncoding rowsImported:rowsImported];
+				[csvParser release];
+				[csvDataBuffer release];
+				[parsedRows release];
+				[parsePositions release];
+				if (localDataLoader) SPClear(localDataLoader);
+				[self _resetFieldMappingGlobals];
+				[importPool drain];
+				[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+				if([filename hasPrefix:SPImportClipboardTempFileNamePrefix])
+					[[NSFileManager defaultManager] removeItemAtPath:filename error:nil];
+				return;
+			}
+
 			// If valid, add the row array and length to local storage
 			if (csvRowArray) {
 				[parsedRows addObject:csvRowArray];
@@ -1017,6 +959,18 @@
 						}
 					}
 				}
+
+				// Only decode the fields of the remaining rows which are used by the mapping; global
+				// values may refer to any field
+				if (csvParserParsesData && !fieldMappingArrayHasGlobalVariables) {
+					NSMutableIndexSet *mappedFieldIndexes = [NSMutableIndexSet indexSet];
+					for (i = 0; i < [fieldMappingArray count]; i++) {
+						if ([NSArrayObjectAtIndex(fieldMapperOperator, i) integerValue] != 1) {
+							[mappedFieldIndexes addIndex:[NSArrayObjectAtIndex(fieldMappingArray, i) unsignedIntegerValue]];
+						}
+					}
+					[csvParser setMaterialisedFieldIndexes:mappedFieldIndexes];
+				}
 				
 				// Set up the field names import string for INSERT or REPLACE INTO
 				[insertBaseString appendString:csvImportHeaderString];
@@ -1053,6 +1007,9 @@
 					[parsedRows removeObjectAtIndex:0];
 					[parsePositions removeObjectAtIndex:0];
 				}
+
+				// Load the rows with LOAD DATA LOCAL INFILE if enabled and supported by the mapping
+				if ([prefs boolForKey:SPCSVImportLoadLocalData]) localDataLoader = [[self _localDataLoaderForCSVImport] retain];
 			}
 			if (!fieldMappingArray) continue;
 			
@@ -1064,6 +1021,7 @@
 				[csvDataBuffer release];
 				[parsedRows release];
 				[parsePositions release];
+				if (localDataLoader) SPClear(localDataLoader);
 				[self _resetFieldMappingGlobals];
 				[importPool drain];
 				[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
@@ -1072,6 +1030,54 @@
 				return;
 			}
 
+			// When loading local data, buffer the rows until a full batch or all the data has been
+			// parsed, then load them in a single statement.  The rows are kept until the batch has
+			// been loaded, so they can still be inserted if the server refuses to load local data.
+			if (localDataLoader) {
+				if (progressCancelled) break;
+
+				for (i = [localDataLoader rowCount]; i < [parsedRows count]; i++) {
+					[localDataLoader appendRow:NSArrayObjectAtIndex(parsedRows, i)];
+				}
+
+				if (![parsedRows count]) continue;
+				if ([localDataLoader bufferedLength] < SPCSVImportLocalDataBatchLength && (csvRowArray || !allDataRead)) continue;
+
+				csvRowsThisQuery = [localDataLoader rowCount];
+
+				if ([localDataLoader loadBufferedRows]) {
+					for (NSString *warning in [localDataLoader lastWarnings]) {
+						[errors appendFormat:
+							NSLocalizedString(@"[WARNING in rows %ld-%ld] %@\n", @"warning text when loading rows of csv file gave warnings"),
+							(long)(rowsImported+1), (long)(rowsImported+csvRowsThisQuery), warning];
+					}
+				} else if ([localDataLoader localDataRefused]) {
+					SPClear(localDataLoader);
+				} else {
+					[[tableDocumentInstance onMainThread] showConsole:nil];
+					[errors appendFormat:
+						NSLocalizedString(@"[ERROR in rows %ld-%ld] %@\n", @"error text when loading rows of csv file gave errors"),
+						(long)(rowsImported+1), (long)(rowsImported+csvRowsThisQuery), [localDataLoader lastErrorMessage]];
+				}
+
+				// If local data was refused, fall through to insert the rows instead
+				if (localDataLoader) {
+					rowsImported += csvRowsThisQuery;
+					SPMainQSync(^{
+						if (fileIsCompressed) {
+							[singleProgressBar setDoubleValue:[csvFileHandle realDataReadLength]];
+							[singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of CSV data", @"CSV import progress text where total size is unknown"), [NSString stringForByteSize:[[parsePositions lastObject] longValue]]]];
+						} else {
+							[singleProgressBar setDoubleValue:[[parsePositions lastObject] doubleValue]];
+							[singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of %@", @"CSV import progress text"), [NSString stringForByteSize:[[parsePositions lastObject] longValue]], [NSString stringForByteSize:fileTotalLength]]];
+						}
+					});
+					[parsedRows removeAllObjects];
+					[parsePositions removeAllObjects];
+					continue;
+				}
+			}
+
 			// If we have more than the csvRowsPerQuery amount, or if we're at the end of the
 			// available data, construct and run a query.
 			while ([parsedRows count] >= csvRowsPerQuery
@@ -1226,6 +1232,7 @@
 	[csvDataBuffer release];
 	[parsedRows release];
 	[parsePositions release];
+	if (localDataLoader) SPClear(localDataLoader);
 	[self _resetFieldMappingGlobals];
 	[importPool drain];
 	[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
@@ -1648,13 +1655,7 @@ cleanup:
 
 	// If the file has an extension '.gz' or '.bz2' indicating gzip or bzip2 compression, fetch the next extension
 	if ([pathExtension isEqualToString:@"GZ"] || [pathExtension isEqualToString:@"BZ2"]) {
-		NSMutableString *pathString = [NSMutableString stringWithString:[selectedUrls[0] path]];
-		
-		BOOL isGzip = [pathExtension isEqualToString:@"GZ"];
-		
-		[pathString deleteCharactersInRange:NSMakeRange([pathString length] - (isGzip ? 3 : 4), (isGzip ? 3 : 4))];
-		
-		pathExtension = [[pathString pathExtension] uppercaseString];		
+		pathExtension = [[[[selectedUrls[0] path] stringByDeletingPathExtension] pathExtension] uppercaseString];
 	}
 	
 	if ([pathExtension isEqualToString:@"SQL"]) {
@@ -1808,6 +1809,122 @@ cleanup:
 	});
 }
 
+/**
+ * Record an error from a query of a SQL import, and unless errors are being ignored, ask
+ * whether to continue the import.
+ */
+- (void)_reportSQLImportError:(NSString *)errorMessage inQuery:(NSInteger)queryNumber errors:(NSMutableString *)errors ignoringFurtherErrors:(BOOL *)ignoreSQLErrors
+{
+	[errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)queryNumber, errorMessage];
+
+	if (*ignoreSQLErrors || progressCancelled) return;
+
+	// Use NSAlert rather than SPBeginWaitingAlertSheet as there is already a modal sheet in progress.
+	__block NSInteger sqlImportErrorSheetReturnCode;
+
+	SPMainQSync(^{
+		NSAlert *sqlErrorAlert = [NSAlert alertWithMessageText:NSLocalizedString(@"An error occurred while importing SQL", @"sql import error message")
+		                                         defaultButton:NSLocalizedString(@"Continue", @"continue button")
+		                                       alternateButton:NSLocalizedString(@"Ignore All Errors", @"ignore errors button")
+		                                           otherButton:NSLocalizedString(@"Stop", @"stop button")
+		                             informativeTextWithFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)queryNumber, errorMessage];
+		[sqlErrorAlert setAlertStyle:NSWarningAlertStyle];
+		sqlImportErrorSheetReturnCode = [sqlErrorAlert runModal];
+	});
+
+	switch (sqlImportErrorSheetReturnCode) {
+		// On "continue", no additional action is required
+		case NSAlertDefaultReturn:
+			break;
+		// Ignore all future errors if asked to
+		case NSAlertAlternateReturn:
+			*ignoreSQLErrors = YES;
+			break;
+		// Otherwise, stop
+		default:
+			[errors appendString:NSLocalizedString(@"Import cancelled!\n", @"import cancelled message")];
+			progressCancelled = YES;
+	}
+}
+
+/**
+ * Tell the user that the CSV file couldn't be read in its encoding.
+ */
+- (void)_showCSVEncodingErrorForEncoding:(NSStringEncoding)csvEncoding rowsImported:(NSInteger)rowsImported
+{
+	SPMainQSync(^{
+		NSString *displayEncoding;
+		if (![importEncodingPopup indexOfSelectedItem]) {
+			displayEncoding = [NSString stringWithFormat:@"%@ - %@", [importEncodingPopup titleOfSelectedItem], [NSString localizedNameOfStringEncoding:csvEncoding]];
+		} else {
+			displayEncoding = [NSString localizedNameOfStringEncoding:csvEncoding];
+		}
+		SPOnewayAlertSheet(
+			SP_FILE_READ_ERROR_STRING,
+			[tableDocumentInstance parentWindow],
+			[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read using the encoding you selected (%@).\n\nOnly %ld rows were imported.", @"CSV encoding read error"), displayEncoding, (long)rowsImported]
+		);
+	});
+}
+
+/**
+ * Returns an opened loader for importing the CSV rows with LOAD DATA LOCAL INFILE, if the field
+ * mapping only copies columns of the file into columns of the table, the import ignores or replaces
+ * duplicate rows, and the server allows loading local data.  Otherwise returns nil, and the rows
+ * are imported with INSERT statements.
+ */
+- (SPCSVImportLocalDataLoader *)_localDataLoaderForCSVImport
+{
+	if (importMethodIsUpdate || csvImportMethodHasTail || fieldMappingArrayHasGlobalVariables) return nil;
+
+	// LOAD DATA only supports the LOW_PRIORITY and IGNORE options of INSERT and REPLACE
+	NSArray *headerWords = [[csvImportHeaderString stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]] componentsSeparatedByString:@" "];
+	NSString *duplicateHandling = nil;
+	BOOL lowPriority = NO;
+
+	if ([headerWords count] < 2 || ![[headerWords lastObject] isEqualToString:@"INTO"]) return nil;
+
+	if ([NSArrayObjectAtIndex(headerWords, 0) isEqualToString:@"REPLACE"]) duplicateHandling = @"REPLACE";
+	else if (![NSArrayObjectAtIndex(headerWords, 0) isEqualToString:@"INSERT"]) return nil;
+
+	for (NSString *option in [headerWords subarrayWithRange:NSMakeRange(1, [headerWords count] - 2)]) {
+		if ([option isEqualToString:@"LOW_PRIORITY"]) lowPriority = YES;
+		else if ([option isEqualToString:@"IGNORE"]) duplicateHandling = @"IGNORE";
+		else return nil;
+	}
+
+	NSMutableArray *columnNames = [NSMutableArray array];
+	NSMutableArray *sourceColumns = [NSMutableArray array];
+	NSMutableArray *defaultValues = [NSMutableArray array];
+	NSMutableIndexSet *emptyStringNullColumns = [NSMutableIndexSet indexSet];
+	NSUInteger i;
+
+	for (i = 0; i < [fieldMappingArray count]; i++) {
+		if ([NSArrayObjectAtIndex(fieldMapperOperator, i) integerValue] > 0) continue;
+
+		NSString *columnName = NSArrayObjectAtIndex(fieldMappingTableColumnNames, i);
+
+		// Geometry and bit values are converted by the INSERT statements
+		if ([geometryFields containsObject:columnName] || [bitFields containsObject:columnName]) return nil;
+
+		if ([nullableNumericFieldsMapIndex containsIndex:i]) [emptyStringNullColumns addIndex:[columnNames count]];
+
+		[columnNames addObject:columnName];
+		[sourceColumns addObject:NSArrayObjectAtIndex(fieldMappingArray, i)];
+		[defaultValues addObject:NSArrayObjectAtIndex(fieldMappingTableDefaultValues, i)];
+	}
+
+	if (![columnNames count]) return nil;
+
+	SPCSVImportLocalDataLoader *loader = [[[SPCSVImportLocalDataLoader alloc] initWithConnection:mySQLConnection table:selectedTableTarget columnNames:columnNames sourceColumns:sourceColumns defaultValues:defaultValues] autorelease];
+
+	[loader setEmptyStringNullColumns:emptyStringNullColumns];
+	[loader setDuplicateHandling:duplicateHandling];
+	[loader setLowPriority:lowPriority];
+
+	return [loader open] ? loader : nil;
+}
+
 /**
  * Tries to determine the line endings of the specified file using the 'file' command.
  */
@@ -44,6 +44,9 @@
 	SPMySQLStreamingResultStore *dataStorage;
 	NSPointerArray *editedRows;
 	BOOL *unloadedColumns;
+	NSUInteger *previewLengthColumns;
+	NSUInteger previewCharacterLength;
+	NSCache *fullValueCache;
 	NSCondition *dataDownloadedLock;
 
 	NSUInteger numberOfColumns;
@@ -58,6 +61,8 @@
 - (id) cellDataAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
 - (id) cellPreviewAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex previewLength:(NSUInteger)previewLength;
 - (BOOL) cellIsNullOrUnloadedAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (NSUInteger) rawDataLengthAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (void) getCellsAtRow:(NSUInteger)rowIndex columns:(const NSUInteger *)columnIndexes count:(NSUInteger)columnCount objects:(id *)cellObjects stringBytes:(NSMutableData *)byteBuffer ranges:(NSRange *)byteRanges;
 
 /* Adding and amending rows and cells */
 - (void) addRowWithContents:(NSMutableArray *)aRow;
@@ -71,6 +76,11 @@
 /* Unloaded columns */
 - (void) setColumnAsUnloaded:(NSUInteger)columnIndex;
 
+/* Previewed columns */
+- (void) setColumnsAsPreviewed:(NSIndexSet *)columnIndexes previewLength:(NSUInteger)previewLength;
+- (BOOL) cellIsTruncatedPreviewAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (void) cacheFullValue:(id)aValue withLength:(unsigned long long)valueLength atRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+
 /* Basic information */
 - (NSUInteger) count;
 - (NSUInteger) columnCount;
@@ -34,10 +34,16 @@
 #include <stdlib.h>
 #include <mach/mach_time.h>
 
+// The approximate number of bytes of full values for previewed cells to keep in memory
+#define SP_DATA_STORAGE_FULL_VALUE_CACHE_LIMIT (32 * 1024 * 1024)
+
 @interface SPDataStorage ()
 
 - (void) _checkNewRow:(NSMutableArray *)aRow;
 - (void) _addRowUnsafeUnchecked:(NSMutableArray *)aRow;
+- (void) _trimStoreRow:(NSMutableArray *)aRow;
+- (id) _fullValueKeyForRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (BOOL) _cellIsTruncatedPreviewUnsafeAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
 
 @end
 
@@ -55,11 +61,12 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 
 /**
  * Set the underlying MySQL data storage.
- * This will clear all edited rows and unloaded column tracking.
+ * This will clear all edited rows, unloaded and previewed column tracking, and cached values.
  */
 - (void) setDataStorage:(SPMySQLStreamingResultStore *)newDataStorage updatingExisting:(BOOL)updateExistingStore
 {
 	BOOL *oldUnloadedColumns;
+	NSUInteger *oldPreviewLengthColumns;
 	NSPointerArray *oldEditedRows;
 	SPMySQLStreamingResultStore *oldDataStorage;
 	
@@ -83,15 +90,19 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 		}
 
 		oldUnloadedColumns = unloadedColumns;
+		oldPreviewLengthColumns = previewLengthColumns;
 		oldEditedRows = editedRows;
 		dataStorage = newDataStorage;
 		numberOfColumns = newNumberOfColumns;
 		unloadedColumns = newUnloadedColumns;
+		previewLengthColumns = NULL;
 		editedRowCount = 0;
 		editedRows = newEditedRows;
+		[fullValueCache removeAllObjects];
 	}
 	
 	free(oldUnloadedColumns);
+	if (oldPreviewLengthColumns) free(oldPreviewLengthColumns);
 	[oldEditedRows release];
 	[oldDataStorage release];
 	
@@ -137,6 +148,16 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 				CFArraySetValueAtIndex((CFMutableArrayRef)dataArray, i, notLoaded);
 			}
 		}
+
+		if (previewLengthColumns) {
+			for (NSUInteger i = 0; i < numberOfColumns; i++) {
+				if (previewLengthColumns[i] != NSNotFound && [self _cellIsTruncatedPreviewUnsafeAtRow:anIndex column:i]) {
+					id fullValue = [fullValueCache objectForKey:[self _fullValueKeyForRow:anIndex column:i]];
+					CFArraySetValueAtIndex((CFMutableArrayRef)dataArray, i, fullValue ? fullValue : notLoaded);
+				}
+			}
+			[self _trimStoreRow:dataArray];
+		}
 		
 		return dataArray;
 	}
@@ -168,6 +189,12 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 			return notLoaded;
 		}
 
+		// If only a preview of the cell was loaded, return the full value if it has been fetched
+		if (previewLengthColumns && [self _cellIsTruncatedPreviewUnsafeAtRow:rowIndex column:columnIndex]) {
+			id fullValue = [fullValueCache objectForKey:[self _fullValueKeyForRow:rowIndex column:columnIndex]];
+			return fullValue ? fullValue : notLoaded;
+		}
+
 		// Return the content
 		return SPMySQLResultStoreObjectAtRowAndColumn(dataStorage, rowIndex, columnIndex);
 	}
@@ -204,8 +231,15 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 			return notLoaded;
 		}
 
+		id preview = SPMySQLResultStorePreviewAtRowAndColumn(dataStorage, rowIndex, columnIndex, previewLength);
+
+		// Mark previews of partially loaded strings as such, unless already shortened further
+		if (previewLengthColumns && [preview isKindOfClass:[NSString class]] && ![(NSString *)preview hasSuffix:@"..."] && [self _cellIsTruncatedPreviewUnsafeAtRow:rowIndex column:columnIndex]) {
+			return [(NSString *)preview stringByAppendingString:@"..."];
+		}
+
 		// Return the content
-		return SPMySQLResultStorePreviewAtRowAndColumn(dataStorage, rowIndex, columnIndex, previewLength);
+		return preview;
 	}
 }
 
@@ -237,6 +271,91 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 	}
 }
 
+/**
+ * Return the length in bytes of the raw data for the specified cell, as stored in the
+ * underlying result store, without converting it to an object.  NSNotFound is returned
+ * when no raw length is available - for NULL or unloaded cells, or for rows which have
+ * been edited locally - and callers should then fall back to the cell contents.
+ */
+- (NSUInteger) rawDataLengthAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	@synchronized(self) {
+		if (rowIndex < editedRowCount && SPDataStorageGetEditedRow(editedRows, rowIndex) != NULL) {
+			return NSNotFound;
+		}
+
+		// Throw an exception if the column index is out of bounds
+		if (columnIndex >= numberOfColumns) {
+			[NSException raise:NSRangeException format:@"Requested storage column (col %llu) beyond bounds (%llu)", (unsigned long long)columnIndex, (unsigned long long)numberOfColumns];
+		}
+
+		if (unloadedColumns[columnIndex]) {
+			return NSNotFound;
+		}
+
+		return [dataStorage cellDataLengthAtRow:rowIndex column:columnIndex];
+	}
+}
+
+/**
+ * Retrieve several cells of a row at once, taking the store lock only once for the row.
+ * If a buffer is supplied, the raw bytes of cells which would be returned as strings are
+ * appended to it - in the encoding of the underlying result, avoiding the creation of
+ * string objects - and their range within the buffer is returned.  For all other cells
+ * the range is set to {NSNotFound, 0} and the cell contents are returned as for
+ * -cellDataAtRow:column:, so NULL, unloaded and partially loaded cells and rows which
+ * have been edited locally are always returned as objects.
+ */
+- (void) getCellsAtRow:(NSUInteger)rowIndex columns:(const NSUInteger *)columnIndexes count:(NSUInteger)columnCount objects:(id *)cellObjects stringBytes:(NSMutableData *)byteBuffer ranges:(NSRange *)byteRanges
+{
+	SPNotLoaded *notLoaded = [SPNotLoaded notLoaded];
+	@synchronized(self) {
+		NSMutableArray *editedRow = (rowIndex < editedRowCount) ? SPDataStorageGetEditedRow(editedRows, rowIndex) : NULL;
+
+		for (NSUInteger i = 0; i < columnCount; i++) {
+			NSUInteger columnIndex = columnIndexes[i];
+
+			byteRanges[i] = NSMakeRange(NSNotFound, 0);
+
+			// If an edited row exists at the supplied index, use its contents
+			if (editedRow != NULL) {
+				cellObjects[i] = CFArrayGetValueAtIndex((CFArrayRef)editedRow, columnIndex);
+				continue;
+			}
+
+			// Throw an exception if the column index is out of bounds
+			if (columnIndex >= numberOfColumns) {
+				[NSException raise:NSRangeException format:@"Requested storage column (col %llu) beyond bounds (%llu)", (unsigned long long)columnIndex, (unsigned long long)numberOfColumns];
+			}
+
+			if (unloadedColumns[columnIndex]) {
+				cellObjects[i] = notLoaded;
+				continue;
+			}
+
+			if (previewLengthColumns && [self _cellIsTruncatedPreviewUnsafeAtRow:rowIndex column:columnIndex]) {
+				id fullValue = [fullValueCache objectForKey:[self _fullValueKeyForRow:rowIndex column:columnIndex]];
+				cellObjects[i] = fullValue ? fullValue : notLoaded;
+				continue;
+			}
+
+			if (byteBuffer) {
+				NSUInteger length;
+				const char *bytes = [dataStorage stringBytesAtRow:rowIndex column:columnIndex length:&length];
+
+				if (bytes) {
+					byteRanges[i] = NSMakeRange([byteBuffer length], length);
+					[byteBuffer appendBytes:bytes length:length];
+					cellObjects[i] = nil;
+					continue;
+				}
+			}
+
+			cellObjects[i] = SPMySQLResultStoreObjectAtRowAndColumn(dataStorage, rowIndex, columnIndex);
+		}
+	}
+}
+
 #pragma mark -
 #pragma mark Retrieving rows via NSFastEnumeration
 
@@ -274,6 +393,16 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 					CFArraySetValueAtIndex((CFMutableArrayRef)targetRow, i, notLoaded);
 				}
 			}
+
+			if (previewLengthColumns) {
+				for (NSUInteger i = 0; i < numberOfColumns; i++) {
+					if (previewLengthColumns[i] != NSNotFound && [self _cellIsTruncatedPreviewUnsafeAtRow:state->state column:i]) {
+						id fullValue = [fullValueCache objectForKey:[self _fullValueKeyForRow:state->state column:i]];
+						CFArraySetValueAtIndex((CFMutableArrayRef)targetRow, i, fullValue ? fullValue : notLoaded);
+					}
+				}
+				[self _trimStoreRow:targetRow];
+			}
 		}
 	}
 
@@ -343,6 +472,7 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 			// Add the new row to the editable store
 			[editedRows insertPointer:newArray atIndex:anIndex];
 			editedRowCount++;
+			[fullValueCache removeAllObjects];
 			
 			// Update the underlying store to keep counts and indices correct
 			[dataStorage insertDummyRowAtIndex:anIndex];
@@ -414,6 +544,7 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 			[editedRows removePointerAtIndex:anIndex];
 		}
 		[dataStorage removeRowAtIndex:anIndex];
+		[fullValueCache removeAllObjects];
 	}
 }
 
@@ -436,6 +567,7 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 			[editedRows removePointerAtIndex:i];
 		}
 		[dataStorage removeRowsInRange:rangeToRemove];
+		[fullValueCache removeAllObjects];
 	}
 }
 
@@ -448,6 +580,7 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 		editedRowCount = 0;
 		[editedRows setCount:0];
 		[dataStorage removeAllRows];
+		[fullValueCache removeAllObjects];
 	}
 }
 
@@ -467,6 +600,83 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 	}
 }
 
+#pragma mark - Previewed columns
+
+/**
+ * Mark columns as previewed: the underlying result store holds only the first previewLength
+ * characters of each value in these columns, and after the columns represented by this
+ * store it contains one additional column per previewed column - in column order - with the
+ * full length of each value in characters, as returned by CHAR_LENGTH().  Those trailing
+ * columns are hidden from users of this store.
+ *
+ * Cells whose preview is shorter than the full value are returned as SPNotLoaded
+ * placeholders by the full data accessors until their value is supplied using
+ * -cacheFullValue:atRow:column:, while the preview accessors return the loaded preview.
+ */
+- (void) setColumnsAsPreviewed:(NSIndexSet *)columnIndexes previewLength:(NSUInteger)previewLength
+{
+	@synchronized(self) {
+		NSUInteger previewedColumnCount = [columnIndexes count];
+
+		if (!previewedColumnCount) return;
+
+		if (previewLengthColumns || previewedColumnCount * 2 > numberOfColumns || [columnIndexes lastIndex] >= numberOfColumns - previewedColumnCount) {
+			[NSException raise:NSRangeException format:@"Invalid columns set as previewed; %llu previewed columns requested in a store with %llu columns", (unsigned long long)previewedColumnCount, (unsigned long long)numberOfColumns];
+		}
+
+		numberOfColumns -= previewedColumnCount;
+		previewCharacterLength = previewLength;
+		previewLengthColumns = malloc(numberOfColumns * sizeof(NSUInteger));
+
+		NSUInteger lengthColumn = numberOfColumns;
+		for (NSUInteger i = 0; i < numberOfColumns; i++) {
+			previewLengthColumns[i] = [columnIndexes containsIndex:i] ? lengthColumn++ : NSNotFound;
+		}
+
+		if (!fullValueCache) {
+			fullValueCache = [[NSCache alloc] init];
+			[fullValueCache setTotalCostLimit:SP_DATA_STORAGE_FULL_VALUE_CACHE_LIMIT];
+		}
+	}
+}
+
+/**
+ * Returns whether only a preview of the specified cell has been loaded, and the full
+ * value isn't currently available from the cache.
+ */
+- (BOOL) cellIsTruncatedPreviewAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	@synchronized(self) {
+		if (!previewLengthColumns || columnIndex >= numberOfColumns) return NO;
+
+		if (rowIndex < editedRowCount && SPDataStorageGetEditedRow(editedRows, rowIndex) != NULL) return NO;
+
+		return [self _cellIsTruncatedPreviewUnsafeAtRow:rowIndex column:columnIndex] && ![fullValueCache objectForKey:[self _fullValueKeyForRow:rowIndex column:columnIndex]];
+	}
+}
+
+/**
+ * Store the full value of a previewed cell, along with its length in characters as reported
+ * by the server.  Values are held in a size-bounded cache and may be discarded again
+ * under memory pressure, in which case the full data accessors revert to returning
+ * SPNotLoaded placeholders.  Values whose length doesn't match the length loaded with
+ * the preview are ignored, as the cell may have been changed since.
+ */
+- (void) cacheFullValue:(id)aValue withLength:(unsigned long long)valueLength atRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	if (!aValue || [aValue isNSNull]) return;
+
+	@synchronized(self) {
+		if (!previewLengthColumns || columnIndex >= numberOfColumns || previewLengthColumns[columnIndex] == NSNotFound) return;
+		if (rowIndex >= SPMySQLResultStoreGetRowCount(dataStorage)) return;
+		if (![self _cellIsTruncatedPreviewUnsafeAtRow:rowIndex column:columnIndex]) return;
+
+		if ([SPMySQLResultStoreObjectAtRowAndColumn(dataStorage, rowIndex, previewLengthColumns[columnIndex]) longLongValue] != (long long)valueLength) return;
+
+		[fullValueCache setObject:aValue forKey:[self _fullValueKeyForRow:rowIndex column:columnIndex] cost:(NSUInteger)valueLength];
+	}
+}
+
 #pragma mark - Basic information
 
 /**
@@ -537,6 +747,8 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 		dataStorage = nil;
 		editedRows = nil;
 		unloadedColumns = NULL;
+		previewLengthColumns = NULL;
+		fullValueCache = nil;
 		dataDownloadedLock = [NSCondition new];
 
 		numberOfColumns = 0;
@@ -551,9 +763,13 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 		SPClear(dataStorage);
 		SPClear(editedRows);
 		SPClear(dataDownloadedLock);
+		SPClear(fullValueCache);
 		if (unloadedColumns) {
 			free(unloadedColumns), unloadedColumns = NULL;
 		}
+		if (previewLengthColumns) {
+			free(previewLengthColumns), previewLengthColumns = NULL;
+		}
 	}
 	
 	[super dealloc];
@@ -581,4 +797,39 @@ static inline NSMutableArray* SPDataStorageGetEditedRow(NSPointerArray* rowStore
 	[dataStorage addDummyRow];
 }
 
+// DO NOT CALL THIS METHOD UNLESS YOU CURRENTLY HAVE A LOCK ON SELF!!!
+// Removes the hidden trailing preview length columns from a row retrieved from the result store.
+- (void) _trimStoreRow:(NSMutableArray *)aRow
+{
+	NSUInteger rowLength = [aRow count];
+
+	if (rowLength > numberOfColumns) {
+		[aRow removeObjectsInRange:NSMakeRange(numberOfColumns, rowLength - numberOfColumns)];
+	}
+}
+
+// DO NOT CALL THIS METHOD UNLESS YOU CURRENTLY HAVE A LOCK ON SELF!!!
+- (id) _fullValueKeyForRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	return [NSNumber numberWithUnsignedLongLong:(unsigned long long)rowIndex * numberOfColumns + columnIndex];
+}
+
+// DO NOT CALL THIS METHOD UNLESS YOU CURRENTLY HAVE A LOCK ON SELF!!!
+// Returns whether the stored value of a cell is shorter than the full length loaded alongside
+// it; dummy rows and NULL cells are never truncated.
+- (BOOL) _cellIsTruncatedPreviewUnsafeAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	NSUInteger lengthColumn = previewLengthColumns[columnIndex];
+
+	if (lengthColumn == NSNotFound) return NO;
+
+	id fullLength = SPMySQLResultStoreObjectAtRowAndColumn(dataStorage, rowIndex, lengthColumn);
+
+	if ([fullLength isNSNull]) return NO;
+
+	// Both the preview and the full length are counted in characters, whatever the column and
+	// connection encodings, so the preview is truncated exactly when the value is longer
+	return ([fullLength longLongValue] > (long long)previewCharacterLength);
+}
+
 @end
@@ -0,0 +1,121 @@
+//
+//  SPDataStorageSerializer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPDataStorage;
+@class SPMySQLConnection;
+
+typedef enum {
+	SPDataStorageSerializeAsTabText        = 0, // Copy: line breaks and tabs are shown as ↵ and ⇥
+	SPDataStorageSerializeAsDraggedTabText = 1, // Drag: cell contents are used unaltered
+	SPDataStorageSerializeAsCSV            = 2,
+	SPDataStorageSerializeAsSQLInserts     = 3
+} SPDataStorageSerializationFormat;
+
+typedef enum {
+	SPDataStorageBlobsExcluded    = 1,
+	SPDataStorageBlobsIncluded    = 2,
+	SPDataStorageBlobsAsFiles     = 3,
+	SPDataStorageBlobsAsImageFile = 4
+} SPDataStorageBlobHandling;
+
+/**
+ * @class SPDataStorageSerializer SPDataStorageSerializer.h
+ *
+ * Serializes a set of rows from a SPDataStorage instance to text - tab-separated,
+ * CSV, or SQL INSERT statements - as used for copying and dragging result rows.
+ *
+ * The rows are split into chunks which are serialized concurrently into UTF-8 byte
+ * buffers, which are then joined in order.  For connections using UTF-8, cells which
+ * are still held as raw bytes in the underlying result store are copied straight into
+ * the buffers without creating any intermediate objects.
+ *
+ * Serialization can be cancelled from any thread, and progress is reported through
+ * an optional handler, so large selections can be serialized on a background thread.
+ */
+@interface SPDataStorageSerializer : NSObject
+{
+	SPDataStorage *dataStorage;
+	SPDataStorageSerializationFormat format;
+
+	NSUInteger numberOfColumns;
+	NSUInteger *columnMappings;
+	NSUInteger *columnTypes;
+	NSArray *columnNames;
+
+	NSString *tableName;
+	SPMySQLConnection *connection;
+	NSString *nullString;
+	NSString *blobFileDirectory;
+	SPDataStorageBlobHandling blobHandling;
+	BOOL displaysBinaryDataAsHex;
+	BOOL includesHeaders;
+
+	id (^unloadedValueLoader)(NSUInteger rowIndex, NSUInteger columnIndex);
+	void (^progressHandler)(CGFloat progress);
+
+	BOOL useRawBytes;
+	NSData *notLoadedData;
+	NSData *nullStringData;
+	NSData *insertStatementData;
+	volatile BOOL cancelled;
+	volatile BOOL aborted;
+	volatile int64_t rowsSerialized;
+}
+
+@property (readwrite, retain) NSString *tableName;
+@property (readwrite, assign) SPMySQLConnection *connection;
+@property (readwrite, retain) NSString *nullString;
+@property (readwrite, retain) NSString *blobFileDirectory;
+@property (readwrite, assign) SPDataStorageBlobHandling blobHandling;
+@property (readwrite, assign) BOOL displaysBinaryDataAsHex;
+@property (readwrite, assign) BOOL includesHeaders;
+
+/**
+ * Called when a SQL INSERT is required for a cell which hasn't been loaded, with the
+ * row and data storage column; should return the cell value, or nil to abort.  Calls
+ * are serialized, but may be made from any thread.
+ */
+@property (readwrite, copy) id (^unloadedValueLoader)(NSUInteger rowIndex, NSUInteger columnIndex);
+
+/**
+ * Called periodically from any thread with the fraction of rows serialized so far.
+ */
+@property (readwrite, copy) void (^progressHandler)(CGFloat progress);
+
+@property (readonly, getter=isCancelled) BOOL cancelled;
+
+- (id)initWithDataStorage:(SPDataStorage *)theDataStorage format:(SPDataStorageSerializationFormat)theFormat;
+
+- (void)setColumns:(NSArray *)storageColumnIndexes names:(NSArray *)names typeGroupings:(NSArray *)typeGroupings;
+
+- (NSString *)serializeRows:(NSIndexSet *)rowIndexes;
+- (void)cancel;
+
+@end
@@ -0,0 +1,747 @@
+//
+//  SPDataStorageSerializer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPDataStorageSerializer.h"
+#import "SPDataStorage.h"
+#import "SPGeometryDataView.h"
+
+#import <SPMySQL/SPMySQL.h>
+#include <libkern/OSAtomic.h>
+
+// The number of rows serialized together by each concurrent worker
+static const NSUInteger SPDataStorageSerializerRowsPerChunk = 2000;
+
+// The approximate length after which a new INSERT statement is started
+static const NSUInteger SPDataStorageSerializerMaxInsertLength = 250000;
+
+typedef enum {
+	SPSerializerColumnNumeric  = 0,
+	SPSerializerColumnString   = 1,
+	SPSerializerColumnBlob     = 2,
+	SPSerializerColumnGeometry = 3
+} SPSerializerColumnType;
+
+typedef enum {
+	SPSerializerEscapeNone          = 0,
+	SPSerializerEscapeControlChars  = 1,
+	SPSerializerEscapeCSVQuotes     = 2
+} SPSerializerEscaping;
+
+@interface SPDataStorageSerializer ()
+
+- (void)_prepareSharedData;
+- (NSString *)_serializeRows:(NSUInteger *)rows count:(NSUInteger)rowCount concurrently:(BOOL)concurrently;
+- (BOOL)_serializeTextRows:(NSUInteger *)rows count:(NSUInteger)rowCount firstOrdinal:(NSUInteger)firstOrdinal intoBuffer:(NSMutableData *)buffer;
+- (BOOL)_serializeSQLRows:(NSUInteger *)rows count:(NSUInteger)rowCount intoBuffer:(NSMutableData *)buffer;
+- (void)_appendTextValue:(id)cellData forRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex ordinal:(NSUInteger)ordinal toBuffer:(NSMutableData *)buffer scratchBuffer:(NSMutableData *)scratch;
+- (void)_appendBlob:(NSData *)blobData ordinal:(NSUInteger)ordinal column:(NSUInteger)columnIndex toBuffer:(NSMutableData *)buffer scratchBuffer:(NSMutableData *)scratch;
+- (void)_appendGeometry:(SPMySQLGeometryData *)geometryData ordinal:(NSUInteger)ordinal column:(NSUInteger)columnIndex toBuffer:(NSMutableData *)buffer scratchBuffer:(NSMutableData *)scratch;
+- (BOOL)_appendSQLValue:(id)cellData stringBytes:(const char *)bytes length:(NSUInteger)length forRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex toBuffer:(NSMutableData *)buffer;
+- (id)_loadUnloadedValueForRow:(NSUInteger)rowIndex column:(NSUInteger)storageColumnIndex;
+- (BOOL)_writesFiles;
+
+@end
+
+/**
+ * Append the UTF-8 representation of a string to a buffer, converting directly into
+ * the buffer's storage.
+ */
+static void SPSerializerAppendUTF8(NSMutableData *buffer, NSString *string)
+{
+	NSUInteger stringLength = [string length];
+
+	if (!stringLength) return;
+
+	// Each UTF-16 unit requires at most three bytes in UTF-8
+	NSUInteger bufferLength = [buffer length];
+	NSUInteger maxLength = stringLength * 3;
+	NSUInteger usedLength = 0;
+
+	[buffer setLength:bufferLength + maxLength];
+	[string getBytes:((char *)[buffer mutableBytes]) + bufferLength maxLength:maxLength usedLength:&usedLength encoding:NSUTF8StringEncoding options:NSStringEncodingConversionAllowLossy range:NSMakeRange(0, stringLength) remainingRange:NULL];
+	[buffer setLength:bufferLength + usedLength];
+}
+
+/**
+ * Append UTF-8 cell bytes to a buffer, applying the supplied escaping.  Runs of bytes
+ * which don't need escaping are copied as a whole; as UTF-8 multibyte sequences never
+ * contain ASCII bytes, the bytes can be scanned without decoding.
+ */
+static void SPSerializerAppendCellBytes(NSMutableData *buffer, const char *bytes, NSUInteger length, SPSerializerEscaping escaping)
+{
+	if (escaping == SPSerializerEscapeNone) {
+		[buffer appendBytes:bytes length:length];
+		return;
+	}
+
+	NSUInteger runStart = 0;
+
+	for (NSUInteger i = 0; i < length; i++) {
+		const char *replacement;
+		NSUInteger replacementLength;
+
+		if (escaping == SPSerializerEscapeCSVQuotes) {
+			if (bytes[i] != '"') continue;
+			replacement = "\"\"";
+			replacementLength = 2;
+		}
+		else if (bytes[i] == '\n') {
+			replacement = "\xE2\x86\xB5"; // ↵
+			replacementLength = 3;
+		}
+		else if (bytes[i] == '\t') {
+			replacement = "\xE2\x87\xA5"; // ⇥
+			replacementLength = 3;
+		}
+		else {
+			continue;
+		}
+
+		if (i > runStart) [buffer appendBytes:bytes + runStart length:i - runStart];
+		[buffer appendBytes:replacement length:replacementLength];
+		runStart = i + 1;
+	}
+
+	if (length > runStart) [buffer appendBytes:bytes + runStart length:length - runStart];
+}
+
+/**
+ * Append a string to a buffer, applying the supplied escaping.
+ */
+static void SPSerializerAppendString(NSMutableData *buffer, NSString *string, SPSerializerEscaping escaping, NSMutableData *scratch)
+{
+	if (escaping == SPSerializerEscapeNone) {
+		SPSerializerAppendUTF8(buffer, string);
+		return;
+	}
+
+	[scratch setLength:0];
+	SPSerializerAppendUTF8(scratch, string);
+	SPSerializerAppendCellBytes(buffer, [scratch bytes], [scratch length], escaping);
+}
+
+@implementation SPDataStorageSerializer
+
+@synthesize tableName;
+@synthesize connection;
+@synthesize nullString;
+@synthesize blobFileDirectory;
+@synthesize blobHandling;
+@synthesize displaysBinaryDataAsHex;
+@synthesize includesHeaders;
+@synthesize unloadedValueLoader;
+@synthesize progressHandler;
+
+/**
+ * Initialise a serializer for the supplied data storage.  The columns to serialize
+ * must be set before serializing any rows.
+ */
+- (id)initWithDataStorage:(SPDataStorage *)theDataStorage format:(SPDataStorageSerializationFormat)theFormat
+{
+	if ((self = [super init])) {
+		dataStorage = [theDataStorage retain];
+		format = theFormat;
+
+		numberOfColumns = 0;
+		columnMappings = NULL;
+		columnTypes = NULL;
+		columnNames = nil;
+
+		nullString = [@"NULL" retain];
+		blobHandling = SPDataStorageBlobsIncluded;
+		displaysBinaryDataAsHex = NO;
+		includesHeaders = NO;
+
+		cancelled = NO;
+		aborted = NO;
+	}
+
+	return self;
+}
+
+/**
+ * Set the columns to serialize, in output order: the data storage column index for
+ * each, the names to use for headers and INSERT statements, and - for SQL output -
+ * the type grouping of each column to determine how values are quoted.
+ */
+- (void)setColumns:(NSArray *)storageColumnIndexes names:(NSArray *)names typeGroupings:(NSArray *)typeGroupings
+{
+	if (columnMappings) free(columnMappings);
+	if (columnTypes) free(columnTypes);
+	if (columnNames) SPClear(columnNames);
+
+	numberOfColumns = [storageColumnIndexes count];
+	columnMappings = calloc(numberOfColumns, sizeof(NSUInteger));
+	columnTypes = calloc(numberOfColumns, sizeof(NSUInteger));
+	columnNames = [names copy];
+
+	for (NSUInteger c = 0; c < numberOfColumns; c++) {
+		columnMappings[c] = [[storageColumnIndexes objectAtIndex:c] unsignedIntegerValue];
+
+		NSString *t = (c < [typeGroupings count]) ? [typeGroupings objectAtIndex:c] : nil;
+
+		if ([t isEqualToString:@"bit"] || [t isEqualToString:@"integer"] || [t isEqualToString:@"float"]) {
+			columnTypes[c] = SPSerializerColumnNumeric;
+		}
+		else if ([t isEqualToString:@"blobdata"] || [t isEqualToString:@"textdata"]) {
+			columnTypes[c] = SPSerializerColumnBlob;
+		}
+		else if ([t isEqualToString:@"geometry"]) {
+			columnTypes[c] = SPSerializerColumnGeometry;
+		}
+		else {
+			columnTypes[c] = SPSerializerColumnString;
+		}
+	}
+}
+
+/**
+ * Serialize the supplied rows, returning the resulting string, or nil if the
+ * serialization was cancelled or a value required for SQL output couldn't be
+ * retrieved.
+ */
+- (NSString *)serializeRows:(NSIndexSet *)rowIndexes
+{
+	NSUInteger rowCount = [rowIndexes count];
+	NSUInteger *rows = malloc(sizeof(NSUInteger) * MAX(rowCount, 1));
+
+	[rowIndexes getIndexes:rows maxCount:rowCount inIndexRange:NULL];
+
+	// Blob and geometry files are written in a freshly cleared directory
+	if ([self _writesFiles]) {
+		NSFileManager *fm = [NSFileManager defaultManager];
+		[fm removeItemAtPath:blobFileDirectory error:nil];
+		[fm createDirectoryAtPath:blobFileDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+	}
+
+	// Raw cell bytes can be copied straight into the UTF-8 output for UTF-8 connections
+	useRawBytes = ([connection stringEncoding] == NSUTF8StringEncoding);
+
+	[self _prepareSharedData];
+
+	// File output uses AppKit drawing for images and geometry, so keep it on the calling thread
+	NSString *result = [self _serializeRows:rows count:rowCount concurrently:![self _writesFiles]];
+
+	// If the stored bytes weren't valid UTF-8, fall back to converting each cell
+	if (!result && useRawBytes && !cancelled && !aborted) {
+		useRawBytes = NO;
+		result = [self _serializeRows:rows count:rowCount concurrently:![self _writesFiles]];
+	}
+
+	free(rows);
+
+	return result;
+}
+
+/**
+ * Whether the serialization has been cancelled.
+ */
+- (BOOL)isCancelled
+{
+	return cancelled;
+}
+
+/**
+ * Cancel a running serialization; safe to call from any thread.
+ */
+- (void)cancel
+{
+	cancelled = YES;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Set up the data shared by all rows: the display strings for NULL and unloaded
+ * cells, and for SQL output the start of each INSERT statement.
+ */
+- (void)_prepareSharedData
+{
+	SPSerializerEscaping escaping = SPSerializerEscapeNone;
+	if (format == SPDataStorageSerializeAsCSV) escaping = SPSerializerEscapeCSVQuotes;
+
+	NSMutableData *scratch = [NSMutableData data];
+	NSMutableData *data;
+
+	if (nullStringData) SPClear(nullStringData);
+	data = [NSMutableData data];
+	SPSerializerAppendString(data, nullString, escaping, scratch);
+	nullStringData = [data copy];
+
+	if (notLoadedData) SPClear(notLoadedData);
+	data = [NSMutableData data];
+	SPSerializerAppendString(data, NSLocalizedString(@"(not loaded)", @"value shown for hidden blob and text fields"), escaping, scratch);
+	notLoadedData = [data copy];
+
+	if (insertStatementData) SPClear(insertStatementData);
+	if (format == SPDataStorageSerializeAsSQLInserts) {
+		data = [NSMutableData data];
+		SPSerializerAppendUTF8(data, [NSString stringWithFormat:@"INSERT INTO %@ (%@)\nVALUES\n",
+			[(tableName == nil) ? @"<table>" : tableName backtickQuotedString], [columnNames componentsJoinedAndBacktickQuoted]]);
+		insertStatementData = [data copy];
+	}
+}
+
+/**
+ * Serialize the supplied rows in chunks - concurrently if requested - and join the
+ * chunks, together with any headers, into the resulting string.
+ */
+- (NSString *)_serializeRows:(NSUInteger *)rows count:(NSUInteger)rowCount concurrently:(BOOL)concurrently
+{
+	NSUInteger numberOfChunks = (rowCount + SPDataStorageSerializerRowsPerChunk - 1) / SPDataStorageSerializerRowsPerChunk;
+	NSMutableData **chunkBuffers = calloc(MAX(numberOfChunks, 1), sizeof(NSMutableData *));
+
+	rowsSerialized = 0;
+
+	void (^serializeChunk)(size_t) = ^(size_t chunkIndex) {
+		@autoreleasepool {
+			NSUInteger firstRow = chunkIndex * SPDataStorageSerializerRowsPerChunk;
+			NSUInteger chunkRowCount = MIN(SPDataStorageSerializerRowsPerChunk, rowCount - firstRow);
+			NSMutableData *chunkBuffer = [[NSMutableData alloc] initWithCapacity:chunkRowCount * MAX(numberOfColumns, 1) * 16];
+			BOOL success;
+
+			if (format == SPDataStorageSerializeAsSQLInserts) {
+				success = [self _serializeSQLRows:rows + firstRow count:chunkRowCount intoBuffer:chunkBuffer];
+			}
+			else {
+				success = [self _serializeTextRows:rows + firstRow count:chunkRowCount firstOrdinal:firstRow intoBuffer:chunkBuffer];
+			}
+
+			if (success) {
+				chunkBuffers[chunkIndex] = chunkBuffer;
+			}
+			else {
+				[chunkBuffer release];
+			}
+
+			int64_t serializedCount = OSAtomicAdd64Barrier((int64_t)chunkRowCount, &rowsSerialized);
+
+			if (progressHandler) progressHandler((CGFloat)serializedCount / (CGFloat)rowCount);
+		}
+	};
+
+	if (concurrently && numberOfChunks > 1) {
+		dispatch_apply(numberOfChunks, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), serializeChunk);
+	}
+	else {
+		for (NSUInteger i = 0; i < numberOfChunks; i++) serializeChunk(i);
+	}
+
+	NSMutableData *result = nil;
+
+	if (!cancelled && !aborted) {
+		NSUInteger resultLength = 0;
+		for (NSUInteger i = 0; i < numberOfChunks; i++) resultLength += [chunkBuffers[i] length] + 1;
+
+		result = [NSMutableData dataWithCapacity:resultLength + 1024];
+
+		// Add the column headers if requested
+		if (includesHeaders && format != SPDataStorageSerializeAsSQLInserts) {
+			NSMutableData *scratch = [NSMutableData data];
+
+			for (NSUInteger c = 0; c < numberOfColumns; c++) {
+				if (format == SPDataStorageSerializeAsCSV) {
+					[result appendBytes:(c ? ",\"" : "\"") length:(c ? 2 : 1)];
+					SPSerializerAppendString(result, [columnNames objectAtIndex:c], SPSerializerEscapeCSVQuotes, scratch);
+					[result appendBytes:"\"" length:1];
+				}
+				else {
+					if (c) [result appendBytes:"\t" length:1];
+					SPSerializerAppendUTF8(result, [columnNames objectAtIndex:c]);
+				}
+			}
+
+			if (numberOfChunks) [result appendBytes:"\n" length:1];
+		}
+
+		// Join the chunks; SQL chunks each end with a complete statement, so are separated
+		// by a blank line, while text chunks need a line break between the rows.
+		for (NSUInteger i = 0; i < numberOfChunks; i++) {
+			if (i) [result appendBytes:"\n" length:1];
+			[result appendData:chunkBuffers[i]];
+			SPClear(chunkBuffers[i]);
+		}
+	}
+
+	for (NSUInteger i = 0; i < numberOfChunks; i++) {
+		if (chunkBuffers[i]) SPClear(chunkBuffers[i]);
+	}
+	free(chunkBuffers);
+
+	if (!result) return nil;
+
+	return [[[NSString alloc] initWithData:result encoding:NSUTF8StringEncoding] autorelease];
+}
+
+/**
+ * Serialize rows as tab-separated or CSV text, without a trailing line break.
+ */
+- (BOOL)_serializeTextRows:(NSUInteger *)rows count:(NSUInteger)rowCount firstOrdinal:(NSUInteger)firstOrdinal intoBuffer:(NSMutableData *)buffer
+{
+	const char *separator = (format == SPDataStorageSerializeAsCSV) ? "," : "\t";
+	BOOL isCSV = (format == SPDataStorageSerializeAsCSV);
+	SPSerializerEscaping escaping = SPSerializerEscapeNone;
+	NSMutableData *scratch = [NSMutableData data];
+	NSMutableData *rowBytes = useRawBytes ? [NSMutableData data] : nil;
+	id *cellObjects = malloc(sizeof(id) * MAX(numberOfColumns, 1));
+	NSRange *cellRanges = malloc(sizeof(NSRange) * MAX(numberOfColumns, 1));
+	BOOL success = YES;
+
+	if (isCSV) escaping = SPSerializerEscapeCSVQuotes;
+	else if (format == SPDataStorageSerializeAsTabText) escaping = SPSerializerEscapeControlChars;
+
+	for (NSUInteger i = 0; i < rowCount; i++) {
+		if (cancelled) {
+			success = NO;
+			break;
+		}
+
+		if (i) [buffer appendBytes:"\n" length:1];
+
+		// Retrieve all the cells of the row while locking the data storage once
+		[rowBytes setLength:0];
+		[dataStorage getCellsAtRow:rows[i] columns:columnMappings count:numberOfColumns objects:cellObjects stringBytes:rowBytes ranges:cellRanges];
+
+		for (NSUInteger c = 0; c < numberOfColumns; c++) {
+			if (c) [buffer appendBytes:separator length:1];
+
+			// Copy the stored bytes directly where possible
+			if (cellRanges[c].location != NSNotFound) {
+				if (isCSV) [buffer appendBytes:"\"" length:1];
+				SPSerializerAppendCellBytes(buffer, (const char *)[rowBytes bytes] + cellRanges[c].location, cellRanges[c].length, escaping);
+				if (isCSV) [buffer appendBytes:"\"" length:1];
+				continue;
+			}
+
+			[self _appendTextValue:cellObjects[c] forRow:rows[i] column:c ordinal:firstOrdinal + i toBuffer:buffer scratchBuffer:scratch];
+		}
+	}
+
+	free(cellObjects);
+	free(cellRanges);
+
+	return success;
+}
+
+/**
+ * Serialize rows as one or more complete INSERT statements, starting a new statement
+ * every ~250k of data.
+ */
+- (BOOL)_serializeSQLRows:(NSUInteger *)rows count:(NSUInteger)rowCount intoBuffer:(NSMutableData *)buffer
+{
+	NSUInteger statementStart = [buffer length];
+	NSMutableData *rowBytes = useRawBytes ? [NSMutableData data] : nil;
+	id *cellObjects = malloc(sizeof(id) * MAX(numberOfColumns, 1));
+	NSRange *cellRanges = malloc(sizeof(NSRange) * MAX(numberOfColumns, 1));
+	BOOL success = YES;
+
+	[buffer appendData:insertStatementData];
+
+	for (NSUInteger i = 0; i < rowCount && success; i++) {
+		if (cancelled || aborted) {
+			success = NO;
+			break;
+		}
+
+		// Close the previous VALUES group, starting a new INSERT if appropriate
+		if (i) {
+			if ([buffer length] - statementStart > SPDataStorageSerializerMaxInsertLength) {
+				[buffer appendBytes:");\n\n" length:4];
+				statementStart = [buffer length];
+				[buffer appendData:insertStatementData];
+			}
+			else {
+				[buffer appendBytes:"),\n" length:3];
+			}
+		}
+
+		[buffer appendBytes:"\t(" length:2];
+
+		// Retrieve all the cells of the row while locking the data storage once
+		[rowBytes setLength:0];
+		[dataStorage getCellsAtRow:rows[i] columns:columnMappings count:numberOfColumns objects:cellObjects stringBytes:rowBytes ranges:cellRanges];
+
+		for (NSUInteger c = 0; c < numberOfColumns; c++) {
+			if (c) [buffer appendBytes:", " length:2];
+
+			const char *bytes = (cellRanges[c].location != NSNotFound) ? (const char *)[rowBytes bytes] + cellRanges[c].location : NULL;
+
+			if (![self _appendSQLValue:cellObjects[c] stringBytes:bytes length:cellRanges[c].length forRow:rows[i] column:c toBuffer:buffer]) {
+				aborted = YES;
+				success = NO;
+				break;
+			}
+		}
+	}
+
+	free(cellObjects);
+	free(cellRanges);
+
+	if (!success) return NO;
+
+	[buffer appendBytes:");\n" length:3];
+
+	return YES;
+}
+
+/**
+ * Append the shown representation of a cell for text output - custom NULL display
+ * strings, (not loaded), and the chosen representation of any blobs or binary texts.
+ */
+- (void)_appendTextValue:(id)cellData forRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex ordinal:(NSUInteger)ordinal toBuffer:(NSMutableData *)buffer scratchBuffer:(NSMutableData *)scratch
+{
+	NSUInteger storageColumn = columnMappings[columnIndex];
+	BOOL isCSV = (format == SPDataStorageSerializeAsCSV);
+	SPSerializerEscaping escaping = SPSerializerEscapeNone;
+
+	if (isCSV) escaping = SPSerializerEscapeCSVQuotes;
+	else if (format == SPDataStorageSerializeAsTabText) escaping = SPSerializerEscapeControlChars;
+
+	// Partially loaded values may be retrieved if a loader is available
+	if ([cellData isSPNotLoaded] && unloadedValueLoader) {
+		id loadedData = [self _loadUnloadedValueForRow:rowIndex column:storageColumn];
+		if (loadedData) cellData = loadedData;
+	}
+
+	if (!cellData) return;
+
+	if (isCSV) [buffer appendBytes:"\"" length:1];
+
+	if ([cellData isNSNull]) {
+		[buffer appendData:nullStringData];
+	}
+	else if ([cellData isSPNotLoaded]) {
+		[buffer appendData:notLoadedData];
+	}
+	else if ([cellData isKindOfClass:[NSData class]]) {
+		[self _appendBlob:cellData ordinal:ordinal column:columnIndex toBuffer:buffer scratchBuffer:scratch];
+	}
+	else if ([cellData isKindOfClass:[SPMySQLGeometryData class]]) {
+		[self _appendGeometry:cellData ordinal:ordinal column:columnIndex toBuffer:buffer scratchBuffer:scratch];
+	}
+	else {
+		SPSerializerAppendString(buffer, [cellData description], escaping, scratch);
+	}
+
+	if (isCSV) [buffer appendBytes:"\"" length:1];
+}
+
+/**
+ * Append the representation of a blob for text output, writing it to a file first
+ * if requested.
+ */
+- (void)_appendBlob:(NSData *)blobData ordinal:(NSUInteger)ordinal column:(NSUInteger)columnIndex toBuffer:(NSMutableData *)buffer scratchBuffer:(NSMutableData *)scratch
+{
+	SPSerializerEscaping escaping = (format == SPDataStorageSerializeAsCSV) ? SPSerializerEscapeCSVQuotes : SPSerializerEscapeNone;
+
+	if (format == SPDataStorageSerializeAsDraggedTabText || blobHandling == SPDataStorageBlobsIncluded) {
+		NSString *displayString;
+
+		if (displaysBinaryDataAsHex) {
+			displayString = [[NSString alloc] initWithFormat:@"0x%@", [blobData dataToHexString]];
+		}
+		else {
+			displayString = [[NSString alloc] initWithData:blobData encoding:[connection stringEncoding]];
+		}
+
+		if (!displayString) displayString = [[NSString alloc] initWithData:blobData encoding:NSISOLatin1StringEncoding];
+
+		if (displayString) {
+			SPSerializerAppendString(buffer, displayString, escaping, scratch);
+			[displayString release];
+		}
+	}
+	else if (blobHandling == SPDataStorageBlobsAsFiles && [self _writesFiles]) {
+		NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.dat", blobFileDirectory, (long)ordinal, (long)columnIndex];
+
+		[blobData writeToFile:fp atomically:NO];
+
+		SPSerializerAppendString(buffer, fp, escaping, scratch);
+	}
+	else if (blobHandling == SPDataStorageBlobsAsImageFile && [self _writesFiles]) {
+		NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.tif", blobFileDirectory, (long)ordinal, (long)columnIndex];
+		NSImage *image = [[NSImage alloc] initWithData:blobData];
+
+		if (image) {
+			NSData *d = [[NSData alloc] initWithData:[image TIFFRepresentationUsingCompression:NSTIFFCompressionLZW factor:1]];
+			[d writeToFile:fp atomically:NO];
+			if (d) SPClear(d);
+			[image release];
+		}
+		else {
+			NSString *noData = @"";
+			[noData writeToFile:fp atomically:NO encoding:NSUTF8StringEncoding error:NULL];
+		}
+
+		SPSerializerAppendString(buffer, fp, escaping, scratch);
+	}
+	else {
+		[buffer appendBytes:"BLOB" length:4];
+	}
+}
+
+/**
+ * Append the representation of a geometry value for text output - as a PDF file if
+ * files are being written, or as WKT otherwise.
+ */
+- (void)_appendGeometry:(SPMySQLGeometryData *)geometryData ordinal:(NSUInteger)ordinal column:(NSUInteger)columnIndex toBuffer:(NSMutableData *)buffer scratchBuffer:(NSMutableData *)scratch
+{
+	SPSerializerEscaping escaping = (format == SPDataStorageSerializeAsCSV) ? SPSerializerEscapeCSVQuotes : SPSerializerEscapeNone;
+
+	if (format != SPDataStorageSerializeAsDraggedTabText && [self _writesFiles]) {
+		NSString *fp = [NSString stringWithFormat:@"%@/%ld_%ld.pdf", blobFileDirectory, (long)ordinal, (long)columnIndex];
+		SPGeometryDataView *v = [[SPGeometryDataView alloc] initWithCoordinates:[geometryData coordinates]];
+		NSData *thePDF = [v pdfData];
+
+		if (thePDF) {
+			[thePDF writeToFile:fp atomically:NO];
+			SPSerializerAppendString(buffer, fp, escaping, scratch);
+		}
+		else {
+			SPSerializerAppendString(buffer, [geometryData wktString], escaping, scratch);
+		}
+
+		if (v) SPClear(v);
+	}
+	else {
+		SPSerializerAppendString(buffer, [geometryData wktString], escaping, scratch);
+	}
+}
+
+/**
+ * Append a cell value for SQL output, quoted and escaped according to the column
+ * type.  The value is supplied either as the cell contents, or as raw UTF-8 bytes
+ * for cells held as strings.  Returns NO if the value couldn't be determined.
+ */
+- (BOOL)_appendSQLValue:(id)cellData stringBytes:(const char *)bytes length:(NSUInteger)length forRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex toBuffer:(NSMutableData *)buffer
+{
+	NSUInteger storageColumn = columnMappings[columnIndex];
+
+	if (bytes) {
+
+		// Numeric values are used unquoted, so can be copied straight from the stored bytes
+		if (columnTypes[columnIndex] == SPSerializerColumnNumeric) {
+			[buffer appendBytes:bytes length:length];
+			return YES;
+		}
+
+		// Other values are escaped through the connection, so need decoding
+		cellData = [[[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding] autorelease];
+		if (!cellData) cellData = SPDataStorageObjectAtRowAndColumn(dataStorage, rowIndex, storageColumn);
+	}
+
+	// If the data is not loaded, attempt to fetch the value
+	if ([cellData isSPNotLoaded] && unloadedValueLoader) {
+		cellData = [self _loadUnloadedValueForRow:rowIndex column:storageColumn];
+	}
+
+	if (!cellData) return NO;
+
+	if ([cellData isNSNull]) {
+		[buffer appendBytes:"NULL" length:4];
+		return YES;
+	}
+
+	NSString *value = nil;
+
+	switch (columnTypes[columnIndex]) {
+
+		// Convert numeric types to unquoted strings
+		case SPSerializerColumnNumeric:
+			value = [cellData description];
+			break;
+
+		// Quote string, text and blob types appropriately
+		case SPSerializerColumnString:
+		case SPSerializerColumnBlob:
+			if ([cellData isKindOfClass:[NSData class]]) {
+				value = [connection escapeAndQuoteData:cellData];
+			}
+			else {
+				value = [connection escapeAndQuoteString:[cellData description]];
+			}
+			break;
+
+		case SPSerializerColumnGeometry:
+			value = [connection escapeAndQuoteData:[cellData data]];
+			break;
+	}
+
+	if (!value) return NO;
+
+	SPSerializerAppendUTF8(buffer, value);
+
+	return YES;
+}
+
+/**
+ * Retrieve an unloaded value using the loader, serializing the calls as the loader
+ * will usually need to query the server.
+ */
+- (id)_loadUnloadedValueForRow:(NSUInteger)rowIndex column:(NSUInteger)storageColumnIndex
+{
+	@synchronized(self) {
+		if (cancelled) return nil;
+
+		return unloadedValueLoader(rowIndex, storageColumnIndex);
+	}
+}
+
+/**
+ * Whether blobs or geometry values are written out to files.
+ */
+- (BOOL)_writesFiles
+{
+	return ((blobHandling == SPDataStorageBlobsAsFiles || blobHandling == SPDataStorageBlobsAsImageFile) && [blobFileDirectory length]);
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	if (columnMappings) free(columnMappings);
+	if (columnTypes) free(columnTypes);
+
+	SPClear(dataStorage);
+	if (columnNames) SPClear(columnNames);
+	if (tableName) SPClear(tableName);
+	if (nullString) SPClear(nullString);
+	if (blobFileDirectory) SPClear(blobFileDirectory);
+	if (unloadedValueLoader) [unloadedValueLoader release], unloadedValueLoader = nil;
+	if (progressHandler) [progressHandler release], progressHandler = nil;
+	if (nullStringData) SPClear(nullStringData);
+	if (notLoadedData) SPClear(notLoadedData);
+	if (insertStatementData) SPClear(insertStatementData);
+
+	[super dealloc];
+}
+
+@end
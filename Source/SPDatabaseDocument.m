@@ -6653,6 +6653,9 @@ static BOOL isOSAtLeast10_14;
  */
 - (void)setContentRequiresReload:(BOOL)reload
 {
+	// Row counts cached for the database may no longer be valid
+	if (reload) [tableDataInstance invalidateCachedNumberOfRows];
+
 	if (reload && selectedTableName
 #ifndef SP_CODA /* check which tab is selected */
 	    && [self currentlySelectedView] == SPTableViewContent
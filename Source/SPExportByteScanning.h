@@ -0,0 +1,111 @@
+//
+//  SPExportByteScanning.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#if defined(__SSE2__)
+#import <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#import <arm_neon.h>
+#endif
+
+/**
+ * Returns the index of the first byte which matches any of the up to four bytes in the supplied
+ * set, or the length if there is none.  Compares 16 bytes at a time where SSE2 or NEON is available,
+ * so exporters can copy runs of bytes which need no escaping directly.
+ */
+static inline NSUInteger SPExportFindByteInSet(const char *bytes, NSUInteger length, const unsigned char *byteSet, NSUInteger byteSetCount)
+{
+	NSUInteger i = 0, j;
+
+	if (!byteSetCount) return length;
+
+#if defined(__SSE2__)
+	__m128i needles[4];
+
+	for (j = 0; j < 4; j++) needles[j] = _mm_set1_epi8((char)byteSet[j < byteSetCount ? j : 0]);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + i));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, needles[0]), _mm_cmpeq_epi8(chunk, needles[1])),
+		                               _mm_or_si128(_mm_cmpeq_epi8(chunk, needles[2]), _mm_cmpeq_epi8(chunk, needles[3])));
+		int mask = _mm_movemask_epi8(matches);
+
+		if (mask) return i + __builtin_ctz(mask);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	uint8x16_t needles[4];
+
+	for (j = 0; j < 4; j++) needles[j] = vdupq_n_u8(byteSet[j < byteSetCount ? j : 0]);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t chunk = vld1q_u8((const uint8_t *)(bytes + i));
+		uint8x16_t matches = vorrq_u8(vorrq_u8(vceqq_u8(chunk, needles[0]), vceqq_u8(chunk, needles[1])),
+		                              vorrq_u8(vceqq_u8(chunk, needles[2]), vceqq_u8(chunk, needles[3])));
+
+		// Locate the match within the chunk in the bytewise loop below
+		if (vmaxvq_u8(matches)) break;
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		for (j = 0; j < byteSetCount; j++)
+		{
+			if ((unsigned char)bytes[i] == byteSet[j]) return i;
+		}
+	}
+
+	return length;
+}
+
+/**
+ * Returns whether the supplied encoding writes the ASCII characters as single bytes which cannot
+ * occur within any other character, so that ASCII delimiters can be found and escaped bytewise.
+ */
+static inline BOOL SPExportEncodingIsASCIICompatible(NSStringEncoding encoding)
+{
+	switch (encoding)
+	{
+		case NSUTF8StringEncoding:
+		case NSASCIIStringEncoding:
+		case NSISOLatin1StringEncoding:
+		case NSISOLatin2StringEncoding:
+		case NSWindowsCP1250StringEncoding:
+		case NSWindowsCP1251StringEncoding:
+		case NSWindowsCP1252StringEncoding:
+		case NSWindowsCP1253StringEncoding:
+		case NSWindowsCP1254StringEncoding:
+		case NSMacOSRomanStringEncoding:
+			return YES;
+		default:
+			return NO;
+	}
+}
@@ -0,0 +1,79 @@
+//
+//  SPExportCheckpoint.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+// Keys of the partial table dump dictionaries
+extern NSString *SPExportCheckpointDumpLengthKey;
+extern NSString *SPExportCheckpointKeyColumnKey;
+extern NSString *SPExportCheckpointKeyBoundKey;
+extern NSString *SPExportCheckpointRowCountKey;
+
+/**
+ * @class SPExportCheckpoint SPExportCheckpoint.h
+ *
+ * Records the progress of a long running SQL export in a manifest, so that an export which stops part way
+ * through - for example after losing its connection - can be resumed instead of restarted.
+ *
+ * The checkpoint is kept in a directory alongside the export file.  Its manifest records the export settings,
+ * the tables whose dumps are complete, and the length of the export file at its last durable checkpoint, at
+ * which any compression stream has been ended so the file can be truncated and appended to.  For tables
+ * dumped concurrently by key range, the manifest also records the completed part of each table's dump, which
+ * is kept in the checkpoint directory until it has been appended to the export file.
+ *
+ * The manifest is replaced atomically on each update; all methods are thread safe.
+ */
+@interface SPExportCheckpoint : NSObject
+{
+	NSString *exportFilePath;
+	NSString *checkpointPath;
+
+	NSMutableDictionary *manifest;
+}
+
++ (SPExportCheckpoint *)checkpointForExportFileAtPath:(NSString *)path;
+
+- (id)initWithExportFilePath:(NSString *)path;
+
+- (BOOL)beginWithSettings:(NSDictionary *)settings tableNames:(NSArray *)tableNames;
+- (BOOL)loadWithSettings:(NSDictionary *)settings;
+- (void)remove;
+
+- (unsigned long long)exportFileOffset;
+- (NSArray *)completedTables;
+- (NSDictionary *)viewSyntaxes;
+- (NSString *)errors;
+
+- (NSString *)dumpPathForTable:(NSString *)tableName;
+- (NSDictionary *)partialDumpForTable:(NSString *)tableName;
+
+- (void)recordExportFileOffset:(unsigned long long)offset;
+- (void)recordCompletedTable:(NSString *)tableName exportFileOffset:(unsigned long long)offset viewSyntaxes:(NSDictionary *)viewSyntaxes errors:(NSString *)errors;
+- (void)recordPartialDumpOfTable:(NSString *)tableName length:(unsigned long long)length keyColumn:(NSString *)keyColumn keyBound:(NSString *)keyBound rowCount:(NSUInteger)rowCount;
+
+@end
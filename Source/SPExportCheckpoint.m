@@ -0,0 +1,358 @@
+//
+//  SPExportCheckpoint.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportCheckpoint.h"
+
+// The version of the manifest format; manifests of other versions are not resumed
+static const NSInteger SPExportCheckpointVersion = 1;
+
+static NSString *SPExportCheckpointDirectoryExtension = @"checkpoint";
+static NSString *SPExportCheckpointManifestName       = @"Manifest.plist";
+
+// Manifest keys
+static NSString *SPExportCheckpointVersionKey          = @"Version";
+static NSString *SPExportCheckpointSettingsKey         = @"Settings";
+static NSString *SPExportCheckpointTableNamesKey       = @"TableNames";
+static NSString *SPExportCheckpointFileOffsetKey       = @"ExportFileOffset";
+static NSString *SPExportCheckpointCompletedTablesKey  = @"CompletedTables";
+static NSString *SPExportCheckpointViewSyntaxesKey     = @"ViewSyntaxes";
+static NSString *SPExportCheckpointErrorsKey           = @"Errors";
+static NSString *SPExportCheckpointPartialDumpsKey     = @"PartialDumps";
+
+NSString *SPExportCheckpointDumpLengthKey = @"DumpLength";
+NSString *SPExportCheckpointKeyColumnKey  = @"KeyColumn";
+NSString *SPExportCheckpointKeyBoundKey   = @"KeyBound";
+NSString *SPExportCheckpointRowCountKey   = @"RowCount";
+
+@interface SPExportCheckpoint ()
+
+- (NSString *)_manifestPath;
+- (BOOL)_writeManifest;
+
+@end
+
+@implementation SPExportCheckpoint
+
+/**
+ * Returns an autoreleased checkpoint for the export file at the supplied path.
+ */
++ (SPExportCheckpoint *)checkpointForExportFileAtPath:(NSString *)path
+{
+	return [[[SPExportCheckpoint alloc] initWithExportFilePath:path] autorelease];
+}
+
+/**
+ * Initialise a checkpoint for the export file at the supplied path.  The checkpoint
+ * directory is named after the export file, in the same folder.
+ *
+ * @param path The path of the export file
+ */
+- (id)initWithExportFilePath:(NSString *)path
+{
+	if ((self = [super init])) {
+		exportFilePath = [path copy];
+		checkpointPath = [[path stringByAppendingPathExtension:SPExportCheckpointDirectoryExtension] retain];
+
+		manifest = nil;
+	}
+
+	return self;
+}
+
+/**
+ * Start a new checkpoint for an export, replacing any previous checkpoint of the file.
+ *
+ * @param settings   The export settings, which must match for the export to be resumed
+ * @param tableNames The names of the tables being exported, in order
+ *
+ * @return NO if the checkpoint could not be created
+ */
+- (BOOL)beginWithSettings:(NSDictionary *)settings tableNames:(NSArray *)tableNames
+{
+	@synchronized(self) {
+		NSFileManager *fileManager = [NSFileManager defaultManager];
+
+		[fileManager removeItemAtPath:checkpointPath error:NULL];
+
+		if (![fileManager createDirectoryAtPath:checkpointPath withIntermediateDirectories:NO attributes:nil error:NULL]) {
+			NSLog(@"SPExportCheckpoint could not create the checkpoint directory %@", checkpointPath);
+			return NO;
+		}
+
+		if (manifest) SPClear(manifest);
+
+		manifest = [[NSMutableDictionary alloc] init];
+
+		[manifest setObject:@(SPExportCheckpointVersion) forKey:SPExportCheckpointVersionKey];
+		[manifest setObject:settings forKey:SPExportCheckpointSettingsKey];
+		[manifest setObject:tableNames forKey:SPExportCheckpointTableNamesKey];
+		[manifest setObject:@0ULL forKey:SPExportCheckpointFileOffsetKey];
+		[manifest setObject:[NSMutableArray array] forKey:SPExportCheckpointCompletedTablesKey];
+		[manifest setObject:[NSDictionary dictionary] forKey:SPExportCheckpointViewSyntaxesKey];
+		[manifest setObject:@"" forKey:SPExportCheckpointErrorsKey];
+		[manifest setObject:[NSMutableDictionary dictionary] forKey:SPExportCheckpointPartialDumpsKey];
+
+		return [self _writeManifest];
+	}
+}
+
+/**
+ * Load the manifest of a previous export of the file, checking that it can be resumed: the manifest
+ * must be readable and of the current version, the export settings must match, and the export file
+ * must still hold the data up to the last checkpoint.
+ *
+ * @param settings The settings of the export which is to be resumed
+ *
+ * @return YES if the export can be resumed from the checkpoint
+ */
+- (BOOL)loadWithSettings:(NSDictionary *)settings
+{
+	@synchronized(self) {
+		NSData *manifestData = [NSData dataWithContentsOfFile:[self _manifestPath]];
+
+		if (!manifestData) return NO;
+
+		NSMutableDictionary *loadedManifest = [NSPropertyListSerialization propertyListWithData:manifestData options:NSPropertyListMutableContainers format:NULL error:NULL];
+
+		if (![loadedManifest isKindOfClass:[NSMutableDictionary class]]) return NO;
+
+		if ([[loadedManifest objectForKey:SPExportCheckpointVersionKey] integerValue] != SPExportCheckpointVersion) return NO;
+
+		if (![[loadedManifest objectForKey:SPExportCheckpointSettingsKey] isEqual:settings]) return NO;
+
+		// Nothing can be resumed until the dump header has been checkpointed
+		unsigned long long offset = [[loadedManifest objectForKey:SPExportCheckpointFileOffsetKey] unsignedLongLongValue];
+
+		if (!offset) return NO;
+
+		NSDictionary *fileAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:exportFilePath error:NULL];
+
+		if (!fileAttributes || [fileAttributes fileSize] < offset) return NO;
+
+		if (manifest) SPClear(manifest);
+
+		manifest = [loadedManifest retain];
+
+		return YES;
+	}
+}
+
+/**
+ * Remove the checkpoint directory, including any partial table dumps.
+ */
+- (void)remove
+{
+	@synchronized(self) {
+		[[NSFileManager defaultManager] removeItemAtPath:checkpointPath error:NULL];
+
+		if (manifest) SPClear(manifest);
+	}
+}
+
+#pragma mark -
+#pragma mark Checkpoint state
+
+/**
+ * Returns the length of the export file at the last checkpoint.
+ */
+- (unsigned long long)exportFileOffset
+{
+	@synchronized(self) {
+		return [[manifest objectForKey:SPExportCheckpointFileOffsetKey] unsignedLongLongValue];
+	}
+}
+
+/**
+ * Returns the names of the tables which had been appended to the export file at the last checkpoint.
+ */
+- (NSArray *)completedTables
+{
+	@synchronized(self) {
+		return [[[manifest objectForKey:SPExportCheckpointCompletedTablesKey] copy] autorelease];
+	}
+}
+
+/**
+ * Returns the deferred view syntaxes collected up to the last checkpoint.
+ */
+- (NSDictionary *)viewSyntaxes
+{
+	@synchronized(self) {
+		return [[[manifest objectForKey:SPExportCheckpointViewSyntaxesKey] copy] autorelease];
+	}
+}
+
+/**
+ * Returns the export errors which had occurred at the last checkpoint.
+ */
+- (NSString *)errors
+{
+	@synchronized(self) {
+		return [[[manifest objectForKey:SPExportCheckpointErrorsKey] copy] autorelease];
+	}
+}
+
+/**
+ * Returns the path a table is dumped to before being appended to the export file.  The file is
+ * named by the table's position in the export, so it is found again when the export is resumed.
+ */
+- (NSString *)dumpPathForTable:(NSString *)tableName
+{
+	@synchronized(self) {
+		NSUInteger tableIndex = [[manifest objectForKey:SPExportCheckpointTableNamesKey] indexOfObject:tableName];
+
+		if (tableIndex == NSNotFound) return nil;
+
+		return [checkpointPath stringByAppendingPathComponent:[NSString stringWithFormat:@"Table-%lu.sql", (unsigned long)tableIndex]];
+	}
+}
+
+/**
+ * Returns the completed part of a table's dump recorded at the last checkpoint, as a dictionary of
+ * the dump's length, the key column and the upper bound of the key ranges it holds, and the number of
+ * rows it holds; or nil if none was recorded or the dump file no longer holds it.
+ */
+- (NSDictionary *)partialDumpForTable:(NSString *)tableName
+{
+	@synchronized(self) {
+		NSDictionary *partialDump = [[manifest objectForKey:SPExportCheckpointPartialDumpsKey] objectForKey:tableName];
+
+		if (!partialDump) return nil;
+
+		NSDictionary *fileAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[self dumpPathForTable:tableName] error:NULL];
+
+		if (!fileAttributes || [fileAttributes fileSize] < [[partialDump objectForKey:SPExportCheckpointDumpLengthKey] unsignedLongLongValue]) return nil;
+
+		return [[partialDump copy] autorelease];
+	}
+}
+
+#pragma mark -
+#pragma mark Recording progress
+
+/**
+ * Record the length of the export file once its contents up to that point have been made durable.
+ */
+- (void)recordExportFileOffset:(unsigned long long)offset
+{
+	@synchronized(self) {
+		if (!manifest) return;
+
+		[manifest setObject:@(offset) forKey:SPExportCheckpointFileOffsetKey];
+
+		[self _writeManifest];
+	}
+}
+
+/**
+ * Record that a table's dump has been appended to the export file, along with the export state at
+ * that point.
+ *
+ * @param tableName    The name of the table
+ * @param offset       The length of the export file, which must already be durable
+ * @param viewSyntaxes The deferred view syntaxes collected so far
+ * @param errors       The export errors so far
+ */
+- (void)recordCompletedTable:(NSString *)tableName exportFileOffset:(unsigned long long)offset viewSyntaxes:(NSDictionary *)viewSyntaxes errors:(NSString *)errors
+{
+	@synchronized(self) {
+		if (!manifest) return;
+
+		[[manifest objectForKey:SPExportCheckpointCompletedTablesKey] addObject:tableName];
+		[[manifest objectForKey:SPExportCheckpointPartialDumpsKey] removeObjectForKey:tableName];
+
+		[manifest setObject:@(offset) forKey:SPExportCheckpointFileOffsetKey];
+		[manifest setObject:viewSyntaxes forKey:SPExportCheckpointViewSyntaxesKey];
+		[manifest setObject:errors forKey:SPExportCheckpointErrorsKey];
+
+		[self _writeManifest];
+	}
+}
+
+/**
+ * Record the completed part of a table dump which is read in key ranges.
+ *
+ * @param tableName The name of the table
+ * @param length    The length of the table's dump file, which must already be durable
+ * @param keyColumn The column the table is read in key ranges of
+ * @param keyBound  The quoted upper bound of the last key range in the dump
+ * @param rowCount  The number of rows in the dump
+ */
+- (void)recordPartialDumpOfTable:(NSString *)tableName length:(unsigned long long)length keyColumn:(NSString *)keyColumn keyBound:(NSString *)keyBound rowCount:(NSUInteger)rowCount
+{
+	@synchronized(self) {
+		if (!manifest) return;
+
+		[[manifest objectForKey:SPExportCheckpointPartialDumpsKey] setObject:@{
+			SPExportCheckpointDumpLengthKey : @(length),
+			SPExportCheckpointKeyColumnKey  : keyColumn,
+			SPExportCheckpointKeyBoundKey   : keyBound,
+			SPExportCheckpointRowCountKey   : @(rowCount)
+		} forKey:tableName];
+
+		[self _writeManifest];
+	}
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (NSString *)_manifestPath
+{
+	return [checkpointPath stringByAppendingPathComponent:SPExportCheckpointManifestName];
+}
+
+/**
+ * Atomically replace the manifest on disk with the current state.
+ */
+- (BOOL)_writeManifest
+{
+	NSError *error = nil;
+	NSData *manifestData = [NSPropertyListSerialization dataWithPropertyList:manifest format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+
+	if (manifestData && [manifestData writeToFile:[self _manifestPath] options:NSDataWritingAtomic error:&error]) return YES;
+
+	NSLog(@"SPExportCheckpoint could not write the manifest %@: %@", [self _manifestPath], [error localizedDescription]);
+
+	return NO;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(exportFilePath);
+	SPClear(checkpointPath);
+	if (manifest) SPClear(manifest);
+
+	[super dealloc];
+}
+
+@end
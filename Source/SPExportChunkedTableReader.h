@@ -0,0 +1,117 @@
+//
+//  SPExportChunkedTableReader.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMySQLConnection, SPExportConnectionPool;
+
+/**
+ * @class SPExportChunkedTableReader SPExportChunkedTableReader.h
+ *
+ * Reads the rows of a large table for export by splitting it into ranges of its single-column primary
+ * key. Each range is found with a boundary query seeking a chunk's length along the key, and fetched
+ * on the table's connection or on any idle connection from the export connection pool, so several
+ * ranges are read concurrently within the pool's shared snapshot. The chunk length adapts to the
+ * measured fetch throughput, within a maximum size in bytes.
+ *
+ * Rows are returned in key range order, like a streaming result: fetched chunks wait in a reorder
+ * buffer, bounded to a few chunks and a maximum size ahead of the reader, until all preceding
+ * chunks have been read.
+ */
+@interface SPExportChunkedTableReader : NSObject
+{
+	NSString *tableName;
+	NSString *keyColumnName;
+	NSString *selectColumns;
+
+	SPMySQLConnection *tableConnection;
+	SPExportConnectionPool *connectionPool;
+
+	NSCondition *chunkCondition;
+	NSMutableDictionary *fetchedChunks;
+	NSArray *fieldNames;
+	NSString *lastErrorMessage;
+	NSString *lastChunkUpperBound;
+	NSMutableDictionary *chunkUpperBounds;
+	NSMutableDictionary *chunkByteLengths;
+	NSString *completedKeyBound;
+
+	NSUInteger chunkLength;
+	BOOL adaptsChunkLength;
+	NSUInteger maximumBufferedBytes;
+	NSUInteger nextChunkIndex;
+	NSUInteger readChunkIndex;
+	NSUInteger activeFetchers;
+	NSUInteger bufferedChunkBytes;
+
+	NSArray *currentChunkRows;
+	NSUInteger currentChunkRowIndex;
+
+	NSUInteger processedRowCount;
+	double dataWaitTime;
+
+	BOOL allChunksClaimed;
+	BOOL seekingChunkBoundary;
+	BOOL cancelled;
+}
+
+/**
+ * @property chunkLength The number of rows the next chunk is sought to hold; may be set before reading starts
+ */
+@property (readwrite, assign) NSUInteger chunkLength;
+
+/**
+ * @property adaptsChunkLength Whether the chunk length adapts to the measured fetch throughput; defaults to YES
+ */
+@property (readwrite, assign) BOOL adaptsChunkLength;
+
+/**
+ * @property maximumBufferedBytes The size of the fetched chunks waiting for the reader beyond which no further
+ *                                chunks are claimed
+ */
+@property (readwrite, assign) NSUInteger maximumBufferedBytes;
+
++ (NSString *)chunkingKeyForTableDetails:(NSDictionary *)tableDetails rowCount:(NSUInteger)rowCount;
+
+- (id)initWithTableName:(NSString *)table keyColumn:(NSString *)keyColumn selectColumns:(NSString *)columns connection:(SPMySQLConnection *)connection connectionPool:(SPExportConnectionPool *)pool;
+
+- (void)setInitialLowerBound:(NSString *)lowerBound;
+- (void)startReading;
+
+- (NSArray *)fieldNames;
+- (NSArray *)getRowAsArray;
+- (void)cancelResultLoad;
+- (NSString *)lastErrorMessage;
+
+- (NSUInteger)completedChunkCount;
+- (NSString *)completedKeyBound;
+
+- (NSUInteger)processedRowCount;
+- (double)dataWaitTime;
+
+@end
@@ -0,0 +1,584 @@
+//
+//  SPExportChunkedTableReader.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportChunkedTableReader.h"
+#import "SPExportConnectionPool.h"
+#import "SPThreadAdditions.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The number of rows a table must have to be read in chunks
+static const NSUInteger SPExportChunkedTableMinimumRows = 500000;
+
+// The number of rows fetched per chunk initially, and the bounds the length adapts within
+static const NSUInteger SPExportChunkInitialLength = 10000;
+static const NSUInteger SPExportChunkMinimumLength = 1000;
+static const NSUInteger SPExportChunkMaximumLength = 250000;
+
+// The time a chunk fetch should take; the chunk length adapts towards this using the measured throughput
+static const double SPExportChunkTargetDuration = 1.0;
+
+// The number of chunks which may be fetched ahead of the chunk being read, which also limits the
+// number of connections fetching chunks concurrently
+static const NSUInteger SPExportChunkMaximumReadAhead = 8;
+
+// The approximate size a chunk's rows should not exceed, bounding the chunk length for wide rows,
+// and the size of the fetched chunks buffered for the reader beyond which no more are claimed
+static const NSUInteger SPExportChunkMaximumBytes = 16 * 1024 * 1024;
+static const NSUInteger SPExportChunkMaximumBufferedBytes = 128 * 1024 * 1024;
+
+@interface SPExportChunkedTableReader ()
+
+- (void)_fetchChunksUsingConnection:(SPMySQLConnection *)connection;
+- (void)_startHelperFetchers;
+- (BOOL)_claimChunk:(NSUInteger *)chunkIndex lowerBound:(NSString **)lowerBound upperBound:(NSString **)upperBound usingConnection:(SPMySQLConnection *)connection;
+- (NSString *)_quotedKeyValue:(id)keyValue forConnection:(SPMySQLConnection *)connection;
+- (NSUInteger)_byteLengthOfRow:(NSArray *)row;
+- (void)_setErrorMessage:(NSString *)errorMessage;
+- (void)_waitForFetchers;
+
+@end
+
+@implementation SPExportChunkedTableReader
+
+@synthesize chunkLength;
+@synthesize adaptsChunkLength;
+@synthesize maximumBufferedBytes;
+
+/**
+ * Returns the column a table should be split into key ranges by - a single-column primary key of a
+ * type which compares and sorts consistently as a quoted value - or nil if there isn't one or the
+ * table is too small to benefit.
+ *
+ * @param tableDetails The table information, as returned by SPTableData
+ * @param rowCount     The number of rows in the table
+ */
++ (NSString *)chunkingKeyForTableDetails:(NSDictionary *)tableDetails rowCount:(NSUInteger)rowCount
+{
+	NSArray *primaryKeyColumns = [tableDetails objectForKey:@"primarykeyfield"];
+
+	if (rowCount < SPExportChunkedTableMinimumRows || [primaryKeyColumns count] != 1) return nil;
+
+	NSString *keyColumnName = [primaryKeyColumns objectAtIndex:0];
+
+	for (NSDictionary *column in [tableDetails objectForKey:@"columns"])
+	{
+		if (![[column objectForKey:@"name"] isEqualToString:keyColumnName]) continue;
+
+		if ([@[@"integer", @"string", @"binary", @"date"] containsObject:[column objectForKey:@"typegrouping"]]) return keyColumnName;
+
+		break;
+	}
+
+	return nil;
+}
+
+/**
+ * Initialise a reader for the supplied table.
+ *
+ * @param table      The name of the table to read
+ * @param keyColumn  The primary key column to split the table by
+ * @param columns    The column list to select, already quoted
+ * @param connection The table's connection, which is always used to fetch chunks
+ * @param pool       The pool idle connections are taken from to fetch further chunks concurrently
+ */
+- (id)initWithTableName:(NSString *)table keyColumn:(NSString *)keyColumn selectColumns:(NSString *)columns connection:(SPMySQLConnection *)connection connectionPool:(SPExportConnectionPool *)pool
+{
+	if ((self = [super init])) {
+		tableName = [table copy];
+		keyColumnName = [keyColumn copy];
+		selectColumns = [columns copy];
+
+		tableConnection = [connection retain];
+		connectionPool = [pool retain];
+
+		chunkCondition = [[NSCondition alloc] init];
+		fetchedChunks = [[NSMutableDictionary alloc] init];
+		chunkUpperBounds = [[NSMutableDictionary alloc] init];
+		chunkByteLengths = [[NSMutableDictionary alloc] init];
+
+		chunkLength = SPExportChunkInitialLength;
+		adaptsChunkLength = YES;
+		maximumBufferedBytes = SPExportChunkMaximumBufferedBytes;
+	}
+
+	return self;
+}
+
+/**
+ * Set the key value to read rows after, skipping the key ranges already read - as when resuming
+ * an export.  Must be called before reading starts.
+ *
+ * @param lowerBound The quoted upper bound of the key ranges already read, as returned by completedKeyBound
+ */
+- (void)setInitialLowerBound:(NSString *)lowerBound
+{
+	[chunkCondition lock];
+
+	if (lastChunkUpperBound) SPClear(lastChunkUpperBound);
+
+	lastChunkUpperBound = [lowerBound copy];
+
+	[chunkCondition unlock];
+}
+
+/**
+ * Start fetching chunks in the background.
+ */
+- (void)startReading
+{
+	[chunkCondition lock];
+	activeFetchers++;
+	[chunkCondition unlock];
+
+	[NSThread detachNewThreadWithName:[NSString stringWithFormat:@"SPExportChunkedTableReader fetching %@", tableName] target:self selector:@selector(_fetchChunksUsingConnection:) object:tableConnection];
+}
+
+/**
+ * Returns the field names of the result, waiting for the first chunk if necessary.
+ */
+- (NSArray *)fieldNames
+{
+	[chunkCondition lock];
+
+	while (!fieldNames && !cancelled && !lastErrorMessage) [chunkCondition wait];
+
+	NSArray *names = [[fieldNames retain] autorelease];
+
+	[chunkCondition unlock];
+
+	return names;
+}
+
+/**
+ * Returns the next row in key range order, waiting for its chunk to be fetched if necessary.
+ *
+ * @return The row, or nil once all rows have been read or if reading failed or was cancelled
+ */
+- (NSArray *)getRowAsArray
+{
+	while (1)
+	{
+		if (currentChunkRows && currentChunkRowIndex < [currentChunkRows count]) {
+			processedRowCount++;
+
+			return [[NSArrayObjectAtIndex(currentChunkRows, currentChunkRowIndex++) retain] autorelease];
+		}
+
+		[chunkCondition lock];
+
+		// Release the chunk which has been read, making room for another to be fetched
+		if (currentChunkRows) {
+			NSNumber *readChunkKey = [NSNumber numberWithUnsignedInteger:readChunkIndex];
+
+			SPClear(currentChunkRows);
+
+			bufferedChunkBytes -= [[chunkByteLengths objectForKey:readChunkKey] unsignedIntegerValue];
+			[chunkByteLengths removeObjectForKey:readChunkKey];
+
+			if (completedKeyBound) SPClear(completedKeyBound);
+
+			completedKeyBound = [[chunkUpperBounds objectForKey:readChunkKey] retain];
+			[chunkUpperBounds removeObjectForKey:readChunkKey];
+
+			readChunkIndex++;
+			[chunkCondition broadcast];
+		}
+
+		NSNumber *chunkKey = [NSNumber numberWithUnsignedInteger:readChunkIndex];
+
+		NSTimeInterval waitStartTime = [NSDate timeIntervalSinceReferenceDate];
+
+		while (!cancelled && !lastErrorMessage && ![fetchedChunks objectForKey:chunkKey] && !(allChunksClaimed && readChunkIndex >= nextChunkIndex))
+		{
+			[chunkCondition wait];
+		}
+
+		dataWaitTime += [NSDate timeIntervalSinceReferenceDate] - waitStartTime;
+
+		if (!cancelled && !lastErrorMessage && [fetchedChunks objectForKey:chunkKey]) {
+			currentChunkRows = [[fetchedChunks objectForKey:chunkKey] retain];
+			currentChunkRowIndex = 0;
+
+			[fetchedChunks removeObjectForKey:chunkKey];
+		}
+
+		[chunkCondition unlock];
+
+		// All rows have been read; ensure no fetches are still using the connections before returning
+		if (!currentChunkRows) {
+			[self _waitForFetchers];
+
+			return nil;
+		}
+	}
+}
+
+/**
+ * Stop reading, waiting for any chunk fetches in progress to complete.
+ */
+- (void)cancelResultLoad
+{
+	[chunkCondition lock];
+	cancelled = YES;
+	[chunkCondition broadcast];
+	[chunkCondition unlock];
+
+	[self _waitForFetchers];
+}
+
+/**
+ * Returns the error which stopped the table being read, or nil if no errors occurred.
+ */
+- (NSString *)lastErrorMessage
+{
+	NSString *errorMessage;
+
+	[chunkCondition lock];
+	errorMessage = [[lastErrorMessage retain] autorelease];
+	[chunkCondition unlock];
+
+	return errorMessage;
+}
+
+/**
+ * Returns the number of chunks whose rows have all been returned.  Only valid on the thread
+ * reading the rows.
+ */
+- (NSUInteger)completedChunkCount
+{
+	return readChunkIndex;
+}
+
+/**
+ * Returns the quoted upper bound of the key range of the last chunk whose rows have all been
+ * returned, or nil if none has been completed or the final chunk - which has no upper bound -
+ * has been completed.  Only valid on the thread reading the rows.
+ */
+- (NSString *)completedKeyBound
+{
+	return [[completedKeyBound retain] autorelease];
+}
+
+/**
+ * Returns the number of rows which have been returned so far.
+ */
+- (NSUInteger)processedRowCount
+{
+	return processedRowCount;
+}
+
+/**
+ * Returns the total time, in seconds, spent waiting for chunks to be fetched from the server.
+ */
+- (double)dataWaitTime
+{
+	return dataWaitTime;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Claim and fetch chunks on the supplied connection until all chunks have been claimed.  Run on a
+ * background thread for the table's connection, and for each pooled connection recruited to help.
+ */
+- (void)_fetchChunksUsingConnection:(SPMySQLConnection *)connection
+{
+	@autoreleasepool {
+		while (1)
+		{
+			@autoreleasepool {
+				NSUInteger chunkIndex;
+				NSString *lowerBound = nil;
+				NSString *upperBound = nil;
+
+				// Recruit any idle pooled connections to fetch further chunks concurrently
+				if (connection == tableConnection) [self _startHelperFetchers];
+
+				if (![self _claimChunk:&chunkIndex lowerBound:&lowerBound upperBound:&upperBound usingConnection:connection]) break;
+
+				NSMutableString *query = [NSMutableString stringWithFormat:@"SELECT %@ FROM %@", selectColumns, [tableName backtickQuotedString]];
+
+				if (lowerBound && upperBound) {
+					[query appendFormat:@" WHERE %@ > %@ AND %@ <= %@", [keyColumnName backtickQuotedString], lowerBound, [keyColumnName backtickQuotedString], upperBound];
+				}
+				else if (lowerBound) {
+					[query appendFormat:@" WHERE %@ > %@", [keyColumnName backtickQuotedString], lowerBound];
+				}
+				else if (upperBound) {
+					[query appendFormat:@" WHERE %@ <= %@", [keyColumnName backtickQuotedString], upperBound];
+				}
+
+				NSDate *fetchStartDate = [NSDate date];
+
+				// Stream the rows straight into the chunk, rather than buffering the whole result twice
+				SPMySQLStreamingResult *result = [connection streamingQueryString:query useLowMemoryBlockingStreaming:YES];
+
+				if ([connection queryErrored]) {
+					[self _setErrorMessage:[connection lastErrorMessage]];
+					break;
+				}
+
+				NSMutableArray *chunkRows = [NSMutableArray array];
+				NSUInteger chunkBytes = 0;
+				NSArray *row;
+
+				while ((row = [result getRowAsArray]))
+				{
+					[chunkRows addObject:row];
+
+					chunkBytes += [self _byteLengthOfRow:row];
+				}
+
+				// A connection lost part way through the chunk ends the stream early
+				if ([connection queryErrored] || ![connection isConnected]) {
+					[self _setErrorMessage:([connection lastErrorMessage]) ? [connection lastErrorMessage] : NSLocalizedString(@"The connection was lost while reading the table.", @"export : chunked table read : connection lost")];
+					break;
+				}
+
+				NSTimeInterval fetchDuration = -[fetchStartDate timeIntervalSinceNow];
+
+				[chunkCondition lock];
+
+				if (!fieldNames) fieldNames = [[result fieldNames] retain];
+
+				NSNumber *chunkKey = [NSNumber numberWithUnsignedInteger:chunkIndex];
+
+				[fetchedChunks setObject:chunkRows forKey:chunkKey];
+				[chunkByteLengths setObject:[NSNumber numberWithUnsignedInteger:chunkBytes] forKey:chunkKey];
+
+				bufferedChunkBytes += chunkBytes;
+
+				// Adapt the chunk length towards the number of rows fetched in the target duration,
+				// without exceeding the maximum chunk size at the average row size seen
+				if (adaptsChunkLength && [chunkRows count] && fetchDuration > 0) {
+					double targetLength = [chunkRows count] * (SPExportChunkTargetDuration / fetchDuration);
+					NSUInteger averageRowBytes = MAX(1, chunkBytes / [chunkRows count]);
+
+					chunkLength = (NSUInteger)((chunkLength + targetLength) / 2);
+					chunkLength = MIN(chunkLength, SPExportChunkMaximumBytes / averageRowBytes);
+					chunkLength = MAX(SPExportChunkMinimumLength, MIN(SPExportChunkMaximumLength, chunkLength));
+				}
+
+				[chunkCondition broadcast];
+				[chunkCondition unlock];
+			}
+		}
+
+		[chunkCondition lock];
+		activeFetchers--;
+		[chunkCondition broadcast];
+		[chunkCondition unlock];
+
+		if (connection != tableConnection) [connectionPool checkinConnection:connection];
+	}
+}
+
+/**
+ * Start a fetcher for each idle pooled connection, up to the maximum number of fetchers.
+ */
+- (void)_startHelperFetchers
+{
+	while (1)
+	{
+		[chunkCondition lock];
+		BOOL needsFetchers = (!allChunksClaimed && !cancelled && activeFetchers < SPExportChunkMaximumReadAhead);
+		[chunkCondition unlock];
+
+		if (!needsFetchers) return;
+
+		SPMySQLConnection *helperConnection = [connectionPool checkoutIdleConnection];
+
+		if (!helperConnection) return;
+
+		[chunkCondition lock];
+		activeFetchers++;
+		[chunkCondition unlock];
+
+		[NSThread detachNewThreadWithName:[NSString stringWithFormat:@"SPExportChunkedTableReader fetching %@", tableName] target:self selector:@selector(_fetchChunksUsingConnection:) object:helperConnection];
+	}
+}
+
+/**
+ * Claim the next chunk to fetch, and find its key range.  The chunk's upper bound is found by
+ * seeking the chunk length along the key from the previous chunk's upper bound; if no key is
+ * found there, the chunk is the final one and has no upper bound.  Waits while the reader is
+ * too far behind, or while the fetched chunks waiting for it are too large.
+ *
+ * Only one boundary is sought at a time, as each starts from the last, but the query is run
+ * without holding the lock so the reader and other fetchers aren't held up by it.
+ *
+ * @return NO if there are no further chunks to fetch
+ */
+- (BOOL)_claimChunk:(NSUInteger *)chunkIndex lowerBound:(NSString **)lowerBound upperBound:(NSString **)upperBound usingConnection:(SPMySQLConnection *)connection
+{
+	[chunkCondition lock];
+
+	// Limit the chunks fetched ahead of the reader, bounding the memory used by the reorder buffer.
+	// The chunk the reader is waiting for can always be claimed, so the reader can't be starved.
+	while (!cancelled && !lastErrorMessage && !allChunksClaimed && (seekingChunkBoundary || nextChunkIndex >= readChunkIndex + SPExportChunkMaximumReadAhead || (nextChunkIndex > readChunkIndex && bufferedChunkBytes >= maximumBufferedBytes)))
+	{
+		[chunkCondition wait];
+	}
+
+	if (cancelled || lastErrorMessage || allChunksClaimed) {
+		[chunkCondition unlock];
+
+		return NO;
+	}
+
+	seekingChunkBoundary = YES;
+
+	NSString *previousUpperBound = [[lastChunkUpperBound retain] autorelease];
+	NSUInteger boundaryOffset = chunkLength - 1;
+
+	[chunkCondition unlock];
+
+	NSString *escapedKeyColumn = [keyColumnName backtickQuotedString];
+	NSMutableString *boundaryQuery = [NSMutableString stringWithFormat:@"SELECT %@ FROM %@", escapedKeyColumn, [tableName backtickQuotedString]];
+
+	if (previousUpperBound) [boundaryQuery appendFormat:@" WHERE %@ > %@", escapedKeyColumn, previousUpperBound];
+
+	[boundaryQuery appendFormat:@" ORDER BY %@ LIMIT 1 OFFSET %lu", escapedKeyColumn, (unsigned long)boundaryOffset];
+
+	SPMySQLResult *boundaryResult = [connection queryString:boundaryQuery];
+	BOOL boundaryQueryErrored = [connection queryErrored];
+	NSArray *boundaryRow = (boundaryQueryErrored) ? nil : [boundaryResult getRowAsArray];
+	NSString *boundaryValue = ([boundaryRow count]) ? [self _quotedKeyValue:NSArrayObjectAtIndex(boundaryRow, 0) forConnection:connection] : nil;
+
+	[chunkCondition lock];
+
+	seekingChunkBoundary = NO;
+
+	[chunkCondition broadcast];
+
+	if (boundaryQueryErrored || cancelled || lastErrorMessage) {
+		if (boundaryQueryErrored && !lastErrorMessage) lastErrorMessage = [[connection lastErrorMessage] copy];
+
+		[chunkCondition unlock];
+
+		return NO;
+	}
+
+	*chunkIndex = nextChunkIndex++;
+	*lowerBound = previousUpperBound;
+	*upperBound = boundaryValue;
+
+	if (boundaryValue) {
+		[chunkUpperBounds setObject:boundaryValue forKey:[NSNumber numberWithUnsignedInteger:*chunkIndex]];
+
+		[lastChunkUpperBound release];
+		lastChunkUpperBound = [boundaryValue retain];
+	}
+	else {
+		allChunksClaimed = YES;
+	}
+
+	[chunkCondition unlock];
+
+	return YES;
+}
+
+/**
+ * Returns a key value as a quoted literal for use in range conditions.
+ */
+- (NSString *)_quotedKeyValue:(id)keyValue forConnection:(SPMySQLConnection *)connection
+{
+	if ([keyValue isKindOfClass:[NSData class]]) return [connection escapeAndQuoteData:keyValue];
+
+	return [connection escapeAndQuoteString:[keyValue description]];
+}
+
+/**
+ * Returns the approximate memory used by a fetched row's values.
+ */
+- (NSUInteger)_byteLengthOfRow:(NSArray *)row
+{
+	NSUInteger byteLength = 0;
+
+	for (id cellValue in row)
+	{
+		if ([cellValue isKindOfClass:[NSData class]]) byteLength += [(NSData *)cellValue length];
+		else if ([cellValue isKindOfClass:[NSString class]]) byteLength += [(NSString *)cellValue length] * sizeof(unichar);
+		else byteLength += sizeof(id);
+	}
+
+	return byteLength;
+}
+
+/**
+ * Record the error which stopped a chunk being fetched, waking the reader and other fetchers.
+ */
+- (void)_setErrorMessage:(NSString *)errorMessage
+{
+	[chunkCondition lock];
+
+	if (!lastErrorMessage) lastErrorMessage = [errorMessage copy];
+
+	[chunkCondition broadcast];
+	[chunkCondition unlock];
+}
+
+/**
+ * Wait until all background fetchers have finished.
+ */
+- (void)_waitForFetchers
+{
+	[chunkCondition lock];
+
+	while (activeFetchers) [chunkCondition wait];
+
+	[chunkCondition unlock];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(tableName);
+	SPClear(keyColumnName);
+	SPClear(selectColumns);
+	SPClear(tableConnection);
+	SPClear(connectionPool);
+	SPClear(chunkCondition);
+	SPClear(fetchedChunks);
+	SPClear(chunkUpperBounds);
+	SPClear(chunkByteLengths);
+	if (fieldNames) SPClear(fieldNames);
+	if (lastErrorMessage) SPClear(lastErrorMessage);
+	if (lastChunkUpperBound) SPClear(lastChunkUpperBound);
+	if (completedKeyBound) SPClear(completedKeyBound);
+	if (currentChunkRows) SPClear(currentChunkRows);
+
+	[super dealloc];
+}
+
+@end
@@ -0,0 +1,72 @@
+//
+//  SPExportConnectionPool.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMySQLConnection;
+
+/**
+ * @class SPExportConnectionPool SPExportConnectionPool.h
+ *
+ * A pool of additional connections used by exporters to read data concurrently. The connections are
+ * copies of a parent connection, set up with the parent session's database, encoding, SQL_MODE and
+ * time zone, and each runs a transaction started WITH CONSISTENT SNAPSHOT so that all of them see
+ * the same data.
+ * As in mysqldump, a global read lock is held while the transactions are started where permitted.
+ *
+ * Connections are checked out by the thread using them and checked back in when done; all methods
+ * are thread safe.
+ */
+@interface SPExportConnectionPool : NSObject
+{
+	SPMySQLConnection *parentConnection;
+
+	NSMutableArray *connections;
+	NSMutableArray *idleConnections;
+	NSCondition *idleConnectionsCondition;
+
+	BOOL usesSharedSnapshot;
+}
+
+/**
+ * @property usesSharedSnapshot Whether the transactions were started under a global read lock, so
+ *                              all connections are guaranteed to share a single snapshot
+ */
+@property (readonly, assign) BOOL usesSharedSnapshot;
+
+- (id)initWithConnection:(SPMySQLConnection *)connection;
+
+- (BOOL)openConnections:(NSUInteger)connectionCount;
+- (NSUInteger)connectionCount;
+- (void)close;
+
+- (SPMySQLConnection *)checkoutConnection;
+- (SPMySQLConnection *)checkoutIdleConnection;
+- (void)checkinConnection:(SPMySQLConnection *)connection;
+
+@end
@@ -0,0 +1,256 @@
+//
+//  SPExportConnectionPool.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportConnectionPool.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+@implementation SPExportConnectionPool
+
+@synthesize usesSharedSnapshot;
+
+/**
+ * Initialise a pool of connections copied from the supplied connection.
+ */
+- (id)initWithConnection:(SPMySQLConnection *)connection
+{
+	if ((self = [super init])) {
+		parentConnection = [connection retain];
+
+		connections = [[NSMutableArray alloc] init];
+		idleConnections = [[NSMutableArray alloc] init];
+		idleConnectionsCondition = [[NSCondition alloc] init];
+
+		usesSharedSnapshot = NO;
+	}
+
+	return self;
+}
+
+/**
+ * Open the pooled connections and start their snapshot transactions.  Must be called from the
+ * thread using the parent connection, as the parent's session state is read to set them up.
+ *
+ * @param connectionCount The number of connections to open
+ *
+ * @return YES if at least two connections were opened; otherwise no connections remain open
+ */
+- (BOOL)openConnections:(NSUInteger)connectionCount
+{
+	if ([connections count] || connectionCount < 2) return NO;
+
+	// Mirror the parent's session, so queries behave the same on every connection
+	NSArray *sessionDetails = [[parentConnection queryString:@"SELECT DATABASE(), @@SESSION.sql_mode, @@SESSION.time_zone"] getRowAsArray];
+
+	if ([parentConnection queryErrored] || [sessionDetails count] != 3) return NO;
+
+	NSString *database = [NSArrayObjectAtIndex(sessionDetails, 0) unboxNull];
+	NSString *sqlMode = [NSArrayObjectAtIndex(sessionDetails, 1) unboxNull];
+	NSString *timeZone = [NSArrayObjectAtIndex(sessionDetails, 2) unboxNull];
+	NSString *encoding = [parentConnection encoding];
+
+	for (NSUInteger i = 0; i < connectionCount; i++)
+	{
+		SPMySQLConnection *connection = [[parentConnection copy] autorelease];
+
+		// Copy the local port from the parent connection, in case a proxy has changed
+		[connection setPort:[parentConnection port]];
+
+		if (![connection connect]) break;
+
+		if (encoding) [connection setEncoding:encoding];
+
+		if ([database length] && ![connection selectDatabase:database]) {
+			[connection disconnect];
+			break;
+		}
+
+		if (sqlMode) [connection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [connection escapeAndQuoteString:sqlMode]]];
+
+		// TIMESTAMP values are read in the session time zone, so must match the parent's
+		if (timeZone) [connection queryString:[NSString stringWithFormat:@"SET TIME_ZONE=%@", [connection escapeAndQuoteString:timeZone]]];
+
+		[connection queryString:@"SET SESSION TRANSACTION ISOLATION LEVEL REPEATABLE READ"];
+
+		[idleConnectionsCondition lock];
+		[connections addObject:connection];
+		[idleConnectionsCondition unlock];
+	}
+
+	if ([connections count] < 2) {
+		[self close];
+
+		return NO;
+	}
+
+	// Block writes while the transactions are started, so every connection shares the same snapshot.
+	// The lock requires the RELOAD privilege; without it the transactions are started back-to-back.
+	SPMySQLConnection *lockConnection = [connections objectAtIndex:0];
+
+	[lockConnection queryString:@"FLUSH TABLES WITH READ LOCK"];
+
+	usesSharedSnapshot = ![lockConnection queryErrored];
+
+	BOOL snapshotsStarted = YES;
+
+	for (SPMySQLConnection *connection in connections)
+	{
+		[connection queryString:@"START TRANSACTION /*!40100 WITH CONSISTENT SNAPSHOT */"];
+
+		if ([connection queryErrored]) snapshotsStarted = NO;
+	}
+
+	if (usesSharedSnapshot) [lockConnection queryString:@"UNLOCK TABLES"];
+
+	if (!snapshotsStarted) {
+		[self close];
+
+		return NO;
+	}
+
+	[idleConnectionsCondition lock];
+	[idleConnections addObjectsFromArray:connections];
+	[idleConnectionsCondition unlock];
+
+	return YES;
+}
+
+/**
+ * Returns the number of open connections in the pool.
+ */
+- (NSUInteger)connectionCount
+{
+	return [connections count];
+}
+
+/**
+ * End the read-only snapshot transactions and disconnect all pooled connections.  All
+ * connections should have been checked back in first.
+ */
+- (void)close
+{
+	[idleConnectionsCondition lock];
+
+	NSArray *openConnections = [NSArray arrayWithArray:connections];
+
+	[connections removeAllObjects];
+	[idleConnections removeAllObjects];
+
+	// Wake any threads waiting for a connection, as none will become available
+	[idleConnectionsCondition broadcast];
+	[idleConnectionsCondition unlock];
+
+	for (SPMySQLConnection *connection in openConnections)
+	{
+		if (![connection isConnected]) continue;
+
+		[connection queryString:@"COMMIT"];
+		[connection disconnect];
+	}
+
+	usesSharedSnapshot = NO;
+}
+
+/**
+ * Check out a connection, waiting until one is available.
+ *
+ * @return The connection, or nil if the pool is closed
+ */
+- (SPMySQLConnection *)checkoutConnection
+{
+	SPMySQLConnection *connection = nil;
+
+	[idleConnectionsCondition lock];
+
+	while (![idleConnections count] && [connections count]) [idleConnectionsCondition wait];
+
+	if ([idleConnections count]) {
+		connection = [[[idleConnections lastObject] retain] autorelease];
+		[idleConnections removeLastObject];
+	}
+
+	[idleConnectionsCondition unlock];
+
+	return connection;
+}
+
+/**
+ * Check out a connection if one is idle, without waiting.
+ *
+ * @return The connection, or nil if none are idle
+ */
+- (SPMySQLConnection *)checkoutIdleConnection
+{
+	SPMySQLConnection *connection = nil;
+
+	[idleConnectionsCondition lock];
+
+	if ([idleConnections count]) {
+		connection = [[[idleConnections lastObject] retain] autorelease];
+		[idleConnections removeLastObject];
+	}
+
+	[idleConnectionsCondition unlock];
+
+	return connection;
+}
+
+/**
+ * Return a checked out connection to the pool.
+ */
+- (void)checkinConnection:(SPMySQLConnection *)connection
+{
+	if (!connection) return;
+
+	[idleConnectionsCondition lock];
+
+	if ([connections containsObject:connection]) {
+		[idleConnections addObject:connection];
+		[idleConnectionsCondition signal];
+	}
+
+	[idleConnectionsCondition unlock];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	[self close];
+
+	SPClear(parentConnection);
+	SPClear(connections);
+	SPClear(idleConnections);
+	SPClear(idleConnectionsCondition);
+
+	[super dealloc];
+}
+
+@end
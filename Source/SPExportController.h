@@ -37,7 +37,11 @@
 @class SPServerSupport;
 @class SPCSVExporter;
 @class SPXMLExporter;
+@class SPArrowExporter;
 @class SPExportFile;
+@class SPExportStatistics;
+
+@protocol SPExportRowSource;
 
 /**
  * @class SPExportController SPExportController.h
@@ -88,6 +92,7 @@
 	IBOutlet NSWindow *exportProgressWindow;
 	IBOutlet NSTextField *exportProgressTitle;
 	IBOutlet NSTextField *exportProgressText;
+	IBOutlet NSTextField *exportProgressStatisticsText;
 	IBOutlet NSTextField *exportFormatInfoText;
 	IBOutlet NSProgressIndicator *exportProgressIndicator;
 	
@@ -190,6 +195,17 @@
 	 * Array of export files.
 	 */
 	NSMutableArray *exportFiles;
+
+	/**
+	 * Names of the tables whose rows are being exported
+	 */
+	NSMutableArray *exportedTableNames;
+
+	/**
+	 * Throughput statistics of the current export, and the timer updating them on the progress sheet
+	 */
+	SPExportStatistics *exportStatistics;
+	NSTimer *exportStatisticsTimer;
 	
 	/**
 	 * Export type
@@ -290,12 +306,14 @@
 
 - (void)startExport;
 - (void)exportEnded;
+- (void)exportEndedWithErrors:(NSString *)errors;
 - (void)initializeExportUsingSelectedOptions;
 
-- (void)exportTables:(NSArray *)exportTables orDataArray:(NSArray *)dataArray;
+- (void)exportTables:(NSArray *)exportTables orRowSource:(id <SPExportRowSource>)rowSource;
 
-- (SPCSVExporter *)initializeCSVExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray;
-- (SPXMLExporter *)initializeXMLExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray;
+- (SPCSVExporter *)initializeCSVExporterForTable:(NSString *)table orRowSource:(id <SPExportRowSource>)rowSource;
+- (SPXMLExporter *)initializeXMLExporterForTable:(NSString *)table orRowSource:(id <SPExportRowSource>)rowSource;
+- (SPArrowExporter *)initializeArrowExporterForTable:(NSString *)table orRowSource:(id <SPExportRowSource>)rowSource;
 
 #pragma mark - SPExportFileUtilities
 
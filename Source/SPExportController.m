@@ -34,6 +34,8 @@
 #import "SPTableContent.h"
 #import "SPGrowlController.h"
 #import "SPExportFile.h"
+#import "SPExportCheckpoint.h"
+#import "SPExportStatistics.h"
 #import "SPAlertSheets.h"
 #import "SPExportFileNameTokenObject.h"
 #import "SPDatabaseDocument.h"
@@ -43,12 +45,14 @@
 #import "SPSQLExporter.h"
 #import "SPXMLExporter.h"
 #import "SPDotExporter.h"
+#import "SPArrowExporter.h"
 #import "SPConnectionControllerDelegateProtocol.h"
 #import "SPExporter.h"
 #import "SPCSVExporterProtocol.h"
 #import "SPSQLExporterProtocol.h"
 #import "SPXMLExporterProtocol.h"
 #import "SPDotExporterProtocol.h"
+#import "SPArrowExporterProtocol.h"
 #import "SPPDFExporterProtocol.h"
 #import "SPHTMLExporterProtocol.h"
 
@@ -57,6 +61,9 @@
 // Constants
 static const NSUInteger SPExportUIPadding = 20;
 
+// The interval at which the export statistics on the progress sheet are updated
+static const NSTimeInterval SPExportStatisticsUpdateInterval = 1.0;
+
 static NSString * const SPTableViewStructureColumnID = @"structure";
 static NSString * const SPTableViewContentColumnID   = @"content";
 static NSString * const SPTableViewDropColumnID      = @"drop";
@@ -69,7 +76,8 @@ typedef enum
 {
 	SPExportErrorCancelExport   = 0,
 	SPExportErrorReplaceFiles   = 1,
-	SPExportErrorSkipErrorFiles = 2
+	SPExportErrorSkipErrorFiles = 2,
+	SPExportErrorResumeExport   = 3
 }
 SPExportErrorChoice;
 
@@ -87,7 +95,7 @@ static inline NSNumber *IsOn(id obj);
  */
 static inline void SetOnOff(NSNumber *ref,id obj);
 
-@interface SPExportController () <SPCSVExporterProtocol, SPSQLExporterProtocol, SPXMLExporterProtocol, SPDotExporterProtocol, SPPDFExporterProtocol, SPHTMLExporterProtocol>
+@interface SPExportController () <SPCSVExporterProtocol, SPSQLExporterProtocol, SPXMLExporterProtocol, SPDotExporterProtocol, SPArrowExporterProtocol, SPPDFExporterProtocol, SPHTMLExporterProtocol>
 
 - (void)_switchTab;
 - (void)_checkForDatabaseChanges;
@@ -105,9 +113,13 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 - (void)_waitUntilQueueIsEmptyAfterCancelling:(id)sender;
 - (void)_queueIsEmptyAfterCancelling:(id)sender;
 
+- (void)_updateExportStatistics:(NSTimer *)timer;
+- (void)_stopExportStatistics;
+
 #pragma mark - SPExportFileUtilitiesPrivateAPI
 
 - (void)_reopenExportSheet;
+- (SPSQLExporter *)_resumableSQLExporterForFile:(SPExportFile *)file;
 
 #pragma mark - SPExportControllerDelegate
 
@@ -136,29 +148,34 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 - (NSDictionary *)dotSettings;
 - (NSDictionary *)xmlSettings;
 - (NSDictionary *)sqlSettings;
+- (NSDictionary *)arrowSettings;
 
 - (void)applyExporterSettings:(NSDictionary *)settings;
 - (void)applyCsvSettings:(NSDictionary *)settings;
 - (void)applyDotSettings:(NSDictionary *)settings;
 - (void)applyXmlSettings:(NSDictionary *)settings;
 - (void)applySqlSettings:(NSDictionary *)settings;
+- (void)applyArrowSettings:(NSDictionary *)settings;
 
 - (id)exporterSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)dotSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)xmlSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)csvSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)sqlSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
+- (id)arrowSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 
 - (void)applyExporterSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applyDotSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applyXmlSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applyCsvSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applySqlSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
+- (void)applyArrowSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 
 #pragma mark - Shared Private
 
 - (void)sheetDidEnd:(NSWindow *)sheet returnCode:(NSInteger)returnCode contextInfo:(void *)contextInfo;
 - (void)_hideExportProgress;
+- (void)_selectExportTypeTab:(SPExportType)type;
 
 @end
 
@@ -198,6 +215,7 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 		tables = [[NSMutableArray alloc] init];
 		exporters = [[NSMutableArray alloc] init];
 		exportFiles = [[NSMutableArray alloc] init];
+		exportedTableNames = [[NSMutableArray alloc] init];
 		operationQueue = [[NSOperationQueue alloc] init];
 		
 		showAdvancedView = NO;
@@ -294,7 +312,7 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 	// overwrite those with settings for the current export
 	
 	// Select the correct tab
-	if(format != SPAnyExportType) [exportTypeTabBar selectTabViewItemAtIndex:format];
+	if(format != SPAnyExportType) [self _selectExportTypeTab:format];
 	
 	[self updateDisplayedExportFilename];
 	
@@ -389,7 +407,7 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 	
 	NSArray *selectedTables = [tablesListInstance selectedTableItems];
 	
-	BOOL isCustomQuerySelected = ([tableDocumentInstance isCustomQuerySelected] && ([[customQueryInstance currentResult] count] > 1)); 
+	BOOL isCustomQuerySelected = ([tableDocumentInstance isCustomQuerySelected] && ([customQueryInstance currentResultRowCount] > 0)); 
 	BOOL isContentSelected     = ([[tableDocumentInstance selectedToolbarItemIdentifier] isEqualToString:SPMainToolbarTableContent] && ([[tableContentInstance currentResult] count] > 1));
 	
 	if (isContentSelected) {		
@@ -462,7 +480,7 @@ set_input:
 	
 	BOOL isSelectedTables = (exportSource == SPTableExport);
 	
-	[exportFilePerTableCheck setHidden:(!isSelectedTables) || (exportType == SPSQLExport)];
+	[exportFilePerTableCheck setHidden:(!isSelectedTables) || (exportType == SPSQLExport) || (exportType == SPArrowExport)];
 	[exportTableList setEnabled:isSelectedTables];
 	[exportSelectAllTablesButton setEnabled:isSelectedTables];
 	[exportDeselectAllTablesButton setEnabled:isSelectedTables];
@@ -533,8 +551,44 @@ set_input:
 	[exporters removeAllObjects];
 }
 
+/**
+ * Samples the running export's statistics and displays its throughput and estimated time remaining.
+ */
+- (void)_updateExportStatistics:(NSTimer *)timer
+{
+	[exportStatistics sample];
+
+	[exportProgressStatisticsText setStringValue:[exportStatistics progressDescription]];
+}
+
+/**
+ * Stops sampling the export's statistics and discards them.
+ */
+- (void)_stopExportStatistics
+{
+	[exportStatisticsTimer invalidate];
+
+	SPClear(exportStatisticsTimer);
+	SPClear(exportStatistics);
+}
+
+/**
+ * Selects the export type tab for the supplied export type.
+ */
+- (void)_selectExportTypeTab:(SPExportType)type
+{
+	if (type == SPArrowExport) {
+		[exportTypeTabBar selectTabViewItemWithIdentifier:@"arrow"];
+	}
+	else {
+		[exportTypeTabBar selectTabViewItemAtIndex:type];
+	}
+}
+
 - (void)_hideExportProgress
 {
+	[self _stopExportStatistics];
+
 	// Close the progress sheet
 	[NSApp endSheet:exportProgressWindow returnCode:0];
 	[exportProgressWindow orderOut:self];
@@ -883,13 +937,13 @@ set_input:
 	// Selected export format
 	NSString *type = [[[exportTypeTabBar selectedTabViewItem] identifier] lowercaseString];
 	
-	// Determine the export type
-	exportType = [exportTypeTabBar indexOfTabViewItemWithIdentifier:type];
+	// Determine the export type; Arrow has no options tab of its own, so it doesn't share the tab index
+	exportType = [type isEqualToString:@"arrow"] ? SPArrowExport : [exportTypeTabBar indexOfTabViewItemWithIdentifier:type];
 	
 	// Determine what data to use (filtered result, custom query result or selected table(s)) for the export operation
 	exportSource = (exportType == SPDotExport) ? SPTableExport : [exportInputPopUpButton indexOfSelectedItem];
 		
-	[exportOptionsTabBar selectTabViewItemWithIdentifier:type];
+	if (exportType != SPArrowExport) [exportOptionsTabBar selectTabViewItemWithIdentifier:type];
 	
 	BOOL isSQL  = (exportType == SPSQLExport);
 	BOOL isCSV  = (exportType == SPCSVExport);
@@ -897,10 +951,11 @@ set_input:
 	//BOOL isHTML = (exportType == SPHTMLExport);
 	//BOOL isPDF  = (exportType == SPPDFExport);
 	BOOL isDot  = (exportType == SPDotExport);
+	BOOL isArrow = (exportType == SPArrowExport);
 	
-	BOOL enable = (isCSV || isXML /* || isHTML || isPDF  */ || isDot);
+	BOOL enable = (isCSV || isXML /* || isHTML || isPDF  */ || isDot || isArrow);
 	
-	[exportFilePerTableCheck setHidden:(isSQL || isDot)];		
+	[exportFilePerTableCheck setHidden:(isSQL || isDot || isArrow)];		
 	[exportTableList setEnabled:(!isDot)];
 	[exportSelectAllTablesButton setEnabled:(!isDot)];
 	[exportDeselectAllTablesButton setEnabled:(!isDot)];
@@ -924,7 +979,7 @@ set_input:
 		// Enable/disable the 'filtered result' and 'query result' options
 		// Note that the result count check is always greater than one as the first row is always the field names
 		[[[exportInputPopUpButton menu] itemAtIndex:SPFilteredExport] setEnabled:((enable) && ([[tableContentInstance currentResult] count] > 1))];
-		[[[exportInputPopUpButton menu] itemAtIndex:SPQueryExport] setEnabled:((enable) && ([[customQueryInstance currentResult] count] > 1))];
+		[[[exportInputPopUpButton menu] itemAtIndex:SPQueryExport] setEnabled:((enable) && ([customQueryInstance currentResultRowCount] > 0))];
 	}
 	
 	[[exportTableList tableColumnWithIdentifier:SPTableViewStructureColumnID] setHidden:(isSQL) ? (![exportSQLIncludeStructureCheck state]) : YES];
@@ -1037,6 +1092,7 @@ set_input:
 			if (numberOfTables <= 1) break;
 		case SPXMLExport:
 		case SPDotExport:
+		case SPArrowExport:
 			noteText = NSLocalizedString(@"Import of the selected data is currently not supported.", @"Export file format cannot be imported warning");
 			break;
 		default:
@@ -1075,6 +1131,10 @@ set_input:
 		[optionsSummary addObject:NSLocalizedString(@"bzip2 compression", @"bzip2 compression export summary - within a sentence")];
 	}
 
+	if ([prefs boolForKey:SPExportStatisticsReports]) {
+		[optionsSummary addObject:NSLocalizedString(@"statistics report", @"statistics report export summary - within a sentence")];
+	}
+
 	[exportAdvancedOptionsViewLabelButton setTitle:[NSString stringWithFormat:@"%@ (%@)", NSLocalizedString(@"Advanced", @"Advanced options short title"), [optionsSummary componentsJoinedByString:@", "]]];
 }
 
@@ -1093,12 +1153,13 @@ set_input:
 		BOOL isXML  = (exportType == SPXMLExport);
 		BOOL isHTML = (exportType == SPHTMLExport);
 		BOOL isPDF  = (exportType == SPPDFExport);
+		BOOL isArrow = (exportType == SPArrowExport);
 
 		BOOL structureEnabled = [[uiStateDict objectForKey:SPSQLExportStructureEnabled] boolValue];
 		BOOL contentEnabled   = [[uiStateDict objectForKey:SPSQLExportContentEnabled] boolValue];
 		BOOL dropEnabled      = [[uiStateDict objectForKey:SPSQLExportDropEnabled] boolValue];
 
-		if (isCSV || isXML || isHTML || isPDF || (isSQL && ((!structureEnabled) || (!dropEnabled)))) {
+		if (isCSV || isXML || isArrow || isHTML || isPDF || (isSQL && ((!structureEnabled) || (!dropEnabled)))) {
 			enable = NO;
 
 			// Only enable the button if at least one table is selected
@@ -1197,6 +1258,14 @@ set_input:
 			  contextInfo:nil];
 	}
 
+	// Start measuring the export's throughput, estimating its duration from the sizes of the tables
+	[self _stopExportStatistics];
+
+	exportStatistics = [[SPExportStatistics alloc] initWithExporters:exporters exportFiles:exportFiles tableSizeEstimates:[SPExportStatistics tableSizeEstimatesForTables:exportedTableNames connection:connection]];
+	exportStatisticsTimer = [[NSTimer scheduledTimerWithTimeInterval:SPExportStatisticsUpdateInterval target:self selector:@selector(_updateExportStatistics:) userInfo:nil repeats:YES] retain];
+
+	[exportProgressStatisticsText setStringValue:@""];
+
 	// cache the current connection encoding so the exporter can do what it wants.
 	previousConnectionEncoding = [[NSString alloc] initWithString:[connection encoding]];
 	previousConnectionEncodingViaLatin1 = [connection encodingUsesLatin1Transport];
@@ -1214,6 +1283,45 @@ set_input:
  */
 - (void)exportEnded
 {
+	[self exportEndedWithErrors:nil];
+}
+
+/**
+ * Ends the export, displaying the supplied errors along with any errors writing the export
+ * files - so an export whose files could not be written out in full is reported as failed.
+ *
+ * @param errors Errors reported by the exporter, or nil if there were none
+ */
+- (void)exportEndedWithErrors:(NSString *)errors
+{
+	NSMutableString *exportErrors = [NSMutableString stringWithString:(errors) ? errors : @""];
+
+	for (SPExportFile *exportFile in exportFiles)
+	{
+		int writeError = [exportFile writeError];
+
+		if (!writeError) continue;
+
+		if ([exportErrors length]) [exportErrors appendString:@"\n"];
+
+		[exportErrors appendFormat:NSLocalizedString(@"The export file %@ could not be written in full and is incomplete: %s", @"export : export file write failed message"), [exportFile exportFilePath], strerror(writeError)];
+	}
+
+	[exportStatistics exportDidEnd];
+
+	// If enabled, save a report of the export's statistics alongside the first export file
+	if ([prefs boolForKey:SPExportStatisticsReports] && [exportFiles count]) {
+		NSString *reportPath = [[[exportFiles objectAtIndex:0] exportFilePath] stringByAppendingPathExtension:@"statistics.json"];
+
+		if (![exportStatistics writeReportToFile:reportPath]) NSLog(@"Failed to write export statistics to %@", reportPath);
+	}
+
+	// List the parts of any split files and the tables they hold, so they can be imported in parallel
+	for (SPExportFile *exportFile in exportFiles)
+	{
+		if ([exportFile isSplit] && ![exportFile writePartIndex]) NSLog(@"Failed to write the part index %@", [exportFile partIndexPath]);
+	}
+
 	[self _hideExportProgress];
 
 	// Restore query mode
@@ -1224,6 +1332,8 @@ set_input:
 
 	// Restore the connection encoding to it's pre-export value
 	[tableDocumentInstance setConnectionEncoding:[NSString stringWithFormat:@"%@%@", previousConnectionEncoding, (previousConnectionEncodingViaLatin1) ? @"-" : @""] reloadingViews:NO];
+
+	if ([exportErrors length]) [self openExportErrorsSheetWithString:exportErrors];
 }
 
 /**
@@ -1231,7 +1341,7 @@ set_input:
  */
 - (void)initializeExportUsingSelectedOptions
 {
-	NSArray *dataArray = nil;
+	id <SPExportRowSource> rowSource = nil;
 
 	// Get rid of the cached connection encoding
 	if (previousConnectionEncoding) SPClear(previousConnectionEncoding);
@@ -1240,17 +1350,19 @@ set_input:
 
 	NSMutableArray *exportTables = [NSMutableArray array];
 
-	// Set whether or not we are to export to multiple files
-	[self setExportToMultipleFiles:[exportFilePerTableCheck state]];
+	// Set whether or not we are to export to multiple files; Arrow files can't be concatenated, so
+	// each table always gets its own file
+	[self setExportToMultipleFiles:(exportType == SPArrowExport) ? YES : [exportFilePerTableCheck state]];
 
 	// Get the data depending on the source
 	switch (exportSource)
 	{
 		case SPFilteredExport:
-			dataArray = [tableContentInstance currentDataResultWithNULLs:YES hideBLOBs:NO];
+			rowSource = [SPExportArrayRowSource rowSourceWithDataArray:[tableContentInstance currentDataResultWithNULLs:YES hideBLOBs:NO]];
 			break;
 		case SPQueryExport:
-			dataArray = [customQueryInstance currentDataResultWithNULLs:YES truncateDataFields:NO];
+			// The loaded result is exported directly, without being copied or the query being run again
+			rowSource = [customQueryInstance currentResultRowSource];
 			break;
 		case SPTableExport:
 			// Create an array of tables to export
@@ -1303,6 +1415,9 @@ set_input:
 		case SPDotExport:
 			exportTypeLabel = @"Dot";
 			break;
+		case SPArrowExport:
+			exportTypeLabel = @"Arrow";
+			break;
 		case SPPDFExport:
 		case SPHTMLExport:
 		case SPExcelExport:
@@ -1316,23 +1431,23 @@ set_input:
 	{
 		case SPFilteredExport:
 		case SPQueryExport:
-			[self exportTables:nil orDataArray:dataArray];
+			[self exportTables:nil orRowSource:rowSource];
 			break;
 		case SPTableExport:
-			[self exportTables:exportTables orDataArray:nil];
+			[self exportTables:exportTables orRowSource:nil];
 			break;
 	}
 }
 
 /**
- * Exports the contents of the supplied array of tables or data array.
+ * Exports the contents of the supplied array of tables or row source.
  *
  * Note that at least one of these parameters must not be nil.
  *
  * @param exportTables An array of table/view names to be exported (can be nil).
- * @param dataArray    A MySQL result set array to be exported (can be nil).
+ * @param rowSource    A source of loaded result rows to be exported (can be nil).
  */
-- (void)exportTables:(NSArray *)exportTables orDataArray:(NSArray *)dataArray
+- (void)exportTables:(NSArray *)exportTables orRowSource:(id <SPExportRowSource>)rowSource
 {
 	BOOL singleFileHandleSet = NO;
 	SPExportFile *singleExportFile = nil, *file = nil;
@@ -1357,6 +1472,21 @@ set_input:
 	   didEndSelector:nil
 		  contextInfo:nil];
 
+	// Note the tables whose content is exported, so their sizes can be used to estimate the export's duration
+	[exportedTableNames removeAllObjects];
+
+	if (exportTables && exportType != SPDotExport) {
+		for (id table in exportTables)
+		{
+			if ([table isKindOfClass:[NSArray class]]) {
+				if ([[table objectAtIndex:2] boolValue]) [exportedTableNames addObject:[table objectAtIndex:0]];
+			}
+			else {
+				[exportedTableNames addObject:table];
+			}
+		}
+	}
+
 	// CSV export
 	if (exportType == SPCSVExport) {
 
@@ -1388,7 +1518,7 @@ set_input:
 			// Loop through the tables, creating an exporter for each
 			for (NSString *table in exportTables)
 			{
-				csvExporter = [self initializeCSVExporterForTable:table orDataArray:nil];
+				csvExporter = [self initializeCSVExporterForTable:table orRowSource:nil];
 
 				// If required create a single file handle for all CSV exports
 				if (![self exportToMultipleFiles]) {
@@ -1407,7 +1537,7 @@ set_input:
 			}
 		}
 		else {
-			csvExporter = [self initializeCSVExporterForTable:nil orDataArray:dataArray];
+			csvExporter = [self initializeCSVExporterForTable:nil orRowSource:rowSource];
 
 			[exportFiles addObject:singleExportFile];
 
@@ -1453,6 +1583,12 @@ set_input:
 
 		[sqlExporter setExportOutputFile:file];
 
+		// Record the export's progress alongside the file, so it can be resumed if it is interrupted;
+		// a checkpoint can only resume a single file, so files split into parts aren't checkpointed
+		if ([prefs boolForKey:SPExportCheckpoints] && ![prefs integerForKey:SPExportSplitFileSize] && ![prefs boolForKey:SPExportSplitFilesPerTable]) {
+			[sqlExporter setSqlExportCheckpoint:[SPExportCheckpoint checkpointForExportFileAtPath:[file exportFilePath]]];
+		}
+
 		[exporters addObject:sqlExporter];
 
 		[sqlExporter release];
@@ -1487,7 +1623,7 @@ set_input:
 			// Loop through the tables, creating an exporter for each
 			for (NSString *table in exportTables)
 			{
-				xmlExporter = [self initializeXMLExporterForTable:table orDataArray:nil];
+				xmlExporter = [self initializeXMLExporterForTable:table orRowSource:nil];
 
 				// If required create a single file handle for all XML exports
 				if (![self exportToMultipleFiles]) {
@@ -1506,7 +1642,7 @@ set_input:
 			}
 		}
 		else {
-			xmlExporter = [self initializeXMLExporterForTable:nil orDataArray:dataArray];
+			xmlExporter = [self initializeXMLExporterForTable:nil orRowSource:rowSource];
 
 			[singleExportFile setExportFileNeedsXMLHeader:YES];
 
@@ -1556,6 +1692,39 @@ set_input:
 
 		[dotExporter release];
 	}
+	// Arrow export
+	else if (exportType == SPArrowExport) {
+
+		// Each table is always written to its own file
+		if (exportSource == SPTableExport) {
+
+			// Cache the number of tables being exported
+			exportTableCount = [exportTables count];
+
+			for (NSString *table in exportTables)
+			{
+				[exporters addObject:[self initializeArrowExporterForTable:table orRowSource:nil]];
+			}
+		}
+		else {
+			SPArrowExporter *arrowExporter = [self initializeArrowExporterForTable:nil orRowSource:rowSource];
+
+			[exportFilename setString:(createCustomFilename) ? [self expandCustomFilenameFormatUsingTableName:nil] : [self generateDefaultExportFilename]];
+
+			// Only append the extension if necessary
+			if (![[exportFilename pathExtension] length]) {
+				[exportFilename setString:[exportFilename stringByAppendingPathExtension:[self currentDefaultExportFileExtension]]];
+			}
+
+			file = [SPExportFile exportFileAtPath:[[exportPathField stringValue] stringByAppendingPathComponent:exportFilename]];
+
+			[exportFiles addObject:file];
+
+			[arrowExporter setExportOutputFile:file];
+
+			[exporters addObject:arrowExporter];
+		}
+	}
 
 	// For each of the created exporters, set their generic properties
 	for (SPExporter *exporter in exporters)
@@ -1565,6 +1734,7 @@ set_input:
 		[exporter setExportOutputEncoding:[connection stringEncoding]];
 		[exporter setExportMaxProgress:(NSInteger)[exportProgressIndicator bounds].size.width];
 		[exporter setExportUsingLowMemoryBlockingStreaming:([exportProcessLowMemoryButton state] == NSOnState)];
+		[exporter setExportParallelConnections:[prefs integerForKey:SPExportParallelConnections]];
 		[exporter setExportOutputCompressionFormat:(SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
 		[exporter setExportOutputCompressFile:([exportOutputCompressionFormatPopupButton indexOfSelectedItem] != SPNoCompression)];
 	}
@@ -1574,9 +1744,16 @@ set_input:
 	// Create the actual file handles while dealing with errors (e.g. file already exists, etc) during creation
 	for (SPExportFile *exportFile in exportFiles)
 	{
+		// SQL and CSV output can be split into parts at statement or row boundaries, by size or per table
+		if (exportType == SPSQLExport || exportType == SPCSVExport) {
+			[exportFile setExportFileSplitLength:(unsigned long long)MAX([prefs integerForKey:SPExportSplitFileSize], 0) * 1024 * 1024];
+			[exportFile setExportFileSplitsPerTable:[prefs boolForKey:SPExportSplitFilesPerTable]];
+		}
+
 		if ([exportFile createExportFileHandle:NO] == SPExportFileHandleCreated) {
 
-			[exportFile setCompressionFormat:(SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
+			// Arrow files are read from their footer, so can't be compressed as a whole
+			[exportFile setCompressionFormat:(exportType == SPArrowExport) ? SPNoCompression : (SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
 
 			if ([exportFile exportFileNeedsCSVHeader]) {
 				[self writeCSVHeaderToExportFile:exportFile];
@@ -1602,21 +1779,21 @@ set_input:
 }
 
 /**
- * Initialises a CSV exporter for the supplied table name or data array.
+ * Initialises a CSV exporter for the supplied table name or row source.
  *
  * @param table     The table name for which the exporter should be cerated for (can be nil).
- * @param dataArray The MySQL result data array for which the exporter should be created for (can be nil).
+ * @param rowSource The source of result rows for which the exporter should be created for (can be nil).
  */
-- (SPCSVExporter *)initializeCSVExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray
+- (SPCSVExporter *)initializeCSVExporterForTable:(NSString *)table orRowSource:(id <SPExportRowSource>)rowSource
 {
 	SPCSVExporter *csvExporter = [[SPCSVExporter alloc] initWithDelegate:self];
 
-	// Depeding on the export source, set the table name or data array
+	// Depeding on the export source, set the table name or row source
 	if (exportSource == SPTableExport) {
 		[csvExporter setCsvTableName:table];
 	}
 	else {
-		[csvExporter setCsvDataArray:dataArray];
+		[csvExporter setExportRowSource:rowSource];
 	}
 
 	[csvExporter setCsvTableData:tableDataInstance];
@@ -1647,7 +1824,7 @@ set_input:
 			}
 		}
 		else {
-			[exportFilename setString:(dataArray) ? [tableDocumentInstance database] : table];
+			[exportFilename setString:(rowSource) ? [tableDocumentInstance database] : table];
 		}
 
 		// Only append the extension if necessary
@@ -1666,18 +1843,18 @@ set_input:
 }
 
 /**
- * Initialises a XML exporter for the supplied table name or data array.
+ * Initialises a XML exporter for the supplied table name or row source.
  *
  * @param table     The table name for which the exporter should be cerated for (can be nil).
- * @param dataArray The MySQL result data array for which the exporter should be created for (can be nil).
+ * @param rowSource The source of result rows for which the exporter should be created for (can be nil).
  */
-- (SPXMLExporter *)initializeXMLExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray
+- (SPXMLExporter *)initializeXMLExporterForTable:(NSString *)table orRowSource:(id <SPExportRowSource>)rowSource
 {
 	SPXMLExporter *xmlExporter = [[SPXMLExporter alloc] initWithDelegate:self];
 
-	// if required set the data array
+	// if required set the row source
 	if (exportSource != SPTableExport) {
-		[xmlExporter setXmlDataArray:dataArray];
+		[xmlExporter setExportRowSource:rowSource];
 	}
 
 	// Regardless of the export source, set exporter's table name as it's used in the output
@@ -1709,7 +1886,7 @@ set_input:
 			}
 		}
 		else {
-			[exportFilename setString:(dataArray) ? [tableDocumentInstance database] : table];
+			[exportFilename setString:(rowSource) ? [tableDocumentInstance database] : table];
 		}
 
 		// Only append the extension if necessary
@@ -1729,6 +1906,62 @@ set_input:
 	return [xmlExporter autorelease];
 }
 
+/**
+ * Initialises an Arrow exporter for the supplied table name or row source.
+ *
+ * @param table     The table name for which the exporter should be cerated for (can be nil).
+ * @param rowSource The source of result rows for which the exporter should be created for (can be nil).
+ */
+- (SPArrowExporter *)initializeArrowExporterForTable:(NSString *)table orRowSource:(id <SPExportRowSource>)rowSource
+{
+	SPArrowExporter *arrowExporter = [[SPArrowExporter alloc] initWithDelegate:self];
+
+	// Depeding on the export source, set the table name or row source
+	if (exportSource == SPTableExport) {
+		[arrowExporter setArrowTableName:table];
+	}
+	else {
+		[arrowExporter setExportRowSource:rowSource];
+	}
+
+	// Table exports always get a file per table
+	if (exportSource == SPTableExport) {
+
+		if (createCustomFilename) {
+
+			// Create custom filename based on the selected format
+			[exportFilename setString:[self expandCustomFilenameFormatUsingTableName:table]];
+
+			// If the user chose to use a custom filename format and we exporting to multiple files, make
+			// sure the table name is included to ensure the output files are unique.
+			if (exportTableCount > 1) {
+				BOOL tableNameInTokens = NO;
+				NSArray *representedObjects = [exportCustomFilenameTokenField objectValue];
+				for (id representedObject in representedObjects) {
+					if ([representedObject isKindOfClass:[SPExportFileNameTokenObject class]] && [[representedObject tokenId] isEqualToString:SPFileNameTableTokenName]) tableNameInTokens = YES;
+				}
+				[exportFilename setString:(tableNameInTokens ? exportFilename : [exportFilename stringByAppendingFormat:@"_%@", table])];
+			}
+		}
+		else {
+			[exportFilename setString:table];
+		}
+
+		// Only append the extension if necessary
+		if (![[exportFilename pathExtension] length]) {
+			[exportFilename setString:[exportFilename stringByAppendingPathExtension:[self currentDefaultExportFileExtension]]];
+		}
+
+		SPExportFile *file = [SPExportFile exportFileAtPath:[[exportPathField stringValue] stringByAppendingPathComponent:exportFilename]];
+
+		[exportFiles addObject:file];
+
+		[arrowExporter setExportOutputFile:file];
+	}
+
+	return [arrowExporter autorelease];
+}
+
 #pragma mark - SPExportFileUtilitiesPrivateAPI
 
 /**
@@ -1827,6 +2060,7 @@ set_input:
 	NSUInteger parentFoldersMissing = 0;
 	NSUInteger parentFoldersNotWritable = 0;
 	NSUInteger filesFailed = 0;
+	BOOL canResumeExport = NO;
 
 	for (SPExportFile *file in files)
 	{
@@ -1874,6 +2108,23 @@ set_input:
 		if (filesAlreadyExisting == 1) {
 			[alert setMessageText:[NSString stringWithFormat:NSLocalizedString(@"“%@” already exists. Do you want to replace it?", @"Export file already exists message"), [[[files objectAtIndex:0] exportFilePath] lastPathComponent]]];
 			[alert setInformativeText:[NSString stringWithFormat:@"%@%@", NSLocalizedString(@"A file with the same name already exists in the target folder. Replacing it will overwrite its current contents.", @"Export file already exists explanatory text"), additionalErrors]];
+
+			// A split export also replaces the parts of any earlier split export to the same file
+			for (SPExportFile *file in files)
+			{
+				if ([file exportFileHandleStatus] == SPExportFileHandleExists && [file isSplit] && [[file existingPartPaths] count]) {
+					[alert setInformativeText:[NSString stringWithFormat:@"%@%@", NSLocalizedString(@"Parts of an earlier split export with the same name already exist in the target folder. Replacing them will delete them and overwrite the file's current contents.", @"Export file parts already exist explanatory text"), additionalErrors]];
+				}
+			}
+
+			// An interrupted export of the file with the same settings can be continued from its last checkpoint
+			for (SPExportFile *file in files)
+			{
+				if ([file exportFileHandleStatus] == SPExportFileHandleExists && [self _resumableSQLExporterForFile:file]) {
+					[alert setInformativeText:[NSString stringWithFormat:@"%@%@", NSLocalizedString(@"The file is from an interrupted export with the same settings, which can be resumed from its last checkpoint instead.", @"Export file can be resumed explanatory text"), additionalErrors]];
+					canResumeExport = YES;
+				}
+			}
 		}
 		else if (filesAlreadyExisting == [exportFiles count]) {
 			[alert setMessageText:[NSString stringWithFormat:NSLocalizedString(@"All the export files already exist. Do you want to replace them?", @"All export files already exist message")]];
@@ -1899,6 +2150,13 @@ set_input:
 			[[[alert buttons] objectAtIndex:2] setKeyEquivalent:@"s"];
 			[[[alert buttons] objectAtIndex:2] setKeyEquivalentModifierMask:NSEventModifierFlagCommand];
 		}
+
+		if (canResumeExport) {
+			NSButton *resumeButton = [alert addButtonWithTitle:NSLocalizedString(@"Resume", @"resume export button")];
+			[resumeButton setTag:SPExportErrorResumeExport];
+			[resumeButton setKeyEquivalent:@"e"];
+			[resumeButton setKeyEquivalentModifierMask:NSEventModifierFlagCommand];
+		}
 	}
 	// If one or multiple files failed, but only due to unhandled errors, show a short dialog
 	else {
@@ -2015,6 +2273,31 @@ set_input:
 		[self performSelector:@selector(startExport) withObject:nil afterDelay:0.1];
 
 	}
+	// Reopen the files of interrupted exports at their last checkpoint, and continue the exports from there
+	else if (returnCode == SPExportErrorResumeExport) {
+
+		for (SPExportFile *file in files)
+		{
+			if ([file exportFileHandleStatus] != SPExportFileHandleExists) continue;
+
+			SPSQLExporter *sqlExporter = [self _resumableSQLExporterForFile:file];
+
+			if (sqlExporter && [file resumeExportFileHandleAtOffset:[[sqlExporter sqlExportCheckpoint] exportFileOffset]] == SPExportFileHandleCreated) {
+				[sqlExporter setSqlExportResumesFromCheckpoint:YES];
+			}
+			// If the file can no longer be resumed, fall back to replacing it
+			else if ([file createExportFileHandle:YES] != SPExportFileHandleCreated) {
+				continue;
+			}
+
+			[file setCompressionFormat:(SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
+		}
+
+		[files release];
+
+		// Start the export after a short delay to give this sheet a chance to close
+		[self performSelector:@selector(startExport) withObject:nil afterDelay:0.1];
+	}
 	// Cancel the entire export operation
 	else if (returnCode == SPExportErrorCancelExport) {
 
@@ -2035,6 +2318,22 @@ set_input:
 	}
 }
 
+/**
+ * Returns the SQL exporter writing to the supplied file if it can be resumed from a checkpoint
+ * of an earlier, interrupted export to the file, or nil otherwise.
+ */
+- (SPSQLExporter *)_resumableSQLExporterForFile:(SPExportFile *)file
+{
+	for (SPExporter *exporter in exporters)
+	{
+		if ([exporter isKindOfClass:[SPSQLExporter class]] && [[exporter exportOutputFile] isEqualTo:file] && [(SPSQLExporter *)exporter canResumeFromCheckpoint]) {
+			return (SPSQLExporter *)exporter;
+		}
+	}
+
+	return nil;
+}
+
 /**
  * Re-open the export sheet without resetting the interface - for use on error.
  */
@@ -2230,6 +2529,9 @@ set_input:
 		case SPDotExport:
 			extension = @"dot";
 			break;
+		case SPArrowExport:
+			// Arrow files are never compressed as a whole, so there is no compression extension
+			return @"arrow";
 		case SPPDFExport:
 		case SPHTMLExport:
 		case SPExcelExport:
@@ -2788,6 +3090,7 @@ set_input:
 			NAMEOF(SPPDFExport);
 			NAMEOF(SPHTMLExport);
 			NAMEOF(SPExcelExport);
+			NAMEOF(SPArrowExport);
 			NAMEOF(SPAnyExportType);
 	}
 	return nil;
@@ -2799,6 +3102,7 @@ set_input:
 	VALUEOF(SPCSVExport, etd, dst);
 	VALUEOF(SPXMLExport, etd, dst);
 	VALUEOF(SPDotExport, etd, dst);
+	VALUEOF(SPArrowExport, etd, dst);
 	//VALUEOF(SPPDFExport, etd, dst);
 	//VALUEOF(SPHTMLExport, etd, dst);
 	//VALUEOF(SPExcelExport, etd, dst);
@@ -3090,7 +3394,7 @@ set_input:
 
 	SPExportType et;
 	if((o = [dict objectForKey:@"exportType"]) && [[self class] copyExportTypeForDescription:o to:&et]) {
-		[exportTypeTabBar selectTabViewItemAtIndex:et];
+		[self _selectExportTypeTab:et];
 	}
 
 	//exportType should be changed first, as exportSource depends on it
@@ -3140,6 +3444,8 @@ set_input:
 			return [self xmlSettings];
 		case SPDotExport:
 			return [self dotSettings];
+		case SPArrowExport:
+			return [self arrowSettings];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3161,6 +3467,8 @@ set_input:
 			return [self applyXmlSettings:settings];
 		case SPDotExport:
 			return [self applyDotSettings:settings];
+		case SPArrowExport:
+			return [self applyArrowSettings:settings];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3209,6 +3517,16 @@ set_input:
 	if((o = [settings objectForKey:@"DotForceLowerTableNames"])) SetOnOff(o, exportDotForceLowerTableNamesCheck);
 }
 
+- (NSDictionary *)arrowSettings
+{
+	// Arrow has no format options of its own; compression is stored with the generic settings
+	return @{};
+}
+
+- (void)applyArrowSettings:(NSDictionary *)settings
+{
+}
+
 - (NSDictionary *)xmlSettings
 {
 	return @{
@@ -3297,6 +3615,8 @@ set_input:
 			return [self xmlSpecificSettingsForSchemaObject:name ofType:type];
 		case SPDotExport:
 			return [self dotSpecificSettingsForSchemaObject:name ofType:type];
+		case SPArrowExport:
+			return [self arrowSpecificSettingsForSchemaObject:name ofType:type];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3318,6 +3638,8 @@ set_input:
 			return [self applyXmlSpecificSettings:settings forSchemaObject:name ofType:type];
 		case SPDotExport:
 			return [self applyDotSpecificSettings:settings forSchemaObject:name ofType:type];
+		case SPArrowExport:
+			return [self applyArrowSpecificSettings:settings forSchemaObject:name ofType:type];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3339,6 +3661,17 @@ set_input:
 	//should never be called
 }
 
+- (id)arrowSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type
+{
+	// Arrow per table setting is only yes/no, exactly like XML
+	return [self xmlSpecificSettingsForSchemaObject:name ofType:type];
+}
+
+- (void)applyArrowSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type
+{
+	[self applyXmlSpecificSettings:settings forSchemaObject:name ofType:type];
+}
+
 - (id)xmlSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type
 {
 	// XML per table setting is only yes/no
@@ -3482,6 +3815,11 @@ set_input:
 
 		// If we're only exporting to a single file then write a header for the next table
 		if (!exportToMultipleFiles) {
+			SPExportFile *exportFile = [exporter exportOutputFile];
+			NSString *nextTableName = [(SPCSVExporter *)[exporters objectAtIndex:0] csvTableName];
+
+			// Start the next table in a new part if the file is split per table or has reached its split length
+			if ([exportFile needsNewPartForTable:nextTableName]) [exportFile beginNewPart];
 
 			// If we're exporting multiple tables to a single file then append some space and the next table's
 			// name, but only if there is at least 2 exportes left.
@@ -3489,7 +3827,7 @@ set_input:
 													 [exporter csvLineEndingString],
 													 [exporter csvLineEndingString],
 													 NSLocalizedString(@"Table", @"csv export table heading"),
-													 [(SPCSVExporter *)[exporters objectAtIndex:0] csvTableName],
+													 nextTableName,
 													 [exporter csvLineEndingString],
 													 [exporter csvLineEndingString]] dataUsingEncoding:[exporter exportOutputEncoding]]];
 		}
@@ -3550,12 +3888,8 @@ set_input:
 
 - (void)sqlExportProcessComplete:(SPSQLExporter *)exporter
 {
-	[self exportEnded];
-
-	// Check for errors and display the errors sheet if necessary
-	if ([exporter didExportErrorsOccur]) {
-		[self openExportErrorsSheetWithString:[exporter sqlExportErrors]];
-	}
+	// Display any errors in the errors sheet, along with any errors writing the export file
+	[self exportEndedWithErrors:([exporter didExportErrorsOccur]) ? [exporter sqlExportErrors] : nil];
 }
 
 - (void)sqlExportProcessProgressUpdated:(SPSQLExporter *)exporter
@@ -3678,6 +4012,79 @@ set_input:
 	[exportProgressIndicator setDoubleValue:0];
 }
 
+#pragma mark - SPArrowExporterDelegate
+
+- (void)arrowExportProcessWillBegin:(SPArrowExporter *)exporter
+{
+	[exportProgressText displayIfNeeded];
+
+	[exportProgressIndicator setIndeterminate:YES];
+	[exportProgressIndicator setUsesThreadedAnimation:YES];
+	[exportProgressIndicator startAnimation:self];
+
+	// Only update the progress text if this is a table export
+	if (exportSource == SPTableExport) {
+
+		// Update the current table export index
+		currentTableExportIndex = (exportTableCount - [exporters count]);
+
+		[exportProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Table %lu of %lu (%@): Fetching data...", @"export label showing that the app is fetching data for a specific table"), currentTableExportIndex, exportTableCount, [exporter arrowTableName]]];
+	}
+	else {
+		[exportProgressText setStringValue:NSLocalizedString(@"Fetching data...", @"export label showing that the app is fetching data")];
+	}
+
+	[exportProgressText displayIfNeeded];
+}
+
+- (void)arrowExportProcessComplete:(SPArrowExporter *)exporter
+{
+	// Every Arrow export has its own file, which is complete once the footer has been written
+	[[exporter exportOutputFile] close];
+
+	// A table which couldn't be read in full fails the export, skipping any remaining tables
+	if ([exporter didExportErrorsOccur]) {
+		[exporters removeAllObjects];
+
+		[self exportEndedWithErrors:[exporter arrowExportErrors]];
+	}
+	// If required add the next exporter to the operation queue
+	else if (([exporters count] > 0) && (exportSource == SPTableExport)) {
+		[operationQueue addOperation:[exporters objectAtIndex:0]];
+
+		// Remove the exporter we just added to the operation queue from our list of exporters
+		// so we know it's already been done.
+		[exporters removeObjectAtIndex:0];
+	}
+	// Otherwise if the exporter list is empty, close the progress sheet
+	else {
+		[self exportEnded];
+	}
+}
+
+- (void)arrowExportProcessProgressUpdated:(SPArrowExporter *)exporter
+{
+	[[exportProgressIndicator onMainThread] setDoubleValue:[exporter exportProgressValue]];
+}
+
+- (void)arrowExportProcessWillBeginWritingData:(SPArrowExporter *)exporter
+{
+	// Only update the progress text if this is a table export
+	if (exportSource == SPTableExport) {
+		[exportProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Table %lu of %lu (%@): Writing data...", @"export label showing app if writing data for a specific table"), currentTableExportIndex, exportTableCount, [exporter arrowTableName]]];
+	}
+	else {
+		[exportProgressText setStringValue:NSLocalizedString(@"Writing data...", @"export label showing app is writing data")];
+	}
+
+	[exportProgressText displayIfNeeded];
+
+	[exportProgressIndicator stopAnimation:self];
+	[exportProgressIndicator setUsesThreadedAnimation:NO];
+	[exportProgressIndicator setIndeterminate:NO];
+	[exportProgressIndicator setDoubleValue:0];
+}
+
 #pragma mark - SPDotExporterDelegate
 
 - (void)dotExportProcessWillBegin:(SPDotExporter *)exporter
@@ -3758,6 +4165,8 @@ set_input:
     SPClear(tables);
 	SPClear(exporters);
 	SPClear(exportFiles);
+	SPClear(exportedTableNames);
+	[self _stopExportStatistics];
 	SPClear(operationQueue);
 	SPClear(exportFilename);
 	SPClear(localizedTokenNames);
@@ -50,6 +50,14 @@
 	SPFileHandle *exportFileHandle;
 	
 	SPExportFileHandleStatus exportFileHandleStatus;
+
+	SPFileCompressionFormat compressionFormat;
+
+	unsigned long long exportFileSplitLength;
+	BOOL exportFileSplitsPerTable;
+	NSMutableArray *exportFileParts;
+	NSOperationQueue *partClosingQueue;
+	int partWriteError;
 }
 
 /**
@@ -77,14 +85,39 @@
  */
 @property (readonly) SPExportFileHandleStatus exportFileHandleStatus;
 
+/**
+ * @property exportFileSplitLength The uncompressed length after which output rolls over to a new part, or 0 to not split by size
+ */
+@property (readwrite, assign) unsigned long long exportFileSplitLength;
+
+/**
+ * @property exportFileSplitsPerTable Whether each table is written to a part of its own
+ */
+@property (readwrite, assign) BOOL exportFileSplitsPerTable;
+
 + (SPExportFile *)exportFileAtPath:(NSString *)path;
 
 - (id)initWithFilePath:(NSString *)path;
 
-- (void)close;
+- (BOOL)close;
 - (BOOL)delete;
 - (void)writeData:(NSData *)data;
 - (SPExportFileHandleStatus)createExportFileHandle:(BOOL)overwrite;
+- (SPExportFileHandleStatus)resumeExportFileHandleAtOffset:(unsigned long long)offset;
+- (unsigned long long)checkpoint;
 - (void)setCompressionFormat:(SPFileCompressionFormat)fileCompressionFormat;
 
+- (BOOL)isSplit;
+- (BOOL)needsNewPart;
+- (BOOL)needsNewPartForTable:(NSString *)tableName;
+- (BOOL)beginNewPart;
+- (void)addTableToCurrentPart:(NSString *)tableName;
+- (NSArray *)exportFilePartPaths;
+- (NSArray *)existingPartPaths;
+- (unsigned long long)suppliedDataLength;
+- (unsigned long long)fileLength;
+- (int)writeError;
+- (NSString *)partIndexPath;
+- (BOOL)writePartIndex;
+
 @end
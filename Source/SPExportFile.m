@@ -31,9 +31,18 @@
 #import "SPExportFile.h"
 #import "SPFileHandle.h"
 
+// Keys of the records of the parts a split export file is written to
+static NSString *SPExportFilePartPathKey               = @"path";
+static NSString *SPExportFilePartTablesKey             = @"tables";
+static NSString *SPExportFilePartUncompressedLengthKey = @"uncompressedBytes";
+static NSString *SPExportFilePartCompressedLengthKey   = @"compressedBytes";
+
 @interface SPExportFile ()
 
 - (SPExportFileHandleStatus)_createFileHandle;
+- (void)_applyCompressionFormat:(SPFileCompressionFormat)fileCompressionFormat toFileHandle:(SPFileHandle *)fileHandle;
+- (void)_resetPartsWithFirstPartAtPath:(NSString *)path;
+- (NSString *)_pathForPart:(NSUInteger)partNumber;
 
 @end
 
@@ -44,6 +53,8 @@
 @synthesize exportFileNeedsCSVHeader;
 @synthesize exportFileNeedsXMLHeader;
 @synthesize exportFileHandleStatus;
+@synthesize exportFileSplitLength;
+@synthesize exportFileSplitsPerTable;
 
 #pragma mark -
 #pragma mark Initialisation
@@ -74,9 +85,19 @@
 		[self setExportFilePath:path];
 		
 		exportFileHandleStatus = -1;
+		compressionFormat = SPNoCompression;
 		
 		[self setExportFileNeedsCSVHeader:NO];
 		[self setExportFileNeedsXMLHeader:NO];
+
+		exportFileSplitLength = 0;
+		exportFileSplitsPerTable = NO;
+		exportFileParts = [[NSMutableArray alloc] init];
+
+		partClosingQueue = [[NSOperationQueue alloc] init];
+		[partClosingQueue setName:@"SPExportFile part closing queue"];
+
+		partWriteError = 0;
 	}
 	
 	return self;
@@ -87,12 +108,26 @@
 
 /**
  * Closes the export file to writing.
+ *
+ * @return NO if any data - in any part of a split file - could not be written out
  */
-- (void)close
+- (BOOL)close
 {
-	if (![self exportFileHandle]) return;
+	if (![self exportFileHandle]) return YES;
 	
 	[[self exportFileHandle] closeFile];
+
+	// Wait for any earlier parts still being written out in the background
+	[partClosingQueue waitUntilAllOperationsAreFinished];
+
+	@synchronized(self) {
+		NSMutableDictionary *part = [exportFileParts lastObject];
+
+		[part setObject:@([exportFileHandle suppliedDataLength]) forKey:SPExportFilePartUncompressedLengthKey];
+		[part setObject:@([exportFileHandle fileLength]) forKey:SPExportFilePartCompressedLengthKey];
+	}
+
+	return ![self writeError];
 }
 
 /**
@@ -108,6 +143,12 @@
 	[self close];
 
 	NSFileManager *fileManager = [NSFileManager defaultManager];
+
+	// Remove any further parts the file was split into
+	for (NSString *partPath in [self exportFilePartPaths])
+	{
+		if (![partPath isEqualToString:[self exportFilePath]]) [fileManager removeItemAtPath:partPath error:nil];
+	}
 	
 	if ([fileManager fileExistsAtPath:[self exportFilePath]]) {
 		return [[NSFileManager defaultManager] removeItemAtPath:[self exportFilePath] error:nil];
@@ -137,7 +178,8 @@
 /**
  * Creates the underlying export file handle and thus the actual file on disk.
  *
- * @param overwrite If true and a file already exists at this file's location, then it'll be overwritten.
+ * @param overwrite If true and a file already exists at this file's location, then it'll be overwritten, and any
+ *                  parts of an earlier split export to the same location removed.
  * 
  * @return One of SPExportFileHandleStatus indicating the status of its creation.
  */
@@ -152,13 +194,24 @@
 	}
 	
 	NSFileManager *fileManager = [NSFileManager defaultManager];
+	BOOL fileExists = [fileManager fileExistsAtPath:[self exportFilePath]];
+
+	// Parts left by an earlier split export would be overwritten or listed alongside the new parts
+	NSArray *existingParts = [self isSplit] ? [self existingPartPaths] : @[];
 		
-	if ([fileManager fileExistsAtPath:[self exportFilePath]]) {
+	if (fileExists || [existingParts count]) {
 		
 		// If specified attempt to overwrite the file
 		if (overwrite) {
+			BOOL partsRemoved = YES;
+
+			for (NSString *partPath in existingParts)
+			{
+				if (![fileManager removeItemAtPath:partPath error:nil]) partsRemoved = NO;
+			}
+
 			// Check that it's writable first
-			if ([fileManager isWritableFileAtPath:[self exportFilePath]]) {
+			if (partsRemoved && (!fileExists || [fileManager isWritableFileAtPath:[self exportFilePath]])) {
 				exportFileHandleStatus = [self _createFileHandle];
 			}
 			// The file is not writable, so return that we failed.
@@ -178,6 +231,39 @@
 	return exportFileHandleStatus;
 }
 
+/**
+ * Reopens an existing export file to resume writing it, discarding anything written after
+ * the supplied offset.
+ *
+ * @param offset The length of the file at the checkpoint being resumed from
+ *
+ * @return One of SPExportFileHandleStatus indicating the status of its creation.
+ */
+- (SPExportFileHandleStatus)resumeExportFileHandleAtOffset:(unsigned long long)offset
+{
+	if (exportFileHandle) SPClear(exportFileHandle);
+
+	exportFileHandle = [[SPFileHandle fileHandleForAppendingAtPath:[self exportFilePath] truncatingToLength:offset] retain];
+
+	exportFileHandleStatus = (exportFileHandle) ? SPExportFileHandleCreated : SPExportFileHandleFailed;
+
+	if (exportFileHandle) [self _resetPartsWithFirstPartAtPath:[self exportFilePath]];
+
+	return exportFileHandleStatus;
+}
+
+/**
+ * Writes all data written so far durably to disk, so the export can be resumed from this point.
+ *
+ * @return The length of the file to resume from, or 0 if it could not be written out
+ */
+- (unsigned long long)checkpoint
+{
+	if (![self exportFileHandle]) return 0;
+
+	return [[self exportFileHandle] checkpoint];
+}
+
 /**
  * Sets the compression level on the newly created file. Throws an exception
  * if attempting to set the compression level when no file handle exists.
@@ -191,7 +277,258 @@
 		return;
 	}
 
-	[[self exportFileHandle] setCompressionFormat:fileCompressionFormat];
+	// Remember the format, so any further parts are compressed the same way
+	compressionFormat = fileCompressionFormat;
+
+	[self _applyCompressionFormat:fileCompressionFormat toFileHandle:[self exportFileHandle]];
+}
+
+#pragma mark -
+#pragma mark Split Output
+
+/**
+ * Returns whether output is split across several part files, by size or per table.
+ */
+- (BOOL)isSplit
+{
+	return (exportFileSplitLength > 0 || exportFileSplitsPerTable);
+}
+
+/**
+ * Returns whether the current part has reached the split length, so output should roll over
+ * to a new part at the next statement or row boundary.
+ */
+- (BOOL)needsNewPart
+{
+	if (!exportFileSplitLength || ![self exportFileHandle]) return NO;
+
+	return ([[self exportFileHandle] suppliedDataLength] >= exportFileSplitLength);
+}
+
+/**
+ * Returns whether output should roll over to a new part before the supplied table is written -
+ * either because the current part has reached the split length, or because each table is split
+ * into a part of its own and the current part already holds another table.
+ *
+ * @param tableName The name of the table about to be written
+ */
+- (BOOL)needsNewPartForTable:(NSString *)tableName
+{
+	if (exportFileSplitsPerTable) {
+		NSArray *partTables = [[exportFileParts lastObject] objectForKey:SPExportFilePartTablesKey];
+
+		if ([partTables count] && ![[partTables lastObject] isEqualToString:tableName]) return YES;
+	}
+
+	return [self needsNewPart];
+}
+
+/**
+ * Ends the current part and continues output in a new part file alongside it.  The ended part is
+ * closed on a background queue, so its remaining data is compressed and written out independently
+ * while output continues in the new part.  Callers are responsible for only splitting output at a
+ * statement or row boundary, and for writing any header the new part needs.
+ *
+ * @return A BOOL indicating whether the new part was created; if not, output continues in the current part
+ */
+- (BOOL)beginNewPart
+{
+	if (![self exportFileHandle]) return NO;
+
+	NSString *partPath = [self _pathForPart:[exportFileParts count] + 1];
+
+	// Never overwrite a file which appeared after the existing parts were checked for
+	if ([[NSFileManager defaultManager] fileExistsAtPath:partPath]) return NO;
+
+	if (![[NSFileManager defaultManager] createFileAtPath:partPath contents:[NSData data] attributes:nil]) return NO;
+
+	SPFileHandle *partFileHandle = [SPFileHandle fileHandleForWritingAtPath:partPath];
+
+	if (!partFileHandle) {
+		[[NSFileManager defaultManager] removeItemAtPath:partPath error:nil];
+
+		return NO;
+	}
+
+	[self _applyCompressionFormat:compressionFormat toFileHandle:partFileHandle];
+
+	SPFileHandle *previousFileHandle;
+	NSMutableDictionary *previousPart;
+
+	@synchronized(self) {
+		previousFileHandle = exportFileHandle;
+		previousPart = [exportFileParts lastObject];
+
+		exportFileHandle = [partFileHandle retain];
+
+		[exportFileParts addObject:[NSMutableDictionary dictionaryWithObjectsAndKeys:partPath, SPExportFilePartPathKey, [NSMutableArray array], SPExportFilePartTablesKey, nil]];
+	}
+
+	[partClosingQueue addOperationWithBlock:^{
+		BOOL previousPartWritten = [previousFileHandle closeFile];
+
+		@synchronized(self) {
+			if (!previousPartWritten && !partWriteError) partWriteError = [previousFileHandle writeError];
+
+			[previousPart setObject:@([previousFileHandle suppliedDataLength]) forKey:SPExportFilePartUncompressedLengthKey];
+			[previousPart setObject:@([previousFileHandle fileLength]) forKey:SPExportFilePartCompressedLengthKey];
+		}
+
+		[previousFileHandle release];
+	}];
+
+	return YES;
+}
+
+/**
+ * Records that the supplied table is written to the current part, for the part index.
+ *
+ * @param tableName The name of the table
+ */
+- (void)addTableToCurrentPart:(NSString *)tableName
+{
+	if (![self isSplit] || !tableName) return;
+
+	@synchronized(self) {
+		NSMutableArray *partTables = [[exportFileParts lastObject] objectForKey:SPExportFilePartTablesKey];
+
+		if (![[partTables lastObject] isEqualToString:tableName]) [partTables addObject:tableName];
+	}
+}
+
+/**
+ * Returns the paths of the parts the file has been written to, in order; the first part is
+ * always at the file's own path.
+ */
+- (NSArray *)exportFilePartPaths
+{
+	@synchronized(self) {
+		return [exportFileParts valueForKey:SPExportFilePartPathKey];
+	}
+}
+
+/**
+ * Returns the paths of any files already on disk which are named as further parts of the file, or
+ * as its part index, such as those left by an earlier split export to the same path.
+ */
+- (NSArray *)existingPartPaths
+{
+	NSMutableArray *paths = [NSMutableArray array];
+	NSString *directory = [[self exportFilePath] stringByDeletingLastPathComponent];
+	NSString *partNameTemplate = [[self _pathForPart:2] lastPathComponent];
+	NSRange partNumberRange = [partNameTemplate rangeOfString:@"-part0002" options:NSBackwardsSearch];
+	NSString *partNamePrefix = [partNameTemplate substringToIndex:partNumberRange.location + 5];
+	NSString *partNameSuffix = [partNameTemplate substringFromIndex:NSMaxRange(partNumberRange)];
+	NSCharacterSet *nonDigits = [[NSCharacterSet decimalDigitCharacterSet] invertedSet];
+
+	for (NSString *name in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:NULL])
+	{
+		if ([name length] < [partNamePrefix length] + [partNameSuffix length] + 4 || ![name hasPrefix:partNamePrefix] || ![name hasSuffix:partNameSuffix]) continue;
+
+		NSString *partNumber = [name substringWithRange:NSMakeRange([partNamePrefix length], [name length] - [partNamePrefix length] - [partNameSuffix length])];
+
+		if ([partNumber rangeOfCharacterFromSet:nonDigits].location == NSNotFound) [paths addObject:[directory stringByAppendingPathComponent:name]];
+	}
+
+	if ([[NSFileManager defaultManager] fileExistsAtPath:[self partIndexPath]]) [paths addObject:[self partIndexPath]];
+
+	return paths;
+}
+
+/**
+ * Returns the length of the uncompressed data written to all the parts of the file.
+ */
+- (unsigned long long)suppliedDataLength
+{
+	unsigned long long length = 0;
+
+	@synchronized(self) {
+		for (NSDictionary *part in exportFileParts)
+		{
+			if (part != [exportFileParts lastObject]) length += [[part objectForKey:SPExportFilePartUncompressedLengthKey] unsignedLongLongValue];
+		}
+
+		length += [exportFileHandle suppliedDataLength];
+	}
+
+	return length;
+}
+
+/**
+ * Returns the length on disk of all the parts of the file.
+ */
+- (unsigned long long)fileLength
+{
+	unsigned long long length = 0;
+
+	@synchronized(self) {
+		for (NSDictionary *part in exportFileParts)
+		{
+			length += [[[NSFileManager defaultManager] attributesOfItemAtPath:[part objectForKey:SPExportFilePartPathKey] error:NULL] fileSize];
+		}
+	}
+
+	return length;
+}
+
+/**
+ * Returns the error number - as errno - of the first write to any part of the file which
+ * failed, or 0 if all data written so far has been written out.
+ */
+- (int)writeError
+{
+	int errorNumber;
+
+	@synchronized(self) {
+		errorNumber = (partWriteError) ? partWriteError : [exportFileHandle writeError];
+	}
+
+	return errorNumber;
+}
+
+/**
+ * Returns the path of the index listing the parts of a split file.
+ */
+- (NSString *)partIndexPath
+{
+	return [[self exportFilePath] stringByAppendingPathExtension:@"parts.json"];
+}
+
+/**
+ * Writes an index of the parts of a split file and the tables each holds, so the parts can be
+ * located and imported in parallel.  Parts are listed in the order they were written; a part
+ * holding a table continued from the previous part can still be imported on its own, as a split
+ * is only ever made between statements.  Should be called once the file has been closed.
+ *
+ * @return A BOOL indicating whether the index was written
+ */
+- (BOOL)writePartIndex
+{
+	if (![self isSplit]) return NO;
+
+	NSMutableArray *parts = [NSMutableArray array];
+
+	@synchronized(self) {
+		for (NSDictionary *part in exportFileParts)
+		{
+			NSMutableDictionary *partIndex = [NSMutableDictionary dictionaryWithDictionary:part];
+
+			// Parts are listed relative to the index, so the files can be moved together
+			[partIndex setObject:[[part objectForKey:SPExportFilePartPathKey] lastPathComponent] forKey:SPExportFilePartPathKey];
+
+			[parts addObject:partIndex];
+		}
+	}
+
+	NSDictionary *index = @{
+		@"splitLength"    : @(exportFileSplitLength),
+		@"splitsPerTable" : @(exportFileSplitsPerTable),
+		@"parts"          : parts
+	};
+
+	NSData *indexData = [NSJSONSerialization dataWithJSONObject:index options:NSJSONWritingPrettyPrinted error:NULL];
+
+	return (indexData && [indexData writeToFile:[self partIndexPath] atomically:YES]);
 }
 
 #pragma mark -
@@ -218,15 +555,70 @@
 		
 		return SPExportFileHandleFailed;
 	}
+
+	[self _resetPartsWithFirstPartAtPath:[self exportFilePath]];
 	
 	return SPExportFileHandleCreated;
 }
 
+/**
+ * Sets the compression format and the level configured for it on the supplied file handle.
+ */
+- (void)_applyCompressionFormat:(SPFileCompressionFormat)fileCompressionFormat toFileHandle:(SPFileHandle *)fileHandle
+{
+	[fileHandle setCompressionLevel:[[NSUserDefaults standardUserDefaults] integerForKey:SPExportGzipCompressionLevel]];
+	[fileHandle setCompressionFormat:fileCompressionFormat];
+}
+
+/**
+ * Starts recording parts afresh, with the file's own path as the first part.
+ */
+- (void)_resetPartsWithFirstPartAtPath:(NSString *)path
+{
+	@synchronized(self) {
+		partWriteError = 0;
+
+		[exportFileParts removeAllObjects];
+		[exportFileParts addObject:[NSMutableDictionary dictionaryWithObjectsAndKeys:path, SPExportFilePartPathKey, [NSMutableArray array], SPExportFilePartTablesKey, nil]];
+	}
+}
+
+/**
+ * Returns the path of the supplied part of a split file.  The first part is the file itself; further
+ * parts insert their number before the extensions, so "dump.sql.gz" continues in "dump-part0002.sql.gz".
+ */
+- (NSString *)_pathForPart:(NSUInteger)partNumber
+{
+	if (partNumber <= 1) return [self exportFilePath];
+
+	NSString *partName = [[self exportFilePath] lastPathComponent];
+	NSString *extension = [partName pathExtension];
+
+	partName = [partName stringByDeletingPathExtension];
+
+	// Keep the extension of a compressed file's format together with its compression extension
+	if ([@[@"gz", @"bz2"] containsObject:[extension lowercaseString]] && [[partName pathExtension] length]) {
+		extension = [[partName pathExtension] stringByAppendingPathExtension:extension];
+		partName = [partName stringByDeletingPathExtension];
+	}
+
+	partName = [partName stringByAppendingFormat:@"-part%04lu", (unsigned long)partNumber];
+
+	if ([extension length]) partName = [partName stringByAppendingPathExtension:extension];
+
+	return [[[self exportFilePath] stringByDeletingLastPathComponent] stringByAppendingPathComponent:partName];
+}
+
 #pragma mark -
 
 - (void)dealloc
 {
+	[partClosingQueue waitUntilAllOperationsAreFinished];
+
 	if (exportFileHandle) SPClear(exportFileHandle);
+
+	SPClear(exportFileParts);
+	SPClear(partClosingQueue);
 	
 	[super dealloc];
 }
@@ -0,0 +1,91 @@
+//
+//  SPExportRowSource.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPDataStorage;
+
+/**
+ * @protocol SPExportRowSource SPExportRowSource.h
+ *
+ * A source of rows which are already held in memory, such as a loaded custom query result, from
+ * which an exporter can write rows without querying the server.  Cells are returned as strings,
+ * or NSNull for NULL values.
+ *
+ * Rows may be requested concurrently from several threads, so that exporters can serialize
+ * chunks of rows in parallel.
+ */
+@protocol SPExportRowSource <NSObject>
+
+- (NSArray *)exportFieldNames;
+- (NSUInteger)numberOfExportRows;
+- (NSArray *)exportRowAtIndex:(NSUInteger)rowIndex;
+
+@end
+
+/**
+ * @class SPExportArrayRowSource SPExportRowSource.h
+ *
+ * Supplies the rows of a data array, the first object of which contains the field names, as
+ * returned by -[SPTableContent currentDataResultWithNULLs:hideBLOBs:].
+ */
+@interface SPExportArrayRowSource : NSObject <SPExportRowSource>
+{
+	NSArray *dataArray;
+}
+
++ (SPExportArrayRowSource *)rowSourceWithDataArray:(NSArray *)array;
+
+- (id)initWithDataArray:(NSArray *)array;
+
+@end
+
+/**
+ * @class SPExportDataStorageRowSource SPExportRowSource.h
+ *
+ * Supplies rows directly from a SPDataStorage instance, reading only the specified storage
+ * columns in the order given.  Geometry values are returned as WKT and binary data as strings
+ * in the supplied encoding, as shown in the result view.
+ *
+ * The storage is read without locking, so it must be fully loaded and must not be modified
+ * while rows are being exported.
+ */
+@interface SPExportDataStorageRowSource : NSObject <SPExportRowSource>
+{
+	SPDataStorage *dataStorage;
+
+	NSArray *fieldNames;
+	NSUInteger numberOfColumns;
+	NSUInteger *columnMappings;
+
+	NSStringEncoding stringEncoding;
+}
+
+- (id)initWithDataStorage:(SPDataStorage *)storage columns:(NSArray *)storageColumnIndexes names:(NSArray *)names stringEncoding:(NSStringEncoding)encoding;
+
+@end
@@ -0,0 +1,151 @@
+//
+//  SPExportRowSource.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportRowSource.h"
+#import "SPDataStorage.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+@implementation SPExportArrayRowSource
+
++ (SPExportArrayRowSource *)rowSourceWithDataArray:(NSArray *)array
+{
+	return [[[SPExportArrayRowSource alloc] initWithDataArray:array] autorelease];
+}
+
+/**
+ * Initialise a row source for the supplied data array, the first object of which contains the field names.
+ */
+- (id)initWithDataArray:(NSArray *)array
+{
+	if ((self = [super init])) {
+		dataArray = [array retain];
+	}
+
+	return self;
+}
+
+- (NSArray *)exportFieldNames
+{
+	return ([dataArray count]) ? NSArrayObjectAtIndex(dataArray, 0) : [NSArray array];
+}
+
+- (NSUInteger)numberOfExportRows
+{
+	return ([dataArray count]) ? [dataArray count] - 1 : 0;
+}
+
+- (NSArray *)exportRowAtIndex:(NSUInteger)rowIndex
+{
+	return NSArrayObjectAtIndex(dataArray, rowIndex + 1);
+}
+
+- (void)dealloc
+{
+	SPClear(dataArray);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@implementation SPExportDataStorageRowSource
+
+/**
+ * Initialise a row source for the supplied data storage.
+ *
+ * @param storage              The data storage holding the loaded result
+ * @param storageColumnIndexes The data storage column of each exported column, as NSNumbers
+ * @param names                The name of each exported column
+ * @param encoding             The encoding binary data is interpreted in
+ */
+- (id)initWithDataStorage:(SPDataStorage *)storage columns:(NSArray *)storageColumnIndexes names:(NSArray *)names stringEncoding:(NSStringEncoding)encoding
+{
+	if ((self = [super init])) {
+		dataStorage = [storage retain];
+		fieldNames = [names copy];
+		stringEncoding = encoding;
+
+		numberOfColumns = [storageColumnIndexes count];
+		columnMappings = calloc(MAX(numberOfColumns, 1), sizeof(NSUInteger));
+
+		for (NSUInteger i = 0; i < numberOfColumns; i++)
+		{
+			columnMappings[i] = [NSArrayObjectAtIndex(storageColumnIndexes, i) unsignedIntegerValue];
+		}
+	}
+
+	return self;
+}
+
+- (NSArray *)exportFieldNames
+{
+	return fieldNames;
+}
+
+- (NSUInteger)numberOfExportRows
+{
+	return [dataStorage count];
+}
+
+- (NSArray *)exportRowAtIndex:(NSUInteger)rowIndex
+{
+	NSMutableArray *row = [NSMutableArray arrayWithCapacity:numberOfColumns];
+
+	for (NSUInteger i = 0; i < numberOfColumns; i++)
+	{
+		id value = SPDataStorageObjectAtRowAndColumn(dataStorage, rowIndex, columnMappings[i]);
+
+		if ([value isKindOfClass:[SPMySQLGeometryData class]]) {
+			value = [value wktString];
+		}
+		else if ([value isKindOfClass:[NSData class]]) {
+			value = [value stringRepresentationUsingEncoding:stringEncoding];
+		}
+
+		[row addObject:(value) ? value : [NSNull null]];
+	}
+
+	return row;
+}
+
+- (void)dealloc
+{
+	SPClear(dataStorage);
+	SPClear(fieldNames);
+
+	free(columnMappings);
+
+	[super dealloc];
+}
+
+@end
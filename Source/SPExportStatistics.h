@@ -0,0 +1,101 @@
+//
+//  SPExportStatistics.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMySQLConnection;
+
+// Keys of the table statistics dictionaries
+extern NSString *SPExportStatisticsTableNameKey;
+extern NSString *SPExportStatisticsRowCountKey;
+extern NSString *SPExportStatisticsElapsedTimeKey;
+extern NSString *SPExportStatisticsServerWaitTimeKey;
+extern NSString *SPExportStatisticsCompleteKey;
+
+// Keys of the table size estimate dictionaries
+extern NSString *SPExportStatisticsEstimatedDataLengthKey;
+extern NSString *SPExportStatisticsEstimatedRowCountKey;
+
+/**
+ * @class SPExportStatistics SPExportStatistics.h
+ *
+ * Measures the throughput of an export while it runs, from the row counts and server wait times kept by
+ * its exporters and the write statistics of its files' handles.  Sampled periodically on the main thread
+ * for the progress sheet, and summarised in a report once the export has ended.
+ *
+ * Time spent waiting is split three ways: on the server, as the time exporters waited for rows; on the disk
+ * or compressor, as the time exporters were blocked writing data; and on the serializers, as the remaining
+ * time the files' background writers spent waiting for data to be supplied.
+ *
+ * The time remaining is estimated from the tables' data lengths, as reported by the server: tables which
+ * have been read count in full, and tables being read in proportion to the rows read against the server's
+ * row estimate.
+ */
+@interface SPExportStatistics : NSObject
+{
+	NSArray *exporters;
+	NSArray *exportFiles;
+	NSDictionary *tableSizeEstimates;
+
+	NSTimeInterval startTime;
+	NSTimeInterval endTime;
+
+	NSTimeInterval lastSampleTime;
+	unsigned long long lastSampleRowCount;
+	unsigned long long lastSampleUncompressedLength;
+	unsigned long long lastSampleCompressedLength;
+
+	double rowRate;
+	double uncompressedRate;
+	double compressedRate;
+}
+
++ (NSDictionary *)tableSizeEstimatesForTables:(NSArray *)tableNames connection:(SPMySQLConnection *)connection;
+
+- (id)initWithExporters:(NSArray *)theExporters exportFiles:(NSArray *)theExportFiles tableSizeEstimates:(NSDictionary *)estimates;
+
+- (void)sample;
+- (void)exportDidEnd;
+
+- (NSTimeInterval)elapsedTime;
+- (unsigned long long)rowCount;
+- (unsigned long long)uncompressedLength;
+- (unsigned long long)compressedLength;
+- (double)compressionRatio;
+
+- (double)serverWaitTime;
+- (double)serializerWaitTime;
+- (double)diskWaitTime;
+
+- (NSTimeInterval)estimatedTimeRemaining;
+
+- (NSString *)progressDescription;
+- (NSDictionary *)report;
+- (BOOL)writeReportToFile:(NSString *)path;
+
+@end
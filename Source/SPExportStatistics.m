@@ -0,0 +1,468 @@
+//
+//  SPExportStatistics.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportStatistics.h"
+#import "SPExporter.h"
+#import "SPExportFile.h"
+#import "SPFileHandle.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+NSString *SPExportStatisticsTableNameKey            = @"table";
+NSString *SPExportStatisticsRowCountKey             = @"rows";
+NSString *SPExportStatisticsElapsedTimeKey          = @"elapsedSeconds";
+NSString *SPExportStatisticsServerWaitTimeKey       = @"serverWaitSeconds";
+NSString *SPExportStatisticsCompleteKey             = @"complete";
+NSString *SPExportStatisticsEstimatedDataLengthKey  = @"estimatedDataLength";
+NSString *SPExportStatisticsEstimatedRowCountKey    = @"estimatedRows";
+
+// The time an export must have run for before its remaining time is estimated
+static const NSTimeInterval SPExportStatisticsMinimumEstimateTime = 2.0;
+
+// The proportion of a table's data length counted as read until the table has been read completely,
+// as the server's row estimates may be low
+static const double SPExportStatisticsMaximumTableFraction = 0.95;
+
+@interface SPExportStatistics ()
+
+- (NSTimeInterval)_currentTime;
+- (NSString *)_nameOfCompressionFormat:(SPFileCompressionFormat)format;
+- (NSNumber *)_finiteNumber:(double)value;
+
+@end
+
+@implementation SPExportStatistics
+
+/**
+ * Returns the data length and row count estimated by the server for each of the supplied tables in the
+ * connection's current database, keyed by table name.  Views and tables the server has no estimates
+ * for are omitted.
+ */
++ (NSDictionary *)tableSizeEstimatesForTables:(NSArray *)tableNames connection:(SPMySQLConnection *)connection
+{
+	NSMutableDictionary *estimates = [NSMutableDictionary dictionary];
+
+	if (![tableNames count]) return estimates;
+
+	SPMySQLResult *statusResult = [connection queryString:@"SHOW TABLE STATUS"];
+
+	if ([connection queryErrored]) return estimates;
+
+	[statusResult setReturnDataAsStrings:YES];
+
+	NSSet *tableNameSet = [NSSet setWithArray:tableNames];
+
+	for (NSDictionary *tableStatus in statusResult)
+	{
+		NSString *tableName = [tableStatus objectForKey:@"Name"];
+		id dataLength = [tableStatus objectForKey:@"Data_length"];
+		id rowCount = [tableStatus objectForKey:@"Rows"];
+
+		if (![tableNameSet containsObject:tableName] || [dataLength isNSNull] || [rowCount isNSNull]) continue;
+
+		[estimates setObject:@{
+			SPExportStatisticsEstimatedDataLengthKey : @([dataLength longLongValue]),
+			SPExportStatisticsEstimatedRowCountKey   : @([rowCount longLongValue])
+		} forKey:tableName];
+	}
+
+	return estimates;
+}
+
+/**
+ * Initialise statistics for an export, starting its timing.
+ *
+ * @param theExporters     All of the exporters of the export, including those not yet started
+ * @param theExportFiles   The files the export writes to
+ * @param estimates        The table size estimates of the tables being exported, as returned by
+ *                         +tableSizeEstimatesForTables:connection:, or nil if not a table export
+ */
+- (id)initWithExporters:(NSArray *)theExporters exportFiles:(NSArray *)theExportFiles tableSizeEstimates:(NSDictionary *)estimates
+{
+	if ((self = [super init])) {
+		exporters = [[NSArray alloc] initWithArray:theExporters];
+		exportFiles = [[NSArray alloc] initWithArray:theExportFiles];
+		tableSizeEstimates = [[NSDictionary alloc] initWithDictionary:(estimates ? estimates : @{})];
+
+		startTime = [self _currentTime];
+		endTime = 0;
+
+		lastSampleTime = startTime;
+		lastSampleRowCount = 0;
+		lastSampleUncompressedLength = 0;
+		lastSampleCompressedLength = 0;
+
+		rowRate = 0;
+		uncompressedRate = 0;
+		compressedRate = 0;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Sampling
+
+/**
+ * Update the current rates from the progress made since the previous sample.
+ */
+- (void)sample
+{
+	NSTimeInterval now = [self _currentTime];
+	NSTimeInterval interval = now - lastSampleTime;
+
+	if (interval <= 0) return;
+
+	unsigned long long currentRowCount = [self rowCount];
+	unsigned long long currentUncompressedLength = [self uncompressedLength];
+	unsigned long long currentCompressedLength = [self compressedLength];
+
+	rowRate = (currentRowCount - MIN(lastSampleRowCount, currentRowCount)) / interval;
+	uncompressedRate = (currentUncompressedLength - MIN(lastSampleUncompressedLength, currentUncompressedLength)) / interval;
+	compressedRate = (currentCompressedLength - MIN(lastSampleCompressedLength, currentCompressedLength)) / interval;
+
+	lastSampleTime = now;
+	lastSampleRowCount = currentRowCount;
+	lastSampleUncompressedLength = currentUncompressedLength;
+	lastSampleCompressedLength = currentCompressedLength;
+}
+
+/**
+ * Stop the export's timing.
+ */
+- (void)exportDidEnd
+{
+	if (!endTime) endTime = [self _currentTime];
+}
+
+#pragma mark -
+#pragma mark Totals
+
+- (NSTimeInterval)elapsedTime
+{
+	return (endTime ? endTime : [self _currentTime]) - startTime;
+}
+
+- (unsigned long long)rowCount
+{
+	unsigned long long rowCount = 0;
+
+	for (SPExporter *exporter in exporters)
+	{
+		rowCount += [exporter exportRowCount];
+	}
+
+	return rowCount;
+}
+
+/**
+ * Returns the length of the data written by the exporters, before compression.
+ */
+- (unsigned long long)uncompressedLength
+{
+	unsigned long long length = 0;
+
+	for (SPExportFile *file in exportFiles)
+	{
+		length += [file suppliedDataLength];
+	}
+
+	return length;
+}
+
+/**
+ * Returns the length of the export files on disk, including all the parts of split files.
+ */
+- (unsigned long long)compressedLength
+{
+	unsigned long long length = 0;
+
+	for (SPExportFile *file in exportFiles)
+	{
+		length += [file fileLength];
+	}
+
+	return length;
+}
+
+- (double)compressionRatio
+{
+	unsigned long long compressedLength = [self compressedLength];
+
+	return (compressedLength) ? ((double)[self uncompressedLength] / compressedLength) : 0;
+}
+
+#pragma mark -
+#pragma mark Waiting
+
+- (double)serverWaitTime
+{
+	double waitTime = 0;
+
+	for (SPExporter *exporter in exporters)
+	{
+		waitTime += [exporter exportServerWaitTime];
+	}
+
+	return waitTime;
+}
+
+/**
+ * Returns the time the files' background writers waited for data which wasn't spent waiting for the server.
+ */
+- (double)serializerWaitTime
+{
+	double idleTime = 0;
+
+	for (SPExportFile *file in exportFiles)
+	{
+		idleTime += [[file exportFileHandle] writerIdleTime];
+	}
+
+	return MAX(idleTime - [self serverWaitTime], 0);
+}
+
+/**
+ * Returns the time exporters were blocked waiting for the files' background writers to compress and write data.
+ */
+- (double)diskWaitTime
+{
+	double blockedTime = 0;
+
+	for (SPExportFile *file in exportFiles)
+	{
+		blockedTime += [[file exportFileHandle] writeBlockedTime];
+	}
+
+	return blockedTime;
+}
+
+#pragma mark -
+#pragma mark Estimates
+
+/**
+ * Returns the estimated time remaining until all the tables have been read, or -1 if it can't be estimated.
+ */
+- (NSTimeInterval)estimatedTimeRemaining
+{
+	double totalLength = 0;
+	double completedLength = 0;
+
+	for (NSDictionary *estimate in [tableSizeEstimates allValues])
+	{
+		totalLength += [[estimate objectForKey:SPExportStatisticsEstimatedDataLengthKey] doubleValue];
+	}
+
+	if (totalLength <= 0) return -1;
+
+	for (SPExporter *exporter in exporters)
+	{
+		for (NSDictionary *table in [exporter exportTableStatistics])
+		{
+			NSDictionary *estimate = [tableSizeEstimates objectForKey:[table objectForKey:SPExportStatisticsTableNameKey]];
+
+			if (!estimate) continue;
+
+			double dataLength = [[estimate objectForKey:SPExportStatisticsEstimatedDataLengthKey] doubleValue];
+			double estimatedRowCount = [[estimate objectForKey:SPExportStatisticsEstimatedRowCountKey] doubleValue];
+
+			if ([[table objectForKey:SPExportStatisticsCompleteKey] boolValue]) {
+				completedLength += dataLength;
+			}
+			else if (estimatedRowCount > 0) {
+				completedLength += dataLength * MIN([[table objectForKey:SPExportStatisticsRowCountKey] doubleValue] / estimatedRowCount, SPExportStatisticsMaximumTableFraction);
+			}
+		}
+	}
+
+	NSTimeInterval elapsedTime = [self elapsedTime];
+
+	if (completedLength <= 0 || elapsedTime < SPExportStatisticsMinimumEstimateTime) return -1;
+
+	return MAX(elapsedTime * (totalLength - completedLength) / completedLength, 0);
+}
+
+#pragma mark -
+#pragma mark Reporting
+
+/**
+ * Returns a single line describing the current rates and the estimated time remaining, for the progress sheet.
+ */
+- (NSString *)progressDescription
+{
+	NSNumberFormatter *numberFormatter = [[[NSNumberFormatter alloc] init] autorelease];
+
+	[numberFormatter setNumberStyle:NSNumberFormatterDecimalStyle];
+	[numberFormatter setMaximumFractionDigits:0];
+
+	NSMutableString *description = [NSMutableString stringWithFormat:NSLocalizedString(@"%@ rows/s, %@/s", @"export statistics rows and bytes per second"), [numberFormatter stringFromNumber:@(rowRate)], [NSString stringForByteSize:(long long)uncompressedRate]];
+
+	if (compressedRate > 0 && [self compressionRatio] > 1.05) {
+		[description appendFormat:NSLocalizedString(@" (%@/s compressed)", @"export statistics compressed bytes per second"), [NSString stringForByteSize:(long long)compressedRate]];
+	}
+
+	NSTimeInterval timeRemaining = [self estimatedTimeRemaining];
+
+	if (timeRemaining >= 0) {
+		[description appendFormat:NSLocalizedString(@" – about %@ remaining", @"export statistics estimated time remaining"), [NSString stringForTimeInterval:timeRemaining]];
+	}
+
+	return description;
+}
+
+/**
+ * Returns a summary of the export's statistics, including those of each table and file, which can be
+ * serialized as JSON.
+ */
+- (NSDictionary *)report
+{
+	NSTimeInterval elapsedTime = [self elapsedTime];
+	unsigned long long rowCount = [self rowCount];
+	unsigned long long uncompressedLength = [self uncompressedLength];
+	unsigned long long compressedLength = [self compressedLength];
+
+	NSMutableArray *tables = [NSMutableArray array];
+	NSMutableArray *files = [NSMutableArray array];
+
+	for (SPExporter *exporter in exporters)
+	{
+		for (NSDictionary *table in [exporter exportTableStatistics])
+		{
+			NSMutableDictionary *tableReport = [NSMutableDictionary dictionaryWithDictionary:table];
+			NSDictionary *estimate = [tableSizeEstimates objectForKey:[table objectForKey:SPExportStatisticsTableNameKey]];
+			double tableElapsedTime = [[table objectForKey:SPExportStatisticsElapsedTimeKey] doubleValue];
+
+			[tableReport setObject:NSStringFromClass([exporter class]) forKey:@"exporter"];
+			[tableReport setObject:[self _finiteNumber:(tableElapsedTime > 0) ? ([[table objectForKey:SPExportStatisticsRowCountKey] doubleValue] / tableElapsedTime) : 0] forKey:@"rowsPerSecond"];
+
+			if (estimate) [tableReport addEntriesFromDictionary:estimate];
+
+			[tables addObject:tableReport];
+		}
+	}
+
+	for (SPExportFile *file in exportFiles)
+	{
+		SPFileHandle *fileHandle = [file exportFileHandle];
+
+		if (!fileHandle) continue;
+
+		[files addObject:@{
+			@"path"                : [file exportFilePath],
+			@"compressionFormat"   : [self _nameOfCompressionFormat:[fileHandle compressionFormat]],
+			@"parts"               : @([[file exportFilePartPaths] count]),
+			@"uncompressedBytes"   : @([file suppliedDataLength]),
+			@"compressedBytes"     : @([file fileLength]),
+			@"writeBlockedSeconds" : [self _finiteNumber:[fileHandle writeBlockedTime]],
+			@"writerIdleSeconds"   : [self _finiteNumber:[fileHandle writerIdleTime]],
+			@"writerActiveSeconds" : [self _finiteNumber:[fileHandle writerActiveTime]],
+			@"writeThroughput"     : [self _finiteNumber:[fileHandle writeThroughput]]
+		}];
+	}
+
+	return @{
+		@"elapsedSeconds"             : [self _finiteNumber:elapsedTime],
+		@"rows"                       : @(rowCount),
+		@"rowsPerSecond"              : [self _finiteNumber:(elapsedTime > 0) ? (rowCount / elapsedTime) : 0],
+		@"uncompressedBytes"          : @(uncompressedLength),
+		@"uncompressedBytesPerSecond" : [self _finiteNumber:(elapsedTime > 0) ? (uncompressedLength / elapsedTime) : 0],
+		@"compressedBytes"            : @(compressedLength),
+		@"compressedBytesPerSecond"   : [self _finiteNumber:(elapsedTime > 0) ? (compressedLength / elapsedTime) : 0],
+		@"compressionRatio"           : [self _finiteNumber:[self compressionRatio]],
+		@"serverWaitSeconds"          : [self _finiteNumber:[self serverWaitTime]],
+		@"serializerWaitSeconds"      : [self _finiteNumber:[self serializerWaitTime]],
+		@"diskWaitSeconds"            : [self _finiteNumber:[self diskWaitTime]],
+		@"tables"                     : tables,
+		@"files"                      : files
+	};
+}
+
+/**
+ * Write the report to the supplied path as JSON.
+ *
+ * @return A BOOL indicating whether the report was written
+ */
+- (BOOL)writeReportToFile:(NSString *)path
+{
+	NSError *error = nil;
+	NSData *reportData = [NSJSONSerialization dataWithJSONObject:[self report] options:NSJSONWritingPrettyPrinted error:&error];
+
+	if (!reportData) {
+		NSLog(@"Failed to serialize export statistics: %@", [error localizedDescription]);
+		return NO;
+	}
+
+	return [reportData writeToFile:path atomically:YES];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns the time the statistics are measured at; overridden to measure against a fixed clock in tests.
+ */
+- (NSTimeInterval)_currentTime
+{
+	return [NSDate timeIntervalSinceReferenceDate];
+}
+
+- (NSString *)_nameOfCompressionFormat:(SPFileCompressionFormat)format
+{
+	switch (format)
+	{
+		case SPGzipCompression:
+			return @"gzip";
+		case SPBzip2Compression:
+			return @"bzip2";
+		default:
+			return @"none";
+	}
+}
+
+/**
+ * JSON can't represent infinite or NaN values, so report them as 0.
+ */
+- (NSNumber *)_finiteNumber:(double)value
+{
+	return @(isfinite(value) ? value : 0);
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(exporters);
+	SPClear(exportFiles);
+	SPClear(tableSizeEstimates);
+
+	[super dealloc];
+}
+
+@end
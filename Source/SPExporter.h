@@ -53,6 +53,8 @@
  * explicity called.
  */
 
+#import "SPExportRowSource.h"
+
 @class SPMySQLConnection, SPExportFile, SPServerSupport;
 
 @interface SPExporter : NSOperation
@@ -66,6 +68,8 @@
 	BOOL exportProcessIsRunning;
 	BOOL exportUsingLowMemoryBlockingStreaming;
 	BOOL exportOutputCompressFile;
+
+	NSUInteger exportParallelConnections;
 	
 	SPFileCompressionFormat exportOutputCompressionFormat;
 	
@@ -73,7 +77,14 @@
 	
 	SPExportFile *exportOutputFile;
 
+	id <SPExportRowSource> exportRowSource;
+
 	NSStringEncoding exportOutputEncoding;
+
+	NSMutableArray *exportTableStatistics;
+	NSMutableDictionary *exportActiveTables;
+	unsigned long long exportCompletedRowCount;
+	double exportCompletedServerWaitTime;
 }
 
 /**
@@ -126,10 +137,41 @@
  */
 @property(readwrite, assign) NSStringEncoding exportOutputEncoding;
 
+/**
+ * @property exportParallelConnections The number of connections used to read data concurrently from a
+ *                                     shared snapshot, if supported by the exporter; below 2 data is read
+ *                                     on the exporter's connection only
+ */
+@property(readwrite, assign) NSUInteger exportParallelConnections;
+
+/**
+ * @property exportRowSource The source of already loaded rows to export, such as a custom query
+ *                           result, used instead of reading a table from the server
+ */
+@property(readwrite, retain) id <SPExportRowSource> exportRowSource;
+
 - (BOOL)exportOutputCompressFile;
 
 - (void)setExportOutputCompressFile:(BOOL)compress;
 
+#pragma mark Instrumentation
+
+/**
+ * Returns the number of table rows read by the exporter so far.
+ */
+- (unsigned long long)exportRowCount;
+
+/**
+ * Returns the time, in seconds, the exporter has spent waiting for table rows to be received from the server.
+ */
+- (double)exportServerWaitTime;
+
+/**
+ * Returns a dictionary of statistics for each table the exporter has read or is reading, using the
+ * keys defined in SPExportStatistics.h.
+ */
+- (NSArray *)exportTableStatistics;
+
 #pragma mark Shared Private
 
 /**
@@ -152,4 +194,37 @@
          Someone needs to check if that was an oversight or intentional.
 - (void)writeUTF8String:(NSString *)input;
 
+/**
+ * Record that the rows of a table are being read from a streaming result or chunked table reader,
+ * so the rows read and the time spent waiting for them are included in the export's statistics
+ * @param tableName The name of the table
+ * @param result    The result the rows are read from
+ */
+- (void)beginRecordingTable:(NSString *)tableName readingResult:(id)result;
+
+/**
+ * Record that all the rows of a table have been read, before its result is released
+ * @param tableName The name of the table
+ */
+- (void)endRecordingTable:(NSString *)tableName;
+
+/**
+ * Write all the rows of the export's row source to the output file, serializing chunks of rows
+ * concurrently and writing them in order
+ * @param rowSource       The source of the rows
+ * @param serializeChunk  Called concurrently with each range of rows, returning an object which
+ *                        responds to -writeToOutput: holding the serialized rows
+ * @param progressHandler Called on the calling thread after each chunk is written, with the total
+ *                        number of rows written so far
+ * @return NO if the export was cancelled
+ */
+- (BOOL)writeRowsFromSource:(id <SPExportRowSource>)rowSource serializingChunksUsingBlock:(id (^)(NSRange rowRange))serializeChunk progressHandler:(void (^)(NSUInteger rowsWritten))progressHandler;
+
+/**
+ * Record that rows have been written from the export's row source, so they are included in the
+ * export's statistics
+ * @param rowCount The number of rows
+ */
+- (void)recordRowsWrittenFromSource:(NSUInteger)rowCount;
+
 @end
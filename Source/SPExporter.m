@@ -31,6 +31,19 @@
 #import "SPExporter.h"
 #import "SPExportFile.h"
 #import "SPFileHandle.h"
+#import "SPExportStatistics.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// Keys of the records of tables being read
+static NSString *SPExporterTableResultKey    = @"Result";
+static NSString *SPExporterTableStartTimeKey = @"StartTime";
+
+// The number of rows from a row source serialized as a single chunk
+static const NSUInteger SPExporterRowSourceChunkRowCount = 1000;
+
+// The number of chunks serialized concurrently per processor before they are written out
+static const NSUInteger SPExporterRowSourceChunksPerProcessor = 2;
 
 @implementation SPExporter
 
@@ -42,8 +55,10 @@
 @synthesize exportOutputCompressionFormat;
 @synthesize exportData;
 @synthesize exportOutputFile;
+@synthesize exportRowSource;
 @synthesize exportOutputEncoding;
 @synthesize exportMaxProgress;
+@synthesize exportParallelConnections;
 
 /**
  * Initialise an instance of SPExporter, while setting some default values.
@@ -61,6 +76,9 @@
 		
 		// Default the output encoding to UTF-8
 		[self setExportOutputEncoding:NSUTF8StringEncoding];
+
+		exportTableStatistics = [[NSMutableArray alloc] init];
+		exportActiveTables = [[NSMutableDictionary alloc] init];
 	}
 	
 	return self;
@@ -115,6 +133,187 @@
 	[[[self exportOutputFile] exportFileHandle] setCompressionFormat:(compress) ? [self exportOutputCompressionFormat] : SPNoCompression];
 }
 
+#pragma mark -
+#pragma mark Instrumentation
+
+- (unsigned long long)exportRowCount
+{
+	unsigned long long rowCount;
+	NSArray *activeResults;
+
+	@synchronized(exportTableStatistics) {
+		rowCount = exportCompletedRowCount;
+		activeResults = [[exportActiveTables allValues] valueForKey:SPExporterTableResultKey];
+	}
+
+	for (id result in activeResults)
+	{
+		rowCount += [result processedRowCount];
+	}
+
+	return rowCount;
+}
+
+- (double)exportServerWaitTime
+{
+	double waitTime;
+	NSArray *activeResults;
+
+	@synchronized(exportTableStatistics) {
+		waitTime = exportCompletedServerWaitTime;
+		activeResults = [[exportActiveTables allValues] valueForKey:SPExporterTableResultKey];
+	}
+
+	for (id result in activeResults)
+	{
+		waitTime += [result dataWaitTime];
+	}
+
+	return waitTime;
+}
+
+/**
+ * Returns the statistics of the tables which have been read, in the order they completed, followed by
+ * those of the tables still being read.
+ */
+- (NSArray *)exportTableStatistics
+{
+	NSMutableArray *tableStatistics;
+	NSDictionary *activeTables;
+
+	@synchronized(exportTableStatistics) {
+		tableStatistics = [NSMutableArray arrayWithArray:exportTableStatistics];
+		activeTables = [NSDictionary dictionaryWithDictionary:exportActiveTables];
+	}
+
+	NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+
+	for (NSString *tableName in activeTables)
+	{
+		NSDictionary *activeTable = [activeTables objectForKey:tableName];
+		id result = [activeTable objectForKey:SPExporterTableResultKey];
+
+		[tableStatistics addObject:@{
+			SPExportStatisticsTableNameKey      : tableName,
+			SPExportStatisticsRowCountKey       : @([result processedRowCount]),
+			SPExportStatisticsElapsedTimeKey    : @(now - [[activeTable objectForKey:SPExporterTableStartTimeKey] doubleValue]),
+			SPExportStatisticsServerWaitTimeKey : @([result dataWaitTime]),
+			SPExportStatisticsCompleteKey       : @NO
+		}];
+	}
+
+	return tableStatistics;
+}
+
+- (void)beginRecordingTable:(NSString *)tableName readingResult:(id)result
+{
+	if (!tableName || !result) return;
+
+	@synchronized(exportTableStatistics) {
+		[exportActiveTables setObject:@{
+			SPExporterTableResultKey    : result,
+			SPExporterTableStartTimeKey : @([NSDate timeIntervalSinceReferenceDate])
+		} forKey:tableName];
+	}
+}
+
+- (void)endRecordingTable:(NSString *)tableName
+{
+	if (!tableName) return;
+
+	@synchronized(exportTableStatistics) {
+		NSDictionary *activeTable = [exportActiveTables objectForKey:tableName];
+
+		if (!activeTable) return;
+
+		id result = [activeTable objectForKey:SPExporterTableResultKey];
+
+		NSUInteger rowCount = [result processedRowCount];
+		double waitTime = [result dataWaitTime];
+
+		[exportTableStatistics addObject:@{
+			SPExportStatisticsTableNameKey      : tableName,
+			SPExportStatisticsRowCountKey       : @(rowCount),
+			SPExportStatisticsElapsedTimeKey    : @([NSDate timeIntervalSinceReferenceDate] - [[activeTable objectForKey:SPExporterTableStartTimeKey] doubleValue]),
+			SPExportStatisticsServerWaitTimeKey : @(waitTime),
+			SPExportStatisticsCompleteKey       : @YES
+		}];
+
+		exportCompletedRowCount += rowCount;
+		exportCompletedServerWaitTime += waitTime;
+
+		[exportActiveTables removeObjectForKey:tableName];
+	}
+}
+
+/**
+ * Rows are serialized in windows of a few chunks per processor, so that only a limited amount of
+ * serialized output is held in memory before it's written.
+ */
+- (BOOL)writeRowsFromSource:(id <SPExportRowSource>)rowSource serializingChunksUsingBlock:(id (^)(NSRange rowRange))serializeChunk progressHandler:(void (^)(NSUInteger rowsWritten))progressHandler
+{
+	NSUInteger rowCount = [rowSource numberOfExportRows];
+	NSUInteger chunkCount = (rowCount + SPExporterRowSourceChunkRowCount - 1) / SPExporterRowSourceChunkRowCount;
+	NSUInteger windowLength = MAX([[NSProcessInfo processInfo] activeProcessorCount], 1) * SPExporterRowSourceChunksPerProcessor;
+	NSUInteger rowsWritten = 0;
+
+	id *chunks = calloc(windowLength, sizeof(id));
+
+	for (NSUInteger windowStart = 0; windowStart < chunkCount; windowStart += windowLength)
+	{
+		NSUInteger windowChunkCount = MIN(windowLength, chunkCount - windowStart);
+
+		dispatch_apply(windowChunkCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+			if ([self isCancelled]) return;
+
+			@autoreleasepool {
+				NSUInteger firstRow = (windowStart + i) * SPExporterRowSourceChunkRowCount;
+
+				chunks[i] = [serializeChunk(NSMakeRange(firstRow, MIN(SPExporterRowSourceChunkRowCount, rowCount - firstRow))) retain];
+			}
+		});
+
+		BOOL cancelled = [self isCancelled];
+
+		for (NSUInteger i = 0; i < windowChunkCount; i++)
+		{
+			if (!cancelled) {
+				[chunks[i] writeToOutput:[self exportOutputFile]];
+
+				NSUInteger chunkRowCount = MIN(SPExporterRowSourceChunkRowCount, rowCount - rowsWritten);
+
+				rowsWritten += chunkRowCount;
+
+				[self recordRowsWrittenFromSource:chunkRowCount];
+
+				if (progressHandler) progressHandler(rowsWritten);
+			}
+
+			[chunks[i] release];
+			chunks[i] = nil;
+		}
+
+		if (cancelled) {
+			free(chunks);
+
+			return NO;
+		}
+	}
+
+	free(chunks);
+
+	return YES;
+}
+
+- (void)recordRowsWrittenFromSource:(NSUInteger)rowCount
+{
+	@synchronized(exportTableStatistics) {
+		exportCompletedRowCount += rowCount;
+	}
+}
+
+#pragma mark -
+
 - (void)writeString:(NSString *)input
 {
 	[[self exportOutputFile] writeData:[input dataUsingEncoding:[self exportOutputEncoding]]];
@@ -134,6 +333,9 @@
 	if (connection) SPClear(connection);
 	[self setServerSupport:nil];
 	if (exportOutputFile) SPClear(exportOutputFile);
+	if (exportRowSource) SPClear(exportRowSource);
+	SPClear(exportTableStatistics);
+	SPClear(exportActiveTables);
 	
 	[super dealloc];
 }
@@ -28,6 +28,10 @@
 //
 //  More info at <https://github.com/sequelpro/sequelpro>
 
+@class SPParallelGzipCompressor;
+@class SPParallelBzip2Compressor;
+@class SPParallelBzip2Decompressor;
+
 struct SPRawFileHandles;
 /**
  * @class SPFileHandle SPFileHandle.h
@@ -44,18 +48,36 @@ struct SPRawFileHandles;
 	char *wrappedFilePath;
 
 	NSMutableData *buffer;
+	NSMutableData *writeBuffer;
 	NSUInteger bufferDataLength;
 	NSUInteger bufferPosition;
 	BOOL endOfFile;
 	pthread_mutex_t bufferLock;
+	pthread_cond_t bufferCondition;
 	NSThread *processingThread;
+	BOOL processingThreadShouldExit;
+	BOOL processingThreadFinished;
+
+	double writeBlockedTime;
+	double writerIdleTime;
+	double writerActiveTime;
 
 	int fileMode;
+	BOOL appendsToFile;
 	BOOL dataWritten;
 	BOOL allDataWritten;
 	BOOL fileIsClosed;
+	int writeError;
 	
 	SPFileCompressionFormat compressionFormat;
+	NSInteger compressionLevel;
+	SPParallelGzipCompressor *gzipCompressor;
+	SPParallelBzip2Compressor *bzip2Compressor;
+	SPParallelBzip2Decompressor *bzip2Decompressor;
+
+	unsigned long long dataWrittenLength;
+	unsigned long long dataSuppliedLength;
+	unsigned long long checkpointDataLength;
 }
 
 #pragma mark -
@@ -64,6 +86,7 @@ struct SPRawFileHandles;
 + (id)fileHandleForReadingAtPath:(NSString *)path;
 + (id)fileHandleForWritingAtPath:(NSString *)path;
 + (id)fileHandleForPath:(NSString *)path mode:(int)mode;
++ (id)fileHandleForAppendingAtPath:(NSString *)path truncatingToLength:(unsigned long long)length;
 
 #pragma mark -
 #pragma mark Initialisation
@@ -93,13 +116,43 @@ struct SPRawFileHandles;
 // Returns the compression format being used. Currently gzip or bzip2 only.
 - (SPFileCompressionFormat)compressionFormat;
 
-// Write the provided data to the file
+// Set the gzip compression level used when writing, from 1 to 9; takes effect when the compression format is next set
+- (void)setCompressionLevel:(NSInteger)level;
+
+// Write the provided data to the file; once a write has failed, further data is discarded
 - (void)writeData:(NSData *)data;
 
-// Ensures any buffers are written to disk
-- (void)synchronizeFile;
+// Ensures any buffers are written to disk; returns NO if any data could not be written
+- (BOOL)synchronizeFile;
+
+// Writes all data durably to disk, ending any compression stream so the file can be resumed at the returned length
+- (unsigned long long)checkpoint;
+
+// Prevents further access to the file; returns NO if any data could not be written
+- (BOOL)closeFile;
+
+// The error number of the first failed write, or 0 if all data has been written successfully
+- (int)writeError;
+
+#pragma mark -
+#pragma mark Write statistics
+
+// Time spent in writeData: waiting for the background writer to free buffer space
+- (double)writeBlockedTime;
+
+// Time the background writer spent waiting for data to be supplied
+- (double)writerIdleTime;
+
+// Time the background writer spent compressing and writing data to disk
+- (double)writerActiveTime;
+
+// Uncompressed bytes per second written by the background writer while active
+- (double)writeThroughput;
+
+// Uncompressed bytes supplied to writeData:
+- (unsigned long long)suppliedDataLength;
 
-// Prevents further access to the file
-- (void)closeFile;
+// Length of the file on disk, including data written out by compressors
+- (unsigned long long)fileLength;
 
 @end
@@ -29,40 +29,61 @@
 //  More info at <https://github.com/sequelpro/sequelpro>
 
 #import "SPFileHandle.h"
-#import "bzlib.h"
+#import "SPParallelGzipCompressor.h"
+#import "SPParallelBzip2Compressor.h"
+#import "SPParallelBzip2Decompressor.h"
 #import "zlib.1.2.4.h"
 #import "pthread.h"
 
+#include <errno.h>
+#include <mach/mach_time.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 // Define the maximum size of the background write buffer before the writing thread
 // waits until some has been written out.  This can affect speed and memory usage.
 #define SPFH_MAX_WRITE_BUFFER_SIZE 1048576
 
 struct SPRawFileHandles {
 	FILE *file;
-	BZFILE *bzfile;
 	gzFile *gzfile;
 };
 
 @interface SPFileHandle ()
 
 - (void)_writeBufferToData;
+- (void)_setWriteError:(int)errorNumber;
+- (void)_startCompressionStream;
 - (void)_closeFileHandles;
 
 @end
 
+/**
+ * Returns the number of seconds elapsed since the supplied mach_absolute_time().
+ */
+static double _SPFileHandleElapsedSeconds(uint64_t startTime)
+{
+	static mach_timebase_info_data_t timebaseInfo;
+
+	if (!timebaseInfo.denom) mach_timebase_info(&timebaseInfo);
+
+	return (double)((mach_absolute_time() - startTime) * timebaseInfo.numer / timebaseInfo.denom) * 1e-9;
+}
+
 @implementation SPFileHandle
 
 #pragma mark -
 
 /**
- * Initialises and returns a SPFileHandle with a specified file (FILE, gzFile or BZFILE).
+ * Initialises and returns a SPFileHandle with a specified file.
  * "mode" indicates the file interaction mode - currently only read-only
  * or write-only are supported.
  *
- * On reading, theFile can either be one of FILE, gzFile or BZFILE depending on the attempt to
- * determine whether or not the file is in a compressed format (gzip or bzip2). On writing, 
- * theFile is a FILE when compression is disabled, a gzFile when gzip compression is enabled
- * or a BZFILE when bzip2 compression is enabled.
+ * On reading, the file is wrapped in a gzFile if it is gzip compressed, and bzip2 files are
+ * decompressed from the FILE by a SPParallelBzip2Decompressor, depending on the attempt to
+ * determine whether or not the file is in a compressed format.
+ * On writing, compressed data is written to a FILE by the compressor for the format set with
+ * setCompressionFormat:.
  */
 - (id)initWithFile:(FILE *)theFile fromPath:(const char *)path mode:(int)mode
 {
@@ -70,6 +91,7 @@ struct SPRawFileHandles {
 		dataWritten = NO;
 		allDataWritten = YES;
 		fileIsClosed = NO;
+		writeError = 0;
 
 		wrappedFile = malloc(sizeof(*wrappedFile)); //FIXME ivar can be moved to .m file with "modern objc", replacing the opaque struct pointer
 		wrappedFilePath = malloc(strlen(path) + 1);
@@ -82,16 +104,32 @@ struct SPRawFileHandles {
 			[NSException raise:NSInvalidArgumentException format:@"SPFileHandle only supports read-only and write-only file modes"];
 		}
 
-		// Instantiate the buffer
+		// Instantiate the buffers
 		pthread_mutex_init(&bufferLock, NULL);
+		pthread_cond_init(&bufferCondition, NULL);
 		
 		buffer = [[NSMutableData alloc] init];
+		writeBuffer = [[NSMutableData alloc] init];
 		bufferDataLength = 0;
 		bufferPosition = 0;
 		endOfFile = NO;
 		
 		compressionFormat = SPNoCompression;
+		compressionLevel = Z_DEFAULT_COMPRESSION;
+		gzipCompressor = nil;
+		bzip2Compressor = nil;
+		bzip2Decompressor = nil;
+		dataWrittenLength = 0;
+		dataSuppliedLength = 0;
+		checkpointDataLength = 0;
+		appendsToFile = NO;
 		processingThread = nil;
+		processingThreadShouldExit = NO;
+		processingThreadFinished = YES;
+
+		writeBlockedTime = 0;
+		writerIdleTime = 0;
+		writerActiveTime = 0;
 
 		// If in read mode, set up the buffer
 		if (fileMode == O_RDONLY) {
@@ -114,11 +152,10 @@ struct SPRawFileHandles {
 			}
 			// Test for BZ (by checking the file header)
 			if(compressionFormat == SPNoCompression) {
-				char bzbuf[4];
-				int i, c;
+				unsigned char bzbuf[4] = { 0, 0, 0, 0 };
 				
 				// Get the first 4 bytes from the file
-				for (i = 0; (c = getc(theFile)) != EOF && i < 4; bzbuf[i++] = c);
+				fread(bzbuf, 1, 4, theFile);
 				
 				rewind(theFile);
 				
@@ -133,11 +170,11 @@ struct SPRawFileHandles {
 				
 				if (isBzip2) {
 					compressionFormat = SPBzip2Compression;
-					wrappedFile->bzfile = BZ2_bzReadOpen(NULL, theFile, 0, 0, NULL, 0);
+					bzip2Decompressor = [[SPParallelBzip2Decompressor alloc] initWithFile:theFile];
 				}
 			}
-			// We need to save the file handle both in plain and BZ2 format
-			if(compressionFormat == SPNoCompression || compressionFormat == SPBzip2Compression) {
+			// We need to save the file handle in plain and BZ2 format
+			if(compressionFormat != SPGzipCompression) {
 				wrappedFile->file = theFile;
 			}
 			else {
@@ -147,6 +184,7 @@ struct SPRawFileHandles {
 		// In write mode, set up a thread to handle writing in the background
 		else if (fileMode == O_WRONLY) {
 			wrappedFile->file = theFile; // can be changed later via setCompressionFormat:
+			processingThreadFinished = NO;
 			processingThread = [[NSThread alloc] initWithTarget:self selector:@selector(_writeBufferToData) object:nil];
 			[processingThread setName:@"SPFileHandle data writing thread"];
 			[processingThread start];
@@ -199,26 +237,70 @@ struct SPRawFileHandles {
 	return [[[self alloc] initWithFile:file fromPath:pathRepresentation mode:mode] autorelease];
 }
 
+/**
+ * Retrieve and return a SPFileHandle for writing to the end of an existing file, which
+ * is first truncated to the supplied length - as returned by -checkpoint when the file
+ * was previously written.  Returns nil if the file could not be truncated or opened.
+ */
++ (id)fileHandleForAppendingAtPath:(NSString *)path truncatingToLength:(unsigned long long)length
+{
+	const char *pathRepresentation = [path fileSystemRepresentation];
+	if (!pathRepresentation) return nil;
+
+	if (truncate(pathRepresentation, (off_t)length) != 0) return nil;
+
+	FILE *file = fopen(pathRepresentation, "ab");
+
+	if (file == NULL) return nil;
+
+	SPFileHandle *fileHandle = [[[self alloc] initWithFile:file fromPath:pathRepresentation mode:O_WRONLY] autorelease];
+
+	fileHandle->appendsToFile = YES;
+
+	return fileHandle;
+}
+
 #pragma mark -
 #pragma mark Data reading
 
 /**
  * Reads data up to a specified number of uncompressed bytes from the file.
+ *
+ * Compressed data which is corrupt or truncated raises an exception once all the data
+ * decompressed before the problem has been returned, rather than appearing to end early.
  */
 - (NSMutableData *)readDataOfLength:(NSUInteger)length
 {	
 	long dataLength = 0;
 	void *data = malloc(length);
+	NSString *readErrorReason = nil;
 	
 	if (compressionFormat == SPGzipCompression) {
 		dataLength = gzread(wrappedFile->gzfile, data, (unsigned)length);
+
+		if (dataLength < 0) {
+			int gzipError;
+
+			readErrorReason = [NSString stringWithFormat:NSLocalizedString(@"The gzip data could not be decompressed: %s", @"file read : gzip decompression failed"), gzerror(wrappedFile->gzfile, &gzipError)];
+			dataLength = 0;
+		}
 	}
 	else if (compressionFormat == SPBzip2Compression) {
-		dataLength = BZ2_bzread(wrappedFile->bzfile, data, (int)length);
+		dataLength = [bzip2Decompressor readBytes:data length:length];
+
+		if (!dataLength && [bzip2Decompressor decompressionFailed]) {
+			readErrorReason = NSLocalizedString(@"The bzip2 data is corrupt or truncated and could not be decompressed.", @"file read : bzip2 decompression failed");
+		}
 	}
 	else {
 		dataLength = fread(data, 1, length, wrappedFile->file);
 	}
+
+	if (readErrorReason) {
+		free(data);
+
+		[NSException raise:NSInternalInconsistencyException format:@"%@", readErrorReason];
+	}
 		
 	return [NSMutableData dataWithBytesNoCopy:data length:dataLength freeWhenDone:YES];
 }
@@ -243,9 +325,6 @@ struct SPRawFileHandles {
 	if (compressionFormat == SPGzipCompression) {
 		return gzoffset(wrappedFile->gzfile);
 	}
-	else if(compressionFormat == SPBzip2Compression) {
-		return ftell(wrappedFile->file);
-	}
 	else {
 		return ftell(wrappedFile->file);
 	}
@@ -269,92 +348,268 @@ struct SPRawFileHandles {
 	if (dataWritten) [NSException raise:NSInternalInconsistencyException format:@"Cannot change compression settings when data has already been written."];
 
 	compressionFormat = useCompressionFormat;
-	
-	if (compressionFormat == SPGzipCompression) {
-		wrappedFile->gzfile = gzopen(wrappedFilePath, "wb");
-		gzbuffer(wrappedFile->gzfile, 131072);
-	}
-	else if (compressionFormat == SPBzip2Compression) {
-		wrappedFile->file = fopen(wrappedFilePath, "wb");
-		wrappedFile->bzfile = BZ2_bzWriteOpen(NULL, wrappedFile->file, 9, 0, 0);
-	}
-	else {
-		wrappedFile->file = fopen(wrappedFilePath, "wb");
-	}
+
+	// A file being resumed is appended to, so the data up to its last checkpoint is kept.  The
+	// compressor is only started when data is written - see _startCompressionStream.
+	wrappedFile->file = fopen(wrappedFilePath, (appendsToFile) ? "ab" : "wb");
+}
+
+/**
+ * Set the compression level used when writing gzip data, from 1 (fastest) to 9 (best).
+ * Takes effect when the compression format is next set.
+ */
+- (void)setCompressionLevel:(NSInteger)level
+{
+	compressionLevel = level;
 }
 
 /**
  * Write the supplied data to the file.  The data may not be written to the
- * disk at once (see synchronizeFile).
+ * disk at once (see synchronizeFile).  If the background writer has fallen
+ * behind and the buffer is full, blocks until it has taken the buffered data.
+ *
+ * Once the background writer has failed to write data, the file is incomplete,
+ * so any further data is discarded; see writeError.
  */
 - (void)writeData:(NSData *)data
 {
 	// Throw an exception if the file is closed
 	if (fileIsClosed) [NSException raise:NSInternalInconsistencyException format:@"Cannot write to a file handle after it has been closed"];
 
+	if (![data length]) return;
+
 	pthread_mutex_lock(&bufferLock);
-	
-	// Add the data to the buffer
-	if ([data length]) {
-		[buffer appendData:data];
-		allDataWritten = NO;
-		bufferDataLength += [data length];
-	}
 
-	// If the buffer is large, wait for some to be written out
-	while (bufferDataLength > SPFH_MAX_WRITE_BUFFER_SIZE) 
-	{
+	if (writeError) {
 		pthread_mutex_unlock(&bufferLock);
-		usleep(100);
-		pthread_mutex_lock(&bufferLock);
+		return;
 	}
-	
+
+	// If the buffer is full, wait for the writer to swap it out
+	if (bufferDataLength > SPFH_MAX_WRITE_BUFFER_SIZE) {
+		uint64_t waitStartTime = mach_absolute_time();
+
+		while (bufferDataLength > SPFH_MAX_WRITE_BUFFER_SIZE && !processingThreadFinished)
+		{
+			pthread_cond_wait(&bufferCondition, &bufferLock);
+		}
+
+		writeBlockedTime += _SPFileHandleElapsedSeconds(waitStartTime);
+	}
+
+	// Add the data to the buffer, and wake the writer
+	[buffer appendData:data];
+	allDataWritten = NO;
+	bufferDataLength += [data length];
+	dataSuppliedLength += [data length];
+
+	pthread_cond_broadcast(&bufferCondition);
 	pthread_mutex_unlock(&bufferLock);
 }
 
 /**
  * Blocks until all data has been written to disk.
+ *
+ * @return NO if any data written so far could not be written out
  */
-- (void)synchronizeFile
+- (BOOL)synchronizeFile
 {
 	pthread_mutex_lock(&bufferLock);
 	
-	while (!allDataWritten) 
+	while (!allDataWritten && !processingThreadFinished)
 	{
-		pthread_mutex_unlock(&bufferLock);
-		usleep(100);
-		pthread_mutex_lock(&bufferLock);
+		pthread_cond_wait(&bufferCondition, &bufferLock);
 	}
+
+	BOOL writeSucceeded = !writeError;
 	
 	pthread_mutex_unlock(&bufferLock);
+
+	return writeSucceeded;
+}
+
+/**
+ * Blocks until all data has been written, then ends the current compression stream - gzip
+ * members and bzip2 streams may be concatenated - and flushes the file to
+ * disk.  The returned length of the file can be passed to fileHandleForAppendingAtPath:truncatingToLength:
+ * to resume writing after the data written so far, even if more data is written in the meantime.
+ *
+ * @return The length of the file, or 0 if it could not be written out
+ */
+- (unsigned long long)checkpoint
+{
+	if (fileIsClosed || fileMode != O_WRONLY) return 0;
+
+	[self synchronizeFile];
+
+	// Holding the lock while the buffer is empty keeps the background writer waiting
+	pthread_mutex_lock(&bufferLock);
+
+	BOOL streamEnded = YES;
+
+	// The next stream is only started once more data is written, so its header isn't part of the
+	// checkpointed file and isn't written again when the file is resumed
+	if (dataWrittenLength != checkpointDataLength) {
+		if (gzipCompressor) {
+			streamEnded = [gzipCompressor finish];
+			SPClear(gzipCompressor);
+		}
+		else if (bzip2Compressor) {
+			streamEnded = [bzip2Compressor finish];
+			SPClear(bzip2Compressor);
+		}
+
+		checkpointDataLength = dataWrittenLength;
+
+		// The ended stream's data may be incomplete, so the file can't be resumed from here
+		if (!streamEnded && !writeError) writeError = EIO;
+	}
+
+	off_t fileLength = -1;
+
+	if (streamEnded && fflush(wrappedFile->file) == 0 && fsync(fileno(wrappedFile->file)) == 0 && fseeko(wrappedFile->file, 0, SEEK_END) == 0) {
+		fileLength = ftello(wrappedFile->file);
+	}
+
+	pthread_mutex_unlock(&bufferLock);
+
+	if (fileLength < 0 || [self writeError]) {
+		NSLog(@"SPFileHandle failed to checkpoint %s", wrappedFilePath);
+		return 0;
+	}
+
+	return (unsigned long long)fileLength;
 }
 
 /**
  * Ensure all data is written out, close any file handles, and prevent any
  * more data from being written to the file.
+ *
+ * @return NO if any data written to the file could not be written out
  */
-- (void)closeFile
+- (BOOL)closeFile
 {
 	if (!fileIsClosed) {
 		[self synchronizeFile];
+
+		// Stop the background writer, waiting for it to finish before the file handles are closed
+		pthread_mutex_lock(&bufferLock);
+
+		processingThreadShouldExit = YES;
+		pthread_cond_broadcast(&bufferCondition);
+
+		while (!processingThreadFinished) pthread_cond_wait(&bufferCondition, &bufferLock);
+
+		pthread_mutex_unlock(&bufferLock);
+
 		[self _closeFileHandles];
 		
-		if (processingThread) {
-			if ([processingThread isExecuting]) {
-				[processingThread cancel];
-				while ([processingThread isExecuting]) usleep(100);
-			}
-		}
-		
 		fileIsClosed = YES;
 	}
+
+	return ![self writeError];
+}
+
+/**
+ * Returns the error number - as errno - of the first write to the file which failed, or
+ * 0 if all data has been written out so far.  Failures compressing data are reported as EIO.
+ */
+- (int)writeError
+{
+	pthread_mutex_lock(&bufferLock);
+	int errorNumber = writeError;
+	pthread_mutex_unlock(&bufferLock);
+
+	return errorNumber;
+}
+
+#pragma mark -
+#pragma mark Write statistics
+
+/**
+ * Returns the total time, in seconds, writeData: calls spent blocked waiting for buffer
+ * space - a high value indicates writing is limited by compression or disk speed.
+ */
+- (double)writeBlockedTime
+{
+	pthread_mutex_lock(&bufferLock);
+	double blockedTime = writeBlockedTime;
+	pthread_mutex_unlock(&bufferLock);
+
+	return blockedTime;
+}
+
+/**
+ * Returns the total time, in seconds, the background writer spent waiting for data -
+ * a high value indicates writing is limited by the speed data is supplied.
+ */
+- (double)writerIdleTime
+{
+	pthread_mutex_lock(&bufferLock);
+	double idleTime = writerIdleTime;
+	pthread_mutex_unlock(&bufferLock);
+
+	return idleTime;
+}
+
+/**
+ * Returns the total time, in seconds, the background writer spent compressing and
+ * writing data to disk.
+ */
+- (double)writerActiveTime
+{
+	pthread_mutex_lock(&bufferLock);
+	double activeTime = writerActiveTime;
+	pthread_mutex_unlock(&bufferLock);
+
+	return activeTime;
+}
+
+/**
+ * Returns the rate, in uncompressed bytes per second, at which the background writer
+ * compressed and wrote data while it was active.
+ */
+- (double)writeThroughput
+{
+	pthread_mutex_lock(&bufferLock);
+	double throughput = (writerActiveTime > 0) ? (dataWrittenLength / writerActiveTime) : 0;
+	pthread_mutex_unlock(&bufferLock);
+
+	return throughput;
+}
+
+/**
+ * Returns the total length, in bytes, of the uncompressed data supplied to writeData:,
+ * including any data not yet written out by the background writer.
+ */
+- (unsigned long long)suppliedDataLength
+{
+	pthread_mutex_lock(&bufferLock);
+	unsigned long long suppliedLength = dataSuppliedLength;
+	pthread_mutex_unlock(&bufferLock);
+
+	return suppliedLength;
+}
+
+/**
+ * Returns the current length, in bytes, of the file on disk - for a compressed file, the
+ * length of the compressed data written out so far.  This remains available once the file
+ * has been closed.
+ */
+- (unsigned long long)fileLength
+{
+	struct stat fileStatus;
+
+	if (stat(wrappedFilePath, &fileStatus) != 0) return 0;
+
+	return (unsigned long long)fileStatus.st_size;
 }
 
 #pragma mark -
 #pragma mark File information
 
 /**
- * Returns the compression format being used. Currently gzip or bzip2 only.
+ * Returns the compression format being used.
  */
 - (SPFileCompressionFormat)compressionFormat
 {
@@ -365,91 +620,169 @@ struct SPRawFileHandles {
  * A method to be called on a background thread, allowing write data to build
  * up in a buffer and write to disk in chunks as the buffer fills.  This allows
  * background compression of the data when using Gzip compression.
+ *
+ * The buffers are double-buffered: the writer swaps the filled buffer for its
+ * emptied one under the lock, so writeData: can carry on appending while the
+ * previous data is compressed and written without being copied.
  */
 - (void)_writeBufferToData
 {
 	@autoreleasepool {
-		// Process the buffer in a loop into the file, until cancelled
-		while (!fileIsClosed && ![processingThread isCancelled]) {
+		pthread_mutex_lock(&bufferLock);
 
-			// Check whether any data in the buffer needs to be written out - using thread locks for safety
-			pthread_mutex_lock(&bufferLock);
+		while (1) {
 
-			if (!bufferDataLength) {
-				pthread_mutex_unlock(&bufferLock);
-				usleep(1000);
-				continue;
+			// Wait for data to be supplied, or for the file to be closed
+			if (!bufferDataLength && !processingThreadShouldExit) {
+				uint64_t waitStartTime = mach_absolute_time();
+
+				while (!bufferDataLength && !processingThreadShouldExit) pthread_cond_wait(&bufferCondition, &bufferLock);
+
+				writerIdleTime += _SPFileHandleElapsedSeconds(waitStartTime);
 			}
 
-			// Copy the data into a local buffer
-			NSData *dataToBeWritten = [buffer copy];
+			if (!bufferDataLength) break;
+
+			// Swap the filled buffer for the empty write buffer, freeing space for writeData:
+			NSMutableData *dataToBeWritten = buffer;
 
-			[buffer setLength:0];
+			buffer = writeBuffer;
+			writeBuffer = dataToBeWritten;
 			bufferDataLength = 0;
 
+			// After a failed write the file is incomplete, so any remaining data is discarded
+			BOOL skipWrite = (writeError != 0);
+
+			pthread_cond_broadcast(&bufferCondition);
 			pthread_mutex_unlock(&bufferLock);
 
 			// Write out the data
-			long bufferLengthWrittenOut = 0;
-
-			switch (compressionFormat) {
-				case SPGzipCompression:
-					bufferLengthWrittenOut = gzwrite(wrappedFile->gzfile, [dataToBeWritten bytes], (unsigned)[dataToBeWritten length]);
-					break;
-				case SPBzip2Compression:
-					bufferLengthWrittenOut = BZ2_bzwrite(wrappedFile->bzfile, (void *)[dataToBeWritten bytes], (int)[dataToBeWritten length]);
-					break;
-				default:
-					bufferLengthWrittenOut = fwrite([dataToBeWritten bytes], 1, [dataToBeWritten length], wrappedFile->file);
+			uint64_t writeStartTime = mach_absolute_time();
+			BOOL dataWrittenOut = YES;
+			int writeErrorNumber = EIO;
+
+			if (!skipWrite) {
+				[self _startCompressionStream];
+
+				switch (compressionFormat) {
+					case SPGzipCompression:
+						[gzipCompressor compressBytes:[dataToBeWritten bytes] length:[dataToBeWritten length]];
+						dataWrittenOut = ![gzipCompressor writeFailed];
+						break;
+					case SPBzip2Compression:
+						[bzip2Compressor compressBytes:[dataToBeWritten bytes] length:[dataToBeWritten length]];
+						dataWrittenOut = ![bzip2Compressor writeFailed];
+						break;
+					default:
+						errno = 0;
+						dataWrittenOut = (fwrite([dataToBeWritten bytes], 1, [dataToBeWritten length], wrappedFile->file) == [dataToBeWritten length]);
+						if (!dataWrittenOut && errno) writeErrorNumber = errno;
+				}
 			}
 
-			// Restore data to the buffer if it wasn't written out
-			pthread_mutex_lock(&bufferLock);
+			double writeDuration = _SPFileHandleElapsedSeconds(writeStartTime);
 
-			if (bufferLengthWrittenOut < (NSInteger)[dataToBeWritten length]) {
-				if ([buffer length]) {
-					long dataLengthToRestore = [dataToBeWritten length] - bufferLengthWrittenOut;
-					[buffer replaceBytesInRange:NSMakeRange(0, 0) withBytes:[[dataToBeWritten subdataWithRange:NSMakeRange(bufferLengthWrittenOut, dataLengthToRestore)] bytes] length:dataLengthToRestore];
-					bufferDataLength += dataLengthToRestore;
-				}
+			if (!dataWrittenOut) {
+				NSLog(@"SPFileHandle failed to write %lu bytes to %s: %s", (unsigned long)[dataToBeWritten length], wrappedFilePath, strerror(writeErrorNumber));
+
+				[self _setWriteError:writeErrorNumber];
 			}
-			// Otherwise, mark all data as written if it has been - allows synching to hard disk.
-			else if (![buffer length]) {
+
+			// Empty the write buffer for reuse, keeping its allocation, and mark all data as written
+			// if no more has been supplied - allows synching to hard disk.
+			pthread_mutex_lock(&bufferLock);
+
+			dataWrittenLength += [dataToBeWritten length];
+			[dataToBeWritten setLength:0];
+			writerActiveTime += writeDuration;
+
+			if (!bufferDataLength) {
 				allDataWritten = YES;
+				pthread_cond_broadcast(&bufferCondition);
 			}
+		}
 
-			pthread_mutex_unlock(&bufferLock);
+		processingThreadFinished = YES;
+		allDataWritten = YES;
 
-			[dataToBeWritten release];
-		}
+		pthread_cond_broadcast(&bufferCondition);
+		pthread_mutex_unlock(&bufferLock);
 	}
 }
 
 /**
- * Close any open file handles
+ * Record a failed write, keeping the first error so later writes can't mask it.
+ */
+- (void)_setWriteError:(int)errorNumber
+{
+	pthread_mutex_lock(&bufferLock);
+
+	if (!writeError) writeError = (errorNumber) ? errorNumber : EIO;
+
+	pthread_cond_broadcast(&bufferCondition);
+	pthread_mutex_unlock(&bufferLock);
+}
+
+/**
+ * Start a compressor for the compression format when writing, if one isn't already running.
+ * Compressors write the header of their stream as they start, so are only started once data
+ * is written to the stream.
+ */
+- (void)_startCompressionStream
+{
+	if (fileMode != O_WRONLY) return;
+
+	if (compressionFormat == SPGzipCompression && !gzipCompressor) {
+		gzipCompressor = [[SPParallelGzipCompressor alloc] initWithFile:wrappedFile->file compressionLevel:compressionLevel];
+	}
+	else if (compressionFormat == SPBzip2Compression && !bzip2Compressor) {
+		bzip2Compressor = [[SPParallelBzip2Compressor alloc] initWithFile:wrappedFile->file];
+	}
+}
+
+/**
+ * Close any open file handles.  Finishing a compressor writes out the end of its stream, and
+ * closing a file writes out any data still buffered by stdio, so failures of either are recorded
+ * as write errors.
  */
 - (void)_closeFileHandles
 {
+	// A new compressed file with no data written is still written as a valid, empty, stream
+	if (fileMode == O_WRONLY && !dataWrittenLength && !appendsToFile) [self _startCompressionStream];
+
 	if (compressionFormat == SPGzipCompression) {
-		gzclose(wrappedFile->gzfile);
-		wrappedFile->gzfile = NULL;
-	}
-	else if (compressionFormat == SPBzip2Compression) {
-		if (fileMode == O_RDONLY) {
-			BZ2_bzReadClose(NULL, wrappedFile->bzfile);
-		}
-		else if (fileMode == O_WRONLY) {
-			BZ2_bzWriteClose(NULL, wrappedFile->bzfile, 0, NULL, NULL);
+		if (fileMode == O_WRONLY) {
+			if (gzipCompressor) {
+				if (![gzipCompressor finish]) {
+					NSLog(@"SPFileHandle failed to write gzip data to %s", wrappedFilePath);
+					[self _setWriteError:EIO];
+				}
+
+				SPClear(gzipCompressor);
+			}
+			if (fclose(wrappedFile->file) != 0) [self _setWriteError:errno];
+			wrappedFile->file = NULL;
 		}
 		else {
-			[NSException raise:NSInvalidArgumentException format:@"SPFileHandle only supports read-only and write-only file modes"];
+			gzclose(wrappedFile->gzfile);
+			wrappedFile->gzfile = NULL;
+		}
+	}
+	else if (compressionFormat == SPBzip2Compression) {
+		if (bzip2Compressor) {
+			if (![bzip2Compressor finish]) {
+				NSLog(@"SPFileHandle failed to write bzip2 data to %s", wrappedFilePath);
+				[self _setWriteError:EIO];
+			}
+
+			SPClear(bzip2Compressor);
 		}
-		fclose(wrappedFile->file);
-		wrappedFile->bzfile = NULL;
+		if (bzip2Decompressor) SPClear(bzip2Decompressor);
+		if (fclose(wrappedFile->file) != 0 && fileMode == O_WRONLY) [self _setWriteError:errno];
 		wrappedFile->file = NULL;
 	}
 	else {
-		fclose(wrappedFile->file);
+		if (fclose(wrappedFile->file) != 0 && fileMode == O_WRONLY) [self _setWriteError:errno];
 		wrappedFile->file = NULL;
 	}
 }
@@ -468,7 +801,9 @@ struct SPRawFileHandles {
 	free(wrappedFile);
 	free(wrappedFilePath);
 	SPClear(buffer);
+	SPClear(writeBuffer);
 	
+	pthread_cond_destroy(&bufferCondition);
 	pthread_mutex_destroy(&bufferLock);
 	
 	[super dealloc];
@@ -170,8 +170,17 @@ static NSString *DirectoryLocationDomain = @"DirectoryLocationDomain";
 		return NSUTF8StringEncoding;
 	}
 
+	NSData *startData = nil;
+
+	// Corrupt compressed data is left for the import reading the file to report
+	@try {
+		startData = [detectorFileHandle readDataOfLength:5000000];
+	}
+	@catch (NSException *exception) {
+		return NSUTF8StringEncoding;
+	}
+
 	UniversalDetector *fileEncodingDetector = [[UniversalDetector alloc] init];
-	NSData *startData = [detectorFileHandle readDataOfLength:5000000];
 	[fileEncodingDetector analyzeData:startData];
 	detectedEncoding = [fileEncodingDetector encoding];
 	[fileEncodingDetector release];
@@ -0,0 +1,65 @@
+//
+//  SPParallelBzip2Compressor.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPParallelBzip2Compressor SPParallelBzip2Compressor.h
+ *
+ * Compresses data written to a file into bzip2 format, using all available cores.
+ *
+ * As with pbzip2, the data is split into 900k blocks - the bzip2 block size - which are
+ * compressed independently on a worker pool into complete bzip2 streams, and written in order
+ * as they complete.  bzip2 decompressors treat concatenated streams as a single file, and as
+ * bzip2 blocks are compressed independently anyway the compression ratio is unchanged.
+ */
+@interface SPParallelBzip2Compressor : NSObject
+{
+	FILE *outputFile;
+
+	NSMutableData *currentBlockData;
+	NSMutableArray *pendingBlocks;
+	NSUInteger maximumPendingBlocks;
+
+	unsigned long long uncompressedLength;
+	unsigned long long compressedLength;
+
+	BOOL writeFailed;
+	BOOL finished;
+}
+
+- (id)initWithFile:(FILE *)file;
+
+- (void)compressBytes:(const void *)bytes length:(NSUInteger)length;
+- (BOOL)finish;
+- (BOOL)writeFailed;
+
+- (unsigned long long)uncompressedLength;
+- (unsigned long long)compressedLength;
+
+@end
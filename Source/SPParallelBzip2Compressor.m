@@ -0,0 +1,281 @@
+//
+//  SPParallelBzip2Compressor.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParallelBzip2Compressor.h"
+#import "bzlib.h"
+
+// The amount of uncompressed data compressed by each worker, matching the largest bzip2 block size
+static const NSUInteger SPParallelBzip2BlockLength = 900000;
+
+/**
+ * A block of data compressed by a worker.
+ */
+@interface SPParallelBzip2Block : NSObject
+{
+	NSData *inputData;
+	NSMutableData *outputData;
+	BOOL failed;
+	dispatch_semaphore_t completionSemaphore;
+}
+
+@property (readonly) NSData *inputData;
+@property (readonly) NSMutableData *outputData;
+@property (readonly) BOOL failed;
+
+- (id)initWithData:(NSData *)data;
+- (void)compress;
+- (BOOL)waitUntilCompressed:(BOOL)block;
+
+@end
+
+@implementation SPParallelBzip2Block
+
+@synthesize inputData;
+@synthesize outputData;
+@synthesize failed;
+
+- (id)initWithData:(NSData *)data
+{
+	if ((self = [super init])) {
+		inputData = [data retain];
+		outputData = nil;
+		failed = NO;
+		completionSemaphore = dispatch_semaphore_create(0);
+	}
+
+	return self;
+}
+
+/**
+ * Compress the block as a complete bzip2 stream.  Run on a worker thread.
+ */
+- (void)compress
+{
+	// bzip2 output is at most 1% larger than its input, plus 600 bytes
+	unsigned int outputLength = (unsigned int)([inputData length] + [inputData length] / 100 + 600);
+
+	outputData = [[NSMutableData alloc] initWithLength:outputLength];
+
+	if (BZ2_bzBuffToBuffCompress([outputData mutableBytes], &outputLength, (char *)[inputData bytes], (unsigned int)[inputData length], 9, 0, 0) != BZ_OK) {
+		failed = YES;
+		outputLength = 0;
+	}
+
+	[outputData setLength:outputLength];
+
+	dispatch_semaphore_signal(completionSemaphore);
+}
+
+/**
+ * Returns whether the block has been compressed, optionally waiting until it has.
+ */
+- (BOOL)waitUntilCompressed:(BOOL)block
+{
+	return !dispatch_semaphore_wait(completionSemaphore, block ? DISPATCH_TIME_FOREVER : DISPATCH_TIME_NOW);
+}
+
+- (void)dealloc
+{
+	SPClear(inputData);
+	if (outputData) SPClear(outputData);
+
+	dispatch_release(completionSemaphore);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPParallelBzip2Compressor ()
+
+- (void)_submitCurrentBlock;
+- (void)_writeCompressedBlocksWaitingForAll:(BOOL)waitForAll;
+
+@end
+
+@implementation SPParallelBzip2Compressor
+
+/**
+ * Initialise a compressor writing bzip2 data to the supplied file, which must remain
+ * open until -finish has been called.
+ */
+- (id)initWithFile:(FILE *)file
+{
+	if ((self = [super init])) {
+		outputFile = file;
+
+		currentBlockData = [[NSMutableData alloc] initWithCapacity:SPParallelBzip2BlockLength];
+		pendingBlocks = [[NSMutableArray alloc] init];
+
+		// Allow enough blocks in flight to keep every core busy while the next block is filled
+		maximumPendingBlocks = MAX(2, [[NSProcessInfo processInfo] activeProcessorCount] * 2);
+
+		uncompressedLength = 0;
+		compressedLength = 0;
+
+		writeFailed = NO;
+		finished = NO;
+	}
+
+	return self;
+}
+
+/**
+ * Add the supplied data to the stream.  Full blocks are handed to the worker pool, and any
+ * compressed blocks are written out in order; blocks if too many are still being compressed.
+ */
+- (void)compressBytes:(const void *)bytes length:(NSUInteger)length
+{
+	if (finished) [NSException raise:NSInternalInconsistencyException format:@"Cannot compress data after the bzip2 stream has been finished"];
+
+	const char *remainingBytes = bytes;
+
+	while (length)
+	{
+		NSUInteger copyLength = MIN(length, SPParallelBzip2BlockLength - [currentBlockData length]);
+
+		[currentBlockData appendBytes:remainingBytes length:copyLength];
+
+		remainingBytes += copyLength;
+		length -= copyLength;
+
+		if ([currentBlockData length] == SPParallelBzip2BlockLength) [self _submitCurrentBlock];
+	}
+}
+
+/**
+ * Compress any remaining data and wait for all blocks to be written.  The file is not closed.
+ *
+ * @return NO if any data could not be compressed or written
+ */
+- (BOOL)finish
+{
+	if (finished) return !writeFailed;
+
+	// An empty file is still written as a valid, empty, bzip2 stream
+	if ([currentBlockData length] || (![pendingBlocks count] && !uncompressedLength)) [self _submitCurrentBlock];
+
+	[self _writeCompressedBlocksWaitingForAll:YES];
+
+	finished = YES;
+
+	return !writeFailed;
+}
+
+/**
+ * Returns whether any data compressed so far could not be compressed or written.
+ */
+- (BOOL)writeFailed
+{
+	return writeFailed;
+}
+
+/**
+ * Returns the amount of uncompressed data which has been compressed and written so far.
+ */
+- (unsigned long long)uncompressedLength
+{
+	return uncompressedLength;
+}
+
+/**
+ * Returns the amount of compressed data written to the file.
+ */
+- (unsigned long long)compressedLength
+{
+	return compressedLength;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Hand the current block to the worker pool.
+ */
+- (void)_submitCurrentBlock
+{
+	SPParallelBzip2Block *block = [[SPParallelBzip2Block alloc] initWithData:currentBlockData];
+
+	[pendingBlocks addObject:block];
+
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		[block compress];
+	});
+
+	[block release];
+
+	SPClear(currentBlockData);
+	currentBlockData = [[NSMutableData alloc] initWithCapacity:SPParallelBzip2BlockLength];
+
+	[self _writeCompressedBlocksWaitingForAll:NO];
+}
+
+/**
+ * Write out compressed blocks in order.  Stops at the first block still being compressed
+ * unless all blocks are to be written, or the maximum number of blocks are in flight.
+ */
+- (void)_writeCompressedBlocksWaitingForAll:(BOOL)waitForAll
+{
+	while ([pendingBlocks count])
+	{
+		SPParallelBzip2Block *block = [pendingBlocks objectAtIndex:0];
+
+		if (![block waitUntilCompressed:(waitForAll || [pendingBlocks count] >= maximumPendingBlocks)]) break;
+
+		NSData *outputData = [block outputData];
+
+		if ([block failed] || fwrite([outputData bytes], 1, [outputData length], outputFile) < [outputData length]) writeFailed = YES;
+
+		compressedLength += [outputData length];
+		uncompressedLength += [[block inputData] length];
+
+		[pendingBlocks removeObjectAtIndex:0];
+	}
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	// Ensure no workers are still using the pending blocks' data
+	for (SPParallelBzip2Block *block in pendingBlocks)
+	{
+		[block waitUntilCompressed:YES];
+	}
+
+	SPClear(currentBlockData);
+	SPClear(pendingBlocks);
+
+	[super dealloc];
+}
+
+@end
@@ -0,0 +1,74 @@
+//
+//  SPParallelBzip2Decompressor.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPParallelBzip2Decompressor SPParallelBzip2Decompressor.h
+ *
+ * Reads bzip2 data from a file, decompressing blocks across all available cores.
+ *
+ * bzip2 blocks are compressed independently but are not byte-aligned, so the compressed data is
+ * scanned bit by bit for the block and end of stream markers.  Each block found is wrapped in a
+ * stream of its own and decompressed on a worker pool, with the results returned in order.  The
+ * markers can occur by chance within compressed data, so decompression is speculative: a block
+ * which fails to decompress is retried joined to the following block before being reported as
+ * corrupt, and an end of stream marker followed by neither another stream nor the end of the file
+ * is treated as a block marker until the block before it has decompressed.  Concatenated streams, as written by pbzip2 or SPParallelBzip2Compressor, are read as
+ * a single stream.
+ */
+@interface SPParallelBzip2Decompressor : NSObject
+{
+	FILE *inputFile;
+	NSMutableData *inputData;
+	uint64_t scanBit;
+	uint64_t blockStartBit;
+	BOOL blockOpen;
+	BOOL blockFollowsEndOfStream;
+	BOOL expectingStreamHeader;
+	BOOL streamFound;
+	unsigned char blockSizeLevel;
+	BOOL endOfInput;
+	BOOL scanFinished;
+
+	NSMutableArray *pendingBlocks;
+	NSUInteger maximumPendingBlocks;
+
+	NSData *currentOutput;
+	NSUInteger currentOutputPosition;
+
+	BOOL decompressionFailed;
+}
+
+- (id)initWithFile:(FILE *)file;
+
+- (NSUInteger)readBytes:(void *)bytes length:(NSUInteger)length;
+
+- (BOOL)decompressionFailed;
+
+@end
@@ -0,0 +1,587 @@
+//
+//  SPParallelBzip2Decompressor.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParallelBzip2Decompressor.h"
+#import "bzlib.h"
+
+// The amount of compressed data read from the file at a time
+static const NSUInteger SPParallelBzip2ReadLength = 4 * 1024 * 1024;
+
+// Run-length encoding can expand a block far beyond the block size; the most a block is allowed to grow to
+static const NSUInteger SPParallelBzip2MaximumExpansion = 64;
+
+// Block and end of stream markers: the BCD digits of pi and of sqrt(pi)
+static const uint64_t SPBzip2BlockMagic = 0x314159265359ULL;
+static const uint64_t SPBzip2EndOfStreamMagic = 0x177245385090ULL;
+
+/**
+ * Returns the bit at the supplied position, counting from the most significant bit of the first byte.
+ */
+static inline unsigned int _SPBzip2BitAt(const unsigned char *bytes, uint64_t bit)
+{
+	return (bytes[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/**
+ * Search the bits from *bitPosition up to endBit for the next block or end of stream marker.
+ * Returns whether one was found, setting *markerBit to its first bit; otherwise *bitPosition
+ * is advanced to the first bit which could still start a marker once more data is available.
+ */
+static BOOL _SPBzip2FindMarker(const unsigned char *bytes, uint64_t *bitPosition, uint64_t endBit, uint64_t *markerBit, BOOL *isEndOfStream)
+{
+	uint64_t firstMarkerEnd = *bitPosition + 47;
+	uint64_t window = 0;
+
+	if (endBit <= firstMarkerEnd) return NO;
+
+	// Shift in a byte at a time, testing the markers ending at each of its bits in order
+	for (uint64_t byteIndex = *bitPosition >> 3; (byteIndex << 3) < endBit; byteIndex++)
+	{
+		window = (window << 8) | bytes[byteIndex];
+
+		for (int shift = 7; shift >= 0; shift--)
+		{
+			uint64_t markerEnd = (byteIndex << 3) + 7 - shift;
+			uint64_t candidate = (window >> shift) & 0xFFFFFFFFFFFFULL;
+
+			if ((candidate == SPBzip2BlockMagic || candidate == SPBzip2EndOfStreamMagic) && markerEnd >= firstMarkerEnd && markerEnd < endBit) {
+				*markerBit = markerEnd - 47;
+				*isEndOfStream = (candidate == SPBzip2EndOfStreamMagic);
+				*bitPosition = *markerBit;
+				return YES;
+			}
+		}
+	}
+
+	*bitPosition = endBit - 47;
+
+	return NO;
+}
+
+/**
+ * Returns the length of the single block bzip2 stream written by _SPBzip2WriteBlockStream.
+ */
+static inline size_t _SPBzip2BlockStreamLength(uint64_t bitCount)
+{
+	return 4 + (size_t)((bitCount + 80 + 7) >> 3);
+}
+
+/**
+ * Wrap the block at the supplied bit offset in a stream header and end of stream marker, so it
+ * can be decompressed on its own.  The block's CRC doubles as the stream CRC for a single block.
+ */
+static size_t _SPBzip2WriteBlockStream(unsigned char *output, const unsigned char *bytes, uint64_t startBit, uint64_t bitCount, unsigned char blockSizeLevel)
+{
+	const unsigned char *source = bytes + (startBit >> 3);
+	unsigned int shift = (unsigned int)(startBit & 7);
+	uint64_t wholeBytes = bitCount >> 3;
+	uint32_t blockCRC = 0;
+	uint64_t i;
+
+	output[0] = 'B';
+	output[1] = 'Z';
+	output[2] = 'h';
+	output[3] = blockSizeLevel;
+	output += 4;
+
+	// The block is copied to a byte boundary, so whole bytes can be shifted into place
+	if (shift) {
+		for (i = 0; i < wholeBytes; i++) output[i] = (unsigned char)((source[i] << shift) | (source[i + 1] >> (8 - shift)));
+	}
+	else {
+		memcpy(output, source, (size_t)wholeBytes);
+	}
+
+	for (i = 48; i < 80; i++) blockCRC = (blockCRC << 1) | _SPBzip2BitAt(bytes, startBit + i);
+
+	// Append the remaining bits of the block, the end of stream marker and the stream CRC
+	uint64_t outputBit = wholeBytes << 3;
+
+	memset(output + wholeBytes, 0, (size_t)(_SPBzip2BlockStreamLength(bitCount) - 4 - wholeBytes));
+
+	for (i = wholeBytes << 3; i < bitCount; i++, outputBit++) {
+		if (_SPBzip2BitAt(bytes, startBit + i)) output[outputBit >> 3] |= (unsigned char)(0x80 >> (outputBit & 7));
+	}
+	for (i = 0; i < 48; i++, outputBit++) {
+		if ((SPBzip2EndOfStreamMagic >> (47 - i)) & 1) output[outputBit >> 3] |= (unsigned char)(0x80 >> (outputBit & 7));
+	}
+	for (i = 0; i < 32; i++, outputBit++) {
+		if ((blockCRC >> (31 - i)) & 1) output[outputBit >> 3] |= (unsigned char)(0x80 >> (outputBit & 7));
+	}
+
+	return 4 + (size_t)((outputBit + 7) >> 3);
+}
+
+/**
+ * A block of compressed data, located by its markers, decompressed by a worker.
+ */
+@interface SPParallelBzip2DecompressionBlock : NSObject
+{
+	NSData *inputData;
+	uint64_t startBit;
+	uint64_t bitCount;
+	unsigned char blockSizeLevel;
+	BOOL endsStream;
+	BOOL followsEndOfStream;
+	NSMutableData *outputData;
+	BOOL failed;
+	dispatch_semaphore_t completionSemaphore;
+}
+
+@property (readonly) NSMutableData *outputData;
+@property (readonly) BOOL endsStream;
+@property (readonly) BOOL followsEndOfStream;
+@property (readonly) BOOL failed;
+
+- (id)initWithData:(NSData *)data startBit:(uint64_t)start bitCount:(uint64_t)count blockSizeLevel:(unsigned char)level endsStream:(BOOL)ends followsEndOfStream:(BOOL)follows;
+- (SPParallelBzip2DecompressionBlock *)blockJoinedToBlock:(SPParallelBzip2DecompressionBlock *)nextBlock;
+- (void)decompress;
+- (BOOL)waitUntilDecompressed:(BOOL)block;
+
+@end
+
+@implementation SPParallelBzip2DecompressionBlock
+
+@synthesize outputData;
+@synthesize endsStream;
+@synthesize followsEndOfStream;
+@synthesize failed;
+
+/**
+ * Initialise a block from data spanning it, starting at the supplied bit of the first byte.
+ * A block following an end of stream marker which may have occurred by chance may instead
+ * be data trailing the last stream.
+ */
+- (id)initWithData:(NSData *)data startBit:(uint64_t)start bitCount:(uint64_t)count blockSizeLevel:(unsigned char)level endsStream:(BOOL)ends followsEndOfStream:(BOOL)follows
+{
+	if ((self = [super init])) {
+		inputData = [data retain];
+		startBit = start;
+		bitCount = count;
+		blockSizeLevel = level;
+		endsStream = ends;
+		followsEndOfStream = follows;
+		outputData = nil;
+		failed = NO;
+		completionSemaphore = dispatch_semaphore_create(0);
+	}
+
+	return self;
+}
+
+/**
+ * Returns a new block made of this block and the block following it, for when the marker
+ * between them occurred by chance within the compressed data.
+ */
+- (SPParallelBzip2DecompressionBlock *)blockJoinedToBlock:(SPParallelBzip2DecompressionBlock *)nextBlock
+{
+	// The next block's data starts with the byte containing the end of this block
+	NSMutableData *joinedData = [NSMutableData dataWithBytes:[inputData bytes] length:(NSUInteger)((startBit + bitCount) >> 3)];
+
+	[joinedData appendData:nextBlock->inputData];
+
+	return [[[SPParallelBzip2DecompressionBlock alloc] initWithData:joinedData startBit:startBit bitCount:(bitCount + nextBlock->bitCount) blockSizeLevel:blockSizeLevel endsStream:nextBlock->endsStream followsEndOfStream:followsEndOfStream] autorelease];
+}
+
+/**
+ * Decompress the block as a stream of its own.  Run on a worker thread.
+ */
+- (void)decompress
+{
+	NSMutableData *streamData = [[NSMutableData alloc] initWithLength:_SPBzip2BlockStreamLength(bitCount)];
+	unsigned int streamLength = (unsigned int)_SPBzip2WriteBlockStream([streamData mutableBytes], [inputData bytes], startBit, bitCount, blockSizeLevel);
+	NSUInteger blockSize = (blockSizeLevel - '0') * 100000;
+	NSUInteger capacity = blockSize + blockSize / 4;
+	int status;
+
+	outputData = [[NSMutableData alloc] initWithLength:capacity];
+
+	// Grow the output buffer until the block fits
+	do {
+		unsigned int outputLength = (unsigned int)[outputData length];
+
+		status = BZ2_bzBuffToBuffDecompress([outputData mutableBytes], &outputLength, [streamData mutableBytes], streamLength, 0, 0);
+
+		if (status == BZ_OK) {
+			[outputData setLength:outputLength];
+		}
+		else if (status == BZ_OUTBUFF_FULL) {
+			[outputData setLength:[outputData length] * 2];
+		}
+	}
+	while (status == BZ_OUTBUFF_FULL && [outputData length] <= blockSize * SPParallelBzip2MaximumExpansion);
+
+	if (status != BZ_OK) {
+		failed = YES;
+		[outputData setLength:0];
+	}
+
+	[streamData release];
+
+	dispatch_semaphore_signal(completionSemaphore);
+}
+
+/**
+ * Returns whether the block has been decompressed, optionally waiting until it has.
+ */
+- (BOOL)waitUntilDecompressed:(BOOL)block
+{
+	return !dispatch_semaphore_wait(completionSemaphore, block ? DISPATCH_TIME_FOREVER : DISPATCH_TIME_NOW);
+}
+
+- (void)dealloc
+{
+	SPClear(inputData);
+	if (outputData) SPClear(outputData);
+
+	dispatch_release(completionSemaphore);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPParallelBzip2Decompressor ()
+
+- (BOOL)_takeNextDecompressedBlock;
+- (void)_queueBlocks;
+- (void)_submitBlockEndingAtBit:(uint64_t)endBit endsStream:(BOOL)ends;
+- (void)_readInput;
+
+@end
+
+@implementation SPParallelBzip2Decompressor
+
+/**
+ * Initialise a decompressor reading bzip2 data from the start of the supplied file, which
+ * must remain open while data is read.
+ */
+- (id)initWithFile:(FILE *)file
+{
+	if ((self = [super init])) {
+		inputFile = file;
+		inputData = [[NSMutableData alloc] init];
+
+		scanBit = 0;
+		blockStartBit = 0;
+		blockOpen = NO;
+		blockFollowsEndOfStream = NO;
+		expectingStreamHeader = YES;
+		streamFound = NO;
+		blockSizeLevel = '9';
+		endOfInput = NO;
+		scanFinished = NO;
+
+		pendingBlocks = [[NSMutableArray alloc] init];
+
+		// Allow enough blocks in flight to keep every core busy while the output is consumed
+		maximumPendingBlocks = MAX(2, [[NSProcessInfo processInfo] activeProcessorCount] * 2);
+
+		currentOutput = nil;
+		currentOutputPosition = 0;
+
+		decompressionFailed = NO;
+	}
+
+	return self;
+}
+
+/**
+ * Read up to the supplied number of decompressed bytes, returning the number read; fewer
+ * bytes are only returned at the end of the file or if the data is corrupt.
+ */
+- (NSUInteger)readBytes:(void *)bytes length:(NSUInteger)length
+{
+	NSUInteger readLength = 0;
+
+	while (readLength < length)
+	{
+		if (currentOutput && currentOutputPosition < [currentOutput length]) {
+			NSUInteger copyLength = MIN(length - readLength, [currentOutput length] - currentOutputPosition);
+
+			memcpy((char *)bytes + readLength, (const char *)[currentOutput bytes] + currentOutputPosition, copyLength);
+
+			readLength += copyLength;
+			currentOutputPosition += copyLength;
+
+			continue;
+		}
+
+		if (currentOutput) SPClear(currentOutput);
+
+		if (![self _takeNextDecompressedBlock]) break;
+	}
+
+	return readLength;
+}
+
+/**
+ * Returns whether reading stopped early because the data was corrupt or truncated.
+ */
+- (BOOL)decompressionFailed
+{
+	return decompressionFailed;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Wait for the next block in order to be decompressed and make it the current output,
+ * joining it to the following block and retrying if it fails.  Returns NO at the end of
+ * the data, or if a block could not be decompressed.
+ */
+- (BOOL)_takeNextDecompressedBlock
+{
+	if (decompressionFailed) return NO;
+
+	[self _queueBlocks];
+
+	while ([pendingBlocks count])
+	{
+		SPParallelBzip2DecompressionBlock *block = [pendingBlocks objectAtIndex:0];
+
+		[block waitUntilDecompressed:YES];
+
+		if (![block failed]) {
+			currentOutput = [[block outputData] retain];
+			currentOutputPosition = 0;
+
+			[pendingBlocks removeObjectAtIndex:0];
+
+			// Keep the workers busy while the output is consumed
+			[self _queueBlocks];
+
+			return YES;
+		}
+
+		// An end of stream marker not followed by another stream did end the last stream, so as
+		// with bzip2 the data after it is ignored
+		if ([block followsEndOfStream]) {
+			NSLog(@"SPParallelBzip2Decompressor ignored trailing data after the last bzip2 stream");
+
+			[pendingBlocks removeAllObjects];
+			scanFinished = YES;
+
+			return NO;
+		}
+
+		[self _queueBlocks];
+
+		// The block may have been ended by a marker occurring by chance, so retry it joined to the next block
+		if ([block endsStream] || [pendingBlocks count] < 2) {
+			NSLog(@"SPParallelBzip2Decompressor could not decompress a corrupt bzip2 block");
+
+			decompressionFailed = YES;
+
+			return NO;
+		}
+
+		SPParallelBzip2DecompressionBlock *joinedBlock = [block blockJoinedToBlock:[pendingBlocks objectAtIndex:1]];
+
+		[pendingBlocks replaceObjectsInRange:NSMakeRange(0, 2) withObjectsFromArray:@[joinedBlock]];
+
+		[joinedBlock decompress];
+	}
+
+	return NO;
+}
+
+/**
+ * Scan the compressed data for blocks, handing them to the worker pool until the maximum
+ * number of blocks are in flight or the end of the data is reached.
+ */
+- (void)_queueBlocks
+{
+	while (!scanFinished && [pendingBlocks count] < maximumPendingBlocks)
+	{
+		const unsigned char *bytes = [inputData bytes];
+		NSUInteger inputLength = [inputData length];
+
+		// Each stream starts on a byte boundary with "BZh" and the block size
+		if (expectingStreamHeader) {
+			NSUInteger headerByte = (NSUInteger)(scanBit >> 3);
+
+			if (inputLength < headerByte + 4 && !endOfInput) {
+				[self _readInput];
+				continue;
+			}
+
+			if (inputLength >= headerByte + 4 && bytes[headerByte] == 'B' && bytes[headerByte + 1] == 'Z' && bytes[headerByte + 2] == 'h' && bytes[headerByte + 3] >= '1' && bytes[headerByte + 3] <= '9') {
+				blockSizeLevel = bytes[headerByte + 3];
+				scanBit += 32;
+				expectingStreamHeader = NO;
+				streamFound = YES;
+			}
+			else {
+				// As with bzip2, any data after the last stream is ignored
+				if (!streamFound) {
+					NSLog(@"SPParallelBzip2Decompressor could not find a bzip2 stream header");
+					decompressionFailed = YES;
+				}
+				else if (inputLength > headerByte) {
+					NSLog(@"SPParallelBzip2Decompressor ignored trailing data after the last bzip2 stream");
+				}
+
+				scanFinished = YES;
+			}
+
+			continue;
+		}
+
+		uint64_t markerBit;
+		BOOL isEndOfStream;
+
+		if (!_SPBzip2FindMarker(bytes, &scanBit, (uint64_t)inputLength << 3, &markerBit, &isEndOfStream)) {
+			if (!endOfInput) {
+				[self _readInput];
+				continue;
+			}
+
+			// The file ends part way through a stream; pass on any final block so it is reported as corrupt
+			if (blockOpen) {
+				[self _submitBlockEndingAtBit:((uint64_t)inputLength << 3) endsStream:YES];
+			}
+			else {
+				NSLog(@"SPParallelBzip2Decompressor found a truncated bzip2 stream");
+			}
+
+			scanFinished = YES;
+
+			continue;
+		}
+
+		// The end of stream marker is followed by the stream CRC and padding to a byte boundary, then
+		// another stream or the end of the file; otherwise the marker may have occurred by chance
+		BOOL doubtfulEndOfStream = NO;
+
+		if (isEndOfStream) {
+			NSUInteger headerByte = (NSUInteger)((markerBit + 80 + 7) >> 3);
+
+			if (inputLength < headerByte + 4 && !endOfInput) {
+				[self _readInput];
+				continue;
+			}
+
+			BOOL streamFollows = (inputLength >= headerByte + 4 && bytes[headerByte] == 'B' && bytes[headerByte + 1] == 'Z' && bytes[headerByte + 2] == 'h' && bytes[headerByte + 3] >= '1' && bytes[headerByte + 3] <= '9');
+
+			if (!streamFollows && inputLength > headerByte) {
+				doubtfulEndOfStream = YES;
+				isEndOfStream = NO;
+			}
+		}
+
+		if (blockOpen) [self _submitBlockEndingAtBit:markerBit endsStream:isEndOfStream];
+
+		if (isEndOfStream) {
+			blockOpen = NO;
+			expectingStreamHeader = YES;
+			scanBit = ((markerBit + 80 + 7) >> 3) << 3;
+		}
+		else {
+			// Split the block at a doubtful end of stream marker as for a block marker; if the block
+			// before it decompresses the marker was genuine, and what follows is trailing data
+			blockOpen = YES;
+			blockFollowsEndOfStream = doubtfulEndOfStream;
+			blockStartBit = markerBit;
+			scanBit = markerBit + 48;
+		}
+	}
+}
+
+/**
+ * Hand the open block, ending at the supplied bit, to the worker pool.
+ */
+- (void)_submitBlockEndingAtBit:(uint64_t)endBit endsStream:(BOOL)ends
+{
+	NSUInteger firstByte = (NSUInteger)(blockStartBit >> 3);
+	NSUInteger endByte = (NSUInteger)((endBit + 7) >> 3);
+	NSData *blockData = [inputData subdataWithRange:NSMakeRange(firstByte, endByte - firstByte)];
+
+	SPParallelBzip2DecompressionBlock *block = [[SPParallelBzip2DecompressionBlock alloc] initWithData:blockData startBit:(blockStartBit & 7) bitCount:(endBit - blockStartBit) blockSizeLevel:blockSizeLevel endsStream:ends followsEndOfStream:blockFollowsEndOfStream];
+
+	[pendingBlocks addObject:block];
+
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		[block decompress];
+	});
+
+	[block release];
+
+	blockOpen = NO;
+}
+
+/**
+ * Discard the data which has been scanned and is not part of the open block, and read
+ * more data from the file.
+ */
+- (void)_readInput
+{
+	uint64_t keepFromBit = blockOpen ? blockStartBit : scanBit;
+	NSUInteger discardLength = (NSUInteger)MIN(keepFromBit >> 3, [inputData length]);
+
+	if (discardLength) {
+		[inputData replaceBytesInRange:NSMakeRange(0, discardLength) withBytes:NULL length:0];
+
+		scanBit -= (uint64_t)discardLength << 3;
+		if (blockOpen) blockStartBit -= (uint64_t)discardLength << 3;
+	}
+
+	NSUInteger previousLength = [inputData length];
+
+	[inputData setLength:previousLength + SPParallelBzip2ReadLength];
+
+	size_t readLength = fread((char *)[inputData mutableBytes] + previousLength, 1, SPParallelBzip2ReadLength, inputFile);
+
+	[inputData setLength:previousLength + readLength];
+
+	if (readLength < SPParallelBzip2ReadLength) endOfInput = YES;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	// Ensure no workers are still using the pending blocks' data
+	for (SPParallelBzip2DecompressionBlock *block in pendingBlocks)
+	{
+		[block waitUntilDecompressed:YES];
+	}
+
+	SPClear(inputData);
+	SPClear(pendingBlocks);
+	if (currentOutput) SPClear(currentOutput);
+
+	[super dealloc];
+}
+
+@end
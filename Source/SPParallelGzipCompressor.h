@@ -0,0 +1,69 @@
+//
+//  SPParallelGzipCompressor.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPParallelGzipCompressor SPParallelGzipCompressor.h
+ *
+ * Compresses data written to a file into a standard single-member gzip stream, using all available cores.
+ *
+ * As with pigz, the data is split into fixed-size blocks which are deflated independently on a worker
+ * pool, each primed with the last 32KB of the previous block as a preset dictionary so the compression
+ * ratio stays close to that of a single stream.  Each block ends with a sync flush so the compressed
+ * blocks can be concatenated; they are written in order as they complete, and the CRCs of the blocks
+ * are combined for the gzip trailer.
+ */
+@interface SPParallelGzipCompressor : NSObject
+{
+	FILE *outputFile;
+	int compressionLevel;
+
+	NSMutableData *currentBlockData;
+	NSData *previousBlockData;
+	NSMutableArray *pendingBlocks;
+	NSUInteger maximumPendingBlocks;
+
+	unsigned long combinedCRC;
+	unsigned long long uncompressedLength;
+	unsigned long long compressedLength;
+
+	BOOL writeFailed;
+	BOOL finished;
+}
+
+- (id)initWithFile:(FILE *)file compressionLevel:(NSInteger)level;
+
+- (void)compressBytes:(const void *)bytes length:(NSUInteger)length;
+- (BOOL)finish;
+- (BOOL)writeFailed;
+
+- (unsigned long long)uncompressedLength;
+- (unsigned long long)compressedLength;
+
+@end
@@ -0,0 +1,370 @@
+//
+//  SPParallelGzipCompressor.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParallelGzipCompressor.h"
+#import "zlib.1.2.4.h"
+
+// The amount of uncompressed data deflated by each worker
+static const NSUInteger SPParallelGzipBlockLength = 128 * 1024;
+
+// The length of the preset dictionary taken from the end of the previous block
+static const NSUInteger SPParallelGzipDictionaryLength = 32 * 1024;
+
+// Header of a gzip member without a file name or modification time, as written by gzopen()
+static const unsigned char SPParallelGzipHeader[10] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 };
+
+// An empty final deflate block, terminating the concatenated sync-flushed blocks
+static const unsigned char SPParallelGzipFinalBlock[2] = { 0x03, 0x00 };
+
+/**
+ * A block of data compressed by a worker.
+ */
+@interface SPParallelGzipBlock : NSObject
+{
+	NSData *inputData;
+	NSData *dictionaryData;
+	NSMutableData *outputData;
+	unsigned long crc;
+	BOOL failed;
+	dispatch_semaphore_t completionSemaphore;
+}
+
+@property (readonly) NSData *inputData;
+@property (readonly) NSMutableData *outputData;
+@property (readonly) unsigned long crc;
+@property (readonly) BOOL failed;
+
+- (id)initWithData:(NSData *)data dictionaryData:(NSData *)dictionary;
+- (void)compressWithLevel:(int)level;
+- (BOOL)waitUntilCompressed:(BOOL)block;
+
+@end
+
+@implementation SPParallelGzipBlock
+
+@synthesize inputData;
+@synthesize outputData;
+@synthesize crc;
+@synthesize failed;
+
+- (id)initWithData:(NSData *)data dictionaryData:(NSData *)dictionary
+{
+	if ((self = [super init])) {
+		inputData = [data retain];
+		dictionaryData = [dictionary retain];
+		outputData = nil;
+		crc = 0;
+		failed = NO;
+		completionSemaphore = dispatch_semaphore_create(0);
+	}
+
+	return self;
+}
+
+/**
+ * Deflate the block as raw data, ending with a sync flush so it can be followed by the next block.
+ * Run on a worker thread.
+ */
+- (void)compressWithLevel:(int)level
+{
+	const Bytef *bytes = (const Bytef *)[inputData bytes];
+	uInt length = (uInt)[inputData length];
+	z_stream stream;
+	int status;
+
+	memset(&stream, 0, sizeof(stream));
+
+	crc = crc32(crc32(0L, Z_NULL, 0), bytes, length);
+
+	if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		failed = YES;
+		dispatch_semaphore_signal(completionSemaphore);
+		return;
+	}
+
+	// Prime the stream with the end of the previous block, so matches can span blocks
+	if (dictionaryData) {
+		NSUInteger dictionaryLength = MIN([dictionaryData length], SPParallelGzipDictionaryLength);
+
+		deflateSetDictionary(&stream, (const Bytef *)[dictionaryData bytes] + [dictionaryData length] - dictionaryLength, (uInt)dictionaryLength);
+	}
+
+	outputData = [[NSMutableData alloc] initWithLength:deflateBound(&stream, length) + 64];
+
+	stream.next_in = (Bytef *)bytes;
+	stream.avail_in = length;
+	stream.next_out = [outputData mutableBytes];
+	stream.avail_out = (uInt)[outputData length];
+
+	do {
+		if (!stream.avail_out) {
+			[outputData increaseLengthBy:SPParallelGzipDictionaryLength];
+			stream.next_out = (Bytef *)[outputData mutableBytes] + stream.total_out;
+			stream.avail_out = (uInt)([outputData length] - stream.total_out);
+		}
+
+		status = deflate(&stream, Z_SYNC_FLUSH);
+	}
+	while (status == Z_OK && (stream.avail_in || !stream.avail_out));
+
+	if (status != Z_OK && status != Z_BUF_ERROR) failed = YES;
+
+	[outputData setLength:stream.total_out];
+
+	deflateEnd(&stream);
+
+	// The dictionary is no longer required
+	if (dictionaryData) SPClear(dictionaryData);
+
+	dispatch_semaphore_signal(completionSemaphore);
+}
+
+/**
+ * Returns whether the block has been compressed, optionally waiting until it has.
+ */
+- (BOOL)waitUntilCompressed:(BOOL)block
+{
+	return !dispatch_semaphore_wait(completionSemaphore, block ? DISPATCH_TIME_FOREVER : DISPATCH_TIME_NOW);
+}
+
+- (void)dealloc
+{
+	SPClear(inputData);
+	if (dictionaryData) SPClear(dictionaryData);
+	if (outputData) SPClear(outputData);
+
+	dispatch_release(completionSemaphore);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPParallelGzipCompressor ()
+
+- (void)_submitCurrentBlock;
+- (void)_writeCompressedBlocksWaitingForAll:(BOOL)waitForAll;
+- (void)_writeBytes:(const void *)bytes length:(NSUInteger)length;
+
+@end
+
+@implementation SPParallelGzipCompressor
+
+/**
+ * Initialise a compressor writing a gzip stream to the supplied file, which must
+ * remain open until -finish has been called.
+ *
+ * @param file  The file to write to
+ * @param level The zlib compression level, from 1 (fastest) to 9 (best); other values use the zlib default
+ */
+- (id)initWithFile:(FILE *)file compressionLevel:(NSInteger)level
+{
+	if ((self = [super init])) {
+		outputFile = file;
+		compressionLevel = (level >= 1 && level <= 9) ? (int)level : Z_DEFAULT_COMPRESSION;
+
+		currentBlockData = [[NSMutableData alloc] initWithCapacity:SPParallelGzipBlockLength];
+		previousBlockData = nil;
+		pendingBlocks = [[NSMutableArray alloc] init];
+
+		// Allow enough blocks in flight to keep every core busy while the next block is filled
+		maximumPendingBlocks = MAX(2, [[NSProcessInfo processInfo] activeProcessorCount] * 2);
+
+		combinedCRC = crc32(0L, Z_NULL, 0);
+		uncompressedLength = 0;
+		compressedLength = 0;
+
+		writeFailed = NO;
+		finished = NO;
+
+		[self _writeBytes:SPParallelGzipHeader length:sizeof(SPParallelGzipHeader)];
+	}
+
+	return self;
+}
+
+/**
+ * Add the supplied data to the stream.  Full blocks are handed to the worker pool, and any
+ * compressed blocks are written out in order; blocks if too many are still being compressed.
+ */
+- (void)compressBytes:(const void *)bytes length:(NSUInteger)length
+{
+	if (finished) [NSException raise:NSInternalInconsistencyException format:@"Cannot compress data after the gzip stream has been finished"];
+
+	const char *remainingBytes = bytes;
+
+	while (length)
+	{
+		NSUInteger copyLength = MIN(length, SPParallelGzipBlockLength - [currentBlockData length]);
+
+		[currentBlockData appendBytes:remainingBytes length:copyLength];
+
+		remainingBytes += copyLength;
+		length -= copyLength;
+
+		if ([currentBlockData length] == SPParallelGzipBlockLength) [self _submitCurrentBlock];
+	}
+}
+
+/**
+ * Compress any remaining data, wait for all blocks to be written, and terminate the stream
+ * with the gzip trailer.  The file is not closed.
+ *
+ * @return NO if any data could not be compressed or written
+ */
+- (BOOL)finish
+{
+	if (finished) return !writeFailed;
+
+	if ([currentBlockData length]) [self _submitCurrentBlock];
+
+	[self _writeCompressedBlocksWaitingForAll:YES];
+
+	// Terminate the deflate stream, and add the trailer: the CRC and length modulo 2^32, little-endian
+	unsigned char trailer[8];
+
+	for (NSUInteger i = 0; i < 4; i++)
+	{
+		trailer[i] = (unsigned char)((combinedCRC >> (i * 8)) & 0xff);
+		trailer[i + 4] = (unsigned char)((uncompressedLength >> (i * 8)) & 0xff);
+	}
+
+	[self _writeBytes:SPParallelGzipFinalBlock length:sizeof(SPParallelGzipFinalBlock)];
+	[self _writeBytes:trailer length:sizeof(trailer)];
+
+	finished = YES;
+
+	return !writeFailed;
+}
+
+/**
+ * Returns whether any data compressed so far could not be compressed or written.
+ */
+- (BOOL)writeFailed
+{
+	return writeFailed;
+}
+
+/**
+ * Returns the amount of uncompressed data which has been compressed and written so far.
+ */
+- (unsigned long long)uncompressedLength
+{
+	return uncompressedLength;
+}
+
+/**
+ * Returns the amount of compressed data written to the file, including the gzip header and trailer.
+ */
+- (unsigned long long)compressedLength
+{
+	return compressedLength;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Hand the current block to the worker pool, primed with the previous block as its dictionary.
+ */
+- (void)_submitCurrentBlock
+{
+	SPParallelGzipBlock *block = [[SPParallelGzipBlock alloc] initWithData:currentBlockData dictionaryData:previousBlockData];
+	int level = compressionLevel;
+
+	[pendingBlocks addObject:block];
+
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		[block compressWithLevel:level];
+	});
+
+	[block release];
+
+	if (previousBlockData) SPClear(previousBlockData);
+	previousBlockData = currentBlockData;
+	currentBlockData = [[NSMutableData alloc] initWithCapacity:SPParallelGzipBlockLength];
+
+	[self _writeCompressedBlocksWaitingForAll:NO];
+}
+
+/**
+ * Write out compressed blocks in order.  Stops at the first block still being compressed
+ * unless all blocks are to be written, or the maximum number of blocks are in flight.
+ */
+- (void)_writeCompressedBlocksWaitingForAll:(BOOL)waitForAll
+{
+	while ([pendingBlocks count])
+	{
+		SPParallelGzipBlock *block = [pendingBlocks objectAtIndex:0];
+
+		if (![block waitUntilCompressed:(waitForAll || [pendingBlocks count] >= maximumPendingBlocks)]) break;
+
+		if ([block failed]) writeFailed = YES;
+
+		[self _writeBytes:[[block outputData] bytes] length:[[block outputData] length]];
+
+		combinedCRC = crc32_combine(combinedCRC, [block crc], (z_off_t)[[block inputData] length]);
+		uncompressedLength += [[block inputData] length];
+
+		[pendingBlocks removeObjectAtIndex:0];
+	}
+}
+
+- (void)_writeBytes:(const void *)bytes length:(NSUInteger)length
+{
+	if (!length) return;
+
+	size_t writtenLength = fwrite(bytes, 1, length, outputFile);
+
+	if (writtenLength < length) writeFailed = YES;
+
+	compressedLength += writtenLength;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	// Ensure no workers are still using the pending blocks' data
+	for (SPParallelGzipBlock *block in pendingBlocks)
+	{
+		[block waitUntilCompressed:YES];
+	}
+
+	SPClear(currentBlockData);
+	if (previousBlockData) SPClear(previousBlockData);
+	SPClear(pendingBlocks);
+
+	[super dealloc];
+}
+
+@end
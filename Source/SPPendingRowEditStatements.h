@@ -0,0 +1,69 @@
+//
+//  SPPendingRowEditStatements.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMySQLConnection;
+
+/**
+ * @class SPPendingRowEditStatements SPPendingRowEditStatements.h
+ *
+ * Builds and runs the statements which commit queued row edits within a transaction.  New rows
+ * with the same fields are combined into multi-row INSERTs, and rows identified by primary key
+ * with the same changed fields into grouped UPDATEs, each limited to a maximum statement length.
+ * Each statement is described by a dictionary containing the query, the rows it saves, the
+ * equivalent single-row queries used to locate errors, and whether it inserts rows.  UPDATEs
+ * are ordered before INSERTs, in the order the rows were added.
+ *
+ * The values added must already be escaped and quoted for use in a query.
+ */
+@interface SPPendingRowEditStatements : NSObject
+{
+	NSString *escapedTableName;
+	NSArray *keyFieldNames;
+	NSUInteger maxStatementLength;
+	NSStringEncoding stringEncoding;
+
+	NSMutableArray *insertFieldLists;
+	NSMutableDictionary *insertGroups;
+	NSMutableArray *updateFieldLists;
+	NSMutableDictionary *updateGroups;
+	NSMutableArray *singleUpdates;
+}
+
++ (BOOL)engineSupportsTransactions:(NSString *)engine;
+
+- (id)initWithTableName:(NSString *)tableName keyFieldNames:(NSArray *)keyNames maxStatementLength:(NSUInteger)maxLength stringEncoding:(NSStringEncoding)encoding;
+
+- (void)addInsertOfRow:(NSNumber *)rowKey fields:(NSArray *)fieldNames values:(NSArray *)values;
+- (void)addUpdateOfRow:(NSNumber *)rowKey fields:(NSArray *)fieldNames values:(NSArray *)values whereArgument:(NSString *)whereArgument usesPrimaryKey:(BOOL)usesPrimaryKey;
+
+- (NSArray *)statements;
+- (NSDictionary *)rowErrorsExecutingStatements:(NSArray *)statements onConnection:(SPMySQLConnection *)connection;
+
+@end
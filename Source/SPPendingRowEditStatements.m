@@ -0,0 +1,348 @@
+//
+//  SPPendingRowEditStatements.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPPendingRowEditStatements.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The savepoint set before each statement, so a failed statement can be undone before its rows are retried
+static NSString *SPPendingRowEditStatementSavepoint = @"sp_pending_row_statement";
+
+@interface SPPendingRowEditStatements ()
+
+- (NSString *)_groupedUpdateStatementForFields:(NSArray *)fieldNames edits:(NSArray *)rowEdits;
+- (BOOL)_undoFailedStatementOnConnection:(SPMySQLConnection *)connection;
+
+@end
+
+@implementation SPPendingRowEditStatements
+
+/**
+ * Returns whether changes to tables using the supplied storage engine can be rolled back.
+ */
++ (BOOL)engineSupportsTransactions:(NSString *)engine
+{
+	if (![engine isKindOfClass:[NSString class]]) return NO;
+
+	for (NSString *transactionalEngine in @[@"InnoDB", @"XtraDB", @"ndbcluster", @"NDB", @"TokuDB", @"RocksDB"]) {
+		if ([engine caseInsensitiveCompare:transactionalEngine] == NSOrderedSame) return YES;
+	}
+
+	return NO;
+}
+
+/**
+ * Initialise the statements for a table whose primary key is made up of the supplied fields.
+ */
+- (id)initWithTableName:(NSString *)tableName keyFieldNames:(NSArray *)keyNames maxStatementLength:(NSUInteger)maxLength stringEncoding:(NSStringEncoding)encoding
+{
+	if ((self = [super init])) {
+		escapedTableName = [[tableName backtickQuotedString] retain];
+		keyFieldNames = [(keyNames ? keyNames : @[]) copy];
+		maxStatementLength = maxLength;
+		stringEncoding = encoding;
+
+		insertFieldLists = [[NSMutableArray alloc] init];
+		insertGroups = [[NSMutableDictionary alloc] init];
+		updateFieldLists = [[NSMutableArray alloc] init];
+		updateGroups = [[NSMutableDictionary alloc] init];
+		singleUpdates = [[NSMutableArray alloc] init];
+	}
+
+	return self;
+}
+
+/**
+ * Adds a new row to insert.
+ */
+- (void)addInsertOfRow:(NSNumber *)rowKey fields:(NSArray *)fieldNames values:(NSArray *)values
+{
+	NSString *fieldList = [fieldNames componentsJoinedAndBacktickQuoted];
+
+	if (![insertGroups objectForKey:fieldList]) {
+		[insertFieldLists addObject:fieldList];
+		[insertGroups setObject:[NSMutableArray array] forKey:fieldList];
+	}
+
+	[[insertGroups objectForKey:fieldList] addObject:@{
+		@"row" : rowKey,
+		@"tuple" : [NSString stringWithFormat:@"(%@)", [values componentsJoinedByString:@", "]]
+	}];
+}
+
+/**
+ * Adds changed fields of an existing row, identified by the supplied WHERE argument.
+ */
+- (void)addUpdateOfRow:(NSNumber *)rowKey fields:(NSArray *)fieldNames values:(NSArray *)values whereArgument:(NSString *)whereArgument usesPrimaryKey:(BOOL)usesPrimaryKey
+{
+	NSMutableString *queryString = [NSMutableString stringWithFormat:@"UPDATE %@ SET ", escapedTableName];
+
+	for (NSUInteger i = 0; i < [fieldNames count]; i++) {
+		if (i) [queryString appendString:@", "];
+		[queryString appendFormat:@"%@ = %@", [NSArrayObjectAtIndex(fieldNames, i) backtickQuotedString], NSArrayObjectAtIndex(values, i)];
+	}
+	[queryString appendFormat:@" WHERE %@", whereArgument];
+	if (!usesPrimaryKey) [queryString appendString:@" LIMIT 1"];
+
+	NSDictionary *rowEdit = @{
+		@"row" : rowKey,
+		@"fields" : fieldNames,
+		@"values" : values,
+		@"where" : whereArgument,
+		@"query" : queryString
+	};
+
+	// Rows can only be grouped if they are identified by the primary key, and the key itself
+	// isn't changed - as later assignments in an UPDATE see the earlier assigned values.
+	if (!usesPrimaryKey || [fieldNames firstObjectCommonWithArray:keyFieldNames]) {
+		[singleUpdates addObject:rowEdit];
+		return;
+	}
+
+	NSString *fieldList = [fieldNames componentsJoinedAndBacktickQuoted];
+
+	if (![updateGroups objectForKey:fieldList]) {
+		[updateFieldLists addObject:fieldList];
+		[updateGroups setObject:[NSMutableArray array] forKey:fieldList];
+	}
+	[[updateGroups objectForKey:fieldList] addObject:rowEdit];
+}
+
+/**
+ * Returns the statements to commit the rows added so far.
+ */
+- (NSArray *)statements
+{
+	NSMutableArray *statements = [NSMutableArray array];
+
+	// UPDATEs which can't be grouped are run individually
+	for (NSDictionary *rowEdit in singleUpdates) {
+		[statements addObject:@{
+			@"query" : [rowEdit objectForKey:@"query"],
+			@"rows" : @[[rowEdit objectForKey:@"row"]],
+			@"rowQueries" : @[[rowEdit objectForKey:@"query"]],
+			@"insert" : @NO
+		}];
+	}
+
+	// Grouped UPDATEs, split into batches below the maximum statement length
+	for (NSString *fieldList in updateFieldLists) {
+		NSArray *groupEdits = [updateGroups objectForKey:fieldList];
+		NSArray *fieldNames = [[groupEdits objectAtIndex:0] objectForKey:@"fields"];
+		NSMutableArray *batch = [NSMutableArray array];
+		NSUInteger batchLength = 0;
+
+		for (NSDictionary *rowEdit in groupEdits) {
+
+			// Each row adds a WHEN clause per field, plus its WHERE condition
+			NSUInteger rowLength = [[rowEdit objectForKey:@"query"] lengthOfBytesUsingEncoding:stringEncoding] + [[rowEdit objectForKey:@"where"] lengthOfBytesUsingEncoding:stringEncoding] * [fieldNames count];
+
+			if ([batch count] && batchLength + rowLength > maxStatementLength) {
+				[statements addObject:@{
+					@"query" : [self _groupedUpdateStatementForFields:fieldNames edits:batch],
+					@"rows" : [batch valueForKey:@"row"],
+					@"rowQueries" : [batch valueForKey:@"query"],
+					@"insert" : @NO
+				}];
+				batch = [NSMutableArray array];
+				batchLength = 0;
+			}
+
+			[batch addObject:rowEdit];
+			batchLength += rowLength;
+		}
+
+		if ([batch count]) {
+			[statements addObject:@{
+				@"query" : ([batch count] == 1) ? [[batch objectAtIndex:0] objectForKey:@"query"] : [self _groupedUpdateStatementForFields:fieldNames edits:batch],
+				@"rows" : [batch valueForKey:@"row"],
+				@"rowQueries" : [batch valueForKey:@"query"],
+				@"insert" : @NO
+			}];
+		}
+	}
+
+	// Multi-row INSERTs, split into batches below the maximum statement length
+	for (NSString *fieldList in insertFieldLists) {
+		NSString *insertPrefix = [NSString stringWithFormat:@"INSERT INTO %@ (%@) VALUES ", escapedTableName, fieldList];
+		NSUInteger prefixLength = [insertPrefix lengthOfBytesUsingEncoding:stringEncoding];
+		NSMutableString *queryString = nil;
+		NSMutableArray *batchRows = nil;
+		NSMutableArray *batchRowQueries = nil;
+		NSUInteger queryLength = 0;
+
+		for (NSDictionary *rowInsert in [insertGroups objectForKey:fieldList]) {
+			NSString *tuple = [rowInsert objectForKey:@"tuple"];
+			NSUInteger tupleLength = [tuple lengthOfBytesUsingEncoding:stringEncoding];
+
+			if (queryString && queryLength + 2 + tupleLength > maxStatementLength) {
+				[statements addObject:@{ @"query" : queryString, @"rows" : batchRows, @"rowQueries" : batchRowQueries, @"insert" : @YES }];
+				queryString = nil;
+			}
+
+			if (!queryString) {
+				queryString = [NSMutableString stringWithString:insertPrefix];
+				batchRows = [NSMutableArray array];
+				batchRowQueries = [NSMutableArray array];
+				queryLength = prefixLength;
+			}
+			else {
+				[queryString appendString:@", "];
+				queryLength += 2;
+			}
+
+			[queryString appendString:tuple];
+			queryLength += tupleLength;
+
+			[batchRows addObject:[rowInsert objectForKey:@"row"]];
+			[batchRowQueries addObject:[insertPrefix stringByAppendingString:tuple]];
+		}
+
+		if (queryString) {
+			[statements addObject:@{ @"query" : queryString, @"rows" : batchRows, @"rowQueries" : batchRowQueries, @"insert" : @YES }];
+		}
+	}
+
+	return statements;
+}
+
+/**
+ * Runs the supplied statements within the transaction already started on the connection, and
+ * returns the errors of the rows which couldn't be saved, keyed by row.
+ *
+ * When a statement of several rows fails, it is first undone by rolling back to a savepoint set
+ * before it, and its rows are then retried individually to determine which rows caused the
+ * failure.  Errors such as deadlocks roll back the whole transaction, which removes the savepoint;
+ * the remaining statements are then skipped, so that no rows are saved outside the transaction.
+ */
+- (NSDictionary *)rowErrorsExecutingStatements:(NSArray *)statements onConnection:(SPMySQLConnection *)connection
+{
+	NSMutableDictionary *rowErrors = [NSMutableDictionary dictionary];
+	NSString *savepointQuery = [NSString stringWithFormat:@"SAVEPOINT %@", SPPendingRowEditStatementSavepoint];
+
+	for (NSDictionary *statement in statements) {
+		NSArray *statementRows = [statement objectForKey:@"rows"];
+		NSArray *rowQueries = [statement objectForKey:@"rowQueries"];
+
+		[connection queryString:savepointQuery];
+		if (![connection queryErrored]) [connection queryString:[statement objectForKey:@"query"]];
+
+		if (![connection queryErrored]) continue;
+
+		NSString *statementError = [connection lastErrorMessage];
+
+		if (![self _undoFailedStatementOnConnection:connection]) {
+			for (NSNumber *rowKey in statementRows) {
+				[rowErrors setObject:statementError forKey:rowKey];
+			}
+			break;
+		}
+
+		if ([statementRows count] == 1) {
+			[rowErrors setObject:statementError forKey:[statementRows objectAtIndex:0]];
+			continue;
+		}
+
+		// Map the failure back to the individual rows by running them separately
+		for (NSUInteger i = 0; i < [statementRows count]; i++) {
+			[connection queryString:[rowQueries objectAtIndex:i]];
+
+			if (![connection queryErrored]) continue;
+
+			[rowErrors setObject:[connection lastErrorMessage] forKey:[statementRows objectAtIndex:i]];
+
+			if (![self _undoFailedStatementOnConnection:connection]) return rowErrors;
+		}
+	}
+
+	return rowErrors;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Build a single UPDATE for several rows with the same changed fields, using a CASE
+ * expression per field to select each row's value by its primary key condition.
+ */
+- (NSString *)_groupedUpdateStatementForFields:(NSArray *)fieldNames edits:(NSArray *)rowEdits
+{
+	NSMutableString *queryString = [NSMutableString stringWithFormat:@"UPDATE %@ SET ", escapedTableName];
+
+	for (NSUInteger i = 0; i < [fieldNames count]; i++) {
+		NSString *escapedFieldName = [NSArrayObjectAtIndex(fieldNames, i) backtickQuotedString];
+
+		if (i) [queryString appendString:@", "];
+		[queryString appendFormat:@"%@ = CASE", escapedFieldName];
+
+		for (NSDictionary *rowEdit in rowEdits) {
+			[queryString appendFormat:@" WHEN (%@) THEN %@", [rowEdit objectForKey:@"where"], NSArrayObjectAtIndex([rowEdit objectForKey:@"values"], i)];
+		}
+
+		[queryString appendFormat:@" ELSE %@ END", escapedFieldName];
+	}
+
+	[queryString appendString:@" WHERE "];
+
+	for (NSUInteger i = 0; i < [rowEdits count]; i++) {
+		if (i) [queryString appendString:@" OR "];
+		[queryString appendFormat:@"(%@)", [NSArrayObjectAtIndex(rowEdits, i) objectForKey:@"where"]];
+	}
+
+	return queryString;
+}
+
+/**
+ * Rolls back to the savepoint set before the current statement, undoing any of its changes.
+ * Returns NO if the transaction has already been rolled back by the server.
+ */
+- (BOOL)_undoFailedStatementOnConnection:(SPMySQLConnection *)connection
+{
+	[connection queryString:[NSString stringWithFormat:@"ROLLBACK TO SAVEPOINT %@", SPPendingRowEditStatementSavepoint]];
+
+	return ![connection queryErrored];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(escapedTableName);
+	SPClear(keyFieldNames);
+	SPClear(insertFieldLists);
+	SPClear(insertGroups);
+	SPClear(updateFieldLists);
+	SPClear(updateGroups);
+	SPClear(singleUpdates);
+
+	[super dealloc];
+}
+
+@end
@@ -0,0 +1,81 @@
+//
+//  SPSQLExportRowSerializer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * How the cells of a column are written by an SPSQLExportRowSerializer.
+ */
+typedef enum {
+	SPSQLExportCellAsString    = 0, // Escaped and quoted text
+	SPSQLExportCellAsNumber    = 1, // Trusted numbers, written unquoted
+	SPSQLExportCellAsBit       = 2, // BIT values, written as b'0101'
+	SPSQLExportCellAsHexString = 3, // Binary strings already hex-encoded by the server, written as X'...'
+	SPSQLExportCellAsBlob      = 4, // Binary data, hex-encoded or written as text in the blob encoding
+	SPSQLExportCellAsGeometry  = 5  // Geometry data, always hex-encoded
+} SPSQLExportCellFormat;
+
+/**
+ * @class SPSQLExportRowSerializer SPSQLExportRowSerializer.h
+ *
+ * Serializes the rows of an SQL export's INSERT statements into a byte buffer of UTF-8 output.
+ * Raw rows retrieved from a streaming result are escaped, hex-encoded or copied directly from the
+ * MySQL row data without creating any objects; rows supplied as arrays of objects are converted to
+ * bytes first and then written in the same way.
+ */
+@interface SPSQLExportRowSerializer : NSObject
+{
+	NSUInteger columnCount;
+	SPSQLExportCellFormat *cellFormats;
+	NSUInteger *bitLengths;
+
+	NSStringEncoding stringEncoding;
+	NSStringEncoding blobStringEncoding;
+	BOOL encodeBlobsAsHex;
+
+	char *buffer;
+	NSUInteger bufferLength;
+	NSUInteger bufferCapacity;
+}
+
+- (id)initWithColumnCount:(NSUInteger)count stringEncoding:(NSStringEncoding)encoding encodeBlobsAsHex:(BOOL)blobsAsHex blobStringEncoding:(NSStringEncoding)blobEncoding;
+
+- (void)setFormat:(SPSQLExportCellFormat)format bitLength:(NSUInteger)bitLength forColumn:(NSUInteger)column;
+- (SPSQLExportCellFormat)formatForColumn:(NSUInteger)column;
+
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths;
+- (void)appendRow:(NSArray *)row;
+
+- (void)appendBytes:(const char *)bytes length:(NSUInteger)length;
+- (void)appendString:(NSString *)string;
+
+- (NSUInteger)length;
+- (void)writeToOutput:(id)output;
+- (void)reset;
+
+@end
@@ -0,0 +1,425 @@
+//
+//  SPSQLExportRowSerializer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLExportRowSerializer.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The initial size of the output buffer, which grows as required
+static const NSUInteger SPSQLExportRowSerializerInitialCapacity = 65536;
+
+// Characters which are escaped with a backslash within quoted strings, mapped to the character
+// written after the backslash - matching mysql_real_escape_string
+static char SPSQLExportEscapedCharacters[256];
+
+static const char SPSQLExportHexDigits[] = "0123456789ABCDEF";
+
+@interface SPSQLExportRowSerializer ()
+
+- (void)_ensureCapacity:(NSUInteger)additionalLength;
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length;
+- (void)_appendHexBytes:(const char *)bytes length:(NSUInteger)length;
+- (void)_appendBitBytes:(const char *)bytes length:(NSUInteger)length padLength:(NSUInteger)padLength;
+- (void)_appendBlobBytes:(const char *)bytes length:(NSUInteger)length;
+
+@end
+
+@implementation SPSQLExportRowSerializer
+
++ (void)initialize
+{
+	if (self != [SPSQLExportRowSerializer class]) return;
+
+	SPSQLExportEscapedCharacters[(unsigned char)'\0'] = '0';
+	SPSQLExportEscapedCharacters[(unsigned char)'\n'] = 'n';
+	SPSQLExportEscapedCharacters[(unsigned char)'\r'] = 'r';
+	SPSQLExportEscapedCharacters[(unsigned char)'\\'] = '\\';
+	SPSQLExportEscapedCharacters[(unsigned char)'\''] = '\'';
+	SPSQLExportEscapedCharacters[(unsigned char)'"'] = '"';
+	SPSQLExportEscapedCharacters[(unsigned char)'\032'] = 'Z';
+}
+
+/**
+ * Initialise a serializer for rows of the supplied number of columns, with all columns written as strings.
+ *
+ * @param count        The number of columns in each row
+ * @param encoding     The encoding of string data in raw rows
+ * @param blobsAsHex   Whether binary data should be hex-encoded
+ * @param blobEncoding The encoding used to write binary data as text when not hex-encoded
+ */
+- (id)initWithColumnCount:(NSUInteger)count stringEncoding:(NSStringEncoding)encoding encodeBlobsAsHex:(BOOL)blobsAsHex blobStringEncoding:(NSStringEncoding)blobEncoding
+{
+	if ((self = [super init])) {
+		columnCount = count;
+		cellFormats = calloc(MAX(count, 1), sizeof(SPSQLExportCellFormat));
+		bitLengths = calloc(MAX(count, 1), sizeof(NSUInteger));
+
+		stringEncoding = encoding;
+		blobStringEncoding = blobEncoding;
+		encodeBlobsAsHex = blobsAsHex;
+
+		bufferCapacity = SPSQLExportRowSerializerInitialCapacity;
+		bufferLength = 0;
+		buffer = malloc(bufferCapacity);
+	}
+
+	return self;
+}
+
+/**
+ * Set how the cells of the specified column are written.  The bit length is the width BIT
+ * values in raw rows are padded to, and is otherwise ignored.
+ */
+- (void)setFormat:(SPSQLExportCellFormat)format bitLength:(NSUInteger)bitLength forColumn:(NSUInteger)column
+{
+	if (column >= columnCount) return;
+
+	cellFormats[column] = format;
+	bitLengths[column] = bitLength;
+}
+
+- (SPSQLExportCellFormat)formatForColumn:(NSUInteger)column
+{
+	return (column < columnCount) ? cellFormats[column] : SPSQLExportCellAsString;
+}
+
+#pragma mark -
+#pragma mark Row serialization
+
+/**
+ * Append the cells of a raw row, as returned by -[SPMySQLStreamingResult getRawRowCells:lengths:],
+ * separated by commas.
+ */
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths
+{
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		if (i) [self appendBytes:"," length:1];
+
+		const char *cell = cells[i];
+		NSUInteger length = lengths[i];
+
+		if (cell == NULL) {
+			[self appendBytes:"NULL" length:4];
+			continue;
+		}
+
+		switch (cellFormats[i])
+		{
+			case SPSQLExportCellAsNumber:
+				[self appendBytes:cell length:length];
+				break;
+
+			case SPSQLExportCellAsBit:
+				[self _appendBitBytes:cell length:length padLength:bitLengths[i]];
+				break;
+
+			case SPSQLExportCellAsHexString:
+				[self appendBytes:"X'" length:2];
+				[self appendBytes:cell length:length];
+				[self appendBytes:"'" length:1];
+				break;
+
+			case SPSQLExportCellAsGeometry:
+				[self _appendHexBytes:cell length:length];
+				break;
+
+			case SPSQLExportCellAsBlob:
+				if (!length) [self appendBytes:"''" length:2];
+				else [self _appendBlobBytes:cell length:length];
+				break;
+
+			case SPSQLExportCellAsString:
+				if (!length) {
+					[self appendBytes:"''" length:2];
+				}
+
+				// UTF-8 data can be escaped bytewise; other encodings are converted first
+				else if (stringEncoding == NSUTF8StringEncoding) {
+					[self _appendEscapedBytes:cell length:length];
+				}
+				else {
+					NSString *string = [[NSString alloc] initWithBytes:cell length:length encoding:stringEncoding];
+					NSData *stringData = [string dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+
+					[self _appendEscapedBytes:[stringData bytes] length:[stringData length]];
+
+					[string release];
+				}
+				break;
+		}
+	}
+}
+
+/**
+ * Append the cells of a row supplied as an array of objects, separated by commas.  Binary and
+ * geometry data is detected from the objects' classes rather than the column formats.
+ */
+- (void)appendRow:(NSArray *)row
+{
+	NSNull *null = [NSNull null];
+	NSUInteger count = MIN([row count], columnCount);
+
+	for (NSUInteger i = 0; i < count; i++)
+	{
+		if (i) [self appendBytes:"," length:1];
+
+		id object = [row objectAtIndex:i];
+
+		if (object == null) {
+			[self appendBytes:"NULL" length:4];
+			continue;
+		}
+
+		switch (cellFormats[i])
+		{
+			case SPSQLExportCellAsNumber:
+				[self appendString:object];
+				break;
+
+			// Bit values are already converted to strings of bits
+			case SPSQLExportCellAsBit:
+				[self appendBytes:"b'" length:2];
+				[self appendString:[object description]];
+				[self appendBytes:"'" length:1];
+				break;
+
+			case SPSQLExportCellAsHexString:
+				[self appendBytes:"X'" length:2];
+				[self appendString:object];
+				[self appendBytes:"'" length:1];
+				break;
+
+			default:
+				if ([object isKindOfClass:[SPMySQLGeometryData class]]) {
+					NSData *geometryData = [object data];
+
+					[self _appendHexBytes:[geometryData bytes] length:[geometryData length]];
+				}
+				else if ([object length] == 0) {
+					[self appendBytes:"''" length:2];
+				}
+				else if ([object isKindOfClass:[NSData class]]) {
+					[self _appendBlobBytes:[object bytes] length:[object length]];
+				}
+				else {
+					NSData *stringData = [object dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+
+					[self _appendEscapedBytes:[stringData bytes] length:[stringData length]];
+				}
+				break;
+		}
+	}
+}
+
+#pragma mark -
+#pragma mark Buffer handling
+
+- (void)appendBytes:(const char *)bytes length:(NSUInteger)length
+{
+	[self _ensureCapacity:length];
+
+	memcpy(buffer + bufferLength, bytes, length);
+	bufferLength += length;
+}
+
+/**
+ * Append a string as UTF-8.
+ */
+- (void)appendString:(NSString *)string
+{
+	NSData *stringData = [string dataUsingEncoding:NSUTF8StringEncoding];
+
+	[self appendBytes:[stringData bytes] length:[stringData length]];
+}
+
+- (NSUInteger)length
+{
+	return bufferLength;
+}
+
+/**
+ * Write the buffered output to the supplied export file or file handle, and empty the buffer.
+ */
+- (void)writeToOutput:(id)output
+{
+	if (!bufferLength) return;
+
+	[output writeData:[NSData dataWithBytesNoCopy:buffer length:bufferLength freeWhenDone:NO]];
+
+	bufferLength = 0;
+}
+
+/**
+ * Discard any buffered output.
+ */
+- (void)reset
+{
+	bufferLength = 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (void)_ensureCapacity:(NSUInteger)additionalLength
+{
+	if (bufferLength + additionalLength <= bufferCapacity) return;
+
+	while (bufferLength + additionalLength > bufferCapacity) bufferCapacity *= 2;
+
+	buffer = realloc(buffer, bufferCapacity);
+}
+
+/**
+ * Append bytes as a quoted string, backslash-escaping special characters.  Runs of bytes
+ * not requiring escapes are copied in one go.
+ */
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length
+{
+	[self _ensureCapacity:(length * 2) + 2];
+
+	char *output = buffer + bufferLength;
+	NSUInteger runStart = 0;
+
+	*output++ = '\'';
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		char escapedCharacter = SPSQLExportEscapedCharacters[(unsigned char)bytes[i]];
+
+		if (!escapedCharacter) continue;
+
+		memcpy(output, bytes + runStart, i - runStart);
+		output += i - runStart;
+
+		*output++ = '\\';
+		*output++ = escapedCharacter;
+
+		runStart = i + 1;
+	}
+
+	memcpy(output, bytes + runStart, length - runStart);
+	output += length - runStart;
+
+	*output++ = '\'';
+
+	bufferLength = output - buffer;
+}
+
+/**
+ * Append bytes hex-encoded as X'...', matching -[SPMySQLConnection escapeAndQuoteData:].
+ */
+- (void)_appendHexBytes:(const char *)bytes length:(NSUInteger)length
+{
+	[self _ensureCapacity:(length * 2) + 3];
+
+	char *output = buffer + bufferLength;
+
+	*output++ = 'X';
+	*output++ = '\'';
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		unsigned char byte = (unsigned char)bytes[i];
+
+		*output++ = SPSQLExportHexDigits[byte >> 4];
+		*output++ = SPSQLExportHexDigits[byte & 0x0F];
+	}
+
+	*output++ = '\'';
+
+	bufferLength = output - buffer;
+}
+
+/**
+ * Append BIT data as b'...', zero-padded to the field's bit length in the same way
+ * SPMySQL converts BIT values to strings.
+ */
+- (void)_appendBitBytes:(const char *)bytes length:(NSUInteger)length padLength:(NSUInteger)padLength
+{
+	NSUInteger bitLength = MIN(length << 3, padLength);
+
+	[self _ensureCapacity:padLength + 3];
+
+	char *output = buffer + bufferLength;
+
+	*output++ = 'b';
+	*output++ = '\'';
+
+	memset(output, '0', padLength);
+
+	// Fill in from the least significant bit, the rightmost bit of the last byte
+	for (NSUInteger i = 0; i < bitLength; i++)
+	{
+		if (bytes[(length - 1) - (i >> 3)] & (1 << (i % 8))) output[padLength - 1 - i] = '1';
+	}
+
+	output += padLength;
+	*output++ = '\'';
+
+	bufferLength = output - buffer;
+}
+
+/**
+ * Append binary data, either hex-encoded or converted to text using the blob encoding.
+ */
+- (void)_appendBlobBytes:(const char *)bytes length:(NSUInteger)length
+{
+	if (encodeBlobsAsHex) {
+		[self _appendHexBytes:bytes length:length];
+		return;
+	}
+
+	NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:blobStringEncoding];
+
+	if (!string) {
+#warning This can corrupt data! Check if this case ever happens and if so, export as hex-string
+		string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSASCIIStringEncoding];
+	}
+
+	[self appendBytes:"'" length:1];
+	if (string) [self appendString:string];
+	[self appendBytes:"'" length:1];
+
+	[string release];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	free(cellFormats);
+	free(bitLengths);
+	free(buffer);
+
+	[super dealloc];
+}
+
+@end
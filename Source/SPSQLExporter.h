@@ -32,6 +32,7 @@
 #import "SPSQLExporterProtocol.h"
 
 @class SPTableData;
+@class SPExportCheckpoint;
 
 /**
  * @class SPSQLExporter SPSQLExporter.m
@@ -63,6 +64,11 @@
 	NSUInteger sqlInsertAfterNValue;
 
 	SPTableData *sqlTableDataInstance;
+
+	SPExportCheckpoint *sqlExportCheckpoint;
+	BOOL sqlExportResumesFromCheckpoint;
+
+	NSString *sqlExportPartHeader;
 }
 
 /**
@@ -135,8 +141,21 @@
  */
 @property(readwrite, assign) SPSQLExportInsertDivider sqlInsertDivider;
 
+/**
+ * @property sqlExportCheckpoint The checkpoint recording the export's progress, or nil to not record it
+ */
+@property(readwrite, retain) SPExportCheckpoint *sqlExportCheckpoint;
+
+/**
+ * @property sqlExportResumesFromCheckpoint Whether to resume the export from its checkpoint, after
+ *                                          reopening the export file at the checkpoint's offset
+ */
+@property(readwrite, assign) BOOL sqlExportResumesFromCheckpoint;
+
 - (id)initWithDelegate:(NSObject<SPSQLExporterProtocol> *)exportDelegate;
 
+- (BOOL)canResumeFromCheckpoint;
+
 - (BOOL)didExportErrorsOccur;
 
 @end
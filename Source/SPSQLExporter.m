@@ -34,14 +34,37 @@
 #import "SPExportUtilities.h"
 #import "SPExportFile.h"
 #import "SPTableData.h"
+#import "SPExportConnectionPool.h"
+#import "SPExportChunkedTableReader.h"
+#import "SPSQLExportRowSerializer.h"
+#import "SPExportCheckpoint.h"
 #import "RegexKitLite.h"
 
 #import <SPMySQL/SPMySQL.h>
 #include <stdlib.h>
 
+// The size of the reads used to append concurrently dumped tables to the export file
+static const NSUInteger SPSQLExporterTableMergeChunkSize = 1024 * 1024;
+
+// The amount of serialized row data buffered before it is written to the export file
+static const NSUInteger SPSQLExporterOutputFlushLength = 64 * 1024;
+
+// The minimum time between checkpoints of a table dump read in key ranges
+static const NSTimeInterval SPSQLExporterKeyRangeCheckpointInterval = 10.0;
+
 @interface SPSQLExporter ()
 
-- (NSString *)_createViewPlaceholderSyntaxForView:(NSString *)viewName;
+- (BOOL)_exportTable:(NSArray *)table toOutput:(id)output usingConnection:(SPMySQLConnection *)tableConnection connectionPool:(SPExportConnectionPool *)connectionPool tableData:(SPTableData *)tableData viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors reportingProgress:(BOOL)reportsProgress continuingPartialDump:(NSDictionary *)partialDump;
+- (BOOL)_exportTables:(NSArray *)tables usingConnectionPool:(SPExportConnectionPool *)connectionPool viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors;
+- (NSDictionary *)_checkpointSettings;
+- (void)_checkpointCompletedTable:(NSString *)tableName viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors;
+- (NSDictionary *)_resumablePartialDumpForTable:(NSString *)tableName tableData:(SPTableData *)tableData;
+- (void)_appendErrorMessage:(NSString *)errorMessage toErrors:(NSMutableString *)errors;
+- (NSString *)_exportFileFooter;
+- (void)_splitExportFileForTable:(NSString *)tableName startingTable:(BOOL)startingTable;
+- (void)_writeString:(NSString *)input toOutput:(id)output;
+- (void)_writeUTF8String:(NSString *)input toOutput:(id)output;
+- (NSString *)_createViewPlaceholderSyntaxForView:(NSString *)viewName tableData:(SPTableData *)tableData connection:(SPMySQLConnection *)viewConnection;
 
 @end
 
@@ -61,6 +84,8 @@
 @synthesize sqlCurrentTableExportIndex;
 @synthesize sqlInsertAfterNValue;
 @synthesize sqlInsertDivider;
+@synthesize sqlExportCheckpoint;
+@synthesize sqlExportResumesFromCheckpoint;
 
 /**
  * Initialise an instance of SPSQLExporter using the supplied delegate.
@@ -87,9 +112,9 @@
 - (void)exportOperation
 {
 	// used in end_cleanup
-	NSMutableString *errors     = [[NSMutableString alloc] init];
-	NSMutableString *sqlString  = [[NSMutableString alloc] init];
-	NSString *oldSqlMode        = nil;
+	NSMutableString *errors = [[NSMutableString alloc] init];
+	NSString *oldSqlMode    = nil;
+	BOOL resumingExport     = (sqlExportCheckpoint && [self sqlExportResumesFromCheckpoint]);
 
 	// Check that we have all the required info before starting the export
 	if ((![self sqlExportTables])     || ([[self sqlExportTables] count] == 0)          ||
@@ -139,6 +164,15 @@
 		[targetArray addObject:item];
 	}
 
+	// Start recording the export's progress, unless it is being resumed from an earlier checkpoint
+	if (sqlExportCheckpoint && !resumingExport) {
+		NSMutableArray *tableNames = [NSMutableArray arrayWithCapacity:[tables count]];
+
+		for (NSArray *table in tables) [tableNames addObject:NSArrayObjectAtIndex(table, 0)];
+
+		if (![sqlExportCheckpoint beginWithSettings:[self _checkpointSettings] tableNames:tableNames]) [self setSqlExportCheckpoint:nil];
+	}
+
 	NSMutableString *metaString = [NSMutableString string];
 
 	// If required write the UTF-8 Byte Order Mark (BOM)
@@ -249,391 +283,84 @@
 
 	[metaString appendString:@"/*!40111 SET @OLD_SQL_NOTES=@@SQL_NOTES, SQL_NOTES=0 */;\n\n\n"];
 
-	[self writeString:metaString];
-
 	NSMutableDictionary *viewSyntaxes = [NSMutableDictionary dictionary];
 
-	// Loop through the selected tables
-	for (NSArray *table in tables) 
-	{
-		// Check for cancellation flag
-		if ([self isCancelled]) goto end_cleanup;
-		
-		[self setSqlCurrentTableExportIndex:[self sqlCurrentTableExportIndex]+1];
-		NSString *tableName = NSArrayObjectAtIndex(table, 0);
-
-		BOOL sqlOutputIncludeStructure  = [NSArrayObjectAtIndex(table, 1) boolValue];
-		BOOL sqlOutputIncludeContent    = [NSArrayObjectAtIndex(table, 2) boolValue];
-		BOOL sqlOutputIncludeDropSyntax = [NSArrayObjectAtIndex(table, 3) boolValue];
-
-		// Skip tables if not set to output any detail for them
-		if (!sqlOutputIncludeStructure && !sqlOutputIncludeContent && !sqlOutputIncludeDropSyntax) {
-			continue;
-		}
-
-		// Set the current table
-		[self setSqlExportCurrentTable:tableName];
-		
-		// Inform the delegate that we are about to start fetcihing data for the current table
-		[delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginFetchingData:) withObject:self waitUntilDone:NO];
-		
-		NSUInteger lastProgressValue = 0;
-		
-		// Add the name of table
-		[self writeString:[NSString stringWithFormat:@"# %@ %@\n# ------------------------------------------------------------\n\n", NSLocalizedString(@"Dump of table", @"sql export dump of table label"), tableName]];
+	// When resuming, the export file already holds the header and the tables completed by the checkpoint;
+	// skip those tables, restoring the views and errors collected while dumping them
+	if (resumingExport) {
+		NSArray *completedTables = [sqlExportCheckpoint completedTables];
 
-		id createTableSyntax = nil;
-		SPTableType tableType = SPTableTypeTable;
-		// Determine whether this table is a table or a view via the CREATE TABLE command, and keep the create table syntax
-		{
-			SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"SHOW CREATE TABLE %@", [tableName backtickQuotedString]]];
+		[tables removeObjectsAtIndexes:[tables indexesOfObjectsPassingTest:^BOOL(NSArray *table, NSUInteger idx, BOOL *stop) {
+			return [completedTables containsObject:NSArrayObjectAtIndex(table, 0)];
+		}]];
 
-			[queryResult setReturnDataAsStrings:YES];
+		[self setSqlCurrentTableExportIndex:[completedTables count]];
 
-			if ([queryResult numberOfRows]) {
-				NSDictionary *tableDetails = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
+		[viewSyntaxes addEntriesFromDictionary:[sqlExportCheckpoint viewSyntaxes]];
+		[errors appendString:[sqlExportCheckpoint errors]];
+	}
+	else {
+		[self writeString:metaString];
 
-				if ([tableDetails objectForKey:@"Create View"]) {
-					[viewSyntaxes setValue:[[[[tableDetails objectForKey:@"Create View"] copy] autorelease] createViewSyntaxPrettifier] forKey:tableName];
-					createTableSyntax = [self _createViewPlaceholderSyntaxForView:tableName];
-					tableType = SPTableTypeView;
-				}
-				else {
-					createTableSyntax = [[[tableDetails objectForKey:@"Create Table"] copy] autorelease];
-					tableType = SPTableTypeTable;
-				}
+		// Start each part of a split export file with the same header, so the parts can be imported on their own
+		if ([[self exportOutputFile] isSplit]) sqlExportPartHeader = [metaString copy];
 
-				[tableDetails release];
-			}
+		if (sqlExportCheckpoint) [sqlExportCheckpoint recordExportFileOffset:[[self exportOutputFile] checkpoint]];
+	}
 
-			if ([connection queryErrored]) {
-				[errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+	// If set to, open several connections sharing a consistent snapshot to dump the tables concurrently,
+	// splitting large tables into key ranges read on any idle connections
+	SPExportConnectionPool *connectionPool = nil;
 
-				[self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [connection lastErrorMessage]]];
+	if ([self exportParallelConnections] > 1) {
+		connectionPool = [[[SPExportConnectionPool alloc] initWithConnection:connection] autorelease];
 
-				continue;
-			}
-		}
-		
-		// Add a 'DROP TABLE' command if required
-		if (sqlOutputIncludeDropSyntax) {
-			[self writeString:[NSString stringWithFormat:@"DROP %@ IF EXISTS %@;\n\n", ((tableType == SPTableTypeTable) ? @"TABLE" : @"VIEW"), [tableName backtickQuotedString]]];
-		}
-		
-		// Add the create syntax for the table if specified in the export dialog
-		if (sqlOutputIncludeStructure && createTableSyntax) {
+		if (![connectionPool openConnections:[self exportParallelConnections]]) connectionPool = nil;
+	}
 
-			if ([createTableSyntax isKindOfClass:[NSData class]]) {
-#warning This doesn't make sense. If the NSData really contains a string it would be in utf8, utf8mb4 or a mysql pre-4.1 legacy charset, but not in the export output charset. This whole if() is likely a side effect of the BINARY flag confusion (#2700)
-				createTableSyntax = [[[NSString alloc] initWithData:createTableSyntax encoding:[self exportOutputEncoding]] autorelease];
-			}
-			
-			// If necessary strip out the AUTO_INCREMENT from the table structure definition
-			if (![self sqlOutputIncludeAutoIncrement]) {
-				createTableSyntax = [createTableSyntax stringByReplacingOccurrencesOfRegex:[NSString stringWithFormat:@"AUTO_INCREMENT=[0-9]+ "] withString:@""];
-			}
+	if (connectionPool) {
+		// Without the RELOAD privilege the snapshots couldn't be started under FLUSH TABLES WITH READ LOCK;
+		// note this in the file, and report it with the export errors so the user sees it too
+		if (![connectionPool usesSharedSnapshot]) {
+			[self writeUTF8String:@"# Tables were dumped concurrently without a global read lock; their snapshots may differ slightly.\n\n\n"];
 
-			[self writeUTF8String:createTableSyntax];
-			[self writeUTF8String:@";\n\n"];
+			[errors appendFormat:@"%@\n", NSLocalizedString(@"The global read lock needed to dump all tables from a single point in time couldn't be taken, as it requires the RELOAD privilege. The tables were dumped concurrently from separate snapshots, which may differ slightly if the tables were being changed.", @"sql export : parallel export without global read lock warning")];
 		}
 
-		// Add the table content if required
-		if (sqlOutputIncludeContent && (tableType == SPTableTypeTable)) {
-			// Retrieve the table details via the data class, and use it to build an array containing column numeric status
-			NSDictionary *tableDetails = [NSDictionary dictionaryWithDictionary:[sqlTableDataInstance informationForTable:tableName]];
-
-			NSUInteger colCount = [[tableDetails objectForKey:@"columns"] count];
-			NSMutableArray *rawColumnNames = [NSMutableArray arrayWithCapacity:colCount];
-			NSMutableArray *queryColumnDetails = [NSMutableArray arrayWithCapacity:colCount];
-			
-			BOOL *useRawDataForColumnAtIndex = calloc(colCount, sizeof(BOOL));
-			BOOL *useRawHexDataForColumnAtIndex = calloc(colCount, sizeof(BOOL));
-
-			// Determine whether raw data can be used for each column during processing - safe numbers and hex-encoded data.
-			for (NSUInteger j = 0; j < colCount; j++)
-			{
-				NSDictionary *theColumnDetail = NSArrayObjectAtIndex([tableDetails objectForKey:@"columns"], j);
-				NSString *theTypeGrouping = [theColumnDetail objectForKey:@"typegrouping"];
-
-				// Start by setting the column as non-safe
-				useRawDataForColumnAtIndex[j] = NO;
-				useRawHexDataForColumnAtIndex[j] = NO;
-
-				// Determine whether the column should be retrieved as hex data from the server - for binary strings, to
-				// avoid encoding issues when processing
-				if ([self sqlOutputEncodeBLOBasHex]
-					&& [theTypeGrouping isEqualToString:@"string"]
-					&& ([[theColumnDetail objectForKey:@"binary"] boolValue] || [[theColumnDetail objectForKey:@"collation"] hasSuffix:@"_bin"]))
-				{
-					useRawHexDataForColumnAtIndex[j] = YES;
-				}
-
-				// Floats, integers can be output directly assuming they're non-binary
-				if (![[theColumnDetail objectForKey:@"binary"] boolValue] && ([@[@"integer",@"float"] containsObject:theTypeGrouping]))
-				{
-					useRawDataForColumnAtIndex[j] = YES;
-				}
-
-				// Set up the column query string parts
-				[rawColumnNames addObject:[theColumnDetail objectForKey:@"name"]];
-				
-				if (useRawHexDataForColumnAtIndex[j]) {
-					[queryColumnDetails addObject:[NSString stringWithFormat:@"HEX(%@)", [[theColumnDetail objectForKey:@"name"] mySQLBacktickQuotedString]]];
-				} 
-				else {
-					[queryColumnDetails addObject:[[theColumnDetail objectForKey:@"name"] mySQLBacktickQuotedString]];
-				}
-			}
-
-			// Retrieve the number of rows in the table for progress bar drawing
-			NSArray *rowArray = [[connection queryString:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [tableName backtickQuotedString]]] getRowAsArray];
-			
-			if ([connection queryErrored] || ![rowArray count]) {
-				[errors appendFormat:@"%@\n", [connection lastErrorMessage]];
-				[self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [connection lastErrorMessage]]];
-				free(useRawDataForColumnAtIndex);
-				free(useRawHexDataForColumnAtIndex);
-				continue;
-			}
-			
-			NSUInteger rowCount = [NSArrayObjectAtIndex(rowArray, 0) integerValue];
-
-			if (rowCount) {
-				// Set up a result set in streaming mode
-				SPMySQLStreamingResult *streamingResult = [[connection streamingQueryString:[NSString stringWithFormat:@"SELECT %@ FROM %@", [queryColumnDetails componentsJoinedByString:@", "], [tableName backtickQuotedString]] useLowMemoryBlockingStreaming:([self exportUsingLowMemoryBlockingStreaming])] retain];
-
-				// Inform the delegate that we are about to start writing data for the current table
-				[delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
-
-				NSUInteger queryLength = 0;
-				
-				// Lock the table for writing and disable keys if supported
-				[metaString setString:@""];
-				[metaString appendFormat:@"LOCK TABLES %@ WRITE;\n/*!40000 ALTER TABLE %@ DISABLE KEYS */;\n\n", [tableName backtickQuotedString], [tableName backtickQuotedString]];
-				
-				[self writeString:metaString];
-				
-				// Construct the start of the insertion command
-				[self writeUTF8String:[NSString stringWithFormat:@"INSERT INTO %@ (%@)\nVALUES", [tableName backtickQuotedString], [rawColumnNames componentsJoinedAndBacktickQuoted]]];
-				
-				// Iterate through the rows to construct a VALUES group for each
-				NSUInteger rowsWrittenForTable = 0;
-				NSUInteger rowsWrittenForCurrentStmt = 0;
-				BOOL cleanAutoReleasePool = NO;
-				
-				NSAutoreleasePool *sqlExportPool = [[NSAutoreleasePool alloc] init];
-				
-				// Inform the delegate that we are about to start writing the data to disk
-				[delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
-				
-				NSArray *row;
-				while ((row = [streamingResult getRowAsArray]))
-				{
-					// Check for cancellation flag
-					if ([self isCancelled]) {
-						[connection cancelCurrentQuery];
-						[streamingResult cancelResultLoad];
-						[streamingResult release];
-						[sqlExportPool release];
-						free(useRawDataForColumnAtIndex);
-						free(useRawHexDataForColumnAtIndex);
-
-						goto end_cleanup;
-					}
-
-					// Update the progress
-					NSUInteger progress = (NSUInteger)((rowsWrittenForTable + 1) * ([self exportMaxProgress] / rowCount));
-
-					if (progress > lastProgressValue) {
-						[self setExportProgressValue:progress];
-						lastProgressValue = progress;
-
-						// Inform the delegate that the export's progress has been updated
-						[delegate performSelectorOnMainThread:@selector(sqlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
-					}
-
-					// Set up the new row as appropriate.  If a new INSERT statement should be created,
-					// set one up; otherwise, set up a new row
-					if ((([self sqlInsertDivider] == SPSQLInsertEveryNDataBytes) && (queryLength >= ([self sqlInsertAfterNValue] * 1024))) ||
-						(([self sqlInsertDivider] == SPSQLInsertEveryNRows) && (rowsWrittenForCurrentStmt == [self sqlInsertAfterNValue])))
-					{
-						[sqlString setString:@";\n\nINSERT INTO "];
-						[sqlString appendString:[tableName backtickQuotedString]];
-						[sqlString appendString:@" ("];
-						[sqlString appendString:[rawColumnNames componentsJoinedAndBacktickQuoted]];
-						[sqlString appendString:@")\nVALUES\n\t("];
-
-						queryLength = 0, rowsWrittenForCurrentStmt = 0;
-
-						// Use the opportunity to drain and reset the autorelease pool at the end of this row
-						cleanAutoReleasePool = YES;
-					}
-					else if (rowsWrittenForTable == 0) {
-						[sqlString setString:@"\n\t("];
-					}
-					else {
-						[sqlString setString:@",\n\t("];
-					}
-
-					for (NSUInteger t = 0; t < colCount; t++)
-					{
-						id object = NSArrayObjectAtIndex(row, t);
-
-						// Add NULL values directly to the output row; use a pointer comparison to the singleton
-						// instance for speed.
-						if (object == [NSNull null]) {
-							[sqlString appendString:@"NULL"];
-						}
-
-						// Add trusted raw values directly
-						else if (useRawDataForColumnAtIndex[t]) {
-							[sqlString appendString:object];
-						}
+		BOOL tablesExported = [self _exportTables:tables usingConnectionPool:connectionPool viewSyntaxes:viewSyntaxes errors:errors];
 
-						// If the field is of type BIT, the values need a binary prefix of b'x'.
-						else if ([[NSArrayObjectAtIndex([tableDetails objectForKey:@"columns"], t) objectForKey:@"type"] isEqualToString:@"BIT"]) {
-							[sqlString appendFormat:@"b'%@'", [object description]];
-						}
+		[connectionPool close];
 
-						// Add pre-encoded hex types (binary strings) as enclosed but otherwise trusted data
-						else if (useRawHexDataForColumnAtIndex[t]) {
-							[sqlString appendFormat:@"X'%@'", object];
-						}
+		// Tables not dumped in full stop the export, rather than leaving an incomplete export file
+		if (!tablesExported) {
+			if ([self isCancelled]) goto end_cleanup;
 
-						// GEOMETRY data types directly as hex data
-						else if ([object isKindOfClass:[SPMySQLGeometryData class]]) {
-							[sqlString appendString:[connection escapeAndQuoteData:[object data]]];
-						}
+			goto export_interrupted;
+		}
+	}
+	else {
 
-						// Add zero-length data or strings as an empty string
-						else if ([object length] == 0) {
-							[sqlString appendString:@"''"];
-						}
-						
-						// Add other data types as hex data
-						else if ([object isKindOfClass:[NSData class]]) {
-
-							if ([self sqlOutputEncodeBLOBasHex]) {
-								[sqlString appendString:[connection escapeAndQuoteData:object]];
-							}
-							else {
-								NSString *data = [[NSString alloc] initWithData:object encoding:[self exportOutputEncoding]];
-								
-								if (data == nil) {
-#warning This can corrupt data! Check if this case ever happens and if so, export as hex-string
-									data = [[NSString alloc] initWithData:object encoding:NSASCIIStringEncoding];
-								}
-								
-								[sqlString appendFormat:@"'%@'", data];
-								
-								[data release];
-							}
-						} 
-
-						// Otherwise add a quoted string with special characters escaped
-						else {
-							[sqlString appendString:[connection escapeAndQuoteString:object]];
-						}
-						
-						// Add the field separator if this isn't the last cell in the row
-						if (t != ([row count] - 1)) [sqlString appendString:@","];
-					}
+		// Loop through the selected tables
+		for (NSArray *table in tables)
+		{
+			// Check for cancellation flag
+			if ([self isCancelled]) goto end_cleanup;
 
-					[sqlString appendString:@")"];
-					queryLength += [sqlString length];
+			[self setSqlCurrentTableExportIndex:[self sqlCurrentTableExportIndex]+1];
 
-					// Write this row to the file
-					[self writeUTF8String:sqlString];
+			[self _splitExportFileForTable:NSArrayObjectAtIndex(table, 0) startingTable:YES];
 
-					// Clean autorelease pool if so decided earlier
-					if (cleanAutoReleasePool) {
-						[sqlExportPool release];
-						sqlExportPool = [[NSAutoreleasePool alloc] init];
-						cleanAutoReleasePool = NO;
-					}
-					
-					rowsWrittenForTable++;
-					rowsWrittenForCurrentStmt++;
-				}
-				
-				// Complete the command
-				[self writeUTF8String:@";\n\n"];
-				
-				// Unlock the table and re-enable keys if supported
-				[metaString setString:@""];
-				[metaString appendFormat:@"/*!40000 ALTER TABLE %@ ENABLE KEYS */;\nUNLOCK TABLES;\n", [tableName backtickQuotedString]];
-				
-				[self writeUTF8String:metaString];
-				
-				// Drain the autorelease pool
-				[sqlExportPool release];
-			
-				// Release the result set
-				[streamingResult release];
+			if (![self _exportTable:table toOutput:[self exportOutputFile] usingConnection:connection connectionPool:nil tableData:sqlTableDataInstance viewSyntaxes:viewSyntaxes errors:errors reportingProgress:YES continuingPartialDump:nil]) {
+				goto end_cleanup;
 			}
 
-			free(useRawDataForColumnAtIndex);
-			free(useRawHexDataForColumnAtIndex);
-
-			if ([connection queryErrored]) {
-				[errors appendFormat:@"%@\n", [connection lastErrorMessage]];
-				
-				if ([self sqlOutputIncludeErrors]) {
-					[self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [connection lastErrorMessage]]];
-				}
-			}
-		}
+			// A table dumped while the connection was lost is incomplete, so stop at the last checkpoint
+			if (sqlExportCheckpoint) {
+				if (![connection isConnected]) goto export_interrupted;
 
-		// Add triggers if the structure export was enabled
-		if (sqlOutputIncludeStructure) {
-			SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"/*!50003 SHOW TRIGGERS WHERE `Table` = %@ */", [tableName tickQuotedString]]];
-			
-			[queryResult setReturnDataAsStrings:YES];
-			
-			if ([queryResult numberOfRows]) {
-				
-				[metaString setString:@"\n"];
-				[metaString appendString:@"DELIMITER ;;\n"];
-				
-				for (NSUInteger s = 0; s < [queryResult numberOfRows]; s++)
-				{
-					// Check for cancellation flag
-					if ([self isCancelled]) goto end_cleanup;
-					
-					NSDictionary *triggers = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
-					
-					// Definer is user@host but we need to escape it to `user`@`host`
-					NSArray *triggersDefiner = [[triggers objectForKey:@"Definer"] componentsSeparatedByString:@"@"];
-					
-					[metaString appendFormat:@"/*!50003 SET SESSION SQL_MODE=\"%@\" */;;\n/*!50003 CREATE */ ", [triggers objectForKey:@"sql_mode"]];
-					[metaString appendFormat:@"/*!50017 DEFINER=%@@%@ */ /*!50003 TRIGGER %@ %@ %@ ON %@ FOR EACH ROW %@ */;;\n",
-					                         [NSArrayObjectAtIndex(triggersDefiner, 0) backtickQuotedString],
-					                         [NSArrayObjectAtIndex(triggersDefiner, 1) backtickQuotedString],
-					                         [[triggers objectForKey:@"Trigger"] backtickQuotedString],
-					                         [triggers objectForKey:@"Timing"],
-					                         [triggers objectForKey:@"Event"],
-					                         [[triggers objectForKey:@"Table"] backtickQuotedString],
-					                         [triggers objectForKey:@"Statement"]];
-					
-					[triggers release];
-				}
-				
-				[metaString appendString:@"DELIMITER ;\n/*!50003 SET SESSION SQL_MODE=@OLD_SQL_MODE */;\n"];
-				
-				[self writeUTF8String:metaString];
-			}
-			
-			if ([connection queryErrored]) {
-				[errors appendFormat:@"%@\n", [connection lastErrorMessage]];
-				
-				if ([self sqlOutputIncludeErrors]) {
-					[self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [connection lastErrorMessage]]];
-				}
+				[self _checkpointCompletedTable:NSArrayObjectAtIndex(table, 0) viewSyntaxes:viewSyntaxes errors:errors];
 			}
 		}
-		
-		// Add an additional separator between tables
-		[self writeUTF8String:@"\n\n"];
 	}
 	
 	// Process any deferred views, adding commands to delete the placeholder tables and add the actual views
@@ -794,25 +521,17 @@
 		}
 	}
 	
-	// Restore unique checks, foreign key checks, and other settings saved at the start
-	[metaString setString:@"\n"];
-	[metaString appendString:@"/*!40111 SET SQL_NOTES=@OLD_SQL_NOTES */;\n"];
-	[metaString appendString:@"/*!40101 SET SQL_MODE=@OLD_SQL_MODE */;\n"];
-	[metaString appendString:@"/*!40014 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS */;\n"];
-	
-	// Restore the client encoding to the original encoding before import
-	[metaString appendString:@"/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;\n"];
-	[metaString appendString:@"/*!40101 SET CHARACTER_SET_RESULTS=@OLD_CHARACTER_SET_RESULTS */;\n"];
-	[metaString appendString:@"/*!40101 SET COLLATION_CONNECTION=@OLD_COLLATION_CONNECTION */;\n"];
-	
 	// Write footer-type information to the file
-	[self writeUTF8String:metaString];
+	[self writeUTF8String:[self _exportFileFooter]];
 
 	// Set export errors
 	[self setSqlExportErrors:errors];
 
 	// Close the file
 	[[self exportOutputFile] close];
+
+	// The export is complete, so it no longer needs to be resumable
+	[sqlExportCheckpoint remove];
 	
 	// Mark the process as not running
 	[self setExportProcessIsRunning:NO];
@@ -820,12 +539,41 @@
 	// Inform the delegate that the export process is complete
 	[delegate performSelectorOnMainThread:@selector(sqlExportProcessComplete:) withObject:self waitUntilDone:NO];
 
+	goto end_cleanup;
+
+export_interrupted:
+	// Keep the checkpoint, so exporting to the same file again offers to resume the export from it
+	if (sqlExportCheckpoint) {
+		[self _appendErrorMessage:NSLocalizedString(@"The connection to the server was lost, so the export was stopped. Export to the same file again to resume the export from its last checkpoint.", @"sql export : connection lost during resumable export message") toErrors:errors];
+	}
+	else {
+		[self _appendErrorMessage:NSLocalizedString(@"A table could not be read in full, so the export was stopped. The export file is incomplete.", @"sql export : table dump failed during concurrent export message") toErrors:errors];
+	}
+	[self setSqlExportErrors:errors];
+
+	[[self exportOutputFile] close];
+
+	[self setExportProcessIsRunning:NO];
+
+	[delegate performSelectorOnMainThread:@selector(sqlExportProcessComplete:) withObject:self waitUntilDone:NO];
+
 end_cleanup:
+	// A cancelled export file is deleted, so its checkpoint is of no further use
+	if ([self isCancelled]) [sqlExportCheckpoint remove];
+
 	if(oldSqlMode) {
 		[connection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@",[oldSqlMode tickQuotedString]]];
 	}
 	[errors release];
-	[sqlString release];
+}
+
+/**
+ * Returns whether the export can be resumed from the checkpoint left by an earlier export to the
+ * same file with the same settings.
+ */
+- (BOOL)canResumeFromCheckpoint
+{
+	return [sqlExportCheckpoint loadWithSettings:[self _checkpointSettings]];
 }
 
 /**
@@ -838,21 +586,835 @@ end_cleanup:
 	return ([[self sqlExportErrors] length] != 0);
 }
 
+/**
+ * Dump the structure and content of a single table or view.
+ *
+ * @param table           The export settings array for the table
+ * @param output          The export file or file handle to write the dump to
+ * @param tableConnection The connection to retrieve the table from
+ * @param tableData       The table data instance using tableConnection
+ * @param viewSyntaxes    The dictionary collecting the deferred view syntaxes
+ * @param errors          The string collecting any export errors
+ * @param reportsProgress Whether to report the current table and its progress to the delegate
+ * @param partialDump     The checkpointed part of the table's dump already in output, to continue
+ *                        the dump after; or nil to dump the whole table
+ *
+ * @return NO if the export was cancelled, or if the key ranges of a table could not all be read
+ */
+- (BOOL)_exportTable:(NSArray *)table toOutput:(id)output usingConnection:(SPMySQLConnection *)tableConnection connectionPool:(SPExportConnectionPool *)connectionPool tableData:(SPTableData *)tableData viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors reportingProgress:(BOOL)reportsProgress continuingPartialDump:(NSDictionary *)partialDump
+{
+	NSString *tableName = NSArrayObjectAtIndex(table, 0);
+
+	BOOL sqlOutputIncludeStructure  = [NSArrayObjectAtIndex(table, 1) boolValue];
+	BOOL sqlOutputIncludeContent    = [NSArrayObjectAtIndex(table, 2) boolValue];
+	BOOL sqlOutputIncludeDropSyntax = [NSArrayObjectAtIndex(table, 3) boolValue];
+
+	// Skip tables if not set to output any detail for them
+	if (!sqlOutputIncludeStructure && !sqlOutputIncludeContent && !sqlOutputIncludeDropSyntax) {
+		return YES;
+	}
+
+	// When dumping a single table at a time, set the current table and inform the delegate
+	// that we are about to start fetching data for it
+	if (reportsProgress) {
+		[self setSqlExportCurrentTable:tableName];
+		[delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginFetchingData:) withObject:self waitUntilDone:NO];
+	}
+
+	NSMutableString *metaString = [NSMutableString string];
+	NSUInteger lastProgressValue = 0;
+	BOOL tableRowsIncomplete = NO;
+	
+	// Add the name of table, unless continuing a dump which already has it
+	if (!partialDump) {
+		[self _writeString:[NSString stringWithFormat:@"# %@ %@\n# ------------------------------------------------------------\n\n", NSLocalizedString(@"Dump of table", @"sql export dump of table label"), tableName] toOutput:output];
+	}
+
+	id createTableSyntax = nil;
+	SPTableType tableType = SPTableTypeTable;
+	// Determine whether this table is a table or a view via the CREATE TABLE command, and keep the create table syntax
+	{
+		SPMySQLResult *queryResult = [tableConnection queryString:[NSString stringWithFormat:@"SHOW CREATE TABLE %@", [tableName backtickQuotedString]]];
+
+		[queryResult setReturnDataAsStrings:YES];
+
+		if ([queryResult numberOfRows]) {
+			NSDictionary *tableDetails = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
+
+			if ([tableDetails objectForKey:@"Create View"]) {
+				@synchronized(viewSyntaxes) {
+					[viewSyntaxes setValue:[[[[tableDetails objectForKey:@"Create View"] copy] autorelease] createViewSyntaxPrettifier] forKey:tableName];
+				}
+				createTableSyntax = [self _createViewPlaceholderSyntaxForView:tableName tableData:tableData connection:tableConnection];
+				tableType = SPTableTypeView;
+			}
+			else {
+				createTableSyntax = [[[tableDetails objectForKey:@"Create Table"] copy] autorelease];
+				tableType = SPTableTypeTable;
+			}
+
+			[tableDetails release];
+		}
+
+		if ([tableConnection queryErrored]) {
+			[self _appendErrorMessage:[tableConnection lastErrorMessage] toErrors:errors];
+
+			[self _writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [tableConnection lastErrorMessage]] toOutput:output];
+
+			return YES;
+		}
+	}
+	
+	// Add a 'DROP TABLE' command if required
+	if (sqlOutputIncludeDropSyntax && !partialDump) {
+		[self _writeString:[NSString stringWithFormat:@"DROP %@ IF EXISTS %@;\n\n", ((tableType == SPTableTypeTable) ? @"TABLE" : @"VIEW"), [tableName backtickQuotedString]] toOutput:output];
+	}
+	
+	// Add the create syntax for the table if specified in the export dialog
+	if (sqlOutputIncludeStructure && createTableSyntax && !partialDump) {
+
+		if ([createTableSyntax isKindOfClass:[NSData class]]) {
+#warning This doesn't make sense. If the NSData really contains a string it would be in utf8, utf8mb4 or a mysql pre-4.1 legacy charset, but not in the export output charset. This whole if() is likely a side effect of the BINARY flag confusion (#2700)
+			createTableSyntax = [[[NSString alloc] initWithData:createTableSyntax encoding:[self exportOutputEncoding]] autorelease];
+		}
+		
+		// If necessary strip out the AUTO_INCREMENT from the table structure definition
+		if (![self sqlOutputIncludeAutoIncrement]) {
+			createTableSyntax = [createTableSyntax stringByReplacingOccurrencesOfRegex:[NSString stringWithFormat:@"AUTO_INCREMENT=[0-9]+ "] withString:@""];
+		}
+
+		[self _writeUTF8String:createTableSyntax toOutput:output];
+		[self _writeUTF8String:@";\n\n" toOutput:output];
+	}
+
+	// Add the table content if required
+	if (sqlOutputIncludeContent && (tableType == SPTableTypeTable)) {
+		// Retrieve the table details via the data class, and use it to build an array containing column numeric status
+		NSDictionary *tableDetails = [NSDictionary dictionaryWithDictionary:[tableData informationForTable:tableName]];
+
+		NSUInteger colCount = [[tableDetails objectForKey:@"columns"] count];
+		NSMutableArray *rawColumnNames = [NSMutableArray arrayWithCapacity:colCount];
+		NSMutableArray *queryColumnDetails = [NSMutableArray arrayWithCapacity:colCount];
+		
+		BOOL *useRawDataForColumnAtIndex = calloc(colCount, sizeof(BOOL));
+		BOOL *useRawHexDataForColumnAtIndex = calloc(colCount, sizeof(BOOL));
+
+		// Determine whether raw data can be used for each column during processing - safe numbers and hex-encoded data.
+		for (NSUInteger j = 0; j < colCount; j++)
+		{
+			NSDictionary *theColumnDetail = NSArrayObjectAtIndex([tableDetails objectForKey:@"columns"], j);
+			NSString *theTypeGrouping = [theColumnDetail objectForKey:@"typegrouping"];
+
+			// Start by setting the column as non-safe
+			useRawDataForColumnAtIndex[j] = NO;
+			useRawHexDataForColumnAtIndex[j] = NO;
+
+			// Determine whether the column should be retrieved as hex data from the server - for binary strings, to
+			// avoid encoding issues when processing
+			if ([self sqlOutputEncodeBLOBasHex]
+				&& [theTypeGrouping isEqualToString:@"string"]
+				&& ([[theColumnDetail objectForKey:@"binary"] boolValue] || [[theColumnDetail objectForKey:@"collation"] hasSuffix:@"_bin"]))
+			{
+				useRawHexDataForColumnAtIndex[j] = YES;
+			}
+
+			// Floats, integers can be output directly assuming they're non-binary
+			if (![[theColumnDetail objectForKey:@"binary"] boolValue] && ([@[@"integer",@"float"] containsObject:theTypeGrouping]))
+			{
+				useRawDataForColumnAtIndex[j] = YES;
+			}
+
+			// Set up the column query string parts
+			[rawColumnNames addObject:[theColumnDetail objectForKey:@"name"]];
+			
+			if (useRawHexDataForColumnAtIndex[j]) {
+				[queryColumnDetails addObject:[NSString stringWithFormat:@"HEX(%@)", [[theColumnDetail objectForKey:@"name"] mySQLBacktickQuotedString]]];
+			} 
+			else {
+				[queryColumnDetails addObject:[[theColumnDetail objectForKey:@"name"] mySQLBacktickQuotedString]];
+			}
+		}
+
+		// Retrieve the number of rows in the table for progress bar drawing
+		NSArray *rowArray = [[tableConnection queryString:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [tableName backtickQuotedString]]] getRowAsArray];
+		
+		if ([tableConnection queryErrored] || ![rowArray count]) {
+			[self _appendErrorMessage:[tableConnection lastErrorMessage] toErrors:errors];
+			[self _writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [tableConnection lastErrorMessage]] toOutput:output];
+			free(useRawDataForColumnAtIndex);
+			free(useRawHexDataForColumnAtIndex);
+			return YES;
+		}
+		
+		NSUInteger rowCount = [NSArrayObjectAtIndex(rowArray, 0) integerValue];
+
+		// A partial dump is continued even if the table has since been emptied, to complete its statements
+		if (rowCount || partialDump) {
+			// Key ranges read on different pooled connections only fit together if the snapshots were
+			// started under a global read lock; otherwise the table is read as a single stream
+			NSString *chunkingKey = ([connectionPool usesSharedSnapshot]) ? [SPExportChunkedTableReader chunkingKeyForTableDetails:tableDetails rowCount:rowCount] : nil;
+
+			if (partialDump) chunkingKey = [partialDump objectForKey:SPExportCheckpointKeyColumnKey];
+
+			// Set up a result set in streaming mode - or for large tables in a pooled export, a reader
+			// fetching key ranges of the table concurrently
+			id streamingResult;
+			SPExportChunkedTableReader *chunkedReader = nil;
+
+			if (chunkingKey) {
+				chunkedReader = [[SPExportChunkedTableReader alloc] initWithTableName:tableName keyColumn:chunkingKey selectColumns:[queryColumnDetails componentsJoinedByString:@", "] connection:tableConnection connectionPool:connectionPool];
+
+				if (partialDump) [chunkedReader setInitialLowerBound:[partialDump objectForKey:SPExportCheckpointKeyBoundKey]];
+
+				[chunkedReader startReading];
+
+				streamingResult = chunkedReader;
+			}
+			else {
+				streamingResult = [[tableConnection streamingQueryString:[NSString stringWithFormat:@"SELECT %@ FROM %@", [queryColumnDetails componentsJoinedByString:@", "], [tableName backtickQuotedString]] useLowMemoryBlockingStreaming:([self exportUsingLowMemoryBlockingStreaming])] retain];
+			}
+
+			[self beginRecordingTable:tableName readingResult:streamingResult];
+
+			// Inform the delegate that we are about to start writing data for the current table
+			if (reportsProgress) [delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+
+			NSUInteger queryLength = 0;
+
+			// Set up the serializer writing each VALUES group as UTF-8 bytes.  Rows of a streaming result are
+			// serialized directly from the raw MySQL row data; rows of a chunked reader are serialized from objects.
+			BOOL useRawRows = [streamingResult isKindOfClass:[SPMySQLStreamingResult class]];
+
+			SPSQLExportRowSerializer *rowSerializer = [[SPSQLExportRowSerializer alloc] initWithColumnCount:colCount stringEncoding:[tableConnection stringEncoding] encodeBlobsAsHex:[self sqlOutputEncodeBLOBasHex] blobStringEncoding:[self exportOutputEncoding]];
+
+			for (NSUInteger j = 0; j < colCount; j++)
+			{
+				SPSQLExportCellFormat cellFormat = SPSQLExportCellAsString;
+				NSUInteger bitLength = 0;
+
+				// Trusted numbers, BIT fields and binary strings retrieved as hex are identified from the table details
+				if (useRawDataForColumnAtIndex[j]) {
+					cellFormat = SPSQLExportCellAsNumber;
+				}
+				else if ([[NSArrayObjectAtIndex([tableDetails objectForKey:@"columns"], j) objectForKey:@"type"] isEqualToString:@"BIT"]) {
+					cellFormat = SPSQLExportCellAsBit;
+				}
+				else if (useRawHexDataForColumnAtIndex[j]) {
+					cellFormat = SPSQLExportCellAsHexString;
+				}
+
+				// Raw rows carry no object types, so binary and geometry data are identified from the result fields
+				if (useRawRows) {
+					SPMySQLResultFieldProcessor fieldProcessor = [streamingResult fieldProcessorForFieldAtIndex:j];
+
+					if (cellFormat == SPSQLExportCellAsBit) {
+						bitLength = [streamingResult bitLengthForFieldAtIndex:j];
+					}
+					else if (cellFormat == SPSQLExportCellAsString && fieldProcessor == SPMySQLResultFieldAsGeometry) {
+						cellFormat = SPSQLExportCellAsGeometry;
+					}
+					else if (cellFormat == SPSQLExportCellAsString && (fieldProcessor == SPMySQLResultFieldAsBlob || fieldProcessor == SPMySQLResultFieldAsUnhandled)) {
+						cellFormat = SPSQLExportCellAsBlob;
+					}
+				}
+
+				[rowSerializer setFormat:cellFormat bitLength:bitLength forColumn:j];
+			}
+
+			const char **rawRowCells = NULL;
+			unsigned long *rawRowCellLengths = NULL;
+
+			if (useRawRows) {
+				rawRowCells = malloc(sizeof(char *) * colCount);
+				rawRowCellLengths = malloc(sizeof(unsigned long) * colCount);
+			}
+
+			NSString *insertStatementStart = [NSString stringWithFormat:@";\n\nINSERT INTO %@ (%@)\nVALUES\n\t(", [tableName backtickQuotedString], [rawColumnNames componentsJoinedAndBacktickQuoted]];
+			
+			// Iterate through the rows to construct a VALUES group for each
+			NSUInteger rowsWrittenForTable = 0;
+			NSUInteger rowsWrittenForCurrentStmt = 0;
+			BOOL cleanAutoReleasePool = NO;
+
+			if (!partialDump) {
+				// Lock the table for writing and disable keys if supported
+				[metaString setString:@""];
+				[metaString appendFormat:@"LOCK TABLES %@ WRITE;\n/*!40000 ALTER TABLE %@ DISABLE KEYS */;\n\n", [tableName backtickQuotedString], [tableName backtickQuotedString]];
+
+				[self _writeString:metaString toOutput:output];
+
+				// Construct the start of the insertion command
+				[self _writeUTF8String:[NSString stringWithFormat:@"INSERT INTO %@ (%@)\nVALUES", [tableName backtickQuotedString], [rawColumnNames componentsJoinedAndBacktickQuoted]] toOutput:output];
+			}
+			else {
+				// The partial dump ends after a row, so start a new INSERT statement for the following rows
+				rowsWrittenForTable = [[partialDump objectForKey:SPExportCheckpointRowCountKey] unsignedIntegerValue];
+				rowsWrittenForCurrentStmt = [self sqlInsertAfterNValue];
+				queryLength = [self sqlInsertAfterNValue] * 1024;
+			}
+
+			// Only a table written directly to a split export file can be split across its parts
+			BOOL splitsOutput = (output == [self exportOutputFile] && [[self exportOutputFile] isSplit]);
+
+			// When dumping to a file of the checkpoint, checkpoint the dump as the key ranges of the table are completed
+			BOOL checkpointsKeyRanges = (sqlExportCheckpoint && chunkedReader && [output isKindOfClass:[NSFileHandle class]]);
+			NSUInteger checkpointedChunkCount = 0;
+			NSTimeInterval lastCheckpointTime = [NSDate timeIntervalSinceReferenceDate];
+			
+			NSAutoreleasePool *sqlExportPool = [[NSAutoreleasePool alloc] init];
+			
+			// Inform the delegate that we are about to start writing the data to disk
+			if (reportsProgress) [delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+			
+			NSArray *row = nil;
+			while (useRawRows ? [streamingResult getRawRowCells:rawRowCells lengths:rawRowCellLengths] : ((row = [streamingResult getRowAsArray]) != nil))
+			{
+				// Check for cancellation flag
+				if ([self isCancelled]) {
+					[tableConnection cancelCurrentQuery];
+					[streamingResult cancelResultLoad];
+					[self endRecordingTable:tableName];
+					[streamingResult release];
+					[rowSerializer release];
+					[sqlExportPool release];
+					free(useRawDataForColumnAtIndex);
+					free(useRawHexDataForColumnAtIndex);
+					if (rawRowCells) free(rawRowCells);
+					if (rawRowCellLengths) free(rawRowCellLengths);
+
+					return NO;
+				}
+
+				// Once a row of a new key range is returned, all rows up to the previous range's bound are in the dump
+				if (checkpointsKeyRanges && [chunkedReader completedChunkCount] != checkpointedChunkCount) {
+					checkpointedChunkCount = [chunkedReader completedChunkCount];
+
+					if (rowsWrittenForTable && [chunkedReader completedKeyBound] && ([NSDate timeIntervalSinceReferenceDate] - lastCheckpointTime) >= SPSQLExporterKeyRangeCheckpointInterval) {
+						[rowSerializer writeToOutput:output];
+						[(NSFileHandle *)output synchronizeFile];
+
+						[sqlExportCheckpoint recordPartialDumpOfTable:tableName length:[output offsetInFile] keyColumn:chunkingKey keyBound:[chunkedReader completedKeyBound] rowCount:rowsWrittenForTable];
+
+						lastCheckpointTime = [NSDate timeIntervalSinceReferenceDate];
+					}
+				}
+
+				// Update the progress
+				NSUInteger progress = (rowCount) ? (NSUInteger)((rowsWrittenForTable + 1) * ([self exportMaxProgress] / rowCount)) : 0;
+
+				if (reportsProgress && progress > lastProgressValue) {
+					[self setExportProgressValue:progress];
+					lastProgressValue = progress;
+
+					// Inform the delegate that the export's progress has been updated
+					[delegate performSelectorOnMainThread:@selector(sqlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+				}
+
+				NSUInteger rowStartLength = [rowSerializer length];
+
+				// Set up the new row as appropriate.  If a new INSERT statement should be created,
+				// set one up; otherwise, set up a new row
+				if ((([self sqlInsertDivider] == SPSQLInsertEveryNDataBytes) && (queryLength >= ([self sqlInsertAfterNValue] * 1024))) ||
+					(([self sqlInsertDivider] == SPSQLInsertEveryNRows) && (rowsWrittenForCurrentStmt == [self sqlInsertAfterNValue])))
+				{
+					// Between statements, a split export file can roll over to a new part, which
+					// needs the table to be locked again to continue its rows
+					if (splitsOutput && [[self exportOutputFile] needsNewPart]) {
+						[rowSerializer appendString:[NSString stringWithFormat:@";\n\n/*!40000 ALTER TABLE %@ ENABLE KEYS */;\nUNLOCK TABLES;\n\n\n", [tableName backtickQuotedString]]];
+						[rowSerializer writeToOutput:output];
+
+						[self _splitExportFileForTable:tableName startingTable:NO];
+
+						[rowSerializer appendString:[NSString stringWithFormat:@"LOCK TABLES %@ WRITE;\n/*!40000 ALTER TABLE %@ DISABLE KEYS */;\n\n", [tableName backtickQuotedString], [tableName backtickQuotedString]]];
+						[rowSerializer appendString:[insertStatementStart substringFromIndex:3]];
+					}
+					else {
+						[rowSerializer appendString:insertStatementStart];
+					}
+
+					queryLength = 0, rowsWrittenForCurrentStmt = 0;
+
+					// Use the opportunity to drain and reset the autorelease pool at the end of this row
+					cleanAutoReleasePool = YES;
+				}
+				else if (rowsWrittenForTable == 0) {
+					[rowSerializer appendBytes:"\n\t(" length:3];
+				}
+				else {
+					[rowSerializer appendBytes:",\n\t(" length:4];
+				}
+
+				if (useRawRows) {
+					[rowSerializer appendRawRowCells:rawRowCells lengths:rawRowCellLengths];
+				}
+				else {
+					[rowSerializer appendRow:row];
+				}
+
+				[rowSerializer appendBytes:")" length:1];
+				queryLength += [rowSerializer length] - rowStartLength;
+
+				// Write the buffered rows to the file once enough have been serialized
+				if ([rowSerializer length] >= SPSQLExporterOutputFlushLength) {
+					[rowSerializer writeToOutput:output];
+				}
+
+				// Clean autorelease pool if so decided earlier
+				if (cleanAutoReleasePool) {
+					[sqlExportPool release];
+					sqlExportPool = [[NSAutoreleasePool alloc] init];
+					cleanAutoReleasePool = NO;
+				}
+				
+				rowsWrittenForTable++;
+				rowsWrittenForCurrentStmt++;
+			}
+
+			[rowSerializer writeToOutput:output];
+			[rowSerializer release];
+
+			if (rawRowCells) free(rawRowCells);
+			if (rawRowCellLengths) free(rawRowCellLengths);
+			
+			// Complete the command
+			[self _writeUTF8String:@";\n\n" toOutput:output];
+			
+			// Unlock the table and re-enable keys if supported
+			[metaString setString:@""];
+			[metaString appendFormat:@"/*!40000 ALTER TABLE %@ ENABLE KEYS */;\nUNLOCK TABLES;\n", [tableName backtickQuotedString]];
+			
+			[self _writeUTF8String:metaString toOutput:output];
+			
+			// Drain the autorelease pool
+			[sqlExportPool release];
+
+			// Report any error which stopped the key ranges being read
+			if ([chunkedReader lastErrorMessage]) {
+				tableRowsIncomplete = YES;
+
+				[self _appendErrorMessage:[chunkedReader lastErrorMessage] toErrors:errors];
+
+				if ([self sqlOutputIncludeErrors]) {
+					[self _writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [chunkedReader lastErrorMessage]] toOutput:output];
+				}
+			}
+
+			// Release the result set
+			[self endRecordingTable:tableName];
+			[streamingResult release];
+		}
+
+		free(useRawDataForColumnAtIndex);
+		free(useRawHexDataForColumnAtIndex);
+
+		if ([tableConnection queryErrored]) {
+			[self _appendErrorMessage:[tableConnection lastErrorMessage] toErrors:errors];
+			
+			if ([self sqlOutputIncludeErrors]) {
+				[self _writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [tableConnection lastErrorMessage]] toOutput:output];
+			}
+		}
+	}
+
+	// Add triggers if the structure export was enabled
+	if (sqlOutputIncludeStructure) {
+		SPMySQLResult *queryResult = [tableConnection queryString:[NSString stringWithFormat:@"/*!50003 SHOW TRIGGERS WHERE `Table` = %@ */", [tableName tickQuotedString]]];
+		
+		[queryResult setReturnDataAsStrings:YES];
+		
+		if ([queryResult numberOfRows]) {
+			
+			[metaString setString:@"\n"];
+			[metaString appendString:@"DELIMITER ;;\n"];
+			
+			for (NSUInteger s = 0; s < [queryResult numberOfRows]; s++)
+			{
+				// Check for cancellation flag
+				if ([self isCancelled]) return NO;
+				
+				NSDictionary *triggers = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
+				
+				// Definer is user@host but we need to escape it to `user`@`host`
+				NSArray *triggersDefiner = [[triggers objectForKey:@"Definer"] componentsSeparatedByString:@"@"];
+				
+				[metaString appendFormat:@"/*!50003 SET SESSION SQL_MODE=\"%@\" */;;\n/*!50003 CREATE */ ", [triggers objectForKey:@"sql_mode"]];
+				[metaString appendFormat:@"/*!50017 DEFINER=%@@%@ */ /*!50003 TRIGGER %@ %@ %@ ON %@ FOR EACH ROW %@ */;;\n",
+				                         [NSArrayObjectAtIndex(triggersDefiner, 0) backtickQuotedString],
+				                         [NSArrayObjectAtIndex(triggersDefiner, 1) backtickQuotedString],
+				                         [[triggers objectForKey:@"Trigger"] backtickQuotedString],
+				                         [triggers objectForKey:@"Timing"],
+				                         [triggers objectForKey:@"Event"],
+				                         [[triggers objectForKey:@"Table"] backtickQuotedString],
+				                         [triggers objectForKey:@"Statement"]];
+				
+				[triggers release];
+			}
+			
+			[metaString appendString:@"DELIMITER ;\n/*!50003 SET SESSION SQL_MODE=@OLD_SQL_MODE */;\n"];
+			
+			[self _writeUTF8String:metaString toOutput:output];
+		}
+		
+		if ([tableConnection queryErrored]) {
+			[self _appendErrorMessage:[tableConnection lastErrorMessage] toErrors:errors];
+			
+			if ([self sqlOutputIncludeErrors]) {
+				[self _writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [tableConnection lastErrorMessage]] toOutput:output];
+			}
+		}
+	}
+	
+	// Add an additional separator between tables
+	[self _writeUTF8String:@"\n\n" toOutput:output];
+
+	return !tableRowsIncomplete;
+}
+
+/**
+ * Dump the supplied tables concurrently, with each pooled connection dumping one table at a time
+ * to its own temporary file.  The files are appended to the export file in table order as they
+ * complete, so the output is the same as that of a serial dump.  Once no tables remain to be
+ * started, the connections become available to read the key ranges of large tables.
+ *
+ * A table whose connection is lost, or whose last query fails, stops the export.  When the export
+ * is checkpointed, the tables are dumped to files in the checkpoint directory instead, and are
+ * kept until they have been appended to the checkpointed export file, leaving the checkpoint to
+ * resume from.
+ *
+ * @return NO if the export was cancelled or a table could not be dumped in full
+ */
+- (BOOL)_exportTables:(NSArray *)tables usingConnectionPool:(SPExportConnectionPool *)connectionPool viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors
+{
+	NSUInteger tableCount = [tables count];
+	NSUInteger previousTableCount = [self sqlCurrentTableExportIndex];
+	NSString *tableFilePrefix = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPSQLExport-%@-", [[NSProcessInfo processInfo] globallyUniqueString]]];
+	NSMutableArray *tableFilePaths = [NSMutableArray arrayWithCapacity:tableCount];
+	BOOL resumingExport = (sqlExportCheckpoint && [self sqlExportResumesFromCheckpoint]);
+
+	for (NSUInteger tableIndex = 0; tableIndex < tableCount; tableIndex++)
+	{
+		NSString *tableFilePath = [sqlExportCheckpoint dumpPathForTable:NSArrayObjectAtIndex(NSArrayObjectAtIndex(tables, tableIndex), 0)];
+
+		[tableFilePaths addObject:(tableFilePath) ? tableFilePath : [tableFilePrefix stringByAppendingFormat:@"%lu.sql", (unsigned long)tableIndex]];
+	}
+
+	NSCondition *tableCompletionCondition = [[NSCondition alloc] init];
+	NSMutableIndexSet *completedTables = [NSMutableIndexSet indexSet];
+	__block NSUInteger nextTableIndex = 0;
+	__block BOOL dumpInterrupted = NO;
+	NSUInteger workerCount = MIN([connectionPool connectionCount], tableCount);
+	__block NSUInteger activeWorkers = workerCount;
+
+	dispatch_group_t workerGroup = dispatch_group_create();
+	dispatch_queue_t workerQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+
+	for (NSUInteger i = 0; i < workerCount; i++)
+	{
+		dispatch_group_async(workerGroup, workerQueue, ^{
+			SPMySQLConnection *snapshotConnection = [connectionPool checkoutConnection];
+			SPTableData *tableData = [[SPTableData alloc] init];
+
+			[tableData setConnection:snapshotConnection];
+
+			while (1)
+			{
+				[tableCompletionCondition lock];
+				NSUInteger tableIndex = nextTableIndex++;
+				BOOL stopDumping = dumpInterrupted;
+				[tableCompletionCondition unlock];
+
+				if (tableIndex >= tableCount || !snapshotConnection || [self isCancelled] || stopDumping) break;
+
+				NSArray *table = NSArrayObjectAtIndex(tables, tableIndex);
+				BOOL continueExport = YES;
+
+				@autoreleasepool {
+					NSString *tableFilePath = NSArrayObjectAtIndex(tableFilePaths, tableIndex);
+					NSFileHandle *tableFile = nil;
+
+					// Continue a dump checkpointed part way through the table, or start a new one
+					NSDictionary *partialDump = (resumingExport) ? [self _resumablePartialDumpForTable:NSArrayObjectAtIndex(table, 0) tableData:tableData] : nil;
+
+					if (partialDump) {
+						tableFile = [NSFileHandle fileHandleForWritingAtPath:tableFilePath];
+
+						[tableFile truncateFileAtOffset:[[partialDump objectForKey:SPExportCheckpointDumpLengthKey] unsignedLongLongValue]];
+					}
+					else if ([[NSFileManager defaultManager] createFileAtPath:tableFilePath contents:nil attributes:nil]) {
+						tableFile = [NSFileHandle fileHandleForWritingAtPath:tableFilePath];
+					}
+
+					if (tableFile) {
+						@try {
+							continueExport = [self _exportTable:table toOutput:tableFile usingConnection:snapshotConnection connectionPool:connectionPool tableData:tableData viewSyntaxes:viewSyntaxes errors:errors reportingProgress:NO continuingPartialDump:partialDump];
+						}
+						@catch (NSException *e) {
+							continueExport = NO;
+
+							[self _appendErrorMessage:[NSString stringWithFormat:@"%@: %@", NSArrayObjectAtIndex(table, 0), [e reason]] toErrors:errors];
+						}
+
+						[tableFile closeFile];
+					}
+					else {
+						continueExport = NO;
+
+						[self _appendErrorMessage:[NSString stringWithFormat:NSLocalizedString(@"Could not create a temporary file to dump table %@", @"sql export : temporary table dump file couldn't be created"), NSArrayObjectAtIndex(table, 0)] toErrors:errors];
+					}
+				}
+
+				// A table dumped while the connection was lost or a query failed is incomplete; stop
+				// the export, leaving the table to be resumed if the export is checkpointed
+				BOOL tableInterrupted = (![snapshotConnection isConnected] || [snapshotConnection queryErrored] || (!continueExport && ![self isCancelled]));
+
+				[tableCompletionCondition lock];
+				if (tableInterrupted) dumpInterrupted = YES;
+				else [completedTables addIndex:tableIndex];
+				[tableCompletionCondition broadcast];
+				[tableCompletionCondition unlock];
+
+				if (tableInterrupted) break;
+
+				if (!continueExport) break;
+			}
+
+			[tableData release];
+
+			[connectionPool checkinConnection:snapshotConnection];
+
+			[tableCompletionCondition lock];
+			activeWorkers--;
+			[tableCompletionCondition broadcast];
+			[tableCompletionCondition unlock];
+		});
+	}
+
+	BOOL tablesExported = YES;
+
+	// Append the table dumps to the export file in order, as they complete
+	for (NSUInteger tableIndex = 0; tableIndex < tableCount; tableIndex++)
+	{
+		[self setSqlCurrentTableExportIndex:previousTableCount + tableIndex + 1];
+		[self setSqlExportCurrentTable:NSArrayObjectAtIndex(NSArrayObjectAtIndex(tables, tableIndex), 0)];
+
+		[delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginFetchingData:) withObject:self waitUntilDone:NO];
+
+		[tableCompletionCondition lock];
+
+		while (![completedTables containsIndex:tableIndex] && activeWorkers) [tableCompletionCondition wait];
+
+		BOOL tableCompleted = [completedTables containsIndex:tableIndex];
+
+		[tableCompletionCondition unlock];
+
+		if (!tableCompleted || [self isCancelled]) {
+			tablesExported = NO;
+			break;
+		}
+
+		[delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+
+		NSString *tableFilePath = NSArrayObjectAtIndex(tableFilePaths, tableIndex);
+		NSFileHandle *tableFile = [NSFileHandle fileHandleForReadingAtPath:tableFilePath];
+
+		// Table dumps are appended whole, so a split export file can only roll over between them
+		[self _splitExportFileForTable:NSArrayObjectAtIndex(NSArrayObjectAtIndex(tables, tableIndex), 0) startingTable:YES];
+
+		while (tableFile)
+		{
+			@autoreleasepool {
+				NSData *tableDumpData = [tableFile readDataOfLength:SPSQLExporterTableMergeChunkSize];
+
+				if (![tableDumpData length]) break;
+
+				[[self exportOutputFile] writeData:tableDumpData];
+			}
+		}
+
+		[tableFile closeFile];
+
+		// Checkpoint the export file before discarding the table's dump
+		if (sqlExportCheckpoint) {
+			[self _checkpointCompletedTable:NSArrayObjectAtIndex(NSArrayObjectAtIndex(tables, tableIndex), 0) viewSyntaxes:viewSyntaxes errors:errors];
+		}
+
+		[[NSFileManager defaultManager] removeItemAtPath:tableFilePath error:NULL];
+
+		[self setExportProgressValue:((previousTableCount + tableIndex + 1) * ([self exportMaxProgress] / (previousTableCount + tableCount)))];
+
+		[delegate performSelectorOnMainThread:@selector(sqlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+	}
+
+	// Wait for any remaining workers - after a cancellation - and remove their files
+	dispatch_group_wait(workerGroup, DISPATCH_TIME_FOREVER);
+	dispatch_release(workerGroup);
+
+	[tableCompletionCondition release];
+
+	// The dumps in a checkpoint are kept to resume from, or removed along with it
+	if (!tablesExported && !sqlExportCheckpoint) {
+		for (NSString *tableFilePath in tableFilePaths)
+		{
+			[[NSFileManager defaultManager] removeItemAtPath:tableFilePath error:NULL];
+		}
+	}
+
+	return tablesExported;
+}
+
+/**
+ * Returns the statements restoring the settings changed by the dump header, which end the export
+ * file and each part of a split export file.
+ */
+- (NSString *)_exportFileFooter
+{
+	NSMutableString *footer = [NSMutableString stringWithString:@"\n"];
+
+	// Restore unique checks, foreign key checks, and other settings saved at the start
+	[footer appendString:@"/*!40111 SET SQL_NOTES=@OLD_SQL_NOTES */;\n"];
+	[footer appendString:@"/*!40101 SET SQL_MODE=@OLD_SQL_MODE */;\n"];
+	[footer appendString:@"/*!40014 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS */;\n"];
+
+	// Restore the client encoding to the original encoding before import
+	[footer appendString:@"/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;\n"];
+	[footer appendString:@"/*!40101 SET CHARACTER_SET_RESULTS=@OLD_CHARACTER_SET_RESULTS */;\n"];
+	[footer appendString:@"/*!40101 SET COLLATION_CONNECTION=@OLD_COLLATION_CONNECTION */;\n"];
+
+	return footer;
+}
+
+/**
+ * If the export file is split and its current part is complete, ends the part with the dump footer
+ * and continues in a new part starting with the dump header, so each part can be imported on its own.
+ * Must only be called between statements.
+ *
+ * @param tableName     The name of the table being written
+ * @param startingTable Whether the table is about to be started, rather than continued in a new part
+ */
+- (void)_splitExportFileForTable:(NSString *)tableName startingTable:(BOOL)startingTable
+{
+	SPExportFile *exportFile = [self exportOutputFile];
+
+	if (![exportFile isSplit] || !sqlExportPartHeader) return;
+
+	if (startingTable ? [exportFile needsNewPartForTable:tableName] : [exportFile needsNewPart]) {
+		[self writeUTF8String:[self _exportFileFooter]];
+
+		// If a new part can't be created, output continues in the current part with the header's settings restored
+		if (![exportFile beginNewPart]) NSLog(@"SPSQLExporter failed to create a new part of the export file %@", [exportFile exportFilePath]);
+
+		[self writeString:sqlExportPartHeader];
+	}
+
+	[exportFile addTableToCurrentPart:tableName];
+}
+
+/**
+ * Returns the settings which determine the content of the export file; an export can only be
+ * resumed from a checkpoint recorded with the same settings.
+ */
+- (NSDictionary *)_checkpointSettings
+{
+	return @{
+		@"Host"                 : [self sqlDatabaseHost],
+		@"Database"             : [self sqlDatabaseName],
+		@"Tables"               : [self sqlExportTables],
+		@"IncludeUTF8BOM"       : @([self sqlOutputIncludeUTF8BOM]),
+		@"EncodeBLOBasHex"      : @([self sqlOutputEncodeBLOBasHex]),
+		@"IncludeErrors"        : @([self sqlOutputIncludeErrors]),
+		@"IncludeAutoIncrement" : @([self sqlOutputIncludeAutoIncrement]),
+		@"InsertDivider"        : @([self sqlInsertDivider]),
+		@"InsertAfterNValue"    : @([self sqlInsertAfterNValue]),
+		@"OutputEncoding"       : @([self exportOutputEncoding]),
+		@"CompressionFormat"    : @([self exportOutputCompressionFormat])
+	};
+}
+
+/**
+ * Make the export file durable up to the end of a table which has just been written to it, and
+ * record the table as completed in the checkpoint.
+ */
+- (void)_checkpointCompletedTable:(NSString *)tableName viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors
+{
+	unsigned long long exportFileOffset = [[self exportOutputFile] checkpoint];
+
+	if (!exportFileOffset) return;
+
+	NSDictionary *checkpointViewSyntaxes;
+	NSString *checkpointErrors;
+
+	@synchronized(viewSyntaxes) {
+		checkpointViewSyntaxes = [[viewSyntaxes copy] autorelease];
+	}
+
+	@synchronized(errors) {
+		checkpointErrors = [[errors copy] autorelease];
+	}
+
+	[sqlExportCheckpoint recordCompletedTable:tableName exportFileOffset:exportFileOffset viewSyntaxes:checkpointViewSyntaxes errors:checkpointErrors];
+}
+
+/**
+ * Returns the checkpointed part of a table's dump to continue when resuming, provided the table
+ * is still keyed by the column its key ranges were read by.
+ */
+- (NSDictionary *)_resumablePartialDumpForTable:(NSString *)tableName tableData:(SPTableData *)tableData
+{
+	NSDictionary *partialDump = [sqlExportCheckpoint partialDumpForTable:tableName];
+
+	if (!partialDump) return nil;
+
+	NSArray *primaryKeyColumns = [[tableData informationForTable:tableName] objectForKey:@"primarykeyfield"];
+
+	if ([primaryKeyColumns count] != 1 || ![[primaryKeyColumns objectAtIndex:0] isEqualToString:[partialDump objectForKey:SPExportCheckpointKeyColumnKey]]) return nil;
+
+	return partialDump;
+}
+
+/**
+ * Append an error message to the supplied errors string, which may be shared by
+ * several threads.
+ */
+- (void)_appendErrorMessage:(NSString *)errorMessage toErrors:(NSMutableString *)errors
+{
+	@synchronized(errors) {
+		[errors appendFormat:@"%@\n", errorMessage];
+	}
+}
+
+/**
+ * Write a string to the supplied export file or file handle using the current output encoding.
+ */
+- (void)_writeString:(NSString *)input toOutput:(id)output
+{
+	[output writeData:[input dataUsingEncoding:[self exportOutputEncoding]]];
+}
+
+/**
+ * Write a string to the supplied export file or file handle using UTF-8 encoding.
+ */
+- (void)_writeUTF8String:(NSString *)input toOutput:(id)output
+{
+	[output writeData:[input dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
 /**
  * Retrieve information for a view and use that to construct a CREATE TABLE string for an equivalent basic 
  * table. Allows the construction of placeholder tables to resolve view interdependencies within dumps.
  *
- * @param viewName The name of the view for which the placeholder is to be created for.
+ * @param viewName        The name of the view for which the placeholder is to be created for.
+ * @param tableData       The table data instance to retrieve the view information with
+ * @param viewConnection  The connection used by tableData
  *
  * @return The CREATE TABLE placeholder syntax
  */
-- (NSString *)_createViewPlaceholderSyntaxForView:(NSString *)viewName
+- (NSString *)_createViewPlaceholderSyntaxForView:(NSString *)viewName tableData:(SPTableData *)tableData connection:(SPMySQLConnection *)viewConnection
 {
 	NSUInteger i, j;
 	NSMutableString *placeholderSyntax;
 	
 	// Get structured information for the view via the SPTableData parsers
-	NSDictionary *viewInformation = [sqlTableDataInstance informationForView:viewName];
+	NSDictionary *viewInformation = [tableData informationForView:viewName];
 	
 	if (!viewInformation) return nil;
 	
@@ -884,7 +1446,7 @@ end_cleanup:
 			
 			for (j = 0; j < [[column objectForKey:@"values"] count]; j++) 
 			{
-				[fieldString appendString:[connection escapeAndQuoteString:NSArrayObjectAtIndex([column objectForKey:@"values"], j)]];
+				[fieldString appendString:[viewConnection escapeAndQuoteString:NSArrayObjectAtIndex([column objectForKey:@"values"], j)]];
 				if ((j + 1) != [[column objectForKey:@"values"] count]) {
 					[fieldString appendString:@","];
 				}
@@ -920,7 +1482,7 @@ end_cleanup:
 				[fieldString appendFormat:@" DEFAULT %@",[column objectForKey:@"default"]];
 			} 
 			else {
-				[fieldString appendFormat:@" DEFAULT %@", [connection escapeAndQuoteString:[column objectForKey:@"default"]]];
+				[fieldString appendFormat:@" DEFAULT %@", [viewConnection escapeAndQuoteString:[column objectForKey:@"default"]]];
 			}
 		}
 		
@@ -948,6 +1510,8 @@ end_cleanup:
 	SPClear(sqlExportCurrentTable);
 	SPClear(sqlDatabaseVersion);
 	SPClear(sqlExportErrors);
+	if (sqlExportCheckpoint) SPClear(sqlExportCheckpoint);
+	if (sqlExportPartHeader) SPClear(sqlExportPartHeader);
 	
 	[super dealloc];
 }
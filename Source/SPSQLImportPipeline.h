@@ -0,0 +1,93 @@
+//
+//  SPSQLImportPipeline.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPFileHandle;
+
+/**
+ * @class SPSQLImportPipeline SPSQLImportPipeline.h
+ *
+ * Reads and splits a SQL file into statements for import in two background stages, so that file
+ * reading and decompression, statement splitting and statement execution overlap.  A reader thread
+ * reads the file in chunks into a bounded queue, and a splitter thread decodes the chunks and splits
+ * them into statements with a SPSQLParser, queueing batches of statements for the importing thread
+ * to execute.  Both queues are bounded, so each stage only runs a little ahead of the next.
+ *
+ * Executing a statement which may change the session's SQL mode can change how later statements
+ * are split, so the splitter waits for such statements to be executed, and for the importing thread
+ * to report the resulting backslash escaping, before splitting any further.
+ *
+ * The time each stage spends working rather than waiting on the others is recorded, so the stage
+ * limiting an import can be identified.
+ */
+@interface SPSQLImportPipeline : NSObject
+{
+	SPFileHandle *fileHandle;
+	NSStringEncoding stringEncoding;
+
+	NSCondition *pipelineCondition;
+	NSMutableArray *readChunks;
+	NSMutableArray *statementBatches;
+
+	id currentBatch;
+	NSUInteger currentStatementIndex;
+
+	NSUInteger queuedBatchCount;
+	NSUInteger executedBatchCount;
+	NSUInteger activeThreads;
+
+	NSString *readErrorReason;
+	BOOL noBackslashEscapes;
+	BOOL allDataRead;
+	BOOL allStatementsSplit;
+	BOOL decodingFailed;
+	BOOL cancelled;
+
+	NSTimeInterval startTime;
+	double readerBusyTime;
+	double splitterBusyTime;
+	double executorWaitTime;
+}
+
+- (id)initWithFileHandle:(SPFileHandle *)handle stringEncoding:(NSStringEncoding)encoding noBackslashEscapes:(BOOL)ignoreBackslashEscapes;
+
+- (void)start;
+- (void)close;
+
+- (NSString *)nextStatementReturningByteLength:(NSUInteger *)byteLength;
+- (void)setNoBackslashEscapes:(BOOL)ignoreBackslashEscapes;
+
+- (NSString *)readErrorReason;
+- (BOOL)decodingFailed;
+
+- (double)readerUtilisation;
+- (double)splitterUtilisation;
+- (double)executorUtilisation;
+
+@end
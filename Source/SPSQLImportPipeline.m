@@ -0,0 +1,612 @@
+//
+//  SPSQLImportPipeline.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLImportPipeline.h"
+#import "SPFileHandle.h"
+#import "SPSQLParser.h"
+#import "SPThreadAdditions.h"
+
+// The length of the chunks the file is read in
+static const NSUInteger SPSQLImportPipelineChunkLength = 1048576;
+
+// The number of read chunks queued ahead of the splitter
+static const NSUInteger SPSQLImportPipelineMaximumQueuedChunks = 4;
+
+// The number of statement batches queued ahead of the importing thread
+static const NSUInteger SPSQLImportPipelineMaximumQueuedBatches = 8;
+
+// The number of statements after which a batch is queued, even if its chunk hasn't been fully split
+static const NSUInteger SPSQLImportPipelineMaximumBatchStatements = 1000;
+
+// Statements shorter than this are checked for SQL mode changes
+static const NSUInteger SPSQLImportPipelineModeChangeMaximumLength = 4096;
+
+/**
+ * A batch of statements split from the file, with the length of the file data each was split from.
+ */
+@interface SPSQLImportStatementBatch : NSObject
+{
+	NSMutableArray *statements;
+	NSMutableData *byteLengths;
+}
+
+- (void)addStatement:(NSString *)statement byteLength:(NSUInteger)byteLength;
+- (NSUInteger)count;
+- (NSString *)statementAtIndex:(NSUInteger)index byteLength:(NSUInteger *)byteLength;
+
+@end
+
+@implementation SPSQLImportStatementBatch
+
+- (id)init
+{
+	if ((self = [super init])) {
+		statements = [[NSMutableArray alloc] init];
+		byteLengths = [[NSMutableData alloc] init];
+	}
+
+	return self;
+}
+
+- (void)addStatement:(NSString *)statement byteLength:(NSUInteger)byteLength
+{
+	[statements addObject:statement];
+	[byteLengths appendBytes:&byteLength length:sizeof(NSUInteger)];
+}
+
+- (NSUInteger)count
+{
+	return [statements count];
+}
+
+- (NSString *)statementAtIndex:(NSUInteger)index byteLength:(NSUInteger *)byteLength
+{
+	if (byteLength) *byteLength = ((const NSUInteger *)[byteLengths bytes])[index];
+
+	return NSArrayObjectAtIndex(statements, index);
+}
+
+- (void)dealloc
+{
+	SPClear(statements);
+	SPClear(byteLengths);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPSQLImportPipeline ()
+
+- (void)_readChunks;
+- (void)_splitStatements;
+- (BOOL)_queueBatch:(SPSQLImportStatementBatch *)batch waitingUntilExecuted:(BOOL)waitUntilExecuted;
+- (void)_threadFinished;
+
+@end
+
+@implementation SPSQLImportPipeline
+
+/**
+ * Initialise a pipeline reading the supplied file.
+ *
+ * @param handle                  The file handle to read, which must not be read elsewhere until the pipeline is closed
+ * @param encoding                The encoding of the SQL file
+ * @param ignoreBackslashEscapes  Whether the session's SQL mode includes NO_BACKSLASH_ESCAPES when the import starts
+ */
+- (id)initWithFileHandle:(SPFileHandle *)handle stringEncoding:(NSStringEncoding)encoding noBackslashEscapes:(BOOL)ignoreBackslashEscapes
+{
+	if ((self = [super init])) {
+		fileHandle = [handle retain];
+		stringEncoding = encoding;
+		noBackslashEscapes = ignoreBackslashEscapes;
+
+		pipelineCondition = [[NSCondition alloc] init];
+		readChunks = [[NSMutableArray alloc] init];
+		statementBatches = [[NSMutableArray alloc] init];
+	}
+
+	return self;
+}
+
+/**
+ * Start reading and splitting the file in the background.
+ */
+- (void)start
+{
+	[pipelineCondition lock];
+
+	startTime = [NSDate timeIntervalSinceReferenceDate];
+	activeThreads = 2;
+
+	[pipelineCondition unlock];
+
+	[NSThread detachNewThreadWithName:@"SPSQLImportPipeline reader" target:self selector:@selector(_readChunks) object:nil];
+	[NSThread detachNewThreadWithName:@"SPSQLImportPipeline splitter" target:self selector:@selector(_splitStatements) object:nil];
+}
+
+/**
+ * Stop reading and splitting the file, and wait for the background threads to finish, after which
+ * the file handle may be used or closed.
+ */
+- (void)close
+{
+	[pipelineCondition lock];
+
+	cancelled = YES;
+	[pipelineCondition broadcast];
+
+	while (activeThreads) [pipelineCondition wait];
+
+	[pipelineCondition unlock];
+}
+
+/**
+ * Returns the next statement to execute, waiting for it to be split if necessary.  Statements are
+ * trimmed, and may be empty.  Requesting a statement marks the previous one as executed.
+ *
+ * @param byteLength On return, the length of the file data the statement was split from
+ *
+ * @return The statement, or nil once the whole file has been split or if reading or decoding it failed
+ */
+- (NSString *)nextStatementReturningByteLength:(NSUInteger *)byteLength
+{
+	if (currentBatch && currentStatementIndex < [currentBatch count]) {
+		return [[[currentBatch statementAtIndex:currentStatementIndex++ byteLength:byteLength] retain] autorelease];
+	}
+
+	NSTimeInterval waitStartTime = [NSDate timeIntervalSinceReferenceDate];
+
+	[pipelineCondition lock];
+
+	// All the statements of the current batch have been executed
+	if (currentBatch) {
+		SPClear(currentBatch);
+
+		executedBatchCount++;
+		[pipelineCondition broadcast];
+	}
+
+	while (![statementBatches count] && !allStatementsSplit && !cancelled) [pipelineCondition wait];
+
+	if ([statementBatches count] && !cancelled) {
+		currentBatch = [[statementBatches objectAtIndex:0] retain];
+		currentStatementIndex = 0;
+
+		[statementBatches removeObjectAtIndex:0];
+		[pipelineCondition broadcast];
+	}
+
+	executorWaitTime += [NSDate timeIntervalSinceReferenceDate] - waitStartTime;
+
+	[pipelineCondition unlock];
+
+	if (!currentBatch) return nil;
+
+	return [[[currentBatch statementAtIndex:currentStatementIndex++ byteLength:byteLength] retain] autorelease];
+}
+
+/**
+ * Set whether backslashes are treated as escape characters when splitting further statements,
+ * after a statement has changed the session's SQL mode.
+ */
+- (void)setNoBackslashEscapes:(BOOL)ignoreBackslashEscapes
+{
+	[pipelineCondition lock];
+
+	noBackslashEscapes = ignoreBackslashEscapes;
+
+	[pipelineCondition unlock];
+}
+
+/**
+ * Returns the reason reading the file failed, once all the statements read before the failure
+ * have been returned, or nil.
+ */
+- (NSString *)readErrorReason
+{
+	[pipelineCondition lock];
+
+	NSString *reason = [[readErrorReason retain] autorelease];
+
+	[pipelineCondition unlock];
+
+	return reason;
+}
+
+/**
+ * Returns whether the file couldn't be decoded in the supplied encoding.
+ */
+- (BOOL)decodingFailed
+{
+	[pipelineCondition lock];
+
+	BOOL failed = decodingFailed;
+
+	[pipelineCondition unlock];
+
+	return failed;
+}
+
+#pragma mark -
+#pragma mark Utilisation
+
+/**
+ * Returns the fraction of the time since the pipeline started that the reader has spent reading
+ * and decompressing the file, rather than waiting for the splitter.
+ */
+- (double)readerUtilisation
+{
+	[pipelineCondition lock];
+
+	double elapsedTime = [NSDate timeIntervalSinceReferenceDate] - startTime;
+	double utilisation = (elapsedTime > 0) ? MIN(readerBusyTime / elapsedTime, 1) : 0;
+
+	[pipelineCondition unlock];
+
+	return utilisation;
+}
+
+/**
+ * Returns the fraction of the time since the pipeline started that the splitter has spent decoding
+ * and splitting statements, rather than waiting for the reader or the importing thread.
+ */
+- (double)splitterUtilisation
+{
+	[pipelineCondition lock];
+
+	double elapsedTime = [NSDate timeIntervalSinceReferenceDate] - startTime;
+	double utilisation = (elapsedTime > 0) ? MIN(splitterBusyTime / elapsedTime, 1) : 0;
+
+	[pipelineCondition unlock];
+
+	return utilisation;
+}
+
+/**
+ * Returns the fraction of the time since the pipeline started that the importing thread has spent
+ * executing statements, rather than waiting for them to be split.
+ */
+- (double)executorUtilisation
+{
+	[pipelineCondition lock];
+
+	double elapsedTime = [NSDate timeIntervalSinceReferenceDate] - startTime;
+	double utilisation = (elapsedTime > 0) ? MAX(MIN((elapsedTime - executorWaitTime) / elapsedTime, 1), 0) : 0;
+
+	[pipelineCondition unlock];
+
+	return utilisation;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Read the file into the chunk queue until the end of the file is reached, reading fails, or the
+ * pipeline is stopped.
+ */
+- (void)_readChunks
+{
+	while (1)
+	{
+		NSAutoreleasePool *readPool = [[NSAutoreleasePool alloc] init];
+
+		[pipelineCondition lock];
+
+		while ([readChunks count] >= SPSQLImportPipelineMaximumQueuedChunks && !cancelled && !decodingFailed) [pipelineCondition wait];
+
+		BOOL stopped = (cancelled || decodingFailed);
+
+		[pipelineCondition unlock];
+
+		if (stopped) {
+			[readPool drain];
+			break;
+		}
+
+		NSTimeInterval readStartTime = [NSDate timeIntervalSinceReferenceDate];
+		NSData *fileChunk = nil;
+		NSString *errorReason = nil;
+
+		@try {
+			fileChunk = [fileHandle readDataOfLength:SPSQLImportPipelineChunkLength];
+		}
+		@catch (NSException *exception) {
+			errorReason = [exception reason];
+		}
+
+		[pipelineCondition lock];
+
+		readerBusyTime += [NSDate timeIntervalSinceReferenceDate] - readStartTime;
+
+		// Empty data marks the end of the file
+		BOOL finished = (errorReason || ![fileChunk length]);
+
+		if (errorReason) readErrorReason = [errorReason copy];
+		if (!finished) [readChunks addObject:fileChunk];
+
+		[pipelineCondition broadcast];
+		[pipelineCondition unlock];
+
+		[readPool drain];
+
+		if (finished) break;
+	}
+
+	[pipelineCondition lock];
+
+	allDataRead = YES;
+
+	[pipelineCondition unlock];
+
+	[self _threadFinished];
+}
+
+/**
+ * Decode the read chunks and split them into statements, queueing the statements split from each
+ * chunk as a batch.
+ *
+ * Each chunk is checked for line endings, which are used to split the data into parts which can be
+ * decoded to NSStrings in the file's encoding; these are fed to a SQL parser.
+ */
+- (void)_splitStatements
+{
+	NSMutableData *dataBuffer = [[NSMutableData alloc] init];
+	SPSQLParser *sqlParser = [[SPSQLParser alloc] init];
+	const unsigned char *dataBufferBytes;
+	NSInteger dataBufferLength = 0;
+	NSInteger dataBufferPosition = 0;
+	NSInteger dataBufferLastQueryEndPosition = 0;
+	BOOL allChunksSplit = NO;
+	NSCharacterSet *whitespaceAndNewlineCharset = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+
+	[sqlParser setDelimiterSupport:YES];
+
+	while (!allChunksSplit)
+	{
+		NSAutoreleasePool *splitPool = [[NSAutoreleasePool alloc] init];
+		NSData *fileChunk = nil;
+
+		[pipelineCondition lock];
+
+		while (![readChunks count] && !allDataRead && !cancelled) [pipelineCondition wait];
+
+		if ([readChunks count] && !cancelled) {
+			fileChunk = [[[readChunks objectAtIndex:0] retain] autorelease];
+
+			[readChunks removeObjectAtIndex:0];
+			[pipelineCondition broadcast];
+		}
+
+		BOOL stopped = (cancelled || (!fileChunk && readErrorReason));
+
+		[sqlParser setNoBackslashEscapes:noBackslashEscapes];
+
+		[pipelineCondition unlock];
+
+		// Don't execute the remainder of a file which couldn't be read to the end
+		if (stopped) {
+			[splitPool drain];
+			break;
+		}
+
+		NSTimeInterval splitStartTime = [NSDate timeIntervalSinceReferenceDate];
+		double chunkSplitTime = 0;
+
+		// If no data was read, the end of the file has been reached - ensure full processing
+		if (fileChunk) {
+			[dataBuffer appendData:fileChunk];
+		}
+		else {
+			allChunksSplit = YES;
+		}
+
+		// Step through the data buffer, identifying line endings to parse the data with
+		dataBufferBytes = [dataBuffer bytes];
+		dataBufferLength = [dataBuffer length];
+
+		for ( ; dataBufferPosition < dataBufferLength || allChunksSplit; dataBufferPosition++)
+		{
+			if (allChunksSplit || dataBufferBytes[dataBufferPosition] == 0x0A || dataBufferBytes[dataBufferPosition] == 0x0D) {
+
+				// Keep reading through any other line endings
+				while (dataBufferPosition + 1 < dataBufferLength
+						&& (dataBufferBytes[dataBufferPosition+1] == 0x0A
+							|| dataBufferBytes[dataBufferPosition+1] == 0x0D))
+				{
+					dataBufferPosition++;
+				}
+
+				// Try to generate a NSString with the resulting data
+				NSInteger segmentEndPosition = MIN(dataBufferPosition, dataBufferLength);
+				NSString *sqlString = [[NSString alloc] initWithData:[dataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, segmentEndPosition - dataBufferLastQueryEndPosition)]
+				                                            encoding:stringEncoding];
+
+				if (!sqlString) {
+					[pipelineCondition lock];
+					decodingFailed = YES;
+					[pipelineCondition broadcast];
+					[pipelineCondition unlock];
+
+					break;
+				}
+
+				// Add the NSString segment to the SQL parser and release it
+				[sqlParser appendString:sqlString];
+				[sqlString release];
+
+				if (allChunksSplit) break;
+
+				// Increment the query end position marker
+				dataBufferLastQueryEndPosition = dataBufferPosition;
+			}
+		}
+
+		if ([self decodingFailed]) {
+			[splitPool drain];
+			break;
+		}
+
+		// Trim the data buffer if part of it was used
+		if (dataBufferLastQueryEndPosition) {
+			[dataBuffer setData:[dataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferLength - dataBufferLastQueryEndPosition)]];
+			dataBufferPosition -= dataBufferLastQueryEndPosition;
+			dataBufferLastQueryEndPosition = 0;
+		}
+
+		// Extract any complete SQL queries that can be found in the strings parsed so far
+		SPSQLImportStatementBatch *batch = [[[SPSQLImportStatementBatch alloc] init] autorelease];
+		NSString *query;
+		BOOL queued = YES;
+
+		while (queued && (query = [sqlParser trimAndReturnStringToCharacter:';' trimmingInclusively:YES returningInclusively:NO]))
+		{
+			NSUInteger queryByteLength = [query lengthOfBytesUsingEncoding:stringEncoding] + 1;
+
+			// Ensure whitespace is removed from both ends, and normalise if necessary.
+			if ([sqlParser containsCarriageReturns]) {
+				query = [SPSQLParser normaliseQueryForExecution:query];
+			}
+			else {
+				query = [query stringByTrimmingCharactersInSet:whitespaceAndNewlineCharset];
+			}
+
+			[batch addStatement:query byteLength:queryByteLength];
+
+			// A change of SQL mode may affect how the following statements are split, so wait for it to be executed
+			BOOL mayChangeMode = ([query length] < SPSQLImportPipelineModeChangeMaximumLength && [query rangeOfString:@"sql_mode" options:NSCaseInsensitiveSearch].location != NSNotFound);
+
+			if (mayChangeMode || [batch count] >= SPSQLImportPipelineMaximumBatchStatements) {
+				chunkSplitTime += [NSDate timeIntervalSinceReferenceDate] - splitStartTime;
+
+				queued = [self _queueBatch:batch waitingUntilExecuted:mayChangeMode];
+
+				splitStartTime = [NSDate timeIntervalSinceReferenceDate];
+
+				if (mayChangeMode) {
+					[pipelineCondition lock];
+					[sqlParser setNoBackslashEscapes:noBackslashEscapes];
+					[pipelineCondition unlock];
+				}
+
+				batch = [[[SPSQLImportStatementBatch alloc] init] autorelease];
+			}
+		}
+
+		// If any text remains in the SQL parser at the end of the file, it's an unterminated query - execute it.
+		if (queued && allChunksSplit) {
+			query = [sqlParser stringByTrimmingCharactersInSet:whitespaceAndNewlineCharset];
+
+			if ([query length]) [batch addStatement:query byteLength:[query lengthOfBytesUsingEncoding:stringEncoding]];
+		}
+
+		[pipelineCondition lock];
+		splitterBusyTime += chunkSplitTime + [NSDate timeIntervalSinceReferenceDate] - splitStartTime;
+		[pipelineCondition unlock];
+
+		if (queued) queued = [self _queueBatch:batch waitingUntilExecuted:NO];
+
+		[splitPool drain];
+
+		if (!queued) break;
+	}
+
+	[sqlParser release];
+	[dataBuffer release];
+
+	[pipelineCondition lock];
+
+	allStatementsSplit = YES;
+
+	[pipelineCondition unlock];
+
+	[self _threadFinished];
+}
+
+/**
+ * Queue a batch of statements for execution, waiting for room in the queue, and optionally until
+ * the batch has been executed.  Empty batches are ignored.
+ *
+ * @return NO if the pipeline was stopped
+ */
+- (BOOL)_queueBatch:(SPSQLImportStatementBatch *)batch waitingUntilExecuted:(BOOL)waitUntilExecuted
+{
+	[pipelineCondition lock];
+
+	if ([batch count]) {
+		while ([statementBatches count] >= SPSQLImportPipelineMaximumQueuedBatches && !cancelled) [pipelineCondition wait];
+
+		if (!cancelled) {
+			[statementBatches addObject:batch];
+			queuedBatchCount++;
+
+			[pipelineCondition broadcast];
+		}
+
+		if (waitUntilExecuted) {
+			while (executedBatchCount < queuedBatchCount && !cancelled) [pipelineCondition wait];
+		}
+	}
+
+	BOOL queued = !cancelled;
+
+	[pipelineCondition unlock];
+
+	return queued;
+}
+
+- (void)_threadFinished
+{
+	[pipelineCondition lock];
+
+	activeThreads--;
+	[pipelineCondition broadcast];
+
+	[pipelineCondition unlock];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(fileHandle);
+	SPClear(pipelineCondition);
+	SPClear(readChunks);
+	SPClear(statementBatches);
+	if (currentBatch) SPClear(currentBatch);
+	if (readErrorReason) SPClear(readErrorReason);
+
+	[super dealloc];
+}
+
+@end
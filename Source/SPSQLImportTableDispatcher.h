@@ -0,0 +1,87 @@
+//
+//  SPSQLImportTableDispatcher.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMySQLConnection;
+
+/**
+ * @class SPSQLImportTableDispatcher SPSQLImportTableDispatcher.h
+ *
+ * Runs the statements of a SQL import which only touch a single table on a pool of additional
+ * connections, so that the data of independent tables is imported concurrently.  Each table's
+ * statements - its CREATE TABLE, INSERTs and keys changes - are executed in file order on one
+ * connection at a time, while the statements of different tables run in parallel.  The connections
+ * are copies of a parent connection, set up with the parent session's database, encoding and SQL_MODE,
+ * and every session statement of the file (SET NAMES, FOREIGN_KEY_CHECKS, SQL_MODE, USE...) is
+ * replayed on each connection before it runs the statements which followed it in the file.
+ *
+ * All other statements are left for the importing thread to execute on the parent connection once
+ * every statement queued before them has been executed.  These include every statement on a temporary
+ * table, which only exists in the session that created it.  Where the order of table statements can't
+ * be shown not to matter - when foreign key checks are enabled, or the file uses transactions - the
+ * dispatcher stops queueing statements, so that the rest of the file is imported in order.
+ *
+ * The dispatcher must only be used from the importing thread, apart from -takeErrors.
+ */
+@interface SPSQLImportTableDispatcher : NSObject
+{
+	SPMySQLConnection *parentConnection;
+	NSStringEncoding stringEncoding;
+
+	NSMutableArray *connections;
+	NSCondition *dispatchCondition;
+	NSMutableArray *queuedStatements;
+	NSCountedSet *outstandingTables;
+	NSMutableSet *executingTables;
+	NSMutableArray *sessionStatements;
+	NSMutableArray *errors;
+	NSUInteger activeThreads;
+	BOOL cancelled;
+
+	NSMutableSet *triggerTables;
+	NSMutableSet *temporaryTables;
+	NSString *serialFallbackReason;
+	BOOL foreignKeyChecksDisabled;
+}
+
++ (NSString *)tableDefinedByStatement:(NSString *)statement;
+
+- (id)initWithConnection:(SPMySQLConnection *)connection stringEncoding:(NSStringEncoding)encoding;
+
+- (BOOL)openConnections:(NSUInteger)connectionCount;
+- (NSUInteger)connectionCount;
+- (void)close;
+
+- (BOOL)dispatchStatement:(NSString *)statement statementNumber:(NSInteger)statementNumber;
+- (void)waitUntilAllStatementsExecuted;
+
+- (NSArray *)takeErrors;
+- (NSString *)serialFallbackReason;
+
+@end
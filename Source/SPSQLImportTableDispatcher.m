@@ -0,0 +1,589 @@
+//
+//  SPSQLImportTableDispatcher.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLImportTableDispatcher.h"
+#import "SPThreadAdditions.h"
+#import "RegexKitLite.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The number of table statements queued per connection before dispatching waits
+static const NSUInteger SPSQLImportTableDispatcherQueuedStatementsPerConnection = 4;
+
+// The length of the start of each statement examined to classify it
+static const NSUInteger SPSQLImportTableDispatcherStatementHeadLength = 4096;
+
+// A table name, optionally qualified by its database
+#define SPSQLImportIdentifier @"(?:`(?:[^`]|``)++`|[\\w$]++)"
+#define SPSQLImportTableName @"(" SPSQLImportIdentifier @"(?:\\s*\\.\\s*" SPSQLImportIdentifier @")?)"
+
+// Statements which only touch the named table
+static NSString *SPSQLImportInsertRegex = @"(?i)^(?:INSERT|REPLACE)(?:\\s+(?:LOW_PRIORITY|DELAYED|HIGH_PRIORITY|IGNORE))*+(?:\\s+INTO)?+\\s+" SPSQLImportTableName @"\\s*(?:\\([^)]*\\)\\s*)?VALUES?\\s*\\(";
+static NSString *SPSQLImportTableDefinitionRegex = @"(?i)^(?:CREATE(?:\\s+TEMPORARY)?+\\s+TABLE(?:\\s+IF\\s+NOT\\s+EXISTS)?+|DROP(?:\\s+TEMPORARY)?+\\s+TABLE(?:\\s+IF\\s+EXISTS)?+|ALTER(?:\\s+(?:ONLINE|OFFLINE|IGNORE))*+\\s+TABLE|TRUNCATE(?:\\s+TABLE)?+)\\s+" SPSQLImportTableName @"(?!\\s*[,.]|[\\w$`])";
+
+// Temporary tables, which only exist in the session creating them
+static NSString *SPSQLImportTemporaryTableRegex = @"(?i)^(CREATE|DROP)\\s+TEMPORARY\\s+TABLE(?:\\s+IF(?:\\s+NOT)?+\\s+EXISTS)?+\\s+" SPSQLImportTableName;
+
+// Table definitions which also read or refer to other tables
+static NSString *SPSQLImportTableReferenceRegex = @"(?i)\\b(?:SELECT|LIKE|REFERENCES)\\b";
+
+// Statements which change the session, and must be repeated on every connection
+static NSString *SPSQLImportSessionRegex = @"(?i)^(?:SET|USE)\\b";
+static NSString *SPSQLImportGlobalSetRegex = @"(?i)^SET\\s+(?:GLOBAL\\b|@@GLOBAL\\.)";
+static NSString *SPSQLImportForeignKeyChecksRegex = @"(?i)(?<![\\w@])FOREIGN_KEY_CHECKS\\s*=\\s*'?([^\\s,'*]+)";
+
+// Statements which are skipped, as the tables are written by several connections
+static NSString *SPSQLImportTableLockRegex = @"(?i)^(?:UN)?LOCK\\s+TABLES?\\b";
+
+// Statements whose effects depend on the order of statements across tables
+static NSString *SPSQLImportTransactionRegex = @"(?i)^(?:BEGIN|START\\s+TRANSACTION|COMMIT|ROLLBACK|XA|SAVEPOINT|RELEASE\\s+SAVEPOINT)\\b|^SET\\b.*\\bAUTOCOMMIT\\b";
+static NSString *SPSQLImportTriggerRegex = @"(?is)^CREATE(?:\\s+|\\*/|/\\*!\\d*|OR\\s+REPLACE|DEFINER\\s*=\\s*\\S+?(?=\\s|\\*/))*TRIGGER\\b";
+static NSString *SPSQLImportTriggerTableRegex = @"(?is)\\bON\\s+" SPSQLImportTableName @"\\s+FOR\\s+EACH\\s+ROW\\b";
+
+/**
+ * A statement queued for execution on one of the dispatcher's connections.
+ */
+@interface SPSQLImportTableStatement : NSObject
+{
+	NSString *statement;
+	NSString *table;
+	NSInteger statementNumber;
+	NSUInteger sessionStatementCount;
+}
+
+@property (readonly, retain) NSString *statement;
+@property (readonly, retain) NSString *table;
+@property (readonly, assign) NSInteger statementNumber;
+@property (readonly, assign) NSUInteger sessionStatementCount;
+
+- (id)initWithStatement:(NSString *)aStatement table:(NSString *)aTable statementNumber:(NSInteger)number sessionStatementCount:(NSUInteger)count;
+
+@end
+
+@implementation SPSQLImportTableStatement
+
+@synthesize statement;
+@synthesize table;
+@synthesize statementNumber;
+@synthesize sessionStatementCount;
+
+- (id)initWithStatement:(NSString *)aStatement table:(NSString *)aTable statementNumber:(NSInteger)number sessionStatementCount:(NSUInteger)count
+{
+	if ((self = [super init])) {
+		statement = [aStatement retain];
+		table = [aTable retain];
+		statementNumber = number;
+		sessionStatementCount = count;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	SPClear(statement);
+	SPClear(table);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+/**
+ * Returns the start of a statement examined to classify it, outside any leading conditional
+ * comment, eg "/*!40000 ALTER TABLE...".
+ */
+static NSString *SPSQLImportStatementHead(NSString *statement)
+{
+	NSString *head = ([statement length] > SPSQLImportTableDispatcherStatementHeadLength) ? [statement substringToIndex:SPSQLImportTableDispatcherStatementHeadLength] : statement;
+
+	return [head stringByReplacingOccurrencesOfRegex:@"^\\s*/\\*!\\d*\\s*" withString:@""];
+}
+
+/**
+ * Returns the key statements on a table are queued under.  Table names are compared without their
+ * database and case insensitively, which can only order statements more strictly than necessary.
+ */
+static NSString *SPSQLImportTableKey(NSString *tableName)
+{
+	NSString *name = [[tableName componentsMatchedByRegex:SPSQLImportIdentifier] lastObject];
+
+	if ([name hasPrefix:@"`"]) {
+		name = [[name substringWithRange:NSMakeRange(1, [name length] - 2)] stringByReplacingOccurrencesOfString:@"``" withString:@"`"];
+	}
+
+	return [name lowercaseString];
+}
+
+#pragma mark -
+
+@interface SPSQLImportTableDispatcher ()
+
+- (void)_queueStatement:(NSString *)statement table:(NSString *)table statementNumber:(NSInteger)statementNumber;
+- (void)_fallBackToSerialExecution:(NSString *)reason;
+- (void)_executeStatementsOnConnection:(SPMySQLConnection *)connection;
+
+@end
+
+@implementation SPSQLImportTableDispatcher
+
+/**
+ * Returns the table a CREATE, ALTER, DROP or TRUNCATE TABLE statement defines, as the key its
+ * statements are queued under, or nil if the statement isn't a definition of a single table which
+ * doesn't refer to any others.
+ *
+ * @param statement The statement
+ */
++ (NSString *)tableDefinedByStatement:(NSString *)statement
+{
+	NSString *table = [SPSQLImportStatementHead(statement) stringByMatching:SPSQLImportTableDefinitionRegex capture:1L];
+
+	if (!table || [statement isMatchedByRegex:SPSQLImportTableReferenceRegex]) return nil;
+
+	return SPSQLImportTableKey(table);
+}
+
+/**
+ * Initialise a dispatcher for statements imported through the supplied connection.
+ *
+ * @param connection The connection the import runs on
+ * @param encoding   The encoding to send statements in
+ */
+- (id)initWithConnection:(SPMySQLConnection *)connection stringEncoding:(NSStringEncoding)encoding
+{
+	if ((self = [super init])) {
+		parentConnection = [connection retain];
+		stringEncoding = encoding;
+
+		connections = [[NSMutableArray alloc] init];
+		dispatchCondition = [[NSCondition alloc] init];
+		queuedStatements = [[NSMutableArray alloc] init];
+		outstandingTables = [[NSCountedSet alloc] init];
+		executingTables = [[NSMutableSet alloc] init];
+		sessionStatements = [[NSMutableArray alloc] init];
+		errors = [[NSMutableArray alloc] init];
+		triggerTables = [[NSMutableSet alloc] init];
+		temporaryTables = [[NSMutableSet alloc] init];
+	}
+
+	return self;
+}
+
+/**
+ * Open the connections and start a thread executing statements on each.  Must be called from the
+ * importing thread, before any statements are dispatched, as the parent's session state is read to
+ * set them up.
+ *
+ * @param connectionCount The number of connections to open
+ *
+ * @return YES if at least two connections were opened; otherwise no connections remain open
+ */
+- (BOOL)openConnections:(NSUInteger)connectionCount
+{
+	if ([connections count] || connectionCount < 2) return NO;
+
+	// Mirror the parent's session, including any character set the import has switched it to
+	SPMySQLResult *result = [parentConnection queryString:@"SELECT DATABASE(), @@SESSION.sql_mode, @@SESSION.character_set_client"];
+
+	[result setReturnDataAsStrings:YES];
+
+	NSArray *sessionDetails = [result getRowAsArray];
+
+	if ([parentConnection queryErrored] || [sessionDetails count] != 3) return NO;
+
+	NSString *database = [NSArrayObjectAtIndex(sessionDetails, 0) unboxNull];
+	NSString *sqlMode = [NSArrayObjectAtIndex(sessionDetails, 1) unboxNull];
+	NSString *characterSet = [NSArrayObjectAtIndex(sessionDetails, 2) unboxNull];
+	NSString *encoding = [parentConnection encoding];
+
+	for (NSUInteger i = 0; i < connectionCount; i++)
+	{
+		SPMySQLConnection *connection = [[parentConnection copy] autorelease];
+
+		// Copy the local port from the parent connection, in case a proxy has changed
+		[connection setPort:[parentConnection port]];
+
+		if (![connection connect]) break;
+
+		if (encoding) [connection setEncoding:encoding];
+
+		if (characterSet) [connection queryString:[NSString stringWithFormat:@"SET NAMES %@", [connection escapeAndQuoteString:characterSet]]];
+
+		if ([database length] && ![connection selectDatabase:database]) {
+			[connection disconnect];
+			break;
+		}
+
+		if (sqlMode) [connection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [connection escapeAndQuoteString:sqlMode]]];
+
+		[connections addObject:connection];
+	}
+
+	if ([connections count] < 2) {
+		[self close];
+
+		return NO;
+	}
+
+	[dispatchCondition lock];
+	activeThreads = [connections count];
+	[dispatchCondition unlock];
+
+	for (SPMySQLConnection *connection in connections)
+	{
+		[NSThread detachNewThreadWithName:@"SPSQLImportTableDispatcher statement execution" target:self selector:@selector(_executeStatementsOnConnection:) object:connection];
+	}
+
+	return YES;
+}
+
+/**
+ * Returns the number of connections statements are being dispatched to, which is zero once the
+ * dispatcher has been closed or has fallen back to serial execution.
+ */
+- (NSUInteger)connectionCount
+{
+	return [connections count];
+}
+
+/**
+ * Discard any statements which haven't started executing, wait for the rest to finish and disconnect
+ * the connections.  Errors of executed statements remain available through -takeErrors.
+ */
+- (void)close
+{
+	[dispatchCondition lock];
+
+	cancelled = YES;
+
+	for (SPSQLImportTableStatement *queuedStatement in queuedStatements)
+	{
+		[outstandingTables removeObject:[queuedStatement table]];
+	}
+
+	[queuedStatements removeAllObjects];
+	[dispatchCondition broadcast];
+
+	while (activeThreads) [dispatchCondition wait];
+
+	[dispatchCondition unlock];
+
+	for (SPMySQLConnection *connection in connections)
+	{
+		if ([connection isConnected]) [connection disconnect];
+	}
+
+	[connections removeAllObjects];
+}
+
+/**
+ * Dispatch the next statement of the file.  Statements touching a single table are queued for one
+ * of the connections; the caller must execute any other statement on the parent connection itself,
+ * which it may do as soon as this returns, as any queued statements it depends on have then been
+ * executed.
+ *
+ * @param statement       The statement
+ * @param statementNumber The position of the statement in the file, used to report errors
+ *
+ * @return YES if the statement was queued or skipped; NO if the caller must execute it
+ */
+- (BOOL)dispatchStatement:(NSString *)statement statementNumber:(NSInteger)statementNumber
+{
+	if (![connections count]) return NO;
+
+	NSString *head = SPSQLImportStatementHead(statement);
+
+	if ([head isMatchedByRegex:SPSQLImportTransactionRegex]) {
+		[self _fallBackToSerialExecution:NSLocalizedString(@"the file uses transactions", @"sql import : parallel import stopped because of transactions")];
+
+		return NO;
+	}
+
+	// Session statements are executed by the caller, and repeated on each connection before the statements following them
+	if ([head isMatchedByRegex:SPSQLImportSessionRegex]) {
+		NSString *foreignKeyChecks = [[head componentsMatchedByRegex:SPSQLImportForeignKeyChecksRegex capture:1L] lastObject];
+
+		if (foreignKeyChecks) foreignKeyChecksDisabled = ([foreignKeyChecks isEqualToString:@"0"] || [foreignKeyChecks caseInsensitiveCompare:@"OFF"] == NSOrderedSame);
+
+		if (![head isMatchedByRegex:SPSQLImportGlobalSetRegex]) {
+			[dispatchCondition lock];
+			[sessionStatements addObject:statement];
+			[dispatchCondition unlock];
+		}
+
+		return NO;
+	}
+
+	// Table locks would block the other connections writing the tables, and only speed up writing from a single connection
+	if ([head isMatchedByRegex:SPSQLImportTableLockRegex]) return YES;
+
+	// Inserts into a table with triggers may write to any other table, so run in order with all other statements
+	if ([head isMatchedByRegex:SPSQLImportTriggerRegex]) {
+		NSString *triggerTable = [head stringByMatching:SPSQLImportTriggerTableRegex capture:1L];
+
+		if (!triggerTable) {
+			[self _fallBackToSerialExecution:NSLocalizedString(@"the file creates triggers", @"sql import : parallel import stopped because of triggers")];
+
+			return NO;
+		}
+
+		[triggerTables addObject:SPSQLImportTableKey(triggerTable)];
+		[self waitUntilAllStatementsExecuted];
+
+		return NO;
+	}
+
+	// Temporary tables can't be seen by the other connections, so all their statements run on the parent connection
+	NSArray *temporaryTableComponents = [head captureComponentsMatchedByRegex:SPSQLImportTemporaryTableRegex];
+
+	if ([temporaryTableComponents count] == 3) {
+		NSString *temporaryTable = SPSQLImportTableKey([temporaryTableComponents objectAtIndex:2]);
+
+		if ([[temporaryTableComponents objectAtIndex:1] caseInsensitiveCompare:@"CREATE"] == NSOrderedSame) {
+			[temporaryTables addObject:temporaryTable];
+		}
+		else {
+			[temporaryTables removeObject:temporaryTable];
+		}
+
+		[self waitUntilAllStatementsExecuted];
+
+		return NO;
+	}
+
+	NSString *table = [head stringByMatching:SPSQLImportInsertRegex capture:1L];
+
+	table = (table) ? SPSQLImportTableKey(table) : [[self class] tableDefinedByStatement:statement];
+
+	// Any other statement runs once everything before it has been executed
+	if (!table || [triggerTables containsObject:table] || [temporaryTables containsObject:table]) {
+		[self waitUntilAllStatementsExecuted];
+
+		return NO;
+	}
+
+	// With foreign key checks enabled, writes to one table depend on the data of others
+	if (!foreignKeyChecksDisabled) {
+		[self _fallBackToSerialExecution:NSLocalizedString(@"foreign key checks are enabled", @"sql import : parallel import stopped because of foreign key checks")];
+
+		return NO;
+	}
+
+	[self _queueStatement:statement table:table statementNumber:statementNumber];
+
+	return YES;
+}
+
+/**
+ * Wait until every queued statement has been executed.
+ */
+- (void)waitUntilAllStatementsExecuted
+{
+	[dispatchCondition lock];
+
+	while ([outstandingTables count] && !cancelled) [dispatchCondition wait];
+
+	[dispatchCondition unlock];
+}
+
+/**
+ * Returns the errors of the statements executed since the last call, in the order they occurred,
+ * as dictionaries of the statement number and error message.
+ */
+- (NSArray *)takeErrors
+{
+	NSArray *takenErrors;
+
+	[dispatchCondition lock];
+
+	takenErrors = [NSArray arrayWithArray:errors];
+	[errors removeAllObjects];
+
+	[dispatchCondition unlock];
+
+	return takenErrors;
+}
+
+/**
+ * Returns why statements are no longer being dispatched, if the dispatcher has fallen back to
+ * serial execution.
+ */
+- (NSString *)serialFallbackReason
+{
+	return serialFallbackReason;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Queue a statement for execution after the table's earlier statements, waiting if the queue is full.
+ */
+- (void)_queueStatement:(NSString *)statement table:(NSString *)table statementNumber:(NSInteger)statementNumber
+{
+	NSUInteger maximumQueuedStatements = [connections count] * SPSQLImportTableDispatcherQueuedStatementsPerConnection;
+
+	[dispatchCondition lock];
+
+	while ([queuedStatements count] >= maximumQueuedStatements && !cancelled) [dispatchCondition wait];
+
+	if (!cancelled) {
+		SPSQLImportTableStatement *tableStatement = [[SPSQLImportTableStatement alloc] initWithStatement:statement table:table statementNumber:statementNumber sessionStatementCount:[sessionStatements count]];
+
+		[queuedStatements addObject:tableStatement];
+		[outstandingTables addObject:table];
+		[dispatchCondition broadcast];
+
+		[tableStatement release];
+	}
+
+	[dispatchCondition unlock];
+}
+
+/**
+ * Stop dispatching statements once the queued ones have been executed, leaving the caller to execute
+ * the rest of the file in order.
+ */
+- (void)_fallBackToSerialExecution:(NSString *)reason
+{
+	[self waitUntilAllStatementsExecuted];
+	[self close];
+
+	if (!serialFallbackReason) serialFallbackReason = [reason copy];
+}
+
+/**
+ * Execute queued statements on a connection until the dispatcher is closed.  A statement is only
+ * taken while no other connection is executing a statement of its table, so each table's statements
+ * are executed one at a time in the order they were queued.
+ */
+- (void)_executeStatementsOnConnection:(SPMySQLConnection *)connection
+{
+	NSAutoreleasePool *threadPool = [[NSAutoreleasePool alloc] init];
+	NSUInteger executedSessionStatementCount = 0;
+
+	[dispatchCondition lock];
+
+	while (1)
+	{
+		SPSQLImportTableStatement *tableStatement = nil;
+
+		while (!cancelled) {
+			for (SPSQLImportTableStatement *queuedStatement in queuedStatements)
+			{
+				if (![executingTables containsObject:[queuedStatement table]]) {
+					tableStatement = queuedStatement;
+					break;
+				}
+			}
+
+			if (tableStatement) break;
+
+			[dispatchCondition wait];
+		}
+
+		if (!tableStatement) break;
+
+		[tableStatement retain];
+		[queuedStatements removeObjectIdenticalTo:tableStatement];
+		[executingTables addObject:[tableStatement table]];
+
+		// Queueing may continue now a statement has been taken
+		[dispatchCondition broadcast];
+
+		NSArray *replayedStatements = [sessionStatements subarrayWithRange:NSMakeRange(executedSessionStatementCount, [tableStatement sessionStatementCount] - executedSessionStatementCount)];
+
+		[dispatchCondition unlock];
+
+		NSAutoreleasePool *statementPool = [[NSAutoreleasePool alloc] init];
+
+		// Bring the session up to date with the parent's session when the statement was read; any
+		// errors were already reported when the parent connection executed the statements
+		for (NSString *sessionStatement in replayedStatements)
+		{
+			[connection queryString:sessionStatement usingEncoding:stringEncoding withResultType:SPMySQLResultAsResult];
+		}
+
+		executedSessionStatementCount = [tableStatement sessionStatementCount];
+
+		[connection queryString:[tableStatement statement] usingEncoding:stringEncoding withResultType:SPMySQLResultAsResult];
+
+		NSDictionary *error = nil;
+
+		if ([connection queryErrored] && ![[connection lastErrorMessage] isEqualToString:@"Query was empty"]) {
+			error = @{
+				@"statementNumber" : @([tableStatement statementNumber]),
+				@"message" : [connection lastErrorMessage]
+			};
+		}
+
+		[dispatchCondition lock];
+
+		if (error) [errors addObject:error];
+
+		[executingTables removeObject:[tableStatement table]];
+		[outstandingTables removeObject:[tableStatement table]];
+		[dispatchCondition broadcast];
+
+		[tableStatement release];
+		[statementPool drain];
+	}
+
+	activeThreads--;
+	[dispatchCondition broadcast];
+	[dispatchCondition unlock];
+
+	[threadPool drain];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	[self close];
+
+	SPClear(parentConnection);
+	SPClear(connections);
+	SPClear(dispatchCondition);
+	SPClear(queuedStatements);
+	SPClear(outstandingTables);
+	SPClear(executingTables);
+	SPClear(sessionStatements);
+	SPClear(errors);
+	SPClear(triggerTables);
+	SPClear(temporaryTables);
+	if (serialFallbackReason) SPClear(serialFallbackReason);
+
+	[super dealloc];
+}
+
+@end
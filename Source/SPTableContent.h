@@ -149,6 +149,12 @@ typedef NS_ENUM(NSInteger, SPTableContentFilterSource) {
 	NSUInteger tableLoadTimerTicksSinceLastUpdate;
 	NSUInteger tableLoadLastRowCount;
 	NSUInteger tableLoadTargetRowCount;
+	NSString *incrementalRefreshTimestamp;
+	NSIndexSet *previewedColumnIndexes;
+	NSMutableIndexSet *pendingFullValueRows;
+	SPMySQLConnection *fullValueConnection;
+	pthread_mutex_t fullValueConnectionLock;
+	NSMutableDictionary *pendingRowEdits;
 
 	NSArray *cqColumnDefinition;
 	BOOL isFirstChangeInView;
@@ -251,6 +257,15 @@ typedef NS_ENUM(NSInteger, SPTableContentFilterSource) {
 - (void)updateNumberOfRows;
 - (void)autosizeColumns;
 - (BOOL)saveRowOnDeselect;
+
+// Deferred row edits
+- (NSUInteger)numberOfPendingRowEdits;
+- (BOOL)commitPendingRowEdits;
+- (void)discardPendingRowEdits;
+- (IBAction)commitPendingRowEdits:(id)sender;
+- (IBAction)discardPendingRowEdits:(id)sender;
+- (IBAction)toggleDeferredRowEdits:(id)sender;
+
 - (void)sortTableTaskWithColumn:(NSTableColumn *)tableColumn;
 - (void)showErrorSheetWith:(NSArray *)error;
 - (void)processFieldEditorResult:(id)data contextInfo:(NSDictionary*)contextInfo;
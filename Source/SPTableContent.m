@@ -44,6 +44,8 @@
 #import "SPTooltip.h"
 #import "RegexKitLite.h"
 #import "SPDataStorage.h"
+#import "SPTableContentRefreshPatch.h"
+#import "SPPendingRowEditStatements.h"
 #import "SPAlertSheets.h"
 #import "SPHistoryController.h"
 #import "SPGeometryDataView.h"
@@ -99,10 +101,11 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 
 @end
 
-@interface SPTableContent ()
+@interface SPTableContent () <SPMySQLConnectionDelegate>
 
 - (BOOL)cancelRowEditing;
 - (void)documentWillClose:(NSNotification *)notification;
+- (void)tableInfoChanged:(NSNotification *)notification;
 
 - (void)updateFilterRuleEditorSize:(CGFloat)requestedHeight animate:(BOOL)animate;
 - (void)filterRuleEditorPreferredSizeChanged:(NSNotification *)notification;
@@ -110,6 +113,30 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 - (void)setRuleEditorVisible:(BOOL)show animate:(BOOL)animate;
 
 - (void)_setViewBlankState;
+- (void)_restoreSelectionIndexes;
+
+- (void)_reloadTableTaskAllowingIncrementalRefresh:(NSNumber *)allowIncrementalRefresh;
+- (NSString *)_incrementalRefreshTimestampColumn;
+- (BOOL)_refreshTableIncrementally;
+- (NSString *)_escapedKeyValue:(id)aValue forColumn:(NSString *)columnName;
+
+#ifndef SP_CODA
+- (NSIndexSet *)_columnIndexesToPreview;
+- (NSString *)_fieldListForQueryPreviewingColumns:(NSIndexSet *)columnIndexes;
+- (void)_queueFullValueFetchForRow:(NSUInteger)rowIndex;
+- (void)_fetchPendingFullValues;
+- (void)_fetchFullValuesTask:(NSDictionary *)fetchDetails;
+- (BOOL)_ensureFullValueConnectionForDatabase:(NSString *)databaseName;
+#endif
+
+- (BOOL)_defersRowEditCommits;
+- (BOOL)_saveRowAndPendingRowEditsAskingUser:(BOOL)askUser;
+- (BOOL)_commitPendingRowEditsAskingUser:(BOOL)askUser;
+- (BOOL)_saveRowOnSelectionChange;
+- (BOOL)_queueEditedRow;
+- (void)_getFieldsToSave:(NSMutableArray *)rowFieldsToSave values:(NSMutableArray *)rowValuesToSave forRow:(NSUInteger)rowIndex originalRow:(NSArray *)originalRow;
+- (SPPendingRowEditStatements *)_statementsForPendingRowEdits;
+- (void)pendingRowEditsErrorSheetDidEnd:(NSAlert *)alert returnCode:(NSInteger)returnCode contextInfo:(void *)contextInfo;
 
 #pragma mark - SPTableContentDataSource_Private_API
 
@@ -142,6 +169,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		isWorking = NO;
 		
 		pthread_mutex_init(&tableValuesLock, NULL);
+		pthread_mutex_init(&fullValueConnectionLock, NULL);
 
 		tableValues       = [[SPDataStorage alloc] init];
 		dataColumns       = [[NSMutableArray alloc] init];
@@ -186,6 +214,11 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		usedQuery = [[NSString alloc] initWithString:@""];
 
 		tableLoadTimer = nil;
+		incrementalRefreshTimestamp = nil;
+		previewedColumnIndexes = nil;
+		pendingFullValueRows = [[NSMutableIndexSet alloc] init];
+		fullValueConnection = nil;
+		pendingRowEdits = [[NSMutableDictionary alloc] init];
 
 		textForegroundColor  = [NSColor controlTextColor]; // this color dynamically adapts to the rest of the UI
 		nullHighlightColor   = [NSColor lightGrayColor];
@@ -280,6 +313,12 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	                                         selector:@selector(documentWillClose:)
 	                                             name:SPDocumentWillCloseNotification
 	                                           object:tableDocumentInstance];
+
+	// Pick up exact row counts retrieved in the background
+	[[NSNotificationCenter defaultCenter] addObserver:self
+	                                         selector:@selector(tableInfoChanged:)
+	                                             name:SPTableInfoChangedNotification
+	                                           object:tableDocumentInstance];
 }
 
 #pragma mark -
@@ -443,6 +482,9 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	// Reset table key store for use in argumentForRow:
 	if (keys) SPClear(keys);
 
+	// Any queued row edits belong to the previous table contents, which have been saved or discarded
+	[pendingRowEdits removeAllObjects];
+
 	// Check the supplied table name.  If it matches the old one, a reload is being performed;
 	// reload the data in-place to maintain table state if possible.
 	if ([selectedTable isEqualToString:newTableName]) {
@@ -735,13 +777,27 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 
 	// Add a filter string if appropriate
 	filterString = [[self onMainThread] tableFilterString];
-	
+
+	// Load previews of blob and text columns where possible, rather than omitting them entirely;
+	// previews would affect the results of DISTINCT queries, so skip them there.
+	NSIndexSet *columnIndexesToPreview = nil;
+#ifndef SP_CODA
+	if (!(activeFilter == SPTableContentFilterSourceTableFilter && filterString && [filterTableController isDistinct])) {
+		columnIndexesToPreview = [self _columnIndexesToPreview];
+	}
+#endif
+	if (previewedColumnIndexes) SPClear(previewedColumnIndexes);
+	previewedColumnIndexes = [columnIndexesToPreview retain];
+
 	// Start construction of the query string
 	queryString = [NSMutableString stringWithFormat:@"SELECT %@%@ FROM %@", 
 #ifndef SP_CODA
 			(activeFilter == SPTableContentFilterSourceTableFilter && filterString && [filterTableController isDistinct]) ? @"DISTINCT " :
 #endif
 			@"", 
+#ifndef SP_CODA
+			[columnIndexesToPreview count] ? [self _fieldListForQueryPreviewingColumns:columnIndexesToPreview] :
+#endif
 			[self fieldListForQuery], [selectedTable backtickQuotedString]];
 
 	if ([filterString length]) {
@@ -786,12 +842,19 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	// Perform and process the query
 	[tableContentView performSelectorOnMainThread:@selector(noteNumberOfRowsChanged) withObject:nil waitUntilDone:YES];
 	[self setUsedQuery:queryString];
+
+	// If the table can be refreshed incrementally later, note the server time before loading
+	if (incrementalRefreshTimestamp) SPClear(incrementalRefreshTimestamp);
+	if ([self _incrementalRefreshTimestampColumn]) {
+		incrementalRefreshTimestamp = [[mySQLConnection getFirstFieldFromQuery:@"SELECT NOW()"] retain];
+	}
+
 	resultStore = [[mySQLConnection resultStoreFromQueryString:queryString] retain];
 
 	// Ensure the number of columns are unchanged; if the column count has changed, abort the load
 	// and queue a full table reload.
 	BOOL fullTableReloadRequired = NO;
-	if (resultStore && [dataColumns count] != [resultStore numberOfFields]) {
+	if (resultStore && [dataColumns count] + [previewedColumnIndexes count] != [resultStore numberOfFields]) {
 		[tableDocumentInstance disableTaskCancellation];
 		[mySQLConnection cancelCurrentQuery];
 		[resultStore cancelResultLoad];
@@ -826,69 +889,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	[tableDocumentInstance disableTaskCancellation];
 
 	// Restore selection indexes if appropriate
-	if (selectionToRestore) {
-		BOOL previousTableRowsSelectable = tableRowsSelectable;
-		tableRowsSelectable = YES;
-		NSMutableIndexSet *selectionSet = [NSMutableIndexSet indexSet];
-
-		// Currently two types of stored selection are supported: primary keys and direct index sets.
-		if ([[selectionToRestore objectForKey:@"type"] isEqualToString:SPSelectionDetailTypePrimaryKeyed]) {
-
-			// Check whether the keys are still present and get their positions
-			BOOL columnsFound = YES;
-			NSArray *primaryKeyFieldNames = [selectionToRestore objectForKey:@"keys"];
-			NSUInteger primaryKeyFieldCount = [primaryKeyFieldNames count];
-			NSUInteger *primaryKeyFieldIndexes = calloc(primaryKeyFieldCount, sizeof(NSUInteger));
-			for (NSUInteger i = 0; i < primaryKeyFieldCount; i++) {
-				primaryKeyFieldIndexes[i] = [[tableDataInstance columnNames] indexOfObject:[primaryKeyFieldNames objectAtIndex:i]];
-				if (primaryKeyFieldIndexes[i] == NSNotFound) {
-					columnsFound = NO;
-				}
-			}
-
-			// Only proceed with reselection if all columns were found
-			if (columnsFound && primaryKeyFieldCount) {
-				NSDictionary *selectionKeysToRestore = [selectionToRestore objectForKey:@"rows"];
-				NSUInteger rowsToSelect = [selectionKeysToRestore count];
-				BOOL rowMatches = NO;
-
-				for (NSUInteger i = 0; i < tableRowsCount; i++) {
-
-					// For single-column primary keys look up the cell value in the dictionary for a match
-					if (primaryKeyFieldCount == 1) {
-						if ([selectionKeysToRestore objectForKey:SPDataStorageObjectAtRowAndColumn(tableValues, i, primaryKeyFieldIndexes[0])]) {
-							rowMatches = YES;
-						}
-
-					// For multi-column primary keys, convert all the cells to a string for lookup.
-					} else {
-						NSMutableString *lookupString = [[NSMutableString alloc] initWithString:[SPDataStorageObjectAtRowAndColumn(tableValues, i, primaryKeyFieldIndexes[0]) description]];
-						for (NSUInteger j = 1; j < primaryKeyFieldCount; j++) {
-							[lookupString appendString:SPUniqueSchemaDelimiter];
-							[lookupString appendString:[SPDataStorageObjectAtRowAndColumn(tableValues, i, primaryKeyFieldIndexes[j]) description]];
-						}
-						if ([selectionKeysToRestore objectForKey:lookupString]) rowMatches = YES;
-						[lookupString release];
-					}
-					
-					if (rowMatches) {
-						[selectionSet addIndex:i];
-						rowsToSelect--;
-						if (rowsToSelect <= 0) break;
-						rowMatches = NO;
-					}
-				}
-			}
-
-			free(primaryKeyFieldIndexes);
-
-		} else if ([[selectionToRestore objectForKey:@"type"] isEqualToString:SPSelectionDetailTypeIndexed]) {
-			selectionSet = [selectionToRestore objectForKey:@"rows"];
-		}
-
-		[[tableContentView onMainThread] selectRowIndexes:selectionSet byExtendingSelection:NO];
-		tableRowsSelectable = previousTableRowsSelectable;
-	}
+	[self _restoreSelectionIndexes];
 
 	if ([prefs boolForKey:SPLimitResults] && (contentPage > 1 || (NSInteger)tableRowsCount == [prefs integerForKey:SPLimitResultsValue]))
 	{
@@ -947,6 +948,77 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	}
 }
 
+/**
+ * Restores the stored selection (see -setSelectionToRestore:) against the currently
+ * loaded rows, looking rows up by primary key where possible.
+ */
+- (void)_restoreSelectionIndexes
+{
+	if (!selectionToRestore) return;
+
+	BOOL previousTableRowsSelectable = tableRowsSelectable;
+	tableRowsSelectable = YES;
+	NSMutableIndexSet *selectionSet = [NSMutableIndexSet indexSet];
+
+	// Currently two types of stored selection are supported: primary keys and direct index sets.
+	if ([[selectionToRestore objectForKey:@"type"] isEqualToString:SPSelectionDetailTypePrimaryKeyed]) {
+
+		// Check whether the keys are still present and get their positions
+		BOOL columnsFound = YES;
+		NSArray *primaryKeyFieldNames = [selectionToRestore objectForKey:@"keys"];
+		NSUInteger primaryKeyFieldCount = [primaryKeyFieldNames count];
+		NSUInteger *primaryKeyFieldIndexes = calloc(primaryKeyFieldCount, sizeof(NSUInteger));
+		for (NSUInteger i = 0; i < primaryKeyFieldCount; i++) {
+			primaryKeyFieldIndexes[i] = [[tableDataInstance columnNames] indexOfObject:[primaryKeyFieldNames objectAtIndex:i]];
+			if (primaryKeyFieldIndexes[i] == NSNotFound) {
+				columnsFound = NO;
+			}
+		}
+
+		// Only proceed with reselection if all columns were found
+		if (columnsFound && primaryKeyFieldCount) {
+			NSDictionary *selectionKeysToRestore = [selectionToRestore objectForKey:@"rows"];
+			NSUInteger rowsToSelect = [selectionKeysToRestore count];
+			BOOL rowMatches = NO;
+
+			for (NSUInteger i = 0; i < tableRowsCount; i++) {
+
+				// For single-column primary keys look up the cell value in the dictionary for a match
+				if (primaryKeyFieldCount == 1) {
+					if ([selectionKeysToRestore objectForKey:SPDataStorageObjectAtRowAndColumn(tableValues, i, primaryKeyFieldIndexes[0])]) {
+						rowMatches = YES;
+					}
+
+				// For multi-column primary keys, convert all the cells to a string for lookup.
+				} else {
+					NSMutableString *lookupString = [[NSMutableString alloc] initWithString:[SPDataStorageObjectAtRowAndColumn(tableValues, i, primaryKeyFieldIndexes[0]) description]];
+					for (NSUInteger j = 1; j < primaryKeyFieldCount; j++) {
+						[lookupString appendString:SPUniqueSchemaDelimiter];
+						[lookupString appendString:[SPDataStorageObjectAtRowAndColumn(tableValues, i, primaryKeyFieldIndexes[j]) description]];
+					}
+					if ([selectionKeysToRestore objectForKey:lookupString]) rowMatches = YES;
+					[lookupString release];
+				}
+				
+				if (rowMatches) {
+					[selectionSet addIndex:i];
+					rowsToSelect--;
+					if (rowsToSelect <= 0) break;
+					rowMatches = NO;
+				}
+			}
+		}
+
+		free(primaryKeyFieldIndexes);
+
+	} else if ([[selectionToRestore objectForKey:@"type"] isEqualToString:SPSelectionDetailTypeIndexed]) {
+		selectionSet = [selectionToRestore objectForKey:@"rows"];
+	}
+
+	[[tableContentView onMainThread] selectRowIndexes:selectionSet byExtendingSelection:NO];
+	tableRowsSelectable = previousTableRowsSelectable;
+}
+
 /**
  * Processes a supplied streaming result store, monitoring the load and updating the data
  * displayed during download.
@@ -961,6 +1033,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	pthread_mutex_lock(&tableValuesLock);
 	tableRowsCount = 0;
 	[tableValues setDataStorage:theResultStore updatingExisting:!![tableValues count]];
+	if ([previewedColumnIndexes count]) [tableValues setColumnsAsPreviewed:previewedColumnIndexes previewLength:SPDeferredColumnPreviewLength];
 	pthread_mutex_unlock(&tableValuesLock);
 
 	// Start the data downloading
@@ -977,7 +1050,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	// Set the column load states on the table values store
 	if ([prefs boolForKey:SPLoadBlobsAsNeeded]) {
 		for ( i = 0; i < dataColumnsCount ; i++ ) {
-			if ([tableDataInstance columnIsBlobOrText:[NSArrayObjectAtIndex(dataColumns, i) objectForKey:@"name"]]) {
+			if (![previewedColumnIndexes containsIndex:i] && [tableDataInstance columnIsBlobOrText:[NSArrayObjectAtIndex(dataColumns, i) objectForKey:@"name"]]) {
 				[tableValues setColumnAsUnloaded:i];
 			}
 		}
@@ -1105,6 +1178,16 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		[countString appendFormat:NSLocalizedString(@"%@ %@ selected", @"text showing how many rows are selected"), [numberFormatter stringFromNumber:[NSNumber numberWithInteger:selectedRows]], rowString];
 	}
 
+	// If edited rows are waiting to be committed, append the pending count
+	NSUInteger pendingRowEditCount = [pendingRowEdits count];
+	if (pendingRowEditCount) {
+		[countString appendString:@"; "];
+		if (pendingRowEditCount == 1)
+			[countString appendFormat:NSLocalizedString(@"%@ edited row not yet saved", @"text showing a single edited row waiting to be committed"), [numberFormatter stringFromNumber:[NSNumber numberWithUnsignedInteger:pendingRowEditCount]]];
+		else
+			[countString appendFormat:NSLocalizedString(@"%@ edited rows not yet saved", @"text showing how many edited rows are waiting to be committed"), [numberFormatter stringFromNumber:[NSNumber numberWithUnsignedInteger:pendingRowEditCount]]];
+	}
+
 #ifndef SP_CODA
 	[countText setStringValue:countString];
 #endif
@@ -1203,35 +1286,52 @@ static void *TableContentKVOContext = &TableContentKVOContext;
  * Reloads the current table data, performing a new SQL query. Now attempts to preserve sort
  * order, filters, and viewport. Performs the action in a new thread if a task is not already
  * running.
+ *
+ * When triggered by the user, only the changed rows are transferred if the table supports
+ * it (see -_refreshTableIncrementally); holding down Option forces a full reload.
  */
 - (IBAction)reloadTable:(id)sender
 {
+	BOOL allowIncrementalRefresh = NO;
+	if (sender != self && [NSThread isMainThread]) {
+		allowIncrementalRefresh = !([[NSApp currentEvent] modifierFlags] & NSEventModifierFlagOption);
+	}
+
 	[tableDocumentInstance startTaskWithDescription:NSLocalizedString(@"Reloading data...", @"Reloading data task description")];
 
 	if ([NSThread isMainThread]) {
-		[NSThread detachNewThreadWithName:SPCtxt(@"SPTableContent table reload task", tableDocumentInstance) target:self selector:@selector(reloadTableTask) object:nil];
+		[NSThread detachNewThreadWithName:SPCtxt(@"SPTableContent table reload task", tableDocumentInstance) target:self selector:@selector(_reloadTableTaskAllowingIncrementalRefresh:) object:@(allowIncrementalRefresh)];
 	} else {
 		[self reloadTableTask];
 	}
 }
 
 - (void)reloadTableTask
+{
+	[self _reloadTableTaskAllowingIncrementalRefresh:@NO];
+}
+
+- (void)_reloadTableTaskAllowingIncrementalRefresh:(NSNumber *)allowIncrementalRefresh
 {
 	@autoreleasepool {
 		// Check whether a save of the current row is required, abort if pending changes couldn't be saved.
 		if ([[self onMainThread] saveRowOnDeselect]) {
 
-			// Save view details to restore safely if possible (except viewport, which will be
-			// preserved automatically, and can then be scrolled as the table loads)
-			[[self onMainThread] storeCurrentDetailsForRestoration];
-			[self setViewportToRestore:NSZeroRect];
+			// Try to patch the loaded data in place, falling back to a full reload
+			if (![allowIncrementalRefresh boolValue] || ![self _refreshTableIncrementally]) {
+
+				// Save view details to restore safely if possible (except viewport, which will be
+				// preserved automatically, and can then be scrolled as the table loads)
+				[[self onMainThread] storeCurrentDetailsForRestoration];
+				[self setViewportToRestore:NSZeroRect];
 
-			// Clear the table data column cache and status (including counts)
-			[tableDataInstance resetColumnData];
-			[tableDataInstance resetStatusData];
+				// Clear the table data column cache and status (including counts)
+				[tableDataInstance resetColumnData];
+				[tableDataInstance resetStatusData];
 
-			// Load the table's data
-			[self loadTable:[tablesListInstance tableName]];
+				// Load the table's data
+				[self loadTable:[tablesListInstance tableName]];
+			}
 		}
 
 		[tableDocumentInstance endTask];
@@ -1473,154 +1573,599 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 }
 
 #pragma mark -
-#pragma mark Pagination
+#pragma mark Incremental refresh
 
 /**
- * Move the pagination backwards or forwards one page, or update
- * the page to respect the submitted field.
+ * Returns the name of a column the server updates automatically whenever a row changes
+ * (ON UPDATE CURRENT_TIMESTAMP), or nil if the current table has none.
  */
-- (IBAction) navigatePaginationFromButton:(id)sender
+- (NSString *)_incrementalRefreshTimestampColumn
 {
-	if (![self saveRowOnDeselect]) return;
+	if ([tablesListInstance tableType] != SPTableTypeTable) return nil;
 
-	if (sender == paginationPreviousButton) {
-		if (contentPage <= 1) return;
-		[paginationViewController setPage:@(contentPage - 1)];
-	} else if (sender == paginationNextButton) {
-		if ((NSInteger)contentPage * [prefs integerForKey:SPLimitResultsValue] >= maxNumRows) return;
-		[paginationViewController setPage:@(contentPage + 1)];
+	for (NSDictionary *column in dataColumns) {
+		if ([[column objectForKey:@"onupdatetimestamp"] boolValue]) return [column objectForKey:@"name"];
 	}
 
-	[self filterTable:sender];
+	return nil;
 }
 
 /**
- * When the Pagination button is pressed, show or hide the pagination
- * layer depending on the current state.
+ * Brings the loaded table data up to date by transferring only the rows which have
+ * changed since the last load instead of re-running the full query.
+ *
+ * Rows are identified by primary key.  Changed and inserted rows are found using the table's
+ * auto-updating timestamp column, looking back SPIncrementalRefreshOverlapSeconds before the
+ * last server time noted so that rows committed late by longer transactions aren't missed.
+ * Deleted rows are found by diffing the loaded keys against the primary keys now on the
+ * server, which only transfers the key columns; rows inserted with older timestamps show up in
+ * the same diff and fall back to a full reload.  The existing data store is patched in place,
+ * which preserves the scroll position, and the selection is restored by primary key.
+ *
+ * Returns NO without touching the loaded data if the table or the current view state
+ * doesn't allow an incremental refresh, in which case a full reload is required.
  */
-#ifndef SP_CODA
-- (IBAction) togglePagination:(NSButton *)sender
+- (BOOL)_refreshTableIncrementally
 {
-	[self setPaginationViewVisibility:([sender state] == NSOnState)];
-}
+	NSString *timestampColumn = [self _incrementalRefreshTimestampColumn];
+	NSArray *primaryKeyFieldNames = [tableDataInstance primaryKeyColumnNames];
+
+	// Only fully loaded, unpaginated and unsorted results can be patched - new rows are simply appended
+	if (!selectedTable || !incrementalRefreshTimestamp || !timestampColumn || !primaryKeyFieldNames) return NO;
+	if (isEditingRow || isInterruptedLoad || isLimited || contentPage > 1 || sortCol || ![tableValues dataDownloaded]) return NO;
+#ifndef SP_CODA
+	if (activeFilter == SPTableContentFilterSourceTableFilter && [filterTableController isDistinct]) return NO;
 #endif
 
-- (void)popoverDidClose:(NSNotification *)notification
-{
-	//not to hide the view, but to change the paginationButton
-	[self setPaginationViewVisibility:NO];
-}
+	// Look up the key columns, which must all be loaded in full rather than as previews
+	NSMutableArray *primaryKeyFieldIndexes = [NSMutableArray arrayWithCapacity:[primaryKeyFieldNames count]];
+	for (NSString *keyName in primaryKeyFieldNames) {
+		NSUInteger keyIndex = [[tableDataInstance columnNames] indexOfObject:keyName];
+		if (keyIndex == NSNotFound || [previewedColumnIndexes containsIndex:keyIndex]) return NO;
+		[primaryKeyFieldIndexes addObject:@(keyIndex)];
+	}
 
-/**
- * Show or hide the pagination layer, also changing the first responder as appropriate.
- */
-- (void) setPaginationViewVisibility:(BOOL)makeVisible
-{
-#ifndef SP_CODA
-	NSRect paginationViewFrame = [paginationView frame];
-	
-	if(makeVisible) {
-		[paginationButton setState:NSOnState];
-		[paginationButton setImage:[NSImage imageNamed:@"button_action"]];
-		[paginationViewController makeInputFirstResponder];
+	NSString *tableName = [selectedTable backtickQuotedString];
+	NSString *filterString = [[self onMainThread] tableFilterString];
+	NSString *filterClause = [filterString length] ? [NSString stringWithFormat:@" AND (%@)", filterString] : @"";
+
+	NSMutableArray *quotedKeyNames = [NSMutableArray arrayWithCapacity:[primaryKeyFieldNames count]];
+	for (NSString *keyName in primaryKeyFieldNames) {
+		[quotedKeyNames addObject:[keyName backtickQuotedString]];
 	}
-	else {
-		[paginationButton setState:NSOffState];
-		[paginationButton setImage:[NSImage imageNamed:@"button_pagination"]];
-		// TODO This is only relevant in 10.6 legacy mode.
-		// When using a modern NSPopover, the view controller's parent window is an _NSPopoverWindow,
-		// not the SP window and we don't care what the first responder in the popover is.
-		// (when it is not being displayed anyway).
-		if (!paginationPopover && [paginationViewController isFirstResponderInside]) {
-			[[[paginationViewController view] window] makeFirstResponder:nil];
-		}
+
+	[tableDocumentInstance enableTaskCancellationWithTitle:NSLocalizedString(@"Stop", @"stop button") callbackObject:nil callbackFunction:NULL];
+
+	// Note the server time first; the overlap window of the next refresh covers any rows changed from here on
+	NSString *refreshTimestamp = [mySQLConnection getFirstFieldFromQuery:@"SELECT NOW()"];
+
+	// Fetch the rows changed since the last load.  Previewed blob and text columns are fetched
+	// in full, as replaced rows are held as edited rows which can't carry previews.
+	SPMySQLResult *rowResult = nil;
+	if (refreshTimestamp && ![mySQLConnection queryErrored]) {
+		rowResult = [mySQLConnection queryString:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ >= %@ - INTERVAL %lu SECOND%@", tableName, [timestampColumn backtickQuotedString], [mySQLConnection escapeAndQuoteString:incrementalRefreshTimestamp], (unsigned long)SPIncrementalRefreshOverlapSeconds, filterClause]];
 	}
-	
-	if(paginationPopover) {
-		if(makeVisible) {
-			[paginationPopover showRelativeToRect:[paginationButton bounds] ofView:paginationButton preferredEdge:NSMinYEdge];
-		}
-		else if([paginationPopover isShown]) {
-			//usually this should not happen, as the popover will disappear once the user clicks somewhere
-			//else in the window (including the paginationButton).
-			[paginationPopover close];
-		}
-		return;
+
+	// Abort on errors, or if the table structure has changed in the meantime
+	if (!rowResult || [mySQLConnection queryErrored] || [mySQLConnection lastQueryWasCancelled] || [rowResult numberOfFields] != [dataColumns count]) {
+		[tableDocumentInstance disableTaskCancellation];
+		return NO;
 	}
-	
-	if (makeVisible) {
-		if (paginationViewFrame.size.height == paginationViewHeight) return;
-		paginationViewFrame.size.height = paginationViewHeight;
-	} else {
-		if (paginationViewFrame.size.height == 0) return;
-		paginationViewFrame.size.height = 0;
+	[rowResult setDefaultRowReturnType:SPMySQLResultRowAsArray];
+
+	SPTableContentRefreshPatch *patch = [[[SPTableContentRefreshPatch alloc] initWithLoadedRows:(id <SPTableContentRefreshPatchRows>)tableValues keyColumnIndexes:primaryKeyFieldIndexes] autorelease];
+	for (NSArray *row in rowResult) {
+		[patch addChangedRow:row];
 	}
 
-	[[paginationView animator] setFrame:paginationViewFrame];
-#endif
+	// Fetch the keys of every matching row, which can usually be read from the primary key
+	// alone; loaded rows missing from the list have been deleted, and listed rows which are
+	// neither loaded nor changed were missed by the timestamp window.
+	SPMySQLResult *keyResult = [mySQLConnection queryString:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE 1%@", [quotedKeyNames componentsJoinedByString:@", "], tableName, filterClause]];
+
+	[tableDocumentInstance disableTaskCancellation];
+
+	if (!keyResult || [mySQLConnection queryErrored] || [mySQLConnection lastQueryWasCancelled]) return NO;
+	[keyResult setDefaultRowReturnType:SPMySQLResultRowAsArray];
+
+	for (NSArray *keyRow in keyResult) {
+		[patch addServerKeyRow:keyRow];
+	}
+
+	if (![patch calculatePatch]) return NO;
+
+	NSDictionary *rowsToReplace = [patch rowsToReplace];
+	NSArray *rowsToAdd = [patch rowsToAdd];
+	NSIndexSet *rowIndexesToRemove = [patch rowIndexesToRemove];
+
+	// Appending rows to the first page of limited results could exceed the page size
+	if ([rowsToAdd count] && [prefs boolForKey:SPLimitResults] && [tableValues count] - [rowIndexesToRemove count] + [rowsToAdd count] > (NSUInteger)[prefs integerForKey:SPLimitResultsValue]) return NO;
+
+	[incrementalRefreshTimestamp release];
+	incrementalRefreshTimestamp = [refreshTimestamp retain];
+
+	// Nothing to do if the table hasn't changed
+	if ([patch isEmpty]) return YES;
+
+	[self setSelectionToRestore:[[self onMainThread] selectionDetailsAllowingIndexSelection:NO]];
+
+	// Patch the data store on the main thread, so the table view never sees it half-updated.
+	// Replaced row indexes refer to the rows before any are removed, so replace rows first.
+	SPMainQSync(^{
+		pthread_mutex_lock(&tableValuesLock);
+		for (NSNumber *rowIndex in rowsToReplace) {
+			SPDataStorageReplaceRow(tableValues, [rowIndex unsignedIntegerValue], [rowsToReplace objectForKey:rowIndex]);
+		}
+		[rowIndexesToRemove enumerateIndexesWithOptions:NSEnumerationReverse usingBlock:^(NSUInteger rowIndex, BOOL *stop) {
+			[tableValues removeRowAtIndex:rowIndex];
+		}];
+		for (NSArray *row in rowsToAdd) {
+			SPDataStorageAddRow(tableValues, row);
+		}
+		tableRowsCount = [tableValues count];
+		pthread_mutex_unlock(&tableValuesLock);
+
+		[tableContentView noteNumberOfRowsChanged];
+		[tableContentView reloadData];
+	});
+
+	[self _restoreSelectionIndexes];
+	[self setSelectionToRestore:nil];
+
+	[self updateNumberOfRows];
+
+	SPMainQSync(^{
+		[self updateCountText];
+		[self updatePaginationState];
+	});
+
+	return YES;
 }
 
 /**
- * Update the state of the pagination buttons and text.
- * This function is not thread-safe and should be called on the main thread.
+ * Returns a primary key value escaped for use in a WHERE clause.
  */
-- (void) updatePaginationState
+- (NSString *)_escapedKeyValue:(id)aValue forColumn:(NSString *)columnName
 {
-	NSUInteger maxPage = ceilf((CGFloat)maxNumRows / [prefs floatForKey:SPLimitResultsValue]);
-	if (isFiltered && !isLimited) {
-		maxPage = contentPage;
+	// BIT fields need a binary prefix
+	if ([[[tableDataInstance columnWithName:columnName] objectForKey:@"type"] isEqualToString:@"BIT"]) {
+		return [NSString stringWithFormat:@"b'%@'", [mySQLConnection escapeString:[aValue description] includingQuotes:NO]];
 	}
-	BOOL enabledMode = ![tableDocumentInstance isWorking];
 
-	BOOL limitResults = [prefs boolForKey:SPLimitResults];
-	// Set up the previous page button
-	[paginationPreviousButton setEnabled:(limitResults && contentPage > 1 ? enabledMode : NO)];
+	if ([aValue isKindOfClass:[NSData class]]) {
+		return [mySQLConnection escapeAndQuoteData:aValue];
+	}
 
-	// Set up the next page button
-	[paginationNextButton setEnabled:(limitResults && contentPage < maxPage ? enabledMode : NO)];
+	return [mySQLConnection escapeAndQuoteString:[aValue description]];
+}
 
 #ifndef SP_CODA
-	// As long as a table is selected (which it will be if this is called), enable pagination detail button
-	[paginationButton setEnabled:enabledMode];
-#endif
+#pragma mark -
+#pragma mark Deferred column previews
 
-	// "1" is the minimum page, so maxPage must not be less (which it would be for empty tables)
-	if(maxPage < 1) maxPage = 1;
+/**
+ * Returns the indexes of the blob and text columns which should only have previews loaded,
+ * or nil if all columns should be loaded in full.
+ */
+- (NSIndexSet *)_columnIndexesToPreview
+{
+	if (![prefs boolForKey:SPLoadBlobsAsNeeded]) return nil;
 
-	// Set the values and maximums for the text field and associated pager
-	[paginationViewController setPage:@(contentPage)];
-	[paginationViewController setMaxPage:@(maxPage)];
-}
+	NSMutableIndexSet *columnIndexes = [NSMutableIndexSet indexSet];
 
-#pragma mark -
-#pragma mark Edit methods
+	for (NSUInteger i = 0; i < [dataColumns count]; i++) {
+		if ([tableDataInstance columnIsBlobOrText:[NSArrayObjectAtIndex(dataColumns, i) objectForKey:@"name"]]) {
+			[columnIndexes addIndex:i];
+		}
+	}
+
+	return [columnIndexes count] ? columnIndexes : nil;
+}
 
 /**
- * Collect all columns for a given 'tableForColumn' table and
- * return a WHERE clause for identifying the field in quesyion.
+ * Returns a field list selecting only the start of each of the supplied columns, followed
+ * by the full length of each of those columns in order, as expected by
+ * -[SPDataStorage setColumnsAsPreviewed:previewLength:].
  */
-- (NSString *)argumentForRow:(NSUInteger)rowIndex ofTable:(NSString *)tableForColumn andDatabase:(NSString *)database includeBlobs:(BOOL)includeBlobs
+- (NSString *)_fieldListForQueryPreviewingColumns:(NSIndexSet *)columnIndexes
 {
-	NSArray *dataRow;
-	id field;
-	NSMutableArray *argumentParts = [NSMutableArray array];
+	NSMutableArray *fields = [NSMutableArray arrayWithCapacity:[dataColumns count] + [columnIndexes count]];
+	NSMutableArray *lengthFields = [NSMutableArray arrayWithCapacity:[columnIndexes count]];
 
-	// Check the table/view columns and select only those coming from the supplied database and table
-	NSMutableArray *columnsInSpecifiedTable = [NSMutableArray array];
-	for(field in cqColumnDefinition) {
-		if([[field objectForKey:@"db"] isEqualToString:database] && [[field objectForKey:@"org_table"] isEqualToString:tableForColumn])
-			[columnsInSpecifiedTable addObject:field];
+	for (NSUInteger i = 0; i < [dataColumns count]; i++) {
+		NSString *fieldName = [[NSArrayObjectAtIndex(dataColumns, i) objectForKey:@"name"] backtickQuotedString];
+
+		if ([columnIndexes containsIndex:i]) {
+			[fields addObject:[NSString stringWithFormat:@"LEFT(%@, %lu)", fieldName, (unsigned long)SPDeferredColumnPreviewLength]];
+			[lengthFields addObject:[NSString stringWithFormat:@"CHAR_LENGTH(%@)", fieldName]];
+		} else {
+			[fields addObject:fieldName];
+		}
 	}
 
-	// --- Build WHERE clause ---
-	dataRow = [tableValues rowContentsAtIndex:rowIndex];
+	[fields addObjectsFromArray:lengthFields];
 
-	// Get the primary key if there is one, using any columns present within it
-	SPMySQLResult *theResult = [mySQLConnection queryString:[NSString stringWithFormat:@"SHOW COLUMNS FROM %@.%@",
-		[database backtickQuotedString], [tableForColumn backtickQuotedString]]];
-	[theResult setReturnDataAsStrings:YES];
-	NSMutableArray *primaryColumnsInSpecifiedTable = [NSMutableArray array];
-	for (NSDictionary *eachRow in theResult) {
+	return [fields componentsJoinedByString:@", "];
+}
+
+/**
+ * Note that a row containing previewed cells has been displayed; the full values of the
+ * visible rows are then fetched in the background shortly afterwards.
+ */
+- (void)_queueFullValueFetchForRow:(NSUInteger)rowIndex
+{
+	if ([pendingFullValueRows containsIndex:rowIndex]) return;
+
+	[pendingFullValueRows addIndex:rowIndex];
+
+	[NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(_fetchPendingFullValues) object:nil];
+	[self performSelector:@selector(_fetchPendingFullValues) withObject:nil afterDelay:0.2];
+}
+
+/**
+ * Collects the keys of the displayed rows which contain partially loaded cells, and starts
+ * a background fetch of their full values.
+ */
+- (void)_fetchPendingFullValues
+{
+	NSRange visibleRows = [tableContentView rowsInRect:[tableContentView visibleRect]];
+	NSMutableIndexSet *rowIndexes = [NSMutableIndexSet indexSet];
+
+	[pendingFullValueRows enumerateIndexesInRange:visibleRows options:0 usingBlock:^(NSUInteger rowIndex, BOOL *stop) {
+		[rowIndexes addIndex:rowIndex];
+	}];
+	[pendingFullValueRows removeAllIndexes];
+
+	NSArray *primaryKeyFieldNames = [tableDataInstance primaryKeyColumnNames];
+
+	if (![rowIndexes count] || ![previewedColumnIndexes count] || !primaryKeyFieldNames || !selectedTable || isWorking || [tableDocumentInstance isWorking]) return;
+
+	// Full values can only be matched up to rows by primary keys which are themselves loaded
+	NSMutableArray *primaryKeyFieldIndexes = [NSMutableArray arrayWithCapacity:[primaryKeyFieldNames count]];
+	for (NSString *keyName in primaryKeyFieldNames) {
+		NSUInteger keyIndex = [[tableDataInstance columnNames] indexOfObject:keyName];
+		if (keyIndex == NSNotFound || [previewedColumnIndexes containsIndex:keyIndex]) return;
+		[primaryKeyFieldIndexes addObject:@(keyIndex)];
+	}
+
+	NSMutableArray *keysToFetch = [NSMutableArray arrayWithCapacity:[rowIndexes count]];
+
+	pthread_mutex_lock(&tableValuesLock);
+	[rowIndexes enumerateIndexesUsingBlock:^(NSUInteger rowIndex, BOOL *stop) {
+		if (rowIndex >= tableRowsCount) {
+			*stop = YES;
+			return;
+		}
+
+		BOOL rowHasTruncatedCells = NO;
+		for (NSUInteger columnIndex = [previewedColumnIndexes firstIndex]; columnIndex != NSNotFound; columnIndex = [previewedColumnIndexes indexGreaterThanIndex:columnIndex]) {
+			if ([tableValues cellIsTruncatedPreviewAtRow:rowIndex column:columnIndex]) {
+				rowHasTruncatedCells = YES;
+				break;
+			}
+		}
+		if (!rowHasTruncatedCells) return;
+
+		NSMutableArray *keyValues = [NSMutableArray arrayWithCapacity:[primaryKeyFieldIndexes count]];
+		for (NSNumber *keyIndex in primaryKeyFieldIndexes) {
+			[keyValues addObject:SPDataStorageObjectAtRowAndColumn(tableValues, rowIndex, [keyIndex unsignedIntegerValue])];
+		}
+		[keysToFetch addObject:keyValues];
+	}];
+	pthread_mutex_unlock(&tableValuesLock);
+
+	if (![keysToFetch count]) return;
+
+	NSMutableArray *previewedColumnNames = [NSMutableArray arrayWithCapacity:[previewedColumnIndexes count]];
+	[previewedColumnIndexes enumerateIndexesUsingBlock:^(NSUInteger columnIndex, BOOL *stop) {
+		[previewedColumnNames addObject:[NSArrayObjectAtIndex(dataColumns, columnIndex) objectForKey:@"name"]];
+	}];
+
+	NSDictionary *fetchDetails = @{
+		@"database" : [tableDocumentInstance database],
+		@"table" : selectedTable,
+		@"keyNames" : primaryKeyFieldNames,
+		@"keyIndexes" : primaryKeyFieldIndexes,
+		@"keys" : keysToFetch,
+		@"columnNames" : previewedColumnNames,
+		@"columnIndexes" : previewedColumnIndexes
+	};
+
+	[NSThread detachNewThreadWithName:SPCtxt(@"SPTableContent full value fetch task", tableDocumentInstance) target:self selector:@selector(_fetchFullValuesTask:) object:fetchDetails];
+}
+
+/**
+ * Fetches the full values of previewed columns for the supplied keys in batches, and adds
+ * them to the data store's value cache once they have been matched back up to their rows.
+ */
+- (void)_fetchFullValuesTask:(NSDictionary *)fetchDetails
+{
+	@autoreleasepool {
+		NSString *databaseName = [fetchDetails objectForKey:@"database"];
+		NSString *tableName = [fetchDetails objectForKey:@"table"];
+		NSArray *primaryKeyFieldNames = [fetchDetails objectForKey:@"keyNames"];
+		NSArray *primaryKeyFieldIndexes = [fetchDetails objectForKey:@"keyIndexes"];
+		NSArray *keysToFetch = [fetchDetails objectForKey:@"keys"];
+		NSArray *columnNames = [fetchDetails objectForKey:@"columnNames"];
+		NSIndexSet *columnIndexes = [fetchDetails objectForKey:@"columnIndexes"];
+		NSUInteger keyCount = [primaryKeyFieldNames count];
+
+		NSMutableArray *fields = [NSMutableArray arrayWithCapacity:keyCount + [columnNames count] * 2];
+		for (NSString *keyName in primaryKeyFieldNames) {
+			[fields addObject:[keyName backtickQuotedString]];
+		}
+		for (NSString *columnName in columnNames) {
+			[fields addObject:[columnName backtickQuotedString]];
+			[fields addObject:[NSString stringWithFormat:@"CHAR_LENGTH(%@)", [columnName backtickQuotedString]]];
+		}
+
+		NSString *keyList = (keyCount == 1) ? [[primaryKeyFieldNames objectAtIndex:0] backtickQuotedString] : [NSString stringWithFormat:@"(%@)", [primaryKeyFieldNames componentsJoinedAndBacktickQuoted]];
+		NSMutableDictionary *fetchedRows = [NSMutableDictionary dictionaryWithCapacity:[keysToFetch count]];
+
+		// Fetches run on their own connection, so they never interleave with queries on the main
+		// connection, and one at a time
+		pthread_mutex_lock(&fullValueConnectionLock);
+
+		if (![self _ensureFullValueConnectionForDatabase:databaseName]) {
+			pthread_mutex_unlock(&fullValueConnectionLock);
+			return;
+		}
+
+		for (NSUInteger batchStart = 0; batchStart < [keysToFetch count]; batchStart += SPDeferredColumnFetchBatchSize) {
+			NSArray *batchKeys = [keysToFetch subarrayWithRange:NSMakeRange(batchStart, MIN(SPDeferredColumnFetchBatchSize, [keysToFetch count] - batchStart))];
+			NSMutableArray *keyTuples = [NSMutableArray arrayWithCapacity:[batchKeys count]];
+
+			for (NSArray *keyValues in batchKeys) {
+				NSMutableArray *escapedValues = [NSMutableArray arrayWithCapacity:keyCount];
+				for (NSUInteger j = 0; j < keyCount; j++) {
+					[escapedValues addObject:[self _escapedKeyValue:NSArrayObjectAtIndex(keyValues, j) forColumn:NSArrayObjectAtIndex(primaryKeyFieldNames, j)]];
+				}
+				[keyTuples addObject:(keyCount == 1) ? [escapedValues objectAtIndex:0] : [NSString stringWithFormat:@"(%@)", [escapedValues componentsJoinedByString:@", "]]];
+			}
+
+			SPMySQLResult *valuesResult = [fullValueConnection queryString:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ IN (%@)", [fields componentsJoinedByString:@", "], [tableName backtickQuotedString], keyList, [keyTuples componentsJoinedByString:@", "]]];
+
+			// Give up quietly on errors; the values will be fetched on demand instead
+			if (!valuesResult || [fullValueConnection queryErrored] || [fullValueConnection lastQueryWasCancelled]) {
+				pthread_mutex_unlock(&fullValueConnectionLock);
+				return;
+			}
+
+			[valuesResult setDefaultRowReturnType:SPMySQLResultRowAsArray];
+
+			for (NSArray *row in valuesResult) {
+				NSString *lookupString = [[[row subarrayWithRange:NSMakeRange(0, keyCount)] valueForKey:@"description"] componentsJoinedByString:SPUniqueSchemaDelimiter];
+				[fetchedRows setObject:[row subarrayWithRange:NSMakeRange(keyCount, [row count] - keyCount)] forKey:lookupString];
+			}
+		}
+
+		pthread_mutex_unlock(&fullValueConnectionLock);
+
+		if (![fetchedRows count]) return;
+
+		// Match the values up to the rows on the main thread, where edits take place, only
+		// caching values for rows which are still in place
+		SPMainQSync(^{
+			if (![selectedTable isEqualToString:tableName] || ![previewedColumnIndexes isEqualToIndexSet:columnIndexes]) return;
+
+			pthread_mutex_lock(&tableValuesLock);
+			for (NSUInteger rowIndex = 0; rowIndex < tableRowsCount; rowIndex++) {
+				NSMutableString *lookupString = [NSMutableString stringWithString:[SPDataStorageObjectAtRowAndColumn(tableValues, rowIndex, [NSArrayObjectAtIndex(primaryKeyFieldIndexes, 0) unsignedIntegerValue]) description]];
+				for (NSUInteger j = 1; j < keyCount; j++) {
+					[lookupString appendString:SPUniqueSchemaDelimiter];
+					[lookupString appendString:[SPDataStorageObjectAtRowAndColumn(tableValues, rowIndex, [NSArrayObjectAtIndex(primaryKeyFieldIndexes, j) unsignedIntegerValue]) description]];
+				}
+
+				NSArray *values = [fetchedRows objectForKey:lookupString];
+				if (!values) continue;
+
+				__block NSUInteger valueIndex = 0;
+				[columnIndexes enumerateIndexesUsingBlock:^(NSUInteger columnIndex, BOOL *stop) {
+					id fullValue = NSArrayObjectAtIndex(values, valueIndex);
+					id fullLength = NSArrayObjectAtIndex(values, valueIndex + 1);
+					if (![fullLength isNSNull]) {
+						[tableValues cacheFullValue:fullValue withLength:(unsigned long long)[fullLength longLongValue] atRow:rowIndex column:columnIndex];
+					}
+					valueIndex += 2;
+				}];
+
+				[fetchedRows removeObjectForKey:lookupString];
+				if (![fetchedRows count]) break;
+			}
+			pthread_mutex_unlock(&tableValuesLock);
+		});
+	}
+}
+
+/**
+ * Sets up the connection used to fetch full values, by cloning the main connection and
+ * matching its encoding so values are decoded the same way, and selects the supplied
+ * database.  Must be called with the full value connection lock held.
+ */
+- (BOOL)_ensureFullValueConnectionForDatabase:(NSString *)databaseName
+{
+	if (!mySQLConnection || ![mySQLConnection isConnected] || !databaseName) return NO;
+
+	if (!fullValueConnection) {
+		fullValueConnection = [mySQLConnection copy];
+		[fullValueConnection setDelegate:self];
+		[fullValueConnection setDelegateQueryLogging:NO];
+	}
+
+	if (![fullValueConnection isConnected] || ![fullValueConnection checkConnectionIfNecessary]) {
+
+		// Copy the local port from the parent connection, in case a proxy has changed
+		[fullValueConnection setPort:[mySQLConnection port]];
+
+		if (![fullValueConnection connect]) return NO;
+	}
+
+	if (![[fullValueConnection encoding] isEqualToString:[mySQLConnection encoding]] || [fullValueConnection encodingUsesLatin1Transport] != [mySQLConnection encodingUsesLatin1Transport]) {
+		[fullValueConnection setEncoding:[mySQLConnection encoding]];
+		[fullValueConnection setEncodingUsesLatin1Transport:[mySQLConnection encodingUsesLatin1Transport]];
+	}
+
+	return [fullValueConnection selectDatabase:databaseName];
+}
+
+/**
+ * Forward keychain password requests for the full value connection to the database document.
+ */
+- (NSString *)keychainPasswordForConnection:(id)connection
+{
+	return [tableDocumentInstance keychainPasswordForConnection:connection];
+}
+#endif
+
+#pragma mark -
+#pragma mark Pagination
+
+/**
+ * Move the pagination backwards or forwards one page, or update
+ * the page to respect the submitted field.
+ */
+- (IBAction) navigatePaginationFromButton:(id)sender
+{
+	if (![self saveRowOnDeselect]) return;
+
+	if (sender == paginationPreviousButton) {
+		if (contentPage <= 1) return;
+		[paginationViewController setPage:@(contentPage - 1)];
+	} else if (sender == paginationNextButton) {
+		if ((NSInteger)contentPage * [prefs integerForKey:SPLimitResultsValue] >= maxNumRows) return;
+		[paginationViewController setPage:@(contentPage + 1)];
+	}
+
+	[self filterTable:sender];
+}
+
+/**
+ * When the Pagination button is pressed, show or hide the pagination
+ * layer depending on the current state.
+ */
+#ifndef SP_CODA
+- (IBAction) togglePagination:(NSButton *)sender
+{
+	[self setPaginationViewVisibility:([sender state] == NSOnState)];
+}
+#endif
+
+- (void)popoverDidClose:(NSNotification *)notification
+{
+	//not to hide the view, but to change the paginationButton
+	[self setPaginationViewVisibility:NO];
+}
+
+/**
+ * Show or hide the pagination layer, also changing the first responder as appropriate.
+ */
+- (void) setPaginationViewVisibility:(BOOL)makeVisible
+{
+#ifndef SP_CODA
+	NSRect paginationViewFrame = [paginationView frame];
+	
+	if(makeVisible) {
+		[paginationButton setState:NSOnState];
+		[paginationButton setImage:[NSImage imageNamed:@"button_action"]];
+		[paginationViewController makeInputFirstResponder];
+	}
+	else {
+		[paginationButton setState:NSOffState];
+		[paginationButton setImage:[NSImage imageNamed:@"button_pagination"]];
+		// TODO This is only relevant in 10.6 legacy mode.
+		// When using a modern NSPopover, the view controller's parent window is an _NSPopoverWindow,
+		// not the SP window and we don't care what the first responder in the popover is.
+		// (when it is not being displayed anyway).
+		if (!paginationPopover && [paginationViewController isFirstResponderInside]) {
+			[[[paginationViewController view] window] makeFirstResponder:nil];
+		}
+	}
+	
+	if(paginationPopover) {
+		if(makeVisible) {
+			[paginationPopover showRelativeToRect:[paginationButton bounds] ofView:paginationButton preferredEdge:NSMinYEdge];
+		}
+		else if([paginationPopover isShown]) {
+			//usually this should not happen, as the popover will disappear once the user clicks somewhere
+			//else in the window (including the paginationButton).
+			[paginationPopover close];
+		}
+		return;
+	}
+	
+	if (makeVisible) {
+		if (paginationViewFrame.size.height == paginationViewHeight) return;
+		paginationViewFrame.size.height = paginationViewHeight;
+	} else {
+		if (paginationViewFrame.size.height == 0) return;
+		paginationViewFrame.size.height = 0;
+	}
+
+	[[paginationView animator] setFrame:paginationViewFrame];
+#endif
+}
+
+/**
+ * Update the state of the pagination buttons and text.
+ * This function is not thread-safe and should be called on the main thread.
+ */
+- (void) updatePaginationState
+{
+	NSUInteger maxPage = ceilf((CGFloat)maxNumRows / [prefs floatForKey:SPLimitResultsValue]);
+	if (isFiltered && !isLimited) {
+		maxPage = contentPage;
+	}
+	BOOL enabledMode = ![tableDocumentInstance isWorking];
+
+	BOOL limitResults = [prefs boolForKey:SPLimitResults];
+	// Set up the previous page button
+	[paginationPreviousButton setEnabled:(limitResults && contentPage > 1 ? enabledMode : NO)];
+
+	// Set up the next page button
+	[paginationNextButton setEnabled:(limitResults && contentPage < maxPage ? enabledMode : NO)];
+
+#ifndef SP_CODA
+	// As long as a table is selected (which it will be if this is called), enable pagination detail button
+	[paginationButton setEnabled:enabledMode];
+#endif
+
+	// "1" is the minimum page, so maxPage must not be less (which it would be for empty tables)
+	if(maxPage < 1) maxPage = 1;
+
+	// Set the values and maximums for the text field and associated pager
+	[paginationViewController setPage:@(contentPage)];
+	[paginationViewController setMaxPage:@(maxPage)];
+}
+
+#pragma mark -
+#pragma mark Edit methods
+
+/**
+ * Collect all columns for a given 'tableForColumn' table and
+ * return a WHERE clause for identifying the field in quesyion.
+ */
+- (NSString *)argumentForRow:(NSUInteger)rowIndex ofTable:(NSString *)tableForColumn andDatabase:(NSString *)database includeBlobs:(BOOL)includeBlobs
+{
+	NSArray *dataRow;
+	id field;
+	NSMutableArray *argumentParts = [NSMutableArray array];
+
+	// Check the table/view columns and select only those coming from the supplied database and table
+	NSMutableArray *columnsInSpecifiedTable = [NSMutableArray array];
+	for(field in cqColumnDefinition) {
+		if([[field objectForKey:@"db"] isEqualToString:database] && [[field objectForKey:@"org_table"] isEqualToString:tableForColumn])
+			[columnsInSpecifiedTable addObject:field];
+	}
+
+	// --- Build WHERE clause ---
+	dataRow = [tableValues rowContentsAtIndex:rowIndex];
+
+	// Get the primary key if there is one, using any columns present within it
+	SPMySQLResult *theResult = [mySQLConnection queryString:[NSString stringWithFormat:@"SHOW COLUMNS FROM %@.%@",
+		[database backtickQuotedString], [tableForColumn backtickQuotedString]]];
+	[theResult setReturnDataAsStrings:YES];
+	NSMutableArray *primaryColumnsInSpecifiedTable = [NSMutableArray array];
+	for (NSDictionary *eachRow in theResult) {
 		if ( [[eachRow objectForKey:@"Key"] isEqualToString:@"PRI"] ) {
 			for (field in columnsInSpecifiedTable) {
 				if([[field objectForKey:@"org_name"] isEqualToString:[eachRow objectForKey:@"Field"]]) {
@@ -1684,8 +2229,9 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	// Check whether table editing is permitted (necessary as some actions - eg table double-click - bypass validation)
 	if ([tableDocumentInstance isWorking] || [tablesListInstance tableType] != SPTableTypeTable) return;
 
-	// Check whether a save of the current row is required.
-	if ( ![self saveRowOnDeselect] ) return;
+	// Check whether a save of the current row is required.  New rows are added at the end of the
+	// table, so any queued edits can remain queued.
+	if ( ![self _saveRowOnSelectionChange] ) return;
 
 	for (NSDictionary *column in dataColumns) {
 		if ([column objectForKey:@"default"] == nil || [[column objectForKey:@"default"] isNSNull]) {
@@ -1902,6 +2448,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 			if (isEditingRow) [self cancelRowEditing];
 
 			[mySQLConnection queryString:[NSString stringWithFormat:@"DELETE FROM %@", [selectedTable backtickQuotedString]]];
+			[tableDataInstance invalidateCachedNumberOfRowsForTable:selectedTable];
 			if ( ![mySQLConnection queryErrored] ) {
 				maxNumRows = 0;
 				tableRowsCount = 0;
@@ -2118,6 +2665,8 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 			// Restore Console Log window's updating bahaviour
 			[[SPQueryController sharedQueryController] setAllowConsoleUpdate:consoleUpdateStatus];
 
+			if (affectedRows) [tableDataInstance invalidateCachedNumberOfRowsForTable:selectedTable];
+
 			if (errors) {
 				NSMutableString *messageText = [NSMutableString stringWithCapacity:50];
 				NSString *messageTitle = NSLocalizedString(@"Unexpected number of rows removed!", @"Table Content : Remove Row : Result : n Error title");
@@ -2459,75 +3008,15 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		return YES;
 	}
 
-	// Iterate through the row contents, constructing the (ordered) arrays of keys and values to be saved
+	// In deferred mode, queue the row to be committed together with other edited rows
+	if ([self _defersRowEditCommits]) return [self _queueEditedRow];
+
+	// Construct the (ordered) arrays of keys and values to be saved
 	NSMutableArray *rowFieldsToSave = [[NSMutableArray alloc] initWithCapacity:[dataColumns count]];
 	NSMutableArray *rowValuesToSave = [[NSMutableArray alloc] initWithCapacity:[dataColumns count]];
 	NSUInteger i;
-	NSDictionary *fieldDefinition;
-	id rowObject;
-	
-	for (i = 0; i < [dataColumns count]; i++) 
-	{
-		rowObject = [tableValues cellDataAtRow:currentlyEditingRow column:i];
-		fieldDefinition = NSArrayObjectAtIndex(dataColumns, i);
-
-		// Skip "not loaded" cells entirely - these only occur when editing tables when the
-		// preference setting is enabled, and don't need to be saved back to the table.
-		if ([rowObject isSPNotLoaded]) continue;
-
-		// If an edit has taken place, and the field value hasn't changed, the value
-		// can also be skipped
-		if (!isEditingNewRow && [rowObject isEqual:NSArrayObjectAtIndex(oldRow, i)]) continue;
-
-		// Prepare to derive the value to save
-		NSString *fieldValue;
-		NSString *fieldTypeGroup = [fieldDefinition objectForKey:@"typegrouping"];
-
-		// Use NULL when the user has entered the nullValue string defined in the preferences,
-		// or when a numeric  or date field is empty.
-		if ([rowObject isNSNull]
-			|| (([fieldTypeGroup isEqualToString:@"float"] || [fieldTypeGroup isEqualToString:@"integer"] || [fieldTypeGroup isEqualToString:@"date"])
-				&& [[rowObject description] isEqualToString:@""] && [[fieldDefinition objectForKey:@"null"] boolValue]))
-		{
-			fieldValue = @"NULL";
-
-		// Convert geometry values to their string values
-		} else if ([fieldTypeGroup isEqualToString:@"geometry"]) {
-			fieldValue = ([rowObject isKindOfClass:[SPMySQLGeometryData class]]) ? [[rowObject wktString] getGeomFromTextString] : [(NSString*)rowObject getGeomFromTextString];
-	
-		// Convert the object to a string (here we can add special treatment for date-, number- and data-fields)
-		} else {
-
-			// I believe these class matches are not ever met at present.
-			if ([rowObject isKindOfClass:[NSCalendarDate class]]) {
-				fieldValue = [mySQLConnection escapeAndQuoteString:[rowObject description]];
-			} else if ([rowObject isKindOfClass:[NSNumber class]]) {
-				fieldValue = [rowObject stringValue];
-
-			// Convert data to its hex representation
-			} else if ([rowObject isKindOfClass:[NSData class]]) {
-				fieldValue = [mySQLConnection escapeAndQuoteData:rowObject];
-
-			} else {
-				NSString *desc = [rowObject description];
-				if ([desc isMatchedByRegex:SPCurrentTimestampPattern]) {
-					fieldValue = desc;
-				} else if ([fieldTypeGroup isEqualToString:@"bit"]) {
-					fieldValue = [NSString stringWithFormat:@"b'%@'", ((![desc length] || [desc isEqualToString:@"0"]) ? @"0" : desc)];
-				} else if ([fieldTypeGroup isEqualToString:@"date"] && [desc isEqualToString:@"NOW()"]) {
-					fieldValue = @"NOW()";
-				} else if ([fieldTypeGroup isEqualToString:@"string"] && [[rowObject description] isEqualToString:@"UUID()"]) {
-					fieldValue = @"UUID()";
-				} else {
-					fieldValue = [mySQLConnection escapeAndQuoteString:desc];
-				}
-			}
-		}
 
-		// Store the key and value in the ordered arrays for saving.
-		[rowFieldsToSave addObject:[fieldDefinition objectForKey:@"name"]];
-		[rowValuesToSave addObject:fieldValue];
-	}
+	[self _getFieldsToSave:rowFieldsToSave values:rowValuesToSave forRow:currentlyEditingRow originalRow:(isEditingNewRow ? nil : oldRow)];
 
 	[[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:@"SMySQLQueryWillBePerformed" object:tableDocumentInstance];
 
@@ -2591,113 +3080,390 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 			[tableValues replaceRowAtIndex:currentlyEditingRow withRowContents:oldRow];
 		}
 
-		isEditingRow = NO;
-		currentlyEditingRow = -1;
-		[tableContentView reloadData];
+		isEditingRow = NO;
+		currentlyEditingRow = -1;
+		[tableContentView reloadData];
+
+		[[SPQueryController sharedQueryController] showErrorInConsole:NSLocalizedString(@"/* WARNING: No rows have been affected */\n", @"warning shown in the console when no rows have been affected after writing to the db") connection:[tableDocumentInstance name] database:[tableDocumentInstance database]];
+
+		return YES;
+
+	// On success...
+	} else if ( ![mySQLConnection queryErrored] ) {
+		isEditingRow = NO;
+
+		// New row created successfully
+		if ( isEditingNewRow ) {
+			[tableDataInstance invalidateCachedNumberOfRowsForTable:selectedTable];
+#ifndef SP_CODA
+			if ( [prefs boolForKey:SPReloadAfterAddingRow] ) {
+
+				// Save any edits which have been started but not saved to the underlying table/data structures
+				// yet - but not if currently undoing/redoing, as this can cause a processing loop
+				if (![[[[tableContentView window] firstResponder] undoManager] isUndoing] && ![[[[tableContentView window] firstResponder] undoManager] isRedoing]) {
+				[[tableDocumentInstance parentWindow] endEditingFor:nil];
+				}
+
+				previousTableRowsCount = tableRowsCount;
+				[self loadTableValues];
+			} 
+			else {
+#endif
+				// Set the insertId for fields with auto_increment
+				for ( i = 0; i < [dataColumns count] ; i++ ) {
+					if ([[NSArrayObjectAtIndex(dataColumns, i) objectForKey:@"autoincrement"] integerValue]) {
+						[tableValues replaceObjectInRow:currentlyEditingRow column:i withObject:[[NSNumber numberWithUnsignedLongLong:[mySQLConnection lastInsertID]] description]];
+					}
+				}
+#ifndef SP_CODA
+			}
+#endif
+			isEditingNewRow = NO;
+
+		// Existing row edited successfully
+		} else {
+
+			// Reload table if set to - otherwise no action required.
+#ifndef SP_CODA
+			if ([prefs boolForKey:SPReloadAfterEditingRow]) {
+
+				// Save any edits which have been started but not saved to the underlying table/data structures
+				// yet - but not if currently undoing/redoing, as this can cause a processing loop
+				if (![[[[tableContentView window] firstResponder] undoManager] isUndoing] && ![[[[tableContentView window] firstResponder] undoManager] isRedoing]) {
+				[[tableDocumentInstance parentWindow] endEditingFor:nil];
+				}
+
+				previousTableRowsCount = tableRowsCount;
+				[self loadTableValues];
+			}
+#endif
+		}
+		currentlyEditingRow = -1;
+
+		return YES;
+	}
+	// Report errors which have occurred
+	else {
+		SPBeginAlertSheet(
+			NSLocalizedString(@"Unable to write row", @"Unable to write row error"),
+			NSLocalizedString(@"Edit row", @"Edit row button"),
+			NSLocalizedString(@"Discard changes", @"discard changes button"),
+			nil,
+			[tableDocumentInstance parentWindow],
+			self,
+			@selector(addRowErrorSheetDidEnd:returnCode:contextInfo:),
+			NULL,
+			[NSString stringWithFormat:NSLocalizedString(@"MySQL said:\n\n%@", @"message of panel when error while adding row to db"), [mySQLConnection lastErrorMessage]]
+		);
+		return NO;
+	}
+}
+
+/**
+ * Handle the user decision as a result of an addRow error.
+ */
+- (void) addRowErrorSheetDidEnd:(NSAlert *)alert returnCode:(NSInteger)returnCode contextInfo:(void *)contextInfo
+{
+	// Order out current sheet to suppress overlapping of sheets
+	[[alert window] orderOut:nil];
+
+	// Edit row selected - reselect the row, and start editing.
+	if ( returnCode == NSAlertDefaultReturn ) {
+		[tableContentView selectRowIndexes:[NSIndexSet indexSetWithIndex:currentlyEditingRow] byExtendingSelection:NO];
+		[tableContentView performSelector:@selector(keyDown:) withObject:[NSEvent keyEventWithType:NSKeyDown location:NSMakePoint(0,0) modifierFlags:0 timestamp:0 windowNumber:[[tableContentView window] windowNumber] context:[NSGraphicsContext currentContext] characters:@"" charactersIgnoringModifiers:@"" isARepeat:NO keyCode:0x24] afterDelay:0.0];
+
+	} 
+	else {
+	// Discard changes selected
+		[self cancelRowEditing];
+	}
+	
+	[tableContentView reloadData];
+}
+
+/**
+ * A method to be called whenever the table selection changes; checks whether the current
+ * row is being edited, and if so attempts to save it.  Returns YES if no save was necessary
+ * or the save was successful, and NO if a save was necessary and failed - in which case further
+ * editing is required.  In that case this method will reselect the row in question for reediting.
+ * If row edits have been queued, the user is then asked whether to save or discard them, and
+ * NO is also returned if the user cancels.
+ */
+- (BOOL)saveRowOnDeselect
+{
+	return [self _saveRowAndPendingRowEditsAskingUser:YES];
+}
+
+/**
+ * Cancel active row editing, replacing the previous row if there was one
+ * and resetting state.
+ * Returns whether row editing was cancelled.
+ */
+- (BOOL)cancelRowEditing
+{
+	[[tableContentView window] makeFirstResponder:tableContentView];
+
+	if (!isEditingRow) return NO;
+	if (isEditingNewRow) {
+		tableRowsCount--;
+		[tableValues removeRowAtIndex:currentlyEditingRow];
+		[self updateCountText];
+		isEditingNewRow = NO;
+	} else {
+		[tableValues replaceRowAtIndex:currentlyEditingRow withRowContents:oldRow];
+	}
+	isEditingRow = NO;
+	currentlyEditingRow = -1;
+	[tableContentView reloadData];
+	[[tableContentView window] makeFirstResponder:tableContentView];
+	return YES;
+}
+
+/**
+ * Build the ordered arrays of field names and SQL values to save for a row.  If original row
+ * contents are supplied, only fields which have changed are included; otherwise all loaded
+ * fields are included, as for new rows.
+ */
+- (void)_getFieldsToSave:(NSMutableArray *)rowFieldsToSave values:(NSMutableArray *)rowValuesToSave forRow:(NSUInteger)rowIndex originalRow:(NSArray *)originalRow
+{
+	NSUInteger i;
+	NSDictionary *fieldDefinition;
+	id rowObject;
+
+	for (i = 0; i < [dataColumns count]; i++)
+	{
+		rowObject = [tableValues cellDataAtRow:rowIndex column:i];
+		fieldDefinition = NSArrayObjectAtIndex(dataColumns, i);
+
+		// Skip "not loaded" cells entirely - these only occur when editing tables when the
+		// preference setting is enabled, and don't need to be saved back to the table.
+		if ([rowObject isSPNotLoaded]) continue;
+
+		// If an edit has taken place, and the field value hasn't changed, the value
+		// can also be skipped
+		if (originalRow && [rowObject isEqual:NSArrayObjectAtIndex(originalRow, i)]) continue;
+
+		// Prepare to derive the value to save
+		NSString *fieldValue;
+		NSString *fieldTypeGroup = [fieldDefinition objectForKey:@"typegrouping"];
+
+		// Use NULL when the user has entered the nullValue string defined in the preferences,
+		// or when a numeric  or date field is empty.
+		if ([rowObject isNSNull]
+			|| (([fieldTypeGroup isEqualToString:@"float"] || [fieldTypeGroup isEqualToString:@"integer"] || [fieldTypeGroup isEqualToString:@"date"])
+				&& [[rowObject description] isEqualToString:@""] && [[fieldDefinition objectForKey:@"null"] boolValue]))
+		{
+			fieldValue = @"NULL";
+
+		// Convert geometry values to their string values
+		} else if ([fieldTypeGroup isEqualToString:@"geometry"]) {
+			fieldValue = ([rowObject isKindOfClass:[SPMySQLGeometryData class]]) ? [[rowObject wktString] getGeomFromTextString] : [(NSString*)rowObject getGeomFromTextString];
+	
+		// Convert the object to a string (here we can add special treatment for date-, number- and data-fields)
+		} else {
+
+			// I believe these class matches are not ever met at present.
+			if ([rowObject isKindOfClass:[NSCalendarDate class]]) {
+				fieldValue = [mySQLConnection escapeAndQuoteString:[rowObject description]];
+			} else if ([rowObject isKindOfClass:[NSNumber class]]) {
+				fieldValue = [rowObject stringValue];
+
+			// Convert data to its hex representation
+			} else if ([rowObject isKindOfClass:[NSData class]]) {
+				fieldValue = [mySQLConnection escapeAndQuoteData:rowObject];
+
+			} else {
+				NSString *desc = [rowObject description];
+				if ([desc isMatchedByRegex:SPCurrentTimestampPattern]) {
+					fieldValue = desc;
+				} else if ([fieldTypeGroup isEqualToString:@"bit"]) {
+					fieldValue = [NSString stringWithFormat:@"b'%@'", ((![desc length] || [desc isEqualToString:@"0"]) ? @"0" : desc)];
+				} else if ([fieldTypeGroup isEqualToString:@"date"] && [desc isEqualToString:@"NOW()"]) {
+					fieldValue = @"NOW()";
+				} else if ([fieldTypeGroup isEqualToString:@"string"] && [[rowObject description] isEqualToString:@"UUID()"]) {
+					fieldValue = @"UUID()";
+				} else {
+					fieldValue = [mySQLConnection escapeAndQuoteString:desc];
+				}
+			}
+		}
+
+		// Store the key and value in the ordered arrays for saving.
+		[rowFieldsToSave addObject:[fieldDefinition objectForKey:@"name"]];
+		[rowValuesToSave addObject:fieldValue];
+	}
+}
+
+#pragma mark -
+#pragma mark Deferred row edits
 
-		[[SPQueryController sharedQueryController] showErrorInConsole:NSLocalizedString(@"/* WARNING: No rows have been affected */\n", @"warning shown in the console when no rows have been affected after writing to the db") connection:[tableDocumentInstance name] database:[tableDocumentInstance database]];
+/**
+ * Returns the number of edited rows queued to be committed.
+ */
+- (NSUInteger)numberOfPendingRowEdits
+{
+	return [pendingRowEdits count];
+}
+
+/**
+ * Commit all queued row edits to the table in a single transaction, combining new rows
+ * into multi-row INSERTs and rows with the same changed fields into grouped UPDATEs, each
+ * limited to the server's max_allowed_packet.  If any statement fails, it is undone and its
+ * rows are retried individually to determine which rows caused the failure; the transaction
+ * is then rolled back, the failed rows are selected, and the edits remain queued.
+ * Returns YES if there was nothing to commit or the commit succeeded.
+ */
+- (BOOL)commitPendingRowEdits
+{
+	if (![pendingRowEdits count]) return YES;
+
+	SPPendingRowEditStatements *pendingStatements = [self _statementsForPendingRowEdits];
+	NSArray *statements = [pendingStatements statements];
 
+	// If all edits were reverted to their original values, there is nothing to save
+	if (![statements count]) {
+		[pendingRowEdits removeAllObjects];
+		[self updateCountText];
 		return YES;
+	}
 
-	// On success...
-	} else if ( ![mySQLConnection queryErrored] ) {
-		isEditingRow = NO;
+	NSMutableDictionary *rowErrors = [NSMutableDictionary dictionary];
+	BOOL committedInserts = NO;
+	BOOL committedUpdates = NO;
 
-		// New row created successfully
-		if ( isEditingNewRow ) {
-#ifndef SP_CODA
-			if ( [prefs boolForKey:SPReloadAfterAddingRow] ) {
+	[[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:@"SMySQLQueryWillBePerformed" object:tableDocumentInstance];
 
-				// Save any edits which have been started but not saved to the underlying table/data structures
-				// yet - but not if currently undoing/redoing, as this can cause a processing loop
-				if (![[[[tableContentView window] firstResponder] undoManager] isUndoing] && ![[[[tableContentView window] firstResponder] undoManager] isRedoing]) {
-				[[tableDocumentInstance parentWindow] endEditingFor:nil];
-				}
+	// START TRANSACTION would implicitly commit a transaction the user has begun on this
+	// connection, so nest the statements in a savepoint within such a transaction instead;
+	// a failure then only rolls back the queued edits, and the user's transaction stays open.
+	SPMySQLServerStatusBits serverStatus;
+	BOOL useSavepoint = ([mySQLConnection updateServerStatusBits:&serverStatus] && serverStatus.inTransaction);
 
-				previousTableRowsCount = tableRowsCount;
-				[self loadTableValues];
-			} 
-			else {
-#endif
-				// Set the insertId for fields with auto_increment
-				for ( i = 0; i < [dataColumns count] ; i++ ) {
-					if ([[NSArrayObjectAtIndex(dataColumns, i) objectForKey:@"autoincrement"] integerValue]) {
-						[tableValues replaceObjectInRow:currentlyEditingRow column:i withObject:[[NSNumber numberWithUnsignedLongLong:[mySQLConnection lastInsertID]] description]];
-					}
+	[mySQLConnection queryString:(useSavepoint ? @"SAVEPOINT sp_pending_row_edits" : @"START TRANSACTION")];
+
+	if ([mySQLConnection queryErrored]) {
+		for (NSNumber *rowKey in pendingRowEdits) {
+			[rowErrors setObject:[mySQLConnection lastErrorMessage] forKey:rowKey];
+		}
+	}
+	else {
+		for (NSDictionary *statement in statements) {
+			if ([[statement objectForKey:@"insert"] boolValue]) committedInserts = YES;
+			else committedUpdates = YES;
+		}
+
+		[rowErrors addEntriesFromDictionary:[pendingStatements rowErrorsExecutingStatements:statements onConnection:mySQLConnection]];
+
+		if ([rowErrors count]) {
+			[mySQLConnection queryString:(useSavepoint ? @"ROLLBACK TO SAVEPOINT sp_pending_row_edits" : @"ROLLBACK")];
+		}
+		else {
+			[mySQLConnection queryString:(useSavepoint ? @"RELEASE SAVEPOINT sp_pending_row_edits" : @"COMMIT")];
+
+			if ([mySQLConnection queryErrored]) {
+				for (NSNumber *rowKey in pendingRowEdits) {
+					[rowErrors setObject:[mySQLConnection lastErrorMessage] forKey:rowKey];
 				}
-#ifndef SP_CODA
 			}
-#endif
-			isEditingNewRow = NO;
+		}
+	}
 
-		// Existing row edited successfully
-		} else {
+	[[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:@"SMySQLQueryHasBeenPerformed" object:tableDocumentInstance];
 
-			// Reload table if set to - otherwise no action required.
-#ifndef SP_CODA
-			if ([prefs boolForKey:SPReloadAfterEditingRow]) {
+	// Report the rows which couldn't be saved, selecting them for re-editing
+	if ([rowErrors count]) {
+		NSArray *failedRowKeys = [[rowErrors allKeys] sortedArrayUsingSelector:@selector(compare:)];
+		NSMutableIndexSet *failedRows = [NSMutableIndexSet indexSet];
+		NSMutableString *errorDetails = [NSMutableString string];
 
-				// Save any edits which have been started but not saved to the underlying table/data structures
-				// yet - but not if currently undoing/redoing, as this can cause a processing loop
-				if (![[[[tableContentView window] firstResponder] undoManager] isUndoing] && ![[[[tableContentView window] firstResponder] undoManager] isRedoing]) {
-				[[tableDocumentInstance parentWindow] endEditingFor:nil];
-				}
+		for (NSNumber *rowKey in failedRowKeys) {
+			[failedRows addIndex:[rowKey unsignedIntegerValue]];
 
-				previousTableRowsCount = tableRowsCount;
-				[self loadTableValues];
+			if ([failedRows count] <= 10) {
+				[errorDetails appendFormat:NSLocalizedString(@"Row %lu: %@\n", @"row number and error message for a row which couldn't be saved"), (unsigned long)([rowKey unsignedIntegerValue] + 1), [rowErrors objectForKey:rowKey]];
 			}
-#endif
 		}
-		currentlyEditingRow = -1;
+		if ([failedRowKeys count] > 10) {
+			[errorDetails appendFormat:NSLocalizedString(@"…and %lu more\n", @"indication that further rows couldn't be saved"), (unsigned long)([failedRowKeys count] - 10)];
+		}
+
+		[tableContentView selectRowIndexes:failedRows byExtendingSelection:NO];
+		[tableContentView scrollRowToVisible:[failedRows firstIndex]];
 
-		return YES;
-	}
-	// Report errors which have occurred
-	else {
 		SPBeginAlertSheet(
-			NSLocalizedString(@"Unable to write row", @"Unable to write row error"),
-			NSLocalizedString(@"Edit row", @"Edit row button"),
+			NSLocalizedString(@"Unable to save edited rows", @"Unable to save queued row edits error"),
+			NSLocalizedString(@"Edit rows", @"Edit rows button"),
 			NSLocalizedString(@"Discard changes", @"discard changes button"),
 			nil,
 			[tableDocumentInstance parentWindow],
 			self,
-			@selector(addRowErrorSheetDidEnd:returnCode:contextInfo:),
+			@selector(pendingRowEditsErrorSheetDidEnd:returnCode:contextInfo:),
 			NULL,
-			[NSString stringWithFormat:NSLocalizedString(@"MySQL said:\n\n%@", @"message of panel when error while adding row to db"), [mySQLConnection lastErrorMessage]]
+			[NSString stringWithFormat:NSLocalizedString(@"%lu of %lu edited rows couldn't be saved, so no changes have been committed. MySQL said:\n\n%@", @"message of panel when errors occurred while committing queued row edits"), (unsigned long)[failedRowKeys count], (unsigned long)[pendingRowEdits count], errorDetails]
 		);
+
 		return NO;
 	}
+
+	[pendingRowEdits removeAllObjects];
+
+	if (committedInserts) [tableDataInstance invalidateCachedNumberOfRowsForTable:selectedTable];
+
+	// Reload the table if set to - or if new rows may have received auto_increment values
+	BOOL tableHasAutoIncrementColumn = NO;
+	for (NSDictionary *column in dataColumns) {
+		if ([[column objectForKey:@"autoincrement"] integerValue]) tableHasAutoIncrementColumn = YES;
+	}
+
+	if ((committedInserts && (tableHasAutoIncrementColumn || [prefs boolForKey:SPReloadAfterAddingRow]))
+		|| (committedUpdates && [prefs boolForKey:SPReloadAfterEditingRow]))
+	{
+		previousTableRowsCount = tableRowsCount;
+		[self loadTableValues];
+	}
+	else {
+		[self updateCountText];
+	}
+
+	return YES;
 }
 
 /**
- * Handle the user decision as a result of an addRow error.
+ * Discard all queued row edits, removing queued new rows and restoring the original contents
+ * of edited rows.
  */
-- (void) addRowErrorSheetDidEnd:(NSAlert *)alert returnCode:(NSInteger)returnCode contextInfo:(void *)contextInfo
+- (void)discardPendingRowEdits
 {
-	// Order out current sheet to suppress overlapping of sheets
-	[[alert window] orderOut:nil];
+	if (![pendingRowEdits count]) return;
 
-	// Edit row selected - reselect the row, and start editing.
-	if ( returnCode == NSAlertDefaultReturn ) {
-		[tableContentView selectRowIndexes:[NSIndexSet indexSetWithIndex:currentlyEditingRow] byExtendingSelection:NO];
-		[tableContentView performSelector:@selector(keyDown:) withObject:[NSEvent keyEventWithType:NSKeyDown location:NSMakePoint(0,0) modifierFlags:0 timestamp:0 windowNumber:[[tableContentView window] windowNumber] context:[NSGraphicsContext currentContext] characters:@"" charactersIgnoringModifiers:@"" isARepeat:NO keyCode:0x24] afterDelay:0.0];
+	// Work backwards through the rows, so removing new rows doesn't affect the later indexes
+	NSArray *rowKeys = [[pendingRowEdits allKeys] sortedArrayUsingSelector:@selector(compare:)];
 
-	} 
-	else {
-	// Discard changes selected
-		[self cancelRowEditing];
+	for (NSNumber *rowKey in [rowKeys reverseObjectEnumerator]) {
+		NSDictionary *pendingEdit = [pendingRowEdits objectForKey:rowKey];
+		NSUInteger rowIndex = [rowKey unsignedIntegerValue];
+
+		if ([[pendingEdit objectForKey:@"newRow"] boolValue]) {
+			[tableValues removeRowAtIndex:rowIndex];
+			tableRowsCount--;
+		}
+		else {
+			[tableValues replaceRowAtIndex:rowIndex withRowContents:[NSMutableArray arrayWithArray:[pendingEdit objectForKey:@"originalRow"]]];
+		}
 	}
-	
+
+	[pendingRowEdits removeAllObjects];
+
 	[tableContentView reloadData];
+	[self updateCountText];
 }
 
 /**
- * A method to be called whenever the table selection changes; checks whether the current
- * row is being edited, and if so attempts to save it.  Returns YES if no save was necessary
- * or the save was successful, and NO if a save was necessary and failed - in which case further
- * editing is required.  In that case this method will reselect the row in question for reediting.
+ * Saves any row being edited, as -saveRowOnDeselect, and then commits or discards any queued
+ * row edits.  If requested, the user is first asked whether to save or discard queued edits,
+ * or to cancel the action requiring them to be resolved.
  */
-- (BOOL)saveRowOnDeselect
+- (BOOL)_saveRowAndPendingRowEditsAskingUser:(BOOL)askUser
 {
 	if ([tablesListInstance tableType] == SPTableTypeView) {
 		isSavingRow = NO;
@@ -2710,15 +3476,19 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		[[tableDocumentInstance parentWindow] endEditingFor:nil];
 	}
 
-	// If no rows are currently being edited, or a save is in progress, return success at once.
-	if (!isEditingRow || isSavingRow) return YES;
-	
+	// If a save is in progress, return success at once.
+	if (isSavingRow) return YES;
+
+	// If no rows are currently being edited, just commit or discard any queued row edits.
+	if (!isEditingRow) return [self _commitPendingRowEditsAskingUser:askUser];
+
 	isSavingRow = YES;
 
-	// Attempt to save the row, and return YES if the save succeeded.
+	// Attempt to save the row, and return YES if the save - and the commit or discarding of
+	// any queued row edits - succeeded.
 	if ([self saveRowToTable]) {
 		isSavingRow = NO;
-		return YES;
+		return [self _commitPendingRowEditsAskingUser:askUser];
 	}
 
 	// Saving failed - return failure.
@@ -2728,30 +3498,193 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 }
 
 /**
- * Cancel active row editing, replacing the previous row if there was one
- * and resetting state.
- * Returns whether row editing was cancelled.
+ * Commits any queued row edits, first asking the user whether to save or discard them if
+ * requested.  Returns NO if the commit failed or the user cancelled.
  */
-- (BOOL)cancelRowEditing
+- (BOOL)_commitPendingRowEditsAskingUser:(BOOL)askUser
 {
-	[[tableContentView window] makeFirstResponder:tableContentView];
+	if (![pendingRowEdits count] || !askUser) return [self commitPendingRowEdits];
 
-	if (!isEditingRow) return NO;
-	if (isEditingNewRow) {
-		tableRowsCount--;
-		[tableValues removeRowAtIndex:currentlyEditingRow];
-		[self updateCountText];
-		isEditingNewRow = NO;
-	} else {
-		[tableValues replaceRowAtIndex:currentlyEditingRow withRowContents:oldRow];
+	NSAlert *alert = [NSAlert alertWithMessageText:NSLocalizedString(@"Save edited rows?", @"title of alert asking whether to save queued row edits")
+	                                 defaultButton:NSLocalizedString(@"Save", @"save button")
+	                               alternateButton:NSLocalizedString(@"Cancel", @"cancel button")
+	                                   otherButton:NSLocalizedString(@"Discard", @"discard button")
+	                     informativeTextWithFormat:NSLocalizedString(@"%lu edited rows haven't been saved to the table yet. Do you want to save or discard the changes?", @"message of alert asking whether to save queued row edits"), (unsigned long)[pendingRowEdits count]];
+
+	[alert setAlertStyle:NSWarningAlertStyle];
+
+	switch ([alert runModal]) {
+		case NSAlertDefaultReturn:
+			return [self commitPendingRowEdits];
+		case NSAlertOtherReturn:
+			[self discardPendingRowEdits];
+			return YES;
+	}
+
+	return NO;
+}
+
+/**
+ * Save any row being edited and commit all queued row edits.
+ */
+- (IBAction)commitPendingRowEdits:(id)sender
+{
+	[self _saveRowAndPendingRowEditsAskingUser:NO];
+}
+
+/**
+ * Cancel any row being edited and discard all queued row edits.
+ */
+- (IBAction)discardPendingRowEdits:(id)sender
+{
+	[self cancelRowEditing];
+	[self discardPendingRowEdits];
+}
+
+/**
+ * Toggle whether row edits are queued to be committed together; any queued row edits
+ * are committed when deferring is switched off.
+ */
+- (IBAction)toggleDeferredRowEdits:(id)sender
+{
+	BOOL deferEdits = ![prefs boolForKey:SPDeferRowEditCommits];
+
+	if (!deferEdits && ![self _saveRowAndPendingRowEditsAskingUser:NO]) return;
+
+	[prefs setBool:deferEdits forKey:SPDeferRowEditCommits];
+}
+
+/**
+ * Handle the user decision after queued row edits couldn't be committed.
+ */
+- (void)pendingRowEditsErrorSheetDidEnd:(NSAlert *)alert returnCode:(NSInteger)returnCode contextInfo:(void *)contextInfo
+{
+	// Order out current sheet to suppress overlapping of sheets
+	[[alert window] orderOut:nil];
+
+	// Edit rows selected - the failed rows are already selected, so keep the edits queued.
+	// Otherwise discard the queued edits.
+	if (returnCode != NSAlertDefaultReturn) {
+		[self discardPendingRowEdits];
+	}
+
+	[tableContentView reloadData];
+}
+
+/**
+ * Returns whether row edits should be queued to be committed together, rather than
+ * saved as each edited row is deselected.
+ */
+- (BOOL)_defersRowEditCommits
+{
+	if (![prefs boolForKey:SPDeferRowEditCommits] || [tablesListInstance tableType] != SPTableTypeTable) return NO;
+
+	// Queued edits are only committed all-or-nothing if the table's changes can be rolled back;
+	// on MyISAM and other non-transactional engines rows are saved as they are deselected.
+	return [SPPendingRowEditStatements engineSupportsTransactions:[tableDataInstance statusValueForKey:@"Engine"]];
+}
+
+/**
+ * Called when the selection moves away from an edited row.  When deferring row edits
+ * the row is queued to be committed later; otherwise the row is saved at once.
+ */
+- (BOOL)_saveRowOnSelectionChange
+{
+	if (![self _defersRowEditCommits]) return [self saveRowOnDeselect];
+
+	// Save any edits which have been started but not saved to the underlying table/data structures
+	// yet - but not if currently undoing/redoing, as this can cause a processing loop
+	if (![[[[tableContentView window] firstResponder] undoManager] isUndoing] && ![[[[tableContentView window] firstResponder] undoManager] isRedoing]) {
+		[[tableDocumentInstance parentWindow] endEditingFor:nil];
 	}
+
+	if (!isEditingRow || isSavingRow) return YES;
+
+	isSavingRow = YES;
+	BOOL rowWasQueued = [self saveRowToTable];
+	isSavingRow = NO;
+
+	return rowWasQueued;
+}
+
+/**
+ * Queue the row being edited to be committed later.  The edited contents remain in the
+ * data storage; the original contents and the WHERE clause identifying the row are stored
+ * the first time a row is queued, so further edits to the row are combined.
+ */
+- (BOOL)_queueEditedRow
+{
+	NSNumber *rowKey = [NSNumber numberWithInteger:currentlyEditingRow];
+
+	if (![pendingRowEdits objectForKey:rowKey]) {
+		NSMutableDictionary *pendingEdit = [NSMutableDictionary dictionaryWithCapacity:4];
+
+		if (isEditingNewRow) {
+			[pendingEdit setObject:@YES forKey:@"newRow"];
+		}
+		else {
+			NSString *whereArg = [self argumentForRow:-2 excludingLimits:YES];
+			if (![whereArg length]) {
+				SPLog(@"Did not find plausible WHERE condition for UPDATE.");
+				NSBeep();
+				return NO;
+			}
+
+			[pendingEdit setObject:@NO forKey:@"newRow"];
+			[pendingEdit setObject:[NSArray arrayWithArray:oldRow] forKey:@"originalRow"];
+			[pendingEdit setObject:whereArg forKey:@"whereArgument"];
+			[pendingEdit setObject:@(!setLimit) forKey:@"usesPrimaryKey"];
+		}
+
+		[pendingRowEdits setObject:pendingEdit forKey:rowKey];
+	}
+
 	isEditingRow = NO;
+	isEditingNewRow = NO;
 	currentlyEditingRow = -1;
-	[tableContentView reloadData];
-	[[tableContentView window] makeFirstResponder:tableContentView];
+
+	[self updateCountText];
+
 	return YES;
 }
 
+/**
+ * Build the statements to commit the queued row edits, as described by SPPendingRowEditStatements.
+ */
+- (SPPendingRowEditStatements *)_statementsForPendingRowEdits
+{
+	// Leave some headroom below max_allowed_packet for the protocol overhead
+	NSUInteger maxStatementLength = [mySQLConnection maxQuerySize];
+	if (maxStatementLength > 2048) maxStatementLength -= 1024;
+
+	SPPendingRowEditStatements *statements = [[SPPendingRowEditStatements alloc] initWithTableName:selectedTable keyFieldNames:((keys && !setLimit) ? keys : nil) maxStatementLength:maxStatementLength stringEncoding:[mySQLConnection stringEncoding]];
+
+	NSArray *rowKeys = [[pendingRowEdits allKeys] sortedArrayUsingSelector:@selector(compare:)];
+
+	for (NSNumber *rowKey in rowKeys) {
+		NSDictionary *pendingEdit = [pendingRowEdits objectForKey:rowKey];
+		BOOL isNewRow = [[pendingEdit objectForKey:@"newRow"] boolValue];
+		NSMutableArray *rowFieldsToSave = [NSMutableArray arrayWithCapacity:[dataColumns count]];
+		NSMutableArray *rowValuesToSave = [NSMutableArray arrayWithCapacity:[dataColumns count]];
+
+		[self _getFieldsToSave:rowFieldsToSave values:rowValuesToSave forRow:[rowKey unsignedIntegerValue] originalRow:(isNewRow ? nil : [pendingEdit objectForKey:@"originalRow"])];
+
+		// Rows whose edits have been reverted have nothing to save
+		if (![rowFieldsToSave count]) continue;
+
+		if (isNewRow) {
+			[statements addInsertOfRow:rowKey fields:rowFieldsToSave values:rowValuesToSave];
+		}
+		else {
+			[statements addUpdateOfRow:rowKey fields:rowFieldsToSave values:rowValuesToSave whereArgument:[pendingEdit objectForKey:@"whereArgument"] usesPrimaryKey:[[pendingEdit objectForKey:@"usesPrimaryKey"] boolValue]];
+		}
+	}
+
+	return [statements autorelease];
+}
+
+#pragma mark -
+
 /**
  * Returns the WHERE argument to identify a row.
  * If "row" is -2, it uses the oldRow.
@@ -3533,6 +4466,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		maxNumRowsIsEstimate = NO;
 		[tableDataInstance setStatusValue:[NSString stringWithFormat:@"%ld", (long)maxNumRows] forKey:@"Rows"];
 		[tableDataInstance setStatusValue:@"y" forKey:@"RowsCountAccurate"];
+		[tableDataInstance cacheAccurateNumberOfRows:maxNumRows forTable:selectedTable];
 #ifndef SP_CODA
 		[[tableInfoInstance onMainThread] tableChanged:nil];
 #warning Private ivar accessed from outside (#2978)
@@ -3684,6 +4618,22 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	[self clearTableLoadTimer];
 }
 
+/**
+ * Updates the total row count shown for filtered or paginated results once an exact
+ * count for the table becomes available.
+ */
+- (void)tableInfoChanged:(NSNotification *)notification
+{
+	if (isWorking || !selectedTable || (!isFiltered && !isLimited)) return;
+	if (![[tableDataInstance statusValueForKey:@"RowsCountAccurate"] boolValue]) return;
+
+	maxNumRows = [[tableDataInstance statusValueForKey:@"Rows"] integerValue];
+	maxNumRowsIsEstimate = NO;
+
+	[self updateCountText];
+	[self updatePaginationState];
+}
+
 #pragma mark -
 #pragma mark KVO methods
 
@@ -3745,6 +4695,17 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		return ((![tableContentView numberOfSelectedRows]) && ([tablesListInstance tableType] == SPTableTypeTable));
 	}
 
+	// Deferred row edits
+	if (action == @selector(toggleDeferredRowEdits:)) {
+		[menuItem setState:([prefs boolForKey:SPDeferRowEditCommits] ? NSOnState : NSOffState)];
+
+		return ([tablesListInstance tableType] == SPTableTypeTable && [SPPendingRowEditStatements engineSupportsTransactions:[tableDataInstance statusValueForKey:@"Engine"]]);
+	}
+
+	if (action == @selector(commitPendingRowEdits:) || action == @selector(discardPendingRowEdits:)) {
+		return ([pendingRowEdits count] > 0 || isEditingRow);
+	}
+
 	return YES;
 }
 
@@ -3799,6 +4760,13 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 			else {
 				value = [self _contentValueForTableColumn:columnIndex row:rowIndex asPreview:YES];
 			}
+
+#ifndef SP_CODA
+			// Fetch the full values of partially loaded cells as they are displayed
+			if ([previewedColumnIndexes containsIndex:columnIndex]) {
+				[self _queueFullValueFetchForRow:rowIndex];
+			}
+#endif
 		}
 
 		if ([value isKindOfClass:[SPMySQLGeometryData class]]) {
@@ -3860,7 +4828,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 		// Catch editing events in the row and if the row isn't currently being edited,
 		// start an edit.  This allows edits including enum changes to save correctly.
 		if (isEditingRow && [tableContentView selectedRow] != currentlyEditingRow) {
-			[self saveRowOnDeselect];
+			[self _saveRowOnSelectionChange];
 		}
 
 		if (!isEditingRow) {
@@ -3986,7 +4954,7 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	[addButton setEnabled:([tablesListInstance tableType] == SPTableTypeTable)];
 
 	// If we are editing a row, attempt to save that row - if saving failed, reselect the edit row.
-	if (isEditingRow && [tableContentView selectedRow] != currentlyEditingRow && ![self saveRowOnDeselect]) return;
+	if (isEditingRow && [tableContentView selectedRow] != currentlyEditingRow && ![self _saveRowOnSelectionChange]) return;
 
 	if (![tableDocumentInstance isWorking]) {
 		// Update the row selection count
@@ -4666,6 +5634,12 @@ static void *TableContentKVOContext = &TableContentKVOContext;
 	if (sortColumnToRestore)    SPClear(sortColumnToRestore);
 	if (selectionToRestore)     SPClear(selectionToRestore);
 	if (cqColumnDefinition)     SPClear(cqColumnDefinition);
+	if (incrementalRefreshTimestamp) SPClear(incrementalRefreshTimestamp);
+	if (previewedColumnIndexes) SPClear(previewedColumnIndexes);
+	SPClear(pendingFullValueRows);
+	SPClear(pendingRowEdits);
+	if (fullValueConnection) SPClear(fullValueConnection);
+	pthread_mutex_destroy(&fullValueConnectionLock);
 
 	SPClear(filtersToRestore);
 
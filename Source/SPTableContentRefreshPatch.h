@@ -0,0 +1,83 @@
+//
+//  SPTableContentRefreshPatch.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * The loaded rows a refresh patch is calculated against; implemented by SPDataStorage.
+ */
+@protocol SPTableContentRefreshPatchRows <NSObject>
+
+- (NSUInteger)count;
+- (id)cellDataAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex;
+- (NSMutableArray *)rowContentsAtIndex:(NSUInteger)anIndex;
+
+@end
+
+/**
+ * @class SPTableContentRefreshPatch SPTableContentRefreshPatch.h
+ *
+ * Works out the changes needed to bring loaded table rows up to date from the rows changed on
+ * the server since they were loaded, together with the primary keys of every row now on the server.
+ * Rows are matched by primary key: changed rows replace the loaded rows with the same key, or are
+ * appended; loaded rows whose keys are no longer on the server are removed.  A key on the server
+ * which is neither loaded nor among the changed rows belongs to a row which was missed - for example
+ * one inserted with an old timestamp - and requires a full reload.
+ *
+ * Row indexes to replace refer to the loaded rows before any are removed.
+ */
+@interface SPTableContentRefreshPatch : NSObject
+{
+	id <SPTableContentRefreshPatchRows> loadedRows;
+	NSArray *keyColumnIndexes;
+
+	NSMutableDictionary *loadedRowIndexes;
+	NSMutableDictionary *changedRows;
+	NSMutableArray *changedRowKeys;
+	NSMutableSet *serverKeys;
+
+	NSMutableDictionary *rowsToReplace;
+	NSMutableArray *rowsToAdd;
+	NSMutableIndexSet *rowIndexesToRemove;
+}
+
++ (NSString *)keyForRow:(NSArray *)row keyColumnIndexes:(NSArray *)columnIndexes;
+
+- (id)initWithLoadedRows:(id <SPTableContentRefreshPatchRows>)rows keyColumnIndexes:(NSArray *)columnIndexes;
+
+- (void)addChangedRow:(NSArray *)row;
+- (void)addServerKeyRow:(NSArray *)keyRow;
+
+- (BOOL)calculatePatch;
+
+- (NSDictionary *)rowsToReplace;
+- (NSArray *)rowsToAdd;
+- (NSIndexSet *)rowIndexesToRemove;
+- (BOOL)isEmpty;
+
+@end
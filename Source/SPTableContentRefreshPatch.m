@@ -0,0 +1,202 @@
+//
+//  SPTableContentRefreshPatch.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPTableContentRefreshPatch.h"
+
+@implementation SPTableContentRefreshPatch
+
+/**
+ * Returns a string identifying a row by the values of its key columns.
+ */
++ (NSString *)keyForRow:(NSArray *)row keyColumnIndexes:(NSArray *)columnIndexes
+{
+	NSMutableString *key = [NSMutableString string];
+
+	for (NSUInteger i = 0; i < [columnIndexes count]; i++) {
+		if (i) [key appendString:SPUniqueSchemaDelimiter];
+		[key appendString:[[row objectAtIndex:[[columnIndexes objectAtIndex:i] unsignedIntegerValue]] description]];
+	}
+
+	return key;
+}
+
+/**
+ * Initialise a patch against the supplied loaded rows, whose primary key is made up of the
+ * columns at the supplied indexes.
+ */
+- (id)initWithLoadedRows:(id <SPTableContentRefreshPatchRows>)rows keyColumnIndexes:(NSArray *)columnIndexes
+{
+	if ((self = [super init])) {
+		loadedRows = [rows retain];
+		keyColumnIndexes = [columnIndexes copy];
+
+		changedRows = [[NSMutableDictionary alloc] init];
+		changedRowKeys = [[NSMutableArray alloc] init];
+		serverKeys = [[NSMutableSet alloc] init];
+
+		rowsToReplace = [[NSMutableDictionary alloc] init];
+		rowsToAdd = [[NSMutableArray alloc] init];
+		rowIndexesToRemove = [[NSMutableIndexSet alloc] init];
+
+		// Index the loaded rows by key
+		NSUInteger rowCount = [loadedRows count];
+		loadedRowIndexes = [[NSMutableDictionary alloc] initWithCapacity:rowCount];
+		for (NSUInteger i = 0; i < rowCount; i++) {
+			NSMutableString *key = [NSMutableString string];
+			for (NSUInteger j = 0; j < [keyColumnIndexes count]; j++) {
+				if (j) [key appendString:SPUniqueSchemaDelimiter];
+				[key appendString:[[loadedRows cellDataAtRow:i column:[[keyColumnIndexes objectAtIndex:j] unsignedIntegerValue]] description]];
+			}
+			[loadedRowIndexes setObject:@(i) forKey:key];
+		}
+	}
+
+	return self;
+}
+
+/**
+ * Adds a full row which has changed on the server since the rows were loaded.  Rows which
+ * haven't actually changed may be added too, and are left untouched.
+ */
+- (void)addChangedRow:(NSArray *)row
+{
+	NSString *key = [SPTableContentRefreshPatch keyForRow:row keyColumnIndexes:keyColumnIndexes];
+
+	if (![changedRows objectForKey:key]) [changedRowKeys addObject:key];
+	[changedRows setObject:row forKey:key];
+}
+
+/**
+ * Adds the key of a row currently on the server; the key row holds only the key columns,
+ * in the order of the key column indexes.
+ */
+- (void)addServerKeyRow:(NSArray *)keyRow
+{
+	NSMutableString *key = [NSMutableString string];
+
+	for (NSUInteger i = 0; i < [keyRow count]; i++) {
+		if (i) [key appendString:SPUniqueSchemaDelimiter];
+		[key appendString:[[keyRow objectAtIndex:i] description]];
+	}
+
+	[serverKeys addObject:key];
+}
+
+/**
+ * Works out the rows to replace, add and remove once all changed rows and server keys have
+ * been added.  Returns NO if the loaded rows can't be patched, and a full reload is required.
+ */
+- (BOOL)calculatePatch
+{
+	[rowsToReplace removeAllObjects];
+	[rowsToAdd removeAllObjects];
+	[rowIndexesToRemove removeAllIndexes];
+
+	// Any row on the server must either be loaded already or have changed
+	for (NSString *key in serverKeys) {
+		if (![loadedRowIndexes objectForKey:key] && ![changedRows objectForKey:key]) return NO;
+	}
+
+	// Loaded rows no longer on the server have been deleted, or had their key changed
+	for (NSString *key in loadedRowIndexes) {
+		if (![serverKeys containsObject:key]) [rowIndexesToRemove addIndex:[[loadedRowIndexes objectForKey:key] unsignedIntegerValue]];
+	}
+
+	// Changed rows which have since been deleted are skipped, as the key list was read last
+	for (NSString *key in changedRowKeys) {
+		if (![serverKeys containsObject:key]) continue;
+
+		NSArray *row = [changedRows objectForKey:key];
+		NSNumber *loadedIndex = [loadedRowIndexes objectForKey:key];
+
+		// Rows within the overlap window are usually unchanged, so only replace rows which differ
+		if (loadedIndex) {
+			if (![[loadedRows rowContentsAtIndex:[loadedIndex unsignedIntegerValue]] isEqualToArray:row]) {
+				[rowsToReplace setObject:row forKey:loadedIndex];
+			}
+		}
+		else {
+			[rowsToAdd addObject:row];
+		}
+	}
+
+	return YES;
+}
+
+/**
+ * The changed rows to replace, keyed by the index of the loaded row they replace.
+ */
+- (NSDictionary *)rowsToReplace
+{
+	return rowsToReplace;
+}
+
+/**
+ * The rows to append, in the order they were added.
+ */
+- (NSArray *)rowsToAdd
+{
+	return rowsToAdd;
+}
+
+/**
+ * The indexes of the loaded rows to remove.
+ */
+- (NSIndexSet *)rowIndexesToRemove
+{
+	return rowIndexesToRemove;
+}
+
+/**
+ * Returns whether the calculated patch leaves the loaded rows unchanged.
+ */
+- (BOOL)isEmpty
+{
+	return ![rowsToReplace count] && ![rowsToAdd count] && ![rowIndexesToRemove count];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(loadedRows);
+	SPClear(keyColumnIndexes);
+	SPClear(loadedRowIndexes);
+	SPClear(changedRows);
+	SPClear(changedRowKeys);
+	SPClear(serverKeys);
+	SPClear(rowsToReplace);
+	SPClear(rowsToAdd);
+	SPClear(rowIndexesToRemove);
+
+	[super dealloc];
+}
+
+@end
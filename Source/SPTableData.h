@@ -32,7 +32,9 @@
 @class SPTablesList;
 @class SPMySQLConnection;
 
-@interface SPTableData : NSObject 
+#import <SPMySQL/SPMySQL.h>
+
+@interface SPTableData : NSObject <SPMySQLConnectionDelegate>
 {
 	IBOutlet SPDatabaseDocument* tableDocumentInstance;
 	IBOutlet SPTablesList* tableListInstance;
@@ -51,6 +53,12 @@
 
 	pthread_mutex_t dataProcessingLock;
 
+	// Exact row counts are run on a separate connection and cached per table
+	SPMySQLConnection *rowCountConnection;
+	NSMutableDictionary *cachedRowCounts;
+	NSString *rowCountTableInProgress;
+	pthread_mutex_t rowCountLock;
+
 	BOOL tableHasAutoIncrementField;
 }
 
@@ -80,6 +88,10 @@
 - (BOOL) updateStatusInformationForCurrentTable;
 - (BOOL) updateTriggersForCurrentTable;
 - (BOOL) updateAccurateNumberOfRowsForCurrentTableForcingUpdate:(BOOL)alwaysUpdate;
+- (void) cancelAccurateNumberOfRowsUpdate;
+- (void) cacheAccurateNumberOfRows:(NSInteger)rowCount forTable:(NSString *)tableName;
+- (void) invalidateCachedNumberOfRowsForTable:(NSString *)tableName;
+- (void) invalidateCachedNumberOfRows;
 - (NSDictionary *) parseFieldDefinitionStringParts:(NSArray *)definitionParts;
 - (NSArray *) primaryKeyColumnNames;
 
@@ -35,6 +35,7 @@
 #import "SPAlertSheets.h"
 #import "RegexKitLite.h"
 #import "SPServerSupport.h"
+#import "SPThreadAdditions.h"
 
 #import <pthread.h>
 #import <SPMySQL/SPMySQL.h>
@@ -43,6 +44,10 @@
 
 - (void)_loopWhileWorking;
 - (NSDictionary *)parseCreateStatement:(NSString *)tableDef ofType:(NSString *)tableType;
+- (NSString *)_rowCountCacheKeyForTable:(NSString *)tableName;
+- (void)_startBackgroundRowCountForCurrentTable;
+- (void)_countRowsInBackground:(NSDictionary *)countDetails;
+- (BOOL)_ensureRowCountConnection;
 
 @end
 
@@ -65,7 +70,12 @@
 		tableCreateSyntax = nil;
 		tableHasAutoIncrementField = NO;
 
+		rowCountConnection = nil;
+		cachedRowCounts = [[NSMutableDictionary alloc] init];
+		rowCountTableInProgress = nil;
+
 		pthread_mutex_init(&dataProcessingLock, NULL);
+		pthread_mutex_init(&rowCountLock, NULL);
 	}
 
 	return self;
@@ -313,6 +323,8 @@
  */
 - (void) resetAllData
 {
+	[self cancelAccurateNumberOfRowsUpdate];
+
 	[columns removeAllObjects];
 	[columnNames removeAllObjects];
 	[status removeAllObjects];
@@ -1024,6 +1036,12 @@
 		return NO;
 	}
 
+	// Keep any row count already shown for this table, in case no new estimate can be retrieved
+	NSString *previousRowCount = nil;
+	if ([[status objectForKey:@"Name"] isEqualToString:[tableListInstance tableName]] && ![[status objectForKey:@"Rows"] isNSNull]) {
+		previousRowCount = [[[status objectForKey:@"Rows"] retain] autorelease];
+	}
+
 	// Retrieve the status as a dictionary and set as the cache
 	[status setDictionary:[tableStatusResult getRowAsDictionary]];
 
@@ -1049,22 +1067,34 @@
 			[status setObject:@"n" forKey:@"RowsCountAccurate"];
 		}
 
-		// [status objectForKey:@"Rows"] is NULL then try to get the number of rows via SELECT COUNT(1) FROM `foo`
+		// [status objectForKey:@"Rows"] is NULL then use a previously counted value, or the optimizer's estimate
+		// from EXPLAIN; the exact count is then retrieved in the background.
 		// this happens e.g. for db "information_schema"
 		if([[status objectForKey:@"Rows"] isNSNull]) {
-			tableStatusResult = [mySQLConnection queryString:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [escapedTableName backtickQuotedString] ]];
-			// this query can fail e.g. if a table is damaged
-			if (tableStatusResult && ![mySQLConnection queryErrored]) {
-				[status setObject:[[tableStatusResult getRowAsArray] objectAtIndex:0] forKey:@"Rows"];
+			NSNumber *cachedRowCount;
+			@synchronized(cachedRowCounts) {
+				cachedRowCount = [[[cachedRowCounts objectForKey:[self _rowCountCacheKeyForTable:[tableListInstance tableName]]] retain] autorelease];
+			}
+
+			if (cachedRowCount) {
+				[status setObject:[cachedRowCount stringValue] forKey:@"Rows"];
 				[status setObject:@"y" forKey:@"RowsCountAccurate"];
 			}
 			else {
-				//FIXME that error should really show only when trying to view the table content, but we don't even try to load that if Rows==NULL
-				SPOnewayAlertSheet(
-					NSLocalizedString(@"Querying row count failed", @"table status : row count query failed : error title"),
-					[NSApp mainWindow],
-					[NSString stringWithFormat:NSLocalizedString(@"An error occured while trying to determine the number of rows for “%@”.\nMySQL said: %@ (%lu)", @"table status : row count query failed : error message"),[tableListInstance tableName],[mySQLConnection lastErrorMessage],[mySQLConnection lastErrorID]]
-				);
+				tableStatusResult = [mySQLConnection queryString:[NSString stringWithFormat:@"EXPLAIN SELECT 1 FROM %@", [[tableListInstance tableName] backtickQuotedString]]];
+				[tableStatusResult setReturnDataAsStrings:YES];
+
+				// this query can fail e.g. if a table is damaged
+				NSString *estimatedRows = [[tableStatusResult getRowAsDictionary] objectForKey:@"rows"];
+				if (tableStatusResult && ![mySQLConnection queryErrored] && estimatedRows && ![estimatedRows isNSNull]) {
+					[status setObject:estimatedRows forKey:@"Rows"];
+				}
+				else if (previousRowCount) {
+					[status setObject:previousRowCount forKey:@"Rows"];
+				}
+				[status setObject:@"n" forKey:@"RowsCountAccurate"];
+
+				[self _startBackgroundRowCountForCurrentTable];
 			}
 		}
 
@@ -1136,8 +1166,10 @@
  * Retrieve the number of rows in the current table if necessary; if a value has already been
  * set for the current table/view, no update will occur.  However, if the row count value
  * is an estimate but the preferences are set to retrieve accurate row counts, this will
- * run a COUNT query to retrieve an accurate value.
- * Returns YES if the update was successful or not needed, or NO if the update failed
+ * use a cached count for the table, or start a COUNT query on a background connection.
+ * The estimate is kept until the count completes, at which point the status is updated
+ * and a SPTableInfoChangedNotification is posted.
+ * Returns YES if the update was started or not needed, or NO if no table is selected
  */
 - (BOOL) updateAccurateNumberOfRowsForCurrentTableForcingUpdate:(BOOL)alwaysUpdate
 {
@@ -1160,6 +1192,20 @@
 			return YES;
 		}
 
+		// Use a previously retrieved count if one is still valid
+		NSNumber *cachedRowCount;
+		@synchronized(cachedRowCounts) {
+			cachedRowCount = [[[cachedRowCounts objectForKey:[self _rowCountCacheKeyForTable:[tableListInstance tableName]]] retain] autorelease];
+		}
+		if (cachedRowCount) {
+			pthread_mutex_lock(&dataProcessingLock);
+			[status setObject:[cachedRowCount stringValue] forKey:@"Rows"];
+			[status setObject:@"y" forKey:@"RowsCountAccurate"];
+			pthread_mutex_unlock(&dataProcessingLock);
+			[[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:SPTableInfoChangedNotification object:tableDocumentInstance];
+			return YES;
+		}
+
 		SPRowCountQueryUsageLevels rowCountLevel = SPRowCountFetchAlways;
 		NSInteger rowCountCheapBoundary = 5242880;
 #ifndef SP_CODA
@@ -1176,20 +1222,58 @@
 		}
 	}
 
-	// Fetch the number of rows
-	SPMySQLResult *rowResult = [mySQLConnection queryString:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [[tableListInstance tableName] backtickQuotedString]]];
-	if ([mySQLConnection queryErrored] || !rowResult) {
-		return NO;
+	// Count the rows on a background connection; the estimate remains in place until the count is
+	// complete, and the count is cancelled if another table is selected in the meantime.
+	[self _startBackgroundRowCountForCurrentTable];
+
+	return YES;
+}
+
+/**
+ * Cancels a running background row count, if any.
+ */
+- (void) cancelAccurateNumberOfRowsUpdate
+{
+	@synchronized(cachedRowCounts) {
+		if (!rowCountTableInProgress) return;
+		SPClear(rowCountTableInProgress);
 	}
 
-	// Store the number of rows
-	[status setObject:[[rowResult getRowAsArray] objectAtIndex:0] forKey:@"Rows"];
-	[status setObject:@"y" forKey:@"RowsCountAccurate"];
+	[rowCountConnection cancelCurrentQuery];
+}
 
-	// Trigger an update to the table info pane and view
-	[[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:SPTableInfoChangedNotification object:tableDocumentInstance];
+/**
+ * Stores an exact row count for a table obtained elsewhere, eg by loading all of its rows.
+ */
+- (void) cacheAccurateNumberOfRows:(NSInteger)rowCount forTable:(NSString *)tableName
+{
+	if (!tableName) return;
 
-	return YES;
+	@synchronized(cachedRowCounts) {
+		[cachedRowCounts setObject:@(rowCount) forKey:[self _rowCountCacheKeyForTable:tableName]];
+	}
+}
+
+/**
+ * Discards the cached row count for a table, eg after rows were added or removed.
+ */
+- (void) invalidateCachedNumberOfRowsForTable:(NSString *)tableName
+{
+	if (!tableName) return;
+
+	@synchronized(cachedRowCounts) {
+		[cachedRowCounts removeObjectForKey:[self _rowCountCacheKeyForTable:tableName]];
+	}
+}
+
+/**
+ * Discards all cached row counts.
+ */
+- (void) invalidateCachedNumberOfRows
+{
+	@synchronized(cachedRowCounts) {
+		[cachedRowCounts removeAllObjects];
+	}
 }
 
 /**
@@ -1432,13 +1516,16 @@
 	SPClear(constraints);
 	SPClear(status);
 	SPClear(primaryKeyColumns);
+	SPClear(cachedRowCounts);
 
+	if (rowCountConnection) SPClear(rowCountConnection);
 	if (triggers)          SPClear(triggers);
 	if (tableEncoding)     SPClear(tableEncoding);
 	if (tableCreateSyntax) SPClear(tableCreateSyntax);
 	[self setConnection:nil];
 
 	pthread_mutex_destroy(&dataProcessingLock);
+	pthread_mutex_destroy(&rowCountLock);
 
 	[super dealloc];
 }
@@ -1452,6 +1539,122 @@
 	pthread_mutex_unlock(&dataProcessingLock);
 }
 
+- (NSString *)_rowCountCacheKeyForTable:(NSString *)tableName
+{
+	return [NSString stringWithFormat:@"%@%@%@", [tableDocumentInstance database], SPUniqueSchemaDelimiter, tableName];
+}
+
+/**
+ * Starts counting the rows of the current table in the background, cancelling any count
+ * running for another table.  Nothing is done if the table is already being counted.
+ */
+- (void)_startBackgroundRowCountForCurrentTable
+{
+	NSString *tableName = [tableListInstance tableName];
+	NSString *databaseName = [tableDocumentInstance database];
+	if (!tableName || !databaseName) return;
+
+	@synchronized(cachedRowCounts) {
+		if ([rowCountTableInProgress isEqualToString:tableName]) return;
+	}
+
+	[self cancelAccurateNumberOfRowsUpdate];
+
+	NSString *countTable = [[tableName copy] autorelease];
+	@synchronized(cachedRowCounts) {
+		rowCountTableInProgress = [countTable retain];
+	}
+
+	[NSThread detachNewThreadWithName:SPCtxt(@"SPTableData row count task", tableDocumentInstance) target:self selector:@selector(_countRowsInBackground:) object:@{@"table" : countTable, @"database" : databaseName}];
+}
+
+/**
+ * Runs SELECT COUNT(1) for the supplied table on the row count connection, caching the
+ * result and updating the status if the table is still selected once the count completes.
+ */
+- (void)_countRowsInBackground:(NSDictionary *)countDetails
+{
+	@autoreleasepool {
+		NSString *tableName = [countDetails objectForKey:@"table"];
+		NSString *databaseName = [countDetails objectForKey:@"database"];
+		NSString *rowCount = nil;
+		BOOL countStillWanted;
+
+		// Only one count runs at a time; any earlier count will have been cancelled
+		pthread_mutex_lock(&rowCountLock);
+
+		@synchronized(cachedRowCounts) {
+			countStillWanted = (rowCountTableInProgress == tableName);
+		}
+
+		if (countStillWanted && [self _ensureRowCountConnection] && [rowCountConnection selectDatabase:databaseName]) {
+			rowCount = [rowCountConnection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [tableName backtickQuotedString]]];
+			if ([rowCountConnection queryErrored] || [rowCountConnection lastQueryWasCancelled]) rowCount = nil;
+		}
+
+		pthread_mutex_unlock(&rowCountLock);
+
+		@synchronized(cachedRowCounts) {
+			countStillWanted = (rowCountTableInProgress == tableName);
+			if (countStillWanted) SPClear(rowCountTableInProgress);
+			if (rowCount && [databaseName isEqualToString:[tableDocumentInstance database]]) {
+				[cachedRowCounts setObject:@([rowCount integerValue]) forKey:[self _rowCountCacheKeyForTable:tableName]];
+			}
+		}
+
+		// Update the status of the still selected table, and trigger an update to the table info pane and view
+		if (rowCount && countStillWanted) {
+			BOOL statusUpdated = NO;
+
+			pthread_mutex_lock(&dataProcessingLock);
+			if ([tableName isEqualToString:[tableListInstance tableName]] && [tableName isEqualToString:[status objectForKey:@"Name"]]) {
+				[status setObject:[rowCount description] forKey:@"Rows"];
+				[status setObject:@"y" forKey:@"RowsCountAccurate"];
+				statusUpdated = YES;
+			}
+			pthread_mutex_unlock(&dataProcessingLock);
+
+			if (statusUpdated) [[NSNotificationCenter defaultCenter] postNotificationOnMainThreadWithName:SPTableInfoChangedNotification object:tableDocumentInstance];
+		}
+	}
+}
+
+/**
+ * Sets up the connection used for row counts, by cloning the main connection.
+ * Must be called with the row count lock held.
+ */
+- (BOOL)_ensureRowCountConnection
+{
+	if (!mySQLConnection || ![mySQLConnection isConnected]) return NO;
+
+	if (!rowCountConnection) {
+		rowCountConnection = [mySQLConnection copy];
+		[rowCountConnection setDelegate:self];
+	}
+
+	if ([rowCountConnection isConnected] && [rowCountConnection checkConnectionIfNecessary]) return YES;
+
+	// Copy the local port from the parent connection, in case a proxy has changed
+	[rowCountConnection setPort:[mySQLConnection port]];
+
+	if (![rowCountConnection connect]) return NO;
+
+	[rowCountConnection setEncoding:@"utf8"];
+
+	return YES;
+}
+
+#pragma mark -
+#pragma mark SPMySQLConnection delegate methods
+
+/**
+ * Forward keychain password requests to the database object.
+ */
+- (NSString *)keychainPasswordForConnection:(id)connection
+{
+	return [tableDocumentInstance keychainPasswordForConnection:connection];
+}
+
 #ifdef SP_CODA /* glue */
 
 - (void)setTableDocumentInstance:(SPDatabaseDocument *)doc
@@ -0,0 +1,65 @@
+//
+//  SPTextWidthMeasurer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPTextWidthMeasurer SPTextWidthMeasurer.h
+ *
+ * Provides fast, thread-safe single-line text width estimates for a font, as used
+ * when autosizing result columns.  Advances for the Latin-1 range are measured once
+ * per font and cached in a lookup table, so most cell contents can be measured
+ * without any text layout; runs of other characters are measured separately using
+ * the standard string drawing machinery.
+ *
+ * Line breaks are measured as the pilcrow characters used to display them in tables.
+ * Kerning is not taken into account, so widths may be very slightly overestimated.
+ */
+@interface SPTextWidthMeasurer : NSObject
+{
+	NSFont *font;
+	NSDictionary *stringAttributes;
+
+	CGFloat latin1Advances[256];
+	CGFloat reversePilcrowAdvance;
+	CGFloat widestNumericAdvance;
+	CGFloat widestAdvance;
+}
+
+@property (readonly) NSFont *font;
+
++ (SPTextWidthMeasurer *)measurerForFont:(NSFont *)aFont;
++ (BOOL)byteLengthBoundsWidthForEncoding:(NSStringEncoding)anEncoding;
+
+- (id)initWithFont:(NSFont *)aFont;
+
+- (CGFloat)widthOfString:(NSString *)aString;
+- (CGFloat)widthOfNumericStringWithLength:(NSUInteger)length;
+- (CGFloat)maximumWidthOfStringWithByteLength:(NSUInteger)byteLength;
+
+@end
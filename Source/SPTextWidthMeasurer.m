@@ -0,0 +1,267 @@
+//
+//  SPTextWidthMeasurer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPTextWidthMeasurer.h"
+
+// Strings up to this length are measured from a stack buffer
+#define SP_MEASURER_STACK_BUFFER_LENGTH 512
+
+@interface SPTextWidthMeasurer ()
+
+- (CGFloat)_widthOfCharacters:(const unichar *)characters length:(NSUInteger)length;
+
+@end
+
+@implementation SPTextWidthMeasurer
+
+@synthesize font;
+
+/**
+ * Returns a shared measurer for the supplied font, creating and caching it
+ * on first use.  Safe to call from any thread.
+ */
++ (SPTextWidthMeasurer *)measurerForFont:(NSFont *)aFont
+{
+	static NSMutableDictionary *measurers = nil;
+
+	if (!aFont) return nil;
+
+	@synchronized(self) {
+		if (!measurers) measurers = [[NSMutableDictionary alloc] init];
+
+		SPTextWidthMeasurer *measurer = [measurers objectForKey:aFont];
+
+		if (!measurer) {
+			measurer = [[SPTextWidthMeasurer alloc] initWithFont:aFont];
+			[measurers setObject:measurer forKey:aFont];
+			[measurer release];
+		}
+
+		return [[measurer retain] autorelease];
+	}
+}
+
+/**
+ * Returns whether -maximumWidthOfStringWithByteLength: gives an upper bound for strings in
+ * the supplied encoding.  That is only the case for encodings which either cover just the
+ * Latin-1 range (or cp1252, which MySQL calls latin1), or use more than one byte for every
+ * character outside it.  Single byte encodings of other scripts, such as cp1251, koi8r
+ * or greek, can contain characters wider than any measured Latin-1 character, so their
+ * values need to be measured.
+ */
++ (BOOL)byteLengthBoundsWidthForEncoding:(NSStringEncoding)anEncoding
+{
+	switch (anEncoding) {
+		case NSASCIIStringEncoding:
+		case NSISOLatin1StringEncoding:
+		case NSWindowsCP1252StringEncoding:
+		case NSUTF8StringEncoding:
+		case NSUTF16BigEndianStringEncoding:
+		case NSUTF16LittleEndianStringEncoding:
+		case NSUTF16StringEncoding:
+		case NSUTF32BigEndianStringEncoding:
+		case NSUTF32LittleEndianStringEncoding:
+		case NSUTF32StringEncoding:
+			return YES;
+	}
+
+	return NO;
+}
+
+/**
+ * Initialise the measurer, building the advance lookup table for the font.
+ */
+- (id)initWithFont:(NSFont *)aFont
+{
+	if ((self = [super init])) {
+		font = [aFont retain];
+		stringAttributes = [[NSDictionary alloc] initWithObjectsAndKeys:font, NSFontAttributeName, nil];
+
+		unichar c;
+
+		for (NSUInteger i = 0; i < 256; i++)
+		{
+			c = (unichar)i;
+			latin1Advances[i] = [[NSString stringWithCharacters:&c length:1] sizeWithAttributes:stringAttributes].width;
+		}
+
+		// Tables display linebreaks as pilcrows and reverse pilcrows, so measure them as such
+		c = 0x204B;
+		reversePilcrowAdvance = [[NSString stringWithCharacters:&c length:1] sizeWithAttributes:stringAttributes].width;
+
+		latin1Advances['\n'] = latin1Advances[0xB6];
+		latin1Advances['\r'] = reversePilcrowAdvance;
+		latin1Advances[0x0B] = reversePilcrowAdvance;
+		latin1Advances[0x0C] = reversePilcrowAdvance;
+		latin1Advances[0x85] = reversePilcrowAdvance;
+
+		// Numeric and date values only consist of a small set of ASCII characters; use the widest
+		// of these so widths can be derived from the value length alone.
+		widestNumericAdvance = 0;
+
+		for (const char *numericChar = "0123456789-+.:eE"; *numericChar; numericChar++)
+		{
+			if (latin1Advances[(unsigned char)*numericChar] > widestNumericAdvance) {
+				widestNumericAdvance = latin1Advances[(unsigned char)*numericChar];
+			}
+		}
+
+		widestAdvance = reversePilcrowAdvance;
+
+		for (NSUInteger i = 0; i < 256; i++)
+		{
+			if (latin1Advances[i] > widestAdvance) widestAdvance = latin1Advances[i];
+		}
+
+		// MySQL's latin1 is cp1252, which maps 0x80-0x9F to punctuation such as the em dash
+		// and per mille sign instead of control characters; include those in the widest advance
+		for (unsigned char b = 0x80; b <= 0x9F; b++)
+		{
+			NSString *cp1252Character = [[NSString alloc] initWithBytes:&b length:1 encoding:NSWindowsCP1252StringEncoding];
+			if (cp1252Character) {
+				CGFloat advance = [cp1252Character sizeWithAttributes:stringAttributes].width;
+				if (advance > widestAdvance) widestAdvance = advance;
+				[cp1252Character release];
+			}
+		}
+	}
+
+	return self;
+}
+
+#pragma mark -
+
+/**
+ * Returns the estimated single-line width of the supplied string.
+ */
+- (CGFloat)widthOfString:(NSString *)aString
+{
+	NSUInteger length = [aString length];
+
+	if (!length) return 0;
+
+	unichar stackBuffer[SP_MEASURER_STACK_BUFFER_LENGTH];
+	unichar *characters = stackBuffer;
+
+	if (length > SP_MEASURER_STACK_BUFFER_LENGTH) {
+		characters = malloc(sizeof(unichar) * length);
+	}
+
+	[aString getCharacters:characters range:NSMakeRange(0, length)];
+
+	CGFloat width = [self _widthOfCharacters:characters length:length];
+
+	if (characters != stackBuffer) free(characters);
+
+	return width;
+}
+
+/**
+ * Returns the estimated width of a numeric or date value of the supplied length,
+ * allowing widths to be derived from raw data lengths without creating strings.
+ */
+- (CGFloat)widthOfNumericStringWithLength:(NSUInteger)length
+{
+	return widestNumericAdvance * length;
+}
+
+/**
+ * Returns an upper bound for the width of a string whose encoded form is the supplied
+ * number of bytes long.  Every character takes up at least one byte, and characters
+ * outside the Latin-1 range take up several bytes in the multibyte encodings used
+ * for them, so this allows cells to be skipped without decoding them if they can't
+ * be wider than a width already found.
+ *
+ * This only holds for the encodings accepted by +byteLengthBoundsWidthForEncoding:.
+ */
+- (CGFloat)maximumWidthOfStringWithByteLength:(NSUInteger)byteLength
+{
+	return widestAdvance * byteLength;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Sums the advances of the supplied characters, using the lookup table for the
+ * Latin-1 range and measuring runs of other characters as a whole so that
+ * composed characters and complex scripts are still handled by the text system.
+ */
+- (CGFloat)_widthOfCharacters:(const unichar *)characters length:(NSUInteger)length
+{
+	CGFloat width = 0;
+	NSUInteger i, runStart = NSNotFound;
+	unichar c;
+
+	for (i = 0; i <= length; i++)
+	{
+		c = (i < length) ? characters[i] : 0;
+
+		// Collect characters outside of the lookup table into runs
+		if (i < length && c > 0xFF && c != 0x2028 && c != 0x2029) {
+			if (runStart == NSNotFound) runStart = i;
+			continue;
+		}
+
+		// Measure any completed run of other characters
+		if (runStart != NSNotFound) {
+			NSString *run = [[NSString alloc] initWithCharactersNoCopy:(unichar *)(characters + runStart) length:(i - runStart) freeWhenDone:NO];
+			width += [run sizeWithAttributes:stringAttributes].width;
+			[run release];
+			runStart = NSNotFound;
+		}
+
+		if (i == length) break;
+
+		if (c > 0xFF) {
+			width += reversePilcrowAdvance;
+			continue;
+		}
+
+		width += latin1Advances[c];
+
+		// CRLF sequences are displayed as a single reverse pilcrow
+		if (c == '\r' && i + 1 < length && characters[i + 1] == '\n') i++;
+	}
+
+	return width;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(font);
+	SPClear(stringAttributes);
+
+	[super dealloc];
+}
+
+@end
@@ -0,0 +1,88 @@
+//
+//  SPXMLExportRowSerializer.h
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * How the cells of a column are written by an SPXMLExportRowSerializer.
+ */
+typedef enum {
+	SPXMLExportCellAsString   = 0, // Text, escaped as required
+	SPXMLExportCellAsBit      = 1, // BIT values, written as zero-padded strings of bits
+	SPXMLExportCellAsGeometry = 2, // Geometry data, written as WKT text
+	SPXMLExportCellAsBinary   = 3  // Binary data, decoded using the output encoding
+} SPXMLExportCellFormat;
+
+/**
+ * @class SPXMLExportRowSerializer SPXMLExportRowSerializer.h
+ *
+ * Serializes the rows of an XML export into a byte buffer.  The opening, closing and NULL tags of
+ * each column are compiled once into byte templates, so each cell is written as a template copy
+ * followed by its escaped contents.  Escaping scans for '&', '<', '>' and '"' 16 bytes at a time
+ * where the CPU allows and copies the runs between them directly, so cells which need no escaping
+ * are written without creating any objects.
+ *
+ * Rows are serialized in the output encoding when ASCII delimiters can be matched bytewise in it,
+ * and otherwise as UTF-8 which is converted to the output encoding when written.
+ */
+@interface SPXMLExportRowSerializer : NSObject
+{
+	NSUInteger columnCount;
+	SPXMLExportCellFormat *cellFormats;
+	NSUInteger *bitLengths;
+
+	NSStringEncoding stringEncoding;
+	NSStringEncoding outputEncoding;
+	NSStringEncoding bufferEncoding;
+
+	NSMutableData *templates;
+	const char *templateBytes;
+	NSRange *openingTagRanges;
+	NSRange *closingTagRanges;
+	NSRange *nullTagRanges;
+	NSRange rowOpeningTagRange;
+	NSRange rowClosingTagRange;
+
+	char *buffer;
+	NSUInteger bufferLength;
+	NSUInteger bufferCapacity;
+}
+
+- (id)initWithFieldNames:(NSArray *)fieldNames format:(SPXMLExportFormat)format nullString:(NSString *)null stringEncoding:(NSStringEncoding)encoding outputEncoding:(NSStringEncoding)theOutputEncoding;
+
+- (void)setFormat:(SPXMLExportCellFormat)format bitLength:(NSUInteger)bitLength forColumn:(NSUInteger)column;
+- (SPXMLExportCellFormat)formatForColumn:(NSUInteger)column;
+
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths;
+- (void)appendRow:(NSArray *)row;
+
+- (NSUInteger)length;
+- (void)writeToOutput:(id)output;
+- (void)reset;
+
+@end
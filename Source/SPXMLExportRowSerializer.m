@@ -0,0 +1,399 @@
+//
+//  SPXMLExportRowSerializer.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPXMLExportRowSerializer.h"
+#import "SPExportByteScanning.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The initial size of the output buffer, which grows as required
+static const NSUInteger SPXMLExportRowSerializerInitialCapacity = 65536;
+
+// The widest BIT field supported by MySQL
+static const NSUInteger SPXMLExportMaximumBitLength = 64;
+
+// The bytes written as entities within cells, as by -[NSString HTMLEscapeString]
+static const unsigned char SPXMLExportEscapedBytes[4] = { '&', '<', '>', '"' };
+
+@interface SPXMLExportRowSerializer ()
+
+- (NSRange)_addTemplate:(NSString *)string;
+- (void)_ensureCapacity:(NSUInteger)additionalLength;
+- (void)_appendTemplate:(NSRange)templateRange;
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length;
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length encoding:(NSStringEncoding)encoding;
+- (void)_appendEscapedString:(NSString *)string;
+- (void)_appendBitBytes:(const char *)bytes length:(NSUInteger)length padLength:(NSUInteger)padLength;
+
+@end
+
+@implementation SPXMLExportRowSerializer
+
+/**
+ * Initialise a serializer for rows with the supplied field names, with all columns written as strings.
+ *
+ * @param fieldNames        The names of the fields, used for the tags of each column
+ * @param format            The XML format to write
+ * @param null              The string written for NULL values in the plain format
+ * @param encoding          The encoding of text in raw rows
+ * @param theOutputEncoding The encoding of the output
+ */
+- (id)initWithFieldNames:(NSArray *)fieldNames format:(SPXMLExportFormat)format nullString:(NSString *)null stringEncoding:(NSStringEncoding)encoding outputEncoding:(NSStringEncoding)theOutputEncoding
+{
+	if ((self = [super init])) {
+		columnCount = [fieldNames count];
+		cellFormats = calloc(MAX(columnCount, 1), sizeof(SPXMLExportCellFormat));
+		bitLengths = calloc(MAX(columnCount, 1), sizeof(NSUInteger));
+
+		stringEncoding = encoding;
+		outputEncoding = theOutputEncoding;
+		bufferEncoding = SPExportEncodingIsASCIICompatible(theOutputEncoding) ? theOutputEncoding : NSUTF8StringEncoding;
+
+		// Compile the tags of each column once, with the field names already escaped
+		templates = [[NSMutableData alloc] init];
+		openingTagRanges = calloc(MAX(columnCount, 1), sizeof(NSRange));
+		closingTagRanges = calloc(MAX(columnCount, 1), sizeof(NSRange));
+		nullTagRanges = calloc(MAX(columnCount, 1), sizeof(NSRange));
+
+		NSString *escapedNULLString = [(null ? null : @"") HTMLEscapeString];
+
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			NSString *escapedFieldName = [[[fieldNames objectAtIndex:i] description] HTMLEscapeString];
+
+			if (format == SPXMLExportMySQLFormat) {
+				openingTagRanges[i] = [self _addTemplate:[NSString stringWithFormat:@"\t\t<field name=\"%@\">", escapedFieldName]];
+				closingTagRanges[i] = [self _addTemplate:@"</field>\n"];
+				nullTagRanges[i]    = [self _addTemplate:[NSString stringWithFormat:@"\t\t<field name=\"%@\" xsi:nil=\"true\" />\n", escapedFieldName]];
+			}
+			else {
+				openingTagRanges[i] = [self _addTemplate:[NSString stringWithFormat:@"\t\t<%@>", escapedFieldName]];
+				closingTagRanges[i] = [self _addTemplate:[NSString stringWithFormat:@"</%@>\n", escapedFieldName]];
+				nullTagRanges[i]    = [self _addTemplate:[NSString stringWithFormat:@"\t\t<%@>%@</%@>\n", escapedFieldName, escapedNULLString, escapedFieldName]];
+			}
+		}
+
+		rowOpeningTagRange = [self _addTemplate:@"\t<row>\n"];
+		rowClosingTagRange = [self _addTemplate:@"\t</row>\n\n"];
+
+		templateBytes = [templates bytes];
+
+		bufferCapacity = SPXMLExportRowSerializerInitialCapacity;
+		bufferLength = 0;
+		buffer = malloc(bufferCapacity);
+	}
+
+	return self;
+}
+
+/**
+ * Set how the cells of the specified column are written.  The bit length is the width BIT
+ * values in raw rows are padded to, and is otherwise ignored.
+ */
+- (void)setFormat:(SPXMLExportCellFormat)format bitLength:(NSUInteger)bitLength forColumn:(NSUInteger)column
+{
+	if (column >= columnCount) return;
+
+	cellFormats[column] = format;
+	bitLengths[column] = MIN(bitLength, SPXMLExportMaximumBitLength);
+}
+
+- (SPXMLExportCellFormat)formatForColumn:(NSUInteger)column
+{
+	return (column < columnCount) ? cellFormats[column] : SPXMLExportCellAsString;
+}
+
+#pragma mark -
+#pragma mark Row serialization
+
+/**
+ * Append a row element with the cells of a raw row, as returned by
+ * -[SPMySQLStreamingResult getRawRowCells:lengths:].
+ */
+- (void)appendRawRowCells:(const char **)cells lengths:(unsigned long *)lengths
+{
+	[self _appendTemplate:rowOpeningTagRange];
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		const char *cell = cells[i];
+		NSUInteger length = lengths[i];
+
+		if (cell == NULL) {
+			[self _appendTemplate:nullTagRanges[i]];
+			continue;
+		}
+
+		[self _appendTemplate:openingTagRanges[i]];
+
+		switch (cellFormats[i])
+		{
+			case SPXMLExportCellAsString:
+				[self _appendEscapedBytes:cell length:length encoding:stringEncoding];
+				break;
+
+			case SPXMLExportCellAsBinary:
+				[self _appendEscapedBytes:cell length:length encoding:outputEncoding];
+				break;
+
+			case SPXMLExportCellAsBit:
+				[self _appendBitBytes:cell length:length padLength:bitLengths[i]];
+				break;
+
+			case SPXMLExportCellAsGeometry:
+				if (length) {
+					SPMySQLGeometryData *geometry = [[SPMySQLGeometryData alloc] initWithBytes:cell length:length];
+
+					[self _appendEscapedString:[geometry wktString]];
+
+					[geometry release];
+				}
+				break;
+		}
+
+		[self _appendTemplate:closingTagRanges[i]];
+	}
+
+	[self _appendTemplate:rowClosingTagRange];
+}
+
+/**
+ * Append a row element with the cells of a row supplied as an array of objects.
+ */
+- (void)appendRow:(NSArray *)row
+{
+	NSNull *null = [NSNull null];
+	NSUInteger count = MIN([row count], columnCount);
+
+	[self _appendTemplate:rowOpeningTagRange];
+
+	for (NSUInteger i = 0; i < count; i++)
+	{
+		id object = [row objectAtIndex:i];
+
+		if (object == null) {
+			[self _appendTemplate:nullTagRanges[i]];
+			continue;
+		}
+
+		[self _appendTemplate:openingTagRanges[i]];
+
+		if ([object isKindOfClass:[NSData class]]) {
+			[self _appendEscapedBytes:[object bytes] length:[object length] encoding:outputEncoding];
+		}
+		else if ([object isKindOfClass:[SPMySQLGeometryData class]]) {
+			[self _appendEscapedString:[object wktString]];
+		}
+		else {
+			[self _appendEscapedString:[object description]];
+		}
+
+		[self _appendTemplate:closingTagRanges[i]];
+	}
+
+	[self _appendTemplate:rowClosingTagRange];
+}
+
+#pragma mark -
+#pragma mark Buffer handling
+
+- (NSUInteger)length
+{
+	return bufferLength;
+}
+
+/**
+ * Write the buffered output to the supplied export file or file handle, and empty the buffer.
+ */
+- (void)writeToOutput:(id)output
+{
+	if (!bufferLength) return;
+
+	NSData *bufferData = [NSData dataWithBytesNoCopy:buffer length:bufferLength freeWhenDone:NO];
+
+	// Output serialized as UTF-8 is converted to the output encoding; the buffer only ever holds
+	// complete rows so it always ends on a character boundary.
+	if (bufferEncoding != outputEncoding) {
+		NSString *string = [[NSString alloc] initWithData:bufferData encoding:bufferEncoding];
+		NSData *outputData = [string dataUsingEncoding:outputEncoding allowLossyConversion:YES];
+
+		if (outputData) bufferData = outputData;
+
+		[string release];
+	}
+
+	[output writeData:bufferData];
+
+	bufferLength = 0;
+}
+
+/**
+ * Discard any buffered output.
+ */
+- (void)reset
+{
+	bufferLength = 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (NSRange)_addTemplate:(NSString *)string
+{
+	NSData *templateData = [string dataUsingEncoding:bufferEncoding allowLossyConversion:YES];
+	NSRange templateRange = NSMakeRange([templates length], [templateData length]);
+
+	[templates appendData:templateData];
+
+	return templateRange;
+}
+
+- (void)_ensureCapacity:(NSUInteger)additionalLength
+{
+	if (bufferLength + additionalLength <= bufferCapacity) return;
+
+	while (bufferLength + additionalLength > bufferCapacity) bufferCapacity *= 2;
+
+	buffer = realloc(buffer, bufferCapacity);
+}
+
+- (void)_appendTemplate:(NSRange)templateRange
+{
+	[self _ensureCapacity:templateRange.length];
+
+	memcpy(buffer + bufferLength, templateBytes + templateRange.location, templateRange.length);
+	bufferLength += templateRange.length;
+}
+
+/**
+ * Append bytes in the buffer encoding, writing '&', '<', '>' and '"' as entities.  The runs of
+ * bytes between them are copied in one go.
+ */
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length
+{
+	NSUInteger runStart = 0;
+
+	while (runStart < length)
+	{
+		NSUInteger escapeIndex = runStart + SPExportFindByteInSet(bytes + runStart, length - runStart, SPXMLExportEscapedBytes, 4);
+		NSUInteger runLength = escapeIndex - runStart;
+
+		[self _ensureCapacity:runLength + 6];
+
+		memcpy(buffer + bufferLength, bytes + runStart, runLength);
+		bufferLength += runLength;
+
+		if (escapeIndex == length) break;
+
+		const char *entity;
+
+		switch (bytes[escapeIndex])
+		{
+			case '&': entity = "&amp;"; break;
+			case '<': entity = "&lt;"; break;
+			case '>': entity = "&gt;"; break;
+			default:  entity = "&quot;"; break;
+		}
+
+		NSUInteger entityLength = strlen(entity);
+
+		memcpy(buffer + bufferLength, entity, entityLength);
+		bufferLength += entityLength;
+
+		runStart = escapeIndex + 1;
+	}
+}
+
+/**
+ * Append escaped bytes in the supplied encoding, converting them to the buffer encoding first if required.
+ */
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length encoding:(NSStringEncoding)encoding
+{
+	if (encoding == bufferEncoding) {
+		[self _appendEscapedBytes:bytes length:length];
+		return;
+	}
+
+	NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:encoding];
+
+	if (!string) string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSASCIIStringEncoding];
+
+	if (string) [self _appendEscapedString:string];
+
+	[string release];
+}
+
+- (void)_appendEscapedString:(NSString *)string
+{
+	NSData *stringData = [string dataUsingEncoding:bufferEncoding allowLossyConversion:YES];
+
+	[self _appendEscapedBytes:[stringData bytes] length:[stringData length]];
+}
+
+/**
+ * Append BIT data as a string of bits, zero-padded to the field's bit length in the same way
+ * SPMySQL converts BIT values to strings.
+ */
+- (void)_appendBitBytes:(const char *)bytes length:(NSUInteger)length padLength:(NSUInteger)padLength
+{
+	NSUInteger bitLength = MIN(length << 3, padLength);
+
+	[self _ensureCapacity:padLength];
+
+	char *output = buffer + bufferLength;
+
+	memset(output, '0', padLength);
+
+	// Fill in from the least significant bit, the rightmost bit of the last byte
+	for (NSUInteger i = 0; i < bitLength; i++)
+	{
+		if (bytes[(length - 1) - (i >> 3)] & (1 << (i % 8))) output[padLength - 1 - i] = '1';
+	}
+
+	bufferLength += padLength;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	SPClear(templates);
+
+	free(cellFormats);
+	free(bitLengths);
+	free(openingTagRanges);
+	free(closingTagRanges);
+	free(nullTagRanges);
+	free(buffer);
+
+	[super dealloc];
+}
+
+@end
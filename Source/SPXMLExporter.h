@@ -42,8 +42,6 @@
 {
 	NSObject <SPXMLExporterProtocol> *delegate;
 	
-	NSArray *xmlDataArray;
-
 	NSString *xmlTableName;
 	NSString *xmlNULLString;
 	
@@ -58,11 +56,6 @@
  */
 @property (readwrite, assign) NSObject <SPXMLExporterProtocol> *delegate;
 
-/**
- * @property xmlDataArray Data array
- */
-@property (readwrite, retain) NSArray *xmlDataArray;
-
 /**
  * @property xmlTableName Table name
  */
@@ -32,13 +32,22 @@
 #import "SPExportFile.h"
 #import "SPFileHandle.h"
 #import "SPExportUtilities.h"
+#import "SPXMLExportRowSerializer.h"
 
 #import <SPMySQL/SPMySQL.h>
 
+// The length of serialized rows collected before they are written to the file
+static const NSUInteger SPXMLExportSerializedWriteLength = 262144;
+
+@interface SPXMLExporter ()
+
+- (BOOL)_writeRowsFromSource:(id <SPExportRowSource>)rowSource fieldNames:(NSArray *)fieldNames;
+
+@end
+
 @implementation SPXMLExporter
 
 @synthesize delegate;
-@synthesize xmlDataArray;
 @synthesize xmlTableName;
 @synthesize xmlNULLString;
 @synthesize xmlOutputIncludeStructure;
@@ -67,26 +76,23 @@
 {
 	BOOL isTableExport = NO;
 	
-	NSArray *xmlRow = nil;
 	NSArray *fieldNames = nil;
-	NSString *dataConversionString = nil;
 	
 	// Result sets
 	SPMySQLResult *statusResult = nil;
 	SPMySQLResult *structureResult = nil;
 	SPMySQLFastStreamingResult *streamingResult = nil;
 	
-	NSMutableArray *xmlTags    = [NSMutableArray array];
+	id <SPExportRowSource> rowSource = [self exportRowSource];
+	
 	NSMutableString *xmlString = [NSMutableString string];
-	NSMutableString *xmlItem   = [NSMutableString string];
 	
-	NSUInteger xmlRowCount = 0;
 	double lastProgressValue = 0;
-	NSUInteger i, totalRows, currentRowIndex, currentPoolDataLength;
+	NSUInteger i, totalRows, currentRowIndex;
 	
-	// Check to see if we have at least a table name or data array
-	if ((![self xmlTableName] && ![self xmlDataArray]) ||
-		([[self xmlTableName] length] == 0 && [[self xmlDataArray] count] == 0) ||
+	// Check to see if we have at least a table name or row source
+	if ((![self xmlTableName] && !rowSource) ||
+		([[self xmlTableName] length] == 0 && ![[rowSource exportFieldNames] count]) ||
 		(([self xmlFormat] == SPXMLExportMySQLFormat) && ((![self xmlOutputIncludeStructure]) && (![self xmlOutputIncludeContent]))) ||
 		(([self xmlFormat] == SPXMLExportPlainFormat) && (![self xmlNULLString])))
 	{
@@ -99,13 +105,15 @@
 	// Mark the process as running
 	[self setExportProcessIsRunning:YES];
 		
-	// Make a streaming request for the data if the data array isn't set
-	if ((![self xmlDataArray]) && [self xmlTableName]) {
+	// Make a streaming request for the data if there's no row source
+	if (!rowSource && [self xmlTableName]) {
 		
 		isTableExport = YES;
 		
 		totalRows       = [[connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [[self xmlTableName] backtickQuotedString]]] integerValue];
 		streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self xmlTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming]];
+
+		[self beginRecordingTable:[self xmlTableName] readingResult:streamingResult];
 	
 		// Only include the structure if necessary
 		if (([self xmlFormat] == SPXMLExportMySQLFormat) && [self xmlOutputIncludeStructure]) {
@@ -160,21 +168,40 @@
 		[self writeString:xmlString];
 	}
 	else {
-		totalRows = [[self xmlDataArray] count];
+		totalRows = [rowSource numberOfExportRows];
 	}
 	
 	// Only proceed to export the content if this is not a table export or it is and include content is selected
 	if ((!isTableExport) || (isTableExport && [self xmlOutputIncludeContent])) {
 	
-		// Set up an array of encoded field names as opening and closing tags
-		fieldNames = ([self xmlDataArray]) ? NSArrayObjectAtIndex([self xmlDataArray], 0) : [streamingResult fieldNames];
+		// Set up the serializer, which compiles the tags of each field once
+		fieldNames = (rowSource) ? [rowSource exportFieldNames] : [streamingResult fieldNames];
 		
-		for (i = 0; i < [fieldNames count]; i++) 
-		{
-			[xmlTags addObject:[NSMutableArray array]];
+		SPXMLExportRowSerializer *rowSerializer = [[SPXMLExportRowSerializer alloc] initWithFieldNames:fieldNames format:[self xmlFormat] nullString:[self xmlNULLString] stringEncoding:[connection stringEncoding] outputEncoding:[self exportOutputEncoding]];
+		
+		// Rows of a table are serialized directly from the raw MySQL row data, which carries no object
+		// types, so BIT, geometry and binary data are identified from the result fields
+		const char **rawRowCells = NULL;
+		unsigned long *rawRowCellLengths = NULL;
+		
+		if (streamingResult) {
+			for (i = 0; i < [fieldNames count]; i++)
+			{
+				SPMySQLResultFieldProcessor fieldProcessor = [streamingResult fieldProcessorForFieldAtIndex:i];
+				
+				if (fieldProcessor == SPMySQLResultFieldAsBit) {
+					[rowSerializer setFormat:SPXMLExportCellAsBit bitLength:[streamingResult bitLengthForFieldAtIndex:i] forColumn:i];
+				}
+				else if (fieldProcessor == SPMySQLResultFieldAsGeometry) {
+					[rowSerializer setFormat:SPXMLExportCellAsGeometry bitLength:0 forColumn:i];
+				}
+				else if (fieldProcessor == SPMySQLResultFieldAsBlob) {
+					[rowSerializer setFormat:SPXMLExportCellAsBinary bitLength:0 forColumn:i];
+				}
+			}
 			
-			[NSArrayObjectAtIndex(xmlTags, i) addObject:[NSString stringWithFormat:@"\t\t<%@>", [[NSArrayObjectAtIndex(fieldNames, i) description] HTMLEscapeString]]];
-			[NSArrayObjectAtIndex(xmlTags, i) addObject:[NSString stringWithFormat:@"</%@>\n", [[NSArrayObjectAtIndex(fieldNames, i) description] HTMLEscapeString]]];
+			rawRowCells = malloc(sizeof(char *) * MAX([fieldNames count], 1));
+			rawRowCellLengths = malloc(sizeof(unsigned long) * MAX([fieldNames count], 1));
 		}
 		
 		// If required, write an opening tag in the form of the table name
@@ -182,21 +209,25 @@
 			[self writeString:[NSString stringWithFormat:@"\t<%@>\n", ([self xmlTableName]) ? [[self xmlTableName] HTMLEscapeString] : @"custom"]];
 		}
 		
-		// Set up the starting row, which is 0 for streaming result sets and
-		// 1 for supplied arrays which include the column headers as the first row.
 		currentRowIndex = 0;
 		
-		if ([self xmlDataArray]) currentRowIndex++;
-		
 		// Drop into the processing loop
 		NSAutoreleasePool *xmlExportPool = [[NSAutoreleasePool alloc] init];
 		
-		currentPoolDataLength = 0;
-		
 		// Inform the delegate that we are about to start writing the data to disk
 		[delegate performSelectorOnMainThread:@selector(xmlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
 		
-		while (1) 
+		// Rows of a row source are serialized in concurrent chunks
+		if (rowSource && ![self _writeRowsFromSource:rowSource fieldNames:fieldNames]) {
+			SPClear(rowSerializer);
+			
+			[xmlExportPool release];
+			
+			return;
+		}
+		
+		// Rows of a table are read from the streaming result
+		while (streamingResult) 
 		{
 			// Check for cancellation flag
 			if ([self isCancelled]) {
@@ -205,101 +236,32 @@
 					[streamingResult cancelResultLoad];
 				}
 				
+				SPClear(rowSerializer);
+				if (rawRowCells) free(rawRowCells);
+				if (rawRowCellLengths) free(rawRowCellLengths);
+				
 				[xmlExportPool release];
 				
 				return;
 			}
 			
-			// Retrieve the next row from the supplied data, either directly from the array...
-			if ([self xmlDataArray]) {
-				xmlRow = NSArrayObjectAtIndex([self xmlDataArray], currentRowIndex);
-			} 
-			// Or by reading an appropriate row from the streaming result
-			else {
-				xmlRow = [streamingResult getRowAsArray];
-				
-				if (!xmlRow) break;
-			}
+			// Serialize the next raw row from the streaming result
+			if (![streamingResult getRawRowCells:rawRowCells lengths:rawRowCellLengths]) break;
 			
-			// Get the cell count if we don't already have it stored
-			if (!xmlRowCount) xmlRowCount = [xmlRow count];
+			[rowSerializer appendRawRowCells:rawRowCells lengths:rawRowCellLengths];
 			
-			// Construct the row
-			[xmlString setString:@"\t<row>\n"];
+			// Update the progress counter and progress bar
+			currentRowIndex++;
 			
-			for (i = 0; i < xmlRowCount; i++) 
-			{
-				// Check for cancellation flag
-				if ([self isCancelled]) {
-					if (streamingResult) {
-						[connection cancelCurrentQuery];
-						[streamingResult cancelResultLoad];
-					}
-					
-					[xmlExportPool release];
-					
-					return;
-				}
-				
-				BOOL dataIsNULL = NO;
-				id data = NSArrayObjectAtIndex(xmlRow, i);
+			// Write the serialized rows to the filehandle in large blocks
+			if ([rowSerializer length] >= SPXMLExportSerializedWriteLength) {
+				[rowSerializer writeToOutput:[self exportOutputFile]];
 				
-				// Retrieve the contents of this tag
-				if ([data isKindOfClass:[NSData class]]) {
-					dataConversionString = [[NSString alloc] initWithData:data encoding:[self exportOutputEncoding]];
-					
-					if (dataConversionString == nil) {
-						dataConversionString = [[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding];
-					}
-					
-					[xmlItem setString:[NSString stringWithString:dataConversionString]];
-					[dataConversionString release];
-				}
-
-				// Check for null value using a pointer comparison; as [NSNull null] is a singleton this works correctly.
-				else if (data == [NSNull null]) {
-					dataIsNULL = YES;
-					
-					if ([self xmlFormat] == SPXMLExportPlainFormat) {
-						[xmlItem setString:[self xmlNULLString]];
-					}
-				}
-				else if ([data isKindOfClass:[SPMySQLGeometryData class]]) {
-					[xmlItem setString:[data wktString]];
-				}
-				else {
-					[xmlItem setString:[data description]];
-				}
-				
-				if ([self xmlFormat] == SPXMLExportMySQLFormat) {
-					[xmlString appendFormat:@"\t\t<field name=\"%@\"", [[NSArrayObjectAtIndex(fieldNames, i) description] HTMLEscapeString]];
-					
-					if (dataIsNULL) {
-						[xmlString appendString:@" xsi:nil=\"true\" />\n"];
-					}
-					else {
-						[xmlString appendFormat:@">%@</field>\n", [xmlItem HTMLEscapeString]];
-					}
-				}
-				else if ([self xmlFormat] == SPXMLExportPlainFormat) {
-					// Add the opening and closing tag and the contents to the XML string
-					[xmlString appendString:NSArrayObjectAtIndex(NSArrayObjectAtIndex(xmlTags, i), 0)];
-					[xmlString appendString:[xmlItem HTMLEscapeString]];
-					[xmlString appendString:NSArrayObjectAtIndex(NSArrayObjectAtIndex(xmlTags, i), 1)];
-				}
+				// Drain the autorelease pool with each write to keep memory usage low
+				[xmlExportPool release];
+				xmlExportPool = [[NSAutoreleasePool alloc] init];
 			}
 			
-			[xmlString appendString:@"\t</row>\n\n"];
-			
-			// Record the total length for use with pool flushing
-			currentPoolDataLength += [xmlString length];
-			
-			// Write the row to the filehandle
-			[self writeString:xmlString];
-			
-			// Update the progress counter and progress bar
-			currentRowIndex++;
-			
 			// Update the progress
 			if (totalRows && (currentRowIndex * ([self exportMaxProgress] / totalRows)) > lastProgressValue) {
 				
@@ -312,17 +274,16 @@
 			
 			// Inform the delegate that the export's progress has been updated
 			[delegate performSelectorOnMainThread:@selector(xmlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
-			
-			// Drain the autorelease pool as required to keep memory usage low
-			if (currentPoolDataLength > 250000) {
-				[xmlExportPool release];
-				xmlExportPool = [[NSAutoreleasePool alloc] init];
-			}
-			
-			// If an array was supplied and we've processed all rows, break
-			if ([self xmlDataArray] && totalRows == currentRowIndex) break;
 		}
 		
+		[rowSerializer writeToOutput:[self exportOutputFile]];
+		
+		SPClear(rowSerializer);
+		if (rawRowCells) free(rawRowCells);
+		if (rawRowCellLengths) free(rawRowCellLengths);
+		
+		[self endRecordingTable:[self xmlTableName]];
+		
 		if (([self xmlFormat] == SPXMLExportMySQLFormat) && isTableExport) {
 			[self writeString:@"\t</table_data>\n\n"];
 		}
@@ -343,11 +304,47 @@
 	[delegate performSelectorOnMainThread:@selector(xmlExportProcessComplete:) withObject:self waitUntilDone:NO];
 }
 
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Write all the rows of the supplied row source, serializing chunks of rows concurrently.
+ *
+ * @return NO if the export was cancelled
+ */
+- (BOOL)_writeRowsFromSource:(id <SPExportRowSource>)rowSource fieldNames:(NSArray *)fieldNames
+{
+	NSUInteger totalRows = [rowSource numberOfExportRows];
+
+	__block double lastProgressValue = 0;
+
+	return [self writeRowsFromSource:rowSource serializingChunksUsingBlock:^id(NSRange rowRange) {
+		SPXMLExportRowSerializer *chunkSerializer = [[SPXMLExportRowSerializer alloc] initWithFieldNames:fieldNames format:[self xmlFormat] nullString:[self xmlNULLString] stringEncoding:[connection stringEncoding] outputEncoding:[self exportOutputEncoding]];
+
+		for (NSUInteger rowIndex = rowRange.location; rowIndex < NSMaxRange(rowRange); rowIndex++)
+		{
+			[chunkSerializer appendRow:[rowSource exportRowAtIndex:rowIndex]];
+		}
+
+		return [chunkSerializer autorelease];
+	} progressHandler:^(NSUInteger rowsWritten) {
+		double progress = (rowsWritten * ([self exportMaxProgress] / totalRows));
+
+		if (progress > lastProgressValue) {
+			[self setExportProgressValue:progress];
+
+			lastProgressValue = progress;
+
+			// Inform the delegate that the export's progress has been updated
+			[delegate performSelectorOnMainThread:@selector(xmlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+		}
+	}];
+}
+
 #pragma mark -
 
 - (void)dealloc
 {
-	if (xmlDataArray) SPClear(xmlDataArray);
 	if (xmlTableName) SPClear(xmlTableName);
 	if (xmlNULLString) SPClear(xmlNULLString);
 	
@@ -0,0 +1,758 @@
+//
+//  SPArrowIPCWriterTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPArrowIPCWriter.h"
+
+#import <XCTest/XCTest.h>
+
+// The Type union members and Message headers read back
+enum {
+	SPArrowIPCWriterTestTypeInt = 2,
+	SPArrowIPCWriterTestTypeFloatingPoint = 3,
+	SPArrowIPCWriterTestTypeBinary = 4,
+	SPArrowIPCWriterTestTypeUtf8 = 5,
+	SPArrowIPCWriterTestTypeDecimal = 7,
+	SPArrowIPCWriterTestTypeDate = 8,
+	SPArrowIPCWriterTestTypeTimestamp = 10
+};
+
+enum {
+	SPArrowIPCWriterTestMessageSchema = 1,
+	SPArrowIPCWriterTestMessageDictionaryBatch = 2,
+	SPArrowIPCWriterTestMessageRecordBatch = 3
+};
+
+#pragma mark Flatbuffer reading
+
+static inline uint16_t _SPArrowTestUInt16(const uint8_t *bytes)
+{
+	uint16_t value;
+	memcpy(&value, bytes, 2);
+	return value;
+}
+
+static inline int32_t _SPArrowTestInt32(const uint8_t *bytes)
+{
+	int32_t value;
+	memcpy(&value, bytes, 4);
+	return value;
+}
+
+static inline int64_t _SPArrowTestInt64(const uint8_t *bytes)
+{
+	int64_t value;
+	memcpy(&value, bytes, 8);
+	return value;
+}
+
+/* Returns the root table of a flatbuffer. */
+static inline const uint8_t *_SPArrowTestRoot(const uint8_t *flatbuffer)
+{
+	return flatbuffer + (uint32_t)_SPArrowTestInt32(flatbuffer);
+}
+
+/* Returns a field of a table, located through the table's vtable, or NULL if it isn't set. */
+static const uint8_t *_SPArrowTestField(const uint8_t *table, int field)
+{
+	const uint8_t *vtable = table - _SPArrowTestInt32(table);
+
+	if (4 + field * 2 >= _SPArrowTestUInt16(vtable)) return NULL;
+
+	uint16_t offset = _SPArrowTestUInt16(vtable + 4 + field * 2);
+
+	return offset ? table + offset : NULL;
+}
+
+/* Returns the table, vector or string a field refers to, or NULL if it isn't set. */
+static const uint8_t *_SPArrowTestFieldTarget(const uint8_t *table, int field)
+{
+	const uint8_t *offset = _SPArrowTestField(table, field);
+
+	return offset ? offset + (uint32_t)_SPArrowTestInt32(offset) : NULL;
+}
+
+/* Returns a scalar field of the supplied width, or 0 if it isn't set. */
+static int64_t _SPArrowTestFieldScalar(const uint8_t *table, int field, size_t width)
+{
+	const uint8_t *value = _SPArrowTestField(table, field);
+	int64_t result = 0;
+
+	if (!value) return 0;
+
+	switch (width)
+	{
+		case 1: result = (int8_t)value[0]; break;
+		case 2: result = (int16_t)_SPArrowTestUInt16(value); break;
+		case 4: result = _SPArrowTestInt32(value); break;
+		case 8: result = _SPArrowTestInt64(value); break;
+	}
+
+	return result;
+}
+
+/* Returns the number of elements of a vector, which start four bytes after it. */
+static inline uint32_t _SPArrowTestVectorCount(const uint8_t *vector)
+{
+	return vector ? (uint32_t)_SPArrowTestInt32(vector) : 0;
+}
+
+/* Returns an element of a vector of tables. */
+static inline const uint8_t *_SPArrowTestVectorTable(const uint8_t *vector, uint32_t index)
+{
+	const uint8_t *offset = vector + 4 + index * 4;
+
+	return offset + (uint32_t)_SPArrowTestInt32(offset);
+}
+
+#pragma mark -
+
+/**
+ * An output collecting the data written to it.
+ */
+@interface SPArrowIPCWriterTestOutput : NSObject
+{
+	NSMutableData *data;
+}
+
+@property (readonly) NSMutableData *data;
+
+- (void)writeData:(NSData *)theData;
+
+@end
+
+@implementation SPArrowIPCWriterTestOutput
+
+@synthesize data;
+
+- (id)init
+{
+	if ((self = [super init])) {
+		data = [[NSMutableData alloc] init];
+	}
+
+	return self;
+}
+
+- (void)writeData:(NSData *)theData
+{
+	[data appendData:theData];
+}
+
+- (void)dealloc
+{
+	SPClear(data);
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPArrowIPCWriterTests : XCTestCase
+
+- (NSDictionary *)_fieldNamed:(NSString *)name type:(NSString *)type;
+- (NSDictionary *)_decimalFieldNamed:(NSString *)name byteLength:(NSInteger)byteLength decimals:(NSInteger)decimals;
+- (void)_appendRow:(NSArray *)row toWriter:(SPArrowIPCWriter *)writer;
+- (NSDictionary *)_readArrowFile:(NSData *)data;
+- (NSDictionary *)_readField:(const uint8_t *)field;
+- (NSArray *)_readRecordBatch:(const uint8_t *)recordBatch body:(const uint8_t *)body fields:(NSArray *)fields dictionaries:(NSDictionary *)dictionaries;
+- (id)_valueAtIndex:(int64_t)index ofBuffer:(const uint8_t *)values offsets:(const uint8_t *)offsets field:(NSDictionary *)field;
+
+@end
+
+@implementation SPArrowIPCWriterTests
+
+#pragma mark -
+#pragma mark Helpers
+
+/**
+ * Returns a field definition as supplied by a streaming result.
+ */
+- (NSDictionary *)_fieldNamed:(NSString *)name type:(NSString *)type
+{
+	return @{@"name" : name, @"type" : type};
+}
+
+/**
+ * Returns the field definition of a signed DECIMAL column, whose byte length counts the sign and
+ * point as well as the digits.
+ */
+- (NSDictionary *)_decimalFieldNamed:(NSString *)name byteLength:(NSInteger)byteLength decimals:(NSInteger)decimals
+{
+	return @{@"name" : name, @"type" : @"DECIMAL", @"byte_length" : @(byteLength), @"decimals" : @(decimals)};
+}
+
+/**
+ * Appends a row of raw cells, as read from a streaming result, with NSNull for NULL cells.
+ */
+- (void)_appendRow:(NSArray *)row toWriter:(SPArrowIPCWriter *)writer
+{
+	const char *cells[16];
+	unsigned long lengths[16];
+
+	for (NSUInteger i = 0; i < [row count]; i++)
+	{
+		id cell = [row objectAtIndex:i];
+
+		if (cell == [NSNull null]) {
+			cells[i] = NULL;
+			lengths[i] = 0;
+		}
+		else if ([cell isKindOfClass:[NSData class]]) {
+			cells[i] = [cell bytes];
+			lengths[i] = [cell length];
+		}
+		else {
+			cells[i] = [cell UTF8String];
+			lengths[i] = strlen(cells[i]);
+		}
+	}
+
+	[writer appendRawRowCells:cells lengths:lengths];
+}
+
+/**
+ * Reads an Arrow IPC file written without compression, returning its schema fields, its record
+ * batches as arrays of column values, and whether each dictionary batch was a delta.  The messages
+ * are read in order from the start of the file, and checked against the blocks in the footer.
+ */
+- (NSDictionary *)_readArrowFile:(NSData *)data
+{
+	const uint8_t *bytes = [data bytes];
+	NSUInteger length = [data length];
+
+	XCTAssertGreaterThan(length, (NSUInteger)18);
+	XCTAssertEqual(memcmp(bytes, "ARROW1\0\0", 8), 0);
+	XCTAssertEqual(memcmp(bytes + length - 6, "ARROW1", 6), 0);
+
+	NSMutableArray *fields = [NSMutableArray array];
+	NSMutableArray *batches = [NSMutableArray array];
+	NSMutableArray *dictionaryDeltas = [NSMutableArray array];
+	NSMutableDictionary *dictionaries = [NSMutableDictionary dictionary];
+	NSMutableArray *recordBatchOffsets = [NSMutableArray array];
+	NSMutableArray *dictionaryOffsets = [NSMutableArray array];
+	NSUInteger position = 8;
+
+	while (1)
+	{
+		XCTAssertEqual((uint32_t)_SPArrowTestInt32(bytes + position), (uint32_t)0xFFFFFFFF);
+
+		int32_t metadataLength = _SPArrowTestInt32(bytes + position + 4);
+
+		// The end of stream marker
+		if (!metadataLength) break;
+
+		XCTAssertEqual(metadataLength % 8, 0);
+
+		const uint8_t *message = _SPArrowTestRoot(bytes + position + 8);
+		const uint8_t *header = _SPArrowTestFieldTarget(message, 2);
+		const uint8_t *body = bytes + position + 8 + metadataLength;
+		int64_t bodyLength = _SPArrowTestFieldScalar(message, 3, 8);
+
+		XCTAssertEqual(_SPArrowTestFieldScalar(message, 0, 2), (int64_t)4);
+
+		switch (_SPArrowTestFieldScalar(message, 1, 1))
+		{
+			case SPArrowIPCWriterTestMessageSchema:
+			{
+				const uint8_t *fieldVector = _SPArrowTestFieldTarget(header, 1);
+
+				for (uint32_t i = 0; i < _SPArrowTestVectorCount(fieldVector); i++)
+				{
+					[fields addObject:[self _readField:_SPArrowTestVectorTable(fieldVector, i)]];
+				}
+
+				break;
+			}
+			case SPArrowIPCWriterTestMessageDictionaryBatch:
+			{
+				NSNumber *dictionaryId = @(_SPArrowTestFieldScalar(header, 0, 8));
+				BOOL isDelta = (_SPArrowTestFieldScalar(header, 2, 1) != 0);
+				NSDictionary *valueField = @{@"typeType" : @(SPArrowIPCWriterTestTypeUtf8)};
+				NSArray *values = [[self _readRecordBatch:_SPArrowTestFieldTarget(header, 1) body:body fields:@[valueField] dictionaries:nil] objectAtIndex:0];
+
+				if (isDelta) {
+					[[dictionaries objectForKey:dictionaryId] addObjectsFromArray:values];
+				}
+				else {
+					[dictionaries setObject:[NSMutableArray arrayWithArray:values] forKey:dictionaryId];
+				}
+
+				[dictionaryDeltas addObject:@(isDelta)];
+				[dictionaryOffsets addObject:@(position)];
+
+				break;
+			}
+			case SPArrowIPCWriterTestMessageRecordBatch:
+				[batches addObject:[self _readRecordBatch:header body:body fields:fields dictionaries:dictionaries]];
+				[recordBatchOffsets addObject:@(position)];
+				break;
+			default:
+				XCTFail(@"Unexpected message type");
+		}
+
+		position += 8 + metadataLength + (NSUInteger)bodyLength;
+	}
+
+	// The footer indexes the dictionary and record batches, and repeats the schema
+	int32_t footerLength = _SPArrowTestInt32(bytes + length - 10);
+	const uint8_t *footer = _SPArrowTestRoot(bytes + length - 10 - footerLength);
+	const uint8_t *dictionaryBlocks = _SPArrowTestFieldTarget(footer, 2);
+	const uint8_t *recordBatchBlocks = _SPArrowTestFieldTarget(footer, 3);
+
+	XCTAssertEqual(position + 8, length - 10 - (NSUInteger)footerLength);
+	XCTAssertEqual(_SPArrowTestVectorCount(_SPArrowTestFieldTarget(_SPArrowTestFieldTarget(footer, 1), 1)), (uint32_t)[fields count]);
+	XCTAssertEqual(_SPArrowTestVectorCount(dictionaryBlocks), (uint32_t)[dictionaryOffsets count]);
+	XCTAssertEqual(_SPArrowTestVectorCount(recordBatchBlocks), (uint32_t)[recordBatchOffsets count]);
+
+	for (uint32_t i = 0; i < _SPArrowTestVectorCount(dictionaryBlocks); i++)
+	{
+		XCTAssertEqual(_SPArrowTestInt64(dictionaryBlocks + 4 + i * 24), [[dictionaryOffsets objectAtIndex:i] longLongValue]);
+	}
+
+	for (uint32_t i = 0; i < _SPArrowTestVectorCount(recordBatchBlocks); i++)
+	{
+		XCTAssertEqual(_SPArrowTestInt64(recordBatchBlocks + 4 + i * 24), [[recordBatchOffsets objectAtIndex:i] longLongValue]);
+	}
+
+	return @{@"fields" : fields, @"batches" : batches, @"dictionaryDeltas" : dictionaryDeltas};
+}
+
+/**
+ * Reads a schema field's name, type and dictionary encoding.
+ */
+- (NSDictionary *)_readField:(const uint8_t *)field
+{
+	NSMutableDictionary *result = [NSMutableDictionary dictionary];
+	const uint8_t *name = _SPArrowTestFieldTarget(field, 0);
+	const uint8_t *type = _SPArrowTestFieldTarget(field, 3);
+	const uint8_t *dictionary = _SPArrowTestFieldTarget(field, 4);
+	int64_t typeType = _SPArrowTestFieldScalar(field, 2, 1);
+
+	[result setObject:[[[NSString alloc] initWithBytes:name + 4 length:_SPArrowTestVectorCount(name) encoding:NSUTF8StringEncoding] autorelease] forKey:@"name"];
+	[result setObject:@(typeType) forKey:@"typeType"];
+	[result setObject:@(_SPArrowTestFieldScalar(field, 1, 1) != 0) forKey:@"nullable"];
+
+	switch (typeType)
+	{
+		case SPArrowIPCWriterTestTypeInt:
+			[result setObject:@(_SPArrowTestFieldScalar(type, 0, 4)) forKey:@"bitWidth"];
+			[result setObject:@(_SPArrowTestFieldScalar(type, 1, 1) != 0) forKey:@"isSigned"];
+			break;
+		case SPArrowIPCWriterTestTypeFloatingPoint:
+			[result setObject:@(_SPArrowTestFieldScalar(type, 0, 2)) forKey:@"precision"];
+			break;
+		case SPArrowIPCWriterTestTypeDecimal:
+			[result setObject:@(_SPArrowTestFieldScalar(type, 0, 4)) forKey:@"precision"];
+			[result setObject:@(_SPArrowTestFieldScalar(type, 1, 4)) forKey:@"scale"];
+			[result setObject:@(_SPArrowTestFieldScalar(type, 2, 4)) forKey:@"bitWidth"];
+			break;
+		case SPArrowIPCWriterTestTypeDate:
+		case SPArrowIPCWriterTestTypeTimestamp:
+			[result setObject:@(_SPArrowTestFieldScalar(type, 0, 2)) forKey:@"unit"];
+			break;
+	}
+
+	// Dictionary indices are expected to be signed 32-bit integers
+	if (dictionary) {
+		const uint8_t *indexType = _SPArrowTestFieldTarget(dictionary, 1);
+
+		XCTAssertEqual(_SPArrowTestFieldScalar(indexType, 0, 4), (int64_t)32);
+		XCTAssertEqual(_SPArrowTestFieldScalar(indexType, 1, 1), (int64_t)1);
+
+		[result setObject:@(_SPArrowTestFieldScalar(dictionary, 0, 8)) forKey:@"dictionaryId"];
+	}
+
+	return result;
+}
+
+/**
+ * Reads the columns of a record batch as arrays of values, with NSNull for nulls.
+ */
+- (NSArray *)_readRecordBatch:(const uint8_t *)recordBatch body:(const uint8_t *)body fields:(NSArray *)fields dictionaries:(NSDictionary *)dictionaries
+{
+	NSMutableArray *columns = [NSMutableArray array];
+	const uint8_t *nodes = _SPArrowTestFieldTarget(recordBatch, 1);
+	const uint8_t *buffers = _SPArrowTestFieldTarget(recordBatch, 2);
+	int64_t rowCount = _SPArrowTestFieldScalar(recordBatch, 0, 8);
+	uint32_t bufferIndex = 0;
+
+	// Buffers are always written uncompressed, so no BodyCompression table is set
+	XCTAssertTrue(_SPArrowTestField(recordBatch, 3) == NULL);
+	XCTAssertEqual(_SPArrowTestVectorCount(nodes), (uint32_t)[fields count]);
+
+	for (NSUInteger i = 0; i < [fields count]; i++)
+	{
+		NSDictionary *field = [fields objectAtIndex:i];
+		NSArray *dictionary = ([field objectForKey:@"dictionaryId"]) ? [dictionaries objectForKey:[field objectForKey:@"dictionaryId"]] : nil;
+		int64_t typeType = [[field objectForKey:@"typeType"] longLongValue];
+		BOOL hasOffsets = (!dictionary && (typeType == SPArrowIPCWriterTestTypeUtf8 || typeType == SPArrowIPCWriterTestTypeBinary));
+		const uint8_t *node = nodes + 4 + i * 16;
+		const uint8_t *validity = NULL, *offsets = NULL, *values = NULL;
+		int64_t nullCount = 0;
+
+		XCTAssertEqual(_SPArrowTestInt64(node), rowCount);
+
+		// The validity bitmap is left out when there are no nulls
+		if (_SPArrowTestInt64(buffers + 4 + bufferIndex * 16 + 8)) validity = body + _SPArrowTestInt64(buffers + 4 + bufferIndex * 16);
+		bufferIndex++;
+
+		if (hasOffsets) offsets = body + _SPArrowTestInt64(buffers + 4 + bufferIndex++ * 16);
+		values = body + _SPArrowTestInt64(buffers + 4 + bufferIndex++ * 16);
+
+		NSMutableArray *column = [NSMutableArray arrayWithCapacity:(NSUInteger)rowCount];
+
+		for (int64_t row = 0; row < rowCount; row++)
+		{
+			if (validity && !(validity[row >> 3] & (1 << (row & 7)))) {
+				[column addObject:[NSNull null]];
+				nullCount++;
+			}
+			else if (dictionary) {
+				[column addObject:[dictionary objectAtIndex:(NSUInteger)_SPArrowTestInt32(values + row * 4)]];
+			}
+			else {
+				[column addObject:[self _valueAtIndex:row ofBuffer:values offsets:offsets field:field]];
+			}
+		}
+
+		XCTAssertEqual(_SPArrowTestInt64(node + 8), nullCount);
+
+		[columns addObject:column];
+	}
+
+	XCTAssertEqual(bufferIndex, _SPArrowTestVectorCount(buffers));
+
+	return columns;
+}
+
+/**
+ * Returns a value of a column as an object: a number for numeric, decimal, date and timestamp
+ * columns, the unscaled value for decimals, a string for text and data for binary.
+ */
+- (id)_valueAtIndex:(int64_t)index ofBuffer:(const uint8_t *)values offsets:(const uint8_t *)offsets field:(NSDictionary *)field
+{
+	switch ([[field objectForKey:@"typeType"] integerValue])
+	{
+		case SPArrowIPCWriterTestTypeInt:
+		{
+			size_t width = (size_t)[[field objectForKey:@"bitWidth"] integerValue] / 8;
+			uint64_t value = 0;
+
+			memcpy(&value, values + index * width, width);
+
+			if (![[field objectForKey:@"isSigned"] boolValue]) return @(value);
+
+			// Sign extend narrower integers
+			if (width < 8 && (value >> (width * 8 - 1)) & 1) value |= ~0ULL << (width * 8);
+
+			return @((int64_t)value);
+		}
+		case SPArrowIPCWriterTestTypeFloatingPoint:
+			if ([[field objectForKey:@"precision"] integerValue] == 1) {
+				float value;
+				memcpy(&value, values + index * 4, 4);
+				return @(value);
+			}
+			else {
+				double value;
+				memcpy(&value, values + index * 8, 8);
+				return @(value);
+			}
+		case SPArrowIPCWriterTestTypeDecimal:
+		{
+			int64_t low = _SPArrowTestInt64(values + index * 16);
+
+			// Only values fitting in 64 bits are used, so the high half is the sign extension
+			XCTAssertEqual(_SPArrowTestInt64(values + index * 16 + 8), (int64_t)((low < 0) ? -1 : 0));
+
+			return @(low);
+		}
+		case SPArrowIPCWriterTestTypeDate:
+			return @(_SPArrowTestInt32(values + index * 4));
+		case SPArrowIPCWriterTestTypeTimestamp:
+			return @(_SPArrowTestInt64(values + index * 8));
+		case SPArrowIPCWriterTestTypeUtf8:
+		case SPArrowIPCWriterTestTypeBinary:
+		{
+			int32_t start = _SPArrowTestInt32(offsets + index * 4);
+			int32_t end = _SPArrowTestInt32(offsets + index * 4 + 4);
+
+			if ([[field objectForKey:@"typeType"] integerValue] == SPArrowIPCWriterTestTypeBinary) return [NSData dataWithBytes:values + start length:(NSUInteger)(end - start)];
+
+			return [[[NSString alloc] initWithBytes:values + start length:(NSUInteger)(end - start) encoding:NSUTF8StringEncoding] autorelease];
+		}
+	}
+
+	XCTFail(@"Unexpected column type");
+
+	return nil;
+}
+
+#pragma mark -
+#pragma mark Tests
+
+/**
+ * Columns are typed from the MySQL field definitions, with DECIMAL columns too wide for a 128-bit
+ * decimal written as text, and every field nullable.  A file with no rows holds just the schema.
+ */
+- (void)testSchemaFromFieldDefinitions
+{
+	NSArray *fieldDefinitions = @[
+		[self _fieldNamed:@"id" type:@"INT"],
+		@{@"name" : @"count", @"type" : @"INT", @"UNSIGNED_FLAG" : @YES},
+		[self _fieldNamed:@"total" type:@"BIGINT"],
+		@{@"name" : @"flag", @"type" : @"TINYINT", @"UNSIGNED_FLAG" : @YES},
+		[self _decimalFieldNamed:@"price" byteLength:12 decimals:2],
+		[self _fieldNamed:@"ratio" type:@"DOUBLE"],
+		[self _fieldNamed:@"born" type:@"DATE"],
+		[self _fieldNamed:@"seen" type:@"DATETIME"],
+		[self _fieldNamed:@"data" type:@"BLOB"],
+		[self _fieldNamed:@"note" type:@"VARCHAR"],
+		[self _fieldNamed:@"bits" type:@"BIT"],
+		[self _decimalFieldNamed:@"wide" byteLength:67 decimals:0]
+	];
+
+	SPArrowIPCWriter *writer = [[SPArrowIPCWriter alloc] initWithFieldDefinitions:fieldDefinitions];
+	SPArrowIPCWriterTestOutput *output = [[SPArrowIPCWriterTestOutput alloc] init];
+
+	[writer finishWritingToOutput:output];
+
+	NSDictionary *file = [self _readArrowFile:[output data]];
+	NSArray *fields = [file objectForKey:@"fields"];
+
+	XCTAssertEqual([fields count], [fieldDefinitions count]);
+	XCTAssertEqual([[file objectForKey:@"batches"] count], (NSUInteger)0);
+
+	NSArray *expectedFields = @[
+		@{@"name" : @"id", @"typeType" : @(SPArrowIPCWriterTestTypeInt), @"bitWidth" : @32, @"isSigned" : @YES},
+		@{@"name" : @"count", @"typeType" : @(SPArrowIPCWriterTestTypeInt), @"bitWidth" : @32, @"isSigned" : @NO},
+		@{@"name" : @"total", @"typeType" : @(SPArrowIPCWriterTestTypeInt), @"bitWidth" : @64, @"isSigned" : @YES},
+		@{@"name" : @"flag", @"typeType" : @(SPArrowIPCWriterTestTypeInt), @"bitWidth" : @8, @"isSigned" : @NO},
+		@{@"name" : @"price", @"typeType" : @(SPArrowIPCWriterTestTypeDecimal), @"precision" : @10, @"scale" : @2, @"bitWidth" : @128},
+		@{@"name" : @"ratio", @"typeType" : @(SPArrowIPCWriterTestTypeFloatingPoint), @"precision" : @2},
+		@{@"name" : @"born", @"typeType" : @(SPArrowIPCWriterTestTypeDate), @"unit" : @0},
+		@{@"name" : @"seen", @"typeType" : @(SPArrowIPCWriterTestTypeTimestamp), @"unit" : @2},
+		@{@"name" : @"data", @"typeType" : @(SPArrowIPCWriterTestTypeBinary)},
+		@{@"name" : @"note", @"typeType" : @(SPArrowIPCWriterTestTypeUtf8)},
+		@{@"name" : @"bits", @"typeType" : @(SPArrowIPCWriterTestTypeInt), @"bitWidth" : @64, @"isSigned" : @NO},
+		@{@"name" : @"wide", @"typeType" : @(SPArrowIPCWriterTestTypeUtf8)}
+	];
+
+	for (NSUInteger i = 0; i < [expectedFields count]; i++)
+	{
+		NSMutableDictionary *field = [NSMutableDictionary dictionaryWithDictionary:[fields objectAtIndex:i]];
+
+		XCTAssertEqualObjects([field objectForKey:@"nullable"], @YES);
+
+		[field removeObjectForKey:@"nullable"];
+
+		XCTAssertEqualObjects(field, [expectedFields objectAtIndex:i]);
+	}
+
+	[output release];
+	[writer release];
+}
+
+/**
+ * Rows are read back from each record batch written, with the footer indexing every batch.
+ */
+- (void)testRecordBatchesRoundTrip
+{
+	NSArray *fieldDefinitions = @[
+		[self _fieldNamed:@"id" type:@"INT"],
+		[self _fieldNamed:@"name" type:@"VARCHAR"],
+		[self _fieldNamed:@"ratio" type:@"DOUBLE"],
+		[self _fieldNamed:@"data" type:@"BLOB"]
+	];
+
+	SPArrowIPCWriter *writer = [[SPArrowIPCWriter alloc] initWithFieldDefinitions:fieldDefinitions];
+	SPArrowIPCWriterTestOutput *output = [[SPArrowIPCWriterTestOutput alloc] init];
+	NSMutableArray *expectedBatches = [NSMutableArray array];
+	NSUInteger batchLengths[] = { 5, 3 };
+	NSInteger rowId = -2;
+
+	for (NSUInteger batch = 0; batch < 2; batch++)
+	{
+		NSMutableArray *ids = [NSMutableArray array], *names = [NSMutableArray array], *ratios = [NSMutableArray array], *datas = [NSMutableArray array];
+
+		for (NSUInteger row = 0; row < batchLengths[batch]; row++, rowId++)
+		{
+			NSString *name = [NSString stringWithFormat:@"name %ld é", (long)rowId];
+			NSData *data = [[NSString stringWithFormat:@"%ld", (long)rowId] dataUsingEncoding:NSUTF8StringEncoding];
+
+			[self _appendRow:@[[NSString stringWithFormat:@"%ld", (long)rowId], name, [NSString stringWithFormat:@"%ld.25", (long)rowId], data] toWriter:writer];
+
+			[ids addObject:@((int64_t)rowId)];
+			[names addObject:name];
+			[ratios addObject:@(rowId + ((rowId < 0) ? -0.25 : 0.25))];
+			[datas addObject:data];
+		}
+
+		XCTAssertEqual([writer bufferedRowCount], batchLengths[batch]);
+
+		if (batch == 0) [writer writeRecordBatchToOutput:output];
+
+		XCTAssertEqual([writer bufferedRowCount], (NSUInteger)((batch == 0) ? 0 : 3));
+
+		[expectedBatches addObject:@[ids, names, ratios, datas]];
+	}
+
+	[writer finishWritingToOutput:output];
+
+	NSDictionary *file = [self _readArrowFile:[output data]];
+
+	XCTAssertEqualObjects([file objectForKey:@"batches"], expectedBatches);
+	XCTAssertEqual([[file objectForKey:@"dictionaryDeltas"] count], (NSUInteger)0);
+
+	[output release];
+	[writer release];
+}
+
+/**
+ * NULL cells, and values which can't be represented in the column's type such as zero dates,
+ * are written as nulls.
+ */
+- (void)testNullsAndUnrepresentableValues
+{
+	NSArray *fieldDefinitions = @[
+		[self _fieldNamed:@"id" type:@"INT"],
+		[self _fieldNamed:@"born" type:@"DATE"],
+		[self _fieldNamed:@"note" type:@"TEXT"]
+	];
+
+	SPArrowIPCWriter *writer = [[SPArrowIPCWriter alloc] initWithFieldDefinitions:fieldDefinitions];
+	SPArrowIPCWriterTestOutput *output = [[SPArrowIPCWriterTestOutput alloc] init];
+	NSNull *null = [NSNull null];
+
+	[self _appendRow:@[@"1", @"2024-02-29", @"first"] toWriter:writer];
+	[self _appendRow:@[null, @"0000-00-00", null] toWriter:writer];
+	[self _appendRow:@[@"abc", null, @"third"] toWriter:writer];
+	[self _appendRow:@[@"4", @"1970-01-01", @""] toWriter:writer];
+
+	[writer finishWritingToOutput:output];
+
+	NSArray *batches = [[self _readArrowFile:[output data]] objectForKey:@"batches"];
+
+	XCTAssertEqual([batches count], (NSUInteger)1);
+	XCTAssertEqualObjects([[batches objectAtIndex:0] objectAtIndex:0], (@[@1LL, null, null, @4LL]));
+	XCTAssertEqualObjects([[batches objectAtIndex:0] objectAtIndex:1], (@[@19782, null, null, @0]));
+	XCTAssertEqualObjects([[batches objectAtIndex:0] objectAtIndex:2], (@[@"first", null, @"third", @""]));
+
+	[output release];
+	[writer release];
+}
+
+/**
+ * Decimals are scaled to the column's scale, truncating any further digits, and timestamps are
+ * stored as microseconds from the epoch, including fractional seconds and times before 1970.
+ */
+- (void)testDecimalAndTimestampValues
+{
+	NSArray *fieldDefinitions = @[
+		[self _decimalFieldNamed:@"price" byteLength:12 decimals:2],
+		[self _fieldNamed:@"seen" type:@"DATETIME"],
+		[self _fieldNamed:@"changed" type:@"TIMESTAMP"]
+	];
+
+	SPArrowIPCWriter *writer = [[SPArrowIPCWriter alloc] initWithFieldDefinitions:fieldDefinitions];
+	SPArrowIPCWriterTestOutput *output = [[SPArrowIPCWriterTestOutput alloc] init];
+
+	[self _appendRow:@[@"-12.345", @"1969-12-31 23:59:59.5", @"1970-01-01 00:00:00.000001"] toWriter:writer];
+	[self _appendRow:@[@"1234.5", @"2024-02-29 12:00:00", @"0000-00-00 00:00:00"] toWriter:writer];
+	[self _appendRow:@[@"+7.1", @"1970-01-01 00:00:00", @"2038-01-19 03:14:07"] toWriter:writer];
+	[self _appendRow:@[@"0", @"1900-01-01 00:00:00", @"1970-01-02 00:00:01.25"] toWriter:writer];
+
+	[writer finishWritingToOutput:output];
+
+	NSArray *columns = [[[self _readArrowFile:[output data]] objectForKey:@"batches"] objectAtIndex:0];
+
+	XCTAssertEqualObjects([columns objectAtIndex:0], (@[@-1234LL, @123450LL, @710LL, @0LL]));
+	XCTAssertEqualObjects([columns objectAtIndex:1], (@[@-500000LL, @1709208000000000LL, @0LL, @-2208988800000000LL]));
+	XCTAssertEqualObjects([columns objectAtIndex:2], (@[@1LL, [NSNull null], @2147483647000000LL, @86401250000LL]));
+
+	[output release];
+	[writer release];
+}
+
+/**
+ * A text column with few distinct values in the first batch is dictionary encoded, with values
+ * first seen in later batches written as a dictionary delta before the batch using them.
+ */
+- (void)testDictionaryEncodingWithDeltas
+{
+	SPArrowIPCWriter *writer = [[SPArrowIPCWriter alloc] initWithFieldDefinitions:@[[self _fieldNamed:@"colour" type:@"VARCHAR"]]];
+	SPArrowIPCWriterTestOutput *output = [[SPArrowIPCWriterTestOutput alloc] init];
+	NSArray *firstBatch = @[@"red", @"green", @"red", @"green", @"red", @"green", @"red", @"green"];
+	NSArray *secondBatch = @[@"green", @"blue", [NSNull null], @"purple", @"red"];
+
+	for (id value in firstBatch) [self _appendRow:@[value] toWriter:writer];
+
+	[writer writeRecordBatchToOutput:output];
+
+	for (id value in secondBatch) [self _appendRow:@[value] toWriter:writer];
+
+	[writer finishWritingToOutput:output];
+
+	NSDictionary *file = [self _readArrowFile:[output data]];
+
+	XCTAssertEqualObjects([[[file objectForKey:@"fields"] objectAtIndex:0] objectForKey:@"dictionaryId"], @0LL);
+	XCTAssertEqualObjects([file objectForKey:@"dictionaryDeltas"], (@[@NO, @YES]));
+	XCTAssertEqualObjects([file objectForKey:@"batches"], (@[@[firstBatch], @[secondBatch]]));
+
+	[output release];
+	[writer release];
+}
+
+/**
+ * Rows of objects, without field definitions, are written as text columns.
+ */
+- (void)testRowsOfObjects
+{
+	SPArrowIPCWriter *writer = [[SPArrowIPCWriter alloc] initWithColumnNames:@[@"a", @"b"]];
+	SPArrowIPCWriterTestOutput *output = [[SPArrowIPCWriterTestOutput alloc] init];
+
+	[writer appendRow:@[@42, [NSNull null]]];
+	[writer appendRow:@[@"text", [@"bytes" dataUsingEncoding:NSUTF8StringEncoding]]];
+	[writer appendRow:@[@"more"]];
+
+	[writer finishWritingToOutput:output];
+
+	NSDictionary *file = [self _readArrowFile:[output data]];
+
+	XCTAssertEqualObjects([[[file objectForKey:@"fields"] objectAtIndex:1] objectForKey:@"typeType"], @(SPArrowIPCWriterTestTypeUtf8));
+	XCTAssertEqualObjects([file objectForKey:@"batches"], (@[@[@[@"42", @"text", @"more"], @[[NSNull null], @"bytes", [NSNull null]]]]));
+
+	[output release];
+	[writer release];
+}
+
+@end
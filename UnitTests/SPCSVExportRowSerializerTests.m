@@ -0,0 +1,188 @@
+//
+//  SPCSVExportRowSerializerTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVExportRowSerializer.h"
+
+#import <XCTest/XCTest.h>
+
+/**
+ * Collects the data written by a serializer.
+ */
+@interface SPCSVExportRowSerializerTestOutput : NSObject
+{
+	NSMutableData *data;
+}
+
+- (void)writeData:(NSData *)someData;
+- (NSString *)string;
+
+@end
+
+@implementation SPCSVExportRowSerializerTestOutput
+
+- (id)init
+{
+	if ((self = [super init])) {
+		data = [[NSMutableData alloc] init];
+	}
+
+	return self;
+}
+
+- (void)writeData:(NSData *)someData
+{
+	[data appendData:someData];
+}
+
+- (NSString *)string
+{
+	return [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+}
+
+- (void)dealloc
+{
+	[data release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPCSVExportRowSerializerTests : XCTestCase
+
+- (NSString *)_stringByWritingSerializer:(SPCSVExportRowSerializer *)serializer;
+
+@end
+
+@implementation SPCSVExportRowSerializerTests
+
+/**
+ * Raw row cells are enclosed and escaped according to their column formats.
+ */
+- (void)testRawRowCells
+{
+	SPCSVExportRowSerializer *serializer = [[[SPCSVExportRowSerializer alloc] initWithColumnCount:6 stringEncoding:NSUTF8StringEncoding fieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\"" lineEnding:@"\n" nullString:@"NULL"] autorelease];
+
+	[serializer setFormat:SPCSVExportCellAsNumber bitLength:0 forColumn:0];
+	[serializer setFormat:SPCSVExportCellAsBit bitLength:10 forColumn:2];
+	[serializer setFormat:SPCSVExportCellAsNumber bitLength:0 forColumn:5];
+
+	const char *cells[6] = { "12.5", "say \"hi\", ok", "\x01\x05", NULL, "", "1,5" };
+	unsigned long lengths[6] = { 4, 12, 2, 0, 0, 3 };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"12.5,\"say \"\"hi\"\", ok\",0100000101,NULL,\"\",1\",5\n");
+}
+
+/**
+ * Without an enclosing string, multi-character field separators and line endings are escaped,
+ * while cells only sharing their leading bytes are copied unchanged.
+ */
+- (void)testMultiCharacterSeparators
+{
+	SPCSVExportRowSerializer *serializer = [[[SPCSVExportRowSerializer alloc] initWithColumnCount:3 stringEncoding:NSUTF8StringEncoding fieldSeparator:@"||" enclosingCharacter:@"" escapeString:@"\\" lineEnding:@"\r\n" nullString:@"\\N"] autorelease];
+
+	const char *cells[3] = { "a||b\r\nc\\", "0123456789abcdefghij|k\rl", "été" };
+	unsigned long lengths[3] = { 8, 24, 5 };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"a\\||b\\\r\nc\\\\||0123456789abcdefghij|k\rl||été\r\n");
+}
+
+/**
+ * Field names are always enclosed, and rows supplied as objects are written like raw rows.
+ */
+- (void)testFieldNamesAndObjectRow
+{
+	SPCSVExportRowSerializer *serializer = [[[SPCSVExportRowSerializer alloc] initWithColumnCount:3 stringEncoding:NSUTF8StringEncoding fieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\\" lineEnding:@"\n" nullString:@"NULL"] autorelease];
+
+	[serializer setFormat:SPCSVExportCellAsNumber bitLength:0 forColumn:0];
+
+	[serializer appendFieldNames:@[@"id", @"na\"me", @"value"]];
+	[serializer appendRow:@[@"7", @"a\\b", [NSNull null]]];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"\"id\",\"na\\\"me\",\"value\"\n7,\"a\\\\b\",NULL\n");
+}
+
+/**
+ * Cells of columns detecting numbers are only left unenclosed if they look like numbers, as the
+ * string-based writer decides for supplied data.
+ */
+- (void)testDetectingNumbers
+{
+	SPCSVExportRowSerializer *serializer = [[[SPCSVExportRowSerializer alloc] initWithColumnCount:7 stringEncoding:NSUTF8StringEncoding fieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\"" lineEnding:@"\n" nullString:@"NULL"] autorelease];
+
+	for (NSUInteger i = 0; i < 7; i++) [serializer setFormat:SPCSVExportCellDetectingNumber bitLength:0 forColumn:i];
+
+	[serializer appendRow:@[@"-12.5", @"0", @"0.25", @"007", @"12a", @"", [NSNull null]]];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"-12.5,0,0.25,\"007\",\"12a\",\"\",NULL\n");
+}
+
+/**
+ * Output larger than the initial buffer is written intact, and the buffer is emptied after writing.
+ */
+- (void)testBufferGrowth
+{
+	SPCSVExportRowSerializer *serializer = [[[SPCSVExportRowSerializer alloc] initWithColumnCount:1 stringEncoding:NSUTF8StringEncoding fieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\"" lineEnding:@"\n" nullString:@"NULL"] autorelease];
+
+	NSUInteger length = 200000;
+	char *bytes = malloc(length);
+	memset(bytes, '"', length);
+
+	const char *cells[1] = { bytes };
+	unsigned long lengths[1] = { length };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqual([serializer length], (length * 2) + 3);
+
+	NSString *output = [self _stringByWritingSerializer:serializer];
+
+	XCTAssertEqual([output length], (length * 2) + 3);
+	XCTAssertEqual([serializer length], (NSUInteger)0);
+
+	free(bytes);
+}
+
+#pragma mark -
+
+- (NSString *)_stringByWritingSerializer:(SPCSVExportRowSerializer *)serializer
+{
+	SPCSVExportRowSerializerTestOutput *output = [[[SPCSVExportRowSerializerTestOutput alloc] init] autorelease];
+
+	[serializer writeToOutput:output];
+
+	return [output string];
+}
+
+@end
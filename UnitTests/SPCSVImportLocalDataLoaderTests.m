@@ -0,0 +1,504 @@
+//
+//  SPCSVImportLocalDataLoaderTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVImportLocalDataLoader.h"
+
+#import <SPMySQL/SPMySQL.h>
+#import <XCTest/XCTest.h>
+
+static NSString *SPCSVImportLocalDataLoaderTestSessionQuery = @"SELECT DATABASE(), @@GLOBAL.local_infile, @@SESSION.sql_mode, @@SESSION.time_zone, @@SESSION.foreign_key_checks, @@SESSION.unique_checks";
+
+/**
+ * The state shared by a test connection and its copies: the log of queries run on any of them,
+ * the parent's session, the data and result of local data loads, and the warnings they leave.
+ */
+@interface SPCSVImportLocalDataLoaderTestServer : NSObject
+{
+	NSMutableArray *queryLog;
+	NSMutableData *loadedData;
+	NSArray *sessionRow;
+	NSArray *warningRows;
+	NSUInteger loadErrorID;
+}
+
+@property (readonly) NSMutableArray *queryLog;
+@property (readonly) NSMutableData *loadedData;
+@property (readwrite, retain) NSArray *sessionRow;
+@property (readwrite, retain) NSArray *warningRows;
+@property (assign) NSUInteger loadErrorID;
+
+@end
+
+@implementation SPCSVImportLocalDataLoaderTestServer
+
+@synthesize queryLog;
+@synthesize loadedData;
+@synthesize sessionRow;
+@synthesize warningRows;
+@synthesize loadErrorID;
+
+- (id)init
+{
+	if ((self = [super init])) {
+		queryLog = [[NSMutableArray alloc] init];
+		loadedData = [[NSMutableData alloc] init];
+		sessionRow = [@[@"test_db", @"1", @"STRICT_TRANS_TABLES", @"+02:00", @"0", @"1"] retain];
+		warningRows = [@[] retain];
+		loadErrorID = 0;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[queryLog release];
+	[loadedData release];
+	[sessionRow release];
+	[warningRows release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * A result returning the supplied rows in turn.
+ */
+@interface SPCSVImportLocalDataLoaderTestResult : NSObject
+{
+	NSMutableArray *rows;
+}
+
+- (id)initWithRows:(NSArray *)theRows;
+- (void)setReturnDataAsStrings:(BOOL)asStrings;
+- (NSArray *)getRowAsArray;
+
+@end
+
+@implementation SPCSVImportLocalDataLoaderTestResult
+
+- (id)initWithRows:(NSArray *)theRows
+{
+	if ((self = [super init])) {
+		rows = [theRows mutableCopy];
+	}
+
+	return self;
+}
+
+- (void)setReturnDataAsStrings:(BOOL)asStrings
+{
+}
+
+- (NSArray *)getRowAsArray
+{
+	if (![rows count]) return nil;
+
+	NSArray *row = [[[rows objectAtIndex:0] retain] autorelease];
+
+	[rows removeObjectAtIndex:0];
+
+	return row;
+}
+
+- (void)dealloc
+{
+	[rows release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for the parent connection and the loading connection copied from it, logging each
+ * query prefixed with the number of the connection it was run on - 0 for the parent, and 1 for
+ * its copy - and collecting the local data supplied to loads.
+ */
+@interface SPCSVImportLocalDataLoaderTestConnection : NSObject <NSCopying>
+{
+	SPCSVImportLocalDataLoaderTestServer *server;
+	NSUInteger connectionNumber;
+	NSUInteger lastErrorID;
+	BOOL connected;
+}
+
+- (id)initWithServer:(SPCSVImportLocalDataLoaderTestServer *)aServer connectionNumber:(NSUInteger)aNumber;
+
+@end
+
+@implementation SPCSVImportLocalDataLoaderTestConnection
+
+- (id)initWithServer:(SPCSVImportLocalDataLoaderTestServer *)aServer connectionNumber:(NSUInteger)aNumber
+{
+	if ((self = [super init])) {
+		server = [aServer retain];
+		connectionNumber = aNumber;
+		lastErrorID = 0;
+		connected = (aNumber == 0);
+	}
+
+	return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone
+{
+	return [[SPCSVImportLocalDataLoaderTestConnection allocWithZone:zone] initWithServer:server connectionNumber:connectionNumber + 1];
+}
+
+- (void)_logQuery:(NSString *)query
+{
+	[[server queryLog] addObject:[NSString stringWithFormat:@"%lu: %@", (unsigned long)connectionNumber, query]];
+}
+
+- (id)queryString:(NSString *)query
+{
+	[self _logQuery:query];
+
+	lastErrorID = 0;
+
+	if ([query isEqualToString:SPCSVImportLocalDataLoaderTestSessionQuery]) {
+		return [[[SPCSVImportLocalDataLoaderTestResult alloc] initWithRows:@[[server sessionRow]]] autorelease];
+	}
+
+	if ([query hasPrefix:@"SHOW WARNINGS"]) {
+		return [[[SPCSVImportLocalDataLoaderTestResult alloc] initWithRows:[server warningRows]] autorelease];
+	}
+
+	return nil;
+}
+
+- (BOOL)loadLocalDataWithQueryString:(NSString *)query usingEncoding:(NSStringEncoding)encoding readingDataUsingBlock:(SPMySQLLocalDataReadBlock)readBlock
+{
+	char buffer[7];
+	NSInteger readLength;
+
+	[self _logQuery:query];
+
+	// Read in small pieces, so rows are split across reads
+	while ((readLength = readBlock(buffer, sizeof(buffer))) > 0)
+	{
+		[[server loadedData] appendBytes:buffer length:(NSUInteger)readLength];
+	}
+
+	lastErrorID = [server loadErrorID];
+
+	return (lastErrorID == 0);
+}
+
+- (BOOL)queryErrored
+{
+	return (lastErrorID != 0);
+}
+
+- (NSUInteger)lastErrorID
+{
+	return lastErrorID;
+}
+
+- (NSString *)lastErrorMessage
+{
+	return (lastErrorID) ? @"The used command is not allowed with this MySQL version" : nil;
+}
+
+- (void)addClientFlags:(SPMySQLClientFlags)flags
+{
+	[self _logQuery:[NSString stringWithFormat:@"CLIENT FLAGS %lu", (unsigned long)flags]];
+}
+
+- (BOOL)connect
+{
+	connected = YES;
+
+	return YES;
+}
+
+- (BOOL)isConnected
+{
+	return connected;
+}
+
+- (void)disconnect
+{
+	[self _logQuery:@"DISCONNECT"];
+
+	connected = NO;
+}
+
+- (BOOL)selectDatabase:(NSString *)database
+{
+	[self _logQuery:[NSString stringWithFormat:@"USE %@", database]];
+
+	return YES;
+}
+
+- (NSString *)encoding
+{
+	return @"utf8mb4";
+}
+
+- (BOOL)setEncoding:(NSString *)encoding
+{
+	return YES;
+}
+
+- (NSStringEncoding)stringEncoding
+{
+	return NSUTF8StringEncoding;
+}
+
+- (BOOL)serverVersionIsGreaterThanOrEqualTo:(NSUInteger)major minorVersion:(NSUInteger)minor releaseVersion:(NSUInteger)release
+{
+	return YES;
+}
+
+- (NSUInteger)port
+{
+	return 3306;
+}
+
+- (void)setPort:(NSUInteger)port
+{
+}
+
+- (NSString *)escapeAndQuoteString:(NSString *)string
+{
+	return [NSString stringWithFormat:@"'%@'", string];
+}
+
+- (void)dealloc
+{
+	[server release];
+
+	[super dealloc];
+}
+
+@end
+
+#pragma mark -
+
+@interface SPCSVImportLocalDataLoaderTests : XCTestCase
+{
+	SPCSVImportLocalDataLoaderTestServer *server;
+	SPCSVImportLocalDataLoaderTestConnection *parentConnection;
+}
+
+- (SPCSVImportLocalDataLoader *)_loaderWithColumnNames:(NSArray *)names sourceColumns:(NSArray *)columnIndexes defaultValues:(NSArray *)defaults;
+
+@end
+
+@implementation SPCSVImportLocalDataLoaderTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	server = [[SPCSVImportLocalDataLoaderTestServer alloc] init];
+	parentConnection = [[SPCSVImportLocalDataLoaderTestConnection alloc] initWithServer:server connectionNumber:0];
+}
+
+- (void)tearDown
+{
+	[parentConnection release], parentConnection = nil;
+	[server release], server = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns a loader for the table `my``table`, ignoring duplicate rows.
+ */
+- (SPCSVImportLocalDataLoader *)_loaderWithColumnNames:(NSArray *)names sourceColumns:(NSArray *)columnIndexes defaultValues:(NSArray *)defaults
+{
+	SPCSVImportLocalDataLoader *loader = [[SPCSVImportLocalDataLoader alloc] initWithConnection:(SPMySQLConnection *)parentConnection table:@"my`table" columnNames:names sourceColumns:columnIndexes defaultValues:defaults];
+
+	[loader setDuplicateHandling:@"IGNORE"];
+
+	return [loader autorelease];
+}
+
+/**
+ * Loading reports rows which can't be loaded as warnings, so without IGNORE or REPLACE the loader
+ * isn't opened, and the rows are left to be inserted.
+ */
+- (void)testOpenRequiresDuplicateHandling
+{
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id"] sourceColumns:@[@0] defaultValues:@[@""]];
+
+	[loader setDuplicateHandling:nil];
+
+	XCTAssertFalse([loader open]);
+	XCTAssertFalse([loader localDataRefused]);
+	XCTAssertEqualObjects([server queryLog], @[]);
+}
+
+/**
+ * The loading connection is allowed to supply local data, and mirrors the parent's database,
+ * SQL mode, time zone and key checks.
+ */
+- (void)testOpenMirrorsParentSession
+{
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id"] sourceColumns:@[@0] defaultValues:@[@""]];
+
+	XCTAssertTrue([loader open]);
+
+	NSArray *expectedQueries = @[
+		[@"0: " stringByAppendingString:SPCSVImportLocalDataLoaderTestSessionQuery],
+		[NSString stringWithFormat:@"1: CLIENT FLAGS %lu", (unsigned long)SPMySQLClientFlagLocalFiles],
+		@"1: USE test_db",
+		@"1: SET SQL_MODE='STRICT_TRANS_TABLES', TIME_ZONE='+02:00', FOREIGN_KEY_CHECKS=0, UNIQUE_CHECKS=1"
+	];
+
+	XCTAssertEqualObjects([server queryLog], expectedQueries);
+
+	[loader close];
+}
+
+/**
+ * A server not allowing local data refuses the loader before any connection is made.
+ */
+- (void)testOpenRefusedWithoutLocalInfile
+{
+	[server setSessionRow:@[@"test_db", @"0", @"", @"SYSTEM", @"1", @"1"]];
+
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id"] sourceColumns:@[@0] defaultValues:@[@""]];
+
+	XCTAssertFalse([loader open]);
+	XCTAssertTrue([loader localDataRefused]);
+	XCTAssertEqual([[server queryLog] count], (NSUInteger)1);
+}
+
+/**
+ * The statement names the mapped columns in order, reading columns for which empty cells are NULL
+ * through user variables, and includes the load options.
+ */
+- (void)testLoadQuery
+{
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id", @"na`me", @"score"] sourceColumns:@[@0, @1, @2] defaultValues:@[@"", @"", @""]];
+
+	[loader setEmptyStringNullColumns:[NSIndexSet indexSetWithIndex:2]];
+	[loader setDuplicateHandling:@"REPLACE"];
+	[loader setLowPriority:YES];
+
+	XCTAssertTrue([loader open]);
+
+	[loader appendRow:@[@"1", @"a", @"2"]];
+
+	XCTAssertTrue([loader loadBufferedRows]);
+
+	NSString *expectedQuery = @"1: LOAD DATA LOW_PRIORITY LOCAL INFILE 'sequel-pro-csv-import' REPLACE INTO TABLE `my``table` CHARACTER SET utf8mb4 "
+		@"FIELDS TERMINATED BY X'09' ESCAPED BY X'5C' LINES TERMINATED BY X'0A' (`id`, `na``me`, @sp_import_2) SET `score` = NULLIF(@sp_import_2, '')";
+
+	XCTAssertTrue([[server queryLog] containsObject:expectedQuery]);
+
+	[loader close];
+}
+
+/**
+ * Cells are mapped to the table's columns, with defaults for missing cells and NULL for NULL cells
+ * and empty cells of nullable numeric columns, and the characters ending a field or row escaped.
+ */
+- (void)testRowsMappedAndEscaped
+{
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id", @"name", @"score"] sourceColumns:@[@1, @0, @2] defaultValues:@[@"0", @"none", @"7"]];
+
+	[loader setEmptyStringNullColumns:[NSIndexSet indexSetWithIndex:2]];
+
+	XCTAssertTrue([loader open]);
+
+	[loader appendRow:@[@"a\tb", @"1", @""]];
+	[loader appendRow:@[@"back\\slash\r\nline", [NSNull null]]];
+	unichar nulCell[] = { 'n', 'u', 'l', 0, 'x', ' ', 0xE9 };
+
+	[loader appendRow:@[[NSString stringWithCharacters:nulCell length:7], @"3", @"4"]];
+
+	const char expectedBytes[] = "1\ta\\tb\t\\N\n"
+		"\\N\tback\\\\slash\r\\nline\t7\n"
+		"3\tnul\\0x \xC3\xA9\t4\n";
+	NSData *expectedData = [NSData dataWithBytes:expectedBytes length:sizeof(expectedBytes) - 1];
+
+	XCTAssertEqual([loader rowCount], (NSUInteger)3);
+	XCTAssertEqual([loader bufferedLength], [expectedData length]);
+
+	XCTAssertTrue([loader loadBufferedRows]);
+	XCTAssertEqualObjects([server loadedData], expectedData);
+
+	// The buffer is emptied once loaded
+	XCTAssertEqual([loader rowCount], (NSUInteger)0);
+	XCTAssertEqual([loader bufferedLength], (NSUInteger)0);
+
+	[loader close];
+}
+
+/**
+ * Rows the server couldn't load are reported through the warnings left by the load.
+ */
+- (void)testLoadWarnings
+{
+	[server setWarningRows:@[@[@"Warning", @"1062", @"Duplicate entry '1' for key 'PRIMARY'"], @[@"Warning", @"1366", @"Incorrect integer value: 'x' for column 'id' at row 2"]]];
+
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id"] sourceColumns:@[@0] defaultValues:@[@""]];
+
+	XCTAssertTrue([loader open]);
+
+	[loader appendRow:@[@"1"]];
+	[loader appendRow:@[@"x"]];
+
+	XCTAssertTrue([loader loadBufferedRows]);
+	XCTAssertNil([loader lastErrorMessage]);
+	XCTAssertEqualObjects([loader lastWarnings], (@[@"Duplicate entry '1' for key 'PRIMARY'", @"Incorrect integer value: 'x' for column 'id' at row 2"]));
+	XCTAssertEqualObjects([[server queryLog] lastObject], @"1: SHOW WARNINGS LIMIT 100");
+
+	[loader close];
+}
+
+/**
+ * A load refused by the server sets -localDataRefused, so the rows can be inserted instead.
+ */
+- (void)testLoadRefused
+{
+	[server setLoadErrorID:1148];
+
+	SPCSVImportLocalDataLoader *loader = [self _loaderWithColumnNames:@[@"id"] sourceColumns:@[@0] defaultValues:@[@""]];
+
+	XCTAssertTrue([loader open]);
+
+	[loader appendRow:@[@"1"]];
+
+	XCTAssertFalse([loader loadBufferedRows]);
+	XCTAssertTrue([loader localDataRefused]);
+	XCTAssertNotNil([loader lastErrorMessage]);
+	XCTAssertNil([loader lastWarnings]);
+
+	[loader close];
+}
+
+@end
@@ -0,0 +1,138 @@
+//
+//  SPCSVParallelTokenizerTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVParallelTokenizer.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPCSVParallelTokenizerTests : XCTestCase
+
+- (NSData *)_csvDataWithRowCount:(NSUInteger)rowCount rowFormat:(NSString *)rowFormat;
+- (NSArray *)_rowsFromTokenizer:(SPCSVTokenizer *)tokenizer data:(NSData *)data appendLength:(NSUInteger)appendLength;
+- (void)_assertParallelTokenizingMatchesSequential:(NSData *)data lineTerminator:(NSString *)lineEnd escape:(NSString *)escape;
+
+@end
+
+@implementation SPCSVParallelTokenizerTests
+
+/**
+ * Rows spanning chunk boundaries, including quoted fields containing line terminators, field
+ * terminators and escaped quotes, are returned as by a single tokenizer.
+ */
+- (void)testQuotedFieldsAcrossChunks
+{
+	NSData *data = [self _csvDataWithRowCount:60000 rowFormat:@"%lu,\"multi\nline, \\\"quoted\\\" text %lu\",\"\",plain value,\\N\n"];
+
+	[self _assertParallelTokenizingMatchesSequential:data lineTerminator:@"\n" escape:@"\\"];
+}
+
+/**
+ * Excel-style doubled quotes and CRLF line terminators are handled across chunk boundaries.
+ */
+- (void)testDoubledQuotesAndCRLF
+{
+	NSData *data = [self _csvDataWithRowCount:100000 rowFormat:@"%lu,\"say \"\"hi\"\"\r\nthere\",%lu\r\n"];
+
+	[self _assertParallelTokenizingMatchesSequential:data lineTerminator:@"\r\n" escape:@"\""];
+}
+
+/**
+ * Unquoted fields containing quotes, which the speculative row search can't tell from quoted
+ * fields, still give the same rows as a single tokenizer.
+ */
+- (void)testUnquotedFieldsContainingQuotes
+{
+	NSData *data = [self _csvDataWithRowCount:100000 rowFormat:@"%lu,a 27\" screen,\"multi\nline\",%lu inch\"es\n"];
+
+	[self _assertParallelTokenizingMatchesSequential:data lineTerminator:@"\n" escape:@"\\"];
+}
+
+/**
+ * Data shorter than a chunk is tokenized once complete, skipping a byte order mark and padding
+ * short rows as SPCSVTokenizer does.
+ */
+- (void)testShortData
+{
+	NSMutableData *data = [NSMutableData dataWithBytes:"\xEF\xBB\xBF" length:3];
+	[data appendData:[@"a,b,c\n1,2\n\n3,\"4\",5,6" dataUsingEncoding:NSUTF8StringEncoding]];
+
+	SPCSVParallelTokenizer *tokenizer = [[[SPCSVParallelTokenizer alloc] initWithStringEncoding:NSUTF8StringEncoding fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"] autorelease];
+	NSArray *rows = [self _rowsFromTokenizer:tokenizer data:data appendLength:4];
+	NSArray *expected = @[@[@"a", @"b", @"c"], @[@"1", @"2", [SPNotLoaded notLoaded]], @[@"3", @"4", @"5", @"6"]];
+
+	XCTAssertEqualObjects(rows, expected);
+	XCTAssertEqual([tokenizer totalLengthParsed], [data length]);
+}
+
+#pragma mark -
+
+- (NSData *)_csvDataWithRowCount:(NSUInteger)rowCount rowFormat:(NSString *)rowFormat
+{
+	NSMutableString *csv = [NSMutableString string];
+
+	for (NSUInteger i = 0; i < rowCount; i++) [csv appendFormat:rowFormat, (unsigned long)i, (unsigned long)(i * 7)];
+
+	return [csv dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSArray *)_rowsFromTokenizer:(SPCSVTokenizer *)tokenizer data:(NSData *)data appendLength:(NSUInteger)appendLength
+{
+	NSMutableArray *rows = [NSMutableArray array];
+	const uint8_t *bytes = [data bytes];
+	NSArray *row;
+
+	for (NSUInteger i = 0; i < [data length]; i += appendLength) {
+		[tokenizer appendBytes:(bytes + i) length:MIN(appendLength, [data length] - i)];
+		while ((row = [tokenizer getRowAsArrayAndTrimData:YES dataIsComplete:NO])) [rows addObject:row];
+	}
+	while ((row = [tokenizer getRowAsArrayAndTrimData:YES dataIsComplete:YES])) [rows addObject:row];
+
+	return rows;
+}
+
+- (void)_assertParallelTokenizingMatchesSequential:(NSData *)data lineTerminator:(NSString *)lineEnd escape:(NSString *)escape
+{
+	SPCSVTokenizer *tokenizer = [[[SPCSVTokenizer alloc] initWithStringEncoding:NSUTF8StringEncoding fieldTerminator:@"," lineTerminator:lineEnd fieldQuote:@"\"" escape:escape] autorelease];
+	SPCSVParallelTokenizer *parallelTokenizer = [[[SPCSVParallelTokenizer alloc] initWithStringEncoding:NSUTF8StringEncoding fieldTerminator:@"," lineTerminator:lineEnd fieldQuote:@"\"" escape:escape] autorelease];
+
+	[tokenizer setNullReplacementString:@"NULL"];
+	[parallelTokenizer setNullReplacementString:@"NULL"];
+
+	NSArray *expectedRows = [self _rowsFromTokenizer:tokenizer data:data appendLength:[data length]];
+	NSArray *rows = [self _rowsFromTokenizer:parallelTokenizer data:data appendLength:256 * 1024];
+
+	XCTAssertTrue([data length] > 3 * 1024 * 1024);
+	XCTAssertEqual([rows count], [expectedRows count]);
+	XCTAssertEqualObjects(rows, expectedRows);
+	XCTAssertEqual([parallelTokenizer totalLengthParsed], [tokenizer totalLengthParsed]);
+	XCTAssertFalse([parallelTokenizer encodingErrorOccurred]);
+}
+
+@end
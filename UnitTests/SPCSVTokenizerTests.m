@@ -0,0 +1,226 @@
+//
+//  SPCSVTokenizerTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVTokenizer.h"
+#import "SPCSVParser.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPCSVTokenizerTests : XCTestCase
+
+- (SPCSVParser *)_parserWithFieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape;
+- (NSArray *)_rowsFromParser:(SPCSVParser *)parser;
+- (void)_assertDataParsingMatchesStringParsing:(NSString *)csv fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape strict:(BOOL)strict nullString:(NSString *)nullString;
+
+@end
+
+@implementation SPCSVTokenizerTests
+
+/**
+ * Parsing data gives the same rows as parsing the string, across escaping styles and settings.
+ */
+- (void)testDataParsingMatchesStringParsing
+{
+	NSString *csv = @"1,\"a \\\"quoted\\\" value\",\\N\n"
+		@"2,\"multi\nline, with comma\",plain\\,escaped\n"
+		@"\n"
+		@"3,  \"spaced\"  ,NULL,\"NULL\"\n"
+		@"4,\"Excel \"\"doubled\"\" quotes\",\"\"\n"
+		@"5,trailing\\\\,\"é and ü\"";
+
+	[self _assertDataParsingMatchesStringParsing:csv fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\" strict:NO nullString:@"NULL"];
+	[self _assertDataParsingMatchesStringParsing:csv fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\" strict:YES nullString:nil];
+	[self _assertDataParsingMatchesStringParsing:csv fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\"" strict:NO nullString:@"NULL"];
+	[self _assertDataParsingMatchesStringParsing:[csv stringByReplacingOccurrencesOfString:@"\n" withString:@"\r\n"] fieldTerminator:@"," lineTerminator:@"\r\n" fieldQuote:@"\"" escape:@"\\" strict:NO nullString:nil];
+	[self _assertDataParsingMatchesStringParsing:[csv stringByReplacingOccurrencesOfString:@"," withString:@"\t"] fieldTerminator:@"\t" lineTerminator:@"\n" fieldQuote:@"" escape:@"\\" strict:NO nullString:nil];
+}
+
+/**
+ * Rows are only returned once complete when the data arrives a byte at a time, including when
+ * multi-byte characters are split across appends.
+ */
+- (void)testStreamingByteByByte
+{
+	NSString *csv = @"1,\"été\",x\n2,\"naïve\nvalue\",\"\\\"q\\\"\"\n3,ünï,\"\"\n";
+	NSData *data = [csv dataUsingEncoding:NSUTF8StringEncoding];
+	const uint8_t *bytes = [data bytes];
+
+	SPCSVParser *stringParser = [self _parserWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"];
+	[stringParser setString:csv];
+	NSArray *expectedRows = [self _rowsFromParser:stringParser];
+
+	SPCSVParser *dataParser = [self _parserWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"];
+	XCTAssertTrue([dataParser parseDataWithEncoding:NSUTF8StringEncoding]);
+
+	NSMutableArray *rows = [NSMutableArray array];
+	NSArray *row;
+
+	for (NSUInteger i = 0; i < [data length]; i++) {
+		[dataParser appendData:[NSData dataWithBytes:bytes + i length:1]];
+		while ((row = [dataParser getRowAsArrayAndTrimString:YES stringIsComplete:NO])) [rows addObject:row];
+	}
+	while ((row = [dataParser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [rows addObject:row];
+
+	XCTAssertEqualObjects(rows, expectedRows);
+	XCTAssertFalse([dataParser encodingErrorOccurred]);
+}
+
+/**
+ * Fields outside the materialised indexes are returned as NSNull without being decoded.
+ */
+- (void)testMaterialisedFieldIndexes
+{
+	SPCSVTokenizer *tokenizer = [[[SPCSVTokenizer alloc] initWithStringEncoding:NSUTF8StringEncoding fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"] autorelease];
+
+	[tokenizer setMaterialisedFieldIndexes:[NSIndexSet indexSetWithIndex:1]];
+	[tokenizer appendData:[@"a,b,c\n" dataUsingEncoding:NSUTF8StringEncoding]];
+
+	NSArray *expected = @[[NSNull null], @"b", [NSNull null]];
+
+	XCTAssertEqualObjects([tokenizer getRowAsArrayAndTrimData:YES dataIsComplete:YES], expected);
+}
+
+/**
+ * Plain fields point into the CSV data, while fields needing unescaping are copied.
+ */
+- (void)testFieldSpans
+{
+	SPCSVTokenizer *tokenizer = [[[SPCSVTokenizer alloc] initWithStringEncoding:NSUTF8StringEncoding fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"] autorelease];
+
+	[tokenizer appendData:[@"abc,\"de\",\"f\\\"g\",\\N\n" dataUsingEncoding:NSUTF8StringEncoding]];
+
+	XCTAssertTrue([tokenizer tokenizeRowAndTrimData:YES dataIsComplete:YES]);
+	XCTAssertEqual([tokenizer fieldCount], (NSUInteger)4);
+
+	SPCSVFieldSpan span = [tokenizer fieldSpanAtIndex:0];
+	XCTAssertEqual(span.location, (NSUInteger)0);
+	XCTAssertEqual(span.length, (NSUInteger)3);
+	XCTAssertEqual(span.flags, (uint8_t)0);
+
+	span = [tokenizer fieldSpanAtIndex:1];
+	XCTAssertEqual(span.location, (NSUInteger)5);
+	XCTAssertEqual(span.length, (NSUInteger)2);
+	XCTAssertEqual(span.flags, (uint8_t)SPCSVFieldIsQuoted);
+
+	span = [tokenizer fieldSpanAtIndex:2];
+	XCTAssertTrue(span.flags & SPCSVFieldIsUnescaped);
+	XCTAssertEqualObjects([tokenizer fieldAtIndex:2], @"f\"g");
+
+	span = [tokenizer fieldSpanAtIndex:3];
+	XCTAssertTrue(span.flags & SPCSVFieldIsNull);
+	XCTAssertEqualObjects([tokenizer fieldAtIndex:3], [NSNull null]);
+}
+
+/**
+ * Fields and quoted sections spanning several 64-byte scanning blocks are tokenized intact.
+ */
+- (void)testFieldsCrossingScanBlocks
+{
+	NSMutableString *longValue = [NSMutableString string];
+	for (NSUInteger i = 0; i < 300; i++) [longValue appendFormat:@"%lu", (unsigned long)(i % 10)];
+
+	NSString *csv = [NSString stringWithFormat:@"%@,\"%@,\n%@\",x\n", longValue, longValue, longValue];
+
+	[self _assertDataParsingMatchesStringParsing:csv fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\" strict:NO nullString:nil];
+}
+
+/**
+ * Data which can't be decoded in the chosen encoding is reported instead of being imported.
+ */
+- (void)testInvalidEncoding
+{
+	SPCSVParser *parser = [self _parserWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"];
+	const uint8_t bytes[] = { 'a', ',', 0xC3, 0x28, '\n' };
+
+	XCTAssertTrue([parser parseDataWithEncoding:NSUTF8StringEncoding]);
+
+	[parser appendData:[NSData dataWithBytes:bytes length:sizeof(bytes)]];
+	[parser getRowAsArrayAndTrimString:YES stringIsComplete:YES];
+
+	XCTAssertTrue([parser encodingErrorOccurred]);
+}
+
+/**
+ * Multi-character terminators and encodings such as UTF-16 fall back to string parsing.
+ */
+- (void)testUnsupportedSettings
+{
+	XCTAssertFalse([SPCSVTokenizer canTokenizeStringEncoding:NSUTF8StringEncoding fieldTerminator:@"||" lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"]);
+	XCTAssertFalse([SPCSVTokenizer canTokenizeStringEncoding:NSUTF16StringEncoding fieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"]);
+	XCTAssertTrue([SPCSVTokenizer canTokenizeStringEncoding:NSISOLatin1StringEncoding fieldTerminator:@";" lineTerminator:@"\r\n" fieldQuote:@"" escape:@""]);
+
+	SPCSVParser *parser = [self _parserWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"];
+
+	XCTAssertFalse([parser parseDataWithEncoding:NSUTF16StringEncoding]);
+}
+
+#pragma mark -
+
+- (SPCSVParser *)_parserWithFieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape
+{
+	SPCSVParser *parser = [[[SPCSVParser alloc] init] autorelease];
+
+	[parser setFieldTerminatorString:fieldEnd convertDisplayStrings:NO];
+	[parser setLineTerminatorString:lineEnd convertDisplayStrings:NO];
+	[parser setFieldQuoteString:fieldQuote convertDisplayStrings:NO];
+	[parser setEscapeString:escape convertDisplayStrings:NO];
+
+	return parser;
+}
+
+- (NSArray *)_rowsFromParser:(SPCSVParser *)parser
+{
+	NSMutableArray *rows = [NSMutableArray array];
+	NSArray *row;
+
+	while ((row = [parser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [rows addObject:row];
+
+	return rows;
+}
+
+- (void)_assertDataParsingMatchesStringParsing:(NSString *)csv fieldTerminator:(NSString *)fieldEnd lineTerminator:(NSString *)lineEnd fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape strict:(BOOL)strict nullString:(NSString *)nullString
+{
+	SPCSVParser *stringParser = [self _parserWithFieldTerminator:fieldEnd lineTerminator:lineEnd fieldQuote:fieldQuote escape:escape];
+	SPCSVParser *dataParser = [self _parserWithFieldTerminator:fieldEnd lineTerminator:lineEnd fieldQuote:fieldQuote escape:escape];
+
+	for (SPCSVParser *parser in @[stringParser, dataParser]) {
+		[parser setEscapeStringsAreMatchedStrictly:strict];
+		if (nullString) [parser setNullReplacementString:nullString];
+	}
+
+	[stringParser setString:csv];
+
+	XCTAssertTrue([dataParser parseDataWithEncoding:NSUTF8StringEncoding]);
+	[dataParser appendData:[csv dataUsingEncoding:NSUTF8StringEncoding]];
+
+	XCTAssertEqualObjects([self _rowsFromParser:dataParser], [self _rowsFromParser:stringParser]);
+}
+
+@end
@@ -0,0 +1,209 @@
+//
+//  SPExportCheckpointTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportCheckpoint.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPExportCheckpointTests : XCTestCase
+{
+	NSString *exportFilePath;
+	NSDictionary *settings;
+}
+
+- (void)_writeFileAtPath:(NSString *)path length:(NSUInteger)length;
+- (SPExportCheckpoint *)_begunCheckpoint;
+
+@end
+
+@implementation SPExportCheckpointTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	exportFilePath = [[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPExportCheckpointTests-%@.sql", [[NSProcessInfo processInfo] globallyUniqueString]]] retain];
+	settings = [@{@"Host" : @"localhost", @"Database" : @"shop", @"InsertAfterNValue" : @250000} retain];
+}
+
+- (void)tearDown
+{
+	[[SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath] remove];
+	[[NSFileManager defaultManager] removeItemAtPath:exportFilePath error:NULL];
+
+	[exportFilePath release], exportFilePath = nil;
+	[settings release], settings = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Writes a file of the supplied length.
+ */
+- (void)_writeFileAtPath:(NSString *)path length:(NSUInteger)length
+{
+	XCTAssertTrue([[NSMutableData dataWithLength:length] writeToFile:path atomically:NO]);
+}
+
+/**
+ * Returns a checkpoint begun for an export of the tables items and orders.
+ */
+- (SPExportCheckpoint *)_begunCheckpoint
+{
+	SPExportCheckpoint *checkpoint = [SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath];
+
+	XCTAssertTrue([checkpoint beginWithSettings:settings tableNames:@[@"items", @"orders"]]);
+
+	return checkpoint;
+}
+
+/**
+ * The progress recorded in the manifest is read back by a new checkpoint of the same export file.
+ */
+- (void)testManifestRoundTrip
+{
+	SPExportCheckpoint *checkpoint = [self _begunCheckpoint];
+
+	[self _writeFileAtPath:exportFilePath length:300];
+	[self _writeFileAtPath:[checkpoint dumpPathForTable:@"orders"] length:80];
+
+	[checkpoint recordExportFileOffset:100];
+	[checkpoint recordCompletedTable:@"items" exportFileOffset:300 viewSyntaxes:@{@"recent" : @"CREATE VIEW `recent` AS SELECT 1"} errors:@"items: warning\n"];
+	[checkpoint recordPartialDumpOfTable:@"orders" length:80 keyColumn:@"id" keyBound:@"'41'" rowCount:40];
+
+	SPExportCheckpoint *loadedCheckpoint = [SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath];
+
+	XCTAssertTrue([loadedCheckpoint loadWithSettings:settings]);
+	XCTAssertEqual([loadedCheckpoint exportFileOffset], 300ULL);
+	XCTAssertEqualObjects([loadedCheckpoint completedTables], @[@"items"]);
+	XCTAssertEqualObjects([loadedCheckpoint viewSyntaxes], @{@"recent" : @"CREATE VIEW `recent` AS SELECT 1"});
+	XCTAssertEqualObjects([loadedCheckpoint errors], @"items: warning\n");
+	XCTAssertEqualObjects([loadedCheckpoint dumpPathForTable:@"orders"], [checkpoint dumpPathForTable:@"orders"]);
+	XCTAssertNil([loadedCheckpoint dumpPathForTable:@"customers"]);
+
+	NSDictionary *expectedPartialDump = @{
+		SPExportCheckpointDumpLengthKey : @80,
+		SPExportCheckpointKeyColumnKey  : @"id",
+		SPExportCheckpointKeyBoundKey   : @"'41'",
+		SPExportCheckpointRowCountKey   : @40
+	};
+
+	XCTAssertEqualObjects([loadedCheckpoint partialDumpForTable:@"orders"], expectedPartialDump);
+	XCTAssertNil([loadedCheckpoint partialDumpForTable:@"items"]);
+}
+
+/**
+ * An export is only resumed with the settings it was checkpointed with.
+ */
+- (void)testLoadRejectsMismatchedSettings
+{
+	SPExportCheckpoint *checkpoint = [self _begunCheckpoint];
+
+	[self _writeFileAtPath:exportFilePath length:100];
+	[checkpoint recordExportFileOffset:100];
+
+	NSMutableDictionary *changedSettings = [[settings mutableCopy] autorelease];
+
+	[changedSettings setObject:@1000 forKey:@"InsertAfterNValue"];
+
+	SPExportCheckpoint *loadedCheckpoint = [SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath];
+
+	XCTAssertFalse([loadedCheckpoint loadWithSettings:changedSettings]);
+	XCTAssertFalse([loadedCheckpoint loadWithSettings:@{}]);
+	XCTAssertTrue([loadedCheckpoint loadWithSettings:settings]);
+}
+
+/**
+ * An export can't be resumed before its header has been checkpointed, or once the export file no
+ * longer holds the data up to its last checkpoint.
+ */
+- (void)testLoadRejectsMissingCheckpointedData
+{
+	SPExportCheckpoint *checkpoint = [self _begunCheckpoint];
+
+	[self _writeFileAtPath:exportFilePath length:100];
+
+	XCTAssertFalse([[SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath] loadWithSettings:settings]);
+
+	[checkpoint recordExportFileOffset:200];
+
+	XCTAssertFalse([[SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath] loadWithSettings:settings]);
+
+	[[NSFileManager defaultManager] removeItemAtPath:exportFilePath error:NULL];
+
+	XCTAssertFalse([[SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath] loadWithSettings:settings]);
+}
+
+/**
+ * A partial dump is only continued while its dump file still holds the checkpointed data, and
+ * is discarded once the table has been completed.
+ */
+- (void)testPartialDumpLifetime
+{
+	SPExportCheckpoint *checkpoint = [self _begunCheckpoint];
+
+	[self _writeFileAtPath:[checkpoint dumpPathForTable:@"orders"] length:50];
+	[checkpoint recordPartialDumpOfTable:@"orders" length:80 keyColumn:@"id" keyBound:@"'41'" rowCount:40];
+
+	XCTAssertNil([checkpoint partialDumpForTable:@"orders"]);
+
+	[self _writeFileAtPath:[checkpoint dumpPathForTable:@"orders"] length:120];
+
+	XCTAssertEqualObjects([[checkpoint partialDumpForTable:@"orders"] objectForKey:SPExportCheckpointKeyBoundKey], @"'41'");
+
+	[checkpoint recordCompletedTable:@"orders" exportFileOffset:500 viewSyntaxes:@{} errors:@""];
+
+	XCTAssertNil([checkpoint partialDumpForTable:@"orders"]);
+	XCTAssertEqualObjects([checkpoint completedTables], @[@"orders"]);
+}
+
+/**
+ * Beginning a checkpoint discards any earlier one, and removing it deletes its directory.
+ */
+- (void)testBeginAndRemove
+{
+	SPExportCheckpoint *checkpoint = [self _begunCheckpoint];
+	NSString *checkpointDirectory = [[checkpoint dumpPathForTable:@"items"] stringByDeletingLastPathComponent];
+
+	[self _writeFileAtPath:exportFilePath length:100];
+	[checkpoint recordCompletedTable:@"items" exportFileOffset:100 viewSyntaxes:@{} errors:@""];
+
+	SPExportCheckpoint *restartedCheckpoint = [self _begunCheckpoint];
+
+	XCTAssertEqualObjects([restartedCheckpoint completedTables], @[]);
+	XCTAssertEqual([restartedCheckpoint exportFileOffset], 0ULL);
+	XCTAssertFalse([[SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath] loadWithSettings:settings]);
+
+	[restartedCheckpoint remove];
+
+	XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:checkpointDirectory]);
+}
+
+@end
@@ -0,0 +1,530 @@
+//
+//  SPExportChunkedTableReaderTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportChunkedTableReader.h"
+#import "SPExportConnectionPool.h"
+#import "RegexKitLite.h"
+
+#import <SPMySQL/SPMySQL.h>
+#import <XCTest/XCTest.h>
+
+static NSString *SPExportChunkedTableReaderTestBoundaryRegex = @"^SELECT `id` FROM `items`(?: WHERE `id` > '(\\d+)')? ORDER BY `id` LIMIT 1 OFFSET (\\d+)$";
+static NSString *SPExportChunkedTableReaderTestFetchRegex = @"^SELECT \\* FROM `items`(?: WHERE `id` > '(\\d+)')?(?: (?:WHERE|AND) `id` <= '(\\d+)')?$";
+
+/**
+ * A table of (id, name) rows keyed by even ids from 2 to 70, shared by every test connection, which
+ * logs the queries run and the lower bounds of the chunks fetched in the order they complete.
+ */
+@interface SPExportChunkedTableReaderTestTable : NSObject
+{
+	NSMutableArray *queryLog;
+	NSMutableArray *completedFetches;
+	NSTimeInterval firstChunkDelay;
+}
+
+@property (assign) NSTimeInterval firstChunkDelay;
+
+- (NSArray *)rowsAfter:(NSInteger)lowerBound upTo:(NSInteger)upperBound;
+- (void)logQuery:(NSString *)query;
+- (void)logCompletedFetch:(NSInteger)lowerBound;
+- (NSArray *)queryLog;
+- (NSArray *)completedFetches;
+- (NSUInteger)boundaryQueryCount;
+
+@end
+
+@implementation SPExportChunkedTableReaderTestTable
+
+@synthesize firstChunkDelay;
+
+- (id)init
+{
+	if ((self = [super init])) {
+		queryLog = [[NSMutableArray alloc] init];
+		completedFetches = [[NSMutableArray alloc] init];
+		firstChunkDelay = 0;
+	}
+
+	return self;
+}
+
+- (NSArray *)rowsAfter:(NSInteger)lowerBound upTo:(NSInteger)upperBound
+{
+	NSMutableArray *rows = [NSMutableArray array];
+
+	for (NSInteger key = 2; key <= 70; key += 2) {
+		if (key > lowerBound && key <= upperBound) [rows addObject:@[[NSString stringWithFormat:@"%ld", (long)key], [NSString stringWithFormat:@"item %ld", (long)key]]];
+	}
+
+	return rows;
+}
+
+- (void)logQuery:(NSString *)query
+{
+	@synchronized(self) {
+		[queryLog addObject:query];
+	}
+}
+
+- (void)logCompletedFetch:(NSInteger)lowerBound
+{
+	@synchronized(self) {
+		[completedFetches addObject:@(lowerBound)];
+	}
+}
+
+- (NSArray *)queryLog
+{
+	@synchronized(self) {
+		return [[queryLog copy] autorelease];
+	}
+}
+
+- (NSArray *)completedFetches
+{
+	@synchronized(self) {
+		return [[completedFetches copy] autorelease];
+	}
+}
+
+- (NSUInteger)boundaryQueryCount
+{
+	NSUInteger count = 0;
+
+	for (NSString *query in [self queryLog]) {
+		if ([query isMatchedByRegex:SPExportChunkedTableReaderTestBoundaryRegex]) count++;
+	}
+
+	return count;
+}
+
+- (void)dealloc
+{
+	[queryLog release];
+	[completedFetches release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * A result returning the supplied rows in turn.
+ */
+@interface SPExportChunkedTableReaderTestResult : NSObject
+{
+	NSArray *rows;
+	NSUInteger rowIndex;
+}
+
+- (id)initWithRows:(NSArray *)someRows;
+- (NSArray *)getRowAsArray;
+- (NSArray *)fieldNames;
+
+@end
+
+@implementation SPExportChunkedTableReaderTestResult
+
+- (id)initWithRows:(NSArray *)someRows
+{
+	if ((self = [super init])) {
+		rows = [someRows retain];
+		rowIndex = 0;
+	}
+
+	return self;
+}
+
+- (NSArray *)getRowAsArray
+{
+	if (rowIndex >= [rows count]) return nil;
+
+	return [rows objectAtIndex:rowIndex++];
+}
+
+- (NSArray *)fieldNames
+{
+	return @[@"id", @"name"];
+}
+
+- (void)dealloc
+{
+	[rows release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for a connection to the test table, answering the reader's boundary and chunk queries.
+ */
+@interface SPExportChunkedTableReaderTestConnection : NSObject
+{
+	SPExportChunkedTableReaderTestTable *table;
+}
+
+- (id)initWithTable:(SPExportChunkedTableReaderTestTable *)aTable;
+
+@end
+
+@implementation SPExportChunkedTableReaderTestConnection
+
+- (id)initWithTable:(SPExportChunkedTableReaderTestTable *)aTable
+{
+	if ((self = [super init])) {
+		table = [aTable retain];
+	}
+
+	return self;
+}
+
+- (id)queryString:(NSString *)query
+{
+	[table logQuery:query];
+
+	NSArray *boundary = [query captureComponentsMatchedByRegex:SPExportChunkedTableReaderTestBoundaryRegex];
+	NSArray *keyRows = [table rowsAfter:[[boundary objectAtIndex:1] integerValue] upTo:NSIntegerMax];
+	NSUInteger offset = [[boundary objectAtIndex:2] integerValue];
+
+	return [[[SPExportChunkedTableReaderTestResult alloc] initWithRows:((offset < [keyRows count]) ? @[@[[[keyRows objectAtIndex:offset] objectAtIndex:0]]] : @[])] autorelease];
+}
+
+- (id)streamingQueryString:(NSString *)query useLowMemoryBlockingStreaming:(BOOL)fullStreaming
+{
+	[table logQuery:query];
+
+	NSArray *bounds = [query captureComponentsMatchedByRegex:SPExportChunkedTableReaderTestFetchRegex];
+	NSInteger lowerBound = [[bounds objectAtIndex:1] integerValue];
+	NSString *upperBound = [bounds objectAtIndex:2];
+
+	if (!lowerBound && [table firstChunkDelay] > 0) [NSThread sleepForTimeInterval:[table firstChunkDelay]];
+
+	[table logCompletedFetch:lowerBound];
+
+	return [[[SPExportChunkedTableReaderTestResult alloc] initWithRows:[table rowsAfter:lowerBound upTo:([upperBound length] ? [upperBound integerValue] : NSIntegerMax)]] autorelease];
+}
+
+- (BOOL)queryErrored
+{
+	return NO;
+}
+
+- (NSString *)lastErrorMessage
+{
+	return nil;
+}
+
+- (BOOL)isConnected
+{
+	return YES;
+}
+
+- (NSString *)escapeAndQuoteString:(NSString *)string
+{
+	return [NSString stringWithFormat:@"'%@'", string];
+}
+
+- (void)dealloc
+{
+	[table release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for the export connection pool, handing out its idle connections.
+ */
+@interface SPExportChunkedTableReaderTestPool : NSObject
+{
+	NSMutableArray *idleConnections;
+}
+
+- (id)initWithConnections:(NSArray *)connections;
+- (SPMySQLConnection *)checkoutIdleConnection;
+- (void)checkinConnection:(SPMySQLConnection *)connection;
+
+@end
+
+@implementation SPExportChunkedTableReaderTestPool
+
+- (id)initWithConnections:(NSArray *)connections
+{
+	if ((self = [super init])) {
+		idleConnections = [connections mutableCopy];
+	}
+
+	return self;
+}
+
+- (SPMySQLConnection *)checkoutIdleConnection
+{
+	@synchronized(self) {
+		if (![idleConnections count]) return nil;
+
+		SPMySQLConnection *connection = [[[idleConnections lastObject] retain] autorelease];
+		[idleConnections removeLastObject];
+
+		return connection;
+	}
+}
+
+- (void)checkinConnection:(SPMySQLConnection *)connection
+{
+	@synchronized(self) {
+		[idleConnections addObject:connection];
+	}
+}
+
+- (void)dealloc
+{
+	[idleConnections release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPExportChunkedTableReaderTests : XCTestCase
+{
+	SPExportChunkedTableReaderTestTable *table;
+	SPExportChunkedTableReaderTestConnection *connection;
+}
+
+- (SPExportChunkedTableReader *)_readerWithChunkLength:(NSUInteger)length pool:(SPExportChunkedTableReaderTestPool *)pool;
+- (NSArray *)_keysReadFromReader:(SPExportChunkedTableReader *)reader rowLimit:(NSUInteger)rowLimit;
+- (NSUInteger)_settledBoundaryQueryCount;
+
+@end
+
+@implementation SPExportChunkedTableReaderTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	table = [[SPExportChunkedTableReaderTestTable alloc] init];
+	connection = [[SPExportChunkedTableReaderTestConnection alloc] initWithTable:table];
+}
+
+- (void)tearDown
+{
+	[connection release], connection = nil;
+	[table release], table = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns a reader of the test table with a fixed chunk length.
+ */
+- (SPExportChunkedTableReader *)_readerWithChunkLength:(NSUInteger)length pool:(SPExportChunkedTableReaderTestPool *)pool
+{
+	SPExportChunkedTableReader *reader = [[[SPExportChunkedTableReader alloc] initWithTableName:@"items" keyColumn:@"id" selectColumns:@"*" connection:(SPMySQLConnection *)connection connectionPool:(SPExportConnectionPool *)pool] autorelease];
+
+	[reader setChunkLength:length];
+	[reader setAdaptsChunkLength:NO];
+
+	return reader;
+}
+
+/**
+ * Returns the keys of the rows read, up to the supplied number of rows.
+ */
+- (NSArray *)_keysReadFromReader:(SPExportChunkedTableReader *)reader rowLimit:(NSUInteger)rowLimit
+{
+	NSMutableArray *keys = [NSMutableArray array];
+	NSArray *row;
+
+	while ([keys count] < rowLimit && (row = [reader getRowAsArray])) {
+		[keys addObject:[row objectAtIndex:0]];
+	}
+
+	return keys;
+}
+
+/**
+ * Returns the number of boundary queries run once the fetchers have stopped claiming chunks.
+ */
+- (NSUInteger)_settledBoundaryQueryCount
+{
+	NSUInteger count = [table boundaryQueryCount];
+
+	for (NSUInteger i = 0; i < 50; i++) {
+		[NSThread sleepForTimeInterval:0.05];
+
+		NSUInteger newCount = [table boundaryQueryCount];
+
+		if (newCount == count && i >= 4) break;
+
+		count = newCount;
+	}
+
+	return count;
+}
+
+/**
+ * Each chunk's upper bound is sought a chunk length along the key from the previous bound, and
+ * the chunk without a bound found is the final one.
+ */
+- (void)testBoundarySeeking
+{
+	SPExportChunkedTableReader *reader = [self _readerWithChunkLength:10 pool:nil];
+
+	[reader startReading];
+
+	XCTAssertEqual([[self _keysReadFromReader:reader rowLimit:11] count], (NSUInteger)11);
+	XCTAssertEqual([reader completedChunkCount], (NSUInteger)1);
+	XCTAssertEqualObjects([reader completedKeyBound], @"'20'");
+
+	XCTAssertEqual([[self _keysReadFromReader:reader rowLimit:NSUIntegerMax] count], (NSUInteger)24);
+	XCTAssertEqual([reader completedChunkCount], (NSUInteger)4);
+	XCTAssertNil([reader completedKeyBound]);
+
+	NSArray *expectedQueries = @[
+		@"SELECT `id` FROM `items` ORDER BY `id` LIMIT 1 OFFSET 9",
+		@"SELECT * FROM `items` WHERE `id` <= '20'",
+		@"SELECT `id` FROM `items` WHERE `id` > '20' ORDER BY `id` LIMIT 1 OFFSET 9",
+		@"SELECT * FROM `items` WHERE `id` > '20' AND `id` <= '40'",
+		@"SELECT `id` FROM `items` WHERE `id` > '40' ORDER BY `id` LIMIT 1 OFFSET 9",
+		@"SELECT * FROM `items` WHERE `id` > '40' AND `id` <= '60'",
+		@"SELECT `id` FROM `items` WHERE `id` > '60' ORDER BY `id` LIMIT 1 OFFSET 9",
+		@"SELECT * FROM `items` WHERE `id` > '60'"
+	];
+
+	XCTAssertEqualObjects([table queryLog], expectedQueries);
+	XCTAssertEqualObjects([reader fieldNames], (@[@"id", @"name"]));
+}
+
+/**
+ * A resumed read seeks its first boundary from the initial lower bound, skipping the rows before it.
+ */
+- (void)testInitialLowerBound
+{
+	SPExportChunkedTableReader *reader = [self _readerWithChunkLength:10 pool:nil];
+
+	[reader setInitialLowerBound:@"'40'"];
+	[reader startReading];
+
+	NSArray *keys = [self _keysReadFromReader:reader rowLimit:NSUIntegerMax];
+
+	XCTAssertEqualObjects([keys firstObject], @"42");
+	XCTAssertEqual([keys count], (NSUInteger)15);
+	XCTAssertEqualObjects([[table queryLog] firstObject], @"SELECT `id` FROM `items` WHERE `id` > '40' ORDER BY `id` LIMIT 1 OFFSET 9");
+}
+
+/**
+ * Chunks fetched concurrently on pooled connections are held in the reorder buffer until the
+ * chunks before them have been read, so the rows are returned in key order even when a later
+ * chunk is fetched first.
+ */
+- (void)testReorderBufferReturnsRowsInKeyOrder
+{
+	NSMutableArray *helperConnections = [NSMutableArray array];
+	for (NSUInteger i = 0; i < 3; i++) {
+		[helperConnections addObject:[[[SPExportChunkedTableReaderTestConnection alloc] initWithTable:table] autorelease]];
+	}
+
+	SPExportChunkedTableReaderTestPool *pool = [[[SPExportChunkedTableReaderTestPool alloc] initWithConnections:helperConnections] autorelease];
+	SPExportChunkedTableReader *reader = [self _readerWithChunkLength:5 pool:pool];
+
+	[table setFirstChunkDelay:0.5];
+	[reader startReading];
+
+	NSArray *keys = [self _keysReadFromReader:reader rowLimit:NSUIntegerMax];
+	NSMutableArray *expectedKeys = [NSMutableArray array];
+
+	for (NSInteger key = 2; key <= 70; key += 2) {
+		[expectedKeys addObject:[NSString stringWithFormat:@"%ld", (long)key]];
+	}
+
+	// Seven chunks of five rows end at a bound, followed by an empty final chunk
+	XCTAssertEqualObjects(keys, expectedKeys);
+	XCTAssertEqual([reader completedChunkCount], (NSUInteger)8);
+	XCTAssertNotEqualObjects([[table completedFetches] firstObject], @0);
+}
+
+/**
+ * No more than eight chunks are claimed ahead of the chunk being read.
+ */
+- (void)testReadAheadLimitsClaimedChunks
+{
+	SPExportChunkedTableReader *reader = [self _readerWithChunkLength:2 pool:nil];
+
+	[reader startReading];
+
+	XCTAssertEqual([self _settledBoundaryQueryCount], (NSUInteger)8);
+
+	XCTAssertEqual([[self _keysReadFromReader:reader rowLimit:NSUIntegerMax] count], (NSUInteger)35);
+	XCTAssertEqual([table boundaryQueryCount], (NSUInteger)18);
+}
+
+/**
+ * Once the fetched chunks waiting for the reader reach the maximum buffered size, only the chunk
+ * the reader needs next is claimed.
+ */
+- (void)testBufferedBytesLimitClaimedChunks
+{
+	SPExportChunkedTableReader *reader = [self _readerWithChunkLength:2 pool:nil];
+
+	[reader setMaximumBufferedBytes:1];
+	[reader startReading];
+
+	XCTAssertEqual([self _settledBoundaryQueryCount], (NSUInteger)1);
+
+	// Reading the rows of the first chunk doesn't release it until the next chunk is needed
+	XCTAssertEqual([[self _keysReadFromReader:reader rowLimit:2] count], (NSUInteger)2);
+	XCTAssertEqual([self _settledBoundaryQueryCount], (NSUInteger)1);
+
+	XCTAssertEqual([[self _keysReadFromReader:reader rowLimit:1] count], (NSUInteger)1);
+	XCTAssertEqual([self _settledBoundaryQueryCount], (NSUInteger)2);
+
+	[reader cancelResultLoad];
+}
+
+/**
+ * Only large tables with a single-column primary key of a consistently ordered type are chunked.
+ */
+- (void)testChunkingKey
+{
+	NSDictionary *tableDetails = @{
+		@"primarykeyfield" : @[@"id"],
+		@"columns" : @[@{@"name" : @"id", @"typegrouping" : @"integer"}, @{@"name" : @"price", @"typegrouping" : @"float"}]
+	};
+
+	XCTAssertEqualObjects([SPExportChunkedTableReader chunkingKeyForTableDetails:tableDetails rowCount:500000], @"id");
+	XCTAssertNil([SPExportChunkedTableReader chunkingKeyForTableDetails:tableDetails rowCount:499999]);
+	XCTAssertNil([SPExportChunkedTableReader chunkingKeyForTableDetails:@{@"primarykeyfield" : @[@"id", @"price"], @"columns" : [tableDetails objectForKey:@"columns"]} rowCount:500000]);
+	XCTAssertNil([SPExportChunkedTableReader chunkingKeyForTableDetails:@{@"primarykeyfield" : @[@"price"], @"columns" : [tableDetails objectForKey:@"columns"]} rowCount:500000]);
+}
+
+@end
@@ -0,0 +1,450 @@
+//
+//  SPExportConnectionPoolTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportConnectionPool.h"
+
+#import <SPMySQL/SPMySQL.h>
+#import <XCTest/XCTest.h>
+
+static NSString *SPExportConnectionPoolTestSnapshotQuery = @"START TRANSACTION /*!40100 WITH CONSISTENT SNAPSHOT */";
+
+/**
+ * The state shared by a test connection and its copies: the log of queries run on any of them,
+ * the queries that fail, and the number of copies able to connect.
+ */
+@interface SPExportConnectionPoolTestServer : NSObject
+{
+	NSMutableArray *queryLog;
+	NSMutableSet *failingQueries;
+	NSUInteger connectionLimit;
+	NSUInteger connectionCount;
+}
+
+@property (readonly) NSMutableArray *queryLog;
+@property (readonly) NSMutableSet *failingQueries;
+@property (assign) NSUInteger connectionLimit;
+
+- (BOOL)openConnection;
+
+@end
+
+@implementation SPExportConnectionPoolTestServer
+
+@synthesize queryLog;
+@synthesize failingQueries;
+@synthesize connectionLimit;
+
+- (id)init
+{
+	if ((self = [super init])) {
+		queryLog = [[NSMutableArray alloc] init];
+		failingQueries = [[NSMutableSet alloc] init];
+		connectionLimit = NSUIntegerMax;
+		connectionCount = 0;
+	}
+
+	return self;
+}
+
+- (BOOL)openConnection
+{
+	if (connectionCount >= connectionLimit) return NO;
+
+	connectionCount++;
+
+	return YES;
+}
+
+- (void)dealloc
+{
+	[queryLog release];
+	[failingQueries release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * A result returning a single row.
+ */
+@interface SPExportConnectionPoolTestResult : NSObject
+{
+	NSArray *row;
+}
+
+- (id)initWithRow:(NSArray *)aRow;
+- (NSArray *)getRowAsArray;
+
+@end
+
+@implementation SPExportConnectionPoolTestResult
+
+- (id)initWithRow:(NSArray *)aRow
+{
+	if ((self = [super init])) {
+		row = [aRow retain];
+	}
+
+	return self;
+}
+
+- (NSArray *)getRowAsArray
+{
+	return row;
+}
+
+- (void)dealloc
+{
+	[row release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for the connections used by the pool, logging each query prefixed with the number
+ * of the connection it was run on.  The parent connection is number 0, and its copies are
+ * numbered from 1 in the order they are made.
+ */
+@interface SPExportConnectionPoolTestConnection : NSObject <NSCopying>
+{
+	SPExportConnectionPoolTestServer *server;
+	NSUInteger connectionNumber;
+	NSUInteger copyCount;
+	BOOL connected;
+	BOOL lastQueryErrored;
+}
+
+- (id)initWithServer:(SPExportConnectionPoolTestServer *)aServer connectionNumber:(NSUInteger)aNumber;
+
+@end
+
+@implementation SPExportConnectionPoolTestConnection
+
+- (id)initWithServer:(SPExportConnectionPoolTestServer *)aServer connectionNumber:(NSUInteger)aNumber
+{
+	if ((self = [super init])) {
+		server = [aServer retain];
+		connectionNumber = aNumber;
+		copyCount = 0;
+		connected = (aNumber == 0);
+		lastQueryErrored = NO;
+	}
+
+	return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone
+{
+	return [[SPExportConnectionPoolTestConnection allocWithZone:zone] initWithServer:server connectionNumber:++copyCount];
+}
+
+- (void)_logQuery:(NSString *)query
+{
+	@synchronized(server) {
+		[[server queryLog] addObject:[NSString stringWithFormat:@"%lu: %@", (unsigned long)connectionNumber, query]];
+	}
+}
+
+- (id)queryString:(NSString *)query
+{
+	[self _logQuery:query];
+
+	lastQueryErrored = [[server failingQueries] containsObject:query];
+
+	if ([query isEqualToString:@"SELECT DATABASE(), @@SESSION.sql_mode, @@SESSION.time_zone"]) {
+		return [[[SPExportConnectionPoolTestResult alloc] initWithRow:@[@"test_db", @"ANSI_QUOTES", @"Europe/Berlin"]] autorelease];
+	}
+
+	return nil;
+}
+
+- (BOOL)queryErrored
+{
+	return lastQueryErrored;
+}
+
+- (BOOL)connect
+{
+	connected = [server openConnection];
+
+	return connected;
+}
+
+- (BOOL)isConnected
+{
+	return connected;
+}
+
+- (void)disconnect
+{
+	[self _logQuery:@"DISCONNECT"];
+
+	connected = NO;
+}
+
+- (BOOL)selectDatabase:(NSString *)database
+{
+	[self _logQuery:[NSString stringWithFormat:@"USE %@", database]];
+
+	return YES;
+}
+
+- (NSString *)encoding
+{
+	return @"utf8mb4";
+}
+
+- (BOOL)setEncoding:(NSString *)encoding
+{
+	return YES;
+}
+
+- (NSUInteger)port
+{
+	return 3306;
+}
+
+- (void)setPort:(NSUInteger)port
+{
+}
+
+- (NSString *)escapeAndQuoteString:(NSString *)string
+{
+	return [NSString stringWithFormat:@"'%@'", string];
+}
+
+- (void)dealloc
+{
+	[server release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPExportConnectionPoolTests : XCTestCase
+{
+	SPExportConnectionPoolTestServer *server;
+	SPExportConnectionPoolTestConnection *parentConnection;
+	SPExportConnectionPool *pool;
+}
+
+- (NSArray *)_queriesMatching:(NSString *)query;
+
+@end
+
+@implementation SPExportConnectionPoolTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	server = [[SPExportConnectionPoolTestServer alloc] init];
+	parentConnection = [[SPExportConnectionPoolTestConnection alloc] initWithServer:server connectionNumber:0];
+	pool = [[SPExportConnectionPool alloc] initWithConnection:(SPMySQLConnection *)parentConnection];
+}
+
+- (void)tearDown
+{
+	[pool release], pool = nil;
+	[parentConnection release], parentConnection = nil;
+	[server release], server = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns the logged queries ending with the supplied query, in the order they were run.
+ */
+- (NSArray *)_queriesMatching:(NSString *)query
+{
+	return [[server queryLog] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF ENDSWITH %@", query]];
+}
+
+/**
+ * A pool of fewer than two connections offers nothing over the parent connection, so none is opened.
+ */
+- (void)testOpenConnectionsRequiresTwoConnections
+{
+	XCTAssertFalse([pool openConnections:1]);
+	XCTAssertEqual([pool connectionCount], (NSUInteger)0);
+	XCTAssertEqualObjects([server queryLog], @[]);
+}
+
+/**
+ * Each connection mirrors the parent's session, and all snapshots are started under one global
+ * read lock, which is released once the last has started.
+ */
+- (void)testOpenConnectionsStartsSnapshotsUnderReadLock
+{
+	XCTAssertTrue([pool openConnections:3]);
+	XCTAssertEqual([pool connectionCount], (NSUInteger)3);
+	XCTAssertTrue([pool usesSharedSnapshot]);
+
+	NSArray *expectedQueries = @[
+		@"0: SELECT DATABASE(), @@SESSION.sql_mode, @@SESSION.time_zone",
+		@"1: USE test_db",
+		@"1: SET SQL_MODE='ANSI_QUOTES'",
+		@"1: SET TIME_ZONE='Europe/Berlin'",
+		@"1: SET SESSION TRANSACTION ISOLATION LEVEL REPEATABLE READ",
+		@"2: USE test_db",
+		@"2: SET SQL_MODE='ANSI_QUOTES'",
+		@"2: SET TIME_ZONE='Europe/Berlin'",
+		@"2: SET SESSION TRANSACTION ISOLATION LEVEL REPEATABLE READ",
+		@"3: USE test_db",
+		@"3: SET SQL_MODE='ANSI_QUOTES'",
+		@"3: SET TIME_ZONE='Europe/Berlin'",
+		@"3: SET SESSION TRANSACTION ISOLATION LEVEL REPEATABLE READ",
+		@"1: FLUSH TABLES WITH READ LOCK",
+		[@"1: " stringByAppendingString:SPExportConnectionPoolTestSnapshotQuery],
+		[@"2: " stringByAppendingString:SPExportConnectionPoolTestSnapshotQuery],
+		[@"3: " stringByAppendingString:SPExportConnectionPoolTestSnapshotQuery],
+		@"1: UNLOCK TABLES"
+	];
+
+	XCTAssertEqualObjects([server queryLog], expectedQueries);
+}
+
+/**
+ * Without the privilege to take the global read lock the snapshots are started back-to-back, and
+ * the pool reports that they may differ.
+ */
+- (void)testOpenConnectionsWithoutReadLock
+{
+	[[server failingQueries] addObject:@"FLUSH TABLES WITH READ LOCK"];
+
+	XCTAssertTrue([pool openConnections:2]);
+	XCTAssertFalse([pool usesSharedSnapshot]);
+	XCTAssertEqual([[self _queriesMatching:SPExportConnectionPoolTestSnapshotQuery] count], (NSUInteger)2);
+	XCTAssertEqualObjects([self _queriesMatching:@"UNLOCK TABLES"], @[]);
+}
+
+/**
+ * A pool left with a single connection is closed again, disconnecting it.
+ */
+- (void)testOpenConnectionsFailsWithTooFewConnections
+{
+	[server setConnectionLimit:1];
+
+	XCTAssertFalse([pool openConnections:4]);
+	XCTAssertEqual([pool connectionCount], (NSUInteger)0);
+	XCTAssertEqualObjects([self _queriesMatching:SPExportConnectionPoolTestSnapshotQuery], @[]);
+	XCTAssertEqualObjects([self _queriesMatching:@"DISCONNECT"], @[@"1: DISCONNECT"]);
+}
+
+/**
+ * A snapshot which can't be started closes the pool, so no table is dumped from a different
+ * point in time.
+ */
+- (void)testOpenConnectionsFailsIfSnapshotFails
+{
+	[[server failingQueries] addObject:SPExportConnectionPoolTestSnapshotQuery];
+
+	XCTAssertFalse([pool openConnections:2]);
+	XCTAssertEqual([pool connectionCount], (NSUInteger)0);
+	XCTAssertFalse([pool usesSharedSnapshot]);
+	XCTAssertNil([pool checkoutIdleConnection]);
+
+	NSArray *expectedDisconnects = @[@"1: DISCONNECT", @"2: DISCONNECT"];
+
+	XCTAssertEqualObjects([self _queriesMatching:@"DISCONNECT"], expectedDisconnects);
+}
+
+/**
+ * Connections are handed out once each until checked back in, and connections not belonging to
+ * the pool are not accepted.
+ */
+- (void)testCheckoutAndCheckin
+{
+	XCTAssertTrue([pool openConnections:2]);
+
+	SPMySQLConnection *firstConnection = [pool checkoutIdleConnection];
+	SPMySQLConnection *secondConnection = [pool checkoutIdleConnection];
+
+	XCTAssertNotNil(firstConnection);
+	XCTAssertNotNil(secondConnection);
+	XCTAssertNotEqual(firstConnection, secondConnection);
+	XCTAssertNil([pool checkoutIdleConnection]);
+
+	[pool checkinConnection:(SPMySQLConnection *)parentConnection];
+
+	XCTAssertNil([pool checkoutIdleConnection]);
+
+	[pool checkinConnection:secondConnection];
+
+	XCTAssertEqual([pool checkoutConnection], secondConnection);
+
+	[pool checkinConnection:firstConnection];
+	[pool checkinConnection:secondConnection];
+}
+
+/**
+ * Closing the pool commits each snapshot transaction before disconnecting, and wakes any thread
+ * waiting for a connection.
+ */
+- (void)testCloseEndsSnapshotsAndWakesWaiters
+{
+	XCTAssertTrue([pool openConnections:2]);
+
+	SPMySQLConnection *firstConnection = [pool checkoutConnection];
+	SPMySQLConnection *secondConnection = [pool checkoutConnection];
+
+	__block SPMySQLConnection *waitingConnection = firstConnection;
+	dispatch_semaphore_t checkoutFinished = dispatch_semaphore_create(0);
+
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		waitingConnection = [pool checkoutConnection];
+		dispatch_semaphore_signal(checkoutFinished);
+	});
+
+	[pool close];
+
+	XCTAssertEqual(dispatch_semaphore_wait(checkoutFinished, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0L);
+	dispatch_release(checkoutFinished);
+
+	XCTAssertNil(waitingConnection);
+	XCTAssertEqual([pool connectionCount], (NSUInteger)0);
+
+	// Connections checked in after closing are not reused
+	[pool checkinConnection:firstConnection];
+	[pool checkinConnection:secondConnection];
+
+	XCTAssertNil([pool checkoutIdleConnection]);
+
+	NSArray *expectedQueries = @[@"1: COMMIT", @"1: DISCONNECT", @"2: COMMIT", @"2: DISCONNECT"];
+	NSPredicate *closeQueries = [NSPredicate predicateWithFormat:@"SELF ENDSWITH 'COMMIT' OR SELF ENDSWITH 'DISCONNECT'"];
+
+	XCTAssertEqualObjects([[server queryLog] filteredArrayUsingPredicate:closeQueries], expectedQueries);
+}
+
+@end
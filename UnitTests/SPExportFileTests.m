@@ -0,0 +1,278 @@
+//
+//  SPExportFileTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportFile.h"
+#import "SPFileHandle.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPExportFile (SPExportFileTests)
+
+- (NSString *)_pathForPart:(NSUInteger)partNumber;
+
+@end
+
+@interface SPExportFileTests : XCTestCase
+{
+	NSString *exportDirectory;
+}
+
+- (SPExportFile *)_exportFileNamed:(NSString *)name;
+- (void)_writeString:(NSString *)string toExportFile:(SPExportFile *)exportFile;
+- (NSString *)_contentsOfFileAtPath:(NSString *)path;
+
+@end
+
+@implementation SPExportFileTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	exportDirectory = [[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPExportFileTests-%@", [[NSProcessInfo processInfo] globallyUniqueString]]] retain];
+
+	XCTAssertTrue([[NSFileManager defaultManager] createDirectoryAtPath:exportDirectory withIntermediateDirectories:YES attributes:nil error:NULL]);
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:exportDirectory error:NULL];
+
+	[exportDirectory release], exportDirectory = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns an export file of the supplied name in the test directory.
+ */
+- (SPExportFile *)_exportFileNamed:(NSString *)name
+{
+	return [SPExportFile exportFileAtPath:[exportDirectory stringByAppendingPathComponent:name]];
+}
+
+/**
+ * Writes the supplied string to the export file as UTF-8.
+ */
+- (void)_writeString:(NSString *)string toExportFile:(SPExportFile *)exportFile
+{
+	[exportFile writeData:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+/**
+ * Returns the contents of the supplied file as a UTF-8 string.
+ */
+- (NSString *)_contentsOfFileAtPath:(NSString *)path
+{
+	return [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+}
+
+/**
+ * Further parts insert their number before the file's extensions, keeping a compression extension
+ * together with the extension of the compressed format.
+ */
+- (void)testPartPaths
+{
+	SPExportFile *sqlFile = [self _exportFileNamed:@"dump.sql"];
+
+	XCTAssertEqualObjects([sqlFile _pathForPart:1], [exportDirectory stringByAppendingPathComponent:@"dump.sql"]);
+	XCTAssertEqualObjects([sqlFile _pathForPart:2], [exportDirectory stringByAppendingPathComponent:@"dump-part0002.sql"]);
+	XCTAssertEqualObjects([sqlFile _pathForPart:12], [exportDirectory stringByAppendingPathComponent:@"dump-part0012.sql"]);
+
+	XCTAssertEqualObjects([[[self _exportFileNamed:@"dump.sql.gz"] _pathForPart:2] lastPathComponent], @"dump-part0002.sql.gz");
+	XCTAssertEqualObjects([[[self _exportFileNamed:@"dump.csv.BZ2"] _pathForPart:3] lastPathComponent], @"dump-part0003.csv.BZ2");
+	XCTAssertEqualObjects([[[self _exportFileNamed:@"dump.gz"] _pathForPart:2] lastPathComponent], @"dump-part0002.gz");
+	XCTAssertEqualObjects([[[self _exportFileNamed:@"dump.2026.sql"] _pathForPart:2] lastPathComponent], @"dump.2026-part0002.sql");
+	XCTAssertEqualObjects([[[self _exportFileNamed:@"dump"] _pathForPart:2] lastPathComponent], @"dump-part0002");
+}
+
+/**
+ * Output only rolls over once the current part reaches the split length, and each part holds the
+ * data written while it was current.
+ */
+- (void)testSizeRollover
+{
+	SPExportFile *exportFile = [self _exportFileNamed:@"dump.sql"];
+
+	[exportFile setExportFileSplitLength:10];
+
+	XCTAssertEqual([exportFile createExportFileHandle:NO], SPExportFileHandleCreated);
+	XCTAssertTrue([exportFile isSplit]);
+
+	[self _writeString:@"12345" toExportFile:exportFile];
+
+	XCTAssertFalse([exportFile needsNewPart]);
+
+	[self _writeString:@"67890" toExportFile:exportFile];
+
+	XCTAssertTrue([exportFile needsNewPart]);
+	XCTAssertTrue([exportFile beginNewPart]);
+	XCTAssertFalse([exportFile needsNewPart]);
+
+	[self _writeString:@"abc" toExportFile:exportFile];
+
+	XCTAssertTrue([exportFile close]);
+
+	NSArray *expectedPartPaths = @[
+		[exportDirectory stringByAppendingPathComponent:@"dump.sql"],
+		[exportDirectory stringByAppendingPathComponent:@"dump-part0002.sql"]
+	];
+
+	XCTAssertEqualObjects([exportFile exportFilePartPaths], expectedPartPaths);
+	XCTAssertEqualObjects([self _contentsOfFileAtPath:[expectedPartPaths objectAtIndex:0]], @"1234567890");
+	XCTAssertEqualObjects([self _contentsOfFileAtPath:[expectedPartPaths objectAtIndex:1]], @"abc");
+	XCTAssertEqual([exportFile suppliedDataLength], 13ULL);
+	XCTAssertEqual([exportFile fileLength], 13ULL);
+}
+
+/**
+ * When splitting per table, output rolls over before a table other than the one the current part holds.
+ */
+- (void)testPerTableRollover
+{
+	SPExportFile *exportFile = [self _exportFileNamed:@"dump.sql"];
+
+	[exportFile setExportFileSplitsPerTable:YES];
+
+	XCTAssertEqual([exportFile createExportFileHandle:NO], SPExportFileHandleCreated);
+
+	// The first table starts in the file itself
+	XCTAssertFalse([exportFile needsNewPartForTable:@"items"]);
+
+	[exportFile addTableToCurrentPart:@"items"];
+	[self _writeString:@"items" toExportFile:exportFile];
+
+	XCTAssertFalse([exportFile needsNewPartForTable:@"items"]);
+	XCTAssertFalse([exportFile needsNewPart]);
+	XCTAssertTrue([exportFile needsNewPartForTable:@"orders"]);
+	XCTAssertTrue([exportFile beginNewPart]);
+
+	[exportFile addTableToCurrentPart:@"orders"];
+	[self _writeString:@"orders" toExportFile:exportFile];
+
+	XCTAssertTrue([exportFile close]);
+	XCTAssertEqual([[exportFile exportFilePartPaths] count], (NSUInteger)2);
+	XCTAssertEqualObjects([self _contentsOfFileAtPath:[[exportFile exportFilePartPaths] objectAtIndex:1]], @"orders");
+}
+
+/**
+ * The part index lists each part relative to the index, with the tables it holds and its lengths.
+ */
+- (void)testPartIndex
+{
+	SPExportFile *exportFile = [self _exportFileNamed:@"dump.sql"];
+
+	[exportFile setExportFileSplitLength:4];
+
+	XCTAssertEqual([exportFile createExportFileHandle:NO], SPExportFileHandleCreated);
+
+	[exportFile addTableToCurrentPart:@"items"];
+	[self _writeString:@"items" toExportFile:exportFile];
+
+	XCTAssertTrue([exportFile beginNewPart]);
+
+	// A table continued in a new part is listed in both parts
+	[exportFile addTableToCurrentPart:@"items"];
+	[self _writeString:@"more" toExportFile:exportFile];
+	[exportFile addTableToCurrentPart:@"orders"];
+	[self _writeString:@"orders" toExportFile:exportFile];
+
+	XCTAssertTrue([exportFile close]);
+	XCTAssertTrue([exportFile writePartIndex]);
+	XCTAssertEqualObjects([exportFile partIndexPath], [exportDirectory stringByAppendingPathComponent:@"dump.sql.parts.json"]);
+
+	NSDictionary *index = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:[exportFile partIndexPath]] options:0 error:NULL];
+
+	NSDictionary *expectedIndex = @{
+		@"splitLength"    : @4,
+		@"splitsPerTable" : @NO,
+		@"parts"          : @[
+			@{@"path" : @"dump.sql", @"tables" : @[@"items"], @"uncompressedBytes" : @5, @"compressedBytes" : @5},
+			@{@"path" : @"dump-part0002.sql", @"tables" : @[@"items", @"orders"], @"uncompressedBytes" : @10, @"compressedBytes" : @10}
+		]
+	};
+
+	XCTAssertEqualObjects(index, expectedIndex);
+}
+
+/**
+ * A file which isn't split has no part index.
+ */
+- (void)testUnsplitFileHasNoPartIndex
+{
+	SPExportFile *exportFile = [self _exportFileNamed:@"dump.sql"];
+
+	XCTAssertEqual([exportFile createExportFileHandle:NO], SPExportFileHandleCreated);
+
+	[exportFile addTableToCurrentPart:@"items"];
+	[self _writeString:@"items" toExportFile:exportFile];
+
+	XCTAssertTrue([exportFile close]);
+	XCTAssertFalse([exportFile writePartIndex]);
+	XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[exportFile partIndexPath]]);
+	XCTAssertEqualObjects([exportFile exportFilePartPaths], @[[exportFile exportFilePath]]);
+}
+
+/**
+ * Parts left by an earlier split export to the same path are found, block the file from being
+ * created unless overwriting, and are removed when it is.
+ */
+- (void)testExistingParts
+{
+	NSString *earlierPartPath = [exportDirectory stringByAppendingPathComponent:@"dump-part0002.sql.gz"];
+	NSString *earlierIndexPath = [exportDirectory stringByAppendingPathComponent:@"dump.sql.gz.parts.json"];
+	NSString *unrelatedPath = [exportDirectory stringByAppendingPathComponent:@"dump-partial.sql.gz"];
+
+	for (NSString *path in @[earlierPartPath, earlierIndexPath, unrelatedPath])
+	{
+		XCTAssertTrue([[NSData data] writeToFile:path atomically:NO]);
+	}
+
+	SPExportFile *exportFile = [self _exportFileNamed:@"dump.sql.gz"];
+
+	[exportFile setExportFileSplitLength:1024];
+
+	NSArray *expectedPaths = @[earlierPartPath, earlierIndexPath];
+
+	XCTAssertEqualObjects([exportFile existingPartPaths], expectedPaths);
+	XCTAssertEqual([exportFile createExportFileHandle:NO], SPExportFileHandleExists);
+	XCTAssertEqual([exportFile createExportFileHandle:YES], SPExportFileHandleCreated);
+	XCTAssertEqualObjects([exportFile existingPartPaths], @[]);
+	XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:unrelatedPath]);
+
+	// A part which appears after the check is never overwritten
+	XCTAssertTrue([[NSData data] writeToFile:earlierPartPath atomically:NO]);
+	XCTAssertFalse([exportFile beginNewPart]);
+	XCTAssertEqual([[exportFile exportFilePartPaths] count], (NSUInteger)1);
+
+	XCTAssertTrue([exportFile close]);
+}
+
+@end
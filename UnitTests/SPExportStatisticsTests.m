@@ -0,0 +1,417 @@
+//
+//  SPExportStatisticsTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportStatistics.h"
+#import "SPExporter.h"
+#import "SPExportFile.h"
+#import "SPFileHandle.h"
+
+#import <XCTest/XCTest.h>
+
+// The time returned by the statistics' clock
+static NSTimeInterval SPExportStatisticsTestTime = 0;
+
+/**
+ * Statistics measured against SPExportStatisticsTestTime rather than the system clock.
+ */
+@interface SPExportStatisticsTestStatistics : SPExportStatistics
+@end
+
+@implementation SPExportStatisticsTestStatistics
+
+- (NSTimeInterval)_currentTime
+{
+	return SPExportStatisticsTestTime;
+}
+
+@end
+
+/**
+ * Stands in for an exporter with the supplied row count, server wait time and table statistics.
+ */
+@interface SPExportStatisticsTestExporter : NSObject
+{
+	unsigned long long rowCount;
+	double serverWaitTime;
+	NSArray *tableStatistics;
+}
+
+@property (readwrite, assign) unsigned long long rowCount;
+@property (readwrite, assign) double serverWaitTime;
+@property (readwrite, retain) NSArray *tableStatistics;
+
+@end
+
+@implementation SPExportStatisticsTestExporter
+
+@synthesize rowCount;
+@synthesize serverWaitTime;
+@synthesize tableStatistics;
+
+- (unsigned long long)exportRowCount
+{
+	return rowCount;
+}
+
+- (double)exportServerWaitTime
+{
+	return serverWaitTime;
+}
+
+- (NSArray *)exportTableStatistics
+{
+	return tableStatistics;
+}
+
+- (void)dealloc
+{
+	[tableStatistics release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for a file handle with the supplied write statistics.
+ */
+@interface SPExportStatisticsTestFileHandle : NSObject
+{
+	double writeBlockedTime;
+	double writerIdleTime;
+	double writerActiveTime;
+	double writeThroughput;
+}
+
+@property (readwrite, assign) double writeBlockedTime;
+@property (readwrite, assign) double writerIdleTime;
+@property (readwrite, assign) double writerActiveTime;
+@property (readwrite, assign) double writeThroughput;
+
+@end
+
+@implementation SPExportStatisticsTestFileHandle
+
+@synthesize writeBlockedTime;
+@synthesize writerIdleTime;
+@synthesize writerActiveTime;
+@synthesize writeThroughput;
+
+- (SPFileCompressionFormat)compressionFormat
+{
+	return SPGzipCompression;
+}
+
+@end
+
+/**
+ * Stands in for an export file of the supplied lengths, written through a test file handle.
+ */
+@interface SPExportStatisticsTestFile : NSObject
+{
+	unsigned long long suppliedDataLength;
+	unsigned long long fileLength;
+	SPExportStatisticsTestFileHandle *fileHandle;
+}
+
+@property (readwrite, assign) unsigned long long suppliedDataLength;
+@property (readwrite, assign) unsigned long long fileLength;
+@property (readonly) SPExportStatisticsTestFileHandle *fileHandle;
+
+@end
+
+@implementation SPExportStatisticsTestFile
+
+@synthesize suppliedDataLength;
+@synthesize fileLength;
+@synthesize fileHandle;
+
+- (id)init
+{
+	if ((self = [super init])) {
+		fileHandle = [[SPExportStatisticsTestFileHandle alloc] init];
+	}
+
+	return self;
+}
+
+- (SPFileHandle *)exportFileHandle
+{
+	return (SPFileHandle *)fileHandle;
+}
+
+- (NSString *)exportFilePath
+{
+	return @"/tmp/export.sql.gz";
+}
+
+- (NSArray *)exportFilePartPaths
+{
+	return @[@"/tmp/export.sql.gz", @"/tmp/export-part0002.sql.gz"];
+}
+
+- (void)dealloc
+{
+	[fileHandle release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPExportStatisticsTests : XCTestCase
+{
+	SPExportStatisticsTestExporter *exporter;
+	SPExportStatisticsTestFile *file;
+	NSDictionary *estimates;
+}
+
+- (SPExportStatistics *)_statistics;
+- (SPExportStatistics *)_statisticsWithEstimates:(NSDictionary *)tableSizeEstimates;
+- (NSDictionary *)_tableNamed:(NSString *)name rowCount:(NSUInteger)rows complete:(BOOL)complete;
+
+@end
+
+@implementation SPExportStatisticsTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	SPExportStatisticsTestTime = 1000;
+
+	exporter = [[SPExportStatisticsTestExporter alloc] init];
+	file = [[SPExportStatisticsTestFile alloc] init];
+
+	// Two tables of 1000 bytes and 100 rows each
+	NSDictionary *estimate = @{SPExportStatisticsEstimatedDataLengthKey : @1000, SPExportStatisticsEstimatedRowCountKey : @100};
+
+	estimates = [@{@"items" : estimate, @"orders" : estimate} retain];
+}
+
+- (void)tearDown
+{
+	[exporter release], exporter = nil;
+	[file release], file = nil;
+	[estimates release], estimates = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns statistics of the test exporter and file, with the test table size estimates.
+ */
+- (SPExportStatistics *)_statistics
+{
+	return [self _statisticsWithEstimates:estimates];
+}
+
+/**
+ * Returns statistics of the test exporter and file, with the supplied table size estimates.
+ */
+- (SPExportStatistics *)_statisticsWithEstimates:(NSDictionary *)tableSizeEstimates
+{
+	return [[[SPExportStatisticsTestStatistics alloc] initWithExporters:@[exporter] exportFiles:@[file] tableSizeEstimates:tableSizeEstimates] autorelease];
+}
+
+/**
+ * Returns the statistics of a table as kept by an exporter.
+ */
+- (NSDictionary *)_tableNamed:(NSString *)name rowCount:(NSUInteger)rows complete:(BOOL)complete
+{
+	return @{
+		SPExportStatisticsTableNameKey      : name,
+		SPExportStatisticsRowCountKey       : @(rows),
+		SPExportStatisticsElapsedTimeKey    : @4,
+		SPExportStatisticsServerWaitTimeKey : @1,
+		SPExportStatisticsCompleteKey       : @(complete)
+	};
+}
+
+/**
+ * Completed tables count their whole data length, and tables being read the proportion of rows read.
+ */
+- (void)testEstimatedTimeRemainingWeighsTablesByDataLength
+{
+	SPExportStatistics *statistics = [self _statistics];
+
+	[exporter setTableStatistics:@[[self _tableNamed:@"items" rowCount:100 complete:YES], [self _tableNamed:@"orders" rowCount:50 complete:NO]]];
+
+	SPExportStatisticsTestTime += 15;
+
+	// 1500 of 2000 bytes read in 15s leaves 500 bytes, or 5s
+	XCTAssertEqualWithAccuracy([statistics estimatedTimeRemaining], 5.0, 0.0001);
+}
+
+/**
+ * Tables being read count no more than 95% of their data length until complete, as the server's row
+ * estimates may be low.
+ */
+- (void)testEstimatedTimeRemainingCapsIncompleteTables
+{
+	SPExportStatistics *statistics = [self _statistics];
+
+	[exporter setTableStatistics:@[[self _tableNamed:@"items" rowCount:100 complete:YES], [self _tableNamed:@"orders" rowCount:250 complete:NO]]];
+
+	SPExportStatisticsTestTime += 39;
+
+	// 1950 of 2000 bytes read in 39s leaves 50 bytes, or 1s
+	XCTAssertEqualWithAccuracy([statistics estimatedTimeRemaining], 1.0, 0.0001);
+
+	[exporter setTableStatistics:@[[self _tableNamed:@"items" rowCount:100 complete:YES], [self _tableNamed:@"orders" rowCount:250 complete:YES]]];
+
+	XCTAssertEqualWithAccuracy([statistics estimatedTimeRemaining], 0.0, 0.0001);
+}
+
+/**
+ * The time remaining isn't estimated without table sizes, before any data has been read, or too early
+ * in the export.
+ */
+- (void)testEstimatedTimeRemainingUnavailable
+{
+	SPExportStatistics *statistics = [self _statistics];
+
+	SPExportStatisticsTestTime += 10;
+
+	[exporter setTableStatistics:@[[self _tableNamed:@"items" rowCount:0 complete:NO]]];
+
+	XCTAssertEqual([statistics estimatedTimeRemaining], -1.0);
+
+	[exporter setTableStatistics:@[[self _tableNamed:@"items" rowCount:100 complete:YES]]];
+
+	XCTAssertEqual([[self _statisticsWithEstimates:nil] estimatedTimeRemaining], -1.0);
+	XCTAssertEqual([[self _statistics] estimatedTimeRemaining], -1.0);
+	XCTAssertEqualWithAccuracy([statistics estimatedTimeRemaining], 10.0, 0.0001);
+}
+
+/**
+ * Sampling measures the rates from the progress made since the previous sample.
+ */
+- (void)testSampleRates
+{
+	SPExportStatistics *statistics = [self _statisticsWithEstimates:nil];
+
+	[exporter setRowCount:500];
+	SPExportStatisticsTestTime += 5;
+	[statistics sample];
+
+	XCTAssertTrue([[statistics progressDescription] hasPrefix:@"100 rows/s, "]);
+
+	[exporter setRowCount:1100];
+	SPExportStatisticsTestTime += 2;
+	[statistics sample];
+
+	XCTAssertTrue([[statistics progressDescription] hasPrefix:@"300 rows/s, "]);
+
+	// Sampling again at the same time leaves the rates unchanged
+	[statistics sample];
+
+	XCTAssertTrue([[statistics progressDescription] hasPrefix:@"300 rows/s, "]);
+}
+
+/**
+ * The report's rates are measured over the whole export, and stop when it ends.
+ */
+- (void)testReportRates
+{
+	SPExportStatistics *statistics = [self _statisticsWithEstimates:nil];
+
+	[exporter setRowCount:2000];
+	[file setSuppliedDataLength:40000];
+	[file setFileLength:10000];
+
+	SPExportStatisticsTestTime += 4;
+	[statistics exportDidEnd];
+	SPExportStatisticsTestTime += 100;
+
+	NSDictionary *report = [statistics report];
+
+	XCTAssertEqualWithAccuracy([statistics elapsedTime], 4.0, 0.0001);
+	XCTAssertEqualWithAccuracy([[report objectForKey:@"rowsPerSecond"] doubleValue], 500.0, 0.0001);
+	XCTAssertEqualWithAccuracy([[report objectForKey:@"uncompressedBytesPerSecond"] doubleValue], 10000.0, 0.0001);
+	XCTAssertEqualWithAccuracy([[report objectForKey:@"compressedBytesPerSecond"] doubleValue], 2500.0, 0.0001);
+	XCTAssertEqualWithAccuracy([[report objectForKey:@"compressionRatio"] doubleValue], 4.0, 0.0001);
+
+	NSDictionary *fileReport = [[report objectForKey:@"files"] objectAtIndex:0];
+
+	XCTAssertEqualObjects([fileReport objectForKey:@"compressionFormat"], @"gzip");
+	XCTAssertEqualObjects([fileReport objectForKey:@"parts"], @2);
+}
+
+/**
+ * The serializers' wait is the time the writers were idle which wasn't spent waiting for the server.
+ */
+- (void)testWaitTimes
+{
+	SPExportStatistics *statistics = [self _statisticsWithEstimates:nil];
+
+	[exporter setServerWaitTime:3];
+	[[file fileHandle] setWriterIdleTime:5];
+	[[file fileHandle] setWriteBlockedTime:2];
+
+	XCTAssertEqualWithAccuracy([statistics serverWaitTime], 3.0, 0.0001);
+	XCTAssertEqualWithAccuracy([statistics serializerWaitTime], 2.0, 0.0001);
+	XCTAssertEqualWithAccuracy([statistics diskWaitTime], 2.0, 0.0001);
+
+	[exporter setServerWaitTime:8];
+
+	XCTAssertEqual([statistics serializerWaitTime], 0.0);
+}
+
+/**
+ * The report is written as JSON, with values JSON can't represent reported as 0.
+ */
+- (void)testWriteReportToFile
+{
+	SPExportStatistics *statistics = [self _statistics];
+	NSString *reportPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPExportStatisticsTests-%@.json", [[NSProcessInfo processInfo] globallyUniqueString]]];
+
+	[exporter setTableStatistics:@[[self _tableNamed:@"items" rowCount:100 complete:YES]]];
+	[[file fileHandle] setWriteThroughput:INFINITY];
+	[[file fileHandle] setWriterActiveTime:NAN];
+
+	XCTAssertTrue([statistics writeReportToFile:reportPath]);
+
+	NSDictionary *report = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:reportPath] options:0 error:NULL];
+
+	[[NSFileManager defaultManager] removeItemAtPath:reportPath error:NULL];
+
+	NSDictionary *tableReport = [[report objectForKey:@"tables"] objectAtIndex:0];
+	NSDictionary *fileReport = [[report objectForKey:@"files"] objectAtIndex:0];
+
+	XCTAssertEqualObjects([tableReport objectForKey:@"rowsPerSecond"], @25);
+	XCTAssertEqualObjects([tableReport objectForKey:SPExportStatisticsEstimatedDataLengthKey], @1000);
+	XCTAssertEqualObjects([tableReport objectForKey:@"exporter"], @"SPExportStatisticsTestExporter");
+	XCTAssertEqualObjects([fileReport objectForKey:@"writeThroughput"], @0);
+	XCTAssertEqualObjects([fileReport objectForKey:@"writerActiveSeconds"], @0);
+	XCTAssertEqualObjects([report objectForKey:@"rowsPerSecond"], @0);
+}
+
+@end
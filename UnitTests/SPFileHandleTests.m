@@ -0,0 +1,189 @@
+//
+//  SPFileHandleTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPFileHandle.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPFileHandleTests : XCTestCase
+{
+	NSString *filePath;
+}
+
+- (NSData *)_sampleDataOfLength:(NSUInteger)length seed:(unsigned int)seed;
+- (unsigned long long)_fileLength;
+- (void)_testResumeWithCompressionFormat:(SPFileCompressionFormat)format;
+
+@end
+
+@implementation SPFileHandleTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	filePath = [[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPFileHandleTests-%@", [[NSProcessInfo processInfo] globallyUniqueString]]] retain];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:filePath error:NULL];
+
+	[filePath release], filePath = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns repetitive but varied text, so it compresses well.
+ */
+- (NSData *)_sampleDataOfLength:(NSUInteger)length seed:(unsigned int)seed
+{
+	NSMutableData *data = [NSMutableData dataWithCapacity:length + 64];
+
+	while ([data length] < length)
+	{
+		seed = seed * 1103515245 + 12345;
+
+		NSString *line = [NSString stringWithFormat:@"INSERT INTO `table` VALUES (%lu,'value %u');\n", (unsigned long)[data length], (seed >> 16) % 1000];
+
+		[data appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+	}
+
+	[data setLength:length];
+
+	return data;
+}
+
+/**
+ * Returns the length of the file on disk.
+ */
+- (unsigned long long)_fileLength
+{
+	return [[[NSFileManager defaultManager] attributesOfItemAtPath:filePath error:NULL] fileSize];
+}
+
+/**
+ * Writes a file in the supplied format and checkpoints it, writes more data which is lost as if
+ * the export had been interrupted, then resumes the file from the checkpoint; the file must then
+ * read as the data written before the checkpoint followed by the data written after resuming.
+ */
+- (void)_testResumeWithCompressionFormat:(SPFileCompressionFormat)format
+{
+	NSData *checkpointedData = [self _sampleDataOfLength:600000 seed:1];
+	NSData *lostData = [self _sampleDataOfLength:200000 seed:2];
+	NSData *resumedData = [self _sampleDataOfLength:400000 seed:3];
+
+	SPFileHandle *fileHandle = [SPFileHandle fileHandleForWritingAtPath:filePath];
+
+	[fileHandle setCompressionFormat:format];
+	[fileHandle writeData:checkpointedData];
+
+	unsigned long long checkpointLength = [fileHandle checkpoint];
+
+	// The checkpoint ends with the completed stream, not the start of the next one
+	XCTAssertGreaterThan(checkpointLength, 0ULL);
+	XCTAssertEqual(checkpointLength, [self _fileLength]);
+
+	// Checkpointing again without writing leaves the file unchanged
+	XCTAssertEqual([fileHandle checkpoint], checkpointLength);
+	XCTAssertEqual([self _fileLength], checkpointLength);
+
+	[fileHandle writeData:lostData];
+
+	XCTAssertTrue([fileHandle closeFile]);
+	XCTAssertGreaterThan([self _fileLength], checkpointLength);
+
+	fileHandle = [SPFileHandle fileHandleForAppendingAtPath:filePath truncatingToLength:checkpointLength];
+
+	XCTAssertNotNil(fileHandle);
+
+	[fileHandle setCompressionFormat:format];
+	[fileHandle writeData:resumedData];
+
+	XCTAssertTrue([fileHandle closeFile]);
+
+	NSMutableData *expectedData = [NSMutableData dataWithData:checkpointedData];
+
+	[expectedData appendData:resumedData];
+
+	fileHandle = [SPFileHandle fileHandleForReadingAtPath:filePath];
+
+	XCTAssertEqual([fileHandle compressionFormat], format);
+	XCTAssertEqualObjects([fileHandle readDataToEndOfFile], expectedData);
+
+	[fileHandle closeFile];
+}
+
+/**
+ * An uncompressed file resumes directly after the checkpointed data.
+ */
+- (void)testResumeUncompressed
+{
+	[self _testResumeWithCompressionFormat:SPNoCompression];
+}
+
+/**
+ * A gzip file resumes with a new member after the checkpointed member.
+ */
+- (void)testResumeGzip
+{
+	[self _testResumeWithCompressionFormat:SPGzipCompression];
+}
+
+/**
+ * A bzip2 file resumes with a new stream after the checkpointed streams.
+ */
+- (void)testResumeBzip2
+{
+	[self _testResumeWithCompressionFormat:SPBzip2Compression];
+}
+
+/**
+ * A compressed file with no data written still holds a valid, empty, stream.
+ */
+- (void)testEmptyCompressedFile
+{
+	SPFileHandle *fileHandle = [SPFileHandle fileHandleForWritingAtPath:filePath];
+
+	[fileHandle setCompressionFormat:SPGzipCompression];
+
+	XCTAssertTrue([fileHandle closeFile]);
+	XCTAssertGreaterThan([self _fileLength], 0ULL);
+
+	fileHandle = [SPFileHandle fileHandleForReadingAtPath:filePath];
+
+	XCTAssertEqual([fileHandle compressionFormat], SPGzipCompression);
+	XCTAssertEqual([[fileHandle readDataToEndOfFile] length], (NSUInteger)0);
+
+	[fileHandle closeFile];
+}
+
+@end
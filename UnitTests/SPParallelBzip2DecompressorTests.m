@@ -0,0 +1,300 @@
+//
+//  SPParallelBzip2DecompressorTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParallelBzip2Decompressor.h"
+
+#import <XCTest/XCTest.h>
+#include <bzlib.h>
+
+// Block and end of stream markers: the BCD digits of pi and of sqrt(pi)
+static const uint64_t SPParallelBzip2DecompressorTestBlockMagic = 0x314159265359ULL;
+static const uint64_t SPParallelBzip2DecompressorTestEndOfStreamMagic = 0x177245385090ULL;
+
+@interface SPParallelBzip2DecompressorTests : XCTestCase
+
+- (NSData *)_sampleDataOfLength:(NSUInteger)length;
+- (NSData *)_dataOfLength:(NSUInteger)length reproducingMarker:(uint64_t)marker;
+- (NSData *)_bzip2Data:(NSData *)data;
+- (NSData *)_decompressData:(NSData *)bzip2Data failed:(BOOL *)failed;
+- (NSUInteger)_countOfMarker:(uint64_t)marker inData:(NSData *)data;
+
+@end
+
+@implementation SPParallelBzip2DecompressorTests
+
+/**
+ * Returns repetitive but varied text, compressing to a block per 100k with the smallest block size.
+ */
+- (NSData *)_sampleDataOfLength:(NSUInteger)length
+{
+	NSMutableData *data = [NSMutableData dataWithCapacity:length + 64];
+	unsigned int seed = 12345;
+
+	while ([data length] < length)
+	{
+		seed = seed * 1103515245 + 12345;
+
+		NSString *line = [NSString stringWithFormat:@"INSERT INTO `table` VALUES (%lu,'value %u');\n", (unsigned long)[data length], (seed >> 16) % 1000];
+
+		[data appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+	}
+
+	[data setLength:length];
+
+	return data;
+}
+
+/**
+ * Returns data whose compressed blocks each contain the supplied marker by chance.
+ *
+ * Each block records which byte values it uses as a bitmap, sixteen bits per group of sixteen
+ * values, directly after the block header.  Using exactly the byte values set in the marker's
+ * three 16 bit words, from the first three groups, writes the marker into every block.  No byte
+ * is repeated, as runs of four bytes would be encoded with a length byte outside the set.
+ */
+- (NSData *)_dataOfLength:(NSUInteger)length reproducingMarker:(uint64_t)marker
+{
+	unsigned char values[48];
+	NSUInteger valueCount = 0;
+
+	for (NSUInteger bit = 0; bit < 48; bit++)
+	{
+		if ((marker >> (47 - bit)) & 1) values[valueCount++] = (unsigned char)bit;
+	}
+
+	NSMutableData *data = [NSMutableData dataWithLength:length];
+	unsigned char *bytes = [data mutableBytes];
+	unsigned int seed = 12345;
+	NSUInteger i = 0;
+
+	while (i < length)
+	{
+		seed = seed * 1103515245 + 12345;
+
+		unsigned char value = values[(seed >> 16) % valueCount];
+
+		if (i && bytes[i - 1] == value) continue;
+
+		bytes[i++] = value;
+	}
+
+	return data;
+}
+
+/**
+ * Compresses the supplied data into a single bzip2 stream with the smallest block size, so
+ * even small data spans several blocks.
+ */
+- (NSData *)_bzip2Data:(NSData *)data
+{
+	unsigned int compressedLength = (unsigned int)([data length] + [data length] / 100 + 600);
+	NSMutableData *compressedData = [NSMutableData dataWithLength:compressedLength];
+
+	int status = BZ2_bzBuffToBuffCompress([compressedData mutableBytes], &compressedLength, (char *)[data bytes], (unsigned int)[data length], 1, 0, 0);
+
+	XCTAssertEqual(status, BZ_OK);
+
+	[compressedData setLength:compressedLength];
+
+	return compressedData;
+}
+
+/**
+ * Decompresses the supplied data from a temporary file, reading it in chunks not aligned to
+ * the blocks, and returns the data read.
+ */
+- (NSData *)_decompressData:(NSData *)bzip2Data failed:(BOOL *)failed
+{
+	FILE *file = tmpfile();
+
+	fwrite([bzip2Data bytes], 1, [bzip2Data length], file);
+	rewind(file);
+
+	SPParallelBzip2Decompressor *decompressor = [[SPParallelBzip2Decompressor alloc] initWithFile:file];
+	NSMutableData *outputData = [NSMutableData data];
+	unsigned char buffer[65521];
+	NSUInteger readLength;
+
+	while ((readLength = [decompressor readBytes:buffer length:sizeof(buffer)]))
+	{
+		[outputData appendBytes:buffer length:readLength];
+	}
+
+	*failed = [decompressor decompressionFailed];
+
+	[decompressor release];
+
+	fclose(file);
+
+	return outputData;
+}
+
+/**
+ * Returns the number of times the supplied marker occurs in the data, at any bit offset.
+ */
+- (NSUInteger)_countOfMarker:(uint64_t)marker inData:(NSData *)data
+{
+	const unsigned char *bytes = [data bytes];
+	uint64_t window = 0;
+	NSUInteger count = 0;
+
+	for (NSUInteger i = 0; i < [data length]; i++)
+	{
+		for (int bit = 7; bit >= 0; bit--)
+		{
+			window = ((window << 1) | ((bytes[i] >> bit) & 1)) & 0xFFFFFFFFFFFFULL;
+
+			if (window == marker && ((uint64_t)i << 3) + 8 - bit >= 48) count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * An end of stream marker occurring by chance within a block doesn't end the data, and the
+ * blocks split at it are decompressed once joined.
+ */
+- (void)testFalseEndOfStreamMarkers
+{
+	NSData *data = [self _dataOfLength:250000 reproducingMarker:SPParallelBzip2DecompressorTestEndOfStreamMagic];
+	NSData *bzip2Data = [self _bzip2Data:data];
+	BOOL failed = YES;
+
+	// Each of the three blocks holds a false marker, besides the real one ending the stream
+	XCTAssertEqual([self _countOfMarker:SPParallelBzip2DecompressorTestEndOfStreamMagic inData:bzip2Data], (NSUInteger)4);
+
+	XCTAssertEqualObjects([self _decompressData:bzip2Data failed:&failed], data);
+	XCTAssertFalse(failed);
+}
+
+/**
+ * A block marker occurring by chance within a block splits it, and the parts are decompressed
+ * once joined.
+ */
+- (void)testFalseBlockMarkers
+{
+	NSData *data = [self _dataOfLength:250000 reproducingMarker:SPParallelBzip2DecompressorTestBlockMagic];
+	NSData *bzip2Data = [self _bzip2Data:data];
+	BOOL failed = YES;
+
+	XCTAssertEqual([self _countOfMarker:SPParallelBzip2DecompressorTestBlockMagic inData:bzip2Data], (NSUInteger)6);
+
+	XCTAssertEqualObjects([self _decompressData:bzip2Data failed:&failed], data);
+	XCTAssertFalse(failed);
+}
+
+/**
+ * Concatenated streams, as written by SPParallelBzip2Compressor, are read as a single stream,
+ * including when a false end of stream marker precedes the next stream.
+ */
+- (void)testConcatenatedStreams
+{
+	NSData *firstData = [self _dataOfLength:150000 reproducingMarker:SPParallelBzip2DecompressorTestEndOfStreamMagic];
+	NSData *secondData = [self _sampleDataOfLength:350000];
+	NSMutableData *bzip2Data = [NSMutableData dataWithData:[self _bzip2Data:firstData]];
+	NSMutableData *data = [NSMutableData dataWithData:firstData];
+	BOOL failed = YES;
+
+	[bzip2Data appendData:[self _bzip2Data:secondData]];
+	[data appendData:secondData];
+
+	XCTAssertEqualObjects([self _decompressData:bzip2Data failed:&failed], data);
+	XCTAssertFalse(failed);
+}
+
+/**
+ * As with bzip2, data after the last stream is ignored rather than reported as corrupt.
+ */
+- (void)testTrailingDataIgnored
+{
+	NSData *data = [self _sampleDataOfLength:250000];
+	NSMutableData *bzip2Data = [NSMutableData dataWithData:[self _bzip2Data:data]];
+	BOOL failed = YES;
+
+	[bzip2Data appendData:[@"trailing data which is not bzip2" dataUsingEncoding:NSUTF8StringEncoding]];
+
+	XCTAssertEqualObjects([self _decompressData:bzip2Data failed:&failed], data);
+	XCTAssertFalse(failed);
+}
+
+/**
+ * A corrupt block stops reading after the blocks before it, and is reported.
+ */
+- (void)testCorruptBlockFails
+{
+	NSData *data = [self _sampleDataOfLength:250000];
+	NSMutableData *bzip2Data = [NSMutableData dataWithData:[self _bzip2Data:data]];
+	BOOL failed = NO;
+
+	// Damage the last of the three blocks
+	NSUInteger corruptOffset = [bzip2Data length] - [bzip2Data length] / 8;
+
+	((unsigned char *)[bzip2Data mutableBytes])[corruptOffset] ^= 0x55;
+
+	NSData *outputData = [self _decompressData:bzip2Data failed:&failed];
+
+	XCTAssertTrue(failed);
+	XCTAssertGreaterThan([outputData length], (NSUInteger)0);
+	XCTAssertLessThan([outputData length], [data length]);
+	XCTAssertEqualObjects(outputData, [data subdataWithRange:NSMakeRange(0, [outputData length])]);
+}
+
+/**
+ * A stream cut short is reported rather than read as if complete.
+ */
+- (void)testTruncatedStreamFails
+{
+	NSData *data = [self _sampleDataOfLength:250000];
+	NSMutableData *bzip2Data = [NSMutableData dataWithData:[self _bzip2Data:data]];
+	BOOL failed = NO;
+
+	[bzip2Data setLength:[bzip2Data length] - 100];
+
+	NSData *outputData = [self _decompressData:bzip2Data failed:&failed];
+
+	XCTAssertTrue(failed);
+	XCTAssertLessThan([outputData length], [data length]);
+}
+
+/**
+ * Data which isn't bzip2 at all is reported.
+ */
+- (void)testMissingStreamHeaderFails
+{
+	BOOL failed = NO;
+
+	NSData *outputData = [self _decompressData:[@"not bzip2 data" dataUsingEncoding:NSUTF8StringEncoding] failed:&failed];
+
+	XCTAssertTrue(failed);
+	XCTAssertEqual([outputData length], (NSUInteger)0);
+}
+
+@end
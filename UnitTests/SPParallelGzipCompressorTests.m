@@ -0,0 +1,244 @@
+//
+//  SPParallelGzipCompressorTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParallelGzipCompressor.h"
+
+#import <XCTest/XCTest.h>
+#include <zlib.h>
+
+// The length of the blocks the compressor deflates independently
+static const NSUInteger SPParallelGzipCompressorTestBlockLength = 128 * 1024;
+
+@interface SPParallelGzipCompressorTests : XCTestCase
+
+- (NSData *)_sampleDataOfLength:(NSUInteger)length;
+- (NSData *)_compressData:(NSData *)data chunkLength:(NSUInteger)chunkLength succeeded:(BOOL *)succeeded;
+- (NSData *)_gunzipData:(NSData *)gzipData;
+
+@end
+
+@implementation SPParallelGzipCompressorTests
+
+/**
+ * Returns repetitive but varied text, so blocks compress well and benefit from the preceding
+ * block as a dictionary.
+ */
+- (NSData *)_sampleDataOfLength:(NSUInteger)length
+{
+	NSMutableData *data = [NSMutableData dataWithCapacity:length + 64];
+	unsigned int seed = 12345;
+
+	while ([data length] < length)
+	{
+		seed = seed * 1103515245 + 12345;
+
+		NSString *line = [NSString stringWithFormat:@"INSERT INTO `table` VALUES (%lu,'value %u');\n", (unsigned long)[data length], (seed >> 16) % 1000];
+
+		[data appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+	}
+
+	[data setLength:length];
+
+	return data;
+}
+
+/**
+ * Compresses the supplied data to a temporary file, passing it to the compressor in chunks of
+ * the supplied length, and returns the contents of the file.
+ */
+- (NSData *)_compressData:(NSData *)data chunkLength:(NSUInteger)chunkLength succeeded:(BOOL *)succeeded
+{
+	FILE *file = tmpfile();
+
+	SPParallelGzipCompressor *compressor = [[SPParallelGzipCompressor alloc] initWithFile:file compressionLevel:6];
+
+	for (NSUInteger offset = 0; offset < [data length]; offset += chunkLength)
+	{
+		[compressor compressBytes:(const char *)[data bytes] + offset length:MIN(chunkLength, [data length] - offset)];
+	}
+
+	*succeeded = [compressor finish];
+
+	XCTAssertEqual([compressor uncompressedLength], (unsigned long long)[data length]);
+
+	unsigned long long compressedLength = [compressor compressedLength];
+
+	[compressor release];
+
+	fflush(file);
+
+	NSMutableData *fileData = [NSMutableData dataWithLength:(NSUInteger)ftello(file)];
+
+	rewind(file);
+	fread([fileData mutableBytes], 1, [fileData length], file);
+	fclose(file);
+
+	XCTAssertEqual(compressedLength, (unsigned long long)[fileData length]);
+
+	return fileData;
+}
+
+/**
+ * Decompresses gzip data - as gunzip does, including any further concatenated members - and
+ * checks each member's trailer, returning nil if the data is invalid.
+ */
+- (NSData *)_gunzipData:(NSData *)gzipData
+{
+	NSMutableData *outputData = [NSMutableData data];
+	unsigned char outputBuffer[16384];
+	z_stream stream;
+
+	memset(&stream, 0, sizeof(stream));
+
+	if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) return nil;
+
+	stream.next_in = (Bytef *)[gzipData bytes];
+	stream.avail_in = (uInt)[gzipData length];
+
+	int status = Z_OK;
+
+	while (stream.avail_in)
+	{
+		stream.next_out = outputBuffer;
+		stream.avail_out = sizeof(outputBuffer);
+
+		status = inflate(&stream, Z_NO_FLUSH);
+
+		if (status != Z_OK && status != Z_STREAM_END) break;
+
+		[outputData appendBytes:outputBuffer length:sizeof(outputBuffer) - stream.avail_out];
+
+		// Continue with the next member, if any
+		if (status == Z_STREAM_END && stream.avail_in) inflateReset(&stream);
+	}
+
+	inflateEnd(&stream);
+
+	return (status == Z_STREAM_END) ? outputData : nil;
+}
+
+/**
+ * Data spanning several blocks, written in chunks not aligned to the blocks, is decompressed
+ * unchanged by a standard gzip decompressor.
+ */
+- (void)testMultiBlockRoundTrip
+{
+	NSData *data = [self _sampleDataOfLength:SPParallelGzipCompressorTestBlockLength * 5 + 1234];
+	BOOL succeeded = NO;
+
+	NSData *gzipData = [self _compressData:data chunkLength:50000 succeeded:&succeeded];
+
+	XCTAssertTrue(succeeded);
+	XCTAssertLessThan([gzipData length], [data length] / 4);
+	XCTAssertEqualObjects([self _gunzipData:gzipData], data);
+}
+
+/**
+ * Data ending exactly on a block boundary leaves no partial block for the final flush.
+ */
+- (void)testBlockAlignedRoundTrip
+{
+	NSData *data = [self _sampleDataOfLength:SPParallelGzipCompressorTestBlockLength * 3];
+	BOOL succeeded = NO;
+
+	NSData *gzipData = [self _compressData:data chunkLength:SPParallelGzipCompressorTestBlockLength succeeded:&succeeded];
+
+	XCTAssertTrue(succeeded);
+	XCTAssertEqualObjects([self _gunzipData:gzipData], data);
+}
+
+/**
+ * The trailer holds the CRC of all the data, combined from the CRCs of the blocks, and the
+ * length of the data.
+ */
+- (void)testTrailerCombinesBlockCRCs
+{
+	NSData *data = [self _sampleDataOfLength:SPParallelGzipCompressorTestBlockLength * 4 + 99];
+	BOOL succeeded = NO;
+
+	NSData *gzipData = [self _compressData:data chunkLength:7919 succeeded:&succeeded];
+
+	XCTAssertTrue(succeeded);
+	XCTAssertGreaterThan([gzipData length], (NSUInteger)18);
+
+	const unsigned char *bytes = [gzipData bytes];
+	const unsigned char *trailer = bytes + [gzipData length] - 8;
+
+	unsigned long trailerCRC = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((unsigned long)trailer[3] << 24);
+	unsigned long trailerLength = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | ((unsigned long)trailer[7] << 24);
+
+	XCTAssertEqual(bytes[0], (unsigned char)0x1f);
+	XCTAssertEqual(bytes[1], (unsigned char)0x8b);
+	XCTAssertEqual(bytes[2], (unsigned char)0x08);
+	XCTAssertEqual(trailerCRC, crc32(crc32(0L, Z_NULL, 0), [data bytes], (uInt)[data length]));
+	XCTAssertEqual(trailerLength, (unsigned long)[data length]);
+}
+
+/**
+ * A stream with no data is still a valid, empty, gzip file.
+ */
+- (void)testEmptyStream
+{
+	BOOL succeeded = NO;
+
+	NSData *gzipData = [self _compressData:[NSData data] chunkLength:1 succeeded:&succeeded];
+
+	XCTAssertTrue(succeeded);
+	XCTAssertEqualObjects([self _gunzipData:gzipData], [NSData data]);
+}
+
+/**
+ * Data which can't be written to the file is reported when the stream is finished.
+ */
+- (void)testWriteFailureReported
+{
+	NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSProcessInfo processInfo] globallyUniqueString]];
+
+	XCTAssertTrue([[NSFileManager defaultManager] createFileAtPath:path contents:[NSData data] attributes:nil]);
+
+	// A file opened only for reading can't be written to
+	FILE *file = fopen([path fileSystemRepresentation], "rb");
+
+	SPParallelGzipCompressor *compressor = [[SPParallelGzipCompressor alloc] initWithFile:file compressionLevel:6];
+	NSData *data = [self _sampleDataOfLength:SPParallelGzipCompressorTestBlockLength * 2];
+
+	[compressor compressBytes:[data bytes] length:[data length]];
+
+	XCTAssertFalse([compressor finish]);
+	XCTAssertTrue([compressor writeFailed]);
+
+	[compressor release];
+
+	fclose(file);
+
+	[[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+@end
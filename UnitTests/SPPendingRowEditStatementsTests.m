@@ -0,0 +1,329 @@
+//
+//  SPPendingRowEditStatementsTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPPendingRowEditStatements.h"
+
+#import <SPMySQL/SPMySQL.h>
+#import <XCTest/XCTest.h>
+
+/**
+ * Stands in for the connection the statements are run on, logging each query.  Queries in the
+ * failing queries dictionary fail with the error message they map to; once a query in the lost
+ * transaction set has run, rolling back to a savepoint fails as the server would after a deadlock.
+ */
+@interface SPPendingRowEditStatementsTestConnection : NSObject
+{
+	NSMutableArray *queryLog;
+	NSMutableDictionary *failingQueries;
+	NSMutableSet *transactionLosingQueries;
+	NSString *lastErrorMessage;
+	BOOL transactionLost;
+}
+
+@property (readonly) NSMutableArray *queryLog;
+@property (readonly) NSMutableDictionary *failingQueries;
+@property (readonly) NSMutableSet *transactionLosingQueries;
+
+@end
+
+@implementation SPPendingRowEditStatementsTestConnection
+
+@synthesize queryLog;
+@synthesize failingQueries;
+@synthesize transactionLosingQueries;
+
+- (id)init
+{
+	if ((self = [super init])) {
+		queryLog = [[NSMutableArray alloc] init];
+		failingQueries = [[NSMutableDictionary alloc] init];
+		transactionLosingQueries = [[NSMutableSet alloc] init];
+		lastErrorMessage = nil;
+		transactionLost = NO;
+	}
+
+	return self;
+}
+
+- (id)queryString:(NSString *)query
+{
+	[queryLog addObject:query];
+
+	[lastErrorMessage release], lastErrorMessage = nil;
+
+	if ([query hasPrefix:@"ROLLBACK TO SAVEPOINT"] && transactionLost) {
+		lastErrorMessage = [@"SAVEPOINT sp_pending_row_statement does not exist" retain];
+	}
+	else if ([failingQueries objectForKey:query]) {
+		lastErrorMessage = [[failingQueries objectForKey:query] retain];
+		if ([transactionLosingQueries containsObject:query]) transactionLost = YES;
+	}
+
+	return nil;
+}
+
+- (BOOL)queryErrored
+{
+	return (lastErrorMessage != nil);
+}
+
+- (NSString *)lastErrorMessage
+{
+	return lastErrorMessage;
+}
+
+- (void)dealloc
+{
+	[queryLog release];
+	[failingQueries release];
+	[transactionLosingQueries release];
+	[lastErrorMessage release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPPendingRowEditStatementsTests : XCTestCase
+{
+	SPPendingRowEditStatementsTestConnection *connection;
+}
+
+- (SPPendingRowEditStatements *)_statementsWithMaxStatementLength:(NSUInteger)maxLength;
+
+@end
+
+@implementation SPPendingRowEditStatementsTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	connection = [[SPPendingRowEditStatementsTestConnection alloc] init];
+}
+
+- (void)tearDown
+{
+	[connection release], connection = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns statements for a table keyed by its id field.
+ */
+- (SPPendingRowEditStatements *)_statementsWithMaxStatementLength:(NSUInteger)maxLength
+{
+	return [[[SPPendingRowEditStatements alloc] initWithTableName:@"fruit" keyFieldNames:@[@"id"] maxStatementLength:maxLength stringEncoding:NSUTF8StringEncoding] autorelease];
+}
+
+/**
+ * New rows with the same fields are combined into one INSERT, while rows with other fields get
+ * their own.
+ */
+- (void)testInsertsGroupedByFields
+{
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:4096];
+
+	[pendingStatements addInsertOfRow:@0 fields:@[@"name"] values:@[@"'apple'"]];
+	[pendingStatements addInsertOfRow:@1 fields:@[@"name", @"colour"] values:@[@"'banana'", @"'yellow'"]];
+	[pendingStatements addInsertOfRow:@2 fields:@[@"name"] values:@[@"'cherry'"]];
+
+	NSArray *statements = [pendingStatements statements];
+
+	XCTAssertEqual([statements count], (NSUInteger)2);
+	XCTAssertEqualObjects([[statements objectAtIndex:0] objectForKey:@"query"], @"INSERT INTO `fruit` (`name`) VALUES ('apple'), ('cherry')");
+	XCTAssertEqualObjects([[statements objectAtIndex:0] objectForKey:@"rows"], (@[@0, @2]));
+	XCTAssertEqualObjects([[statements objectAtIndex:0] objectForKey:@"rowQueries"], (@[@"INSERT INTO `fruit` (`name`) VALUES ('apple')", @"INSERT INTO `fruit` (`name`) VALUES ('cherry')"]));
+	XCTAssertEqualObjects([[statements objectAtIndex:1] objectForKey:@"query"], @"INSERT INTO `fruit` (`name`, `colour`) VALUES ('banana', 'yellow')");
+	XCTAssertTrue([[[statements objectAtIndex:1] objectForKey:@"insert"] boolValue]);
+}
+
+/**
+ * Rows identified by primary key with the same changed fields are combined into a CASE UPDATE;
+ * rows without a primary key, or changing the key, are updated individually and first.
+ */
+- (void)testUpdatesGroupedByPrimaryKey
+{
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:4096];
+
+	[pendingStatements addInsertOfRow:@5 fields:@[@"name"] values:@[@"'damson'"]];
+	[pendingStatements addUpdateOfRow:@0 fields:@[@"name"] values:@[@"'a'"] whereArgument:@"`id` = '1'" usesPrimaryKey:YES];
+	[pendingStatements addUpdateOfRow:@1 fields:@[@"id"] values:@[@"'20'"] whereArgument:@"`id` = '2'" usesPrimaryKey:YES];
+	[pendingStatements addUpdateOfRow:@2 fields:@[@"name"] values:@[@"'c'"] whereArgument:@"`id` = '3'" usesPrimaryKey:YES];
+	[pendingStatements addUpdateOfRow:@3 fields:@[@"name"] values:@[@"'d'"] whereArgument:@"`name` = 'x'" usesPrimaryKey:NO];
+
+	NSArray *statements = [pendingStatements statements];
+
+	XCTAssertEqualObjects([statements valueForKey:@"query"], (@[
+		@"UPDATE `fruit` SET `id` = '20' WHERE `id` = '2'",
+		@"UPDATE `fruit` SET `name` = 'd' WHERE `name` = 'x' LIMIT 1",
+		@"UPDATE `fruit` SET `name` = CASE WHEN (`id` = '1') THEN 'a' WHEN (`id` = '3') THEN 'c' ELSE `name` END WHERE (`id` = '1') OR (`id` = '3')",
+		@"INSERT INTO `fruit` (`name`) VALUES ('damson')"
+	]));
+	XCTAssertEqualObjects([[statements objectAtIndex:2] objectForKey:@"rows"], (@[@0, @2]));
+	XCTAssertEqualObjects([[statements objectAtIndex:2] objectForKey:@"rowQueries"], (@[@"UPDATE `fruit` SET `name` = 'a' WHERE `id` = '1'", @"UPDATE `fruit` SET `name` = 'c' WHERE `id` = '3'"]));
+	XCTAssertFalse([[[statements objectAtIndex:2] objectForKey:@"insert"] boolValue]);
+}
+
+/**
+ * INSERTs are split so that no statement exceeds the maximum statement length.
+ */
+- (void)testInsertsSplitAtMaxStatementLength
+{
+	// The 36 byte INSERT prefix, and two 5 byte tuples separated by a comma
+	NSUInteger maxLength = 36 + 5 + 2 + 5;
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:maxLength];
+
+	for (NSUInteger i = 0; i < 5; i++) {
+		[pendingStatements addInsertOfRow:@(i) fields:@[@"name"] values:@[[NSString stringWithFormat:@"'%c'", (char)('a' + i)]]];
+	}
+
+	NSArray *statements = [pendingStatements statements];
+
+	XCTAssertEqualObjects([statements valueForKey:@"rows"], (@[@[@0, @1], @[@2, @3], @[@4]]));
+	XCTAssertEqualObjects([[statements objectAtIndex:0] objectForKey:@"query"], @"INSERT INTO `fruit` (`name`) VALUES ('a'), ('b')");
+	for (NSDictionary *statement in statements) {
+		XCTAssertTrue([[statement objectForKey:@"query"] length] <= maxLength);
+	}
+}
+
+/**
+ * Grouped UPDATEs are split by the estimated length of each row's clauses, and a batch of one
+ * row uses the plain UPDATE.
+ */
+- (void)testGroupedUpdatesSplitAtMaxStatementLength
+{
+	// Each row is estimated at its 48 byte single-row UPDATE plus its 10 byte WHERE condition
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:2 * (48 + 10)];
+
+	for (NSUInteger i = 0; i < 3; i++) {
+		[pendingStatements addUpdateOfRow:@(i) fields:@[@"name"] values:@[[NSString stringWithFormat:@"'%c'", (char)('a' + i)]] whereArgument:[NSString stringWithFormat:@"`id` = '%lu'", (unsigned long)(i + 1)] usesPrimaryKey:YES];
+	}
+
+	NSArray *statements = [pendingStatements statements];
+
+	XCTAssertEqualObjects([statements valueForKey:@"rows"], (@[@[@0, @1], @[@2]]));
+	XCTAssertTrue([[[statements objectAtIndex:0] objectForKey:@"query"] hasPrefix:@"UPDATE `fruit` SET `name` = CASE"]);
+	XCTAssertEqualObjects([[statements objectAtIndex:1] objectForKey:@"query"], @"UPDATE `fruit` SET `name` = 'c' WHERE `id` = '3'");
+}
+
+/**
+ * A failed multi-row statement is undone before its rows are retried one at a time, and the
+ * error is mapped to the row which caused it.
+ */
+- (void)testErrorMappedToRows
+{
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:4096];
+
+	for (NSUInteger i = 0; i < 3; i++) {
+		[pendingStatements addInsertOfRow:@(i) fields:@[@"name"] values:@[[NSString stringWithFormat:@"'%c'", (char)('a' + i)]]];
+	}
+
+	[[connection failingQueries] setObject:@"Duplicate entry 'b'" forKey:@"INSERT INTO `fruit` (`name`) VALUES ('a'), ('b'), ('c')"];
+	[[connection failingQueries] setObject:@"Duplicate entry 'b'" forKey:@"INSERT INTO `fruit` (`name`) VALUES ('b')"];
+
+	NSDictionary *rowErrors = [pendingStatements rowErrorsExecutingStatements:[pendingStatements statements] onConnection:(SPMySQLConnection *)connection];
+
+	XCTAssertEqualObjects(rowErrors, @{@1: @"Duplicate entry 'b'"});
+	XCTAssertEqualObjects([connection queryLog], (@[
+		@"SAVEPOINT sp_pending_row_statement",
+		@"INSERT INTO `fruit` (`name`) VALUES ('a'), ('b'), ('c')",
+		@"ROLLBACK TO SAVEPOINT sp_pending_row_statement",
+		@"INSERT INTO `fruit` (`name`) VALUES ('a')",
+		@"INSERT INTO `fruit` (`name`) VALUES ('b')",
+		@"ROLLBACK TO SAVEPOINT sp_pending_row_statement",
+		@"INSERT INTO `fruit` (`name`) VALUES ('c')"
+	]));
+}
+
+/**
+ * A failed single-row statement is mapped to its row without a retry, and later statements
+ * still run so that their errors are reported too.
+ */
+- (void)testSingleRowErrorContinues
+{
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:4096];
+
+	[pendingStatements addUpdateOfRow:@0 fields:@[@"id"] values:@[@"'2'"] whereArgument:@"`id` = '1'" usesPrimaryKey:YES];
+	[pendingStatements addInsertOfRow:@1 fields:@[@"name"] values:@[@"NULL"]];
+
+	[[connection failingQueries] setObject:@"Duplicate entry '2'" forKey:@"UPDATE `fruit` SET `id` = '2' WHERE `id` = '1'"];
+	[[connection failingQueries] setObject:@"Column 'name' cannot be null" forKey:@"INSERT INTO `fruit` (`name`) VALUES (NULL)"];
+
+	NSDictionary *rowErrors = [pendingStatements rowErrorsExecutingStatements:[pendingStatements statements] onConnection:(SPMySQLConnection *)connection];
+
+	XCTAssertEqualObjects(rowErrors, (@{@0: @"Duplicate entry '2'", @1: @"Column 'name' cannot be null"}));
+	XCTAssertEqual([[connection queryLog] count], (NSUInteger)6);
+}
+
+/**
+ * When an error rolls back the whole transaction, no further statements are run, so nothing
+ * is saved outside the transaction.
+ */
+- (void)testLostTransactionStopsExecution
+{
+	SPPendingRowEditStatements *pendingStatements = [self _statementsWithMaxStatementLength:4096];
+
+	[pendingStatements addUpdateOfRow:@0 fields:@[@"name"] values:@[@"'a'"] whereArgument:@"`id` = '1'" usesPrimaryKey:YES];
+	[pendingStatements addUpdateOfRow:@1 fields:@[@"name"] values:@[@"'b'"] whereArgument:@"`id` = '2'" usesPrimaryKey:YES];
+	[pendingStatements addInsertOfRow:@2 fields:@[@"name"] values:@[@"'c'"]];
+
+	NSArray *statements = [pendingStatements statements];
+	NSString *groupedUpdate = [[statements objectAtIndex:0] objectForKey:@"query"];
+
+	[[connection failingQueries] setObject:@"Deadlock found when trying to get lock" forKey:groupedUpdate];
+	[[connection transactionLosingQueries] addObject:groupedUpdate];
+
+	NSDictionary *rowErrors = [pendingStatements rowErrorsExecutingStatements:statements onConnection:(SPMySQLConnection *)connection];
+
+	XCTAssertEqualObjects(rowErrors, (@{@0: @"Deadlock found when trying to get lock", @1: @"Deadlock found when trying to get lock"}));
+	XCTAssertEqualObjects([connection queryLog], (@[
+		@"SAVEPOINT sp_pending_row_statement",
+		groupedUpdate,
+		@"ROLLBACK TO SAVEPOINT sp_pending_row_statement"
+	]));
+}
+
+/**
+ * Only engines whose changes can be rolled back support deferred commits.
+ */
+- (void)testEngineSupportsTransactions
+{
+	XCTAssertTrue([SPPendingRowEditStatements engineSupportsTransactions:@"InnoDB"]);
+	XCTAssertTrue([SPPendingRowEditStatements engineSupportsTransactions:@"innodb"]);
+	XCTAssertTrue([SPPendingRowEditStatements engineSupportsTransactions:@"ndbcluster"]);
+	XCTAssertFalse([SPPendingRowEditStatements engineSupportsTransactions:@"MyISAM"]);
+	XCTAssertFalse([SPPendingRowEditStatements engineSupportsTransactions:@"MEMORY"]);
+	XCTAssertFalse([SPPendingRowEditStatements engineSupportsTransactions:@"Aria"]);
+	XCTAssertFalse([SPPendingRowEditStatements engineSupportsTransactions:nil]);
+}
+
+@end
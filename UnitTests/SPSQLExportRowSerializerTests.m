@@ -0,0 +1,177 @@
+//
+//  SPSQLExportRowSerializerTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLExportRowSerializer.h"
+
+#import <XCTest/XCTest.h>
+
+/**
+ * Collects the data written by a serializer.
+ */
+@interface SPSQLExportRowSerializerTestOutput : NSObject
+{
+	NSMutableData *data;
+}
+
+- (void)writeData:(NSData *)someData;
+- (NSString *)string;
+
+@end
+
+@implementation SPSQLExportRowSerializerTestOutput
+
+- (id)init
+{
+	if ((self = [super init])) {
+		data = [[NSMutableData alloc] init];
+	}
+
+	return self;
+}
+
+- (void)writeData:(NSData *)someData
+{
+	[data appendData:someData];
+}
+
+- (NSString *)string
+{
+	return [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+}
+
+- (void)dealloc
+{
+	[data release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPSQLExportRowSerializerTests : XCTestCase
+
+- (NSString *)_stringByWritingSerializer:(SPSQLExportRowSerializer *)serializer;
+
+@end
+
+@implementation SPSQLExportRowSerializerTests
+
+/**
+ * Raw row cells are written according to their column formats.
+ */
+- (void)testRawRowCells
+{
+	SPSQLExportRowSerializer *serializer = [[[SPSQLExportRowSerializer alloc] initWithColumnCount:7 stringEncoding:NSUTF8StringEncoding encodeBlobsAsHex:YES blobStringEncoding:NSUTF8StringEncoding] autorelease];
+
+	[serializer setFormat:SPSQLExportCellAsNumber bitLength:0 forColumn:0];
+	[serializer setFormat:SPSQLExportCellAsBit bitLength:10 forColumn:2];
+	[serializer setFormat:SPSQLExportCellAsHexString bitLength:0 forColumn:3];
+	[serializer setFormat:SPSQLExportCellAsBlob bitLength:0 forColumn:4];
+	[serializer setFormat:SPSQLExportCellAsString bitLength:0 forColumn:5];
+
+	const char *cells[7] = { "-12.5", "it's\n\"quoted\"\\ \032", "\x01\x05", "DEADBEEF", "\x00\xff", NULL, "" };
+	unsigned long lengths[7] = { 5, 16, 2, 8, 2, 0, 0 };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"-12.5,'it\\'s\\n\\\"quoted\\\"\\\\ \\Z',b'0100000101',X'DEADBEEF',X'00FF',NULL,''");
+}
+
+/**
+ * Escaping preserves multibyte UTF-8 characters and NUL bytes.
+ */
+- (void)testRawStringEscaping
+{
+	SPSQLExportRowSerializer *serializer = [[[SPSQLExportRowSerializer alloc] initWithColumnCount:1 stringEncoding:NSUTF8StringEncoding encodeBlobsAsHex:YES blobStringEncoding:NSUTF8StringEncoding] autorelease];
+
+	const char *cells[1] = { "\xc3\xa9t\xc3\xa9\x00\r" };
+	unsigned long lengths[1] = { 7 };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"'été\\0\\r'");
+}
+
+/**
+ * Rows supplied as objects produce the same output as raw rows.
+ */
+- (void)testObjectRow
+{
+	SPSQLExportRowSerializer *serializer = [[[SPSQLExportRowSerializer alloc] initWithColumnCount:6 stringEncoding:NSUTF8StringEncoding encodeBlobsAsHex:YES blobStringEncoding:NSUTF8StringEncoding] autorelease];
+
+	[serializer setFormat:SPSQLExportCellAsNumber bitLength:0 forColumn:0];
+	[serializer setFormat:SPSQLExportCellAsBit bitLength:0 forColumn:2];
+
+	char blobBytes[2] = { 0x00, (char)0xff };
+	NSArray *row = @[@"42", @"a'b", @"0101", [NSData dataWithBytes:blobBytes length:2], [NSNull null], @""];
+
+	[serializer appendRow:row];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"42,'a\\'b',b'0101',X'00FF',NULL,''");
+}
+
+/**
+ * Output larger than the initial buffer is written intact, and the buffer is emptied after writing.
+ */
+- (void)testBufferGrowth
+{
+	SPSQLExportRowSerializer *serializer = [[[SPSQLExportRowSerializer alloc] initWithColumnCount:1 stringEncoding:NSUTF8StringEncoding encodeBlobsAsHex:YES blobStringEncoding:NSUTF8StringEncoding] autorelease];
+
+	NSUInteger length = 200000;
+	char *bytes = malloc(length);
+	memset(bytes, '\'', length);
+
+	const char *cells[1] = { bytes };
+	unsigned long lengths[1] = { length };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqual([serializer length], (length * 2) + 2);
+
+	NSString *output = [self _stringByWritingSerializer:serializer];
+
+	XCTAssertEqual([output length], (length * 2) + 2);
+	XCTAssertEqual([serializer length], (NSUInteger)0);
+
+	free(bytes);
+}
+
+#pragma mark -
+
+- (NSString *)_stringByWritingSerializer:(SPSQLExportRowSerializer *)serializer
+{
+	SPSQLExportRowSerializerTestOutput *output = [[[SPSQLExportRowSerializerTestOutput alloc] init] autorelease];
+
+	[serializer writeToOutput:output];
+
+	return [output string];
+}
+
+@end
@@ -0,0 +1,481 @@
+//
+//  SPSQLExporterTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLExporter.h"
+#import "SPExportCheckpoint.h"
+#import "SPExportFile.h"
+#import "RegexKitLite.h"
+
+#import <SPMySQL/SPMySQL.h>
+#import <XCTest/XCTest.h>
+
+static NSString *SPSQLExporterTestFetchRegex = @"^SELECT `id`, `name` FROM `items`(?: WHERE `id` > '(\\d+)')?(?: (?:WHERE|AND) `id` <= '(\\d+)')?$";
+
+@interface SPSQLExporter (SPSQLExporterTests)
+
+- (BOOL)_exportTable:(NSArray *)table toOutput:(id)output usingConnection:(SPMySQLConnection *)tableConnection connectionPool:(SPExportConnectionPool *)connectionPool tableData:(SPTableData *)tableData viewSyntaxes:(NSMutableDictionary *)viewSyntaxes errors:(NSMutableString *)errors reportingProgress:(BOOL)reportsProgress continuingPartialDump:(NSDictionary *)partialDump;
+- (NSDictionary *)_resumablePartialDumpForTable:(NSString *)tableName tableData:(SPTableData *)tableData;
+- (NSString *)_exportFileFooter;
+- (void)_splitExportFileForTable:(NSString *)tableName startingTable:(BOOL)startingTable;
+
+@end
+
+/**
+ * An exporter delegate ignoring the export's progress.
+ */
+@interface SPSQLExporterTestDelegate : NSObject <SPSQLExporterProtocol>
+@end
+
+@implementation SPSQLExporterTestDelegate
+
+- (void)sqlExportProcessWillBegin:(SPSQLExporter *)exporter {}
+- (void)sqlExportProcessComplete:(SPSQLExporter *)exporter {}
+- (void)sqlExportProcessProgressUpdated:(SPSQLExporter *)exporter {}
+- (void)sqlExportProcessWillBeginFetchingData:(SPSQLExporter *)exporter {}
+- (void)sqlExportProcessWillBeginWritingData:(SPSQLExporter *)exporter {}
+
+@end
+
+/**
+ * A result returning the supplied rows in turn, as arrays or as dictionaries of the field names,
+ * standing in for a streaming result when the table is read as a single stream.
+ */
+@interface SPSQLExporterTestResult : NSObject
+{
+	NSArray *fieldNames;
+	NSArray *rows;
+	NSUInteger rowIndex;
+}
+
+- (id)initWithFieldNames:(NSArray *)names rows:(NSArray *)someRows;
+
+@end
+
+@implementation SPSQLExporterTestResult
+
+- (id)initWithFieldNames:(NSArray *)names rows:(NSArray *)someRows
+{
+	if ((self = [super init])) {
+		fieldNames = [names retain];
+		rows = [someRows retain];
+		rowIndex = 0;
+	}
+
+	return self;
+}
+
+- (void)setReturnDataAsStrings:(BOOL)asStrings
+{
+}
+
+- (NSUInteger)numberOfRows
+{
+	return [rows count];
+}
+
+- (NSArray *)fieldNames
+{
+	return fieldNames;
+}
+
+- (NSArray *)getRowAsArray
+{
+	if (rowIndex >= [rows count]) return nil;
+
+	return [rows objectAtIndex:rowIndex++];
+}
+
+- (NSDictionary *)getRowAsDictionary
+{
+	NSArray *row = [self getRowAsArray];
+
+	return (row) ? [NSDictionary dictionaryWithObjects:row forKeys:fieldNames] : nil;
+}
+
+- (NSUInteger)processedRowCount
+{
+	return rowIndex;
+}
+
+- (double)dataWaitTime
+{
+	return 0;
+}
+
+- (void)dealloc
+{
+	[fieldNames release];
+	[rows release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for a connection to a table of (id, name) rows with ids from 1 to 6, logging the
+ * queries run.
+ */
+@interface SPSQLExporterTestConnection : NSObject
+{
+	NSMutableArray *queryLog;
+}
+
+- (NSArray *)queryLog;
+
+@end
+
+@implementation SPSQLExporterTestConnection
+
+- (id)init
+{
+	if ((self = [super init])) {
+		queryLog = [[NSMutableArray alloc] init];
+	}
+
+	return self;
+}
+
+- (NSArray *)queryLog
+{
+	@synchronized(self) {
+		return [[queryLog copy] autorelease];
+	}
+}
+
+- (id)queryString:(NSString *)query
+{
+	@synchronized(self) {
+		[queryLog addObject:query];
+	}
+
+	if ([query hasPrefix:@"SHOW CREATE TABLE"]) {
+		return [[[SPSQLExporterTestResult alloc] initWithFieldNames:@[@"Table", @"Create Table"] rows:@[@[@"items", @"CREATE TABLE `items` (`id` int NOT NULL, `name` varchar(32), PRIMARY KEY (`id`))"]]] autorelease];
+	}
+
+	if ([query hasPrefix:@"SELECT COUNT(1)"]) {
+		return [[[SPSQLExporterTestResult alloc] initWithFieldNames:@[@"COUNT(1)"] rows:@[@[@"6"]]] autorelease];
+	}
+
+	// Chunk boundaries are sought further along than the table's rows, so the rest is read as one chunk
+	return [[[SPSQLExporterTestResult alloc] initWithFieldNames:@[@"id"] rows:@[]] autorelease];
+}
+
+- (id)streamingQueryString:(NSString *)query useLowMemoryBlockingStreaming:(BOOL)fullStreaming
+{
+	@synchronized(self) {
+		[queryLog addObject:query];
+	}
+
+	NSArray *bounds = [query captureComponentsMatchedByRegex:SPSQLExporterTestFetchRegex];
+	NSInteger lowerBound = [[bounds objectAtIndex:1] integerValue];
+	NSInteger upperBound = [[bounds objectAtIndex:2] length] ? [[bounds objectAtIndex:2] integerValue] : NSIntegerMax;
+	NSMutableArray *rows = [NSMutableArray array];
+
+	for (NSInteger key = 1; key <= 6; key++) {
+		if (key > lowerBound && key <= upperBound) [rows addObject:@[[NSString stringWithFormat:@"%ld", (long)key], [NSString stringWithFormat:@"item %ld", (long)key]]];
+	}
+
+	return [[[SPSQLExporterTestResult alloc] initWithFieldNames:@[@"id", @"name"] rows:rows] autorelease];
+}
+
+- (NSStringEncoding)stringEncoding
+{
+	return NSUTF8StringEncoding;
+}
+
+- (BOOL)queryErrored
+{
+	return NO;
+}
+
+- (NSString *)lastErrorMessage
+{
+	return nil;
+}
+
+- (BOOL)isConnected
+{
+	return YES;
+}
+
+- (NSString *)escapeAndQuoteString:(NSString *)string
+{
+	return [NSString stringWithFormat:@"'%@'", string];
+}
+
+- (void)cancelCurrentQuery
+{
+}
+
+- (void)dealloc
+{
+	[queryLog release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Stands in for the table data instance, describing the test table with the supplied primary key.
+ */
+@interface SPSQLExporterTestTableData : NSObject
+{
+	NSArray *primaryKeyColumns;
+}
+
+- (id)initWithPrimaryKeyColumns:(NSArray *)columns;
+
+@end
+
+@implementation SPSQLExporterTestTableData
+
+- (id)initWithPrimaryKeyColumns:(NSArray *)columns
+{
+	if ((self = [super init])) {
+		primaryKeyColumns = [columns retain];
+	}
+
+	return self;
+}
+
+- (NSDictionary *)informationForTable:(NSString *)tableName
+{
+	return @{
+		@"columns" : @[
+			@{@"name" : @"id", @"typegrouping" : @"integer"},
+			@{@"name" : @"name", @"typegrouping" : @"string"}
+		],
+		@"primarykeyfield" : primaryKeyColumns
+	};
+}
+
+- (void)dealloc
+{
+	[primaryKeyColumns release];
+
+	[super dealloc];
+}
+
+@end
+
+/**
+ * Collects the data written to it, standing in for a table's dump file.
+ */
+@interface SPSQLExporterTestOutput : NSObject
+{
+	NSMutableData *data;
+}
+
+- (NSString *)string;
+
+@end
+
+@implementation SPSQLExporterTestOutput
+
+- (id)init
+{
+	if ((self = [super init])) {
+		data = [[NSMutableData alloc] init];
+	}
+
+	return self;
+}
+
+- (void)writeData:(NSData *)someData
+{
+	[data appendData:someData];
+}
+
+- (NSString *)string
+{
+	return [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+}
+
+- (void)dealloc
+{
+	[data release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPSQLExporterTests : XCTestCase
+{
+	SPSQLExporterTestDelegate *exporterDelegate;
+	SPSQLExporter *exporter;
+}
+
+@end
+
+@implementation SPSQLExporterTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	exporterDelegate = [[SPSQLExporterTestDelegate alloc] init];
+	exporter = [[SPSQLExporter alloc] initWithDelegate:exporterDelegate];
+
+	[exporter setExportOutputEncoding:NSUTF8StringEncoding];
+	[exporter setSqlInsertDivider:SPSQLInsertEveryNRows];
+	[exporter setSqlInsertAfterNValue:2];
+}
+
+- (void)tearDown
+{
+	[exporter release], exporter = nil;
+	[exporterDelegate release], exporterDelegate = nil;
+
+	[super tearDown];
+}
+
+/**
+ * A table's dump continued from a checkpoint reads the rows after the checkpointed key bound, and
+ * closes the checkpointed INSERT statement to start a new one, without repeating the table's
+ * header, lock or rows already in the dump.
+ */
+- (void)testContinuingPartialDump
+{
+	SPSQLExporterTestConnection *connection = [[[SPSQLExporterTestConnection alloc] init] autorelease];
+	SPSQLExporterTestTableData *tableData = [[[SPSQLExporterTestTableData alloc] initWithPrimaryKeyColumns:@[@"id"]] autorelease];
+	SPSQLExporterTestOutput *output = [[[SPSQLExporterTestOutput alloc] init] autorelease];
+
+	NSDictionary *partialDump = @{
+		SPExportCheckpointKeyColumnKey : @"id",
+		SPExportCheckpointKeyBoundKey  : @"'3'",
+		SPExportCheckpointRowCountKey  : @3
+	};
+
+	NSMutableString *errors = [NSMutableString string];
+
+	BOOL completed = [exporter _exportTable:@[@"items", @NO, @YES, @NO] toOutput:output usingConnection:(SPMySQLConnection *)connection connectionPool:nil tableData:(SPTableData *)tableData viewSyntaxes:[NSMutableDictionary dictionary] errors:errors reportingProgress:NO continuingPartialDump:partialDump];
+
+	NSString *expectedOutput =
+		@";\n\nINSERT INTO `items` (`id`, `name`)\nVALUES\n\t(4,'item 4'),\n\t(5,'item 5')"
+		@";\n\nINSERT INTO `items` (`id`, `name`)\nVALUES\n\t(6,'item 6')"
+		@";\n\n/*!40000 ALTER TABLE `items` ENABLE KEYS */;\nUNLOCK TABLES;\n"
+		@"\n\n";
+
+	XCTAssertTrue(completed);
+	XCTAssertEqualObjects(errors, @"");
+	XCTAssertEqualObjects([output string], expectedOutput);
+	XCTAssertTrue([[connection queryLog] containsObject:@"SELECT `id`, `name` FROM `items` WHERE `id` > '3'"]);
+	XCTAssertFalse([[connection queryLog] containsObject:@"SELECT `id`, `name` FROM `items`"]);
+}
+
+/**
+ * A checkpointed partial dump is only continued while the table is still keyed by the single
+ * column its key ranges were read by.
+ */
+- (void)testResumablePartialDumpNeedsSameKey
+{
+	NSString *exportFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPSQLExporterTests-%@.sql", [[NSProcessInfo processInfo] globallyUniqueString]]];
+	SPExportCheckpoint *checkpoint = [SPExportCheckpoint checkpointForExportFileAtPath:exportFilePath];
+
+	XCTAssertTrue([checkpoint beginWithSettings:@{} tableNames:@[@"items"]]);
+	XCTAssertTrue([[NSMutableData dataWithLength:64] writeToFile:[checkpoint dumpPathForTable:@"items"] atomically:NO]);
+
+	[checkpoint recordPartialDumpOfTable:@"items" length:64 keyColumn:@"id" keyBound:@"'3'" rowCount:3];
+	[exporter setSqlExportCheckpoint:checkpoint];
+
+	SPSQLExporterTestTableData *sameKey = [[[SPSQLExporterTestTableData alloc] initWithPrimaryKeyColumns:@[@"id"]] autorelease];
+	SPSQLExporterTestTableData *changedKey = [[[SPSQLExporterTestTableData alloc] initWithPrimaryKeyColumns:@[@"uuid"]] autorelease];
+	SPSQLExporterTestTableData *compositeKey = [[[SPSQLExporterTestTableData alloc] initWithPrimaryKeyColumns:@[@"id", @"name"]] autorelease];
+
+	XCTAssertEqualObjects([[exporter _resumablePartialDumpForTable:@"items" tableData:(SPTableData *)sameKey] objectForKey:SPExportCheckpointKeyBoundKey], @"'3'");
+	XCTAssertNil([exporter _resumablePartialDumpForTable:@"items" tableData:(SPTableData *)changedKey]);
+	XCTAssertNil([exporter _resumablePartialDumpForTable:@"items" tableData:(SPTableData *)compositeKey]);
+	XCTAssertNil([exporter _resumablePartialDumpForTable:@"orders" tableData:(SPTableData *)sameKey]);
+
+	[checkpoint remove];
+}
+
+/**
+ * A table written to an export file split by size rolls over to a new part between INSERT statements,
+ * and each part can be imported on its own: it starts with the dump header, ends with the dump footer,
+ * and locks the table again before continuing its rows.
+ */
+- (void)testSplitPartsAreIndependentlyImportable
+{
+	NSString *exportDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPSQLExporterTests-%@", [[NSProcessInfo processInfo] globallyUniqueString]]];
+
+	XCTAssertTrue([[NSFileManager defaultManager] createDirectoryAtPath:exportDirectory withIntermediateDirectories:YES attributes:nil error:NULL]);
+
+	SPExportFile *exportFile = [SPExportFile exportFileAtPath:[exportDirectory stringByAppendingPathComponent:@"dump.sql"]];
+
+	// Roll over at every statement boundary
+	[exportFile setExportFileSplitLength:1];
+
+	XCTAssertEqual([exportFile createExportFileHandle:NO], SPExportFileHandleCreated);
+
+	NSString *header = @"/*!40101 SET @OLD_CHARACTER_SET_CLIENT=@@CHARACTER_SET_CLIENT */;\n/*!40101 SET NAMES utf8 */;\n\n\n";
+	NSString *footer = [exporter _exportFileFooter];
+
+	[exporter setExportOutputFile:exportFile];
+	[exporter setValue:header forKey:@"sqlExportPartHeader"];
+
+	// Write the header and start the table as the export does
+	[exporter writeString:header];
+	[exporter _splitExportFileForTable:@"items" startingTable:YES];
+
+	SPSQLExporterTestConnection *connection = [[[SPSQLExporterTestConnection alloc] init] autorelease];
+	SPSQLExporterTestTableData *tableData = [[[SPSQLExporterTestTableData alloc] initWithPrimaryKeyColumns:@[@"id"]] autorelease];
+	NSMutableString *errors = [NSMutableString string];
+
+	BOOL completed = [exporter _exportTable:@[@"items", @NO, @YES, @NO] toOutput:exportFile usingConnection:(SPMySQLConnection *)connection connectionPool:nil tableData:(SPTableData *)tableData viewSyntaxes:[NSMutableDictionary dictionary] errors:errors reportingProgress:NO continuingPartialDump:nil];
+
+	[exporter writeUTF8String:footer];
+
+	XCTAssertTrue(completed);
+	XCTAssertEqualObjects(errors, @"");
+	XCTAssertTrue([exportFile close]);
+
+	NSArray *partPaths = [exportFile exportFilePartPaths];
+
+	XCTAssertEqual([partPaths count], (NSUInteger)3);
+
+	for (NSUInteger i = 0; i < [partPaths count]; i++)
+	{
+		NSString *part = [NSString stringWithContentsOfFile:[partPaths objectAtIndex:i] encoding:NSUTF8StringEncoding error:NULL];
+		NSString *expectedStatement = [NSString stringWithFormat:@"INSERT INTO `items` (`id`, `name`)\nVALUES\n\t(%lu,'item %lu'),\n\t(%lu,'item %lu');\n\n", (unsigned long)(i * 2 + 1), (unsigned long)(i * 2 + 1), (unsigned long)(i * 2 + 2), (unsigned long)(i * 2 + 2)];
+		NSString *expectedLockedStatement = [NSString stringWithFormat:@"LOCK TABLES `items` WRITE;\n/*!40000 ALTER TABLE `items` DISABLE KEYS */;\n\n%@/*!40000 ALTER TABLE `items` ENABLE KEYS */;\nUNLOCK TABLES;\n", expectedStatement];
+
+		XCTAssertTrue([part hasPrefix:header], @"Part %lu: %@", (unsigned long)(i + 1), part);
+		XCTAssertTrue([part rangeOfString:expectedLockedStatement].location != NSNotFound, @"Part %lu: %@", (unsigned long)(i + 1), part);
+		XCTAssertTrue([part hasSuffix:footer], @"Part %lu: %@", (unsigned long)(i + 1), part);
+	}
+
+	[[NSFileManager defaultManager] removeItemAtPath:exportDirectory error:NULL];
+}
+
+@end
@@ -0,0 +1,233 @@
+//
+//  SPSQLImportPipelineTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLImportPipeline.h"
+#import "SPFileHandle.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPSQLImportPipelineTests : XCTestCase
+{
+	NSString *filePath;
+}
+
+- (SPSQLImportPipeline *)_pipelineForSQL:(NSData *)sql noBackslashEscapes:(BOOL)noBackslashEscapes;
+- (NSArray *)_statementsFromPipeline:(SPSQLImportPipeline *)pipeline settingNoBackslashEscapesAfterModeChange:(BOOL)noBackslashEscapes;
+
+@end
+
+@implementation SPSQLImportPipelineTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	filePath = [[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"SPSQLImportPipelineTests-%@", [[NSProcessInfo processInfo] globallyUniqueString]]] retain];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:filePath error:NULL];
+
+	[filePath release], filePath = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Writes the supplied SQL to the test file, and returns a started pipeline reading it.
+ */
+- (SPSQLImportPipeline *)_pipelineForSQL:(NSData *)sql noBackslashEscapes:(BOOL)noBackslashEscapes
+{
+	XCTAssertTrue([sql writeToFile:filePath atomically:NO]);
+
+	SPSQLImportPipeline *pipeline = [[SPSQLImportPipeline alloc] initWithFileHandle:[SPFileHandle fileHandleForReadingAtPath:filePath] stringEncoding:NSUTF8StringEncoding noBackslashEscapes:noBackslashEscapes];
+
+	[pipeline start];
+
+	return [pipeline autorelease];
+}
+
+/**
+ * Returns all the statements from a pipeline, acting as the importing thread: after a statement
+ * changing sql_mode is "executed", the resulting backslash escaping is reported to the pipeline
+ * before the next statement is requested.
+ */
+- (NSArray *)_statementsFromPipeline:(SPSQLImportPipeline *)pipeline settingNoBackslashEscapesAfterModeChange:(BOOL)noBackslashEscapes
+{
+	NSMutableArray *statements = [NSMutableArray array];
+	NSString *statement;
+
+	while ((statement = [pipeline nextStatementReturningByteLength:NULL]))
+	{
+		[statements addObject:statement];
+
+		if ([statement rangeOfString:@"sql_mode" options:NSCaseInsensitiveSearch].location != NSNotFound) [pipeline setNoBackslashEscapes:noBackslashEscapes];
+	}
+
+	[pipeline close];
+
+	return statements;
+}
+
+#pragma mark -
+
+/**
+ * Statements spanning several read chunks and statement batches are returned in file order, with
+ * byte lengths accounting for all of the file but the trailing newline.
+ */
+- (void)testStatementsReturnedInFileOrder
+{
+	NSMutableData *sql = [NSMutableData data];
+	NSMutableArray *expectedStatements = [NSMutableArray array];
+	unsigned int seed = 1;
+
+	// Enough statements to fill more than one read chunk, and many batches
+	for (NSUInteger i = 0; i < 30000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+
+		NSString *statement = [NSString stringWithFormat:@"INSERT INTO `table` VALUES (%lu,'value %u')", (unsigned long)i, (seed >> 16) % 1000];
+
+		[expectedStatements addObject:statement];
+		[sql appendData:[[statement stringByAppendingString:@";\n"] dataUsingEncoding:NSUTF8StringEncoding]];
+	}
+
+	XCTAssertGreaterThan([sql length], (NSUInteger)1048576);
+
+	SPSQLImportPipeline *pipeline = [self _pipelineForSQL:sql noBackslashEscapes:NO];
+	NSMutableArray *statements = [NSMutableArray array];
+	NSUInteger totalByteLength = 0, byteLength = 0;
+	NSString *statement;
+
+	while ((statement = [pipeline nextStatementReturningByteLength:&byteLength]))
+	{
+		[statements addObject:statement];
+
+		totalByteLength += byteLength;
+	}
+
+	[pipeline close];
+
+	XCTAssertEqualObjects(statements, expectedStatements);
+	XCTAssertEqual(totalByteLength, [sql length] - 1);
+	XCTAssertNil([pipeline readErrorReason]);
+	XCTAssertFalse([pipeline decodingFailed]);
+}
+
+/**
+ * A final statement without a terminating semicolon is still returned.
+ */
+- (void)testUnterminatedFinalStatement
+{
+	SPSQLImportPipeline *pipeline = [self _pipelineForSQL:[@"SELECT 1;\n\nSELECT 2\n" dataUsingEncoding:NSUTF8StringEncoding] noBackslashEscapes:NO];
+
+	XCTAssertEqualObjects([self _statementsFromPipeline:pipeline settingNoBackslashEscapesAfterModeChange:NO], (@[@"SELECT 1", @"SELECT 2"]));
+}
+
+/**
+ * Statements following a sql_mode change are only split once the change has been executed and
+ * its backslash escaping reported, so a backslash before a closing quote ends the string once
+ * NO_BACKSLASH_ESCAPES is set.
+ */
+- (void)testSplittingWaitsForSQLModeChange
+{
+	NSString *sql = @"SELECT 1;\nSET SESSION sql_mode = 'NO_BACKSLASH_ESCAPES';\nINSERT INTO `t` VALUES ('a\\');\nINSERT INTO `t` VALUES ('b');\n";
+	SPSQLImportPipeline *pipeline = [self _pipelineForSQL:[sql dataUsingEncoding:NSUTF8StringEncoding] noBackslashEscapes:NO];
+
+	NSArray *expectedStatements = @[
+		@"SELECT 1",
+		@"SET SESSION sql_mode = 'NO_BACKSLASH_ESCAPES'",
+		@"INSERT INTO `t` VALUES ('a\\')",
+		@"INSERT INTO `t` VALUES ('b')"
+	];
+
+	XCTAssertEqualObjects([self _statementsFromPipeline:pipeline settingNoBackslashEscapesAfterModeChange:YES], expectedStatements);
+}
+
+/**
+ * If executing the sql_mode change leaves backslash escaping on, the escaped quote continues the
+ * string into the next statement, leaving a quote open to the end of the file, which is returned
+ * as a single unterminated statement.
+ */
+- (void)testSplittingKeepsEscapingWhenSQLModeChangeDoesNotDisableIt
+{
+	NSString *sql = @"SET SESSION sql_mode = 'ANSI_QUOTES';\nINSERT INTO `t` VALUES ('a\\');\nINSERT INTO `t` VALUES ('b');\n";
+	SPSQLImportPipeline *pipeline = [self _pipelineForSQL:[sql dataUsingEncoding:NSUTF8StringEncoding] noBackslashEscapes:NO];
+
+	NSArray *expectedStatements = @[
+		@"SET SESSION sql_mode = 'ANSI_QUOTES'",
+		@"INSERT INTO `t` VALUES ('a\\');\nINSERT INTO `t` VALUES ('b');"
+	];
+
+	XCTAssertEqualObjects([self _statementsFromPipeline:pipeline settingNoBackslashEscapesAfterModeChange:NO], expectedStatements);
+}
+
+/**
+ * A sql_mode change re-enabling backslash escaping applies to the statements after it, within the
+ * same read chunk, so an escaped quote again continues the string to the end of the file.
+ */
+- (void)testSplittingReenablesEscapingAfterSQLModeChange
+{
+	NSString *sql = @"INSERT INTO `t` VALUES ('a\\');\nSET SESSION sql_mode = '';\nINSERT INTO `t` VALUES ('b\\');\nINSERT INTO `t` VALUES ('c');\n";
+	SPSQLImportPipeline *pipeline = [self _pipelineForSQL:[sql dataUsingEncoding:NSUTF8StringEncoding] noBackslashEscapes:YES];
+
+	NSArray *expectedStatements = @[
+		@"INSERT INTO `t` VALUES ('a\\')",
+		@"SET SESSION sql_mode = ''",
+		@"INSERT INTO `t` VALUES ('b\\');\nINSERT INTO `t` VALUES ('c');"
+	];
+
+	XCTAssertEqualObjects([self _statementsFromPipeline:pipeline settingNoBackslashEscapesAfterModeChange:NO], expectedStatements);
+}
+
+/**
+ * Closing the pipeline before all statements have been requested stops the splitter while it's
+ * waiting for room in the full batch queue, without splitting the rest of the file.
+ */
+- (void)testCloseBeforeAllStatementsRequested
+{
+	NSMutableData *sql = [NSMutableData data];
+
+	for (NSUInteger i = 0; i < 20000; i++)
+	{
+		[sql appendData:[[NSString stringWithFormat:@"INSERT INTO `table` VALUES (%lu);\n", (unsigned long)i] dataUsingEncoding:NSUTF8StringEncoding]];
+	}
+
+	SPSQLImportPipeline *pipeline = [self _pipelineForSQL:sql noBackslashEscapes:NO];
+
+	XCTAssertEqualObjects([pipeline nextStatementReturningByteLength:NULL], @"INSERT INTO `table` VALUES (0)");
+
+	[pipeline close];
+
+	XCTAssertNil([pipeline readErrorReason]);
+}
+
+@end
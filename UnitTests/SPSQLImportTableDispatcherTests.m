@@ -0,0 +1,120 @@
+//
+//  SPSQLImportTableDispatcherTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLImportTableDispatcher.h"
+
+#import <XCTest/XCTest.h>
+
+@interface SPSQLImportTableDispatcherTests : XCTestCase
+
+@end
+
+@implementation SPSQLImportTableDispatcherTests
+
+/**
+ * CREATE TABLE statements define their table, with or without IF NOT EXISTS or a database.
+ */
+- (void)testCreateTable
+{
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TABLE `users` (`id` int(11) NOT NULL, PRIMARY KEY (`id`))"], @"users");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TABLE IF NOT EXISTS `shop`.`Orders` (`id` int)"], @"orders");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"create table items(id int)"], @"items");
+}
+
+/**
+ * ALTER TABLE statements define their table, including inside conditional comments as written by
+ * mysqldump.
+ */
+- (void)testAlterTable
+{
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"ALTER TABLE `users` ADD KEY `name` (`name`)"], @"users");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"ALTER IGNORE TABLE users ADD UNIQUE (email)"], @"users");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"/*!40000 ALTER TABLE `users` DISABLE KEYS */"], @"users");
+}
+
+/**
+ * DROP and TRUNCATE statements of a single table define it; dropping several tables doesn't.
+ */
+- (void)testDropAndTruncateTable
+{
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"DROP TABLE IF EXISTS `users`"], @"users");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"DROP TABLE users"], @"users");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"TRUNCATE `users`"], @"users");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"TRUNCATE TABLE `users`"], @"users");
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"DROP TABLE `users`, `orders`"]);
+}
+
+/**
+ * Temporary tables are recognised as definitions, so their later statements can be found.
+ */
+- (void)testTemporaryTable
+{
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TEMPORARY TABLE tmp_totals (id int)"], @"tmp_totals");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TEMPORARY TABLE IF NOT EXISTS `tmp_totals` (id int)"], @"tmp_totals");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"DROP TEMPORARY TABLE IF EXISTS `tmp_totals`"], @"tmp_totals");
+}
+
+/**
+ * Quoted names are unquoted, including escaped backticks, and may contain any other character.
+ */
+- (void)testQuotedNames
+{
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TABLE `my ``quoted`` Table` (id int)"], @"my `quoted` table");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TABLE `semi;colon.dot, comma` (id int)"], @"semi;colon.dot, comma");
+	XCTAssertEqualObjects([SPSQLImportTableDispatcher tableDefinedByStatement:@"ALTER TABLE `db.name` . `t$1` ENGINE=InnoDB"], @"t$1");
+}
+
+/**
+ * Inserts and table locks aren't table definitions, and are classified separately.
+ */
+- (void)testInsertAndLockAreNotDefinitions
+{
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"INSERT INTO `users` VALUES (1,'a')"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"REPLACE INTO `users` VALUES (1,'a')"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"LOCK TABLES `users` WRITE"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"UNLOCK TABLES"]);
+}
+
+/**
+ * Statements without a table, or which refer to other tables, define no single table.
+ */
+- (void)testStatementsWithoutSingleTable
+{
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@""]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"SELECT 1"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE DATABASE `shop`"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE VIEW `totals` AS SELECT 1"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"/*!40101 SET NAMES utf8 */"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TABLE `copy` LIKE `users`"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"CREATE TABLE `totals` SELECT * FROM `orders`"]);
+	XCTAssertNil([SPSQLImportTableDispatcher tableDefinedByStatement:@"ALTER TABLE `orders` ADD FOREIGN KEY (`user_id`) REFERENCES `users` (`id`)"]);
+}
+
+@end
@@ -0,0 +1,251 @@
+//
+//  SPTableContentRefreshPatchTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPTableContentRefreshPatch.h"
+
+#import <XCTest/XCTest.h>
+
+/**
+ * Loaded rows held in an array, standing in for the table content's data storage.
+ */
+@interface SPTableContentRefreshPatchTestRows : NSObject <SPTableContentRefreshPatchRows>
+{
+	NSArray *rows;
+}
+
+- (id)initWithRows:(NSArray *)someRows;
+
+@end
+
+@implementation SPTableContentRefreshPatchTestRows
+
+- (id)initWithRows:(NSArray *)someRows
+{
+	if ((self = [super init])) {
+		rows = [someRows retain];
+	}
+
+	return self;
+}
+
+- (NSUInteger)count
+{
+	return [rows count];
+}
+
+- (id)cellDataAtRow:(NSUInteger)rowIndex column:(NSUInteger)columnIndex
+{
+	return [[rows objectAtIndex:rowIndex] objectAtIndex:columnIndex];
+}
+
+- (NSMutableArray *)rowContentsAtIndex:(NSUInteger)anIndex
+{
+	return [NSMutableArray arrayWithArray:[rows objectAtIndex:anIndex]];
+}
+
+- (void)dealloc
+{
+	[rows release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPTableContentRefreshPatchTests : XCTestCase
+{
+	SPTableContentRefreshPatchTestRows *loadedRows;
+}
+
+- (SPTableContentRefreshPatch *)_patchWithChangedRows:(NSArray *)changedRows serverKeys:(NSArray *)keys;
+
+@end
+
+@implementation SPTableContentRefreshPatchTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	// Rows of (id, name, updated_at), keyed by id
+	loadedRows = [[SPTableContentRefreshPatchTestRows alloc] initWithRows:@[
+		@[@"1", @"apple", @"2026-10-19 10:00:00"],
+		@[@"2", @"banana", @"2026-10-19 10:00:00"],
+		@[@"3", @"cherry", @"2026-10-19 10:00:00"],
+		@[@"4", @"damson", @"2026-10-19 10:00:00"]
+	]];
+}
+
+- (void)tearDown
+{
+	[loadedRows release], loadedRows = nil;
+
+	[super tearDown];
+}
+
+/**
+ * Returns a calculated patch of the loaded rows keyed by their first column.
+ */
+- (SPTableContentRefreshPatch *)_patchWithChangedRows:(NSArray *)changedRows serverKeys:(NSArray *)keys
+{
+	SPTableContentRefreshPatch *patch = [[[SPTableContentRefreshPatch alloc] initWithLoadedRows:loadedRows keyColumnIndexes:@[@0]] autorelease];
+
+	for (NSArray *row in changedRows) {
+		[patch addChangedRow:row];
+	}
+	for (NSString *key in keys) {
+		[patch addServerKeyRow:@[key]];
+	}
+
+	XCTAssertTrue([patch calculatePatch]);
+
+	return patch;
+}
+
+/**
+ * Rows within the overlap window which haven't changed leave the loaded rows untouched.
+ */
+- (void)testUnchangedRows
+{
+	SPTableContentRefreshPatch *patch = [self _patchWithChangedRows:@[@[@"2", @"banana", @"2026-10-19 10:00:00"]] serverKeys:@[@"1", @"2", @"3", @"4"]];
+
+	XCTAssertTrue([patch isEmpty]);
+}
+
+/**
+ * Changed rows replace the loaded rows with the same key, and new rows are appended in order.
+ */
+- (void)testUpdatedAndInsertedRows
+{
+	NSArray *updatedRow = @[@"3", @"cranberry", @"2026-10-19 10:05:00"];
+	NSArray *insertedRows = @[@[@"6", @"fig", @"2026-10-19 10:05:00"], @[@"5", @"elderberry", @"2026-10-19 10:05:01"]];
+
+	SPTableContentRefreshPatch *patch = [self _patchWithChangedRows:[@[updatedRow] arrayByAddingObjectsFromArray:insertedRows] serverKeys:@[@"1", @"2", @"3", @"4", @"5", @"6"]];
+
+	XCTAssertEqualObjects([patch rowsToReplace], @{@2: updatedRow});
+	XCTAssertEqualObjects([patch rowsToAdd], insertedRows);
+	XCTAssertEqual([[patch rowIndexesToRemove] count], (NSUInteger)0);
+}
+
+/**
+ * Loaded rows whose keys are no longer on the server are removed, even when the same number of
+ * rows was inserted, leaving the row count unchanged.
+ */
+- (void)testDeletedRowsWithUnchangedCount
+{
+	NSArray *insertedRow = @[@"5", @"elderberry", @"2026-10-19 10:05:00"];
+
+	SPTableContentRefreshPatch *patch = [self _patchWithChangedRows:@[insertedRow] serverKeys:@[@"1", @"3", @"4", @"5"]];
+
+	XCTAssertEqualObjects([patch rowIndexesToRemove], [NSIndexSet indexSetWithIndex:1]);
+	XCTAssertEqualObjects([patch rowsToAdd], @[insertedRow]);
+	XCTAssertEqual([[patch rowsToReplace] count], (NSUInteger)0);
+}
+
+/**
+ * Rows deleted without any other change are still removed.
+ */
+- (void)testDeletedRowsOnly
+{
+	SPTableContentRefreshPatch *patch = [self _patchWithChangedRows:@[] serverKeys:@[@"2", @"3"]];
+
+	NSMutableIndexSet *expectedIndexes = [NSMutableIndexSet indexSetWithIndex:0];
+	[expectedIndexes addIndex:3];
+
+	XCTAssertEqualObjects([patch rowIndexesToRemove], expectedIndexes);
+	XCTAssertFalse([patch isEmpty]);
+}
+
+/**
+ * A row whose key changed is removed under its old key and appended under its new one.
+ */
+- (void)testChangedKey
+{
+	NSArray *movedRow = @[@"10", @"apple", @"2026-10-19 10:05:00"];
+
+	SPTableContentRefreshPatch *patch = [self _patchWithChangedRows:@[movedRow] serverKeys:@[@"2", @"3", @"4", @"10"]];
+
+	XCTAssertEqualObjects([patch rowIndexesToRemove], [NSIndexSet indexSetWithIndex:0]);
+	XCTAssertEqualObjects([patch rowsToAdd], @[movedRow]);
+}
+
+/**
+ * Changed rows which were deleted before the keys were read are neither added nor kept.
+ */
+- (void)testChangedRowDeletedBeforeKeysRead
+{
+	SPTableContentRefreshPatch *patch = [self _patchWithChangedRows:@[@[@"2", @"blueberry", @"2026-10-19 10:05:00"], @[@"5", @"elderberry", @"2026-10-19 10:05:00"]] serverKeys:@[@"1", @"3", @"4"]];
+
+	XCTAssertEqualObjects([patch rowIndexesToRemove], [NSIndexSet indexSetWithIndex:1]);
+	XCTAssertEqual([[patch rowsToReplace] count], (NSUInteger)0);
+	XCTAssertEqual([[patch rowsToAdd] count], (NSUInteger)0);
+}
+
+/**
+ * A row on the server which is neither loaded nor changed was missed by the timestamp window,
+ * and requires a full reload.
+ */
+- (void)testMissedRowRequiresFullReload
+{
+	SPTableContentRefreshPatch *patch = [[[SPTableContentRefreshPatch alloc] initWithLoadedRows:loadedRows keyColumnIndexes:@[@0]] autorelease];
+
+	for (NSString *key in @[@"1", @"3", @"4", @"5"]) {
+		[patch addServerKeyRow:@[key]];
+	}
+
+	XCTAssertFalse([patch calculatePatch]);
+}
+
+/**
+ * Composite keys match on every key column, in key order rather than column order.
+ */
+- (void)testCompositeKeys
+{
+	[loadedRows release];
+	loadedRows = [[SPTableContentRefreshPatchTestRows alloc] initWithRows:@[
+		@[@"a", @"1", @"x"],
+		@[@"a", @"2", @"y"],
+		@[@"b", @"1", @"z"]
+	]];
+
+	SPTableContentRefreshPatch *patch = [[[SPTableContentRefreshPatch alloc] initWithLoadedRows:loadedRows keyColumnIndexes:@[@1, @0]] autorelease];
+
+	NSArray *updatedRow = @[@"b", @"1", @"zz"];
+	[patch addChangedRow:updatedRow];
+	[patch addServerKeyRow:@[@"1", @"a"]];
+	[patch addServerKeyRow:@[@"1", @"b"]];
+
+	XCTAssertEqualObjects([SPTableContentRefreshPatch keyForRow:updatedRow keyColumnIndexes:@[@1, @0]], ([NSString stringWithFormat:@"1%@b", SPUniqueSchemaDelimiter]));
+	XCTAssertTrue([patch calculatePatch]);
+	XCTAssertEqualObjects([patch rowsToReplace], @{@2: updatedRow});
+	XCTAssertEqualObjects([patch rowIndexesToRemove], [NSIndexSet indexSetWithIndex:1]);
+}
+
+@end
@@ -0,0 +1,144 @@
+//
+//  SPXMLExportRowSerializerTests.m
+//  sequel-pro
+//
+//  Created by Sequel Pro Team on October 19, 2026.
+//  Copyright (c) 2026 Sequel Pro Team. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPXMLExportRowSerializer.h"
+
+#import <XCTest/XCTest.h>
+
+/**
+ * Collects the data written by a serializer.
+ */
+@interface SPXMLExportRowSerializerTestOutput : NSObject
+{
+	NSMutableData *data;
+}
+
+- (void)writeData:(NSData *)someData;
+- (NSString *)string;
+
+@end
+
+@implementation SPXMLExportRowSerializerTestOutput
+
+- (id)init
+{
+	if ((self = [super init])) {
+		data = [[NSMutableData alloc] init];
+	}
+
+	return self;
+}
+
+- (void)writeData:(NSData *)someData
+{
+	[data appendData:someData];
+}
+
+- (NSString *)string
+{
+	return [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+}
+
+- (void)dealloc
+{
+	[data release];
+
+	[super dealloc];
+}
+
+@end
+
+@interface SPXMLExportRowSerializerTests : XCTestCase
+
+- (NSString *)_stringByWritingSerializer:(SPXMLExportRowSerializer *)serializer;
+
+@end
+
+@implementation SPXMLExportRowSerializerTests
+
+/**
+ * Raw row cells are written in MySQL format elements, with NULLs as nil elements and markup escaped.
+ */
+- (void)testRawRowCellsInMySQLFormat
+{
+	SPXMLExportRowSerializer *serializer = [[[SPXMLExportRowSerializer alloc] initWithFieldNames:@[@"id", @"a<b", @"flags"] format:SPXMLExportMySQLFormat nullString:@"NULL" stringEncoding:NSUTF8StringEncoding outputEncoding:NSUTF8StringEncoding] autorelease];
+
+	[serializer setFormat:SPXMLExportCellAsBit bitLength:10 forColumn:2];
+
+	const char *cells[3] = { "1 & \"2\" > 'é'", NULL, "\x01\x05" };
+	unsigned long lengths[3] = { 14, 0, 2 };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"\t<row>\n\t\t<field name=\"id\">1 &amp; &quot;2&quot; &gt; 'é'</field>\n\t\t<field name=\"a&lt;b\" xsi:nil=\"true\" />\n\t\t<field name=\"flags\">0100000101</field>\n\t</row>\n\n");
+}
+
+/**
+ * Rows supplied as objects are written in plain format elements named after their fields, with
+ * NULLs written as the NULL string.
+ */
+- (void)testObjectRowInPlainFormat
+{
+	SPXMLExportRowSerializer *serializer = [[[SPXMLExportRowSerializer alloc] initWithFieldNames:@[@"name", @"value"] format:SPXMLExportPlainFormat nullString:@"<null>" stringEncoding:NSUTF8StringEncoding outputEncoding:NSUTF8StringEncoding] autorelease];
+
+	[serializer appendRow:@[@"x&y", [NSNull null]]];
+	[serializer appendRow:@[@42, [@"data" dataUsingEncoding:NSUTF8StringEncoding]]];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"\t<row>\n\t\t<name>x&amp;y</name>\n\t\t<value>&lt;null&gt;</value>\n\t</row>\n\n\t<row>\n\t\t<name>42</name>\n\t\t<value>data</value>\n\t</row>\n\n");
+}
+
+/**
+ * Text in an encoding other than the output encoding is converted before being written.
+ */
+- (void)testEncodingConversion
+{
+	SPXMLExportRowSerializer *serializer = [[[SPXMLExportRowSerializer alloc] initWithFieldNames:@[@"name"] format:SPXMLExportPlainFormat nullString:@"NULL" stringEncoding:NSISOLatin1StringEncoding outputEncoding:NSUTF8StringEncoding] autorelease];
+
+	const char *cells[1] = { "caf\xe9" };
+	unsigned long lengths[1] = { 4 };
+
+	[serializer appendRawRowCells:cells lengths:lengths];
+
+	XCTAssertEqualObjects([self _stringByWritingSerializer:serializer], @"\t<row>\n\t\t<name>café</name>\n\t</row>\n\n");
+	XCTAssertEqual([serializer length], (NSUInteger)0);
+}
+
+#pragma mark -
+
+- (NSString *)_stringByWritingSerializer:(SPXMLExportRowSerializer *)serializer
+{
+	SPXMLExportRowSerializerTestOutput *output = [[[SPXMLExportRowSerializerTestOutput alloc] init] autorelease];
+
+	[serializer writeToOutput:output];
+
+	return [output string];
+}
+
+@end